@@ -28,6 +28,7 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         Set<String> includes = getIncludeFiles();
         includes.add("<activemq/util/PrimitiveMap.h>");
         includes.add("<activemq/core/ActiveMQAckHandler.h>");
+        includes.add("<activemq/commands/ExternalMessageBody.h>");
     }
 
     protected void generateNamespaceWrapper( PrintWriter out ) {
@@ -60,6 +61,9 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("        // Indicates if the Message Body are Read Only");
         out.println("        bool readOnlyBody;");
         out.println("");
+        out.println("        // Application owned body that is marshaled in place of the content vector.");
+        out.println("        Pointer<ExternalMessageBody> externalContent;");
+        out.println("");
         out.println("    protected:");
         out.println("");
         out.println("        core::ActiveMQConnection* connection;");
@@ -208,6 +212,38 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("            this->readOnlyBody = value;");
         out.println("        }");
         out.println("");
+        out.println("        /**");
+        out.println("         * Sets an application owned buffer that is marshaled as the content of this");
+        out.println("         * Message without being copied, copies of the Message share the same buffer.");
+        out.println("         * Any existing content is cleared.");
+        out.println("         * @param body - the external body, or NULL to remove it.");
+        out.println("         */");
+        out.println("        void setExternalContent(const Pointer<ExternalMessageBody>& body) {");
+        out.println("            std::vector<unsigned char>().swap(this->content);");
+        out.println("            this->externalContent = body;");
+        out.println("        }");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Gets the application owned body of this Message if one was set.");
+        out.println("         * @return the external body or NULL if the content vector holds the body.");
+        out.println("         */");
+        out.println("        const Pointer<ExternalMessageBody>& getExternalContent() const {");
+        out.println("            return this->externalContent;");
+        out.println("        }");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Gets the bytes that are marshaled as the content of this Message, this is");
+        out.println("         * the content vector unless it is empty and an external body has been set.");
+        out.println("         * @return pointer to the content bytes, or NULL if there are none.");
+        out.println("         */");
+        out.println("        const unsigned char* getContentBytes() const;");
+        out.println("");
+        out.println("        /**");
+        out.println("         * Gets the number of bytes that are marshaled as the content of this Message.");
+        out.println("         * @return the content length in bytes.");
+        out.println("         */");
+        out.println("        int getContentLength() const;");
+        out.println("");
     }
 
 }
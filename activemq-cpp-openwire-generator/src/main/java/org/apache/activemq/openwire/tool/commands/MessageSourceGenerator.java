@@ -39,6 +39,7 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         result.append(", properties()");
         result.append(", readOnlyProperties(false)");
         result.append(", readOnlyBody(false)");
+        result.append(", externalContent()");
         result.append(", connection(NULL)");
 
         return result.toString();
@@ -52,6 +53,7 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("    this->setReadOnlyBody(srcPtr->isReadOnlyBody());");
         out.println("    this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());");
         out.println("    this->setConnection(srcPtr->getConnection());");
+        out.println("    this->externalContent = srcPtr->externalContent;");
     }
 
     protected void generateToStringBody( PrintWriter out ) {
@@ -102,13 +104,37 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("");
         out.println("    unsigned int size = DEFAULT_MESSAGE_SIZE;");
         out.println("");
-        out.println("    size += (unsigned int)this->getContent().size();");
+        out.println("    size += (unsigned int)this->getContentLength();");
         out.println("    size += (unsigned int)this->getMarshalledProperties().size();");
         out.println("");
         out.println("    return size;");
         out.println("}");
         out.println("");
         out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("const unsigned char* Message::getContentBytes() const {");
+        out.println("");
+        out.println("    if (!this->content.empty()) {");
+        out.println("        return &this->content[0];");
+        out.println("    } else if (this->externalContent != NULL) {");
+        out.println("        return this->externalContent->getBuffer();");
+        out.println("    }");
+        out.println("");
+        out.println("    return NULL;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("int Message::getContentLength() const {");
+        out.println("");
+        out.println("    if (!this->content.empty()) {");
+        out.println("        return (int)this->content.size();");
+        out.println("    } else if (this->externalContent != NULL) {");
+        out.println("        return this->externalContent->getLength();");
+        out.println("    }");
+        out.println("");
+        out.println("    return 0;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
         out.println("void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {");
         out.println("");
         out.println("    try {");
@@ -43,6 +43,17 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
         return className;
     }
 
+    /**
+     * Checks if the property is the Message content, which the C++ Message can hold
+     * either in its content vector or in an application owned external buffer so it
+     * has to be marshaled through the getContentBytes and getContentLength methods.
+     * @returns true if the property is Message.content
+     */
+    protected boolean isMessageContent( JProperty property ) {
+        return jclass.getSimpleName().equals("Message") &&
+               property.getSimpleName().equals("content");
+    }
+
     /**
      * Checks if the tightMarshal1 method needs an casted version of its
      * dataStructure argument and then returns true or false to indicate this
@@ -177,6 +188,9 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
             if( size != null ) {
                 out.println(indent + "info->" + setter + "(tightUnmarshalConstByteArray(dataIn, bs, "+ size.asInt() +"));");
             }
+            else if( isMessageContent(property) ) {
+                out.println(indent + "std::vector<unsigned char>(tightUnmarshalByteArray(dataIn, bs)).swap(info->getContent());");
+            }
             else {
                 out.println(indent + "info->" + setter + "(tightUnmarshalByteArray(dataIn, bs));");
             }
@@ -264,7 +278,11 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
                 out.println(indent + "rc += tightMarshalString1(" + getter + ", bs);" );
             }
             else if (type.equals("byte[]") || type.equals("ByteSequence")) {
-                if (size == null) {
+                if (isMessageContent(property)) {
+                    out.println(indent + "bs->writeBoolean(info->getContentLength() != 0);" );
+                    out.println(indent + "rc += info->getContentLength() == 0 ? 0 : info->getContentLength() + 4;");
+                }
+                else if (size == null) {
                     out.println(indent + "bs->writeBoolean(" + getter + ".size() != 0);" );
                     out.println(indent + "rc += " + getter + ".size() == 0 ? 0 : (int)" + getter + ".size() + 4;");
                 }
@@ -344,6 +362,12 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
                 if (size != null) {
                     out.println(indent + "dataOut->write((const unsigned char*)(&" + getter + "[0]), " + size.asInt() + ", 0, " + size.asInt() + ");");
                 }
+                else if (isMessageContent(property)) {
+                    out.println(indent + "if (bs->readBoolean()) {");
+                    out.println(indent + "    dataOut->writeInt(info->getContentLength() );");
+                    out.println(indent + "    dataOut->write(info->getContentBytes(), info->getContentLength(), 0, info->getContentLength());");
+                    out.println(indent + "}");
+                }
                 else {
                     out.println(indent + "if (bs->readBoolean()) {");
                     out.println(indent + "    dataOut->writeInt((int)" + getter + ".size() );");
@@ -438,6 +462,9 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
             if (size != null) {
                 out.println(indent + "info->" + setter + "(looseUnmarshalConstByteArray(dataIn, " + size.asInt() + "));");
             }
+            else if (isMessageContent(property)) {
+                out.println(indent + "std::vector<unsigned char>(looseUnmarshalByteArray(dataIn)).swap(info->getContent());");
+            }
             else {
                 out.println(indent + "info->" + setter + "(looseUnmarshalByteArray(dataIn));");
             }
@@ -529,6 +556,13 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
                 if(size != null) {
                     out.println(indent + "dataOut->write((const unsigned char*)(&" + getter + "[0]), " + size.asInt() + ", 0, " + size.asInt() + ");");
                 }
+                else if (isMessageContent(property)) {
+                    out.println(indent + "dataOut->write( info->getContentLength() != 0 );");
+                    out.println(indent + "if( info->getContentLength() != 0 ) {");
+                    out.println(indent + "    dataOut->writeInt( info->getContentLength() );");
+                    out.println(indent + "    dataOut->write(info->getContentBytes(), info->getContentLength(), 0, info->getContentLength());");
+                    out.println(indent + "}");
+                }
                 else {
                     out.println(indent + "dataOut->write( " + getter + ".size() != 0 );");
                     out.println(indent + "if( " + getter + ".size() != 0 ) {");
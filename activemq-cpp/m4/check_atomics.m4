@@ -72,6 +72,35 @@ AC_DEFUN([DECAF_CHECK_FOR_ATOMIC_BUILTINS], [
 
 ])dnl
 
+dnl
+dnl DECAF_CHECK_FOR_ATOMIC_BUILTINS_64 in GCC, 32 bit targets can lack these
+dnl even when the word sized builtins are available.
+dnl
+AC_DEFUN([DECAF_CHECK_FOR_ATOMIC_BUILTINS_64], [
+
+    AC_CACHE_CHECK([whether the compiler provides 64 bit atomic builtins], [ap_cv_atomic_builtins_64],
+    [AC_TRY_RUN([
+    int main()
+    {
+        long long val = 1010, tmp;
+
+        if (__sync_fetch_and_add(&val, 1010LL) != 1010 || val != 2020)
+            return 1;
+
+        tmp = 0x100000000LL;
+
+        if (__sync_val_compare_and_swap(&val, 2020LL, tmp) != 2020 || val != tmp)
+            return 1;
+
+        return 0;
+    }], [ap_cv_atomic_builtins_64=yes], [ap_cv_atomic_builtins_64=no], [ap_cv_atomic_builtins_64=no])])
+
+    if test "$ap_cv_atomic_builtins_64" = "yes"; then
+        AC_DEFINE(HAVE_ATOMIC_BUILTINS_64, 1, [Define if compiler provides 64 bit atomic builtins])
+    fi
+
+])dnl
+
 dnl ---------------------------------------------------------------------------
 dnl Checks for atomic operations support and the various features that are
 dnl needed in order to build the DECAF Code that uses atomics provided by
@@ -82,5 +111,6 @@ AC_DEFUN([DECAF_CHECK_ATOMICS], [
 
     dnl Attempts to enable atomic builtins compilation on this platform.
     DECAF_CHECK_FOR_ATOMIC_BUILTINS
+    DECAF_CHECK_FOR_ATOMIC_BUILTINS_64
 
 ])
@@ -22,6 +22,7 @@
 
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
 #include <activemq/library/ActiveMQCPP.h>
 
 #include "TestSenderAndReceiver.h"
@@ -42,6 +43,7 @@ int main(int argc, char** argv) {
     printf("Test Started\n");
     int cnt = 25;
     int done = 240;
+    int maxSendDelay = 500;
 
     if (argc > 1) {
         cnt = Integer::parseInt(argv[1]);
@@ -51,6 +53,10 @@ int main(int argc, char** argv) {
         done = Integer::parseInt(argv[2]);
     }
 
+    if (argc > 3) {
+        maxSendDelay = Integer::parseInt(argv[3]);
+    }
+
     string url = "tcp://127.0.0.1:61616?connection.sendTimeout=1000";
 
     ActiveMQCPP::initializeLibrary();
@@ -67,19 +73,27 @@ int main(int argc, char** argv) {
         stringstream str;
         str << i;
         topic += str.str();
-        sar[i] = new TestSenderAndReceiver(url, topic, true, false, 50, 1000);
+        sar[i] = new TestSenderAndReceiver(url, topic, true, false, 50, 1000, maxSendDelay);
         sar[i]->initialize();
     }
 
+    long long start = System::currentTimeMillis();
+
     Thread::sleep(done * 1000);
 
+    long long sent = 0;
     for (int i = 0; i < cnt; i++) {
         try {
             sar[i]->close();
         } catch(...) {}
+        sent += sar[i]->getSendCount();
         delete sar[i];
     }
 
+    long long elapsed = System::currentTimeMillis() - start;
+    printf("\nSent %lld messages in %lld ms, %.1f msgs/sec\n",
+           sent, elapsed, elapsed > 0 ? (double) sent * 1000.0 / (double) elapsed : 0.0);
+
     Receiver::unInitialize();
     ConnectionFactoryMgr::unInitialize();
 
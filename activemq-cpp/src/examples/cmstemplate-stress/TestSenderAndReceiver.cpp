@@ -42,8 +42,9 @@ void TestSenderAndReceiver::onMessage(const string& message) {
 
 ////////////////////////////////////////////////////////////////////////////////
 TestSenderAndReceiver::TestSenderAndReceiver(const string& url, const string& queueOrTopicName, bool isTopic,
-                                             bool isDeliveryPersistent, int timeToLive, int receiveTimeout) :
-    sender(), receiver(), senderThread(), closing(false), sendIndex(0), receiveIndex(0) {
+                                             bool isDeliveryPersistent, int timeToLive, int receiveTimeout,
+                                             int maxSendDelay) :
+    sender(), receiver(), senderThread(), closing(false), sendIndex(0), receiveIndex(0), maxSendDelay(maxSendDelay) {
 
     sender.reset(new Sender(url, queueOrTopicName, isTopic, isDeliveryPersistent, timeToLive));
     receiver.reset(new Receiver(url, queueOrTopicName, isTopic, receiveTimeout, true));
@@ -95,8 +96,10 @@ void TestSenderAndReceiver::run() {
             printf("%c", 33);
         }
 
-        // Sleep for up to 1 second between sends
-        Thread::sleep(random.nextInt(500));
+        // Sleep for a random time between sends, with no delay the sender runs flat out
+        if (maxSendDelay > 0) {
+            Thread::sleep(random.nextInt(maxSendDelay));
+        }
     }
 }
 
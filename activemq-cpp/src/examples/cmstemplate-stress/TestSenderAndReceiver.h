@@ -38,6 +38,7 @@ namespace cmstemplate {
         bool closing;
         int sendIndex;
         int receiveIndex;
+        int maxSendDelay;
 
     private:
 
@@ -47,7 +48,8 @@ namespace cmstemplate {
     public:
 
         TestSenderAndReceiver(const std::string& url, const std::string& queueOrTopicName,
-                              bool isTopic, bool isDeliveryPersistent, int timeToLive, int receiveTimeout);
+                              bool isTopic, bool isDeliveryPersistent, int timeToLive, int receiveTimeout,
+                              int maxSendDelay = 500);
 
         virtual ~TestSenderAndReceiver();
 
@@ -59,6 +61,10 @@ namespace cmstemplate {
 
         void waitUntilReady();
 
+        int getSendCount() const {
+            return sendIndex;
+        }
+
     public:
 
         virtual void onMessage(const std::string& message);
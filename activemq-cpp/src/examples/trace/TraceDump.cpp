@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <activemq/library/ActiveMQCPP.h>
+#include <activemq/metrics/MetricsSnapshot.h>
+#include <activemq/metrics/TraceAnalyzer.h>
+#include <activemq/metrics/TraceEvent.h>
+#include <activemq/metrics/Tracer.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/lang/Exception.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads a trace written by activemq::metrics::Tracer::dump and prints the
+// time messages spent between each stage of the dispatch pipeline.
+//
+//   trace_dump [-v] <trace file>
+//
+// The -v option also prints one line per message.
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[]) {
+
+    bool verbose = false;
+    std::string fileName;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg == "-v") {
+            verbose = true;
+        } else {
+            fileName = arg;
+        }
+    }
+
+    if (fileName.empty()) {
+        std::cerr << "usage: " << argv[0] << " [-v] <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file) {
+        std::cerr << "Could not open trace file: " << fileName << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned char> contents((std::istreambuf_iterator<char>(file)),
+                                        std::istreambuf_iterator<char>());
+
+    activemq::library::ActiveMQCPP::initializeLibrary();
+
+    int result = 0;
+
+    try {
+
+        ByteArrayInputStream input(contents);
+        std::vector<TraceEvent> events = Tracer::readEvents(&input);
+
+        TraceAnalyzer analyzer;
+        analyzer.analyze(events);
+
+        std::cout << "Read " << events.size() << " events for "
+                  << analyzer.getMessages().size() << " messages, times in nanoseconds." << std::endl;
+
+        if (verbose) {
+            std::vector<TraceAnalyzer::MessageTrace>::const_iterator iter = analyzer.getMessages().begin();
+            for (; iter != analyzer.getMessages().end(); ++iter) {
+                std::cout << iter->toString() << std::endl;
+            }
+        }
+
+        std::cout << analyzer.getSummary().toString();
+
+    } catch (Exception& ex) {
+        std::cerr << ex.getMessage() << std::endl;
+        result = 1;
+    }
+
+    activemq::library::ActiveMQCPP::shutdownLibrary();
+
+    return result;
+}
@@ -20,15 +20,18 @@
 #include "ResourceLifecycleManager.h"
 #include <cms/CMSException.h>
 
-#include <decaf/util/Set.h>
-#include <decaf/util/Iterator.h>
-
-#include <memory>
-
 using namespace cms;
 using namespace decaf::util;
 using namespace activemq::cmsutil;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Callers that create a new destination object for every call would otherwise
+    // grow the alias map without bound.
+    const std::size_t MAX_ALIASES = 1024;
+}
+
 /**
  * A catch-all that throws an CMSException.
  */
@@ -41,25 +44,33 @@ using namespace activemq::cmsutil;
 
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession::PooledSession(SessionPool* pool, cms::Session* session) :
-    pool(pool), session(session), producerCache(), consumerCache() {
+    pool(pool), session(session), producerCache(), consumerCache(), destinations(), aliases() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession::~PooledSession() {
 
     // Destroy cached producers.
-    std::auto_ptr<Iterator<CachedProducer*> > producers(producerCache.values().iterator());
-    while (producers->hasNext()) {
+    ProducerMap::iterator producer = producerCache.begin();
+    for (; producer != producerCache.end(); ++producer) {
         try {
-            delete producers->next();
+            delete producer->second;
         } catch (...) {}
     }
 
     // Destroy cached consumers.
-    std::auto_ptr<Iterator<CachedConsumer*> > consumers(consumerCache.values().iterator());
-    while (consumers->hasNext()) {
+    ConsumerMap::iterator consumer = consumerCache.begin();
+    for (; consumer != consumerCache.end(); ++consumer) {
         try {
-            delete consumers->next();
+            delete consumer->second;
+        } catch (...) {}
+    }
+
+    // Destroy the interned destinations, nothing refers to them now.
+    DestinationMap::iterator destination = destinations.begin();
+    for (; destination != destinations.end(); ++destination) {
+        try {
+            delete destination->second;
         } catch (...) {}
     }
 }
@@ -91,27 +102,26 @@ cms::MessageProducer* PooledSession::createCachedProducer(const cms::Destination
             throw CMSException("destination is NULL", NULL);
         }
 
-        std::string key = getUniqueDestName(destination);
+        const cms::Destination* key = internDestination(destination);
 
         // Check the cache - add it if necessary.
-        CachedProducer* cachedProducer = NULL;
-        try {
-            cachedProducer = producerCache.get(key);
-        } catch (decaf::util::NoSuchElementException& e) {
+        ProducerMap::const_iterator iter = producerCache.find(key);
+        if (iter != producerCache.end()) {
+            return iter->second;
+        }
 
-            // No producer exists for this destination - start by creating
-            // a new producer resource.
-            cms::MessageProducer* p = session->createProducer(destination);
+        // No producer exists for this destination - start by creating
+        // a new producer resource.
+        cms::MessageProducer* p = session->createProducer(destination);
 
-            // Add the producer resource to the resource lifecycle manager.
-            pool->getResourceLifecycleManager()->addMessageProducer(p);
+        // Add the producer resource to the resource lifecycle manager.
+        pool->getResourceLifecycleManager()->addMessageProducer(p);
 
-            // Create the cached producer wrapper.
-            cachedProducer = new CachedProducer(p);
+        // Create the cached producer wrapper.
+        CachedProducer* cachedProducer = new CachedProducer(p);
 
-            // Add it to the cache.
-            producerCache.put(key, cachedProducer);
-        }
+        // Add it to the cache.
+        producerCache.insert(std::make_pair(key, cachedProducer));
 
         return cachedProducer;
     }
@@ -127,38 +137,65 @@ cms::MessageConsumer* PooledSession::createCachedConsumer(const cms::Destination
             throw CMSException("destination is NULL", NULL);
         }
 
-        // Append the selector and noLocal flag onto the key.
-        std::string key = getUniqueDestName(destination);
-        key += "s=";
-        key += selector;
-        key += ",nl=";
-        key += (noLocal ? "t" : "f");
+        ConsumerKey key(internDestination(destination), selector, noLocal);
 
         // Check the cache - add it if necessary.
-        CachedConsumer* cachedConsumer = NULL;
-        try {
-            cachedConsumer = consumerCache.get(key);
-        } catch (decaf::util::NoSuchElementException& e) {
+        ConsumerMap::const_iterator iter = consumerCache.find(key);
+        if (iter != consumerCache.end()) {
+            return iter->second;
+        }
 
-            // No producer exists for this destination - start by creating
-            // a new consumer resource.
-            cms::MessageConsumer* c = session->createConsumer(destination, selector, noLocal);
+        // No consumer exists for this destination - start by creating
+        // a new consumer resource.
+        cms::MessageConsumer* c = session->createConsumer(destination, selector, noLocal);
 
-            // Add the consumer resource to the resource lifecycle manager.
-            pool->getResourceLifecycleManager()->addMessageConsumer(c);
+        // Add the consumer resource to the resource lifecycle manager.
+        pool->getResourceLifecycleManager()->addMessageConsumer(c);
 
-            // Create the cached consumer wrapper.
-            cachedConsumer = new CachedConsumer(c);
+        // Create the cached consumer wrapper.
+        CachedConsumer* cachedConsumer = new CachedConsumer(c);
 
-            // Add it to the cache.
-            consumerCache.put(key, cachedConsumer);
-        }
+        // Add it to the cache.
+        consumerCache.insert(std::make_pair(key, cachedConsumer));
 
         return cachedConsumer;
     }
     CMSTEMPLATE_CATCHALL()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const cms::Destination* PooledSession::internDestination(const cms::Destination* dest) {
+
+    // The caller's object may have been freed and its address reused for another
+    // destination since we saw it, so the alias is only trusted if it still matches.
+    AliasMap::const_iterator alias = aliases.find(dest);
+    if (alias != aliases.end() &&
+        alias->second->getDestinationType() == dest->getDestinationType() &&
+        alias->second->equals(*dest)) {
+
+        return alias->second;
+    }
+
+    std::string name = getUniqueDestName(dest);
+
+    cms::Destination* interned = NULL;
+    DestinationMap::const_iterator iter = destinations.find(name);
+    if (iter != destinations.end()) {
+        interned = iter->second;
+    } else {
+        interned = dest->clone();
+        destinations.insert(std::make_pair(name, interned));
+    }
+
+    if (aliases.size() >= MAX_ALIASES) {
+        aliases.clear();
+    }
+
+    aliases[dest] = interned;
+
+    return interned;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string PooledSession::getUniqueDestName(const cms::Destination* dest) {
 
@@ -170,6 +207,16 @@ std::string PooledSession::getUniqueDestName(const cms::Destination* dest) {
         const cms::Topic* topic = dynamic_cast<const cms::Topic*>(dest);
         if (topic != NULL) {
             destName += "t:" + topic->getTopicName();
+        } else {
+            const cms::TemporaryQueue* tempQueue = dynamic_cast<const cms::TemporaryQueue*>(dest);
+            if (tempQueue != NULL) {
+                destName += "tq:" + tempQueue->getQueueName();
+            } else {
+                const cms::TemporaryTopic* tempTopic = dynamic_cast<const cms::TemporaryTopic*>(dest);
+                if (tempTopic != NULL) {
+                    destName += "tt:" + tempTopic->getTopicName();
+                }
+            }
         }
     }
 
@@ -19,11 +19,13 @@
 #define _ACTIVEMQ_CMSUTIL_POOLEDSESSION_H_
 
 #include <cms/Session.h>
-#include <decaf/util/StlMap.h>
 #include <activemq/cmsutil/CachedProducer.h>
 #include <activemq/cmsutil/CachedConsumer.h>
 #include <activemq/util/Config.h>
 
+#include <map>
+#include <string>
+
 namespace activemq {
 namespace cmsutil {
 
@@ -41,9 +43,44 @@ namespace cmsutil {
 
         cms::Session* session;
 
-        decaf::util::StlMap<std::string, CachedProducer*> producerCache;
+        /**
+         * Identifies a cached consumer, the destination is always the interned copy.
+         */
+        struct ConsumerKey {
+
+            const cms::Destination* destination;
+            std::string selector;
+            bool noLocal;
+
+            ConsumerKey(const cms::Destination* destination, const std::string& selector, bool noLocal) :
+                destination(destination), selector(selector), noLocal(noLocal) {}
+
+            bool operator<(const ConsumerKey& other) const {
+                if (destination != other.destination) {
+                    return destination < other.destination;
+                } else if (noLocal != other.noLocal) {
+                    return noLocal < other.noLocal;
+                }
+                return selector < other.selector;
+            }
+        };
 
-        decaf::util::StlMap<std::string, CachedConsumer*> consumerCache;
+        typedef std::map<const cms::Destination*, CachedProducer*> ProducerMap;
+        typedef std::map<ConsumerKey, CachedConsumer*> ConsumerMap;
+        typedef std::map<std::string, cms::Destination*> DestinationMap;
+        typedef std::map<const cms::Destination*, cms::Destination*> AliasMap;
+
+        ProducerMap producerCache;
+
+        ConsumerMap consumerCache;
+
+        // Copies of each destination seen by this session, keyed by type and name, the
+        // producer and consumer caches are keyed by the address of these copies.
+        DestinationMap destinations;
+
+        // The destinations callers have passed in mapped to their interned copy, lets
+        // a caller that reuses its destination skip building the name.
+        AliasMap aliases;
 
     private:
 
@@ -236,6 +273,8 @@ namespace cmsutil {
 
         std::string getUniqueDestName(const cms::Destination* dest);
 
+        const cms::Destination* internDestination(const cms::Destination* dest);
+
     };
 
 }}
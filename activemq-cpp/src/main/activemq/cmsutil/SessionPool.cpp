@@ -18,9 +18,16 @@
 #include "SessionPool.h"
 #include "ResourceLifecycleManager.h"
 
+#include <decaf/lang/Thread.h>
+
 using namespace activemq::cmsutil;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent::atomic;
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////////////
+const int SessionPool::SLOT_COUNT;
+
 ////////////////////////////////////////////////////////////////////////////////
 SessionPool::SessionPool(cms::Connection* connection,
                          cms::Session::AcknowledgeMode ackMode,
@@ -54,6 +61,17 @@ SessionPool::~SessionPool() {
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession* SessionPool::takeSession() {
 
+    // Look for an idle session starting with the one this thread returned last, a
+    // slot is only ever claimed by the thread whose compareAndSet empties it.
+    int home = getHomeSlot();
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        AtomicReference<PooledSession>& slot = slots[(home + i) % SLOT_COUNT];
+        PooledSession* pooledSession = slot.get();
+        if (pooledSession != NULL && slot.compareAndSet(pooledSession, NULL)) {
+            return pooledSession;
+        }
+    }
+
     synchronized(&mutex) {
 
         PooledSession* pooledSession = NULL;
@@ -93,8 +111,22 @@ PooledSession* SessionPool::takeSession() {
 ////////////////////////////////////////////////////////////////////////////////
 void SessionPool::returnSession(PooledSession* session) {
 
+    // Park the session in the first free slot from this thread's own one.
+    int home = getHomeSlot();
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        AtomicReference<PooledSession>& slot = slots[(home + i) % SLOT_COUNT];
+        if (slot.get() == NULL && slot.compareAndSet(NULL, session)) {
+            return;
+        }
+    }
+
     synchronized(&mutex) {
-        // Add to the available list.
+        // Every slot is taken, add to the available list.
         available.push_back(session);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+int SessionPool::getHomeSlot() const {
+    return (int) (Thread::currentThread()->getId() % SLOT_COUNT);
+}
@@ -20,6 +20,7 @@
 
 #include <activemq/cmsutil/PooledSession.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicReference.h>
 #include <cms/Connection.h>
 #include <list>
 #include <activemq/util/Config.h>
@@ -35,8 +36,21 @@ namespace cmsutil {
      * acknowledge mode.  Internal session resources are managed through a
      * provided <code>ResourceLifecycleManager</code>, not by this pool.  This
      * class is thread-safe.
+     * <p>
+     * Idle sessions are kept in a fixed set of slots that are claimed and filled
+     * with atomic operations, each thread starts from its own slot so that a thread
+     * taking and returning sessions in a loop usually gets back the session it used
+     * last, along with the producers and consumers that session has cached.  Only
+     * when every slot is empty or full does the pool fall back to a locked list.
      */
     class AMQCPP_API SessionPool {
+    public:
+
+        /**
+         * The number of idle sessions the pool can hold without taking its lock.
+         */
+        static const int SLOT_COUNT = 32;
+
     private:
 
         cms::Connection* connection;
@@ -45,6 +59,8 @@ namespace cmsutil {
 
         decaf::util::concurrent::Mutex mutex;
 
+        decaf::util::concurrent::atomic::AtomicReference<PooledSession> slots[SLOT_COUNT];
+
         std::list<PooledSession*> available;
 
         std::list<PooledSession*> sessions;
@@ -99,6 +115,10 @@ namespace cmsutil {
             return resourceLifecycleManager;
         }
 
+    private:
+
+        int getHomeSlot() const;
+
     };
 
 }}
@@ -18,13 +18,12 @@
 
 #include <activemq/util/CMSExceptionSupport.h>
 
-#include <decaf/io/FilterOutputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/io/EOFException.h>
 #include <decaf/io/IOException.h>
 
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
+#include <algorithm>
+#include <memory>
 
 using namespace std;
 using namespace activemq;
@@ -35,45 +34,13 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char ActiveMQBytesMessage::ID_ACTIVEMQBYTESMESSAGE = 24;
 
-////////////////////////////////////////////////////////////////////////////////
-namespace {
-
-    class ByteCounterOutputStream : public FilterOutputStream {
-    private:
-
-        int* length;
-
-    private:
-
-        ByteCounterOutputStream( const ByteCounterOutputStream& );
-        ByteCounterOutputStream operator= ( const ByteCounterOutputStream& );
-
-    public:
-
-        ByteCounterOutputStream( int* length, OutputStream* stream, bool own = false )
-            : FilterOutputStream( stream, own ), length( length ) {
-        }
-
-        virtual ~ByteCounterOutputStream() {}
-
-    protected:
-
-        virtual void doWriteByte( unsigned char value ) {
-            (*length)++;
-            FilterOutputStream::doWriteByte( value );
-        }
-
-    };
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQBytesMessage::ActiveMQBytesMessage() :
-    ActiveMQMessageTemplate<cms::BytesMessage>(), bytesOut(NULL), dataIn(), dataOut(), length(0) {
+    ActiveMQMessageTemplate<cms::BytesMessage>(), bytesOut(NULL), dataIn(), dataOut(), length(0), uncompressedBody() {
 
     this->clearBody();
 }
@@ -168,6 +135,57 @@ unsigned char* ActiveMQBytesMessage::getBodyBytes() const {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessage::setBodyBuffer(const unsigned char* buffer, int length, MessageBodyReleaser* releaser) {
+
+    this->failIfReadOnlyBody();
+    try {
+
+        Pointer<ExternalMessageBody> body(new ExternalMessageBody(buffer, length, releaser));
+
+        this->dataOut.reset(NULL);
+        this->bytesOut = NULL;
+        this->length = 0;
+        this->setExternalContent(Pointer<ExternalMessageBody>());
+
+        if (this->connection != NULL && this->connection->isUseCompression() &&
+            length >= this->connection->getCompressionThreshold()) {
+
+            // The body must be compressed into a new array, releasing our reference once
+            // it has been written hands the buffer straight back to the caller.
+            initializeWriting();
+            if (body->getLength() > 0) {
+                this->dataOut->write(body->getBuffer(), body->getLength(), 0, body->getLength());
+            }
+            return;
+        }
+
+        this->setCompressed(false);
+        this->setExternalContent(body);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* ActiveMQBytesMessage::getBodyBuffer() const {
+
+    try {
+
+        initializeReading();
+
+        if (this->length == 0) {
+            return NULL;
+        }
+
+        if (!this->isCompressed()) {
+            return this->getContentBytes();
+        }
+
+        return &this->uncompressedBody[0];
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ActiveMQBytesMessage::getBodyLength() const {
 
@@ -188,6 +206,7 @@ void ActiveMQBytesMessage::clearBody() {
     this->bytesOut = NULL;
     this->dataIn.reset(NULL);
     this->length = 0;
+    std::vector<unsigned char>().swap(this->uncompressedBody);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -593,29 +612,27 @@ void ActiveMQBytesMessage::storeContent() {
 
             this->dataOut->close();
 
-            if (!this->compressed) {
-
-                std::pair<unsigned char*, int> array = this->bytesOut->toByteArray();
-                this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-                delete[] array.first;
-
-            } else {
-
-                ByteArrayOutputStream buffer;
-                DataOutputStream doBuffer(&buffer);
+            std::pair<unsigned char*, int> array = this->bytesOut->toByteArray();
+            std::vector<unsigned char> body(array.first, array.first + array.second);
+            delete[] array.first;
 
-                // Start by writing the length of the written data before compression.
-                doBuffer.writeInt((int) this->length);
+            std::vector<unsigned char> compressedBody;
+            this->compressed = this->compressBody(&body[0], (int) body.size(), compressedBody);
 
-                // Now write the Compressed bytes.
-                this->bytesOut->writeTo(&doBuffer);
+            if (this->compressed) {
 
-                // Now store the annotated content.
-                std::pair<unsigned char*, int> array = buffer.toByteArray();
-                this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-                delete[] array.first;
+                // The length of the body before compression leads the compressed bytes.
+                int size = (int) body.size();
+                body.resize(4 + compressedBody.size());
+                body[0] = (unsigned char) (size >> 24);
+                body[1] = (unsigned char) (size >> 16);
+                body[2] = (unsigned char) (size >> 8);
+                body[3] = (unsigned char) size;
+                std::copy(compressedBody.begin(), compressedBody.end(), body.begin() + 4);
             }
 
+            this->setContent(body);
+
             this->dataOut.reset(NULL);
             this->bytesOut = NULL;
         }
@@ -630,22 +647,37 @@ void ActiveMQBytesMessage::initializeReading() const {
     try {
 
         if (this->dataIn.get() == NULL) {
-            InputStream* is = new ByteArrayInputStream(this->getContent());
+            InputStream* is = NULL;
 
-            if (this->isCompressed()) {
+            if (this->isCompressed() && this->getContentLength() > 0) {
 
                 try {
-                    DataInputStream dis(is);
-                    this->length = dis.readInt();
+                    ByteArrayInputStream bytesIn(this->getContentBytes(), this->getContentLength());
+                    DataInputStream lengthIn(&bytesIn);
+                    this->length = lengthIn.readInt();
+
+                    this->decompressBody(this->getContentBytes() + 4, this->getContentLength() - 4,
+                                         this->uncompressedBody);
+
+                    if ((int) this->uncompressedBody.size() != this->length) {
+                        throw IOException(__FILE__, __LINE__,
+                            "Decompressed body is %d bytes, expected %d",
+                            (int) this->uncompressedBody.size(), this->length);
+                    }
                 } catch (IOException& ex) {
                     throw CMSExceptionSupport::create(ex);
                 }
 
-                is = new InflaterInputStream(is, true);
+                is = new ByteArrayInputStream(this->uncompressedBody);
 
+            } else if (this->getContentLength() > 0) {
+                is = new ByteArrayInputStream(this->getContentBytes(), this->getContentLength());
+                this->length = this->getContentLength();
             } else {
-                this->length = (int) this->getContent().size();
+                is = new ByteArrayInputStream(this->getContent());
+                this->length = 0;
             }
+
             this->dataIn.reset(new DataInputStream(is, true));
         }
     }
@@ -660,19 +692,15 @@ void ActiveMQBytesMessage::initializeWriting() {
         if (this->dataOut.get() == NULL) {
             this->length = 0;
             this->bytesOut = new ByteArrayOutputStream();
-
-            OutputStream* os = this->bytesOut;
-
-            if (this->connection != NULL && this->connection->isUseCompression()) {
-                this->compressed = true;
-
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-
-                os = new DeflaterOutputStream(os, deflator, true, true);
-                os = new ByteCounterOutputStream(&length, os, true);
+            this->dataOut.reset(new DataOutputStream(this->bytesOut, true));
+
+            // Writing to a body supplied with setBodyBuffer appends to it, so it has to be
+            // copied into the stream which then owns the body from here on.
+            Pointer<ExternalMessageBody> external = this->getExternalContent();
+            if (external != NULL && external->getLength() > 0) {
+                this->setExternalContent(Pointer<ExternalMessageBody>());
+                this->dataOut->write(external->getBuffer(), external->getLength(), 0, external->getLength());
             }
-
-            this->dataOut.reset(new DataOutputStream(os, true));
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
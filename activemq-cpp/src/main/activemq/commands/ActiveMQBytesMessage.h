@@ -20,6 +20,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/ActiveMQMessageTemplate.h>
+#include <activemq/commands/MessageBodyReleaser.h>
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
@@ -51,10 +52,15 @@ namespace commands {
         std::auto_ptr<decaf::io::DataOutputStream> dataOut;
 
         /**
-         * Tracks the actual length of the Message when compressed.
+         * Tracks the length of the Message body before compression.
          */
         mutable int length;
 
+        /**
+         * Holds the decompressed body of a compressed Message while it is being read.
+         */
+        mutable std::vector<unsigned char> uncompressedBody;
+
     public:
 
         const static unsigned char ID_ACTIVEMQBYTESMESSAGE;
@@ -88,6 +94,42 @@ namespace commands {
 
         virtual void onSend();
 
+    public:
+
+        /**
+         * Sets the body of this Message to a buffer owned by the application without copying
+         * it.  The buffer is shared by any copies of this Message, including the copy made when
+         * the Message is sent, and must not be modified or freed until the releaser is called,
+         * which happens once the last Message referencing it has been destroyed and can be after
+         * the send call returns.  Any existing body content is discarded.
+         *
+         * When the connection is configured to compress message bodies the buffer has to be
+         * compressed into a new array, in that case the bytes are copied and the releaser is
+         * called before this method returns.
+         *
+         * @param buffer
+         *      The bytes to use as the message body.
+         * @param length
+         *      The number of bytes in the buffer.
+         * @param releaser
+         *      Called when the client no longer references the buffer, can be NULL.
+         *
+         * @throws CMSException if the Message body is read-only or the buffer is invalid.
+         */
+        void setBodyBuffer(const unsigned char* buffer, int length, MessageBodyReleaser* releaser);
+
+        /**
+         * Gets read-only access to the body of this Message without copying it, the number of
+         * bytes available is given by getBodyLength.  The returned pointer remains valid until
+         * the body of this Message is cleared or the Message is destroyed.  Reading the body in
+         * this way does not change the position of the readXXX methods.
+         *
+         * @return a pointer to the message body, or NULL if the body is empty.
+         *
+         * @throws CMSException if the Message is in write-only mode.
+         */
+        const unsigned char* getBodyBuffer() const;
+
     public:   // CMS BytesMessage
 
         virtual void setBodyBytes(const unsigned char* buffer, int numBytes);
@@ -156,7 +156,7 @@ bool ActiveMQDestination::equals(const DataStructure* value) const {
         return false;
     }
 
-    return this->getPhysicalName() == valuePtr->getPhysicalName();
+    return ActiveMQDestination::equals(*valuePtr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,12 +282,21 @@ int ActiveMQDestination::compareTo(const ActiveMQDestination& value) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQDestination::equals(const ActiveMQDestination& value) const {
+
+    // Shared instances from a DestinationCache match by address, and names that
+    // hash differently can't be equal.
+    if (this == &value) {
+        return true;
+    } else if (this->hashCode != value.hashCode) {
+        return false;
+    }
+
     return this->getPhysicalName() == value.getPhysicalName();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQDestination::operator==(const ActiveMQDestination& value) const {
-    return this->getPhysicalName() == value.getPhysicalName();
+    return ActiveMQDestination::equals(value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
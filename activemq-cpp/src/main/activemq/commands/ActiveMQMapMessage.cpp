@@ -22,11 +22,8 @@
 
 #include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/io/ByteArrayOutputStream.h>
-#include <decaf/io/BufferedInputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
 
 using namespace std;
 using namespace decaf;
@@ -34,7 +31,6 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::exceptions;
@@ -113,23 +109,17 @@ void ActiveMQMapMessage::beforeMarshal(WireFormat* wireFormat) {
 
             ByteArrayOutputStream* bytesOut = new ByteArrayOutputStream();
 
-            OutputStream* os = bytesOut;
-
-            if (this->connection != NULL && this->connection->isUseCompression()) {
-                this->compressed = true;
-
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-
-                os = new DeflaterOutputStream(os, deflator, true, true);
-            }
-
-            DataOutputStream dataOut(os, true);
+            DataOutputStream dataOut(bytesOut, true);
             PrimitiveTypesMarshaller::marshalMap(map.get(), dataOut);
             dataOut.close();
 
             std::pair<unsigned char*, int> array = bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
+            std::vector<unsigned char> body(array.first, array.first + array.second);
             delete[] array.first;
+
+            std::vector<unsigned char> compressedBody;
+            this->compressed = this->compressBody(&body[0], (int) body.size(), compressedBody);
+            this->setContent(this->compressed ? compressedBody : body);
         } else {
             clearBody();
         }
@@ -170,11 +160,14 @@ void ActiveMQMapMessage::checkMapIsUnmarshalled() const {
 
         if (map.get() == NULL && !getContent().empty()) {
 
-            InputStream* is = new ByteArrayInputStream(getContent());
+            std::vector<unsigned char> body;
+            InputStream* is = NULL;
 
-            if (isCompressed()) {
-                is = new InflaterInputStream(is, true);
-                is = new BufferedInputStream(is, true);
+            if (isCompressed() && !getContent().empty()) {
+                this->decompressBody(&getContent()[0], (int) getContent().size(), body);
+                is = new ByteArrayInputStream(body);
+            } else {
+                is = new ByteArrayInputStream(getContent());
             }
 
             DataInputStream dataIn(is, true);
@@ -91,6 +91,7 @@ namespace commands {
         virtual void clearBody() {
             try {
                 this->setContent(std::vector<unsigned char>());
+                this->setExternalContent(Pointer<ExternalMessageBody>());
                 this->setReadOnlyBody(false);
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -24,9 +24,6 @@
 #include <decaf/io/EOFException.h>
 #include <decaf/io/IOException.h>
 
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
-
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
@@ -36,7 +33,6 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char ActiveMQObjectMessage::ID_ACTIVEMQOBJECTMESSAGE = 26;
@@ -90,20 +86,9 @@ void ActiveMQObjectMessage::setObjectBytes(const std::vector<unsigned char>& byt
             return;
         }
 
-        if (this->connection != NULL && this->connection->isUseCompression()) {
-            this->compressed = true;
-
-            ByteArrayOutputStream bytesOut;
-            Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-            DeflaterOutputStream out(&bytesOut, deflator, false, true);
-            out.write(&bytes[0], (int)bytes.size());
-
-            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-            delete[] array.first;
-        } else {
-            this->setContent(bytes);
-        }
+        std::vector<unsigned char> compressedBody;
+        this->compressed = this->compressBody(&bytes[0], (int) bytes.size(), compressedBody);
+        this->setContent(this->compressed ? compressedBody : bytes);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -114,30 +99,16 @@ std::vector<unsigned char> ActiveMQObjectMessage::getObjectBytes() const {
     this->failIfWriteOnlyBody();
     try {
 
-        if (this->isCompressed()) {
+        if (this->isCompressed() && !this->getContent().empty()) {
 
-            int length = 0;
-            ByteArrayInputStream is(this->getContent());
             std::vector<unsigned char> uncompressed;
 
             try {
-
-                DataInputStream dis(&is);
-                length = dis.readInt();
-
-                if (length == 0) {
-                    return std::vector<unsigned char>();
-                }
-
-                uncompressed.resize(length);
+                this->decompressBody(&this->getContent()[0], (int) this->getContent().size(), uncompressed);
             } catch (IOException& ex) {
                 throw CMSExceptionSupport::create(ex);
             }
 
-            InflaterInputStream inflater(&is, false);
-            inflater.read(&uncompressed[0], length);
-            inflater.close();
-
             return uncompressed;
         } else {
             return this->getContent();
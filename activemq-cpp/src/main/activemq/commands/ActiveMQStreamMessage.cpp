@@ -38,9 +38,6 @@
 #include <decaf/lang/Float.h>
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
-#include <decaf/io/BufferedInputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
 
 using namespace std;
 using namespace cms;
@@ -55,7 +52,6 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
@@ -69,7 +65,7 @@ namespace commands {
 
     public:
 
-        ActiveMQStreamMessageImpl() : bytesOut(NULL), remainingBytes(-1) {}
+        ActiveMQStreamMessageImpl() : bytesOut(NULL), remainingBytes(-1), uncompressedBody() {}
         ~ActiveMQStreamMessageImpl() {}
 
     public:
@@ -81,6 +77,9 @@ namespace commands {
         // are left unread since the last readBytes call.
         mutable int remainingBytes;
 
+        // The decompressed contents of a compressed message while it is being read.
+        std::vector<unsigned char> uncompressedBody;
+
     };
 }}
 
@@ -948,8 +947,12 @@ void ActiveMQStreamMessage::storeContent() {
 
         if (this->impl->bytesOut->size() > 0) {
             std::pair<unsigned char*, int> array = this->impl->bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
+            std::vector<unsigned char> body(array.first, array.first + array.second);
             delete[] array.first;
+
+            std::vector<unsigned char> compressedBody;
+            this->compressed = this->compressBody(&body[0], (int) body.size(), compressedBody);
+            this->setContent(this->compressed ? compressedBody : body);
         }
 
         this->dataOut.reset(NULL);
@@ -963,11 +966,14 @@ void ActiveMQStreamMessage::initializeReading() const {
     this->failIfWriteOnlyBody();
     try {
         if (this->dataIn.get() == NULL) {
-            InputStream* is = new ByteArrayInputStream(this->getContent());
-
-            if (isCompressed()) {
-                is = new InflaterInputStream(is, true);
-                is = new BufferedInputStream(is, true);
+            InputStream* is = NULL;
+
+            if (isCompressed() && !this->getContent().empty()) {
+                this->decompressBody(&this->getContent()[0], (int) this->getContent().size(),
+                                     this->impl->uncompressedBody);
+                is = new ByteArrayInputStream(this->impl->uncompressedBody);
+            } else {
+                is = new ByteArrayInputStream(this->getContent());
             }
 
             this->dataIn.reset(new DataInputStream(is, true));
@@ -983,18 +989,7 @@ void ActiveMQStreamMessage::initializeWriting() {
     try {
         if (this->dataOut.get() == NULL) {
             this->impl->bytesOut = new ByteArrayOutputStream();
-
-            OutputStream* os = this->impl->bytesOut;
-
-            if (this->connection != NULL && this->connection->isUseCompression()) {
-                this->compressed = true;
-
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-
-                os = new DeflaterOutputStream(os, deflator, true, true);
-            }
-
-            this->dataOut.reset(new DataOutputStream(os, true));
+            this->dataOut.reset(new DataOutputStream(this->impl->bytesOut, true));
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
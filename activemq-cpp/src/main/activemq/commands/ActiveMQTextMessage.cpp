@@ -20,8 +20,6 @@
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/DataInputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
 
 #include <activemq/util/MarshallingSupport.h>
 #include <activemq/util/CMSExceptionSupport.h>
@@ -37,7 +35,6 @@ using namespace activemq::wireformat::openwire;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE = 28;
@@ -132,15 +129,7 @@ void ActiveMQTextMessage::beforeMarshal(wireformat::WireFormat* wireFormat) {
     if (this->text.get() != NULL) {
 
         ByteArrayOutputStream* bytesOut = new ByteArrayOutputStream;
-        OutputStream* os = bytesOut;
-
-        if (this->connection != NULL && this->connection->isUseCompression()) {
-            this->compressed = true;
-            Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-            os = new DeflaterOutputStream(os, deflator, true, true);
-        }
-
-        DataOutputStream dataOut(os, true);
+        DataOutputStream dataOut(bytesOut, true);
 
         if (this->text.get() == NULL) {
             dataOut.writeInt(-1);
@@ -152,8 +141,12 @@ void ActiveMQTextMessage::beforeMarshal(wireformat::WireFormat* wireFormat) {
 
         if (bytesOut->size() > 0) {
             std::pair<unsigned char*, int> array = bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
+            std::vector<unsigned char> body(array.first, array.first + array.second);
             delete[] array.first;
+
+            std::vector<unsigned char> compressedBody;
+            this->compressed = this->compressBody(&body[0], (int) body.size(), compressedBody);
+            this->setContent(this->compressed ? compressedBody : body);
         }
 
         this->text.reset(NULL);
@@ -190,10 +183,14 @@ std::string ActiveMQTextMessage::getText() const {
 
             try {
 
-                InputStream* is = new ByteArrayInputStream(getContent());
+                std::vector<unsigned char> body;
+                InputStream* is = NULL;
 
-                if (isCompressed()) {
-                    is = new InflaterInputStream(is, true);
+                if (isCompressed() && !getContent().empty()) {
+                    this->decompressBody(&getContent()[0], (int) getContent().size(), body);
+                    is = new ByteArrayInputStream(body);
+                } else {
+                    is = new ByteArrayInputStream(getContent());
                 }
 
                 DataInputStream dataIn(is, true);
@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ExternalMessageBody.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+ExternalMessageBody::ExternalMessageBody(const unsigned char* buffer, int length, MessageBodyReleaser* releaser) :
+    buffer(buffer), length(length), releaser(releaser) {
+
+    if (length < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Body length cannot be negative");
+    }
+
+    if (buffer == NULL && length != 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Body buffer cannot be NULL");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ExternalMessageBody::~ExternalMessageBody() {
+    try {
+        if (this->releaser != NULL) {
+            this->releaser->release(this->buffer, this->length);
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
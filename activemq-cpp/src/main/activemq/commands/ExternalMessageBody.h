@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_EXTERNALMESSAGEBODY_H_
+#define _ACTIVEMQ_COMMANDS_EXTERNALMESSAGEBODY_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageBodyReleaser.h>
+
+namespace activemq {
+namespace commands {
+
+    /**
+     * Holds a Message body that lives in memory owned by the application.  Instances are
+     * shared between a Message and its copies using a Pointer so that the body bytes are
+     * never duplicated, when the last reference is dropped the buffer is handed back to the
+     * application through the MessageBodyReleaser it was created with.
+     */
+    class AMQCPP_API ExternalMessageBody {
+    private:
+
+        const unsigned char* buffer;
+        int length;
+        MessageBodyReleaser* releaser;
+
+    private:
+
+        ExternalMessageBody(const ExternalMessageBody&);
+        ExternalMessageBody& operator=(const ExternalMessageBody&);
+
+    public:
+
+        /**
+         * Creates a new body that refers to the given buffer.
+         *
+         * @param buffer
+         *      The body bytes, must remain valid until released.
+         * @param length
+         *      The number of bytes in the body.
+         * @param releaser
+         *      Called when the body is no longer referenced, can be NULL if the
+         *      application manages the lifetime of the buffer itself.
+         *
+         * @throws IllegalArgumentException if the buffer is NULL with a non-zero length.
+         */
+        ExternalMessageBody(const unsigned char* buffer, int length, MessageBodyReleaser* releaser);
+
+        virtual ~ExternalMessageBody();
+
+        /**
+         * @return a pointer to the first byte of the body.
+         */
+        const unsigned char* getBuffer() const {
+            return this->buffer;
+        }
+
+        /**
+         * @return the number of bytes in the body.
+         */
+        int getLength() const {
+            return this->length;
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_EXTERNALMESSAGEBODY_H_ */
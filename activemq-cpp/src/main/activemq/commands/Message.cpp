@@ -16,6 +16,8 @@
  */
 
 #include <activemq/commands/Message.h>
+#include <activemq/compression/CompressionCodec.h>
+#include <activemq/compression/CompressionCodecRegistry.h>
 #include <activemq/core/ActiveMQAckHandler.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/exceptions/ActiveMQException.h>
@@ -29,6 +31,7 @@ using namespace std;
 using namespace activemq;
 using namespace activemq::exceptions;
 using namespace activemq::commands;
+using namespace activemq::compression;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
@@ -48,7 +51,7 @@ Message::Message() :
       groupID(""), groupSequence(0), correlationId(""), persistent(false), expiration(0), priority(0), replyTo(NULL), timestamp(0), 
       type(""), content(), marshalledProperties(), dataStructure(NULL), targetConsumerId(NULL), compressed(false), redeliveryCounter(0), 
       brokerPath(), arrival(0), userID(""), recievedByDFBridge(false), droppable(false), cluster(), brokerInTime(0), brokerOutTime(0), 
-      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), connection(NULL) {
+      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), externalContent(), connection(NULL) {
 
 }
 
@@ -120,6 +123,7 @@ void Message::copyDataStructure(const DataStructure* src) {
     this->setReadOnlyBody(srcPtr->isReadOnlyBody());
     this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());
     this->setConnection(srcPtr->getConnection());
+    this->externalContent = srcPtr->externalContent;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -863,12 +867,56 @@ unsigned int Message::getSize() const {
 
     unsigned int size = DEFAULT_MESSAGE_SIZE;
 
-    size += (unsigned int)this->getContent().size();
+    size += (unsigned int)this->getContentLength();
     size += (unsigned int)this->getMarshalledProperties().size();
 
     return size;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* Message::getContentBytes() const {
+
+    if (!this->content.empty()) {
+        return &this->content[0];
+    } else if (this->externalContent != NULL) {
+        return this->externalContent->getBuffer();
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Message::getContentLength() const {
+
+    if (!this->content.empty()) {
+        return (int)this->content.size();
+    } else if (this->externalContent != NULL) {
+        return this->externalContent->getLength();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Message::compressBody(const unsigned char* body, int size, std::vector<unsigned char>& output) const {
+
+    if (this->connection == NULL || !this->connection->isUseCompression() ||
+        size < this->connection->getCompressionThreshold()) {
+
+        return false;
+    }
+
+    this->connection->getActiveCompressionCodec()->compress(
+        body, size, this->connection->getCompressionLevel(), output);
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Message::decompressBody(const unsigned char* body, int size, std::vector<unsigned char>& output) const {
+    CompressionCodecRegistry::getInstance().findCodecFor(body, size)->decompress(body, size, output);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
 
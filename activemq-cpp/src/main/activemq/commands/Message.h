@@ -28,6 +28,7 @@
 #include <activemq/commands/BrokerId.h>
 #include <activemq/commands/ConsumerId.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/ExternalMessageBody.h>
 #include <activemq/commands/MessageId.h>
 #include <activemq/commands/ProducerId.h>
 #include <activemq/commands/TransactionId.h>
@@ -110,12 +111,42 @@ namespace commands{
         // Indicates if the Message Body are Read Only
         bool readOnlyBody;
 
+        // Application owned body that is marshaled in place of the content vector.
+        Pointer<ExternalMessageBody> externalContent;
+
     protected:
 
         core::ActiveMQConnection* connection;
 
         static const unsigned int DEFAULT_MESSAGE_SIZE = 1024;
 
+        /**
+         * Compresses a marshaled Message body with the Connection's active compression
+         * codec.  Nothing is done when there is no Connection, compression is disabled or
+         * the body is smaller than the Connection's compression threshold.
+         *
+         * @param body - the uncompressed body bytes.
+         * @param size - the number of bytes in the body.
+         * @param output - receives the compressed body.
+         *
+         * @return true if the output now holds the compressed body.
+         *
+         * @throws IOException if the codec fails to compress the body.
+         */
+        bool compressBody(const unsigned char* body, int size, std::vector<unsigned char>& output) const;
+
+        /**
+         * Decompresses a Message body, the codec that wrote it is identified from the
+         * data so bodies compressed by any registered codec can be read.
+         *
+         * @param body - the compressed body bytes.
+         * @param size - the number of bytes in the body.
+         * @param output - receives the uncompressed body.
+         *
+         * @throws IOException if the body is not valid compressed data.
+         */
+        void decompressBody(const unsigned char* body, int size, std::vector<unsigned char>& output) const;
+
     private:
 
         Message(const Message&);
@@ -272,6 +303,38 @@ namespace commands{
             this->readOnlyBody = value;
         }
 
+        /**
+         * Sets an application owned buffer that is marshaled as the content of this
+         * Message without being copied, copies of the Message share the same buffer.
+         * Any existing content is cleared.
+         * @param body - the external body, or NULL to remove it.
+         */
+        void setExternalContent(const Pointer<ExternalMessageBody>& body) {
+            std::vector<unsigned char>().swap(this->content);
+            this->externalContent = body;
+        }
+
+        /**
+         * Gets the application owned body of this Message if one was set.
+         * @return the external body or NULL if the content vector holds the body.
+         */
+        const Pointer<ExternalMessageBody>& getExternalContent() const {
+            return this->externalContent;
+        }
+
+        /**
+         * Gets the bytes that are marshaled as the content of this Message, this is
+         * the content vector unless it is empty and an external body has been set.
+         * @return pointer to the content bytes, or NULL if there are none.
+         */
+        const unsigned char* getContentBytes() const;
+
+        /**
+         * Gets the number of bytes that are marshaled as the content of this Message.
+         * @return the content length in bytes.
+         */
+        int getContentLength() const;
+
         virtual const Pointer<ProducerId>& getProducerId() const;
         virtual Pointer<ProducerId>& getProducerId();
         virtual void setProducerId(const Pointer<ProducerId>& producerId);
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_MESSAGEBODYRELEASER_H_
+#define _ACTIVEMQ_COMMANDS_MESSAGEBODYRELEASER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace commands {
+
+    /**
+     * Callback interface used to return an application owned buffer that was given to
+     * a Message as its body.  The client never copies or frees such a buffer, instead it
+     * calls release once the last Message that references the buffer has been destroyed,
+     * which for a sent Message can be after the send call has returned.
+     *
+     * The callback can be invoked from any thread that drops the final reference to the
+     * Message, implementations should be thread safe and should not block.
+     */
+    class AMQCPP_API MessageBodyReleaser {
+    public:
+
+        virtual ~MessageBodyReleaser();
+
+        /**
+         * Called once the client holds no more references to the given buffer.
+         *
+         * @param buffer
+         *      The buffer that was supplied as the Message body.
+         * @param length
+         *      The number of bytes in the buffer that made up the body.
+         */
+        virtual void release(const unsigned char* buffer, int length) = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_MESSAGEBODYRELEASER_H_ */
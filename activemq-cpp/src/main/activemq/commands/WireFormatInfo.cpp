@@ -307,6 +307,30 @@ void WireFormatInfo::setSizePrefixDisabled(bool sizePrefixDisabled) {
     AMQ_CATCHALL_NOTHROW()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string WireFormatInfo::getCompressionCodecs() const {
+
+    try {
+        if (properties.containsKey("CompressionCodecs")) {
+            return properties.getString("CompressionCodecs");
+        }
+    }
+    AMQ_CATCH_NOTHROW(exceptions::ActiveMQException)
+    AMQ_CATCHALL_NOTHROW()
+
+    return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WireFormatInfo::setCompressionCodecs(const std::string& codecs) {
+
+    try {
+        properties.setString("CompressionCodecs", codecs);
+    }
+    AMQ_CATCH_NOTHROW(exceptions::ActiveMQException)
+    AMQ_CATCHALL_NOTHROW()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void WireFormatInfo::beforeMarshal(WireFormat* wireFormat AMQCPP_UNUSED) {
 
@@ -184,6 +184,20 @@ namespace commands{
          */
         void setSizePrefixDisabled( bool sizePrefixDisabled );
 
+        /**
+         * Gets the names of the Message body compression codecs the sender can
+         * read, as a comma separated list.  Peers that predate codec negotiation
+         * send nothing, in which case an empty string is returned.
+         * @return the comma separated codec names or an empty string.
+         */
+        std::string getCompressionCodecs() const;
+
+        /**
+         * Sets the names of the Message body compression codecs this side can read.
+         * @param codecs - comma separated list of codec names.
+         */
+        void setCompressionCodecs( const std::string& codecs );
+
         /**
          * Get the Magic field
          * @return const reference to a std::vector<char>
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_COMPRESSIONCODEC_H_
+#define _ACTIVEMQ_COMPRESSION_COMPRESSIONCODEC_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace compression {
+
+    /**
+     * A compression algorithm used for Message bodies.
+     *
+     * Codecs work on whole bodies held in memory and must be stateless so that a
+     * single instance can be shared by every Message on every thread.  The output
+     * of a codec has to identify itself from its first bytes, a receiver finds the
+     * codec to use with recognizes() and never needs any other marker.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API CompressionCodec {
+    public:
+
+        virtual ~CompressionCodec();
+
+        /**
+         * @return the name this codec is registered and negotiated under.
+         */
+        virtual std::string getName() const = 0;
+
+        /**
+         * Checks if the given data starts the way this codec's output does.
+         *
+         * @param data
+         *      The compressed data.
+         * @param size
+         *      The number of bytes in the data.
+         *
+         * @return true if this codec produced the data.
+         */
+        virtual bool recognizes(const unsigned char* data, int size) const = 0;
+
+        /**
+         * Compresses the input, replacing the contents of the output vector.
+         *
+         * @param input
+         *      The data to compress.
+         * @param size
+         *      The number of bytes of input.
+         * @param level
+         *      The compression level configured on the Connection, codecs that do
+         *      not support levels ignore it.
+         * @param output
+         *      Receives the compressed data.
+         *
+         * @throws IOException if the data cannot be compressed.
+         */
+        virtual void compress(const unsigned char* input, int size, int level,
+                              std::vector<unsigned char>& output) const = 0;
+
+        /**
+         * Decompresses data written by compress, replacing the contents of the output
+         * vector.
+         *
+         * @param input
+         *      The compressed data.
+         * @param size
+         *      The number of bytes of input.
+         * @param output
+         *      Receives the decompressed data.
+         *
+         * @throws IOException if the data is not valid for this codec.
+         */
+        virtual void decompress(const unsigned char* input, int size,
+                                std::vector<unsigned char>& output) const = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMPRESSION_COMPRESSIONCODEC_H_ */
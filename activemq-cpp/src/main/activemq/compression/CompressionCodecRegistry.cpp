@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionCodecRegistry.h"
+
+#include <activemq/compression/DeflateCompressionCodec.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::compression;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+    CompressionCodecRegistry* theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodecRegistry::CompressionCodecRegistry() : registry() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodecRegistry::~CompressionCodecRegistry() {
+
+    try {
+        this->unregisterAllCodecs();
+    } catch(...) {}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodec* CompressionCodecRegistry::findCodec(const std::string& name) const {
+
+    if (!this->registry.containsKey(name)) {
+        throw NoSuchElementException(__FILE__, __LINE__,
+            "No Matching Compression Codec Registered for name := %s", name.c_str());
+    }
+
+    return this->registry.get(name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodec* CompressionCodecRegistry::findCodecFor(const unsigned char* data, int size) const {
+
+    Pointer< Iterator<CompressionCodec*> > iterator(this->registry.values().iterator());
+    while (iterator->hasNext()) {
+        CompressionCodec* codec = iterator->next();
+        if (codec->recognizes(data, size)) {
+            return codec;
+        }
+    }
+
+    return findCodec(DeflateCompressionCodec::NAME);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecRegistry::registerCodec(CompressionCodec* codec) {
+
+    if (codec == NULL) {
+        throw NullPointerException(__FILE__, __LINE__,
+            "Supplied CompressionCodec pointer was NULL");
+    }
+
+    std::string name = codec->getName();
+
+    // Names are advertised as a comma separated list so they cannot hold one.
+    if (name == "" || name.find(',') != std::string::npos) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "CompressionCodec name cannot be empty or contain a comma: %s", name.c_str());
+    }
+
+    if (this->registry.containsKey(name) && this->registry.get(name) != codec) {
+        delete this->registry.get(name);
+    }
+
+    this->registry.put(name, codec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecRegistry::unregisterCodec(const std::string& name) {
+    if (this->registry.containsKey(name)) {
+        delete this->registry.get(name);
+        this->registry.remove(name);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecRegistry::unregisterAllCodecs() {
+
+    Pointer< Iterator<CompressionCodec*> > iterator(this->registry.values().iterator());
+    while (iterator->hasNext()) {
+        delete iterator->next();
+    }
+
+    this->registry.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> CompressionCodecRegistry::getCodecNames() const {
+    return this->registry.keySet().toArray();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodecRegistry& CompressionCodecRegistry::getInstance() {
+    return *theOnlyInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecRegistry::initialize() {
+    theOnlyInstance = new CompressionCodecRegistry();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecRegistry::shutdown() {
+    theOnlyInstance->unregisterAllCodecs();
+    delete theOnlyInstance;
+    theOnlyInstance = NULL;
+}
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECREGISTRY_H_
+#define _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECREGISTRY_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+#include <vector>
+#include <activemq/compression/CompressionCodec.h>
+
+#include <decaf/util/StlMap.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace compression {
+
+    /**
+     * Registry of the CompressionCodecs available to the client at runtime.  The
+     * deflate and lz4 codecs are registered when the library is initialized, new
+     * codecs can be added before a connection is created.
+     *
+     * The names of the registered codecs are advertised to the broker in the
+     * WireFormatInfo so that a peer can see which bodies this client can read.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API CompressionCodecRegistry {
+    private:
+
+        decaf::util::StlMap<std::string, CompressionCodec*> registry;
+
+    private:
+
+        // Hidden Constructor, prevents instantiation
+        CompressionCodecRegistry();
+
+        // Hidden Copy Constructor
+        CompressionCodecRegistry(const CompressionCodecRegistry& registry);
+
+        // Hidden Assignment operator
+        CompressionCodecRegistry& operator=(const CompressionCodecRegistry& registry);
+
+    public:
+
+        virtual ~CompressionCodecRegistry();
+
+        /**
+         * Gets a registered CompressionCodec by name.
+         *
+         * @param name
+         *        The name of the codec to find in the Registry.
+         *
+         * @return the codec registered under the given name.
+         *
+         * @throws NoSuchElementException if no codec is registered with that name.
+         */
+        CompressionCodec* findCodec(const std::string& name) const;
+
+        /**
+         * Finds the codec that produced the given compressed data.  When no codec
+         * recognizes the data the deflate codec is returned since that is what any
+         * other client would have used.
+         *
+         * @param data
+         *        The compressed data.
+         * @param size
+         *        The number of bytes in the data.
+         *
+         * @return the codec to decompress the data with.
+         *
+         * @throws NoSuchElementException if no codec is registered as deflate.
+         */
+        CompressionCodec* findCodecFor(const unsigned char* data, int size) const;
+
+        /**
+         * Registers a new CompressionCodec under its name.  A codec already registered
+         * with the same name is replaced and deleted.  Once a codec is added to the
+         * Registry its lifetime is controlled by the Registry.
+         *
+         * @param codec
+         *        The new codec to add to the Registry.
+         *
+         * @throws IllegalArgumentException if the codec's name is the empty string
+         *         or contains a comma.
+         * @throws NullPointerException if the codec is Null.
+         */
+        void registerCodec(CompressionCodec* codec);
+
+        /**
+         * Unregisters the codec with the given name and deletes it.
+         *
+         * @param name
+         *        Name of the codec to unregister and destroy.
+         */
+        void unregisterCodec(const std::string& name);
+
+        /**
+         * Removes all codecs and deletes them.
+         */
+        void unregisterAllCodecs();
+
+        /**
+         * Retrieves the names of all the registered codecs.
+         *
+         * @return stl vector of strings with all the codec names registered.
+         */
+        std::vector<std::string> getCodecNames() const;
+
+        /**
+         * Gets the single instance of the CompressionCodecRegistry
+         * @return reference to the single instance of this Registry
+         */
+        static CompressionCodecRegistry& getInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECREGISTRY_H_ */
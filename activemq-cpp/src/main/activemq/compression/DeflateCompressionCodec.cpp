@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DeflateCompressionCodec.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/io/IOException.h>
+#include <decaf/util/zip/Deflater.h>
+#include <decaf/util/zip/Inflater.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::compression;
+using namespace activemq::exceptions;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string DeflateCompressionCodec::NAME = "deflate";
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MIN_BUFFER_SIZE = 512;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeflateCompressionCodec::DeflateCompressionCodec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeflateCompressionCodec::~DeflateCompressionCodec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string DeflateCompressionCodec::getName() const {
+    return NAME;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeflateCompressionCodec::recognizes(const unsigned char* data, int size) const {
+
+    // A zlib stream header names the deflate method and is a multiple of 31.
+    if (size < 2) {
+        return false;
+    }
+
+    return (data[0] & 0x0F) == 8 && (((data[0] << 8) | data[1]) % 31) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeflateCompressionCodec::compress(const unsigned char* input, int size, int level,
+                                       std::vector<unsigned char>& output) const {
+
+    try {
+
+        Deflater deflater(level);
+        if (size > 0) {
+            deflater.setInput(input, size, 0, size);
+        }
+        deflater.finish();
+
+        output.resize((std::size_t) (size / 2 + MIN_BUFFER_SIZE));
+        int written = 0;
+
+        while (!deflater.finished()) {
+            if (written == (int) output.size()) {
+                output.resize(output.size() * 2);
+            }
+            written += deflater.deflate(&output[0], (int) output.size(), written, (int) output.size() - written);
+        }
+
+        output.resize((std::size_t) written);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeflateCompressionCodec::decompress(const unsigned char* input, int size,
+                                         std::vector<unsigned char>& output) const {
+
+    try {
+
+        Inflater inflater;
+        inflater.setInput(input, size, 0, size);
+
+        output.resize((std::size_t) (size * 4 + MIN_BUFFER_SIZE));
+        int written = 0;
+
+        while (!inflater.finished()) {
+
+            if (written == (int) output.size()) {
+                output.resize(output.size() * 2);
+            }
+
+            int count = inflater.inflate(&output[0], (int) output.size(), written, (int) output.size() - written);
+
+            written += count;
+
+            if (count == 0 && !inflater.finished() && (inflater.needsInput() || inflater.needsDictionary())) {
+                throw IOException(__FILE__, __LINE__, "Deflate compressed data is truncated.");
+            }
+        }
+
+        output.resize((std::size_t) written);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_DEFLATECOMPRESSIONCODEC_H_
+#define _ACTIVEMQ_COMPRESSION_DEFLATECOMPRESSIONCODEC_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/compression/CompressionCodec.h>
+
+namespace activemq {
+namespace compression {
+
+    /**
+     * Compresses Message bodies with zlib deflate.  This is the format every other
+     * ActiveMQ client uses for compressed bodies and is the codec used whenever a
+     * peer has not agreed to anything else.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API DeflateCompressionCodec : public CompressionCodec {
+    public:
+
+        static const std::string NAME;
+
+    public:
+
+        DeflateCompressionCodec();
+
+        virtual ~DeflateCompressionCodec();
+
+        virtual std::string getName() const;
+
+        virtual bool recognizes(const unsigned char* data, int size) const;
+
+        virtual void compress(const unsigned char* input, int size, int level,
+                              std::vector<unsigned char>& output) const;
+
+        virtual void decompress(const unsigned char* input, int size,
+                                std::vector<unsigned char>& output) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMPRESSION_DEFLATECOMPRESSIONCODEC_H_ */
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LZ4CompressionCodec.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/internal/util/zip/LZ4Block.h>
+#include <decaf/io/IOException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::compression;
+using namespace activemq::exceptions;
+using namespace decaf::internal::util::zip;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string LZ4CompressionCodec::NAME = "lz4";
+const unsigned char LZ4CompressionCodec::MAGIC = 0x4C;
+const unsigned char LZ4CompressionCodec::VERSION = 1;
+const int LZ4CompressionCodec::HEADER_SIZE = 6;
+
+////////////////////////////////////////////////////////////////////////////////
+LZ4CompressionCodec::LZ4CompressionCodec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LZ4CompressionCodec::~LZ4CompressionCodec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LZ4CompressionCodec::getName() const {
+    return NAME;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool LZ4CompressionCodec::recognizes(const unsigned char* data, int size) const {
+    return size >= HEADER_SIZE && data[0] == MAGIC && data[1] == VERSION;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LZ4CompressionCodec::compress(const unsigned char* input, int size, int level AMQCPP_UNUSED,
+                                   std::vector<unsigned char>& output) const {
+
+    try {
+
+        output.resize((std::size_t) (HEADER_SIZE + LZ4Block::compressBound(size)));
+
+        output[0] = MAGIC;
+        output[1] = VERSION;
+        output[2] = (unsigned char) (size >> 24);
+        output[3] = (unsigned char) (size >> 16);
+        output[4] = (unsigned char) (size >> 8);
+        output[5] = (unsigned char) size;
+
+        int written = LZ4Block::compress(input, size, &output[HEADER_SIZE], (int) output.size() - HEADER_SIZE);
+        output.resize((std::size_t) (HEADER_SIZE + written));
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LZ4CompressionCodec::decompress(const unsigned char* input, int size,
+                                     std::vector<unsigned char>& output) const {
+
+    try {
+
+        if (!recognizes(input, size)) {
+            throw IOException(__FILE__, __LINE__, "Data was not compressed with the LZ4 codec.");
+        }
+
+        int length = (int) (((unsigned int) input[2] << 24) | ((unsigned int) input[3] << 16) |
+                            ((unsigned int) input[4] << 8) | (unsigned int) input[5]);
+
+        // Each byte of an LZ4 block expands to at most 255 bytes of output.
+        if (length < 0 || (long long) length > (long long) (size - HEADER_SIZE) * 255 + 16) {
+            throw IOException(__FILE__, __LINE__, "LZ4 compressed data has an invalid length.");
+        }
+
+        output.resize((std::size_t) length);
+
+        int written = LZ4Block::decompress(input + HEADER_SIZE, size - HEADER_SIZE,
+                                           output.empty() ? NULL : &output[0], length);
+        if (written != length) {
+            throw IOException(__FILE__, __LINE__, "LZ4 compressed data is truncated.");
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_LZ4COMPRESSIONCODEC_H_
+#define _ACTIVEMQ_COMPRESSION_LZ4COMPRESSIONCODEC_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/compression/CompressionCodec.h>
+
+namespace activemq {
+namespace compression {
+
+    /**
+     * Compresses Message bodies as a single LZ4 block.  LZ4 gives up some of the
+     * ratio deflate achieves in exchange for compressing and decompressing many
+     * times faster, which suits latency sensitive flows.
+     *
+     * The compressed body is a six byte header followed by the block.  The header
+     * holds a magic byte, a format version and the uncompressed length as a big
+     * endian int.  The magic byte can never start a zlib stream so the output is
+     * never mistaken for a deflated body.
+     *
+     * Only clients that support this codec can read bodies written with it, so it
+     * should only be used where every consumer is known to support it.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API LZ4CompressionCodec : public CompressionCodec {
+    public:
+
+        static const std::string NAME;
+
+        static const unsigned char MAGIC;
+        static const unsigned char VERSION;
+        static const int HEADER_SIZE;
+
+    public:
+
+        LZ4CompressionCodec();
+
+        virtual ~LZ4CompressionCodec();
+
+        virtual std::string getName() const;
+
+        virtual bool recognizes(const unsigned char* data, int size) const;
+
+        virtual void compress(const unsigned char* input, int size, int level,
+                              std::vector<unsigned char>& output) const;
+
+        virtual void decompress(const unsigned char* input, int size,
+                                std::vector<unsigned char>& output) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMPRESSION_LZ4COMPRESSIONCODEC_H_ */
@@ -19,6 +19,8 @@
 
 #include <cms/Session.h>
 
+#include <activemq/compression/CompressionCodecRegistry.h>
+#include <activemq/compression/DeflateCompressionCodec.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQConnectionMetaData.h>
@@ -33,8 +35,12 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/exceptions/BrokerException.h>
 #include <activemq/exceptions/ConnectionFailedException.h>
+#include <activemq/metrics/MetricsRegistry.h>
+#include <activemq/metrics/Tracer.h>
 #include <activemq/util/CMSExceptionSupport.h>
+#include <activemq/util/DestinationCache.h>
 #include <activemq/util/IdGenerator.h>
+#include <activemq/util/MemoryUsage.h>
 #include <activemq/transport/failover/FailoverTransport.h>
 #include <activemq/transport/ResponseCallback.h>
 #include <activemq/transport/DefaultTransportListener.h>
@@ -43,8 +49,10 @@
 #include <decaf/lang/Math.h>
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
 #include <decaf/util/Iterator.h>
 #include <decaf/util/Set.h>
+#include <decaf/util/StringTokenizer.h>
 #include <decaf/util/Collection.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/UUID.h>
@@ -77,11 +85,13 @@
 using namespace std;
 using namespace cms;
 using namespace activemq;
+using namespace activemq::compression;
 using namespace activemq::core;
 using namespace activemq::core::kernels;
 using namespace activemq::core::policies;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
+using namespace activemq::metrics;
 using namespace activemq::threads;
 using namespace activemq::transport;
 using namespace activemq::transport::failover;
@@ -172,8 +182,10 @@ namespace core {
         bool dispatchAsync;
         bool alwaysSyncSend;
         bool useAsyncSend;
+        bool asyncRegistration;
         bool sendAcksAsync;
         bool messagePrioritySupported;
+        bool weightedFairPriorityDispatch;
         bool watchTopicAdvisories;
         bool useCompression;
         bool useRetroactiveConsumer;
@@ -184,6 +196,9 @@ namespace core {
         bool nonBlockingRedelivery;
         bool alwaysSessionAsync;
         int compressionLevel;
+        std::string compressionCodec;
+        int compressionThreshold;
+        CompressionCodec* volatile activeCodec;
         unsigned int sendTimeout;
         unsigned int closeTimeout;
         unsigned int producerWindowSize;
@@ -210,6 +225,11 @@ namespace core {
 
         Pointer<Exception> firstFailureError;
 
+        // Registrations sent without waiting, and the first of them the Broker refused.
+        decaf::util::concurrent::Mutex registrationLock;
+        int pendingRegistrations;
+        Pointer<Exception> registrationError;
+
         DispatcherMap dispatchers;
         ProducerMap activeProducers;
 
@@ -221,6 +241,22 @@ namespace core {
 
         ConnectionAudit connectionAudit;
 
+        util::DestinationCache destinationCache;
+
+        Pointer<util::MemoryUsage> consumerMemoryUsage;
+
+        MetricsRegistry metrics;
+        Counter* messagesSent;
+        Counter* bytesSent;
+        Counter* messagesReceived;
+        Counter* bytesReceived;
+        Counter* acksSent;
+        Counter* transportInterruptions;
+        Histogram* requestTime;
+        Histogram* ackSendTime;
+        Histogram* reconnectTime;
+        long long interruptedTime;
+
         ConnectionConfig(const Pointer<transport::Transport> transport,
                          const Pointer<decaf::util::Properties> properties) :
                              properties(properties),
@@ -242,8 +278,10 @@ namespace core {
                              dispatchAsync(true),
                              alwaysSyncSend(false),
                              useAsyncSend(false),
+                             asyncRegistration(false),
                              sendAcksAsync(true),
                              messagePrioritySupported(false),
+                             weightedFairPriorityDispatch(false),
                              watchTopicAdvisories(true),
                              useCompression(false),
                              useRetroactiveConsumer(false),
@@ -254,6 +292,9 @@ namespace core {
                              nonBlockingRedelivery(false),
                              alwaysSessionAsync(true),
                              compressionLevel(-1),
+                             compressionCodec(DeflateCompressionCodec::NAME),
+                             compressionThreshold(0),
+                             activeCodec(NULL),
                              sendTimeout(0),
                              closeTimeout(15000),
                              producerWindowSize(0),
@@ -274,18 +315,36 @@ namespace core {
                              brokerInfoReceived(),
                              advisoryConsumer(),
                              firstFailureError(),
+                             registrationLock(),
+                             pendingRegistrations(0),
+                             registrationError(),
                              dispatchers(),
                              activeProducers(),
                              sessionsLock(),
                              activeSessions(),
                              transportListeners(),
-                             activeTempDestinations() {
+                             activeTempDestinations(),
+                             connectionAudit(),
+                             destinationCache(),
+                             consumerMemoryUsage(new util::MemoryUsage()),
+                             metrics(),
+                             messagesSent(metrics.getCounter("messages.sent")),
+                             bytesSent(metrics.getCounter("bytes.sent")),
+                             messagesReceived(metrics.getCounter("messages.received")),
+                             bytesReceived(metrics.getCounter("bytes.received")),
+                             acksSent(metrics.getCounter("acks.sent")),
+                             transportInterruptions(metrics.getCounter("transport.interruptions")),
+                             requestTime(metrics.getHistogram("request.time")),
+                             ackSendTime(metrics.getHistogram("ack.sendTime")),
+                             reconnectTime(metrics.getHistogram("transport.reconnectTime")),
+                             interruptedTime(0) {
 
             this->defaultPrefetchPolicy.reset(new DefaultPrefetchPolicy());
             this->defaultRedeliveryPolicy.reset(new DefaultRedeliveryPolicy());
             this->clientIdGenerator.reset(new util::IdGenerator);
             this->connectionInfo.reset(new ConnectionInfo());
             this->brokerInfoReceived.reset(new CountDownLatch(1));
+            this->activeCodec = CompressionCodecRegistry::getInstance().findCodec(compressionCodec);
 
             // Generate a connectionId
             std::string uniqueId = CONNECTION_ID_GENERATOR.generateId();
@@ -318,6 +377,22 @@ namespace core {
         void waitForBrokerInfo() {
             this->brokerInfoReceived->await();
         }
+
+        // Counts an outgoing Message or MessageAck, elapsed is the time in nanoseconds
+        // that sending it took or -1 if that isn't known.
+        void recordSent(const Pointer<Command>& command, long long elapsed) {
+            if (command->isMessage()) {
+                const commands::Message* message = dynamic_cast<const commands::Message*>(command.get());
+                this->messagesSent->increment();
+                this->bytesSent->add(message->getSize());
+            } else if (command->isMessageAck()) {
+                Tracer::record(TraceEvent::ACK_SENT, command.get());
+                this->acksSent->increment();
+                if (elapsed >= 0) {
+                    this->ackSendTime->record(elapsed);
+                }
+            }
+        }
     };
 
     // Static init.
@@ -479,6 +554,56 @@ namespace core {
         }
     };
 
+    class RegistrationResponseCallback : public ResponseCallback {
+    private:
+
+        ActiveMQConnection* connection;
+        ConnectionConfig* config;
+
+    private:
+
+        RegistrationResponseCallback(const RegistrationResponseCallback&);
+        RegistrationResponseCallback& operator= (const RegistrationResponseCallback&);
+
+    public:
+
+        RegistrationResponseCallback(ActiveMQConnection* connection, ConnectionConfig* config) :
+            ResponseCallback(), connection(connection), config(config) {
+        }
+
+        virtual ~RegistrationResponseCallback() {
+        }
+
+        virtual void onComplete(Pointer<commands::Response> response) {
+
+            Pointer<Exception> error;
+
+            commands::ExceptionResponse* exceptionResponse =
+                dynamic_cast<ExceptionResponse*> (response.get());
+
+            if (exceptionResponse != NULL) {
+                error.reset(exceptionResponse->getException()->createExceptionObject().clone());
+            }
+
+            bool first = false;
+            synchronized(&this->config->registrationLock) {
+                if (error != NULL && this->config->registrationError == NULL) {
+                    this->config->registrationError = error;
+                    first = true;
+                }
+
+                this->config->pendingRegistrations--;
+                this->config->registrationLock.notifyAll();
+            }
+
+            // Only the first failure is fired, a failed transport fails every pending
+            // registration at once and the Connection already reports its own failure.
+            if (first && this->connection->getFirstFailureError() == NULL) {
+                this->connection->onAsyncException(*error);
+            }
+        }
+    };
+
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1068,12 +1193,16 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
 
                     // Message == NULL to signal the end of a Queue Browse.
                     if (message != NULL) {
+                        this->config->messagesReceived->increment();
+                        this->config->bytesReceived->add(message->getSize());
+
                         message->setReadOnlyBody(true);
                         message->setReadOnlyProperties(true);
                         message->setRedeliveryCounter(dispatch->getRedeliveryCounter());
                         message->setConnection(this);
                     }
 
+                    Tracer::record(TraceEvent::CONNECTION_DISPATCH, dispatch.get());
                     dispatcher->dispatch(dispatch);
                 }
             }
@@ -1128,6 +1257,7 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
 void ActiveMQConnection::onWireFormatInfo(Pointer<commands::Command> command AMQCPP_UNUSED) {
     this->config->brokerWireFormatInfo = command.dynamicCast<WireFormatInfo>();
     this->config->protocolVersion->set(this->config->brokerWireFormatInfo->getVersion());
+    this->updateActiveCompressionCodec();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1212,6 +1342,8 @@ void ActiveMQConnection::onClientInternalException(const decaf::lang::Exception&
 void ActiveMQConnection::transportInterrupted() {
 
     this->config->transportInterruptionProcessingComplete->set(0);
+    this->config->transportInterruptions->increment();
+    this->config->interruptedTime = System::nanoTime();
 
     this->config->sessionsLock.readLock().lock();
     try {
@@ -1239,6 +1371,12 @@ void ActiveMQConnection::transportInterrupted() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::transportResumed() {
 
+    // The initial connect also reports a resume, only time real interruptions.
+    if (this->config->interruptedTime != 0) {
+        this->config->reconnectTime->record(System::nanoTime() - this->config->interruptedTime);
+        this->config->interruptedTime = 0;
+    }
+
     synchronized(&this->config->transportListeners) {
         Pointer<Iterator<TransportListener*> > iter(this->config->transportListeners.iterator());
         while (iter->hasNext()) {
@@ -1255,7 +1393,15 @@ void ActiveMQConnection::oneway(Pointer<Command> command) {
 
     try {
         checkClosedOrFailed();
-        this->config->transport->oneway(command);
+
+        if (command->isMessageAck()) {
+            long long start = System::nanoTime();
+            this->config->transport->oneway(command);
+            this->config->recordSent(command, System::nanoTime() - start);
+        } else {
+            this->config->transport->oneway(command);
+            this->config->recordSent(command, -1);
+        }
     }
     AMQ_CATCH_EXCEPTION_CONVERT(IOException, ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::exceptions::UnsupportedOperationException, ActiveMQException)
@@ -1271,6 +1417,7 @@ Pointer<Response> ActiveMQConnection::syncRequest(Pointer<Command> command, unsi
         checkClosedOrFailed();
 
         Pointer<Response> response;
+        long long start = System::nanoTime();
 
         if (timeout == 0) {
             response = this->config->transport->request(command);
@@ -1278,6 +1425,10 @@ Pointer<Response> ActiveMQConnection::syncRequest(Pointer<Command> command, unsi
             response = this->config->transport->request(command, timeout);
         }
 
+        long long elapsed = System::nanoTime() - start;
+        this->config->requestTime->record(elapsed);
+        this->config->recordSent(command, elapsed);
+
         commands::ExceptionResponse* exceptionResponse = dynamic_cast<ExceptionResponse*>(response.get());
 
         if (exceptionResponse != NULL) {
@@ -1307,6 +1458,7 @@ void ActiveMQConnection::asyncRequest(Pointer<Command> command, cms::AsyncCallba
 
         Pointer<ResponseCallback> callback(new AsyncResponseCallback(this->config, onComplete));
         this->config->transport->asyncRequest(command, callback);
+        this->config->recordSent(command, -1);
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(IOException, ActiveMQException)
@@ -1315,6 +1467,80 @@ void ActiveMQConnection::asyncRequest(Pointer<Command> command, cms::AsyncCallba
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::registrationRequest(Pointer<Command> command) {
+
+    try {
+
+        if (!this->config->asyncRegistration) {
+            this->syncRequest(command);
+            return;
+        }
+
+        checkClosedOrFailed();
+
+        synchronized(&this->config->registrationLock) {
+            this->config->pendingRegistrations++;
+        }
+
+        try {
+            Pointer<ResponseCallback> callback(new RegistrationResponseCallback(this, this->config));
+            this->config->transport->asyncRequest(command, callback);
+            this->config->recordSent(command, -1);
+        } catch (Exception& ex) {
+            synchronized(&this->config->registrationLock) {
+                this->config->pendingRegistrations--;
+                this->config->registrationLock.notifyAll();
+            }
+            throw;
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(IOException, ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::exceptions::UnsupportedOperationException, ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::awaitRegistrations(long long timeout) {
+
+    try {
+
+        Pointer<Exception> error;
+
+        synchronized(&this->config->registrationLock) {
+
+            long long deadline = timeout > 0 ? System::currentTimeMillis() + timeout : 0;
+
+            while (this->config->pendingRegistrations > 0) {
+                if (timeout <= 0) {
+                    this->config->registrationLock.wait();
+                } else {
+                    long long remaining = deadline - System::currentTimeMillis();
+                    if (remaining <= 0) {
+                        break;
+                    }
+                    this->config->registrationLock.wait(remaining);
+                }
+            }
+
+            error.swap(this->config->registrationError);
+
+            if (error == NULL && this->config->pendingRegistrations > 0) {
+                return false;
+            }
+        }
+
+        if (error != NULL) {
+            throw *error;
+        }
+
+        return true;
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::checkClosed() const {
     if (this->isClosed()) {
@@ -1353,8 +1579,9 @@ void ActiveMQConnection::ensureConnectionInfoSent() {
                 this->config->connectionInfo->setClientId(this->config->clientIdGenerator->generateId());
             }
 
-            // Now we ping the broker and see if we get an ack / nack
-            syncRequest(this->config->connectionInfo);
+            // Now we ping the broker and see if we get an ack / nack, when registrations
+            // are pipelined the transport keeps this ahead of any session's commands.
+            registrationRequest(this->config->connectionInfo);
 
             this->config->isConnectionInfoSentToBroker = true;
 
@@ -1552,6 +1779,16 @@ void ActiveMQConnection::setUseAsyncSend(bool value) {
     this->config->useAsyncSend = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isAsyncRegistration() const {
+    return this->config->asyncRegistration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setAsyncRegistration(bool value) {
+    this->config->asyncRegistration = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnection::isUseCompression() const {
     return this->config->useCompression;
@@ -1577,6 +1814,69 @@ void ActiveMQConnection::setCompressionLevel(int value) {
     this->config->compressionLevel = Math::min(value, 9);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCompressionCodec(const std::string& name) {
+
+    try {
+        CompressionCodecRegistry::getInstance().findCodec(name);
+    } catch (NoSuchElementException& ex) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "No Compression Codec registered with name: %s", name.c_str());
+    }
+
+    this->config->compressionCodec = name;
+    this->updateActiveCompressionCodec();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnection::getCompressionCodec() const {
+    return this->config->compressionCodec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCompressionThreshold(int value) {
+    this->config->compressionThreshold = Math::max(value, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getCompressionThreshold() const {
+    return this->config->compressionThreshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodec* ActiveMQConnection::getActiveCompressionCodec() const {
+    return this->config->activeCodec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::updateActiveCompressionCodec() {
+
+    std::string name = this->config->compressionCodec;
+
+    // A broker that lists the codecs it accepts wins over our configuration, when it
+    // lists nothing the user's choice stands and they are responsible for the peers.
+    Pointer<WireFormatInfo> info = this->config->brokerWireFormatInfo;
+    if (info != NULL && name != DeflateCompressionCodec::NAME) {
+        std::string advertised = info->getCompressionCodecs();
+        if (!advertised.empty()) {
+            bool found = false;
+            StringTokenizer tokenizer(advertised, ",");
+            while (tokenizer.hasMoreTokens()) {
+                if (tokenizer.nextToken() == name) {
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                name = DeflateCompressionCodec::NAME;
+            }
+        }
+    }
+
+    this->config->activeCodec = CompressionCodecRegistry::getInstance().findCodec(name);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int ActiveMQConnection::getSendTimeout() const {
     return this->config->sendTimeout;
@@ -1637,6 +1937,16 @@ void ActiveMQConnection::setMessagePrioritySupported(bool value) {
     this->config->messagePrioritySupported = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isWeightedFairPriorityDispatch() const {
+    return this->config->weightedFairPriorityDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setWeightedFairPriorityDispatch(bool value) {
+    this->config->weightedFairPriorityDispatch = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::setFirstFailureError(decaf::lang::Exception* error) {
 
@@ -1694,6 +2004,67 @@ ArrayList< Pointer<ActiveMQSessionKernel> > ActiveMQConnection::getSessions() co
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+MetricsRegistry& ActiveMQConnection::getMetricsRegistry() const {
+    return this->config->metrics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+activemq::util::DestinationCache& ActiveMQConnection::getDestinationCache() const {
+    return this->config->destinationCache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<activemq::util::MemoryUsage> ActiveMQConnection::getConsumerMemoryUsage() const {
+    return this->config->consumerMemoryUsage;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot ActiveMQConnection::getMetricsSnapshot() const {
+
+    try {
+
+        long long consumers = 0;
+        long long dispatchQueueDepth = 0;
+        long long deliveredUnacked = 0;
+        long long prefetchLimit = 0;
+        long long bufferedBytes = 0;
+        long long pausedOnMemoryLimit = 0;
+
+        ArrayList< Pointer<ActiveMQSessionKernel> > sessions = getSessions();
+        Pointer< Iterator< Pointer<ActiveMQSessionKernel> > > sessionIter(sessions.iterator());
+        while (sessionIter->hasNext()) {
+
+            ArrayList< Pointer<ActiveMQConsumerKernel> > sessionConsumers = sessionIter->next()->getConsumers();
+            Pointer< Iterator< Pointer<ActiveMQConsumerKernel> > > consumerIter(sessionConsumers.iterator());
+            while (consumerIter->hasNext()) {
+                Pointer<ActiveMQConsumerKernel> consumer = consumerIter->next();
+                consumers++;
+                dispatchQueueDepth += consumer->getMessageAvailableCount();
+                deliveredUnacked += consumer->getDeliveredMessageCount();
+                prefetchLimit += consumer->getConsumerInfo()->getPrefetchSize();
+                bufferedBytes += consumer->getBufferedBytes();
+                if (consumer->isPausedOnMemoryLimit()) {
+                    pausedOnMemoryLimit++;
+                }
+            }
+        }
+
+        this->config->metrics.getGauge("sessions")->set(sessions.size());
+        this->config->metrics.getGauge("consumers")->set(consumers);
+        this->config->metrics.getGauge("consumer.dispatchQueueDepth")->set(dispatchQueueDepth);
+        this->config->metrics.getGauge("consumer.deliveredUnacked")->set(deliveredUnacked);
+        this->config->metrics.getGauge("consumer.prefetchLimit")->set(prefetchLimit);
+        this->config->metrics.getGauge("consumer.bufferedBytes")->set(bufferedBytes);
+        this->config->metrics.getGauge("consumer.pausedOnMemoryLimit")->set(pausedOnMemoryLimit);
+
+        return this->config->metrics.getSnapshot();
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnection::isWatchTopicAdvisories() const {
     return this->config->watchTopicAdvisories;
@@ -1960,3 +2331,13 @@ bool ActiveMQConnection::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnection::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->config->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getConsumerMemoryLimit() const {
+    return (long long) this->config->consumerMemoryUsage->getLimit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setConsumerMemoryLimit(long long limit) {
+    this->config->consumerMemoryUsage->setLimit(limit > 0 ? limit : 0);
+}
@@ -26,6 +26,8 @@
 #include <activemq/commands/ConsumerInfo.h>
 #include <activemq/commands/SessionId.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/metrics/MetricsRegistry.h>
+#include <activemq/metrics/MetricsSnapshot.h>
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/threads/Scheduler.h>
@@ -43,6 +45,13 @@
 #include <memory>
 
 namespace activemq {
+namespace compression {
+    class CompressionCodec;
+}
+namespace util {
+    class DestinationCache;
+    class MemoryUsage;
+}
 namespace core {
 
     using decaf::lang::Pointer;
@@ -461,6 +470,26 @@ namespace core {
          */
         void setUseAsyncSend(bool value);
 
+        /**
+         * Gets if consumer, producer and connection registrations are pipelined.
+         *
+         * @return true if registrations are sent without waiting for the Broker.
+         */
+        bool isAsyncRegistration() const;
+
+        /**
+         * Sets if the ConnectionInfo, ConsumerInfo and ProducerInfo commands sent when
+         * the Connection, its consumers and its producers are created go out without
+         * waiting for each response.  The Broker's answers are checked as they arrive,
+         * the first refusal is reported to the ExceptionListener and can also be
+         * collected with awaitRegistrations.  A consumer or producer the Broker refused
+         * is left open but is of no use and should be closed.
+         *
+         * @param value
+         *      true to pipeline registrations, false to wait for each one (the default).
+         */
+        void setAsyncRegistration(bool value);
+
         /**
          * Gets if the Connection is configured for Message body compression.
          * @return if the Message body will be Compressed or not.
@@ -493,6 +522,51 @@ namespace core {
          */
         int getCompressionLevel() const;
 
+        /**
+         * Sets the name of the CompressionCodec used when Message body compression is
+         * enabled, the default is "deflate" which every ActiveMQ client can read.  Other
+         * codecs such as "lz4" are faster but can only be read by clients that have the
+         * same codec registered.  If the broker advertises the codecs its clients accept
+         * and the configured codec is not one of them the Connection falls back to deflate.
+         *
+         * @param name
+         *      The name of a codec in the CompressionCodecRegistry.
+         *
+         * @throws IllegalArgumentException if no codec is registered with the given name.
+         */
+        void setCompressionCodec(const std::string& name);
+
+        /**
+         * Gets the name of the configured Message body CompressionCodec.
+         *
+         * @return the name of the configured compression codec.
+         */
+        std::string getCompressionCodec() const;
+
+        /**
+         * Sets the minimum size in bytes a Message body must have before it is compressed,
+         * smaller bodies are sent as is.  The default of zero compresses every body.
+         *
+         * @param value
+         *      The minimum body size that is compressed.
+         */
+        void setCompressionThreshold(int value);
+
+        /**
+         * Gets the minimum size in bytes a Message body must have before it is compressed.
+         *
+         * @return the current compression threshold.
+         */
+        int getCompressionThreshold() const;
+
+        /**
+         * Gets the CompressionCodec that outgoing Message bodies are compressed with, this
+         * is the configured codec unless the broker's WireFormatInfo ruled it out.
+         *
+         * @return the codec used to compress Message bodies, never NULL.
+         */
+        activemq::compression::CompressionCodec* getActiveCompressionCodec() const;
+
         /**
          * Gets the assigned send timeout for this Connector
          * @return the send timeout configured in the connection uri
@@ -550,6 +624,24 @@ namespace core {
          */
         void setMessagePrioritySupported(bool value);
 
+        /**
+         * @return true if priority ordered consumers serve the priority levels in weighted
+         *         rounds instead of strictly highest priority first.
+         */
+        bool isWeightedFairPriorityDispatch() const;
+
+        /**
+         * When Message priority is supported, sets whether its consumers and sessions dispatch
+         * in weighted rounds, where each round a priority p level may dispatch up to p + 1
+         * Messages before the levels below it have had their turn.  High priorities are still
+         * favored but a sustained stream of them no longer starves the lower ones.  This is
+         * off by default, which always dispatches the highest priority Message first.
+         *
+         * @param value
+         *      True to enable weighted fair priority dispatch.
+         */
+        void setWeightedFairPriorityDispatch(bool value);
+
         /**
          * Get the Next Temporary Destination Id
          * @return the next id in the sequence.
@@ -822,6 +914,26 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return the limit in bytes on Messages buffered by this Connection's consumers, zero
+         *         when there is no limit.
+         */
+        long long getConsumerMemoryLimit() const;
+
+        /**
+         * Limits the combined size of the Messages that this Connection's consumers hold in
+         * their dispatch queues waiting for a receive call.  Once the limit is reached a
+         * consumer that buffers another Message asks the Broker to stop sending it more by
+         * closing its prefetch window, and reopens it once its own queue empties or the total
+         * drops to half the limit.  The limit is soft, Messages the Broker had already sent
+         * are still accepted, and it applies to consumers created after it is set.  Consumers
+         * with a MessageListener or a zero prefetch don't buffer and are never paused.
+         *
+         * @param limit
+         *      The limit in bytes, zero or less for no limit (the default).
+         */
+        void setConsumerMemoryLimit(long long limit);
+
         /**
          * @return the current connection's OpenWire protocol version.
          */
@@ -963,6 +1075,32 @@ namespace core {
          */
         void asyncRequest(Pointer<commands::Command> command, cms::AsyncCallback* onComplete);
 
+        /**
+         * Sends the Info command that registers a connection, consumer or producer with
+         * the Broker.  This is a syncRequest unless asyncRegistration is enabled, in which
+         * case the command is sent and its response is checked when it arrives.
+         *
+         * @param command
+         *      The Info command that is to be sent to the broker.
+         *
+         * @throws BrokerException if a synchronous registration is refused.
+         * @throws ActiveMQException if any other error occurs while sending the Command.
+         */
+        void registrationRequest(Pointer<commands::Command> command);
+
+        /**
+         * Waits for the Broker to answer every registration pipelined so far and throws
+         * the first refusal among them, once thrown a refusal is not reported again.
+         *
+         * @param timeout
+         *      The time in milliseconds to wait, zero or less waits until all are answered.
+         *
+         * @return true if every registration was answered, false if the wait timed out.
+         *
+         * @throws CMSException if the Broker refused one of the registrations.
+         */
+        bool awaitRegistrations(long long timeout = 0);
+
         /**
          * Notify the exception listener
          * @param ex the exception to fire
@@ -1084,6 +1222,50 @@ namespace core {
          */
         decaf::util::ArrayList< Pointer<activemq::core::kernels::ActiveMQSessionKernel> > getSessions() const;
 
+        /**
+         * Gets the registry that holds this Connection's runtime metrics.  The client
+         * updates these as it runs, all times are in nanoseconds:
+         *
+         *  - messages.sent, bytes.sent, messages.received, bytes.received and acks.sent
+         *    counters.
+         *  - request.time, the round trip time of every synchronous request.
+         *  - ack.sendTime, the time taken to send each MessageAck.
+         *  - transport.interruptions counter and transport.reconnectTime, the time from
+         *    the Transport being interrupted until it resumed.
+         *  - producer.windowBlockedTime, the time a send waited for producer window space.
+         *
+         * Applications can add metrics of their own to the registry.
+         *
+         * @return the MetricsRegistry owned by this Connection.
+         */
+        metrics::MetricsRegistry& getMetricsRegistry() const;
+
+        /**
+         * Samples the sessions, consumers, consumer.dispatchQueueDepth,
+         * consumer.deliveredUnacked, consumer.prefetchLimit, consumer.bufferedBytes and
+         * consumer.pausedOnMemoryLimit gauges from the current Sessions and consumers and
+         * then takes a snapshot of every metric in the registry.
+         *
+         * @return a copy of this Connection's metrics at the time of the call.
+         */
+        metrics::MetricsSnapshot getMetricsSnapshot() const;
+
+        /**
+         * Gets the cache of parsed destinations shared by this Connection's producers.
+         * The destinations it hands out are shared and must not be modified.
+         *
+         * @return the DestinationCache owned by this Connection.
+         */
+        util::DestinationCache& getDestinationCache() const;
+
+        /**
+         * Gets the MemoryUsage that consumers created while a consumer memory limit is set
+         * charge their buffered Messages to.
+         *
+         * @return the consumer MemoryUsage owned by this Connection.
+         */
+        Pointer<util::MemoryUsage> getConsumerMemoryUsage() const;
+
     protected:
 
         /**
@@ -1115,6 +1297,9 @@ namespace core {
         // Process the ConsumerControl command
         void onConsumerControl(Pointer<commands::Command> command);
 
+        // Picks the body compression codec from the configuration and the broker's WireFormatInfo.
+        void updateActiveCompressionCodec();
+
     };
 
 }}
@@ -31,6 +31,7 @@
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQMessageAudit.h>
+#include <activemq/core/policies/AdaptivePrefetchPolicy.h>
 #include <activemq/core/policies/DefaultPrefetchPolicy.h>
 #include <activemq/core/policies/DefaultRedeliveryPolicy.h>
 #include <activemq/util/URISupport.h>
@@ -79,8 +80,10 @@ namespace core{
         bool dispatchAsync;
         bool alwaysSyncSend;
         bool useAsyncSend;
+        bool asyncRegistration;
         bool sendAcksAsync;
         bool messagePrioritySupported;
+        bool weightedFairPriorityDispatch;
         bool useCompression;
         bool useRetroactiveConsumer;
         bool watchTopicAdvisories;
@@ -91,6 +94,8 @@ namespace core{
         bool nonBlockingRedelivery;
         bool alwaysSessionAsync;
         int compressionLevel;
+        std::string compressionCodec;
+        int compressionThreshold;
         unsigned int sendTimeout;
         unsigned int closeTimeout;
         unsigned int producerWindowSize;
@@ -100,6 +105,7 @@ namespace core{
         long long optimizedAckScheduledAckInterval;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        long long consumerMemoryLimit;
 
         cms::ExceptionListener* defaultListener;
         cms::MessageTransformer* defaultTransformer;
@@ -115,8 +121,10 @@ namespace core{
                             dispatchAsync(true),
                             alwaysSyncSend(false),
                             useAsyncSend(false),
+                            asyncRegistration(false),
                             sendAcksAsync(true),
                             messagePrioritySupported(false),
+                            weightedFairPriorityDispatch(false),
                             useCompression(false),
                             useRetroactiveConsumer(false),
                             watchTopicAdvisories(true),
@@ -127,6 +135,8 @@ namespace core{
                             nonBlockingRedelivery(false),
                             alwaysSessionAsync(true),
                             compressionLevel(-1),
+                            compressionCodec("deflate"),
+                            compressionThreshold(0),
                             sendTimeout(0),
                             closeTimeout(15000),
                             producerWindowSize(0),
@@ -136,6 +146,7 @@ namespace core{
                             optimizedAckScheduledAckInterval(0),
                             consumerFailoverRedeliveryWaitPeriod(0),
                             consumerExpiryCheckEnabled(true),
+                            consumerMemoryLimit(0),
                             defaultListener(NULL),
                             defaultTransformer(NULL),
                             defaultPrefetchPolicy(new DefaultPrefetchPolicy()),
@@ -169,13 +180,21 @@ namespace core{
             this->useAsyncSend = Boolean::parseBoolean(
                 properties->getProperty(core::ActiveMQConstants::toString(
                     core::ActiveMQConstants::CONNECTION_USEASYNCSEND), Boolean::toString(useAsyncSend)));
+            this->asyncRegistration = Boolean::parseBoolean(
+                properties->getProperty("connection.asyncRegistration", Boolean::toString(asyncRegistration)));
             this->useCompression = Boolean::parseBoolean(
                 properties->getProperty(core::ActiveMQConstants::toString(
                     core::ActiveMQConstants::CONNECTION_USECOMPRESSION), Boolean::toString(useCompression)));
             this->compressionLevel = Integer::parseInt(
                 properties->getProperty("connection.compressionLevel", Integer::toString(compressionLevel)));
+            this->compressionCodec =
+                properties->getProperty("connection.compressionCodec", compressionCodec);
+            this->compressionThreshold = Integer::parseInt(
+                properties->getProperty("connection.compressionThreshold", Integer::toString(compressionThreshold)));
             this->messagePrioritySupported = Boolean::parseBoolean(
                 properties->getProperty("connection.messagePrioritySupported", Boolean::toString(messagePrioritySupported)));
+            this->weightedFairPriorityDispatch = Boolean::parseBoolean(
+                properties->getProperty("connection.weightedFairPriorityDispatch", Boolean::toString(weightedFairPriorityDispatch)));
             this->checkForDuplicates = Boolean::parseBoolean(
                 properties->getProperty("connection.checkForDuplicates", Boolean::toString(checkForDuplicates)));
             this->auditDepth = Integer::parseInt(
@@ -224,6 +243,20 @@ namespace core{
                 properties->getProperty("connection.alwaysSessionAsync", Boolean::toString(alwaysSessionAsync)));
             this->consumerExpiryCheckEnabled = Boolean::parseBoolean(
                 properties->getProperty("connection.consumerExpiryCheckEnabled", Boolean::toString(consumerExpiryCheckEnabled)));
+            this->consumerMemoryLimit = Long::parseLong(
+                properties->getProperty("connection.consumerMemoryLimit", Long::toString(consumerMemoryLimit)));
+
+            // Switch to the adaptive policy when asked to, keeping any limits already set.
+            if (Boolean::parseBoolean(properties->getProperty("cms.prefetchPolicy.adaptive", "false")) &&
+                !this->defaultPrefetchPolicy->isAdaptive()) {
+
+                std::auto_ptr<PrefetchPolicy> adaptive(new AdaptivePrefetchPolicy());
+                adaptive->setDurableTopicPrefetch(this->defaultPrefetchPolicy->getDurableTopicPrefetch());
+                adaptive->setQueueBrowserPrefetch(this->defaultPrefetchPolicy->getQueueBrowserPrefetch());
+                adaptive->setQueuePrefetch(this->defaultPrefetchPolicy->getQueuePrefetch());
+                adaptive->setTopicPrefetch(this->defaultPrefetchPolicy->getTopicPrefetch());
+                this->defaultPrefetchPolicy = adaptive;
+            }
 
             this->defaultPrefetchPolicy->configure(*properties);
             this->defaultRedeliveryPolicy->configure(*properties);
@@ -398,14 +431,18 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setDispatchAsync(this->settings->dispatchAsync);
     connection->setAlwaysSyncSend(this->settings->alwaysSyncSend);
     connection->setUseAsyncSend(this->settings->useAsyncSend);
+    connection->setAsyncRegistration(this->settings->asyncRegistration);
     connection->setUseCompression(this->settings->useCompression);
     connection->setCompressionLevel(this->settings->compressionLevel);
+    connection->setCompressionCodec(this->settings->compressionCodec);
+    connection->setCompressionThreshold(this->settings->compressionThreshold);
     connection->setSendTimeout(this->settings->sendTimeout);
     connection->setCloseTimeout(this->settings->closeTimeout);
     connection->setProducerWindowSize(this->settings->producerWindowSize);
     connection->setPrefetchPolicy(this->settings->defaultPrefetchPolicy->clone());
     connection->setRedeliveryPolicy(this->settings->defaultRedeliveryPolicy->clone());
     connection->setMessagePrioritySupported(this->settings->messagePrioritySupported);
+    connection->setWeightedFairPriorityDispatch(this->settings->weightedFairPriorityDispatch);
     connection->setWatchTopicAdvisories(this->settings->watchTopicAdvisories);
     connection->setCheckForDuplicates(this->settings->checkForDuplicates);
     connection->setAuditDepth(this->settings->auditDepth);
@@ -421,6 +458,7 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setConsumerFailoverRedeliveryWaitPeriod(this->settings->consumerFailoverRedeliveryWaitPeriod);
     connection->setAlwaysSessionAsync(this->settings->alwaysSessionAsync);
     connection->setConsumerExpiryCheckEnabled(this->settings->consumerExpiryCheckEnabled);
+    connection->setConsumerMemoryLimit(this->settings->consumerMemoryLimit);
 
     if (this->settings->defaultListener) {
         connection->setExceptionListener(this->settings->defaultListener);
@@ -548,6 +586,16 @@ void ActiveMQConnectionFactory::setUseAsyncSend(bool value) {
     this->settings->useAsyncSend = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isAsyncRegistration() const {
+    return this->settings->asyncRegistration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setAsyncRegistration(bool value) {
+    this->settings->asyncRegistration = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isSendAcksAsync() const {
     return this->settings->sendAcksAsync;
@@ -583,6 +631,26 @@ void ActiveMQConnectionFactory::setCompressionLevel(int value) {
     this->settings->compressionLevel = Math::min(value, 9);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnectionFactory::getCompressionCodec() const {
+    return this->settings->compressionCodec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCompressionCodec(const std::string& name) {
+    this->settings->compressionCodec = name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getCompressionThreshold() const {
+    return this->settings->compressionThreshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCompressionThreshold(int value) {
+    this->settings->compressionThreshold = Math::max(value, 0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int ActiveMQConnectionFactory::getSendTimeout() const {
     return this->settings->sendTimeout;
@@ -623,6 +691,16 @@ void ActiveMQConnectionFactory::setMessagePrioritySupported(bool value) {
     this->settings->messagePrioritySupported = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isWeightedFairPriorityDispatch() const {
+    return this->settings->weightedFairPriorityDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setWeightedFairPriorityDispatch(bool value) {
+    this->settings->weightedFairPriorityDispatch = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isWatchTopicAdvisories() const {
     return this->settings->watchTopicAdvisories;
@@ -762,3 +840,13 @@ bool ActiveMQConnectionFactory::isConsumerExpiryCheckEnabled() {
 void ActiveMQConnectionFactory::setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled) {
     this->settings->consumerExpiryCheckEnabled = consumerExpiryCheckEnabled;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getConsumerMemoryLimit() const {
+    return this->settings->consumerMemoryLimit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setConsumerMemoryLimit(long long limit) {
+    this->settings->consumerMemoryLimit = limit;
+}
@@ -318,6 +318,23 @@ namespace core {
          */
         void setUseAsyncSend(bool value);
 
+        /**
+         * Gets if consumer, producer and connection registrations are pipelined.
+         *
+         * @return true if registrations are sent without waiting for the Broker.
+         */
+        bool isAsyncRegistration() const;
+
+        /**
+         * Sets if Connections created by this factory send their consumer, producer and
+         * connection registrations without waiting for each response, see
+         * ActiveMQConnection::setAsyncRegistration.
+         *
+         * @param value
+         *      true to pipeline registrations, false to wait for each one (the default).
+         */
+        void setAsyncRegistration(bool value);
+
         /**
          * Returns whether Message acknowledgments are sent asynchronously meaning no
          * response is required from the broker before the ack completes.
@@ -367,6 +384,39 @@ namespace core {
          */
         int getCompressionLevel() const;
 
+        /**
+         * Sets the name of the CompressionCodec Connections use when Message body
+         * compression is enabled, "deflate" by default.  The name is validated when a
+         * Connection is created.
+         *
+         * @param name
+         *      The name of a codec in the CompressionCodecRegistry.
+         */
+        void setCompressionCodec(const std::string& name);
+
+        /**
+         * Gets the name of the CompressionCodec used for Message bodies.
+         *
+         * @return the name of the configured compression codec.
+         */
+        std::string getCompressionCodec() const;
+
+        /**
+         * Sets the minimum size in bytes a Message body must have before it is
+         * compressed, the default of zero compresses every body.
+         *
+         * @param value
+         *      The minimum body size that is compressed.
+         */
+        void setCompressionThreshold(int value);
+
+        /**
+         * Gets the minimum size in bytes a Message body must have before it is compressed.
+         *
+         * @return the current compression threshold.
+         */
+        int getCompressionThreshold() const;
+
         /**
          * Gets the assigned send timeout for this Connector
          * @return the send timeout configured in the connection uri
@@ -424,6 +474,24 @@ namespace core {
          */
         void setMessagePrioritySupported(bool value);
 
+        /**
+         * @return true if the Connections that this factory creates dispatch prioritized
+         *         Messages in weighted rounds.
+         */
+        bool isWeightedFairPriorityDispatch() const;
+
+        /**
+         * Sets whether the Connections that this factory creates serve the priority levels in
+         * weighted rounds so that low priorities aren't starved by high ones.  Can also be set
+         * with the URI option connection.weightedFairPriorityDispatch.
+         *
+         * @param value
+         *      True to enable weighted fair priority dispatch.
+         *
+         * @see ActiveMQConnection::setWeightedFairPriorityDispatch
+         */
+        void setWeightedFairPriorityDispatch(bool value);
+
         /**
          * Should all created consumers be retroactive.
          *
@@ -672,6 +740,25 @@ namespace core {
          */
         void setConsumerExpiryCheckEnabled(bool consumerExpiryCheckEnabled);
 
+        /**
+         * @return the limit in bytes on Messages buffered by the consumers of Connections
+         *         this factory creates, zero when there is no limit.
+         */
+        long long getConsumerMemoryLimit() const;
+
+        /**
+         * Sets the limit on the combined size of the Messages that the consumers of each
+         * Connection created by this factory hold in their dispatch queues, consumers pause
+         * their prefetch while the limit is reached.  Can also be set with the URI option
+         * connection.consumerMemoryLimit.
+         *
+         * @param limit
+         *      The limit in bytes, zero or less for no limit (the default).
+         *
+         * @see ActiveMQConnection::setConsumerMemoryLimit
+         */
+        void setConsumerMemoryLimit(long long limit);
+
     public:
 
         /**
@@ -149,6 +149,15 @@ cms::Message* ActiveMQConsumer::receiveNoWait() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::vector<cms::Message*> ActiveMQConsumer::receive(int maxMessages, int millisecs) {
+
+    try {
+        return this->config->kernel->receive(maxMessages, millisecs);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumer::setMessageListener(cms::MessageListener* listener) {
 
@@ -163,6 +172,16 @@ int ActiveMQConsumer::getMessageAvailableCount() const {
     return this->config->kernel->getMessageAvailableCount();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumer::getBufferedBytes() const {
+    return this->config->kernel->getBufferedBytes();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumer::isPausedOnMemoryLimit() const {
+    return this->config->kernel->isPausedOnMemoryLimit();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 RedeliveryPolicy* ActiveMQConsumer::getRedeliveryPolicy() const {
     return this->config->kernel->getRedeliveryPolicy();
@@ -188,6 +207,16 @@ decaf::lang::Exception* ActiveMQConsumer::getFailureError() const {
     return this->config->kernel->getFailureError();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::setLocalSelector(const std::string& selector) {
+    this->config->kernel->setLocalSelector(selector);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConsumer::getLocalSelector() const {
+    return this->config->kernel->getLocalSelector();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumer::setMessageTransformer(cms::MessageTransformer* transformer) {
     this->config->kernel->setMessageTransformer(transformer);
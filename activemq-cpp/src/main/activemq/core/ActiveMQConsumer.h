@@ -17,7 +17,7 @@
 #ifndef _ACTIVEMQ_CORE_ACTIVEMQCONSUMER_H_
 #define _ACTIVEMQ_CORE_ACTIVEMQCONSUMER_H_
 
-#include <cms/MessageConsumer.h>
+#include <cms/BatchMessageConsumer.h>
 #include <cms/MessageListener.h>
 #include <cms/Message.h>
 #include <cms/CMSException.h>
@@ -37,7 +37,7 @@ namespace core {
     class ActiveMQSession;
     class ActiveMQConsumerData;
 
-    class AMQCPP_API ActiveMQConsumer : public cms::MessageConsumer {
+    class AMQCPP_API ActiveMQConsumer : public cms::BatchMessageConsumer {
     private:
 
         ActiveMQConsumerData* config;
@@ -88,6 +88,10 @@ namespace core {
 
         virtual cms::MessageTransformer* getMessageTransformer() const;
 
+    public:  // Interface Implementation for cms::BatchMessageConsumer
+
+        virtual std::vector<cms::Message*> receive(int maxMessages, int millisecs);
+
     public:
 
         /**
@@ -112,6 +116,19 @@ namespace core {
          */
         int getMessageAvailableCount() const;
 
+        /**
+         * @return the combined size in bytes of the Message's this consumer is waiting to Dispatch.
+         */
+        long long getBufferedBytes() const;
+
+        /**
+         * @return true while this consumer has closed its prefetch window because its
+         *         Connection's consumer memory limit was reached.
+         *
+         * @see ActiveMQConnection::setConsumerMemoryLimit
+         */
+        bool isPausedOnMemoryLimit() const;
+
         /**
          * Sets the RedeliveryPolicy this Consumer should use when a rollback is
          * performed on a transacted Consumer.  The Consumer takes ownership of the
@@ -139,6 +156,25 @@ namespace core {
          */
         decaf::lang::Exception* getFailureError() const;
 
+        /**
+         * Sets a selector that this consumer evaluates itself against each Message the
+         * Broker dispatches to it, on top of any selector the Broker has applied.  Messages
+         * that don't match are consumed under the session's acknowledgement mode without
+         * being delivered.  The selector applies to Messages delivered or received after
+         * this call, an empty string removes it.
+         *
+         * @param selector
+         *      The JMS selector to evaluate locally.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         */
+        void setLocalSelector(const std::string& selector);
+
+        /**
+         * @return the selector this consumer evaluates locally, or an empty string if none.
+         */
+        std::string getLocalSelector() const;
+
         /**
          * Time in Milliseconds before an automatic acknowledge is done for any outstanding
          * delivered Messages.  A value less than one means no task is scheduled.
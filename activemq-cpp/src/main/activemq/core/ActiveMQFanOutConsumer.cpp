@@ -0,0 +1,567 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ActiveMQFanOutConsumer.h"
+
+#include <activemq/util/CMSExceptionSupport.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/selector/SelectorParser.h>
+#include <activemq/commands/Message.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/MapMessage.h>
+#include <cms/StreamMessage.h>
+#include <cms/TextMessage.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/Iterator.h>
+#include <decaf/util/concurrent/CopyOnWriteArrayList.h>
+#include <decaf/util/concurrent/ExecutorService.h>
+#include <decaf/util/concurrent/Executors.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/Semaphore.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicReference.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::exceptions;
+using namespace activemq::selector;
+using namespace activemq::util;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+const int ActiveMQFanOutConsumer::DEFAULT_MAX_PENDING_MESSAGES = 1000;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    typedef AtomicReference<cms::ExceptionListener> ExceptionListenerRef;
+
+    /**
+     * A listener together with the executor that calls it and the permits that
+     * bound the number of Messages queued for it.
+     */
+    class FanOutListener {
+    private:
+
+        FanOutListener(const FanOutListener&);
+        FanOutListener& operator=(const FanOutListener&);
+
+    public:
+
+        cms::MessageListener* listener;
+        Pointer<MessageSelector> selector;
+        Pointer<ExecutorService> executor;
+        Pointer<ExceptionListenerRef> exceptionListener;
+        Semaphore pending;
+        Mutex mutex;
+        bool closed;
+        Thread* deliveryThread;
+
+        FanOutListener(cms::MessageListener* listener, const Pointer<MessageSelector>& selector,
+                       const Pointer<ExceptionListenerRef>& exceptionListener, int maxPending) :
+            listener(listener), selector(selector), executor(Executors::newSingleThreadExecutor()),
+            exceptionListener(exceptionListener), pending(maxPending), mutex(), closed(false),
+            deliveryThread(NULL) {}
+
+        ~FanOutListener() {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+
+        bool isClosed() {
+            synchronized(&mutex) {
+                return closed;
+            }
+
+            return true;
+        }
+
+        bool isDeliveryThread() {
+            synchronized(&mutex) {
+                return deliveryThread == Thread::currentThread();
+            }
+
+            return false;
+        }
+
+        /**
+         * Stops accepting Messages and waits for the ones already queued to be delivered,
+         * unless called from the listener itself which would then be waiting on its own
+         * executor.
+         *
+         * @return true once the executor has finished, false if it is still running the
+         *         remaining Messages, in which case this object must be kept until it has.
+         */
+        bool close() {
+            synchronized(&mutex) {
+                closed = true;
+            }
+
+            executor->shutdown();
+
+            if (isDeliveryThread()) {
+                return false;
+            }
+
+            return executor->awaitTermination(60, TimeUnit::SECONDS);
+        }
+
+        void reportFailure(const cms::CMSException& ex) {
+            cms::ExceptionListener* target = exceptionListener->get();
+            if (target != NULL) {
+                try {
+                    target->onException(ex);
+                } catch (...) {
+                }
+            }
+        }
+    };
+
+    /**
+     * Delivers one Message to a listener.  The FanOutListener is kept by the fan out
+     * consumer until its executor has terminated, so the task does not share ownership
+     * of it; the executor is never left to be destroyed from its own thread.
+     */
+    class DeliveryTask : public Runnable {
+    private:
+
+        FanOutListener* target;
+        Pointer<cms::Message> message;
+
+    private:
+
+        DeliveryTask(const DeliveryTask&);
+        DeliveryTask& operator=(const DeliveryTask&);
+
+    public:
+
+        DeliveryTask(FanOutListener* target, const Pointer<cms::Message>& message) :
+            Runnable(), target(target), message(message) {}
+
+        virtual ~DeliveryTask() {}
+
+        virtual void run() {
+
+            synchronized(&target->mutex) {
+                target->deliveryThread = Thread::currentThread();
+            }
+
+            // The Message was acknowledged when it was handed off, there is nothing to
+            // roll back so the failure is only reported.
+            try {
+                target->listener->onMessage(message.get());
+            } catch (cms::CMSException& ex) {
+                target->reportFailure(ex);
+            } catch (decaf::lang::Exception& ex) {
+                target->reportFailure(CMSExceptionSupport::create(ex));
+            } catch (std::exception& ex) {
+                target->reportFailure(cms::CMSException(ex.what()));
+            } catch (...) {
+                target->reportFailure(cms::CMSException("MessageListener threw an unknown exception"));
+            }
+
+            target->pending.release();
+        }
+    };
+
+    /**
+     * The bodies of Bytes and Stream Messages are read through a cursor that lives
+     * in the Message, so concurrent readers each need their own copy.
+     */
+    bool isShareable(const cms::Message* message) {
+        return dynamic_cast<const cms::BytesMessage*>(message) == NULL &&
+               dynamic_cast<const cms::StreamMessage*>(message) == NULL;
+    }
+
+    /**
+     * Copies the Message a listener is given, clone leaves the copy writable so it
+     * is made read-only again the way the consumer delivered it.  Text and Map bodies
+     * are decoded on first access and then cached in the Message, they are decoded
+     * here so the listeners that share a copy only ever read it.
+     */
+    Pointer<cms::Message> copyForListeners(const cms::Message* message) {
+
+        Pointer<cms::Message> copy(message->clone());
+
+        commands::Message* amqMessage = dynamic_cast<commands::Message*>(copy.get());
+        if (amqMessage != NULL) {
+            amqMessage->setReadOnlyProperties(true);
+            amqMessage->setReadOnlyBody(true);
+        }
+
+        cms::BytesMessage* bytesMessage = dynamic_cast<cms::BytesMessage*>(copy.get());
+        if (bytesMessage != NULL) {
+            bytesMessage->reset();
+            return copy;
+        }
+
+        cms::StreamMessage* streamMessage = dynamic_cast<cms::StreamMessage*>(copy.get());
+        if (streamMessage != NULL) {
+            streamMessage->reset();
+            return copy;
+        }
+
+        const cms::TextMessage* textMessage = dynamic_cast<const cms::TextMessage*>(copy.get());
+        if (textMessage != NULL) {
+            textMessage->getText();
+            return copy;
+        }
+
+        const cms::MapMessage* mapMessage = dynamic_cast<const cms::MapMessage*>(copy.get());
+        if (mapMessage != NULL) {
+            mapMessage->getMapNames();
+        }
+
+        return copy;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+
+    class ActiveMQFanOutConsumerData : public cms::MessageListener {
+    private:
+
+        ActiveMQFanOutConsumerData(const ActiveMQFanOutConsumerData&);
+        ActiveMQFanOutConsumerData& operator=(const ActiveMQFanOutConsumerData&);
+
+    public:
+
+        std::auto_ptr<cms::MessageConsumer> consumer;
+        CopyOnWriteArrayList< Pointer<FanOutListener> > listeners;
+        Pointer<ExceptionListenerRef> exceptionListener;
+        int maxPendingMessages;
+        AtomicBoolean closed;
+
+        // Listeners whose executor was still running when they were closed, because they
+        // were closed from their own thread or took too long to drain.  They are kept here
+        // until the executor has finished since the queued DeliveryTasks still use them.
+        std::vector< Pointer<FanOutListener> > retired;
+        Mutex retiredMutex;
+
+        ActiveMQFanOutConsumerData(cms::MessageConsumer* consumer, int maxPendingMessages) :
+            cms::MessageListener(), consumer(consumer), listeners(),
+            exceptionListener(new ExceptionListenerRef()), maxPendingMessages(maxPendingMessages),
+            closed(), retired(), retiredMutex() {}
+
+        virtual ~ActiveMQFanOutConsumerData() {
+
+            // Only an executor that has terminated can be destroyed, one that is running
+            // the calling thread can never finish and is left behind.
+            std::vector< Pointer<FanOutListener> >::iterator iter = retired.begin();
+            for (; iter != retired.end(); ++iter) {
+                if ((*iter)->isDeliveryThread()) {
+                    iter->release();
+                    continue;
+                }
+
+                while (!(*iter)->executor->awaitTermination(60, TimeUnit::SECONDS)) {
+                }
+            }
+        }
+
+        virtual void onMessage(const cms::Message* message) {
+
+            std::auto_ptr< Iterator< Pointer<FanOutListener> > > iter(listeners.iterator());
+            if (!iter->hasNext()) {
+                return;
+            }
+
+            Pointer<cms::Message> shared;
+            if (isShareable(message)) {
+                shared = copyForListeners(message);
+            }
+
+            while (iter->hasNext()) {
+                Pointer<FanOutListener> target = iter->next();
+
+                if (target->selector != NULL && !target->selector->matches(message)) {
+                    continue;
+                }
+
+                Pointer<cms::Message> copy = shared;
+                if (copy == NULL) {
+                    copy = copyForListeners(message);
+                }
+
+                // Blocks while the listener is too far behind, but gives up once the listener
+                // or this object is closed since the close may be waiting on this thread.
+                bool acquired = false;
+                while (!(acquired = target->pending.tryAcquire(100, TimeUnit::MILLISECONDS))) {
+                    if (closed.get() || target->isClosed()) {
+                        break;
+                    }
+                }
+
+                if (!acquired) {
+                    continue;
+                }
+
+                synchronized(&target->mutex) {
+                    if (target->closed) {
+                        target->pending.release();
+                    } else {
+                        target->executor->execute(new DeliveryTask(target.get(), copy));
+                    }
+                }
+            }
+        }
+
+        Pointer<FanOutListener> find(cms::MessageListener* listener) const {
+            std::auto_ptr< Iterator< Pointer<FanOutListener> > > iter(listeners.iterator());
+            while (iter->hasNext()) {
+                Pointer<FanOutListener> target = iter->next();
+                if (target->listener == listener) {
+                    return target;
+                }
+            }
+
+            return Pointer<FanOutListener>();
+        }
+
+        void closeListener(const Pointer<FanOutListener>& target) {
+
+            if (!target->close()) {
+                synchronized(&retiredMutex) {
+                    retired.push_back(target);
+                }
+            }
+
+            reapRetired();
+        }
+
+        /**
+         * Waits for the executors of the retired listeners to finish, other than the one
+         * that may be running the calling thread.
+         */
+        void awaitRetired() {
+
+            std::vector< Pointer<FanOutListener> > waiting;
+            synchronized(&retiredMutex) {
+                waiting = retired;
+            }
+
+            std::vector< Pointer<FanOutListener> >::iterator iter = waiting.begin();
+            for (; iter != waiting.end(); ++iter) {
+                if (!(*iter)->isDeliveryThread()) {
+                    (*iter)->executor->awaitTermination(60, TimeUnit::SECONDS);
+                }
+            }
+
+            reapRetired();
+        }
+
+        /**
+         * Drops the retired listeners whose executor has finished.
+         */
+        void reapRetired() {
+
+            std::vector< Pointer<FanOutListener> > finished;
+
+            synchronized(&retiredMutex) {
+                std::vector< Pointer<FanOutListener> >::iterator iter = retired.begin();
+                while (iter != retired.end()) {
+                    if ((*iter)->executor->isTerminated()) {
+                        finished.push_back(*iter);
+                        iter = retired.erase(iter);
+                    } else {
+                        ++iter;
+                    }
+                }
+            }
+
+            // The finished listeners are released here, outside of the lock.
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQFanOutConsumer::ActiveMQFanOutConsumer(cms::MessageConsumer* consumer, int maxPendingMessages) : config(NULL) {
+
+    try {
+
+        if (consumer == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Consumer cannot be NULL");
+        }
+
+        if (maxPendingMessages < 1) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "Maximum pending messages must be at least one: %d", maxPendingMessages);
+        }
+
+        if (consumer->getMessageListener() != NULL) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "Consumer already has a MessageListener");
+        }
+
+        std::auto_ptr<ActiveMQFanOutConsumerData> data(new ActiveMQFanOutConsumerData(consumer, maxPendingMessages));
+
+        try {
+            consumer->setMessageListener(data.get());
+        } catch (...) {
+            data->consumer.release();
+            throw;
+        }
+
+        this->config = data.release();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQFanOutConsumer::~ActiveMQFanOutConsumer() {
+
+    try {
+
+        try {
+            close();
+        } catch (...) {
+        }
+
+        delete this->config;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumer::addMessageListener(cms::MessageListener* listener) {
+    this->addMessageListener(listener, "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumer::addMessageListener(cms::MessageListener* listener, const std::string& selector) {
+
+    try {
+
+        if (listener == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "MessageListener cannot be NULL");
+        }
+
+        Pointer<MessageSelector> compiled;
+        if (!selector.empty()) {
+            compiled = SelectorParser::parse(selector);
+        }
+
+        synchronized(&this->config->listeners) {
+
+            if (this->config->closed.get()) {
+                throw ActiveMQException(__FILE__, __LINE__, "Fan out consumer is closed");
+            }
+
+            if (this->config->find(listener) != NULL) {
+                throw IllegalArgumentException(__FILE__, __LINE__, "MessageListener was already added");
+            }
+
+            this->config->listeners.add(Pointer<FanOutListener>(new FanOutListener(
+                listener, compiled, this->config->exceptionListener, this->config->maxPendingMessages)));
+        }
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQFanOutConsumer::removeMessageListener(cms::MessageListener* listener) {
+
+    try {
+
+        Pointer<FanOutListener> target;
+
+        synchronized(&this->config->listeners) {
+            target = this->config->find(listener);
+            if (target == NULL) {
+                return false;
+            }
+
+            this->config->listeners.remove(target);
+        }
+
+        this->config->closeListener(target);
+        return true;
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQFanOutConsumer::getMessageListenerCount() const {
+    return this->config->listeners.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::MessageConsumer* ActiveMQFanOutConsumer::getMessageConsumer() const {
+    return this->config->consumer.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQFanOutConsumer::getMaxPendingMessages() const {
+    return this->config->maxPendingMessages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumer::setExceptionListener(cms::ExceptionListener* listener) {
+    this->config->exceptionListener->set(listener);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::ExceptionListener* ActiveMQFanOutConsumer::getExceptionListener() const {
+    return this->config->exceptionListener->get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumer::close() {
+
+    try {
+
+        if (!this->config->closed.compareAndSet(false, true)) {
+            return;
+        }
+
+        // The listeners are closed first, the session may be blocked handing a Message
+        // to one that is behind and the consumer can't be closed until it gives up.
+        std::vector< Pointer<FanOutListener> > listeners;
+        synchronized(&this->config->listeners) {
+            listeners = this->config->listeners.toArray();
+            this->config->listeners.clear();
+        }
+
+        for (std::size_t i = 0; i < listeners.size(); ++i) {
+            this->config->closeListener(listeners[i]);
+        }
+
+        this->config->consumer->close();
+        this->config->awaitRetired();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
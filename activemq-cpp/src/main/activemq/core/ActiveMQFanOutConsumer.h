@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMER_H_
+#define _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMER_H_
+
+#include <cms/Closeable.h>
+#include <cms/ExceptionListener.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageListener.h>
+
+#include <activemq/util/Config.h>
+
+#include <string>
+
+namespace activemq {
+namespace core {
+
+    class ActiveMQFanOutConsumerData;
+
+    /**
+     * Delivers the Messages of a single MessageConsumer to any number of local
+     * MessageListeners, so that a process with many listeners interested in the same
+     * subscription only registers one consumer with the Broker and receives and
+     * unmarshals each Message once instead of once per listener.
+     *
+     * Each listener is called from its own single threaded executor, in the order the
+     * Messages arrived, and is given a read-only Message that is shared with the other
+     * listeners.  BytesMessage and StreamMessage bodies are read through a cursor, so
+     * each listener is given its own copy of those.  A listener may be registered with
+     * a selector that is evaluated locally, in which case it only sees the Messages
+     * that match it.
+     *
+     * <b>Delivery to the listeners is at-most-once.</b>  Messages are handed off from
+     * the consumer's MessageListener callback, so they are acknowledged once every
+     * interested listener has had them queued, not when the listeners are done with
+     * them.  A Message that is still queued, or whose listener throws, when the process
+     * fails is lost rather than redelivered.  The consumer is therefore meant to be
+     * created on an AUTO_ACKNOWLEDGE or DUPS_OK_ACKNOWLEDGE session, applications that
+     * can not lose a Message should give each listener its own consumer instead.
+     *
+     * A listener that falls behind by more than its maximum number of pending Messages
+     * holds up the delivery to the others, and through the prefetch window, the Broker.
+     * Exceptions thrown from a listener are passed to the ExceptionListener set on this
+     * object, if any, and do not stop the delivery of later Messages.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API ActiveMQFanOutConsumer : public cms::Closeable {
+    private:
+
+        ActiveMQFanOutConsumerData* config;
+
+    private:
+
+        ActiveMQFanOutConsumer(const ActiveMQFanOutConsumer&);
+        ActiveMQFanOutConsumer& operator=(const ActiveMQFanOutConsumer&);
+
+    public:
+
+        /**
+         * The default number of Messages that can be waiting for a listener.
+         */
+        static const int DEFAULT_MAX_PENDING_MESSAGES;
+
+        /**
+         * Creates a fan out consumer that delivers the Messages of the given consumer
+         * to the listeners added to it.
+         *
+         * @param consumer
+         *      The consumer whose Messages are delivered, this object takes ownership of
+         *      it and becomes its MessageListener.
+         * @param maxPendingMessages
+         *      The number of Messages that can be waiting for any one listener before
+         *      delivery to it blocks.
+         *
+         * @throws CMSException if the consumer is NULL, already has a MessageListener
+         *         or the maximum number of pending Messages is less than one.
+         */
+        ActiveMQFanOutConsumer(cms::MessageConsumer* consumer,
+                               int maxPendingMessages = DEFAULT_MAX_PENDING_MESSAGES);
+
+        /**
+         * Closes this object and waits for the listeners to finish, it must not be
+         * deleted from one of its own listeners.
+         */
+        virtual ~ActiveMQFanOutConsumer();
+
+    public:
+
+        /**
+         * Adds a listener that is given every Message the consumer receives from now on.
+         *
+         * @param listener
+         *      The listener to add, the caller retains ownership of it.
+         *
+         * @throws CMSException if the listener is NULL, already added or this object is closed.
+         */
+        void addMessageListener(cms::MessageListener* listener);
+
+        /**
+         * Adds a listener that is given the Messages the consumer receives from now on
+         * that match the given selector.
+         *
+         * @param listener
+         *      The listener to add, the caller retains ownership of it.
+         * @param selector
+         *      The JMS selector Messages must match to be given to this listener, an empty
+         *      string matches all Messages.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         * @throws CMSException if the listener is NULL, already added or this object is closed.
+         */
+        void addMessageListener(cms::MessageListener* listener, const std::string& selector);
+
+        /**
+         * Removes a listener, waiting for the Messages already queued for it to be
+         * delivered.  A listener that removes itself from its own onMessage call is
+         * not waited on, the Messages still queued for it are delivered after the call
+         * returns.
+         *
+         * @param listener
+         *      The listener to remove.
+         *
+         * @return true if the listener was found and removed.
+         */
+        bool removeMessageListener(cms::MessageListener* listener);
+
+        /**
+         * @return the number of listeners currently added.
+         */
+        int getMessageListenerCount() const;
+
+        /**
+         * @return the consumer whose Messages are delivered, still owned by this object.
+         */
+        cms::MessageConsumer* getMessageConsumer() const;
+
+        /**
+         * @return the number of Messages that can be waiting for any one listener.
+         */
+        int getMaxPendingMessages() const;
+
+        /**
+         * Sets the listener that is told about exceptions thrown from the MessageListeners.
+         *
+         * @param listener
+         *      The listener to notify, or NULL to discard the exceptions, the caller
+         *      retains ownership of it.
+         */
+        void setExceptionListener(cms::ExceptionListener* listener);
+
+        /**
+         * @return the listener that is told about exceptions thrown from the MessageListeners.
+         */
+        cms::ExceptionListener* getExceptionListener() const;
+
+    public:  // Interface Implementation for cms::Closeable
+
+        /**
+         * Stops handing Messages to the listeners, waits for them to be given the Messages
+         * that were already queued for them, other than the listener this is called from,
+         * and then closes the consumer.  This can be called from a listener.
+         *
+         * @throws CMSException if an error occurs while closing the consumer.
+         */
+        virtual void close();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMER_H_ */
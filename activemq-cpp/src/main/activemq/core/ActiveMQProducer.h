@@ -25,6 +25,7 @@
 #include <activemq/util/Config.h>
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
+#include <activemq/core/ProducerWindowListener.h>
 
 namespace activemq {
 namespace core {
@@ -184,6 +185,121 @@ namespace core {
 
     public:
 
+        /**
+         * Sends the message using the Producer's defaults if the producer window has space,
+         * never blocking on the window.
+         *
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window was full.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(cms::Message* message);
+
+        /**
+         * Sends the message if the producer window has space, never blocking on the window.
+         *
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         *
+         * @return true if the message was sent, false if the producer window was full.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(cms::Message* message, int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends the message to the given Destination using the Producer's defaults if the
+         * producer window has space, never blocking on the window.
+         *
+         * @param destination
+         *      The destination on which to send the message
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window was full.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message);
+
+        /**
+         * Sends the message to the given Destination if the producer window has space, never
+         * blocking on the window.  When false is returned the registered ProducerWindowListener
+         * is notified once the broker frees space in the window.
+         *
+         * @param destination
+         *      The destination on which to send the message
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         *
+         * @return true if the message was sent, false if the producer window was full.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        bool trySend(const cms::Destination* destination, cms::Message* message,
+                     int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sets the listener notified when the producer window has space again after a
+         * call to trySend found it full.
+         *
+         * @param listener
+         *      The ProducerWindowListener to notify, or NULL to clear it.
+         */
+        void setProducerWindowListener(ProducerWindowListener* listener) {
+            this->kernel->setProducerWindowListener(listener, this);
+        }
+
+        /**
+         * @return the registered ProducerWindowListener or NULL if none is set.
+         */
+        ProducerWindowListener* getProducerWindowListener() const {
+            return this->kernel->getProducerWindowListener();
+        }
+
+        /**
+         * @return the size in bytes of the producer window, zero if flow control is not in use.
+         */
+        unsigned long long getProducerWindowSize() const {
+            return this->kernel->getProducerWindowSize();
+        }
+
+        /**
+         * @return the number of sent bytes not yet acknowledged by the broker.
+         */
+        unsigned long long getProducerWindowUsage() const {
+            return this->kernel->getProducerWindowUsage();
+        }
+
+        /**
+         * @return true if the producer window is currently full.
+         */
+        bool isProducerWindowFull() const {
+            return this->kernel->isProducerWindowFull();
+        }
+
+        /**
+         * @return the number of sends that found the producer window full.
+         */
+        long long getProducerWindowFullCount() const {
+            return this->kernel->getProducerWindowFullCount();
+        }
+
         /**
          * @return true if this Producer has been closed.
          */
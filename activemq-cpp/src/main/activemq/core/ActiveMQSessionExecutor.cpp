@@ -22,8 +22,9 @@
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/FifoMessageDispatchChannel.h>
-#include <activemq/core/SimplePriorityMessageDispatchChannel.h>
+#include <activemq/core/PriorityMessageDispatchChannel.h>
 #include <activemq/commands/ConsumerInfo.h>
+#include <activemq/metrics/Tracer.h>
 #include <activemq/threads/DedicatedTaskRunner.h>
 
 using namespace std;
@@ -41,7 +42,8 @@ ActiveMQSessionExecutor::ActiveMQSessionExecutor(ActiveMQSessionKernel* session)
     session(session), messageQueue(), taskRunner() {
 
     if (this->session->getConnection()->isMessagePrioritySupported()) {
-        this->messageQueue.reset(new SimplePriorityMessageDispatchChannel());
+        this->messageQueue.reset(new PriorityMessageDispatchChannel(
+            this->session->getConnection()->isWeightedFairPriorityDispatch()));
     } else {
         this->messageQueue.reset(new FifoMessageDispatchChannel());
     }
@@ -157,6 +159,8 @@ void ActiveMQSessionExecutor::dispatch(const Pointer<MessageDispatch>& dispatch)
 
     try {
 
+        metrics::Tracer::record(metrics::TraceEvent::SESSION_DEQUEUE, dispatch.get());
+
         Pointer<ActiveMQConsumerKernel> consumer =
             this->session->lookupConsumerKernel(dispatch->getConsumerId());
 
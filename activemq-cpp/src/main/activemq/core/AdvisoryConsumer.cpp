@@ -74,7 +74,7 @@ AdvisoryConsumer::AdvisoryConsumer(ActiveMQConnection* connection, Pointer<comma
 
     try {
         this->connection->addDispatcher(this->config->info->getConsumerId(), this);
-        this->connection->syncRequest(this->config->info);
+        this->connection->registrationRequest(this->config->info);
     } catch(...) {
         delete this->config;
         throw;
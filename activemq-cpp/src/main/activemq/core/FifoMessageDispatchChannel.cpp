@@ -17,6 +17,8 @@
 
 #include "FifoMessageDispatchChannel.h"
 
+#include <activemq/exceptions/ExceptionDefines.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::core;
@@ -28,7 +30,8 @@ using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-FifoMessageDispatchChannel::FifoMessageDispatchChannel() : closed(false), running(false), channel() {
+FifoMessageDispatchChannel::FifoMessageDispatchChannel() :
+    closed(false), running(false), channel() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +42,7 @@ FifoMessageDispatchChannel::~FifoMessageDispatchChannel() {
 void FifoMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
     synchronized(&channel) {
         channel.addLast(message);
+        charge(message);
         channel.notify();
     }
 }
@@ -47,6 +51,7 @@ void FifoMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message
 void FifoMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
     synchronized(&channel) {
         channel.addFirst(message);
+        charge(message);
         channel.notify();
     }
 }
@@ -78,7 +83,7 @@ Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeue(long long timeout)
             return Pointer<MessageDispatch>();
         }
 
-        return channel.pop();
+        return removeFirst();
     }
 
     return Pointer<MessageDispatch>();
@@ -90,12 +95,28 @@ Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeueNoWait() {
         if (closed || !running || channel.isEmpty()) {
             return Pointer<MessageDispatch>();
         }
-        return channel.pop();
+        return removeFirst();
     }
 
     return Pointer<MessageDispatch>();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int FifoMessageDispatchChannel::drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages) {
+    int count = 0;
+    synchronized(&channel) {
+        if (closed || !running) {
+            return 0;
+        }
+        while (count < maxMessages && !channel.isEmpty()) {
+            target.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> FifoMessageDispatchChannel::peek() const {
     synchronized(&channel) {
@@ -141,6 +162,7 @@ void FifoMessageDispatchChannel::close() {
 void FifoMessageDispatchChannel::clear() {
     synchronized(&channel) {
         channel.clear();
+        releaseAll();
     }
 }
 
@@ -160,7 +182,15 @@ std::vector<Pointer<MessageDispatch> > FifoMessageDispatchChannel::removeAll() {
     synchronized(&channel) {
         result = channel.toArray();
         channel.clear();
+        releaseAll();
     }
 
     return result;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> FifoMessageDispatchChannel::removeFirst() {
+    Pointer<MessageDispatch> message = channel.pop();
+    release(message, channel.isEmpty());
+    return message;
+}
@@ -64,6 +64,8 @@ namespace core {
 
         virtual Pointer<MessageDispatch> dequeueNoWait();
 
+        virtual int drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages);
+
         virtual Pointer<MessageDispatch> peek() const;
 
         virtual void start();
@@ -112,6 +114,12 @@ namespace core {
             channel.notifyAll();
         }
 
+    private:
+
+        // These must be called with the channel locked.
+
+        Pointer<MessageDispatch> removeFirst();
+
     };
 
 }}
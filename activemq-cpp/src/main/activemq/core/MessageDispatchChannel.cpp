@@ -17,8 +17,84 @@
 
 #include "MessageDispatchChannel.h"
 
+#include <activemq/exceptions/ExceptionDefines.h>
+
 using namespace activemq;
 using namespace activemq::core;
+using namespace activemq::util;
+
+////////////////////////////////////////////////////////////////////////////////
+MessageDispatchChannel::MessageDispatchChannel() : bufferedBytes(0), memoryUsage() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageDispatchChannel::~MessageDispatchChannel() {
+    try {
+        if (this->memoryUsage != NULL) {
+            this->memoryUsage->decreaseUsage(this->bufferedBytes);
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MessageDispatchChannel::getBufferedBytes() const {
+    synchronized(const_cast<MessageDispatchChannel*>(this)) {
+        return this->bufferedBytes;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannel::setMemoryUsage(const Pointer<MemoryUsage>& usage) {
+    synchronized(this) {
+        if (this->memoryUsage != NULL) {
+            this->memoryUsage->decreaseUsage(this->bufferedBytes);
+        }
+        this->memoryUsage = usage;
+        if (this->memoryUsage != NULL) {
+            this->memoryUsage->increaseUsage(this->bufferedBytes);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MessageDispatchChannel::getDispatchSize(const Pointer<MessageDispatch>& dispatch) {
+
+    if (dispatch == NULL || dispatch->getMessage() == NULL) {
+        return 0;
+    }
+
+    return dispatch->getMessage()->getSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannel::charge(const Pointer<MessageDispatch>& dispatch) {
+
+    long long size = getDispatchSize(dispatch);
+
+    this->bufferedBytes += size;
+    if (this->memoryUsage != NULL) {
+        this->memoryUsage->increaseUsage(size);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannel::release(const Pointer<MessageDispatch>& dispatch, bool empty) {
+
+    long long size = getDispatchSize(dispatch);
+    if (empty || size > this->bufferedBytes) {
+        size = this->bufferedBytes;
+    }
+
+    this->bufferedBytes -= size;
+    if (this->memoryUsage != NULL) {
+        this->memoryUsage->decreaseUsage(size);
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-MessageDispatchChannel::~MessageDispatchChannel() {}
+void MessageDispatchChannel::releaseAll() {
+    release(Pointer<MessageDispatch>(), true);
+}
@@ -20,6 +20,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/util/MemoryUsage.h>
 
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/Synchronizable.h>
@@ -32,8 +33,21 @@ namespace core {
     using activemq::commands::MessageDispatch;
 
     class AMQCPP_API MessageDispatchChannel: public decaf::util::concurrent::Synchronizable {
+    private:
+
+        long long bufferedBytes;
+
+        Pointer<activemq::util::MemoryUsage> memoryUsage;
+
+    private:
+
+        MessageDispatchChannel(const MessageDispatchChannel&);
+        MessageDispatchChannel& operator=(const MessageDispatchChannel&);
+
     public:
 
+        MessageDispatchChannel();
+
         virtual ~MessageDispatchChannel();
 
         /**
@@ -86,6 +100,18 @@ namespace core {
          */
         virtual Pointer<MessageDispatch> dequeueNoWait() = 0;
 
+        /**
+         * Moves up to maxMessages of the messages that are enqueued right now onto the end
+         * of the given vector, in the order they would have been dequeued, without ever
+         * blocking.  The Channel's lock is taken once for the whole batch.
+         *
+         * @param target - The vector the dequeued messages are appended to.
+         * @param maxMessages - The maximum number of messages to dequeue.
+         *
+         * @return the number of messages that were added to target.
+         */
+        virtual int drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages) = 0;
+
         /**
          * Peek in the Queue and return the first message in the Channel without removing
          * it from the channel.
@@ -127,6 +153,53 @@ namespace core {
          */
         virtual std::vector<Pointer<MessageDispatch> > removeAll() = 0;
 
+        /**
+         * @return the combined size in bytes of the Messages currently in the Channel.
+         */
+        virtual long long getBufferedBytes() const;
+
+        /**
+         * Sets a MemoryUsage that the size of every Message is charged to for as long as
+         * it sits in this Channel, which lets the Channels of many consumers share one
+         * memory budget.  Any bytes already buffered are moved over to the new usage.
+         *
+         * @param usage - The MemoryUsage to charge, or NULL to stop charging one.
+         */
+        virtual void setMemoryUsage(const Pointer<activemq::util::MemoryUsage>& usage);
+
+    protected:
+
+        /**
+         * @return the number of bytes the given dispatch accounts for while it is held in a
+         *         Channel, zero when it carries no Message.
+         */
+        static long long getDispatchSize(const Pointer<MessageDispatch>& dispatch);
+
+        // These must be called with the Channel locked.
+
+        /**
+         * Adds the size of a dispatch that was just added to the Channel to the bytes
+         * it buffers.
+         *
+         * @param dispatch - The dispatch that was added.
+         */
+        void charge(const Pointer<MessageDispatch>& dispatch);
+
+        /**
+         * Takes the size of a dispatch that was just removed from the Channel off the
+         * bytes it buffers.  Once the Channel is empty nothing may stay charged, even if
+         * a Message changed size while it was queued.
+         *
+         * @param dispatch - The dispatch that was removed.
+         * @param empty - true if the Channel is now empty.
+         */
+        void release(const Pointer<MessageDispatch>& dispatch, bool empty);
+
+        /**
+         * Releases all of the buffered bytes, for a Channel that was just emptied.
+         */
+        void releaseAll();
+
     };
 
 }}
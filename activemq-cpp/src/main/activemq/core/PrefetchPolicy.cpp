@@ -45,6 +45,22 @@ void PrefetchPolicy::setAll(int value) {
     DECAF_CATCHALL_THROW(Exception)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool PrefetchPolicy::isAdaptive() const {
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long PrefetchPolicy::getPrefetchAdjustmentInterval() const {
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PrefetchPolicy::adjustPrefetch(int currentPrefetch, int maximumPrefetch AMQCPP_UNUSED, int pendingMessages AMQCPP_UNUSED,
+                                   long long consumedMessages AMQCPP_UNUSED, long long elapsedTime AMQCPP_UNUSED) const {
+    return currentPrefetch;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PrefetchPolicy::configure(const decaf::util::Properties& properties) {
 
@@ -129,6 +129,46 @@ namespace core {
          */
         virtual PrefetchPolicy* clone() const = 0;
 
+        /**
+         * Indicates if this policy adjusts the prefetch of a consumer while it is running.  When
+         * true a consumer keeps its own clone of the policy and periodically calls adjustPrefetch
+         * to compute a new prefetch limit which is then sent on to the broker.
+         *
+         * The default implementation returns false.
+         *
+         * @return true if consumers should adapt their prefetch using this policy.
+         */
+        virtual bool isAdaptive() const;
+
+        /**
+         * Gets the minimum amount of time in milliseconds that a consumer should wait between
+         * calls to adjustPrefetch.  The default implementation returns zero.
+         *
+         * @return the time between prefetch adjustments in milliseconds.
+         */
+        virtual long long getPrefetchAdjustmentInterval() const;
+
+        /**
+         * Computes the prefetch limit a consumer should use given its recent activity.  Only
+         * called on policies that return true from isAdaptive.  The default implementation
+         * returns the current prefetch unchanged.
+         *
+         * @param currentPrefetch
+         *      The prefetch limit the consumer is currently running with.
+         * @param maximumPrefetch
+         *      The prefetch limit the consumer was created with, the result should not exceed it.
+         * @param pendingMessages
+         *      The number of messages that are buffered in the consumer waiting to be consumed.
+         * @param consumedMessages
+         *      The number of messages consumed since the last adjustment.
+         * @param elapsedTime
+         *      The time in milliseconds since the last adjustment.
+         *
+         * @return the new prefetch limit for the consumer.
+         */
+        virtual int adjustPrefetch(int currentPrefetch, int maximumPrefetch, int pendingMessages,
+                                   long long consumedMessages, long long elapsedTime) const;
+
         /**
          * Checks the supplied properties object for properties matching the configurable
          * settings of this class.  The default implementation looks for properties named
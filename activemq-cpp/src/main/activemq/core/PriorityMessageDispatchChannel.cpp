@@ -0,0 +1,295 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PriorityMessageDispatchChannel.h"
+
+#include <cms/Message.h>
+
+#include <activemq/exceptions/ExceptionDefines.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ALL_LEVELS = (1 << 10) - 1;
+
+    // Index of the highest set bit of a non-zero mask of the ten levels.
+    inline int highestLevel(int levels) {
+        int level = 0;
+        if (levels >= (1 << 8)) {
+            levels >>= 8;
+            level += 8;
+        }
+        if (levels >= (1 << 4)) {
+            levels >>= 4;
+            level += 4;
+        }
+        if (levels >= (1 << 2)) {
+            levels >>= 2;
+            level += 2;
+        }
+        if (levels >= (1 << 1)) {
+            level += 1;
+        }
+        return level;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityMessageDispatchChannel::PriorityMessageDispatchChannel(bool weightedFair) :
+    closed(false), running(false), weightedFair(weightedFair), mutex(), nonEmpty(0),
+    credited(ALL_LEVELS), enqueued(0) {
+
+    for (int i = 0; i < MAX_PRIORITIES; ++i) {
+        this->credits[i] = i + 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityMessageDispatchChannel::~PriorityMessageDispatchChannel() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
+    synchronized(&mutex) {
+        int priority = getPriority(message);
+        this->channels[priority].push_back(message);
+        this->nonEmpty |= 1 << priority;
+        this->enqueued++;
+        charge(message);
+        mutex.notify();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
+    synchronized(&mutex) {
+        int priority = getPriority(message);
+        this->channels[priority].push_front(message);
+        this->nonEmpty |= 1 << priority;
+        this->enqueued++;
+        charge(message);
+        mutex.notify();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PriorityMessageDispatchChannel::isEmpty() const {
+    return this->enqueued == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> PriorityMessageDispatchChannel::dequeue(long long timeout) {
+
+    synchronized(&mutex) {
+        // Wait until the channel is ready to deliver messages.
+        while (timeout != 0 && !closed && (isEmpty() || !running)) {
+            if (timeout == -1) {
+                mutex.wait();
+            } else {
+                mutex.wait((unsigned long) timeout);
+                break;
+            }
+        }
+
+        if (closed || !running || isEmpty()) {
+            return Pointer<MessageDispatch>();
+        }
+
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> PriorityMessageDispatchChannel::dequeueNoWait() {
+    synchronized(&mutex) {
+        if (closed || !running || isEmpty()) {
+            return Pointer<MessageDispatch>();
+        }
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityMessageDispatchChannel::drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages) {
+    int count = 0;
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+        while (count < maxMessages && !isEmpty()) {
+            target.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> PriorityMessageDispatchChannel::peek() const {
+    synchronized(&mutex) {
+        if (closed || !running || isEmpty()) {
+            return Pointer<MessageDispatch>();
+        }
+        return this->channels[nextPriority()].front();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::start() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = true;
+            mutex.notifyAll();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::stop() {
+    synchronized(&mutex) {
+        running = false;
+        mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::close() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = false;
+            closed = true;
+        }
+        mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannel::clear() {
+    synchronized(&mutex) {
+        for (int levels = this->nonEmpty; levels != 0; levels &= ~(1 << highestLevel(levels))) {
+            this->channels[highestLevel(levels)].clear();
+        }
+        this->nonEmpty = 0;
+        this->enqueued = 0;
+        releaseAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityMessageDispatchChannel::size() const {
+    synchronized(&mutex) {
+        return this->enqueued;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<Pointer<MessageDispatch> > PriorityMessageDispatchChannel::removeAll() {
+    std::vector<Pointer<MessageDispatch> > result;
+
+    synchronized(&mutex) {
+        result.reserve(this->enqueued);
+        for (int levels = this->nonEmpty; levels != 0; levels &= ~(1 << highestLevel(levels))) {
+            std::deque<Pointer<MessageDispatch> >& channel = this->channels[highestLevel(levels)];
+            result.insert(result.end(), channel.begin(), channel.end());
+            channel.clear();
+        }
+        this->nonEmpty = 0;
+        this->enqueued = 0;
+        releaseAll();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityMessageDispatchChannel::getPriority(const Pointer<MessageDispatch>& dispatch) const {
+
+    int priority = cms::Message::DEFAULT_MSG_PRIORITY;
+
+    if (dispatch->getMessage() != NULL) {
+        priority = dispatch->getMessage()->getPriority();
+        if (priority < 0) {
+            priority = 0;
+        } else if (priority >= MAX_PRIORITIES) {
+            priority = MAX_PRIORITIES - 1;
+        }
+    }
+
+    return priority;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityMessageDispatchChannel::nextPriority() const {
+
+    if (this->weightedFair) {
+        // When no level holding Messages has credit left a new round starts.
+        int candidates = this->nonEmpty & this->credited;
+        return highestLevel(candidates != 0 ? candidates : this->nonEmpty);
+    }
+
+    return highestLevel(this->nonEmpty);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> PriorityMessageDispatchChannel::removeFirst() {
+
+    int priority = nextPriority();
+
+    if (this->weightedFair) {
+        if ((this->credited & (1 << priority)) == 0) {
+            for (int i = 0; i < MAX_PRIORITIES; ++i) {
+                this->credits[i] = i + 1;
+            }
+            this->credited = ALL_LEVELS;
+        }
+
+        if (--this->credits[priority] == 0) {
+            this->credited &= ~(1 << priority);
+        }
+    }
+
+    std::deque<Pointer<MessageDispatch> >& channel = this->channels[priority];
+    Pointer<MessageDispatch> message = channel.front();
+    channel.pop_front();
+
+    if (channel.empty()) {
+        this->nonEmpty &= ~(1 << priority);
+    }
+
+    this->enqueued--;
+    release(message, this->enqueued == 0);
+
+    return message;
+}
@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_PRIORITYMESSAGEDISPATCHCHANNEL_H_
+#define _ACTIVEMQ_CORE_PRIORITYMESSAGEDISPATCHCHANNEL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/core/MessageDispatchChannel.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * A MessageDispatchChannel that orders Messages by their priority and keeps a
+     * bitmap of the priority levels that currently hold Messages, so that finding the
+     * next Message to dispatch doesn't depend on how many levels are empty.
+     *
+     * By default the highest priority Message is always dispatched first, the same
+     * order as the SimplePriorityMessageDispatchChannel.  In weighted fair mode the
+     * levels are instead served in rounds where a level of priority p may dispatch up
+     * to p + 1 Messages, highest levels first, which still favors high priorities but
+     * keeps a sustained stream of them from starving the lower ones.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API PriorityMessageDispatchChannel : public MessageDispatchChannel {
+    private:
+
+        enum {
+            MAX_PRIORITIES = 10
+        };
+
+        bool closed;
+        bool running;
+        bool weightedFair;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::deque< Pointer<MessageDispatch> > channels[MAX_PRIORITIES];
+
+        // Bit n is set when the level of priority n holds a Message.
+        int nonEmpty;
+
+        // Bit n is set when the level of priority n has dispatches left in this round.
+        int credited;
+        int credits[MAX_PRIORITIES];
+
+        int enqueued;
+
+    private:
+
+        PriorityMessageDispatchChannel(const PriorityMessageDispatchChannel&);
+        PriorityMessageDispatchChannel& operator=(const PriorityMessageDispatchChannel&);
+
+    public:
+
+        /**
+         * Creates a new channel.
+         *
+         * @param weightedFair
+         *      True to serve the priority levels in weighted rounds instead of strictly
+         *      by priority.
+         */
+        PriorityMessageDispatchChannel(bool weightedFair = false);
+
+        virtual ~PriorityMessageDispatchChannel();
+
+        /**
+         * @return true if the priority levels are served in weighted rounds.
+         */
+        bool isWeightedFair() const {
+            return this->weightedFair;
+        }
+
+        virtual void enqueue(const Pointer<MessageDispatch>& message);
+
+        virtual void enqueueFirst(const Pointer<MessageDispatch>& message);
+
+        virtual bool isEmpty() const;
+
+        virtual bool isClosed() const {
+            return this->closed;
+        }
+
+        virtual bool isRunning() const {
+            return this->running;
+        }
+
+        virtual Pointer<MessageDispatch> dequeue(long long timeout);
+
+        virtual Pointer<MessageDispatch> dequeueNoWait();
+
+        virtual int drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages);
+
+        virtual Pointer<MessageDispatch> peek() const;
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void clear();
+
+        virtual int size() const;
+
+        virtual std::vector<Pointer<MessageDispatch> > removeAll();
+
+    public:
+
+        virtual void lock() {
+            mutex.lock();
+        }
+
+        virtual bool tryLock() {
+            return mutex.tryLock();
+        }
+
+        virtual void unlock() {
+            mutex.unlock();
+        }
+
+        virtual void wait() {
+            mutex.wait();
+        }
+
+        virtual void wait(long long millisecs) {
+            mutex.wait(millisecs);
+        }
+
+        virtual void wait(long long millisecs, int nanos) {
+            mutex.wait(millisecs, nanos);
+        }
+
+        virtual void notify() {
+            mutex.notify();
+        }
+
+        virtual void notifyAll() {
+            mutex.notifyAll();
+        }
+
+    private:
+
+        // These must be called with the mutex locked.
+
+        int getPriority(const Pointer<MessageDispatch>& dispatch) const;
+
+        int nextPriority() const;
+
+        Pointer<MessageDispatch> removeFirst();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_PRIORITYMESSAGEDISPATCHCHANNEL_H_ */
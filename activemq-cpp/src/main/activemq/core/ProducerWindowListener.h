@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_PRODUCERWINDOWLISTENER_H_
+#define _ACTIVEMQ_CORE_PRODUCERWINDOWLISTENER_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/MessageProducer.h>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * A listener that is notified when a MessageProducer whose producer window was
+     * found full by a call to trySend has had space freed in its window by a ProducerAck
+     * from the broker.  This allows event driven producers to stop sending when the window
+     * fills and resume once the broker has caught up without ever parking a thread inside
+     * the send call.
+     *
+     * The listener is called from the thread that is dispatching incoming commands for the
+     * connection, implementations should not block or perform a send from within the callback.
+     */
+    class AMQCPP_API ProducerWindowListener {
+    public:
+
+        virtual ~ProducerWindowListener();
+
+        /**
+         * Indicates that the producer window of the given producer is no longer full and
+         * that a call to trySend is expected to succeed.
+         *
+         * @param producer
+         *      The producer whose window now has space available.
+         */
+        virtual void onWindowAvailable(cms::MessageProducer* producer) = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_PRODUCERWINDOWLISTENER_H_ */
@@ -19,6 +19,8 @@
 
 #include <cms/Message.h>
 
+#include <activemq/exceptions/ExceptionDefines.h>
+
 #include <decaf/lang/Math.h>
 
 using namespace std;
@@ -48,6 +50,7 @@ void SimplePriorityMessageDispatchChannel::enqueue(const Pointer<MessageDispatch
     synchronized(&mutex) {
         this->getChannel(message).addLast(message);
         this->enqueued++;
+        charge(message);
         mutex.notify();
     }
 }
@@ -57,6 +60,7 @@ void SimplePriorityMessageDispatchChannel::enqueueFirst(const Pointer<MessageDis
     synchronized(&mutex) {
         this->getChannel(message).addFirst(message);
         this->enqueued++;
+        charge(message);
         mutex.notify();
     }
 }
@@ -102,6 +106,22 @@ Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::dequeueNoWait() {
     return Pointer<MessageDispatch>();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int SimplePriorityMessageDispatchChannel::drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages) {
+    int count = 0;
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+        while (count < maxMessages && !isEmpty()) {
+            target.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::peek() const {
     synchronized(&mutex) {
@@ -149,6 +169,8 @@ void SimplePriorityMessageDispatchChannel::clear() {
         for (int i = 0; i < MAX_PRIORITIES; i++) {
             this->channels[i].clear();
         }
+        this->enqueued = 0;
+        releaseAll();
     }
 }
 
@@ -172,6 +194,7 @@ std::vector<Pointer<MessageDispatch> > SimplePriorityMessageDispatchChannel::rem
             this->enqueued -= (int) temp.size();
             channels[i].clear();
         }
+        releaseAll();
     }
 
     return result;
@@ -198,7 +221,9 @@ Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::removeFirst() {
             LinkedList<Pointer<MessageDispatch> >& channel = channels[i];
             if (!channel.isEmpty()) {
                 this->enqueued--;
-                return channel.pop();
+                Pointer<MessageDispatch> message = channel.pop();
+                release(message, this->enqueued == 0);
+                return message;
             }
         }
     }
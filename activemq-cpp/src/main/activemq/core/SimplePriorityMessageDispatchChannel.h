@@ -72,6 +72,8 @@ namespace core {
 
         virtual Pointer<MessageDispatch> dequeueNoWait();
 
+        virtual int drainTo(std::vector<Pointer<MessageDispatch> >& target, int maxMessages);
+
         virtual Pointer<MessageDispatch> peek() const;
 
         virtual void start();
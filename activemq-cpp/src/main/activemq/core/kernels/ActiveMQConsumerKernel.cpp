@@ -35,6 +35,7 @@
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/Message.h>
 #include <activemq/commands/MessageAck.h>
 #include <activemq/commands/MessagePull.h>
@@ -46,9 +47,12 @@
 #include <activemq/core/ActiveMQTransactionContext.h>
 #include <activemq/core/ActiveMQAckHandler.h>
 #include <activemq/core/FifoMessageDispatchChannel.h>
-#include <activemq/core/SimplePriorityMessageDispatchChannel.h>
+#include <activemq/core/PriorityMessageDispatchChannel.h>
+#include <activemq/core/PrefetchPolicy.h>
 #include <activemq/core/RedeliveryPolicy.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
+#include <activemq/metrics/Tracer.h>
+#include <activemq/selector/SelectorParser.h>
 #include <activemq/threads/Scheduler.h>
 #include <cms/ExceptionListener.h>
 #include <cms/MessageTransformer.h>
@@ -62,6 +66,7 @@ using namespace activemq::core::kernels;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
 using namespace activemq::threads;
+using namespace activemq::selector;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
@@ -96,11 +101,15 @@ namespace kernels {
         cms::MessageListener* listener;
         cms::MessageAvailableListener* messageAvailableListener;
         cms::MessageTransformer* transformer;
+        Pointer<MessageSelector> localSelector;
         decaf::util::concurrent::Mutex listenerMutex;
         AtomicBoolean deliveringAcks;
         AtomicBoolean started;
         AtomicBoolean closeSyncRegistered;
         Pointer<MessageDispatchChannel> unconsumedMessages;
+        Pointer<MemoryUsage> memoryUsage;
+        decaf::util::concurrent::Mutex memoryLock;
+        volatile bool pausedOnMemoryLimit;
         decaf::util::LinkedList< decaf::lang::Pointer<commands::MessageDispatch> > deliveredMessages;
         long long lastDeliveredSequenceId;
         Pointer<commands::MessageAck> pendingAck;
@@ -111,6 +120,9 @@ namespace kernels {
         AtomicInteger inProgressClearRequiredFlag;
         long long redeliveryDelay;
         Pointer<RedeliveryPolicy> redeliveryPolicy;
+        Pointer<PrefetchPolicy> prefetchPolicy;
+        long long consumedSinceAdjust;
+        long long lastPrefetchAdjust;
         Pointer<Exception> failureError;
         Pointer<Scheduler> scheduler;
         int hashCode;
@@ -134,11 +146,15 @@ namespace kernels {
         ActiveMQConsumerKernelConfig() : listener(NULL),
                                          messageAvailableListener(NULL),
                                          transformer(NULL),
+                                         localSelector(),
                                          listenerMutex(),
                                          deliveringAcks(),
                                          started(),
                                          closeSyncRegistered(),
                                          unconsumedMessages(),
+                                         memoryUsage(),
+                                         memoryLock(),
+                                         pausedOnMemoryLimit(false),
                                          deliveredMessages(),
                                          lastDeliveredSequenceId(-1),
                                          pendingAck(),
@@ -149,6 +165,9 @@ namespace kernels {
                                          inProgressClearRequiredFlag(0),
                                          redeliveryDelay(0),
                                          redeliveryPolicy(),
+                                         prefetchPolicy(),
+                                         consumedSinceAdjust(0),
+                                         lastPrefetchAdjust(System::currentTimeMillis()),
                                          failureError(),
                                          scheduler(),
                                          hashCode(),
@@ -170,6 +189,18 @@ namespace kernels {
                                          info() {
         }
 
+        /**
+         * Returns the prefetch size used to decide when to send acks, an adaptive consumer
+         * works against its current window so that shrinking it doesn't stall delivery.
+         */
+        int getAckPrefetchSize() const {
+            if (prefetchPolicy != NULL) {
+                return info->getCurrentPrefetchSize();
+            }
+
+            return info->getPrefetchSize();
+        }
+
         bool isTimeForOptimizedAck(int prefetchSize) const {
             if (ackCounter + deliveredCounter >= (prefetchSize * 0.65)) {
                 return true;
@@ -356,6 +387,15 @@ namespace kernels {
             return false;
         }
 
+        bool filteredLocally(const Pointer<MessageDispatch>& dispatch) {
+            Pointer<MessageSelector> selector;
+            synchronized(&listenerMutex) {
+                selector = localSelector;
+            }
+
+            return selector != NULL && !selector->matches(dispatch->getMessage().get());
+        }
+
         bool redeliveryExceeded(Pointer<MessageDispatch> dispatch) {
             try {
                 return session->isTransacted() && redeliveryPolicy != NULL &&
@@ -763,7 +803,6 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
     consumerInfo->setSubscriptionName(name);
     consumerInfo->setSelector(selector);
     consumerInfo->setPrefetchSize(prefetch);
-    consumerInfo->setCurrentPrefetchSize(prefetch);
     consumerInfo->setMaximumPendingMessageLimit(maxPendingMessageCount);
     consumerInfo->setBrowser(browser);
     consumerInfo->setDispatchAsync(dispatchAsync);
@@ -778,20 +817,36 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
     this->internal->parent = this;
     this->internal->info = consumerInfo;
     this->internal->redeliveryPolicy.reset(this->session->getConnection()->getRedeliveryPolicy()->clone());
+
     this->internal->scheduler = this->session->getScheduler();
 
     if (this->session->getConnection()->isMessagePrioritySupported()) {
-        this->internal->unconsumedMessages.reset(new SimplePriorityMessageDispatchChannel());
+        this->internal->unconsumedMessages.reset(new PriorityMessageDispatchChannel(
+            this->session->getConnection()->isWeightedFairPriorityDispatch()));
     } else {
         this->internal->unconsumedMessages.reset(new FifoMessageDispatchChannel());
     }
 
+    if (this->session->getConnection()->getConsumerMemoryLimit() > 0) {
+        this->internal->memoryUsage = this->session->getConnection()->getConsumerMemoryUsage();
+        this->internal->unconsumedMessages->setMemoryUsage(this->internal->memoryUsage);
+    }
+
     if (listener != NULL) {
         this->setMessageListener(listener);
     }
 
     applyDestinationOptions(this->consumerInfo);
 
+    // The destination options may have changed the prefetch, the window starts from that.
+    consumerInfo->setCurrentPrefetchSize(consumerInfo->getPrefetchSize());
+
+    // Each adaptive consumer tunes its own window so it needs its own copy of the policy.
+    PrefetchPolicy* prefetchPolicy = this->session->getConnection()->getPrefetchPolicy();
+    if (prefetchPolicy != NULL && prefetchPolicy->isAdaptive() && consumerInfo->getPrefetchSize() > 0 && !browser) {
+        this->internal->prefetchPolicy.reset(prefetchPolicy->clone());
+    }
+
     if (session->getConnection()->isOptimizeAcknowledge() && session->isAutoAcknowledge() && !consumerInfo->isBrowser()) {
         this->internal->optimizeAcknowledge = true;
     }
@@ -1024,6 +1079,7 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
         // Loop until the time is up or we get a non-expired message
         while (true) {
             Pointer<MessageDispatch> dispatch = this->internal->unconsumedMessages->dequeue(timeout);
+            checkMemoryLimit();
             if (dispatch == NULL) {
                 if (timeout > 0 && !this->internal->unconsumedMessages->isClosed()) {
                     timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
@@ -1043,6 +1099,14 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
                     timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
                 }
 
+                sendPullRequest(timeout);
+            } else if (internal->filteredLocally(dispatch)) {
+                beforeMessageIsConsumed(dispatch);
+                afterMessageIsConsumed(dispatch, false);
+                if (timeout > 0) {
+                    timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
+                }
+
                 sendPullRequest(timeout);
             } else if (internal->redeliveryExceeded(dispatch)) {
                 internal->posionAck(dispatch,
@@ -1163,6 +1227,92 @@ cms::Message* ActiveMQConsumerKernel::receiveNoWait() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::vector<cms::Message*> ActiveMQConsumerKernel::receive(int maxMessages, int millisecs) {
+
+    std::vector<cms::Message*> messages;
+
+    try {
+
+        this->checkClosed();
+        this->checkMessageListener();
+
+        if (maxMessages <= 0) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "Max messages must be greater than zero: %d", maxMessages);
+        }
+
+        // A zero prefetch consumer only ever has the one message it pulled, so the
+        // batch can be no bigger than a single receive.
+        if (maxMessages == 1 || internal->info->getPrefetchSize() == 0) {
+            cms::Message* message = millisecs < 0 ? this->receiveNoWait() : this->receive(millisecs);
+            if (message != NULL) {
+                messages.push_back(message);
+            }
+            return messages;
+        }
+
+        this->sendPullRequest(millisecs < 0 ? -1 : millisecs);
+
+        // Wait for the first message the same way receive would, then take whatever
+        // else is already here under a single lock of the channel.
+        Pointer<MessageDispatch> first = dequeue(millisecs < 0 ? 0 : (millisecs == 0 ? -1 : millisecs));
+        if (first == NULL) {
+            return messages;
+        }
+
+        std::vector<Pointer<MessageDispatch> > batch;
+        batch.reserve(maxMessages);
+        beforeMessageIsConsumed(first);
+        batch.push_back(first);
+
+        std::vector<Pointer<MessageDispatch> > dispatches;
+        this->internal->unconsumedMessages->drainTo(dispatches, maxMessages - 1);
+        checkMemoryLimit();
+
+        std::vector<Pointer<MessageDispatch> >::const_iterator iter = dispatches.begin();
+        for (; iter != dispatches.end(); ++iter) {
+            const Pointer<MessageDispatch>& dispatch = *iter;
+            if (dispatch->getMessage() == NULL) {
+                continue;
+            } else if (internal->consumeExpiredMessage(dispatch)) {
+                beforeMessageIsConsumed(dispatch);
+                afterMessageIsConsumed(dispatch, true);
+            } else if (internal->filteredLocally(dispatch)) {
+                beforeMessageIsConsumed(dispatch);
+                afterMessageIsConsumed(dispatch, false);
+            } else if (internal->redeliveryExceeded(dispatch)) {
+                internal->posionAck(dispatch,
+                                    "dispatch to " + getConsumerId()->toString() +
+                                    " exceeds RedeliveryPolicy limit: " +
+                                    Integer::toString(internal->redeliveryPolicy->getMaximumRedeliveries()));
+            } else {
+                beforeMessageIsConsumed(dispatch);
+                batch.push_back(dispatch);
+            }
+        }
+
+        // Everything in the batch is acknowledged as one range instead of once per message.
+        afterMessagesAreConsumed(batch.front(), batch.back(), (int) batch.size());
+
+        try {
+            messages.reserve(batch.size());
+            for (iter = batch.begin(); iter != batch.end(); ++iter) {
+                messages.push_back(createCMSMessage(*iter).release());
+            }
+        } catch (...) {
+            std::vector<cms::Message*>::iterator message = messages.begin();
+            for (; message != messages.end(); ++message) {
+                delete *message;
+            }
+            throw;
+        }
+
+        return messages;
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::setMessageListener(cms::MessageListener* listener) {
 
@@ -1254,7 +1404,30 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
         } else if (messageExpired) {
             acknowledge(message, ActiveMQConstants::ACK_TYPE_EXPIRED);
             return;
-        } else if (session->isTransacted()) {
+        }
+
+        afterMessagesAreConsumed(message, message, 1);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::afterMessagesAreConsumed(Pointer<MessageDispatch> first,
+                                                      Pointer<MessageDispatch> last, int count) {
+
+    try {
+
+        if (this->internal->unconsumedMessages->isClosed()) {
+            return;
+        }
+
+        if (this->internal->prefetchPolicy != NULL) {
+            adjustPrefetch(count);
+        }
+
+        if (session->isTransacted()) {
             return;
         }
 
@@ -1264,8 +1437,8 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
                     if (!this->internal->deliveredMessages.isEmpty()) {
                         if (this->internal->optimizeAcknowledge) {
 
-                            this->internal->ackCounter++;
-                            if (this->internal->isTimeForOptimizedAck(this->consumerInfo->getPrefetchSize())) {
+                            this->internal->ackCounter += count;
+                            if (this->internal->isTimeForOptimizedAck(this->internal->getAckPrefetchSize())) {
                                 Pointer<MessageAck> ack =
                                     makeAckForAllDeliveredMessages(ActiveMQConstants::ACK_TYPE_CONSUMED);
                                 if (ack != NULL) {
@@ -1299,15 +1472,19 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
                 this->internal->deliveringAcks.set(false);
             }
         } else if (isAutoAcknowledgeBatch()) {
-            ackLater(message, ActiveMQConstants::ACK_TYPE_CONSUMED);
+            ackLater(first, last, count, ActiveMQConstants::ACK_TYPE_CONSUMED);
         } else if (session->isClientAcknowledge() || session->isIndividualAcknowledge()) {
-            bool messageUnackedByConsumer = false;
-            synchronized(&this->internal->deliveredMessages) {
-                messageUnackedByConsumer = this->internal->deliveredMessages.contains(message);
+            // A batch has only just been delivered so none of it can have been acked
+            // by the client yet, a single message may have been acked by a listener.
+            bool messageUnackedByConsumer = count > 1;
+            if (!messageUnackedByConsumer) {
+                synchronized(&this->internal->deliveredMessages) {
+                    messageUnackedByConsumer = this->internal->deliveredMessages.contains(last);
+                }
             }
 
             if (messageUnackedByConsumer) {
-                this->ackLater(message, ActiveMQConstants::ACK_TYPE_DELIVERED);
+                this->ackLater(first, last, count, ActiveMQConstants::ACK_TYPE_DELIVERED);
             }
         } else {
             throw IllegalStateException(__FILE__, __LINE__, "Invalid Session State");
@@ -1318,6 +1495,85 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::adjustPrefetch(int consumed) {
+
+    this->internal->consumedSinceAdjust += consumed;
+
+    long long now = System::currentTimeMillis();
+    long long elapsed = now - this->internal->lastPrefetchAdjust;
+
+    if (elapsed < this->internal->prefetchPolicy->getPrefetchAdjustmentInterval()) {
+        return;
+    }
+
+    int current = this->consumerInfo->getCurrentPrefetchSize();
+    int next = this->internal->prefetchPolicy->adjustPrefetch(
+        current, this->consumerInfo->getPrefetchSize(), this->internal->unconsumedMessages->size(),
+        this->internal->consumedSinceAdjust, elapsed);
+
+    this->internal->consumedSinceAdjust = 0;
+    this->internal->lastPrefetchAdjust = now;
+
+    if (next == current || next <= 0) {
+        return;
+    }
+
+    // Flush outstanding acks before the window changes so the broker's view of
+    // what this consumer holds stays accurate.
+    deliverAcks();
+
+    synchronized(&this->internal->memoryLock) {
+        this->consumerInfo->setCurrentPrefetchSize(next);
+
+        // A paused consumer picks up the new window when it resumes.
+        if (!this->internal->pausedOnMemoryLimit) {
+            sendPrefetchControl(next);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::checkMemoryLimit() {
+
+    Pointer<MemoryUsage> usage = this->internal->memoryUsage;
+    if (usage == NULL || this->consumerInfo->getPrefetchSize() == 0 || this->consumerInfo->isBrowser()) {
+        return;
+    }
+
+    // A limit that was removed while this consumer was paused must still resume it.
+    unsigned long long limit = usage->getLimit();
+    if (limit == 0 && !this->internal->pausedOnMemoryLimit) {
+        return;
+    }
+
+    // Read before taking the memory lock, which is never held while taking the channel's.
+    bool empty = limit == 0 || this->internal->unconsumedMessages->isEmpty();
+
+    synchronized(&this->internal->memoryLock) {
+        if (!this->internal->pausedOnMemoryLimit) {
+            if (limit != 0 && !empty && usage->isFull()) {
+                this->internal->pausedOnMemoryLimit = true;
+                sendPrefetchControl(0);
+            }
+        } else if (empty || usage->getUsage() <= limit / 2) {
+            this->internal->pausedOnMemoryLimit = false;
+            sendPrefetchControl(this->consumerInfo->getCurrentPrefetchSize());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::sendPrefetchControl(int prefetch) {
+
+    Pointer<ConsumerControl> control(new ConsumerControl());
+    control->setConsumerId(this->consumerInfo->getConsumerId());
+    control->setDestination(this->consumerInfo->getDestination());
+    control->setPrefetch(prefetch);
+
+    this->session->oneway(control);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::deliverAcks() {
 
@@ -1359,6 +1615,12 @@ void ActiveMQConsumerKernel::deliverAcks() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::ackLater(Pointer<MessageDispatch> dispatch, int ackType) {
+    ackLater(dispatch, dispatch, 1, ackType);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::ackLater(Pointer<MessageDispatch> first, Pointer<MessageDispatch> last,
+                                      int count, int ackType) {
 
     // Don't acknowledge now, but we may need to let the broker know the
     // consumer got the message to expand the pre-fetch window
@@ -1368,13 +1630,13 @@ void ActiveMQConsumerKernel::ackLater(Pointer<MessageDispatch> dispatch, int ack
 
     // The delivered message list is only needed for the recover method
     // which is only used with client ack.
-    this->internal->deliveredCounter++;
+    this->internal->deliveredCounter += count;
 
     Pointer<MessageAck> oldPendingAck = this->internal->pendingAck;
-    this->internal->pendingAck.reset(new MessageAck(dispatch, ackType, internal->deliveredCounter));
+    this->internal->pendingAck.reset(new MessageAck(last, ackType, internal->deliveredCounter));
 
     if (oldPendingAck == NULL) {
-        this->internal->pendingAck->setFirstMessageId(this->internal->pendingAck->getLastMessageId());
+        this->internal->pendingAck->setFirstMessageId(first->getMessage()->getMessageId());
     } else if (oldPendingAck->getAckType() == this->internal->pendingAck->getAckType()) {
         this->internal->pendingAck->setFirstMessageId(oldPendingAck->getFirstMessageId());
     } else {
@@ -1391,7 +1653,7 @@ void ActiveMQConsumerKernel::ackLater(Pointer<MessageDispatch> dispatch, int ack
 
     // Need to evaluate both expired and normal messages as otherwise consumer may get stalled
     int pendingAcks = (internal->deliveredCounter + internal->ackCounter) - internal->additionalWindowSize;
-    if ((0.5 * this->consumerInfo->getPrefetchSize()) <= pendingAcks) {
+    if ((0.5 * this->internal->getAckPrefetchSize()) <= pendingAcks) {
         session->sendAck(this->internal->pendingAck);
         this->internal->pendingAck.reset(NULL);
         this->internal->deliveredCounter = 0;
@@ -1628,7 +1890,13 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
 
                     synchronized(&this->internal->listenerMutex) {
 
-                        if (this->internal->listener != NULL && this->internal->unconsumedMessages->isRunning()) {
+                        if (this->internal->listener != NULL && this->internal->unconsumedMessages->isRunning() &&
+                            this->internal->filteredLocally(dispatch)) {
+                            // Filtered locally, consume it so the Broker's window moves on.  Messages
+                            // for a synchronous consumer are screened by the receiving thread instead.
+                            beforeMessageIsConsumed(dispatch);
+                            afterMessageIsConsumed(dispatch, false);
+                        } else if (this->internal->listener != NULL && this->internal->unconsumedMessages->isRunning()) {
                             if (this->internal->redeliveryExceeded(dispatch)) {
                                 internal->posionAck(dispatch,
                                                     "dispatch to " + getConsumerId()->toString() +
@@ -1641,7 +1909,9 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                             try {
                                 bool expired = isConsumerExpiryCheckEnabled() && dispatch->getMessage()->isExpired();
                                 if (!expired) {
+                                    metrics::Tracer::record(metrics::TraceEvent::LISTENER_START, dispatch.get());
                                     this->internal->listener->onMessage(message.get());
+                                    metrics::Tracer::record(metrics::TraceEvent::LISTENER_END, dispatch.get());
                                 }
                                 afterMessageIsConsumed(dispatch, expired);
                             } catch (RuntimeException& e) {
@@ -1660,6 +1930,7 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                                 session->getConnection()->rollbackDuplicate(this, dispatch->getMessage());
                             }
                             this->internal->unconsumedMessages->enqueue(dispatch);
+                            checkMemoryLimit();
                             if (this->internal->messageAvailableListener != NULL) {
                                 this->internal->messageAvailableListener->onMessageAvailable(this);
                             }
@@ -1797,6 +2068,7 @@ bool ActiveMQConsumerKernel::iterate() {
         if (this->internal->listener != NULL) {
             Pointer<MessageDispatch> dispatch = internal->unconsumedMessages->dequeueNoWait();
             if (dispatch != NULL) {
+                checkMemoryLimit();
                 this->dispatch(dispatch);
                 return true;
             }
@@ -1836,6 +2108,11 @@ void ActiveMQConsumerKernel::clearMessagesInProgress() {
                     }
                 }
 
+                // The consumer was recreated with its full window, so it is no longer paused.
+                synchronized(&this->internal->memoryLock) {
+                    this->internal->pausedOnMemoryLimit = false;
+                }
+
                 // allow dispatch on this connection to resume
                 this->session->getConnection()->setTransportInterruptionProcessingComplete();
                 this->internal->inProgressClearRequiredFlag.decrementAndGet();
@@ -1863,6 +2140,25 @@ int ActiveMQConsumerKernel::getMessageAvailableCount() const {
     return this->internal->unconsumedMessages->size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getBufferedBytes() const {
+    return this->internal->unconsumedMessages->getBufferedBytes();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::isPausedOnMemoryLimit() const {
+    return this->internal->pausedOnMemoryLimit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::getDeliveredMessageCount() const {
+    synchronized(&this->internal->deliveredMessages) {
+        return this->internal->deliveredMessages.size();
+    }
+
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::applyDestinationOptions(Pointer<ConsumerInfo> info) {
 
@@ -2012,6 +2308,35 @@ decaf::lang::Exception* ActiveMQConsumerKernel::getFailureError() const {
     return this->internal->failureError.get();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setLocalSelector(const std::string& selector) {
+
+    try {
+
+        Pointer<MessageSelector> compiled;
+        if (!selector.empty()) {
+            compiled = SelectorParser::parse(selector);
+        }
+
+        synchronized(&this->internal->listenerMutex) {
+            this->internal->localSelector = compiled;
+        }
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConsumerKernel::getLocalSelector() const {
+
+    synchronized(&this->internal->listenerMutex) {
+        if (this->internal->localSelector != NULL) {
+            return this->internal->localSelector->getText();
+        }
+    }
+
+    return "";
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::setPrefetchSize(int prefetchSize) {
     deliverAcks();
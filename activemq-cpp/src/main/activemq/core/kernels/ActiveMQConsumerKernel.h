@@ -17,7 +17,7 @@
 #ifndef _ACTIVEMQ_CORE_KERNELS_ACTIVEMQCONSUMERKERNEL_H_
 #define _ACTIVEMQ_CORE_KERNELS_ACTIVEMQCONSUMERKERNEL_H_
 
-#include <cms/MessageConsumer.h>
+#include <cms/BatchMessageConsumer.h>
 #include <cms/MessageListener.h>
 #include <cms/MessageAvailableListener.h>
 #include <cms/Message.h>
@@ -46,7 +46,7 @@ namespace kernels {
     class ActiveMQSessionKernel;
     class ActiveMQConsumerKernelConfig;
 
-    class AMQCPP_API ActiveMQConsumerKernel : public cms::MessageConsumer, public Dispatcher {
+    class AMQCPP_API ActiveMQConsumerKernel : public cms::BatchMessageConsumer, public Dispatcher {
     private:
 
         /**
@@ -99,6 +99,8 @@ namespace kernels {
 
         virtual cms::Message* receiveNoWait();
 
+        virtual std::vector<cms::Message*> receive(int maxMessages, int millisecs);
+
         virtual void setMessageListener(cms::MessageListener* listener);
 
         virtual cms::MessageListener* getMessageListener() const;
@@ -275,6 +277,22 @@ namespace kernels {
          */
         int getMessageAvailableCount() const;
 
+        /**
+         * @return the number of Message's delivered to this consumer that have not yet been acknowledged.
+         */
+        int getDeliveredMessageCount() const;
+
+        /**
+         * @return the combined size in bytes of the Message's this consumer is waiting to Dispatch.
+         */
+        long long getBufferedBytes() const;
+
+        /**
+         * @return true while this consumer has closed its prefetch window because its
+         *         Connection's consumer memory limit was reached.
+         */
+        bool isPausedOnMemoryLimit() const;
+
         /**
          * Sets the RedeliveryPolicy this Consumer should use when a rollback is
          * performed on a transacted Consumer.  The Consumer takes ownership of the
@@ -310,6 +328,25 @@ namespace kernels {
          */
         decaf::lang::Exception* getFailureError() const;
 
+        /**
+         * Sets a selector that this consumer evaluates itself against each Message the
+         * Broker dispatches to it, on top of any selector the Broker has applied.  Messages
+         * that don't match are consumed under the session's acknowledgement mode without
+         * being delivered.  The selector applies to Messages delivered or received after
+         * this call, an empty string removes it.
+         *
+         * @param selector
+         *      The JMS selector to evaluate locally.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         */
+        void setLocalSelector(const std::string& selector);
+
+        /**
+         * @return the selector this consumer evaluates locally, or an empty string if none.
+         */
+        std::string getLocalSelector() const;
+
         /**
          * Sets the current prefetch size for the consumer as indicated by a Broker
          * ConsumerControl command.
@@ -424,6 +461,18 @@ namespace kernels {
 
         void ackLater(Pointer<commands::MessageDispatch> message, int ackType);
 
+        void ackLater(Pointer<commands::MessageDispatch> first, Pointer<commands::MessageDispatch> last,
+                      int count, int ackType);
+
+        void afterMessagesAreConsumed(Pointer<commands::MessageDispatch> first,
+                                      Pointer<commands::MessageDispatch> last, int count);
+
+        void adjustPrefetch(int consumed);
+
+        void checkMemoryLimit();
+
+        void sendPrefetchControl(int prefetch);
+
         void immediateIndividualTransactedAck(Pointer<commands::MessageDispatch> dispatch);
 
         Pointer<commands::MessageAck> makeAckForAllDeliveredMessages(int type);
@@ -24,6 +24,7 @@
 #include <activemq/util/CMSExceptionSupport.h>
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
+#include <activemq/util/DestinationCache.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/InvalidStateException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
@@ -57,7 +58,12 @@ ActiveMQProducerKernel::ActiveMQProducerKernel(ActiveMQSessionKernel* session,
                                                                         memoryUsage(),
                                                                         destination(),
                                                                         messageSequence(),
-                                                                        transformer() {
+                                                                        transformer(),
+                                                                        windowListener(NULL),
+                                                                        windowListenerProducer(NULL),
+                                                                        windowListenerPending(false),
+                                                                        windowFullCount(0),
+                                                                        windowBlockedTime(NULL) {
 
     if (session == NULL || producerId == NULL) {
         throw ActiveMQException(
@@ -85,6 +91,8 @@ ActiveMQProducerKernel::ActiveMQProducerKernel(ActiveMQSessionKernel* session,
     // size > 0
     if (session->getConnection()->getProtocolVersion() >= 3 && session->getConnection()->getProducerWindowSize() > 0) {
         this->memoryUsage.reset(new MemoryUsage(session->getConnection()->getProducerWindowSize()));
+        this->windowBlockedTime =
+            session->getConnection()->getMetricsRegistry().getHistogram("producer.windowBlockedTime");
     }
 }
 
@@ -229,12 +237,15 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
             dest = this->producerInfo->getDestination();
         } else if (this->producerInfo->getDestination() == NULL) {
             // We always need to use a copy of the users destination since we want to control
-            // its lifetime.  If the transform results in a new destination we can use that, but
-            // if its already an ActiveMQDestination then we need to clone it.
+            // its lifetime.  The connection keeps one shared copy per destination so routing
+            // producers don't allocate a new one on every send, if the transform results in
+            // a new destination it is only needed long enough to find the shared copy.
+            DestinationCache& cache = this->session->getConnection()->getDestinationCache();
             if (ActiveMQMessageTransformation::transformDestination(destination, &transformed)) {
-                dest.reset(const_cast<ActiveMQDestination*>(transformed));
+                std::auto_ptr<const ActiveMQDestination> converted(transformed);
+                dest = cache.intern(converted.get());
             } else {
-                dest.reset(transformed->cloneDataStructure());
+                dest = cache.intern(transformed);
             }
         } else {
             throw cms::UnsupportedOperationException(
@@ -262,7 +273,14 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
 
         if (this->memoryUsage.get() != NULL) {
             try {
-                this->memoryUsage->waitForSpace();
+                if (this->memoryUsage->isFull()) {
+                    this->windowFullCount.incrementAndGet();
+                    long long start = System::nanoTime();
+                    this->memoryUsage->waitForSpace();
+                    this->windowBlockedTime->record(System::nanoTime() - start);
+                } else {
+                    this->memoryUsage->waitForSpace();
+                }
             } catch (InterruptedException& e) {
                 throw cms::CMSException("Send aborted due to thread interrupt.");
             }
@@ -274,6 +292,93 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        return this->trySend(this->destination.get(), message, defaultDeliveryMode, defaultPriority, defaultTimeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(cms::Message* message, int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        this->checkClosed();
+        return this->trySend(this->destination.get(), message, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(const cms::Destination* destination, cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        return this->trySend(destination, message, defaultDeliveryMode, defaultPriority, defaultTimeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::trySend(const cms::Destination* destination, cms::Message* message,
+                                     int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+
+        this->checkClosed();
+
+        if (this->memoryUsage.get() != NULL && this->memoryUsage->isFull()) {
+
+            // Record that the listener is owed a notification before checking again, a
+            // ProducerAck that lands between the two checks will then either be seen here
+            // or will trigger the listener from onProducerAck.
+            this->windowListenerPending.set(true);
+
+            if (this->memoryUsage->isFull()) {
+                this->windowFullCount.incrementAndGet();
+                return false;
+            }
+        }
+
+        this->send(destination, message, deliveryMode, priority, timeToLive, NULL);
+        return true;
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long ActiveMQProducerKernel::getProducerWindowSize() const {
+
+    if (this->memoryUsage.get() != NULL) {
+        return this->memoryUsage->getLimit();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long ActiveMQProducerKernel::getProducerWindowUsage() const {
+
+    if (this->memoryUsage.get() != NULL) {
+        return this->memoryUsage->getUsage();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::isProducerWindowFull() const {
+
+    if (this->memoryUsage.get() != NULL) {
+        return this->memoryUsage->isFull();
+    }
+
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQProducerKernel::onProducerAck(const commands::ProducerAck& ack) {
 
@@ -281,6 +386,13 @@ void ActiveMQProducerKernel::onProducerAck(const commands::ProducerAck& ack) {
 
         if (this->memoryUsage.get() != NULL) {
             this->memoryUsage->decreaseUsage(ack.getSize());
+
+            if (!this->memoryUsage->isFull() && this->windowListenerPending.compareAndSet(true, false)) {
+                ProducerWindowListener* listener = this->windowListener;
+                if (listener != NULL) {
+                    listener->onWindowAvailable(this->windowListenerProducer);
+                }
+            }
         }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
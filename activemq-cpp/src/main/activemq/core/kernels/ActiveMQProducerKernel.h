@@ -30,6 +30,10 @@
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/commands/ProducerAck.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/core/ProducerWindowListener.h>
+#include <activemq/metrics/Histogram.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 
 #include <memory>
 
@@ -83,6 +87,21 @@ namespace kernels {
         // Used to tranform Message before sending them to the CMS bus.
         cms::MessageTransformer* transformer;
 
+        // Listener notified when a full producer window has space again, can be NULL.
+        ProducerWindowListener* windowListener;
+
+        // The producer handed to the window listener, the facade the listener was set on.
+        cms::MessageProducer* windowListenerProducer;
+
+        // Set when a trySend call found the window full and the listener is owed a callback.
+        decaf::util::concurrent::atomic::AtomicBoolean windowListenerPending;
+
+        // Number of sends that found the producer window full, blocked or rejected.
+        decaf::util::concurrent::atomic::AtomicInteger windowFullCount;
+
+        // The Connection's histogram of the time sends spent blocked on a full window.
+        metrics::Histogram* windowBlockedTime;
+
     private:
 
         ActiveMQProducerKernel(const ActiveMQProducerKernel&);
@@ -250,6 +269,88 @@ namespace kernels {
             return this->sendTimeout;
         }
 
+    public:
+
+        /**
+         * Attempts to send the given message to the Producer's assigned Destination using
+         * the Producer's default delivery mode, priority and time to live, without waiting
+         * for space in the producer window.
+         *
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window was full and
+         *         the message was not sent.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        virtual bool trySend(cms::Message* message);
+
+        /**
+         * Attempts to send the given message to the Producer's assigned Destination without
+         * waiting for space in the producer window.
+         *
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         *
+         * @return true if the message was sent, false if the producer window was full and
+         *         the message was not sent.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        virtual bool trySend(cms::Message* message, int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Attempts to send the given message to the given Destination using the Producer's
+         * default delivery mode, priority and time to live, without waiting for space in
+         * the producer window.
+         *
+         * @param destination
+         *      The destination on which to send the message
+         * @param message
+         *      The message to be sent.
+         *
+         * @return true if the message was sent, false if the producer window was full and
+         *         the message was not sent.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        virtual bool trySend(const cms::Destination* destination, cms::Message* message);
+
+        /**
+         * Attempts to send the given message to the given Destination without waiting for
+         * space in the producer window.  When the window is full the message is left untouched
+         * and false is returned, if a ProducerWindowListener is registered it is notified once
+         * a ProducerAck from the broker frees space in the window.
+         *
+         * Only asynchronous sends consume space in the producer window, a message that is sent
+         * synchronously will still wait for the broker's response.
+         *
+         * @param destination
+         *      The destination on which to send the message
+         * @param message
+         *      The message to be sent.
+         * @param deliveryMode
+         *      The delivery mode to be used.
+         * @param priority
+         *      The priority for this message.
+         * @param timeToLive
+         *      The time to live value for this message in milliseconds.
+         *
+         * @return true if the message was sent, false if the producer window was full and
+         *         the message was not sent.
+         *
+         * @throws CMSException if an internal error occurs while sending the message.
+         */
+        virtual bool trySend(const cms::Destination* destination, cms::Message* message,
+                             int deliveryMode, int priority, long long timeToLive);
+
         /**
          * @return true if this Producer has been closed.
          */
@@ -275,6 +376,55 @@ namespace kernels {
             return this->producerInfo->getProducerId();
         }
 
+        /**
+         * Sets the listener that is notified when the producer window has space available
+         * after a call to trySend found it full.
+         *
+         * @param listener
+         *      The ProducerWindowListener to notify, or NULL to clear the current listener.
+         * @param producer
+         *      The producer passed to the listener, NULL to pass this kernel.
+         */
+        void setProducerWindowListener(ProducerWindowListener* listener, cms::MessageProducer* producer = NULL) {
+            this->windowListenerProducer = producer != NULL ? producer : this;
+            this->windowListener = listener;
+        }
+
+        /**
+         * Gets the listener that is notified when the producer window has space available.
+         *
+         * @return the registered ProducerWindowListener or NULL if none is set.
+         */
+        ProducerWindowListener* getProducerWindowListener() const {
+            return this->windowListener;
+        }
+
+        /**
+         * @return the size in bytes of this producer's window, or zero if producer window
+         *         flow control is not in use for this producer.
+         */
+        unsigned long long getProducerWindowSize() const;
+
+        /**
+         * @return the number of bytes sent by this producer that the broker has yet to
+         *         acknowledge with a ProducerAck, always zero if flow control is not in use.
+         */
+        unsigned long long getProducerWindowUsage() const;
+
+        /**
+         * @return true if the producer window is currently full, a call to send would block
+         *         and a call to trySend would return false.
+         */
+        bool isProducerWindowFull() const;
+
+        /**
+         * @return the number of sends from this producer that found the producer window full,
+         *         counting both sends that blocked and calls to trySend that returned false.
+         */
+        long long getProducerWindowFullCount() const {
+            return this->windowFullCount.get();
+        }
+
         /**
          * Handles the work of Processing a ProducerAck Command from the Broker.
          * @param ack - The ProducerAck message received from the Broker.
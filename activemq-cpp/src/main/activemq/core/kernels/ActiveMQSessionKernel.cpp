@@ -592,7 +592,7 @@ cms::MessageConsumer* ActiveMQSessionKernel::createConsumer(const cms::Destinati
 
         try{
             this->addConsumer(consumer);
-            this->connection->syncRequest(consumer->getConsumerInfo());
+            this->connection->registrationRequest(consumer->getConsumerInfo());
         } catch (Exception& ex) {
             this->removeConsumer(consumer);
             throw;
@@ -636,7 +636,7 @@ cms::MessageConsumer* ActiveMQSessionKernel::createDurableConsumer(const cms::To
 
         try {
             this->addConsumer(consumer);
-            this->connection->syncRequest(consumer->getConsumerInfo());
+            this->connection->registrationRequest(consumer->getConsumerInfo());
         } catch (Exception& ex) {
             this->removeConsumer(consumer);
             throw;
@@ -686,7 +686,7 @@ cms::MessageProducer* ActiveMQSessionKernel::createProducer(const cms::Destinati
 
         try {
             this->addProducer(producer);
-            this->connection->syncRequest(producer->getProducerInfo());
+            this->connection->registrationRequest(producer->getProducerInfo());
         } catch (Exception& ex) {
             this->removeProducer(producer);
             throw;
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AdaptivePrefetchPolicy.h"
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Math.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::core::policies;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+int AdaptivePrefetchPolicy::DEFAULT_MINIMUM_PREFETCH = 1;
+long long AdaptivePrefetchPolicy::DEFAULT_ADJUSTMENT_INTERVAL = 1000;
+long long AdaptivePrefetchPolicy::DEFAULT_TARGET_BACKLOG_TIME = 1000;
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchPolicy::AdaptivePrefetchPolicy() :
+    DefaultPrefetchPolicy(),
+    minimumPrefetch(DEFAULT_MINIMUM_PREFETCH),
+    adjustmentInterval(DEFAULT_ADJUSTMENT_INTERVAL),
+    targetBacklogTime(DEFAULT_TARGET_BACKLOG_TIME) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchPolicy::~AdaptivePrefetchPolicy() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PrefetchPolicy* AdaptivePrefetchPolicy::clone() const {
+
+    AdaptivePrefetchPolicy* copy = new AdaptivePrefetchPolicy;
+
+    copy->setDurableTopicPrefetch(this->getDurableTopicPrefetch());
+    copy->setTopicPrefetch(this->getTopicPrefetch());
+    copy->setQueueBrowserPrefetch(this->getQueueBrowserPrefetch());
+    copy->setQueuePrefetch(this->getQueuePrefetch());
+    copy->setMinimumPrefetch(this->getMinimumPrefetch());
+    copy->setAdjustmentInterval(this->getAdjustmentInterval());
+    copy->setTargetBacklogTime(this->getTargetBacklogTime());
+
+    return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int AdaptivePrefetchPolicy::adjustPrefetch(int currentPrefetch, int maximumPrefetch, int pendingMessages,
+                                           long long consumedMessages, long long elapsedTime) const {
+
+    if (elapsedTime <= 0 || maximumPrefetch <= 0) {
+        return currentPrefetch;
+    }
+
+    // The number of messages this consumer gets through in the target backlog time
+    // at the rate it has been consuming since the last adjustment.
+    long long target = (consumedMessages * this->targetBacklogTime) / elapsedTime;
+    long long result = currentPrefetch;
+
+    if (pendingMessages == 0) {
+        // Consumer drained everything it was sent, let the broker send more, if it
+        // hasn't seen anything at all there's nothing to base a change on.
+        if (consumedMessages > 0) {
+            result = Math::max((long long) currentPrefetch * 2, target);
+        }
+    } else if (target < currentPrefetch) {
+        // Consumer is holding more than it can process in the target time, back off
+        // gradually so that a single slow interval doesn't collapse the window.
+        result = Math::max(target, (long long) currentPrefetch / 2);
+    }
+
+    int minimum = Math::min(this->minimumPrefetch, maximumPrefetch);
+
+    if (result < minimum) {
+        result = minimum;
+    } else if (result > maximumPrefetch) {
+        result = maximumPrefetch;
+    }
+
+    return (int) result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicy::configure(const decaf::util::Properties& properties) {
+
+    try {
+
+        DefaultPrefetchPolicy::configure(properties);
+
+        if (properties.hasProperty("cms.prefetchPolicy.minimumPrefetch")) {
+            this->setMinimumPrefetch(Integer::parseInt(
+                properties.getProperty("cms.prefetchPolicy.minimumPrefetch")));
+        }
+        if (properties.hasProperty("cms.prefetchPolicy.adjustmentInterval")) {
+            this->setAdjustmentInterval(Long::parseLong(
+                properties.getProperty("cms.prefetchPolicy.adjustmentInterval")));
+        }
+        if (properties.hasProperty("cms.prefetchPolicy.targetBacklogTime")) {
+            this->setTargetBacklogTime(Long::parseLong(
+                properties.getProperty("cms.prefetchPolicy.targetBacklogTime")));
+        }
+    }
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_POLICIES_ADAPTIVEPREFETCHPOLICY_H_
+#define _ACTIVEMQ_CORE_POLICIES_ADAPTIVEPREFETCHPOLICY_H_
+
+#include <activemq/util/Config.h>
+
+#include <activemq/core/policies/DefaultPrefetchPolicy.h>
+
+namespace activemq {
+namespace core {
+namespace policies {
+
+    /**
+     * A PrefetchPolicy that lets each consumer grow and shrink its prefetch limit at runtime
+     * based on how quickly it is actually consuming messages.  The configured prefetch values
+     * act as the upper bound for a consumer, the consumer starts at that value and then at each
+     * adjustment interval computes how many messages it can consume in the target backlog time.
+     *
+     * A consumer whose buffered messages would take longer than the target backlog time to
+     * consume has its prefetch reduced so that it stops hoarding messages other consumers on
+     * the same destination could be processing.  A consumer that has drained its buffer has its
+     * prefetch doubled so that it is never left waiting on the broker.  The new limit is sent to
+     * the broker in a ConsumerControl command.
+     *
+     * The policy can be configured from the connection URI using the options prefixed with
+     * cms.prefetchPolicy, for instance cms.prefetchPolicy.minimumPrefetch=10.
+     */
+    class AMQCPP_API AdaptivePrefetchPolicy : public DefaultPrefetchPolicy {
+    private:
+
+        int minimumPrefetch;
+        long long adjustmentInterval;
+        long long targetBacklogTime;
+
+    public:
+
+        static int DEFAULT_MINIMUM_PREFETCH;
+        static long long DEFAULT_ADJUSTMENT_INTERVAL;
+        static long long DEFAULT_TARGET_BACKLOG_TIME;
+
+    private:
+
+        AdaptivePrefetchPolicy(const AdaptivePrefetchPolicy&);
+        AdaptivePrefetchPolicy& operator=(AdaptivePrefetchPolicy&);
+
+    public:
+
+        AdaptivePrefetchPolicy();
+
+        virtual ~AdaptivePrefetchPolicy();
+
+        /**
+         * Sets the smallest prefetch limit a consumer can be reduced to.
+         *
+         * @param value
+         *      The minimum prefetch, values less than one are treated as one.
+         */
+        void setMinimumPrefetch(int value) {
+            this->minimumPrefetch = value < 1 ? 1 : getMaxPrefetchLimit(value);
+        }
+
+        /**
+         * @return the smallest prefetch limit a consumer can be reduced to.
+         */
+        int getMinimumPrefetch() const {
+            return this->minimumPrefetch;
+        }
+
+        /**
+         * Sets the time in milliseconds a consumer waits between prefetch adjustments.
+         *
+         * @param value
+         *      The adjustment interval in milliseconds.
+         */
+        void setAdjustmentInterval(long long value) {
+            this->adjustmentInterval = value;
+        }
+
+        /**
+         * @return the time in milliseconds a consumer waits between prefetch adjustments.
+         */
+        long long getAdjustmentInterval() const {
+            return this->adjustmentInterval;
+        }
+
+        /**
+         * Sets the amount of work, measured in milliseconds at the consumer's observed rate,
+         * that a consumer should keep buffered.
+         *
+         * @param value
+         *      The target backlog time in milliseconds.
+         */
+        void setTargetBacklogTime(long long value) {
+            this->targetBacklogTime = value;
+        }
+
+        /**
+         * @return the amount of work in milliseconds a consumer aims to keep buffered.
+         */
+        long long getTargetBacklogTime() const {
+            return this->targetBacklogTime;
+        }
+
+        virtual PrefetchPolicy* clone() const;
+
+        virtual bool isAdaptive() const {
+            return true;
+        }
+
+        virtual long long getPrefetchAdjustmentInterval() const {
+            return this->adjustmentInterval;
+        }
+
+        virtual int adjustPrefetch(int currentPrefetch, int maximumPrefetch, int pendingMessages,
+                                   long long consumedMessages, long long elapsedTime) const;
+
+        virtual void configure(const decaf::util::Properties& properties);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_CORE_POLICIES_ADAPTIVEPREFETCHPOLICY_H_ */
@@ -20,12 +20,18 @@
 #include <decaf/lang/Runtime.h>
 #include <activemq/wireformat/WireFormatRegistry.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/compression/CompressionCodecRegistry.h>
 
 #include <activemq/util/IdGenerator.h>
+#include <activemq/metrics/Tracer.h>
+#include <activemq/selector/SelectorParser.h>
 
 #include <activemq/wireformat/stomp/StompWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 
+#include <activemq/compression/DeflateCompressionCodec.h>
+#include <activemq/compression/LZ4CompressionCodec.h>
+
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/tcp/TcpTransportFactory.h>
 #include <activemq/transport/tcp/SslTransportFactory.h>
@@ -33,6 +39,9 @@
 
 using namespace activemq;
 using namespace activemq::library;
+using namespace activemq::compression;
+using namespace activemq::metrics;
+using namespace activemq::selector;
 using namespace activemq::util;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
@@ -56,6 +65,9 @@ void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
     // Initialize the Decaf Library by requesting its runtime.
     decaf::lang::Runtime::initializeRuntime(argc, argv);
 
+    // Register all Compression Codecs, the WireFormats advertise their names.
+    ActiveMQCPP::registerCompressionCodecs();
+
     // Register all WireFormats
     ActiveMQCPP::registerWireFormats();
 
@@ -64,6 +76,12 @@ void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
 
     // Start the IdGenerator Kernel
     IdGenerator::initialize();
+
+    // Start the Tracer Kernel, tracing remains disabled until requested.
+    Tracer::initialize();
+
+    // Start the cache of compiled selectors.
+    SelectorParser::initialize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,11 +92,18 @@ void ActiveMQCPP::initializeLibrary() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::shutdownLibrary() {
 
+    // Shutdown the compiled selector cache
+    SelectorParser::shutdown();
+
+    // Shutdown the Tracer Kernel
+    Tracer::shutdown();
+
     // Shutdown the IdGenerator Kernel
     IdGenerator::shutdown();
 
     WireFormatRegistry::shutdown();
     TransportRegistry::shutdown();
+    CompressionCodecRegistry::shutdown();
 
     // Now it should be safe to shutdown Decaf.
     decaf::lang::Runtime::shutdownRuntime();
@@ -108,3 +133,13 @@ void ActiveMQCPP::registerTransports() {
     TransportRegistry::getInstance().registerFactory("mock", new MockTransportFactory());
     TransportRegistry::getInstance().registerFactory("failover", new FailoverTransportFactory());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQCPP::registerCompressionCodecs() {
+
+    // Each of the internally implemented Compression Codecs is registered here
+    CompressionCodecRegistry::initialize();
+
+    CompressionCodecRegistry::getInstance().registerCodec(new DeflateCompressionCodec());
+    CompressionCodecRegistry::getInstance().registerCodec(new LZ4CompressionCodec());
+}
@@ -69,6 +69,7 @@ namespace library {
 
         static void registerWireFormats();
         static void registerTransports();
+        static void registerCompressionCodecs();
 
     };
 
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Counter.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/lang/Thread.h>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::lang;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+Counter::Counter() : cells() {
+    for (int i = 0; i < CELLS; ++i) {
+        this->cells[i].value = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Counter::~Counter() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Counter::add(long long delta) {
+    int cell = (int)(Thread::currentThread()->getId() & (CELLS - 1));
+    Atomics::getAndAdd64(&this->cells[cell].value, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Counter::getCount() const {
+
+    long long result = 0;
+    for (int i = 0; i < CELLS; ++i) {
+        result += Atomics::getAndAdd64(const_cast<volatile long long*>(&this->cells[i].value), 0);
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Counter::reset() {
+    for (int i = 0; i < CELLS; ++i) {
+        long long current = Atomics::getAndAdd64(&this->cells[i].value, 0);
+        Atomics::getAndAdd64(&this->cells[i].value, -current);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_COUNTER_H_
+#define _ACTIVEMQ_METRICS_COUNTER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * A monotonically increasing count that many threads can update without
+     * contending with each other.  The count is spread over a number of cache
+     * line sized cells, each thread adds to the cell picked by its thread id and
+     * readers sum all the cells, so updates never take a lock.
+     */
+    class AMQCPP_API Counter {
+    public:
+
+        static const int CELLS = 16;
+
+    private:
+
+        struct Cell {
+            volatile long long value;
+            char padding[64 - sizeof(long long)];
+        };
+
+        Cell cells[CELLS];
+
+    private:
+
+        Counter(const Counter&);
+        Counter& operator=(const Counter&);
+
+    public:
+
+        Counter();
+
+        virtual ~Counter();
+
+        /**
+         * Adds one to the count.
+         */
+        void increment() {
+            add(1);
+        }
+
+        /**
+         * Adds the given amount to the count.
+         *
+         * @param delta
+         *      The amount to add.
+         */
+        void add(long long delta);
+
+        /**
+         * Gets the current count, updates that happen while the cells are being
+         * summed may or may not be included.
+         *
+         * @return the sum of all the updates made so far.
+         */
+        long long getCount() const;
+
+        /**
+         * Sets the count back to zero.
+         */
+        void reset();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_COUNTER_H_ */
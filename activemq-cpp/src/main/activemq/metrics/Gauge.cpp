@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Gauge.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+Gauge::Gauge() : value(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Gauge::~Gauge() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Gauge::set(long long value) {
+
+    long long current = get();
+    while (!Atomics::compareAndSet64(&this->value, current, value)) {
+        current = get();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Gauge::add(long long delta) {
+    Atomics::getAndAdd64(&this->value, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Gauge::get() const {
+    return Atomics::getAndAdd64(const_cast<volatile long long*>(&this->value), 0);
+}
@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_GAUGE_H_
+#define _ACTIVEMQ_METRICS_GAUGE_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * A single value that can move up and down, such as the depth of a queue.
+     * Gauges are either updated as the value changes or sampled just before a
+     * snapshot of the registry is taken.
+     */
+    class AMQCPP_API Gauge {
+    private:
+
+        volatile long long value;
+
+    private:
+
+        Gauge(const Gauge&);
+        Gauge& operator=(const Gauge&);
+
+    public:
+
+        Gauge();
+
+        virtual ~Gauge();
+
+        /**
+         * Replaces the current value.
+         *
+         * @param value
+         *      The new value of the gauge.
+         */
+        void set(long long value);
+
+        /**
+         * Adds the given amount, which can be negative, to the current value.
+         *
+         * @param delta
+         *      The amount to add.
+         */
+        void add(long long delta);
+
+        /**
+         * @return the current value of the gauge.
+         */
+        long long get() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_GAUGE_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Histogram.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/lang/Long.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::lang;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    int floorLog2(unsigned long long value) {
+
+        int result = 0;
+        if (value >= (1ULL << 32)) { value >>= 32; result += 32; }
+        if (value >= (1ULL << 16)) { value >>= 16; result += 16; }
+        if (value >= (1ULL << 8)) { value >>= 8; result += 8; }
+        if (value >= (1ULL << 4)) { value >>= 4; result += 4; }
+        if (value >= (1ULL << 2)) { value >>= 2; result += 2; }
+        if (value >= (1ULL << 1)) { result += 1; }
+
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Histogram::Histogram() : counts(), count(0), sum(0), min(Long::MAX_VALUE), max(0) {
+    for (int i = 0; i < BUCKETS; ++i) {
+        this->counts[i] = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Histogram::~Histogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Histogram::getBucketIndex(long long value) {
+
+    if (value < SUB_BUCKETS) {
+        return value < 0 ? 0 : (int) value;
+    }
+
+    int shift = floorLog2((unsigned long long) value) - SUB_BUCKET_BITS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + (int) ((value >> shift) - SUB_BUCKETS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getHighestValueInBucket(int index) {
+
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    int shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    long long lowest = (long long) (SUB_BUCKETS + (index - SUB_BUCKETS) % SUB_BUCKETS) << shift;
+
+    return lowest + ((1LL << shift) - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Histogram::record(long long value) {
+
+    if (value < 0) {
+        value = 0;
+    }
+
+    Atomics::getAndAdd64(&this->counts[getBucketIndex(value)], 1);
+    Atomics::getAndAdd64(&this->sum, value);
+    Atomics::getAndAdd64(&this->count, 1);
+
+    long long current = read(&this->max);
+    while (value > current && !Atomics::compareAndSet64(&this->max, current, value)) {
+        current = read(&this->max);
+    }
+
+    current = read(&this->min);
+    while (value < current && !Atomics::compareAndSet64(&this->min, current, value)) {
+        current = read(&this->min);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getCount() const {
+    return read(&this->count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getMin() const {
+    return getCount() == 0 ? 0 : read(&this->min);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getMax() const {
+    return read(&this->max);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double Histogram::getMean() const {
+
+    long long total = getCount();
+    if (total == 0) {
+        return 0.0;
+    }
+
+    return (double) read(&this->sum) / (double) total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getValueAtPercentile(double percentile) const {
+
+    std::vector<long long> bucketCounts(BUCKETS);
+    long long total = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        bucketCounts[i] = read(&this->counts[i]);
+        total += bucketCounts[i];
+    }
+
+    return getValueAtPercentile(&bucketCounts[0], total, getMax(), percentile);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::getValueAtPercentile(const long long* bucketCounts, long long total,
+                                          long long largest, double percentile) const {
+
+    if (total == 0) {
+        return 0;
+    }
+
+    if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    long long rank = (long long) ((percentile / 100.0) * (double) total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    long long seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += bucketCounts[i];
+        if (seen >= rank) {
+            long long value = getHighestValueInBucket(i);
+            return value < largest ? value : largest;
+        }
+    }
+
+    return largest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HistogramSnapshot Histogram::getSnapshot() const {
+
+    // Percentiles are all taken from the same copy of the buckets so they
+    // stay consistent with each other while values are being recorded.
+    std::vector<long long> bucketCounts(BUCKETS);
+    long long total = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        bucketCounts[i] = read(&this->counts[i]);
+        total += bucketCounts[i];
+    }
+
+    long long largest = getMax();
+
+    return HistogramSnapshot(total, getMin(), largest, getMean(),
+                             getValueAtPercentile(&bucketCounts[0], total, largest, 50.0),
+                             getValueAtPercentile(&bucketCounts[0], total, largest, 90.0),
+                             getValueAtPercentile(&bucketCounts[0], total, largest, 99.0),
+                             getValueAtPercentile(&bucketCounts[0], total, largest, 99.9));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Histogram::reset() {
+
+    for (int i = 0; i < BUCKETS; ++i) {
+        Atomics::getAndAdd64(&this->counts[i], -read(&this->counts[i]));
+    }
+
+    Atomics::getAndAdd64(&this->count, -read(&this->count));
+    Atomics::getAndAdd64(&this->sum, -read(&this->sum));
+
+    long long current = read(&this->max);
+    while (!Atomics::compareAndSet64(&this->max, current, 0)) {
+        current = read(&this->max);
+    }
+
+    current = read(&this->min);
+    while (!Atomics::compareAndSet64(&this->min, current, Long::MAX_VALUE)) {
+        current = read(&this->min);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Histogram::read(const volatile long long* target) const {
+    return Atomics::getAndAdd64(const_cast<volatile long long*>(target), 0);
+}
@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_HISTOGRAM_H_
+#define _ACTIVEMQ_METRICS_HISTOGRAM_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/HistogramSnapshot.h>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * Records the distribution of non-negative values, typically latencies in
+     * nanoseconds, in a fixed set of log-linear buckets in the style of an HDR
+     * histogram.  Each power of two range is split into SUB_BUCKETS equal buckets
+     * so any value is reported to within 1/SUB_BUCKETS of its true value, values
+     * below 2 * SUB_BUCKETS are exact.  Recording a value is a handful of atomic
+     * adds and never takes a lock or allocates memory.
+     */
+    class AMQCPP_API Histogram {
+    public:
+
+        static const int SUB_BUCKET_BITS = 4;
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int BUCKETS = SUB_BUCKETS + (63 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    private:
+
+        volatile long long counts[BUCKETS];
+        volatile long long count;
+        volatile long long sum;
+        volatile long long min;
+        volatile long long max;
+
+    private:
+
+        Histogram(const Histogram&);
+        Histogram& operator=(const Histogram&);
+
+    public:
+
+        Histogram();
+
+        virtual ~Histogram();
+
+        /**
+         * Records a value, negative values are recorded as zero.
+         *
+         * @param value
+         *      The value to add to the distribution.
+         */
+        void record(long long value);
+
+        /**
+         * @return the number of values recorded.
+         */
+        long long getCount() const;
+
+        /**
+         * @return the smallest value recorded or zero if none have been.
+         */
+        long long getMin() const;
+
+        /**
+         * @return the largest value recorded or zero if none have been.
+         */
+        long long getMax() const;
+
+        /**
+         * @return the mean of the values recorded or zero if none have been.
+         */
+        double getMean() const;
+
+        /**
+         * Gets the value below which the given percentage of the recorded values fall.
+         *
+         * @param percentile
+         *      A value between 0 and 100, e.g. 99.9
+         *
+         * @return the highest value in the bucket holding the value at the given
+         *         percentile, never more than getMax, or zero if nothing was recorded.
+         */
+        long long getValueAtPercentile(double percentile) const;
+
+        /**
+         * @return the count, range, mean and common percentiles of the values recorded.
+         */
+        HistogramSnapshot getSnapshot() const;
+
+        /**
+         * Throws out all the recorded values, values recorded while this runs may
+         * or may not be kept.
+         */
+        void reset();
+
+    public:
+
+        /**
+         * @return the index of the bucket that the given value is counted in.
+         */
+        static int getBucketIndex(long long value);
+
+        /**
+         * @return the highest value that is counted in the given bucket.
+         */
+        static long long getHighestValueInBucket(int index);
+
+    private:
+
+        long long read(const volatile long long* target) const;
+
+        long long getValueAtPercentile(const long long* bucketCounts, long long total,
+                                       long long largest, double percentile) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_HISTOGRAM_H_ */
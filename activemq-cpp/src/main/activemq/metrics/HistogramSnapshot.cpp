@@ -0,0 +1,35 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HistogramSnapshot.h"
+
+using namespace activemq;
+using namespace activemq::metrics;
+
+////////////////////////////////////////////////////////////////////////////////
+HistogramSnapshot::HistogramSnapshot() : count(0), min(0), max(0), mean(0), p50(0), p90(0), p99(0), p999(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HistogramSnapshot::HistogramSnapshot(long long count, long long min, long long max, double mean,
+                                     long long p50, long long p90, long long p99, long long p999) :
+    count(count), min(min), max(max), mean(mean), p50(p50), p90(p90), p99(p99), p999(p999) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HistogramSnapshot::~HistogramSnapshot() {
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_HISTOGRAMSNAPSHOT_H_
+#define _ACTIVEMQ_METRICS_HISTOGRAMSNAPSHOT_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * The distribution of the values recorded by a Histogram at the time the
+     * snapshot was taken.  Percentiles are the highest value that falls in the
+     * same bucket as the value at that rank.
+     */
+    class AMQCPP_API HistogramSnapshot {
+    private:
+
+        long long count;
+        long long min;
+        long long max;
+        double mean;
+        long long p50;
+        long long p90;
+        long long p99;
+        long long p999;
+
+    public:
+
+        HistogramSnapshot();
+
+        HistogramSnapshot(long long count, long long min, long long max, double mean,
+                          long long p50, long long p90, long long p99, long long p999);
+
+        virtual ~HistogramSnapshot();
+
+        long long getCount() const {
+            return this->count;
+        }
+
+        long long getMin() const {
+            return this->min;
+        }
+
+        long long getMax() const {
+            return this->max;
+        }
+
+        double getMean() const {
+            return this->mean;
+        }
+
+        long long get50thPercentile() const {
+            return this->p50;
+        }
+
+        long long get90thPercentile() const {
+            return this->p90;
+        }
+
+        long long get99thPercentile() const {
+            return this->p99;
+        }
+
+        long long get999thPercentile() const {
+            return this->p999;
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_HISTOGRAMSNAPSHOT_H_ */
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetricsRegistry.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/concurrent/Concurrent.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    template<typename T>
+    T* lookup(std::map<std::string, T*>& metrics, const std::string& name) {
+
+        typename std::map<std::string, T*>::iterator iter = metrics.find(name);
+        if (iter != metrics.end()) {
+            return iter->second;
+        }
+
+        T* metric = new T();
+        metrics[name] = metric;
+        return metric;
+    }
+
+    template<typename T>
+    void destroy(std::map<std::string, T*>& metrics) {
+
+        typename std::map<std::string, T*>::iterator iter = metrics.begin();
+        for (; iter != metrics.end(); ++iter) {
+            delete iter->second;
+        }
+
+        metrics.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsRegistry::MetricsRegistry() : counters(), gauges(), histograms(), mutex() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsRegistry::~MetricsRegistry() {
+    try {
+        destroy(this->counters);
+        destroy(this->gauges);
+        destroy(this->histograms);
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Counter* MetricsRegistry::getCounter(const std::string& name) {
+
+    synchronized(&this->mutex) {
+        return lookup(this->counters, name);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Gauge* MetricsRegistry::getGauge(const std::string& name) {
+
+    synchronized(&this->mutex) {
+        return lookup(this->gauges, name);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Histogram* MetricsRegistry::getHistogram(const std::string& name) {
+
+    synchronized(&this->mutex) {
+        return lookup(this->histograms, name);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot MetricsRegistry::getSnapshot() const {
+
+    MetricsSnapshot snapshot(System::currentTimeMillis());
+
+    synchronized(&this->mutex) {
+
+        std::map<std::string, Counter*>::const_iterator counter = this->counters.begin();
+        for (; counter != this->counters.end(); ++counter) {
+            snapshot.setCounter(counter->first, counter->second->getCount());
+        }
+
+        std::map<std::string, Gauge*>::const_iterator gauge = this->gauges.begin();
+        for (; gauge != this->gauges.end(); ++gauge) {
+            snapshot.setGauge(gauge->first, gauge->second->get());
+        }
+
+        std::map<std::string, Histogram*>::const_iterator histogram = this->histograms.begin();
+        for (; histogram != this->histograms.end(); ++histogram) {
+            snapshot.setHistogram(histogram->first, histogram->second->getSnapshot());
+        }
+    }
+
+    return snapshot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistry::reset() {
+
+    synchronized(&this->mutex) {
+
+        std::map<std::string, Counter*>::iterator counter = this->counters.begin();
+        for (; counter != this->counters.end(); ++counter) {
+            counter->second->reset();
+        }
+
+        std::map<std::string, Gauge*>::iterator gauge = this->gauges.begin();
+        for (; gauge != this->gauges.end(); ++gauge) {
+            gauge->second->set(0);
+        }
+
+        std::map<std::string, Histogram*>::iterator histogram = this->histograms.begin();
+        for (; histogram != this->histograms.end(); ++histogram) {
+            histogram->second->reset();
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_METRICSREGISTRY_H_
+#define _ACTIVEMQ_METRICS_METRICSREGISTRY_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/Counter.h>
+#include <activemq/metrics/Gauge.h>
+#include <activemq/metrics/Histogram.h>
+#include <activemq/metrics/MetricsSnapshot.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * Holds the named Counters, Gauges and Histograms of one client component.
+     *
+     * A metric is created the first time it is asked for and lives as long as the
+     * registry, so callers on a hot path look a metric up once and keep the pointer,
+     * updating it from then on never takes a lock.  Only the lookup and getSnapshot
+     * synchronize on the registry.
+     */
+    class AMQCPP_API MetricsRegistry {
+    private:
+
+        std::map<std::string, Counter*> counters;
+        std::map<std::string, Gauge*> gauges;
+        std::map<std::string, Histogram*> histograms;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+    private:
+
+        MetricsRegistry(const MetricsRegistry&);
+        MetricsRegistry& operator=(const MetricsRegistry&);
+
+    public:
+
+        MetricsRegistry();
+
+        virtual ~MetricsRegistry();
+
+        /**
+         * Gets the named Counter, creating it if needed.
+         *
+         * @param name
+         *      The name of the counter.
+         *
+         * @return a pointer to the counter that remains owned by this registry.
+         */
+        Counter* getCounter(const std::string& name);
+
+        /**
+         * Gets the named Gauge, creating it if needed.
+         *
+         * @param name
+         *      The name of the gauge.
+         *
+         * @return a pointer to the gauge that remains owned by this registry.
+         */
+        Gauge* getGauge(const std::string& name);
+
+        /**
+         * Gets the named Histogram, creating it if needed.
+         *
+         * @param name
+         *      The name of the histogram.
+         *
+         * @return a pointer to the histogram that remains owned by this registry.
+         */
+        Histogram* getHistogram(const std::string& name);
+
+        /**
+         * @return a copy of the current value of every metric in this registry.
+         */
+        MetricsSnapshot getSnapshot() const;
+
+        /**
+         * Sets every counter, gauge and histogram back to zero.
+         */
+        void reset();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_METRICSREGISTRY_H_ */
@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetricsSnapshot.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::metrics;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    template<typename T>
+    std::vector<std::string> keysOf(const std::map<std::string, T>& values) {
+
+        std::vector<std::string> result;
+        typename std::map<std::string, T>::const_iterator iter = values.begin();
+        for (; iter != values.end(); ++iter) {
+            result.push_back(iter->first);
+        }
+
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot::MetricsSnapshot() : timestamp(0), counters(), gauges(), histograms() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot::MetricsSnapshot(long long timestamp) : timestamp(timestamp), counters(), gauges(), histograms() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot::~MetricsSnapshot() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MetricsSnapshot::getCounter(const std::string& name) const {
+    std::map<std::string, long long>::const_iterator iter = this->counters.find(name);
+    return iter == this->counters.end() ? 0 : iter->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MetricsSnapshot::getGauge(const std::string& name) const {
+    std::map<std::string, long long>::const_iterator iter = this->gauges.find(name);
+    return iter == this->gauges.end() ? 0 : iter->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HistogramSnapshot MetricsSnapshot::getHistogram(const std::string& name) const {
+    std::map<std::string, HistogramSnapshot>::const_iterator iter = this->histograms.find(name);
+    return iter == this->histograms.end() ? HistogramSnapshot() : iter->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MetricsSnapshot::hasCounter(const std::string& name) const {
+    return this->counters.find(name) != this->counters.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MetricsSnapshot::hasGauge(const std::string& name) const {
+    return this->gauges.find(name) != this->gauges.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MetricsSnapshot::hasHistogram(const std::string& name) const {
+    return this->histograms.find(name) != this->histograms.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> MetricsSnapshot::getCounterNames() const {
+    return keysOf(this->counters);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> MetricsSnapshot::getGaugeNames() const {
+    return keysOf(this->gauges);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> MetricsSnapshot::getHistogramNames() const {
+    return keysOf(this->histograms);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsSnapshot::setCounter(const std::string& name, long long value) {
+    this->counters[name] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsSnapshot::setGauge(const std::string& name, long long value) {
+    this->gauges[name] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsSnapshot::setHistogram(const std::string& name, const HistogramSnapshot& value) {
+    this->histograms[name] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string MetricsSnapshot::toString() const {
+
+    std::ostringstream stream;
+
+    std::map<std::string, long long>::const_iterator iter = this->counters.begin();
+    for (; iter != this->counters.end(); ++iter) {
+        stream << iter->first << " count=" << iter->second << std::endl;
+    }
+
+    for (iter = this->gauges.begin(); iter != this->gauges.end(); ++iter) {
+        stream << iter->first << " value=" << iter->second << std::endl;
+    }
+
+    std::map<std::string, HistogramSnapshot>::const_iterator histogram = this->histograms.begin();
+    for (; histogram != this->histograms.end(); ++histogram) {
+        const HistogramSnapshot& values = histogram->second;
+        stream << histogram->first
+               << " count=" << values.getCount()
+               << " min=" << values.getMin()
+               << " mean=" << (long long) values.getMean()
+               << " p50=" << values.get50thPercentile()
+               << " p90=" << values.get90thPercentile()
+               << " p99=" << values.get99thPercentile()
+               << " p99.9=" << values.get999thPercentile()
+               << " max=" << values.getMax() << std::endl;
+    }
+
+    return stream.str();
+}
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_METRICSSNAPSHOT_H_
+#define _ACTIVEMQ_METRICS_METRICSSNAPSHOT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/HistogramSnapshot.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * A copy of the values of every metric in a MetricsRegistry at one point in
+     * time.  Snapshots are plain values that can be kept, compared with a later
+     * snapshot or exported without holding on to the registry.
+     */
+    class AMQCPP_API MetricsSnapshot {
+    private:
+
+        long long timestamp;
+        std::map<std::string, long long> counters;
+        std::map<std::string, long long> gauges;
+        std::map<std::string, HistogramSnapshot> histograms;
+
+    public:
+
+        MetricsSnapshot();
+
+        MetricsSnapshot(long long timestamp);
+
+        virtual ~MetricsSnapshot();
+
+        /**
+         * @return the time in milliseconds since the epoch when the snapshot was taken.
+         */
+        long long getTimestamp() const {
+            return this->timestamp;
+        }
+
+        /**
+         * @return the value of the named counter, or zero if there is no such counter.
+         */
+        long long getCounter(const std::string& name) const;
+
+        /**
+         * @return the value of the named gauge, or zero if there is no such gauge.
+         */
+        long long getGauge(const std::string& name) const;
+
+        /**
+         * @return the named histogram, or an empty one if there is no such histogram.
+         */
+        HistogramSnapshot getHistogram(const std::string& name) const;
+
+        bool hasCounter(const std::string& name) const;
+
+        bool hasGauge(const std::string& name) const;
+
+        bool hasHistogram(const std::string& name) const;
+
+        std::vector<std::string> getCounterNames() const;
+
+        std::vector<std::string> getGaugeNames() const;
+
+        std::vector<std::string> getHistogramNames() const;
+
+        void setCounter(const std::string& name, long long value);
+
+        void setGauge(const std::string& name, long long value);
+
+        void setHistogram(const std::string& name, const HistogramSnapshot& value);
+
+        /**
+         * Formats every metric as a line of name=value pairs, sorted by name,
+         * suitable for writing to a log.
+         *
+         * @return the metrics in text form.
+         */
+        std::string toString() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_METRICSSNAPSHOT_H_ */
@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TraceAnalyzer.h"
+
+#include <activemq/metrics/Histogram.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::metrics;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    bool compareTimestamps(const TraceEvent& left, const TraceEvent& right) {
+        return left.timestamp < right.timestamp;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceAnalyzer::MessageTrace::MessageTrace() : key(0), commandId(0), type(0), stages() {
+    for (int i = 0; i < TraceEvent::STAGE_COUNT; ++i) {
+        this->stages[i] = -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TraceAnalyzer::MessageTrace::getStageCount() const {
+
+    int count = 0;
+    for (int i = 0; i < TraceEvent::STAGE_COUNT; ++i) {
+        if (this->stages[i] >= 0) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TraceAnalyzer::MessageTrace::getLatency(int from, int to) const {
+
+    if (from < 0 || from >= TraceEvent::STAGE_COUNT || to < 0 || to >= TraceEvent::STAGE_COUNT) {
+        return -1;
+    }
+
+    if (this->stages[from] < 0 || this->stages[to] < 0) {
+        return -1;
+    }
+
+    return this->stages[to] - this->stages[from];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TraceAnalyzer::MessageTrace::getTotalLatency() const {
+
+    long long first = -1;
+    long long last = -1;
+
+    for (int i = 0; i < TraceEvent::STAGE_COUNT; ++i) {
+        if (this->stages[i] < 0) {
+            continue;
+        }
+        if (first < 0 || this->stages[i] < first) {
+            first = this->stages[i];
+        }
+        if (this->stages[i] > last) {
+            last = this->stages[i];
+        }
+    }
+
+    return first < 0 ? 0 : last - first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string TraceAnalyzer::MessageTrace::toString() const {
+
+    std::ostringstream stream;
+
+    stream << "key=" << std::hex << this->key << std::dec
+           << " commandId=" << this->commandId
+           << " type=" << (int) this->type;
+
+    int previous = -1;
+    for (int i = 0; i < TraceEvent::STAGE_COUNT; ++i) {
+        if (this->stages[i] < 0) {
+            continue;
+        }
+        stream << " " << TraceEvent::getStageName(i) << "=";
+        stream << (previous < 0 ? 0 : this->stages[i] - this->stages[previous]);
+        previous = i;
+    }
+
+    stream << " total=" << getTotalLatency();
+
+    return stream.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceAnalyzer::TraceAnalyzer() : messages(), latencies() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceAnalyzer::~TraceAnalyzer() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceAnalyzer::analyze(const std::vector<TraceEvent>& events) {
+
+    std::vector<TraceEvent> sorted(events);
+    std::stable_sort(sorted.begin(), sorted.end(), compareTimestamps);
+
+    std::vector<MessageTrace> traces;
+    std::map<long long, std::size_t> current;
+
+    std::vector<TraceEvent>::const_iterator event = sorted.begin();
+    for (; event != sorted.end(); ++event) {
+
+        if (event->stage < TraceEvent::UNMARSHAL_DONE || event->stage >= TraceEvent::STAGE_COUNT) {
+            continue;
+        }
+
+        std::map<long long, std::size_t>::iterator found = current.find(event->key);
+        if (found == current.end() || traces[found->second].stages[event->stage] >= 0) {
+            MessageTrace trace;
+            trace.key = event->key;
+            trace.commandId = event->commandId;
+            trace.type = event->type;
+            traces.push_back(trace);
+            current[event->key] = traces.size() - 1;
+        }
+
+        traces[current[event->key]].stages[event->stage] = event->timestamp;
+    }
+
+    std::vector<MessageTrace>::const_iterator trace = traces.begin();
+    for (; trace != traces.end(); ++trace) {
+
+        if (trace->getStageCount() < 2) {
+            continue;
+        }
+
+        int previous = -1;
+        for (int i = 0; i < TraceEvent::STAGE_COUNT; ++i) {
+            if (trace->stages[i] < 0) {
+                continue;
+            }
+            if (previous >= 0) {
+                std::string name = TraceEvent::getStageName(previous) + "->" + TraceEvent::getStageName(i);
+                this->latencies.getHistogram(name)->record(trace->getLatency(previous, i));
+            }
+            previous = i;
+        }
+
+        this->latencies.getHistogram("total")->record(trace->getTotalLatency());
+        this->messages.push_back(*trace);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MetricsSnapshot TraceAnalyzer::getSummary() const {
+    return this->latencies.getSnapshot();
+}
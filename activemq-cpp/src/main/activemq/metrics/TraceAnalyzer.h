@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_TRACEANALYZER_H_
+#define _ACTIVEMQ_METRICS_TRACEANALYZER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/MetricsRegistry.h>
+#include <activemq/metrics/MetricsSnapshot.h>
+#include <activemq/metrics/TraceEvent.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * Rebuilds the path of each message from a set of TraceEvents collected by
+     * the Tracer and works out how long messages spent between each pair of
+     * adjacent stages.  Stage latencies are summarized in histograms named after
+     * the two stages, for example "unmarshal->connection.dispatch", along with a
+     * "total" histogram covering the first to the last stage seen.
+     */
+    class AMQCPP_API TraceAnalyzer {
+    public:
+
+        /**
+         * The time at which a single message reached each of the traced stages.
+         */
+        class AMQCPP_API MessageTrace {
+        public:
+
+            long long key;
+            int commandId;
+            unsigned char type;
+            long long stages[TraceEvent::STAGE_COUNT];
+
+        public:
+
+            MessageTrace();
+
+            /**
+             * @return the number of stages the message was seen at.
+             */
+            int getStageCount() const;
+
+            /**
+             * @return the nanoseconds between the two stages or -1 if either was not seen.
+             */
+            long long getLatency(int from, int to) const;
+
+            /**
+             * @return the nanoseconds between the first and last stage seen.
+             */
+            long long getTotalLatency() const;
+
+            /**
+             * @return a single line listing the time taken to reach each stage.
+             */
+            std::string toString() const;
+
+        };
+
+    private:
+
+        std::vector<MessageTrace> messages;
+        MetricsRegistry latencies;
+
+    private:
+
+        TraceAnalyzer(const TraceAnalyzer&);
+        TraceAnalyzer& operator=(const TraceAnalyzer&);
+
+    public:
+
+        TraceAnalyzer();
+
+        virtual ~TraceAnalyzer();
+
+        /**
+         * Adds the given events to the analysis, events need not be sorted.  A
+         * message seen twice at the same stage, as happens on redelivery, is
+         * counted as two messages.
+         *
+         * @param events
+         *      The events to analyze.
+         */
+        void analyze(const std::vector<TraceEvent>& events);
+
+        /**
+         * @return the messages rebuilt so far that passed at least two stages.
+         */
+        const std::vector<MessageTrace>& getMessages() const {
+            return this->messages;
+        }
+
+        /**
+         * @return the stage latency histograms of all the messages analyzed.
+         */
+        MetricsSnapshot getSummary() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_TRACEANALYZER_H_ */
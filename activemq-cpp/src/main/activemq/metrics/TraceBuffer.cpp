@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TraceBuffer.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+TraceBuffer::TraceBuffer(int capacity, unsigned short thread) :
+    events(NULL), capacity(1), mask(0), thread(thread), head(0), floor(0), owned(0) {
+
+    while (this->capacity < capacity) {
+        this->capacity <<= 1;
+    }
+
+    this->mask = this->capacity - 1;
+    this->events = new TraceEvent[this->capacity];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceBuffer::~TraceBuffer() {
+    delete [] this->events;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceBuffer::record(long long timestamp, long long key, int commandId,
+                         unsigned char type, unsigned char stage) {
+
+    long long position = this->head;
+
+    TraceEvent& event = this->events[position & this->mask];
+    event.timestamp = timestamp;
+    event.key = key;
+    event.commandId = commandId;
+    event.type = type;
+    event.stage = stage;
+    event.thread = this->thread;
+
+    // Publishing through an atomic add orders the stores above before the new
+    // head becomes visible to a reader.
+    Atomics::getAndAdd64(&this->head, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceBuffer::copyTo(std::vector<TraceEvent>& result) const {
+
+    long long end = getRecordedCount();
+    long long start = end - this->capacity;
+    if (start < this->floor) {
+        start = this->floor;
+    }
+    if (start < 0) {
+        start = 0;
+    }
+
+    std::size_t first = result.size();
+    for (long long i = start; i < end; ++i) {
+        result.push_back(this->events[i & this->mask]);
+    }
+
+    // Anything the writer moved over while we were copying is suspect, the slot
+    // of the event currently being written counts as moved over as well.
+    long long oldestSafe = getRecordedCount() - this->capacity + 1;
+    if (oldestSafe > start) {
+        long long skip = oldestSafe - start;
+        if (skip > end - start) {
+            skip = end - start;
+        }
+        result.erase(result.begin() + first, result.begin() + first + (std::size_t) skip);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceBuffer::clear() {
+    this->floor = getRecordedCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TraceBuffer::getRecordedCount() const {
+    return Atomics::getAndAdd64(const_cast<volatile long long*>(&this->head), 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TraceBuffer::acquire() {
+    return Atomics::compareAndSet32(&this->owned, 0, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceBuffer::release() {
+    Atomics::getAndSet(&this->owned, 0);
+}
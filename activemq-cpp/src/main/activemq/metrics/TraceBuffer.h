@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_TRACEBUFFER_H_
+#define _ACTIVEMQ_METRICS_TRACEBUFFER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/TraceEvent.h>
+
+#include <vector>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * A fixed size ring of TraceEvents with a single writer.  The writer never
+     * waits, once the ring is full the oldest events are overwritten.  Readers
+     * may copy the contents at any time, events that the writer could have been
+     * overwriting during the copy are left out of the result.
+     */
+    class AMQCPP_API TraceBuffer {
+    private:
+
+        TraceEvent* events;
+        int capacity;
+        long long mask;
+        unsigned short thread;
+
+        volatile long long head;
+        long long floor;
+        volatile int owned;
+
+    private:
+
+        TraceBuffer(const TraceBuffer&);
+        TraceBuffer& operator=(const TraceBuffer&);
+
+    public:
+
+        /**
+         * Creates a new buffer.
+         *
+         * @param capacity
+         *      The number of events held, rounded up to a power of two.
+         * @param thread
+         *      The value stored in the thread field of each event written.
+         */
+        TraceBuffer(int capacity, unsigned short thread);
+
+        virtual ~TraceBuffer();
+
+        /**
+         * Appends an event, must only be called by the thread that owns the buffer.
+         */
+        void record(long long timestamp, long long key, int commandId,
+                    unsigned char type, unsigned char stage);
+
+        /**
+         * Appends a copy of the events currently held, oldest first, to the given
+         * vector.
+         *
+         * @param result
+         *      The vector the events are added to.
+         */
+        void copyTo(std::vector<TraceEvent>& result) const;
+
+        /**
+         * Drops the events currently held, later calls to copyTo only return
+         * events recorded after this call.
+         */
+        void clear();
+
+        /**
+         * @return the number of events this buffer can hold.
+         */
+        int getCapacity() const {
+            return this->capacity;
+        }
+
+        /**
+         * @return the total number of events that have been written to the buffer.
+         */
+        long long getRecordedCount() const;
+
+        /**
+         * Claims the buffer for the calling thread.
+         *
+         * @return true if the buffer was not owned by another thread.
+         */
+        bool acquire();
+
+        /**
+         * Gives up ownership so that another thread can acquire the buffer.
+         */
+        void release();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_TRACEBUFFER_H_ */
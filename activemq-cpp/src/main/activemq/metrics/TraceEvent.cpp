@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TraceEvent.h"
+
+using namespace activemq;
+using namespace activemq::metrics;
+
+////////////////////////////////////////////////////////////////////////////////
+TraceEvent::TraceEvent() : timestamp(0), key(0), commandId(0), type(0), stage(0), thread(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceEvent::TraceEvent(long long timestamp, long long key, int commandId,
+                       unsigned char type, unsigned char stage, unsigned short thread) :
+    timestamp(timestamp), key(key), commandId(commandId), type(type), stage(stage), thread(thread) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string TraceEvent::getStageName(int stage) {
+
+    switch (stage) {
+        case UNMARSHAL_DONE:
+            return "unmarshal";
+        case CONNECTION_DISPATCH:
+            return "connection.dispatch";
+        case SESSION_DEQUEUE:
+            return "session.dequeue";
+        case LISTENER_START:
+            return "listener.start";
+        case LISTENER_END:
+            return "listener.end";
+        case ACK_SENT:
+            return "ack.sent";
+        default:
+            return "unknown";
+    }
+}
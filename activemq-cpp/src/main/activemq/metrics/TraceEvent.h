@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_TRACEEVENT_H_
+#define _ACTIVEMQ_METRICS_TRACEEVENT_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+
+namespace activemq {
+namespace metrics {
+
+    /**
+     * One fixed size record written by the Tracer each time a command passes a
+     * point of interest in the client.  Events carry no strings so they can be
+     * written into a ring buffer with a handful of stores.
+     *
+     * The key identifies the message the event belongs to, it is taken from the
+     * MessageId of dispatched messages and from the last acknowledged MessageId
+     * of acks so that all of a message's events share it, other commands use
+     * their command id.
+     */
+    class AMQCPP_API TraceEvent {
+    public:
+
+        enum Stage {
+            UNMARSHAL_DONE = 1,
+            CONNECTION_DISPATCH = 2,
+            SESSION_DEQUEUE = 3,
+            LISTENER_START = 4,
+            LISTENER_END = 5,
+            ACK_SENT = 6
+        };
+
+        /**
+         * One more than the highest stage value, stages can index arrays of this size.
+         */
+        static const int STAGE_COUNT = 7;
+
+    public:
+
+        long long timestamp;
+        long long key;
+        int commandId;
+        unsigned char type;
+        unsigned char stage;
+        unsigned short thread;
+
+    public:
+
+        TraceEvent();
+
+        TraceEvent(long long timestamp, long long key, int commandId,
+                   unsigned char type, unsigned char stage, unsigned short thread);
+
+        /**
+         * @return a printable name for the given stage value.
+         */
+        static std::string getStageName(int stage);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_TRACEEVENT_H_ */
@@ -0,0 +1,373 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tracer.h"
+
+#include <activemq/metrics/TraceBuffer.h>
+#include <activemq/commands/Command.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/internal/util/concurrent/ThreadLocalImpl.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::metrics;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+TracerKernel* Tracer::kernel = NULL;
+volatile bool Tracer::enabled = false;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace metrics {
+
+    /**
+     * Hands each thread its own TraceBuffer.  Buffers are never freed while the
+     * library is running, when a thread terminates its buffer is kept, events and
+     * all, and given to the next thread that starts recording.  Terminating
+     * threads release their buffer without locking since they run this from the
+     * thread exit cleanup.
+     */
+    class TracerKernel : public ThreadLocalImpl {
+    public:
+
+        Mutex mutex;
+        std::vector<TraceBuffer*> buffers;
+        int bufferSize;
+
+    private:
+
+        TracerKernel(const TracerKernel&);
+        TracerKernel& operator=(const TracerKernel&);
+
+    public:
+
+        TracerKernel() : ThreadLocalImpl(), mutex(), buffers(), bufferSize(Tracer::DEFAULT_BUFFER_SIZE) {
+        }
+
+        virtual ~TracerKernel() {
+            try {
+                removeAll();
+
+                std::vector<TraceBuffer*>::iterator iter = this->buffers.begin();
+                for (; iter != this->buffers.end(); ++iter) {
+                    delete *iter;
+                }
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        TraceBuffer* getBuffer() {
+
+            TraceBuffer* buffer = static_cast<TraceBuffer*>(getRawValue());
+            if (buffer != NULL) {
+                return buffer;
+            }
+
+            synchronized(&this->mutex) {
+                std::vector<TraceBuffer*>::iterator iter = this->buffers.begin();
+                for (; iter != this->buffers.end() && buffer == NULL; ++iter) {
+                    if ((*iter)->acquire()) {
+                        buffer = *iter;
+                    }
+                }
+
+                if (buffer == NULL) {
+                    buffer = new TraceBuffer(this->bufferSize, (unsigned short) this->buffers.size());
+                    buffer->acquire();
+                    this->buffers.push_back(buffer);
+                }
+            }
+
+            setRawValue(buffer);
+            return buffer;
+        }
+
+        virtual void doDelete(void* value) {
+            static_cast<TraceBuffer*>(value)->release();
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int TRACE_MAGIC = 0x414D5154;
+    const int TRACE_VERSION = 1;
+
+    const unsigned long long FNV_OFFSET = 14695981039346656037ULL;
+    const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+    unsigned long long mix(unsigned long long hash, long long value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (unsigned long long) ((value >> (i * 8)) & 0xFF);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    unsigned long long mix(unsigned long long hash, const std::string& value) {
+        for (std::string::size_type i = 0; i < value.size(); ++i) {
+            hash ^= (unsigned char) value[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    long long keyOf(const MessageId* id) {
+
+        unsigned long long hash = FNV_OFFSET;
+
+        if (!id->getTextView().empty()) {
+            return (long long) mix(hash, id->getTextView());
+        }
+
+        const ProducerId* producer = id->getProducerId().get();
+        if (producer != NULL) {
+            hash = mix(hash, producer->getConnectionId());
+            hash = mix(hash, producer->getSessionId());
+            hash = mix(hash, producer->getValue());
+        }
+
+        return (long long) mix(hash, id->getProducerSequenceId());
+    }
+
+    bool compareTimestamps(const TraceEvent& left, const TraceEvent& right) {
+        return left.timestamp < right.timestamp;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::initialize() {
+    Tracer::kernel = new TracerKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::shutdown() {
+    Tracer::enabled = false;
+    delete Tracer::kernel;
+    Tracer::kernel = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::setEnabled(bool value) {
+
+    if (Tracer::kernel == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    Tracer::enabled = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::setBufferSize(int size) {
+
+    if (Tracer::kernel == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    synchronized(&Tracer::kernel->mutex) {
+        Tracer::kernel->bufferSize = size;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::doRecord(TraceEvent::Stage stage, const Command* command) {
+
+    TracerKernel* current = Tracer::kernel;
+    if (current == NULL || command == NULL) {
+        return;
+    }
+
+    current->getBuffer()->record(System::nanoTime(), getKey(command), command->getCommandId(),
+                                 command->getDataStructureType(), (unsigned char) stage);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Tracer::getKey(const Command* command) {
+
+    const MessageId* id = NULL;
+
+    if (command->isMessageDispatch()) {
+        const Message* message = dynamic_cast<const MessageDispatch*>(command)->getMessage().get();
+        if (message != NULL) {
+            id = message->getMessageId().get();
+        }
+    } else if (command->isMessage()) {
+        id = dynamic_cast<const Message*>(command)->getMessageId().get();
+    } else if (command->isMessageAck()) {
+        id = dynamic_cast<const MessageAck*>(command)->getLastMessageId().get();
+    }
+
+    if (id != NULL) {
+        return keyOf(id);
+    }
+
+    return command->getCommandId();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<TraceEvent> Tracer::getEvents() {
+
+    std::vector<TraceEvent> events;
+
+    if (Tracer::kernel == NULL) {
+        return events;
+    }
+
+    synchronized(&Tracer::kernel->mutex) {
+        std::vector<TraceBuffer*>::const_iterator iter = Tracer::kernel->buffers.begin();
+        for (; iter != Tracer::kernel->buffers.end(); ++iter) {
+            (*iter)->copyTo(events);
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(), compareTimestamps);
+    return events;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::clear() {
+
+    if (Tracer::kernel == NULL) {
+        return;
+    }
+
+    synchronized(&Tracer::kernel->mutex) {
+        std::vector<TraceBuffer*>::const_iterator iter = Tracer::kernel->buffers.begin();
+        for (; iter != Tracer::kernel->buffers.end(); ++iter) {
+            (*iter)->clear();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::dump(const std::string& fileName) {
+
+    try {
+
+        ByteArrayOutputStream bytes;
+        writeEvents(getEvents(), &bytes);
+
+        std::pair<unsigned char*, int> contents = bytes.toByteArray();
+
+        std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write((const char*) contents.first, contents.second);
+        file.close();
+        delete [] contents.first;
+
+        if (file.fail()) {
+            throw IOException(__FILE__, __LINE__, "Could not write trace file: %s", fileName.c_str());
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::writeEvents(const std::vector<TraceEvent>& events, OutputStream* output) {
+
+    try {
+
+        DataOutputStream stream(output);
+
+        stream.writeInt(TRACE_MAGIC);
+        stream.writeInt(TRACE_VERSION);
+        stream.writeInt((int) events.size());
+
+        std::vector<TraceEvent>::const_iterator iter = events.begin();
+        for (; iter != events.end(); ++iter) {
+            stream.writeLong(iter->timestamp);
+            stream.writeLong(iter->key);
+            stream.writeInt(iter->commandId);
+            stream.writeByte(iter->type);
+            stream.writeByte(iter->stage);
+            stream.writeShort((short) iter->thread);
+        }
+
+        stream.flush();
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<TraceEvent> Tracer::readEvents(InputStream* input) {
+
+    try {
+
+        DataInputStream stream(input);
+
+        if (stream.readInt() != TRACE_MAGIC) {
+            throw IOException(__FILE__, __LINE__, "Input is not an ActiveMQ-CPP trace.");
+        }
+
+        int version = stream.readInt();
+        if (version != TRACE_VERSION) {
+            throw IOException(__FILE__, __LINE__, "Unsupported trace version: %d", version);
+        }
+
+        int count = stream.readInt();
+        if (count < 0) {
+            throw IOException(__FILE__, __LINE__, "Invalid trace event count: %d", count);
+        }
+
+        std::vector<TraceEvent> events;
+        events.reserve(count);
+
+        for (int i = 0; i < count; ++i) {
+            TraceEvent event;
+            event.timestamp = stream.readLong();
+            event.key = stream.readLong();
+            event.commandId = stream.readInt();
+            event.type = stream.readUnsignedByte();
+            event.stage = stream.readUnsignedByte();
+            event.thread = stream.readUnsignedShort();
+            events.push_back(event);
+        }
+
+        return events;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
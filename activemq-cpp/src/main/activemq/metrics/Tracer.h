@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_METRICS_TRACER_H_
+#define _ACTIVEMQ_METRICS_TRACER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/metrics/TraceEvent.h>
+
+#include <decaf/io/InputStream.h>
+#include <decaf/io/OutputStream.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace commands {
+    class Command;
+}
+namespace metrics {
+
+    class TracerKernel;
+
+    /**
+     * Records binary TraceEvents as commands move from the socket to a consumer's
+     * MessageListener so the time spent in each stage can be measured without the
+     * cost of logging.  Each thread writes into its own TraceBuffer, recording is
+     * lock free and allocation free once a thread has its buffer, and when tracing
+     * is disabled the cost is a single test of a flag.
+     *
+     * The events collected can be written out in a compact binary form and read
+     * back by the trace dump tool which uses a TraceAnalyzer to rebuild the
+     * per-message stage latencies.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API Tracer {
+    public:
+
+        static const int DEFAULT_BUFFER_SIZE = 8192;
+
+    private:
+
+        static TracerKernel* kernel;
+        static volatile bool enabled;
+
+    private:
+
+        Tracer();
+        Tracer(const Tracer&);
+        Tracer& operator=(const Tracer&);
+
+    public:
+
+        /**
+         * Records that the given command has reached a stage, does nothing when
+         * tracing is disabled.
+         *
+         * @param stage
+         *      The stage that was reached.
+         * @param command
+         *      The command being traced.
+         */
+        static void record(TraceEvent::Stage stage, const commands::Command* command) {
+            if (enabled) {
+                doRecord(stage, command);
+            }
+        }
+
+        /**
+         * @return true if events are currently being recorded.
+         */
+        static bool isEnabled() {
+            return enabled;
+        }
+
+        /**
+         * Turns recording on or off for all threads in the process.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static void setEnabled(bool value);
+
+        /**
+         * Sets the number of events held by the buffers of threads that begin
+         * recording after this call, older buffers keep their size.
+         *
+         * @param size
+         *      The number of events per thread, rounded up to a power of two.
+         */
+        static void setBufferSize(int size);
+
+        /**
+         * Collects the events currently held in the buffers of all threads.
+         *
+         * @return the events ordered by time.
+         */
+        static std::vector<TraceEvent> getEvents();
+
+        /**
+         * Discards the events currently held in the buffers of all threads.
+         */
+        static void clear();
+
+        /**
+         * Writes the events currently held by all threads to the named file.
+         *
+         * @param fileName
+         *      The file to create or replace.
+         *
+         * @throws IOException if the file cannot be written.
+         */
+        static void dump(const std::string& fileName);
+
+        /**
+         * Writes events to a stream in the binary trace format.
+         *
+         * @param events
+         *      The events to write.
+         * @param output
+         *      The stream to write to.
+         *
+         * @throws IOException if an error occurs while writing.
+         */
+        static void writeEvents(const std::vector<TraceEvent>& events, decaf::io::OutputStream* output);
+
+        /**
+         * Reads events written by writeEvents from a stream.
+         *
+         * @param input
+         *      The stream to read from.
+         *
+         * @return the events that were read.
+         *
+         * @throws IOException if the stream does not hold a valid trace.
+         */
+        static std::vector<TraceEvent> readEvents(decaf::io::InputStream* input);
+
+        /**
+         * Computes the key under which events for the given command are grouped,
+         * see TraceEvent.
+         */
+        static long long getKey(const commands::Command* command);
+
+    private:
+
+        static void doRecord(TraceEvent::Stage stage, const commands::Command* command);
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_METRICS_TRACER_H_ */
@@ -0,0 +1,241 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Expression.h"
+
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/util/PrimitiveValueNode.h>
+
+#include <cms/DeliveryMode.h>
+
+using namespace activemq;
+using namespace activemq::selector;
+using namespace activemq::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::string PERSISTENT = "PERSISTENT";
+    const std::string NON_PERSISTENT = "NON_PERSISTENT";
+
+    const std::string JMSX_DELIVERY_COUNT_NAME = "JMSXDeliveryCount";
+    const std::string JMSX_GROUP_ID_NAME = "JMSXGroupID";
+    const std::string JMSX_GROUP_SEQ_NAME = "JMSXGroupSeq";
+
+    struct HeaderName {
+        const char* name;
+        EvaluationContext::HeaderField field;
+    };
+
+    const HeaderName HEADER_NAMES[] = {
+        { "JMSCorrelationID", EvaluationContext::JMS_CORRELATION_ID },
+        { "JMSDeliveryMode", EvaluationContext::JMS_DELIVERY_MODE },
+        { "JMSExpiration", EvaluationContext::JMS_EXPIRATION },
+        { "JMSMessageID", EvaluationContext::JMS_MESSAGE_ID },
+        { "JMSPriority", EvaluationContext::JMS_PRIORITY },
+        { "JMSRedelivered", EvaluationContext::JMS_REDELIVERED },
+        { "JMSTimestamp", EvaluationContext::JMS_TIMESTAMP },
+        { "JMSType", EvaluationContext::JMS_TYPE },
+        { "JMSXDeliveryCount", EvaluationContext::JMSX_DELIVERY_COUNT },
+        { "JMSXGroupID", EvaluationContext::JMSX_GROUP_ID },
+        { "JMSXGroupSeq", EvaluationContext::JMSX_GROUP_SEQ }
+    };
+
+    const int NUM_HEADER_NAMES = sizeof(HEADER_NAMES) / sizeof(HeaderName);
+
+    Value stringOrNull(const std::string& value) {
+        return value.empty() ? Value() : Value::ofString(&value);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EvaluationContext::EvaluationContext(const cms::Message* message) :
+    message(message), amqMessage(dynamic_cast<const commands::Message*>(message)), scratch(), strings() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EvaluationContext::EvaluationContext(const commands::Message* message) :
+    message(NULL), amqMessage(message), scratch(), strings() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+EvaluationContext::~EvaluationContext() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool EvaluationContext::lookupHeaderField(const std::string& name, HeaderField& field) {
+
+    if (name.compare(0, 3, "JMS") != 0) {
+        return false;
+    }
+
+    for (int i = 0; i < NUM_HEADER_NAMES; ++i) {
+        if (name == HEADER_NAMES[i].name) {
+            field = HEADER_NAMES[i].field;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Value EvaluationContext::getHeader(HeaderField field) const {
+
+    std::string& storage = this->scratch[field];
+
+    if (this->amqMessage != NULL) {
+
+        switch (field) {
+            case JMS_CORRELATION_ID:
+                return stringOrNull(this->amqMessage->getCorrelationId());
+            case JMS_DELIVERY_MODE:
+                return Value::ofString(this->amqMessage->isPersistent() ? &PERSISTENT : &NON_PERSISTENT);
+            case JMS_EXPIRATION:
+                return Value::ofLong(this->amqMessage->getExpiration());
+            case JMS_MESSAGE_ID:
+                if (this->amqMessage->getMessageId() == NULL) {
+                    return Value();
+                }
+                storage = this->amqMessage->getMessageId()->toString();
+                return Value::ofString(&storage);
+            case JMS_PRIORITY:
+                return Value::ofLong(this->amqMessage->getPriority());
+            case JMS_REDELIVERED:
+                return Value::ofBoolean(this->amqMessage->getRedeliveryCounter() > 0);
+            case JMS_TIMESTAMP:
+                return Value::ofLong(this->amqMessage->getTimestamp());
+            case JMS_TYPE:
+                return stringOrNull(this->amqMessage->getType());
+            case JMSX_DELIVERY_COUNT:
+                return Value::ofLong(this->amqMessage->getRedeliveryCounter() + 1);
+            case JMSX_GROUP_ID:
+                return stringOrNull(this->amqMessage->getGroupID());
+            case JMSX_GROUP_SEQ:
+                return Value::ofLong(this->amqMessage->getGroupSequence());
+            default:
+                return Value();
+        }
+    }
+
+    switch (field) {
+        case JMS_CORRELATION_ID:
+            storage = this->message->getCMSCorrelationID();
+            return stringOrNull(storage);
+        case JMS_DELIVERY_MODE:
+            return Value::ofString(this->message->getCMSDeliveryMode() == cms::DeliveryMode::PERSISTENT ?
+                                   &PERSISTENT : &NON_PERSISTENT);
+        case JMS_EXPIRATION:
+            return Value::ofLong(this->message->getCMSExpiration());
+        case JMS_MESSAGE_ID:
+            storage = this->message->getCMSMessageID();
+            return stringOrNull(storage);
+        case JMS_PRIORITY:
+            return Value::ofLong(this->message->getCMSPriority());
+        case JMS_REDELIVERED:
+            return Value::ofBoolean(this->message->getCMSRedelivered());
+        case JMS_TIMESTAMP:
+            return Value::ofLong(this->message->getCMSTimestamp());
+        case JMS_TYPE:
+            storage = this->message->getCMSType();
+            return stringOrNull(storage);
+        case JMSX_DELIVERY_COUNT:
+            return getCMSProperty(JMSX_DELIVERY_COUNT_NAME);
+        case JMSX_GROUP_ID:
+            return getCMSProperty(JMSX_GROUP_ID_NAME);
+        case JMSX_GROUP_SEQ:
+            return getCMSProperty(JMSX_GROUP_SEQ_NAME);
+        default:
+            return Value();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Value EvaluationContext::getProperty(const std::string& name) const {
+
+    if (this->amqMessage == NULL) {
+        return getCMSProperty(name);
+    }
+
+    const PrimitiveMap& properties = this->amqMessage->getMessageProperties();
+    if (!properties.containsKey(name)) {
+        return Value();
+    }
+
+    const PrimitiveValueNode& node = properties.get(name);
+    switch (node.getType()) {
+        case PrimitiveValueNode::BOOLEAN_TYPE:
+            return Value::ofBoolean(node.getBool());
+        case PrimitiveValueNode::BYTE_TYPE:
+            return Value::ofLong(node.getByte());
+        case PrimitiveValueNode::SHORT_TYPE:
+            return Value::ofLong(node.getShort());
+        case PrimitiveValueNode::INTEGER_TYPE:
+            return Value::ofLong(node.getInt());
+        case PrimitiveValueNode::LONG_TYPE:
+            return Value::ofLong(node.getLong());
+        case PrimitiveValueNode::FLOAT_TYPE:
+            return Value::ofDouble(node.getFloat());
+        case PrimitiveValueNode::DOUBLE_TYPE:
+            return Value::ofDouble(node.getDouble());
+        case PrimitiveValueNode::STRING_TYPE:
+        case PrimitiveValueNode::BIG_STRING_TYPE:
+            // Point at the map's own copy instead of copying it out.
+            if (node.getValue().stringValue == NULL) {
+                return Value();
+            }
+            return Value::ofString(node.getValue().stringValue);
+        default:
+            return Value();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Value EvaluationContext::getCMSProperty(const std::string& name) const {
+
+    if (!this->message->propertyExists(name)) {
+        return Value();
+    }
+
+    switch (this->message->getPropertyValueType(name)) {
+        case cms::Message::BOOLEAN_TYPE:
+            return Value::ofBoolean(this->message->getBooleanProperty(name));
+        case cms::Message::BYTE_TYPE:
+            return Value::ofLong(this->message->getByteProperty(name));
+        case cms::Message::SHORT_TYPE:
+            return Value::ofLong(this->message->getShortProperty(name));
+        case cms::Message::INTEGER_TYPE:
+            return Value::ofLong(this->message->getIntProperty(name));
+        case cms::Message::LONG_TYPE:
+            return Value::ofLong(this->message->getLongProperty(name));
+        case cms::Message::FLOAT_TYPE:
+            return Value::ofDouble(this->message->getFloatProperty(name));
+        case cms::Message::DOUBLE_TYPE:
+            return Value::ofDouble(this->message->getDoubleProperty(name));
+        case cms::Message::STRING_TYPE:
+            this->strings.push_back(this->message->getStringProperty(name));
+            return Value::ofString(&this->strings.back());
+        default:
+            return Value();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Expression::~Expression() {
+}
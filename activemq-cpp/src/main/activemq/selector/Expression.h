@@ -0,0 +1,263 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_SELECTOR_EXPRESSION_H_
+#define _ACTIVEMQ_SELECTOR_EXPRESSION_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/Message.h>
+
+#include <list>
+#include <string>
+
+namespace activemq {
+namespace commands {
+    class Message;
+}
+namespace selector {
+
+    /**
+     * The result of evaluating part of a selector.  A Value is either NULL, which
+     * doubles as the UNKNOWN of the selector's three valued logic, or a boolean,
+     * an integral number, a floating point number or a string.
+     *
+     * String values don't own their characters, they point at the selector's
+     * literals, the message's properties or the EvaluationContext, all of which
+     * outlive a single evaluation.
+     */
+    class AMQCPP_API Value {
+    public:
+
+        enum Type {
+            NULL_VALUE,
+            BOOLEAN_VALUE,
+            LONG_VALUE,
+            DOUBLE_VALUE,
+            STRING_VALUE
+        };
+
+    private:
+
+        Type type;
+
+        union {
+            bool booleanValue;
+            long long longValue;
+            double doubleValue;
+            const std::string* stringValue;
+        } value;
+
+    public:
+
+        Value() : type(NULL_VALUE), value() {
+            this->value.longValue = 0;
+        }
+
+        static Value ofBoolean(bool value) {
+            Value result;
+            result.type = BOOLEAN_VALUE;
+            result.value.booleanValue = value;
+            return result;
+        }
+
+        static Value ofLong(long long value) {
+            Value result;
+            result.type = LONG_VALUE;
+            result.value.longValue = value;
+            return result;
+        }
+
+        static Value ofDouble(double value) {
+            Value result;
+            result.type = DOUBLE_VALUE;
+            result.value.doubleValue = value;
+            return result;
+        }
+
+        static Value ofString(const std::string* value) {
+            Value result;
+            result.type = STRING_VALUE;
+            result.value.stringValue = value;
+            return result;
+        }
+
+        Type getType() const {
+            return this->type;
+        }
+
+        bool isNull() const {
+            return this->type == NULL_VALUE;
+        }
+
+        bool isBoolean() const {
+            return this->type == BOOLEAN_VALUE;
+        }
+
+        bool isNumber() const {
+            return this->type == LONG_VALUE || this->type == DOUBLE_VALUE;
+        }
+
+        bool isString() const {
+            return this->type == STRING_VALUE;
+        }
+
+        /**
+         * @return true only if this is the boolean value TRUE, NULL and non boolean
+         *         values are never true.
+         */
+        bool isTrue() const {
+            return this->type == BOOLEAN_VALUE && this->value.booleanValue;
+        }
+
+        bool getBoolean() const {
+            return this->value.booleanValue;
+        }
+
+        long long getLong() const {
+            return this->value.longValue;
+        }
+
+        /**
+         * @return the numeric value as a double, valid for both number types.
+         */
+        double getDouble() const {
+            return this->type == LONG_VALUE ? (double) this->value.longValue : this->value.doubleValue;
+        }
+
+        const std::string& getString() const {
+            return *this->value.stringValue;
+        }
+
+    };
+
+    /**
+     * Gives a selector's expressions access to the Message being evaluated.  Header
+     * fields are read from the Message as they are referenced and properties are
+     * looked up in the Message's property map without being copied, the context is
+     * meant to live on the stack for the duration of one evaluation.
+     */
+    class AMQCPP_API EvaluationContext {
+    public:
+
+        /**
+         * The message header fields a selector can refer to by name.
+         */
+        enum HeaderField {
+            JMS_CORRELATION_ID,
+            JMS_DELIVERY_MODE,
+            JMS_EXPIRATION,
+            JMS_MESSAGE_ID,
+            JMS_PRIORITY,
+            JMS_REDELIVERED,
+            JMS_TIMESTAMP,
+            JMS_TYPE,
+            JMSX_DELIVERY_COUNT,
+            JMSX_GROUP_ID,
+            JMSX_GROUP_SEQ,
+            HEADER_FIELD_COUNT
+        };
+
+    private:
+
+        const cms::Message* message;
+        const commands::Message* amqMessage;
+
+        mutable std::string scratch[HEADER_FIELD_COUNT];
+        mutable std::list<std::string> strings;
+
+    private:
+
+        EvaluationContext(const EvaluationContext&);
+        EvaluationContext& operator=(const EvaluationContext&);
+
+    public:
+
+        /**
+         * Creates a context for any CMS Message, an ActiveMQ Message is read directly
+         * and any other provider's Message through the CMS property accessors.
+         */
+        EvaluationContext(const cms::Message* message);
+
+        /**
+         * Creates a context for a Message as it was received from the Broker.
+         */
+        EvaluationContext(const commands::Message* message);
+
+        ~EvaluationContext();
+
+        /**
+         * @return the value of the given header field in the Message being evaluated.
+         */
+        Value getHeader(HeaderField field) const;
+
+        /**
+         * @return the value of the named property, NULL if the Message doesn't have it
+         *         or it isn't of a type a selector can work with.
+         */
+        Value getProperty(const std::string& name) const;
+
+        /**
+         * Maps a selector identifier to the header field it names.
+         *
+         * @return true if the name is a header field, which is then stored in field.
+         */
+        static bool lookupHeaderField(const std::string& name, HeaderField& field);
+
+    private:
+
+        Value getCMSProperty(const std::string& name) const;
+
+    };
+
+    /**
+     * A node of a compiled selector.  Expressions are immutable once the parser has
+     * built them so one tree can be evaluated by any number of threads at once.
+     */
+    class AMQCPP_API Expression {
+    public:
+
+        virtual ~Expression();
+
+        /**
+         * Evaluates this expression against the Message held by the context.
+         *
+         * @param context
+         *      The context of the Message being evaluated.
+         *
+         * @return the result, NULL when it is unknown.
+         */
+        virtual Value evaluate(const EvaluationContext& context) const = 0;
+
+        /**
+         * @return true if this expression can yield a boolean and so may be used as
+         *         the operand of a logical operator or as a whole selector.
+         */
+        virtual bool isBooleanExpression() const = 0;
+
+        /**
+         * @return true if the evaluation of this expression is the boolean value TRUE.
+         */
+        bool matches(const EvaluationContext& context) const {
+            return evaluate(context).isTrue();
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_SELECTOR_EXPRESSION_H_ */
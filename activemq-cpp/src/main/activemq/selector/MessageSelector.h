@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_SELECTOR_MESSAGESELECTOR_H_
+#define _ACTIVEMQ_SELECTOR_MESSAGESELECTOR_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/selector/Expression.h>
+
+#include <cms/Message.h>
+
+#include <string>
+
+namespace activemq {
+namespace commands {
+    class Message;
+}
+namespace selector {
+
+    /**
+     * A compiled JMS message selector that can be evaluated in the client.  Instances
+     * are created by the SelectorParser and are immutable, a single MessageSelector
+     * can be shared by any number of consumers and threads.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API MessageSelector {
+    private:
+
+        std::string text;
+        Expression* expression;
+
+    private:
+
+        MessageSelector(const MessageSelector&);
+        MessageSelector& operator=(const MessageSelector&);
+
+    public:
+
+        /**
+         * Creates a new MessageSelector, taking ownership of the compiled expression.
+         *
+         * @param text
+         *      The selector as it was written.
+         * @param expression
+         *      The compiled selector, or NULL for an empty selector that matches
+         *      every Message.
+         */
+        MessageSelector(const std::string& text, Expression* expression);
+
+        virtual ~MessageSelector();
+
+        /**
+         * @return the selector as it was written.
+         */
+        const std::string& getText() const {
+            return this->text;
+        }
+
+        /**
+         * Tests a Message against this selector, a selector that evaluates to false
+         * or to unknown does not match.
+         *
+         * @param message
+         *      The Message to test.
+         *
+         * @return true if the Message is selected.
+         */
+        bool matches(const cms::Message* message) const;
+
+        /**
+         * Tests a Message as it was received from the Broker against this selector.
+         *
+         * @param message
+         *      The Message to test.
+         *
+         * @return true if the Message is selected.
+         */
+        bool matches(const commands::Message* message) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_SELECTOR_MESSAGESELECTOR_H_ */
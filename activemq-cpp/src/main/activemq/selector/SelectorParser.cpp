@@ -0,0 +1,1393 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SelectorParser.h"
+
+#include <cms/InvalidSelectorException.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/util/LRUCache.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::selector;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int SelectorParser::CACHE_SIZE = 100;
+
+SelectorCacheKernel* SelectorParser::kernel = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace selector {
+
+    class SelectorCacheKernel {
+    private:
+
+        SelectorCacheKernel(const SelectorCacheKernel&);
+        SelectorCacheKernel& operator=(const SelectorCacheKernel&);
+
+    public:
+
+        Mutex mutex;
+        LRUCache<std::string, Pointer<MessageSelector> > cache;
+
+        SelectorCacheKernel() : mutex(), cache(SelectorParser::CACHE_SIZE) {}
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Three valued logic helpers, a NULL Value is UNKNOWN.
+
+    Value logicalNot(const Value& value) {
+        if (!value.isBoolean()) {
+            return Value();
+        }
+        return Value::ofBoolean(!value.getBoolean());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    class ConstantExpression : public Expression {
+    private:
+
+        std::string text;
+        Value value;
+
+    private:
+
+        ConstantExpression(const ConstantExpression&);
+        ConstantExpression& operator=(const ConstantExpression&);
+
+    public:
+
+        ConstantExpression(const Value& value) : text(), value(value) {}
+
+        ConstantExpression(const std::string& text) : text(text), value() {
+            this->value = Value::ofString(&this->text);
+        }
+
+        virtual ~ConstantExpression() {}
+
+        const Value& getValue() const {
+            return this->value;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context DECAF_UNUSED) const {
+            return this->value;
+        }
+
+        virtual bool isBooleanExpression() const {
+            return this->value.isBoolean() || this->value.isNull();
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class PropertyExpression : public Expression {
+    private:
+
+        std::string name;
+
+    public:
+
+        PropertyExpression(const std::string& name) : name(name) {}
+
+        virtual ~PropertyExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            return context.getProperty(this->name);
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class HeaderExpression : public Expression {
+    private:
+
+        EvaluationContext::HeaderField field;
+
+    public:
+
+        HeaderExpression(EvaluationContext::HeaderField field) : field(field) {}
+
+        virtual ~HeaderExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            return context.getHeader(this->field);
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class BinaryExpression : public Expression {
+    private:
+
+        BinaryExpression(const BinaryExpression&);
+        BinaryExpression& operator=(const BinaryExpression&);
+
+    protected:
+
+        Expression* left;
+        Expression* right;
+
+    public:
+
+        BinaryExpression(Expression* left, Expression* right) : left(left), right(right) {}
+
+        virtual ~BinaryExpression() {
+            delete this->left;
+            delete this->right;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class AndExpression : public BinaryExpression {
+    public:
+
+        AndExpression(Expression* left, Expression* right) : BinaryExpression(left, right) {}
+
+        virtual ~AndExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value lvalue = this->left->evaluate(context);
+            if (lvalue.isBoolean() && !lvalue.getBoolean()) {
+                return lvalue;
+            }
+
+            Value rvalue = this->right->evaluate(context);
+            if (rvalue.isBoolean() && !rvalue.getBoolean()) {
+                return rvalue;
+            }
+
+            if (lvalue.isTrue() && rvalue.isTrue()) {
+                return lvalue;
+            }
+
+            return Value();
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class OrExpression : public BinaryExpression {
+    public:
+
+        OrExpression(Expression* left, Expression* right) : BinaryExpression(left, right) {}
+
+        virtual ~OrExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value lvalue = this->left->evaluate(context);
+            if (lvalue.isTrue()) {
+                return lvalue;
+            }
+
+            Value rvalue = this->right->evaluate(context);
+            if (rvalue.isTrue()) {
+                return rvalue;
+            }
+
+            if (lvalue.isBoolean() && rvalue.isBoolean()) {
+                return Value::ofBoolean(false);
+            }
+
+            return Value();
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class NotExpression : public Expression {
+    private:
+
+        Expression* operand;
+
+    private:
+
+        NotExpression(const NotExpression&);
+        NotExpression& operator=(const NotExpression&);
+
+    public:
+
+        NotExpression(Expression* operand) : operand(operand) {}
+
+        virtual ~NotExpression() {
+            delete this->operand;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            return logicalNot(this->operand->evaluate(context));
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    enum ComparisonOperator {
+        EQUAL,
+        NOT_EQUAL,
+        LESS_THAN,
+        LESS_THAN_OR_EQUAL,
+        GREATER_THAN,
+        GREATER_THAN_OR_EQUAL
+    };
+
+    /**
+     * Compares two values the way the Broker does, numbers of either type compare
+     * by value, strings and booleans only with their own kind.  Any NULL operand
+     * makes the result unknown, a comparison of values of different kinds is false.
+     */
+    Value compare(const Value& lvalue, const Value& rvalue, ComparisonOperator op) {
+
+        if (lvalue.isNull() || rvalue.isNull()) {
+            return Value();
+        }
+
+        int result = 0;
+
+        if (lvalue.isNumber() && rvalue.isNumber()) {
+            if (lvalue.getType() == Value::LONG_VALUE && rvalue.getType() == Value::LONG_VALUE) {
+                result = lvalue.getLong() < rvalue.getLong() ? -1 : (lvalue.getLong() > rvalue.getLong() ? 1 : 0);
+            } else {
+                double left = lvalue.getDouble();
+                double right = rvalue.getDouble();
+                if (left != left || right != right) {
+                    return Value::ofBoolean(op == NOT_EQUAL);
+                }
+                result = left < right ? -1 : (left > right ? 1 : 0);
+            }
+        } else if (lvalue.isString() && rvalue.isString()) {
+            result = lvalue.getString().compare(rvalue.getString());
+        } else if (lvalue.isBoolean() && rvalue.isBoolean()) {
+            if (op != EQUAL && op != NOT_EQUAL) {
+                return Value::ofBoolean(false);
+            }
+            result = lvalue.getBoolean() == rvalue.getBoolean() ? 0 : 1;
+        } else {
+            return Value::ofBoolean(op == NOT_EQUAL);
+        }
+
+        switch (op) {
+            case EQUAL:
+                return Value::ofBoolean(result == 0);
+            case NOT_EQUAL:
+                return Value::ofBoolean(result != 0);
+            case LESS_THAN:
+                return Value::ofBoolean(result < 0);
+            case LESS_THAN_OR_EQUAL:
+                return Value::ofBoolean(result <= 0);
+            case GREATER_THAN:
+                return Value::ofBoolean(result > 0);
+            default:
+                return Value::ofBoolean(result >= 0);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    class ComparisonExpression : public BinaryExpression {
+    private:
+
+        ComparisonOperator op;
+
+    public:
+
+        ComparisonExpression(ComparisonOperator op, Expression* left, Expression* right) :
+            BinaryExpression(left, right), op(op) {}
+
+        virtual ~ComparisonExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value lvalue = this->left->evaluate(context);
+            if (lvalue.isNull()) {
+                return lvalue;
+            }
+            return compare(lvalue, this->right->evaluate(context), this->op);
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class BetweenExpression : public Expression {
+    private:
+
+        Expression* value;
+        Expression* low;
+        Expression* high;
+
+    private:
+
+        BetweenExpression(const BetweenExpression&);
+        BetweenExpression& operator=(const BetweenExpression&);
+
+    public:
+
+        BetweenExpression(Expression* value, Expression* low, Expression* high) :
+            value(value), low(low), high(high) {}
+
+        virtual ~BetweenExpression() {
+            delete this->value;
+            delete this->low;
+            delete this->high;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value operand = this->value->evaluate(context);
+            if (operand.isNull()) {
+                return operand;
+            }
+
+            Value lower = compare(operand, this->low->evaluate(context), GREATER_THAN_OR_EQUAL);
+            if (lower.isBoolean() && !lower.getBoolean()) {
+                return lower;
+            }
+
+            Value upper = compare(operand, this->high->evaluate(context), LESS_THAN_OR_EQUAL);
+            if (upper.isBoolean() && !upper.getBoolean()) {
+                return upper;
+            }
+
+            return lower.isTrue() && upper.isTrue() ? lower : Value();
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class InExpression : public Expression {
+    private:
+
+        Expression* operand;
+        std::set<std::string> values;
+
+    private:
+
+        InExpression(const InExpression&);
+        InExpression& operator=(const InExpression&);
+
+    public:
+
+        InExpression(Expression* operand, const std::set<std::string>& values) :
+            operand(operand), values(values) {}
+
+        virtual ~InExpression() {
+            delete this->operand;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value value = this->operand->evaluate(context);
+            if (!value.isString()) {
+                return Value();
+            }
+
+            return Value::ofBoolean(this->values.find(value.getString()) != this->values.end());
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class IsNullExpression : public Expression {
+    private:
+
+        Expression* operand;
+
+    private:
+
+        IsNullExpression(const IsNullExpression&);
+        IsNullExpression& operator=(const IsNullExpression&);
+
+    public:
+
+        IsNullExpression(Expression* operand) : operand(operand) {}
+
+        virtual ~IsNullExpression() {
+            delete this->operand;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            return Value::ofBoolean(this->operand->evaluate(context).isNull());
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /**
+     * LIKE is matched without regular expressions.  The pattern is reduced once to
+     * an exact match, a prefix, a suffix or a substring search when it allows it,
+     * anything else uses a wildcard matcher that backtracks only to the last %.
+     */
+    class LikeExpression : public Expression {
+    private:
+
+        enum Kind {
+            EXACT,
+            PREFIX,
+            SUFFIX,
+            CONTAINS,
+            WILDCARD
+        };
+
+        // Each pattern element is a literal character, ANY_ONE for _ or ANY_MANY for %.
+        enum Wildcard {
+            ANY_ONE = -1,
+            ANY_MANY = -2
+        };
+
+        Expression* operand;
+        Kind kind;
+        std::string literal;
+        std::vector<int> pattern;
+
+    private:
+
+        LikeExpression(const LikeExpression&);
+        LikeExpression& operator=(const LikeExpression&);
+
+    public:
+
+        LikeExpression(Expression* operand, const std::vector<int>& pattern) :
+            operand(operand), kind(WILDCARD), literal(), pattern(pattern) {
+
+            int wildcards = 0;
+            int singles = 0;
+            for (std::size_t i = 0; i < pattern.size(); ++i) {
+                if (pattern[i] == ANY_MANY) {
+                    wildcards++;
+                } else if (pattern[i] == ANY_ONE) {
+                    singles++;
+                } else {
+                    literal += (char) pattern[i];
+                }
+            }
+
+            if (singles > 0) {
+                return;
+            }
+
+            bool leading = !pattern.empty() && pattern.front() == ANY_MANY;
+            bool trailing = pattern.size() > 1 && pattern.back() == ANY_MANY;
+
+            if (wildcards == 0) {
+                kind = EXACT;
+            } else if (wildcards == 1 && trailing) {
+                kind = PREFIX;
+            } else if (wildcards == 1 && leading) {
+                kind = SUFFIX;
+            } else if (wildcards == 2 && leading && trailing) {
+                kind = CONTAINS;
+            }
+        }
+
+        virtual ~LikeExpression() {
+            delete this->operand;
+        }
+
+        static std::vector<int> compilePattern(const std::string& pattern, int escape) {
+            std::vector<int> result;
+            for (std::size_t i = 0; i < pattern.size(); ++i) {
+                int ch = (unsigned char) pattern[i];
+                if (escape >= 0 && ch == escape) {
+                    if (++i == pattern.size()) {
+                        throw cms::InvalidSelectorException("LIKE pattern ends with its escape character");
+                    }
+                    result.push_back((unsigned char) pattern[i]);
+                } else if (ch == '%') {
+                    // Consecutive %'s match the same as one.
+                    if (result.empty() || result.back() != ANY_MANY) {
+                        result.push_back(ANY_MANY);
+                    }
+                } else if (ch == '_') {
+                    result.push_back(ANY_ONE);
+                } else {
+                    result.push_back(ch);
+                }
+            }
+            return result;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value value = this->operand->evaluate(context);
+            if (value.isNull()) {
+                return value;
+            } else if (!value.isString()) {
+                return Value::ofBoolean(false);
+            }
+
+            const std::string& text = value.getString();
+
+            switch (this->kind) {
+                case EXACT:
+                    return Value::ofBoolean(text == this->literal);
+                case PREFIX:
+                    return Value::ofBoolean(text.compare(0, literal.size(), literal) == 0);
+                case SUFFIX:
+                    return Value::ofBoolean(text.size() >= literal.size() &&
+                        text.compare(text.size() - literal.size(), literal.size(), literal) == 0);
+                case CONTAINS:
+                    return Value::ofBoolean(text.find(literal) != std::string::npos);
+                default:
+                    return Value::ofBoolean(wildcardMatch(text));
+            }
+        }
+
+        virtual bool isBooleanExpression() const {
+            return true;
+        }
+
+    private:
+
+        bool wildcardMatch(const std::string& text) const {
+
+            std::size_t t = 0;
+            std::size_t p = 0;
+            std::size_t starPattern = std::string::npos;
+            std::size_t starText = 0;
+
+            while (t < text.size()) {
+                if (p < pattern.size() && pattern[p] == ANY_MANY) {
+                    starPattern = p++;
+                    starText = t;
+                } else if (p < pattern.size() &&
+                           (pattern[p] == ANY_ONE || pattern[p] == (unsigned char) text[t])) {
+                    p++;
+                    t++;
+                } else if (starPattern != std::string::npos) {
+                    p = starPattern + 1;
+                    t = ++starText;
+                } else {
+                    return false;
+                }
+            }
+
+            while (p < pattern.size() && pattern[p] == ANY_MANY) {
+                p++;
+            }
+
+            return p == pattern.size();
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    enum ArithmeticOperator {
+        PLUS,
+        MINUS,
+        MULTIPLY,
+        DIVIDE,
+        MODULO
+    };
+
+    class ArithmeticExpression : public BinaryExpression {
+    private:
+
+        ArithmeticOperator op;
+
+    public:
+
+        ArithmeticExpression(ArithmeticOperator op, Expression* left, Expression* right) :
+            BinaryExpression(left, right), op(op) {}
+
+        virtual ~ArithmeticExpression() {}
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value lvalue = this->left->evaluate(context);
+            if (!lvalue.isNumber()) {
+                return Value();
+            }
+
+            Value rvalue = this->right->evaluate(context);
+            if (!rvalue.isNumber()) {
+                return Value();
+            }
+
+            if (lvalue.getType() == Value::LONG_VALUE && rvalue.getType() == Value::LONG_VALUE) {
+                long long left = lvalue.getLong();
+                long long right = rvalue.getLong();
+                switch (op) {
+                    case PLUS:
+                        return Value::ofLong(left + right);
+                    case MINUS:
+                        return Value::ofLong(left - right);
+                    case MULTIPLY:
+                        return Value::ofLong(left * right);
+                    case DIVIDE:
+                        return right == 0 ? Value() : Value::ofLong(left / right);
+                    default:
+                        return right == 0 ? Value() : Value::ofLong(left % right);
+                }
+            }
+
+            double left = lvalue.getDouble();
+            double right = rvalue.getDouble();
+            switch (op) {
+                case PLUS:
+                    return Value::ofDouble(left + right);
+                case MINUS:
+                    return Value::ofDouble(left - right);
+                case MULTIPLY:
+                    return Value::ofDouble(left * right);
+                case DIVIDE:
+                    return Value::ofDouble(left / right);
+                default:
+                    return Value::ofDouble(std::fmod(left, right));
+            }
+        }
+
+        virtual bool isBooleanExpression() const {
+            return false;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class NegateExpression : public Expression {
+    private:
+
+        Expression* operand;
+
+    private:
+
+        NegateExpression(const NegateExpression&);
+        NegateExpression& operator=(const NegateExpression&);
+
+    public:
+
+        NegateExpression(Expression* operand) : operand(operand) {}
+
+        virtual ~NegateExpression() {
+            delete this->operand;
+        }
+
+        virtual Value evaluate(const EvaluationContext& context) const {
+            Value value = this->operand->evaluate(context);
+            if (value.getType() == Value::LONG_VALUE) {
+                return Value::ofLong(-value.getLong());
+            } else if (value.getType() == Value::DOUBLE_VALUE) {
+                return Value::ofDouble(-value.getDouble());
+            }
+            return Value();
+        }
+
+        virtual bool isBooleanExpression() const {
+            return false;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    enum TokenType {
+        END,
+        LEFT_PAREN,
+        RIGHT_PAREN,
+        COMMA,
+        EQUALS,
+        NOT_EQUALS,
+        LESS,
+        LESS_EQUALS,
+        GREATER,
+        GREATER_EQUALS,
+        PLUS_SIGN,
+        MINUS_SIGN,
+        STAR,
+        SLASH,
+        PERCENT,
+        STRING_LITERAL,
+        LONG_LITERAL,
+        DOUBLE_LITERAL,
+        IDENTIFIER,
+        KEYWORD_AND,
+        KEYWORD_OR,
+        KEYWORD_NOT,
+        KEYWORD_BETWEEN,
+        KEYWORD_LIKE,
+        KEYWORD_ESCAPE,
+        KEYWORD_IN,
+        KEYWORD_IS,
+        KEYWORD_NULL,
+        KEYWORD_TRUE,
+        KEYWORD_FALSE
+    };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+        long long longValue;
+        double doubleValue;
+        int position;
+
+        Token() : type(END), text(), longValue(0), doubleValue(0), position(0) {}
+    };
+
+    struct Keyword {
+        const char* text;
+        TokenType type;
+    };
+
+    const Keyword KEYWORDS[] = {
+        { "AND", KEYWORD_AND },
+        { "OR", KEYWORD_OR },
+        { "NOT", KEYWORD_NOT },
+        { "BETWEEN", KEYWORD_BETWEEN },
+        { "LIKE", KEYWORD_LIKE },
+        { "ESCAPE", KEYWORD_ESCAPE },
+        { "IN", KEYWORD_IN },
+        { "IS", KEYWORD_IS },
+        { "NULL", KEYWORD_NULL },
+        { "TRUE", KEYWORD_TRUE },
+        { "FALSE", KEYWORD_FALSE }
+    };
+
+    const int NUM_KEYWORDS = sizeof(KEYWORDS) / sizeof(Keyword);
+
+    bool isIdentifierStart(char ch) {
+        return std::isalpha((unsigned char) ch) || ch == '_' || ch == '$';
+    }
+
+    bool isIdentifierPart(char ch) {
+        return std::isalnum((unsigned char) ch) || ch == '_' || ch == '$' || ch == '.';
+    }
+
+    bool equalsIgnoreCase(const std::string& text, const char* keyword) {
+        std::size_t i = 0;
+        for (; i < text.size() && keyword[i] != '\0'; ++i) {
+            if (std::toupper((unsigned char) text[i]) != keyword[i]) {
+                return false;
+            }
+        }
+        return i == text.size() && keyword[i] == '\0';
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    class Lexer {
+    private:
+
+        const std::string& input;
+        std::size_t position;
+
+    public:
+
+        Lexer(const std::string& input) : input(input), position(0) {}
+
+        static void error(const std::string& message, std::size_t position) {
+            throw cms::InvalidSelectorException(
+                message + " at position " + Integer::toString((int) position));
+        }
+
+        std::vector<Token> tokenize() {
+
+            std::vector<Token> tokens;
+
+            while (true) {
+                skipWhitespace();
+
+                Token token;
+                token.position = (int) position;
+
+                if (position >= input.size()) {
+                    tokens.push_back(token);
+                    return tokens;
+                }
+
+                char ch = input[position];
+
+                if (ch == '\'') {
+                    token.type = STRING_LITERAL;
+                    token.text = readQuoted('\'');
+                } else if (ch == '"') {
+                    token.type = IDENTIFIER;
+                    token.text = readQuoted('"');
+                } else if (std::isdigit((unsigned char) ch) ||
+                           (ch == '.' && position + 1 < input.size() &&
+                            std::isdigit((unsigned char) input[position + 1]))) {
+                    readNumber(token);
+                } else if (isIdentifierStart(ch)) {
+                    std::size_t start = position;
+                    while (position < input.size() && isIdentifierPart(input[position])) {
+                        position++;
+                    }
+                    token.type = IDENTIFIER;
+                    token.text = input.substr(start, position - start);
+                    for (int i = 0; i < NUM_KEYWORDS; ++i) {
+                        if (equalsIgnoreCase(token.text, KEYWORDS[i].text)) {
+                            token.type = KEYWORDS[i].type;
+                            break;
+                        }
+                    }
+                } else {
+                    readOperator(token);
+                }
+
+                tokens.push_back(token);
+            }
+        }
+
+    private:
+
+        void skipWhitespace() {
+            while (position < input.size() && std::isspace((unsigned char) input[position])) {
+                position++;
+            }
+        }
+
+        std::string readQuoted(char quote) {
+            std::size_t start = position++;
+            std::string result;
+            while (true) {
+                if (position >= input.size()) {
+                    error("Unterminated quoted text", start);
+                }
+                char ch = input[position++];
+                if (ch == quote) {
+                    // A doubled quote stands for the quote character itself.
+                    if (position < input.size() && input[position] == quote) {
+                        result += quote;
+                        position++;
+                    } else {
+                        return result;
+                    }
+                } else {
+                    result += ch;
+                }
+            }
+        }
+
+        void readNumber(Token& token) {
+
+            std::size_t start = position;
+
+            if (input[position] == '0' && position + 1 < input.size() &&
+                (input[position + 1] == 'x' || input[position + 1] == 'X')) {
+
+                position += 2;
+                std::size_t digits = position;
+                while (position < input.size() && std::isxdigit((unsigned char) input[position])) {
+                    position++;
+                }
+                if (position == digits || position - digits > 16) {
+                    error("Invalid hexadecimal literal", start);
+                }
+                token.type = LONG_LITERAL;
+                token.longValue = (long long) std::strtoull(input.substr(digits, position - digits).c_str(), NULL, 16);
+                skipLongSuffix();
+                checkNumberEnd(start);
+                return;
+            }
+
+            while (position < input.size() && std::isdigit((unsigned char) input[position])) {
+                position++;
+            }
+
+            bool floating = false;
+            if (position < input.size() && input[position] == '.') {
+                floating = true;
+                position++;
+                while (position < input.size() && std::isdigit((unsigned char) input[position])) {
+                    position++;
+                }
+            }
+
+            if (position < input.size() && (input[position] == 'e' || input[position] == 'E')) {
+                floating = true;
+                position++;
+                if (position < input.size() && (input[position] == '+' || input[position] == '-')) {
+                    position++;
+                }
+                std::size_t digits = position;
+                while (position < input.size() && std::isdigit((unsigned char) input[position])) {
+                    position++;
+                }
+                if (position == digits) {
+                    error("Invalid exponent in numeric literal", start);
+                }
+            }
+
+            std::string text = input.substr(start, position - start);
+
+            if (floating) {
+                token.type = DOUBLE_LITERAL;
+                token.doubleValue = std::strtod(text.c_str(), NULL);
+                if (position < input.size() && std::strchr("fFdD", input[position]) != NULL) {
+                    position++;
+                }
+            } else {
+                token.type = LONG_LITERAL;
+                int base = text.size() > 1 && text[0] == '0' ? 8 : 10;
+                if (base == 8 && text.find_first_of("89") != std::string::npos) {
+                    error("Invalid octal literal", start);
+                }
+
+                // Leave room for the magnitude of the most negative long.
+                unsigned long long value = std::strtoull(text.c_str(), NULL, base);
+                if (text.size() > 22 || value > 9223372036854775808ULL) {
+                    error("Numeric literal out of range", start);
+                }
+                token.longValue = (long long) value;
+                skipLongSuffix();
+            }
+
+            checkNumberEnd(start);
+        }
+
+        void skipLongSuffix() {
+            if (position < input.size() && (input[position] == 'l' || input[position] == 'L')) {
+                position++;
+            }
+        }
+
+        void checkNumberEnd(std::size_t start) {
+            if (position < input.size() && isIdentifierPart(input[position])) {
+                error("Invalid numeric literal", start);
+            }
+        }
+
+        void readOperator(Token& token) {
+
+            char ch = input[position];
+            char next = position + 1 < input.size() ? input[position + 1] : '\0';
+
+            position++;
+
+            switch (ch) {
+                case '(':
+                    token.type = LEFT_PAREN;
+                    return;
+                case ')':
+                    token.type = RIGHT_PAREN;
+                    return;
+                case ',':
+                    token.type = COMMA;
+                    return;
+                case '=':
+                    token.type = EQUALS;
+                    return;
+                case '+':
+                    token.type = PLUS_SIGN;
+                    return;
+                case '-':
+                    token.type = MINUS_SIGN;
+                    return;
+                case '*':
+                    token.type = STAR;
+                    return;
+                case '/':
+                    token.type = SLASH;
+                    return;
+                case '%':
+                    token.type = PERCENT;
+                    return;
+                case '<':
+                    if (next == '>') {
+                        position++;
+                        token.type = NOT_EQUALS;
+                    } else if (next == '=') {
+                        position++;
+                        token.type = LESS_EQUALS;
+                    } else {
+                        token.type = LESS;
+                    }
+                    return;
+                case '>':
+                    if (next == '=') {
+                        position++;
+                        token.type = GREATER_EQUALS;
+                    } else {
+                        token.type = GREATER;
+                    }
+                    return;
+                default:
+                    error(std::string("Unexpected character '") + ch + "'", position - 1);
+            }
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    class Parser {
+    private:
+
+        std::vector<Token> tokens;
+        std::size_t current;
+
+    public:
+
+        Parser(const std::string& selector) : tokens(Lexer(selector).tokenize()), current(0) {}
+
+        /**
+         * Parses the selector using the SQL 92 operator precedence, from lowest to
+         * highest: OR, AND, NOT, the comparison predicates, + and -, *, / and % and
+         * finally the unary sign.
+         */
+        Expression* parse() {
+
+            if (peek().type == IDENTIFIER && tokens[current + 1].type == STRING_LITERAL &&
+                (equalsIgnoreCase(peek().text, "XPATH") || equalsIgnoreCase(peek().text, "XQUERY"))) {
+
+                throw cms::InvalidSelectorException(
+                    "XPATH and XQUERY selectors can only be evaluated by the Broker");
+            }
+
+            int position = peek().position;
+            std::auto_ptr<Expression> expression(orExpression());
+            if (peek().type != END) {
+                unexpected();
+            }
+
+            return checkBoolean(expression, position);
+        }
+
+    private:
+
+        const Token& peek() const {
+            return tokens[current];
+        }
+
+        bool accept(TokenType type) {
+            if (tokens[current].type == type) {
+                current++;
+                return true;
+            }
+            return false;
+        }
+
+        const Token& expect(TokenType type, const char* what) {
+            if (tokens[current].type != type) {
+                Lexer::error(std::string("Expected ") + what, tokens[current].position);
+            }
+            return tokens[current++];
+        }
+
+        void unexpected() const {
+            if (peek().type == END) {
+                Lexer::error("Unexpected end of selector", peek().position);
+            }
+            Lexer::error("Unexpected token", peek().position);
+        }
+
+        Expression* checkBoolean(std::auto_ptr<Expression>& expression, int position) {
+            if (!expression->isBooleanExpression()) {
+                Lexer::error("Expected a boolean expression", position);
+            }
+            return expression.release();
+        }
+
+        Expression* orExpression() {
+            int position = peek().position;
+            std::auto_ptr<Expression> left(andExpression());
+            while (accept(KEYWORD_OR)) {
+                left.reset(checkBoolean(left, position));
+                int rightPosition = peek().position;
+                std::auto_ptr<Expression> right(andExpression());
+                left.reset(new OrExpression(left.release(), checkBoolean(right, rightPosition)));
+            }
+            return left.release();
+        }
+
+        Expression* andExpression() {
+            int position = peek().position;
+            std::auto_ptr<Expression> left(notExpression());
+            while (accept(KEYWORD_AND)) {
+                left.reset(checkBoolean(left, position));
+                int rightPosition = peek().position;
+                std::auto_ptr<Expression> right(notExpression());
+                left.reset(new AndExpression(left.release(), checkBoolean(right, rightPosition)));
+            }
+            return left.release();
+        }
+
+        Expression* notExpression() {
+            if (accept(KEYWORD_NOT)) {
+                int position = peek().position;
+                std::auto_ptr<Expression> operand(notExpression());
+                return new NotExpression(checkBoolean(operand, position));
+            }
+            return predicate();
+        }
+
+        Expression* predicate() {
+
+            std::auto_ptr<Expression> left(additiveExpression());
+
+            ComparisonOperator op;
+            switch (peek().type) {
+                case EQUALS:
+                    op = EQUAL;
+                    break;
+                case NOT_EQUALS:
+                    op = NOT_EQUAL;
+                    break;
+                case LESS:
+                    op = LESS_THAN;
+                    break;
+                case LESS_EQUALS:
+                    op = LESS_THAN_OR_EQUAL;
+                    break;
+                case GREATER:
+                    op = GREATER_THAN;
+                    break;
+                case GREATER_EQUALS:
+                    op = GREATER_THAN_OR_EQUAL;
+                    break;
+                case KEYWORD_IS:
+                    return isNullPredicate(left);
+                case KEYWORD_NOT:
+                case KEYWORD_BETWEEN:
+                case KEYWORD_LIKE:
+                case KEYWORD_IN:
+                    return negatablePredicate(left);
+                default:
+                    return left.release();
+            }
+
+            current++;
+            Expression* right = additiveExpression();
+
+            // <> is NOT of = so that comparing different types yields TRUE.
+            if (op == NOT_EQUAL) {
+                return new NotExpression(new ComparisonExpression(EQUAL, left.release(), right));
+            }
+            return new ComparisonExpression(op, left.release(), right);
+        }
+
+        Expression* isNullPredicate(std::auto_ptr<Expression>& operand) {
+            current++;
+            bool negated = accept(KEYWORD_NOT);
+            expect(KEYWORD_NULL, "NULL");
+
+            Expression* result = new IsNullExpression(operand.release());
+            return negated ? new NotExpression(result) : result;
+        }
+
+        Expression* negatablePredicate(std::auto_ptr<Expression>& operand) {
+
+            bool negated = accept(KEYWORD_NOT);
+            std::auto_ptr<Expression> result;
+
+            if (accept(KEYWORD_BETWEEN)) {
+                std::auto_ptr<Expression> low(additiveExpression());
+                expect(KEYWORD_AND, "AND");
+                Expression* high = additiveExpression();
+                result.reset(new BetweenExpression(operand.release(), low.release(), high));
+            } else if (accept(KEYWORD_LIKE)) {
+                std::string pattern = expect(STRING_LITERAL, "a LIKE pattern").text;
+                int escape = -1;
+                if (accept(KEYWORD_ESCAPE)) {
+                    const Token& token = expect(STRING_LITERAL, "an ESCAPE character");
+                    if (token.text.size() != 1) {
+                        Lexer::error("ESCAPE must be a single character", token.position);
+                    }
+                    escape = (unsigned char) token.text[0];
+                }
+                result.reset(new LikeExpression(operand.release(),
+                                                LikeExpression::compilePattern(pattern, escape)));
+            } else if (accept(KEYWORD_IN)) {
+                std::set<std::string> values;
+                expect(LEFT_PAREN, "(");
+                do {
+                    values.insert(expect(STRING_LITERAL, "a string literal").text);
+                } while (accept(COMMA));
+                expect(RIGHT_PAREN, ")");
+                result.reset(new InExpression(operand.release(), values));
+            } else {
+                Lexer::error("Expected BETWEEN, LIKE or IN", peek().position);
+            }
+
+            return negated ? new NotExpression(result.release()) : result.release();
+        }
+
+        Expression* additiveExpression() {
+            std::auto_ptr<Expression> left(multiplicativeExpression());
+            while (true) {
+                ArithmeticOperator op;
+                if (accept(PLUS_SIGN)) {
+                    op = PLUS;
+                } else if (accept(MINUS_SIGN)) {
+                    op = MINUS;
+                } else {
+                    return left.release();
+                }
+                Expression* right = multiplicativeExpression();
+                left.reset(new ArithmeticExpression(op, left.release(), right));
+            }
+        }
+
+        Expression* multiplicativeExpression() {
+            std::auto_ptr<Expression> left(unaryExpression());
+            while (true) {
+                ArithmeticOperator op;
+                if (accept(STAR)) {
+                    op = MULTIPLY;
+                } else if (accept(SLASH)) {
+                    op = DIVIDE;
+                } else if (accept(PERCENT)) {
+                    op = MODULO;
+                } else {
+                    return left.release();
+                }
+                Expression* right = unaryExpression();
+                left.reset(new ArithmeticExpression(op, left.release(), right));
+            }
+        }
+
+        Expression* unaryExpression() {
+            if (accept(PLUS_SIGN)) {
+                return unaryExpression();
+            } else if (accept(MINUS_SIGN)) {
+                // Negative literals fold here, which is also the only place the
+                // magnitude of the most negative long is accepted.
+                if (peek().type == LONG_LITERAL) {
+                    unsigned long long magnitude = (unsigned long long) tokens[current++].longValue;
+                    return new ConstantExpression(Value::ofLong((long long) (0ULL - magnitude)));
+                } else if (peek().type == DOUBLE_LITERAL) {
+                    return new ConstantExpression(Value::ofDouble(-tokens[current++].doubleValue));
+                }
+                return new NegateExpression(unaryExpression());
+            }
+            return primaryExpression();
+        }
+
+        Expression* primaryExpression() {
+
+            const Token& token = peek();
+
+            switch (token.type) {
+                case LEFT_PAREN: {
+                    current++;
+                    std::auto_ptr<Expression> expression(orExpression());
+                    expect(RIGHT_PAREN, ")");
+                    return expression.release();
+                }
+                case STRING_LITERAL:
+                    current++;
+                    return new ConstantExpression(token.text);
+                case LONG_LITERAL:
+                    if (token.longValue < 0) {
+                        Lexer::error("Numeric literal out of range", token.position);
+                    }
+                    current++;
+                    return new ConstantExpression(Value::ofLong(token.longValue));
+                case DOUBLE_LITERAL:
+                    current++;
+                    return new ConstantExpression(Value::ofDouble(token.doubleValue));
+                case KEYWORD_TRUE:
+                    current++;
+                    return new ConstantExpression(Value::ofBoolean(true));
+                case KEYWORD_FALSE:
+                    current++;
+                    return new ConstantExpression(Value::ofBoolean(false));
+                case KEYWORD_NULL:
+                    current++;
+                    return new ConstantExpression(Value());
+                case IDENTIFIER: {
+                    current++;
+                    EvaluationContext::HeaderField field;
+                    if (EvaluationContext::lookupHeaderField(token.text, field)) {
+                        return new HeaderExpression(field);
+                    }
+                    return new PropertyExpression(token.text);
+                }
+                default:
+                    unexpected();
+                    return NULL;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelector* SelectorParser::compile(const std::string& selector) {
+
+    std::size_t start = selector.find_first_not_of(" \t\r\n\f\v");
+    if (start == std::string::npos) {
+        return new MessageSelector(selector, NULL);
+    }
+
+    Parser parser(selector);
+    std::auto_ptr<Expression> expression(parser.parse());
+    return new MessageSelector(selector, expression.release());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageSelector> SelectorParser::parse(const std::string& selector) {
+
+    if (kernel == NULL) {
+        return Pointer<MessageSelector>(compile(selector));
+    }
+
+    synchronized(&kernel->mutex) {
+        if (kernel->cache.containsKey(selector)) {
+            return kernel->cache.get(selector);
+        }
+    }
+
+    // Compile outside the lock, two threads racing on the same text both
+    // produce an equivalent selector and the last one in is kept.
+    Pointer<MessageSelector> result(compile(selector));
+
+    synchronized(&kernel->mutex) {
+        kernel->cache.put(selector, result);
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParser::initialize() {
+    SelectorParser::kernel = new SelectorCacheKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParser::shutdown() {
+    delete SelectorParser::kernel;
+    SelectorParser::kernel = NULL;
+}
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_SELECTOR_SELECTORPARSER_H_
+#define _ACTIVEMQ_SELECTOR_SELECTORPARSER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/selector/MessageSelector.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace selector {
+
+    class SelectorCacheKernel;
+
+    /**
+     * Compiles JMS message selectors, the SQL 92 conditional expression subset the
+     * JMS specification defines, into a tree of Expressions that can be evaluated
+     * against a Message without the help of the Broker.
+     *
+     * The supported syntax is that of the ActiveMQ Broker's selectors: the logical
+     * operators NOT, AND and OR, the comparison operators =, <>, <, <=, > and >=,
+     * arithmetic with +, -, *, / and %, [NOT] BETWEEN, [NOT] IN, [NOT] LIKE with an
+     * optional ESCAPE, IS [NOT] NULL, string, numeric and boolean literals, message
+     * properties and the JMS header fields.  XPATH and XQUERY selectors can only be
+     * evaluated by the Broker and are rejected.
+     *
+     * Compiled selectors are kept in a bounded cache once the library has been
+     * initialized, so consumers that use the same selector share one instance.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API SelectorParser {
+    private:
+
+        static SelectorCacheKernel* kernel;
+
+    private:
+
+        SelectorParser();
+        SelectorParser(const SelectorParser&);
+        SelectorParser& operator=(const SelectorParser&);
+
+    public:
+
+        /**
+         * The number of compiled selectors the cache holds on to.
+         */
+        static const int CACHE_SIZE;
+
+        /**
+         * Returns the compiled form of the given selector, from the cache when it
+         * has been compiled before.
+         *
+         * @param selector
+         *      The selector text to compile.
+         *
+         * @return the shared compiled selector.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         */
+        static decaf::lang::Pointer<MessageSelector> parse(const std::string& selector);
+
+        /**
+         * Compiles the given selector without consulting the cache.
+         *
+         * @param selector
+         *      The selector text to compile.
+         *
+         * @return a new compiled selector which the caller owns.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         */
+        static MessageSelector* compile(const std::string& selector);
+
+    private:
+
+        static void initialize();
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_SELECTOR_SELECTORPARSER_H_ */
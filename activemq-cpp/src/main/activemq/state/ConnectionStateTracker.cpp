@@ -24,6 +24,8 @@
 #include <decaf/util/NoSuchElementException.h>
 #include <decaf/util/concurrent/ConcurrentStlMap.h>
 
+#include <vector>
+
 #include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/ExceptionResponse.h>
 #include <activemq/commands/RemoveInfo.h>
@@ -46,30 +48,111 @@ namespace activemq {
 namespace state {
 
 
-    class MessageCache : public LinkedHashMap<Pointer<MessageId>, Pointer<Command> > {
-    protected:
+    /**
+     * Holds the non-transacted Messages that would be replayed on reconnect in the
+     * order they were sent.  The entries live in a circular buffer that only grows
+     * until the byte limit is reached, after which tracking a Message costs a clone
+     * and a slot assignment instead of a hash map node and a MessageId hash.  The
+     * oldest Messages are dropped once the total size exceeds the parent's maximum
+     * message cache size.
+     */
+    class MessageCache {
+    private:
+
+        struct Entry {
+            Pointer<Message> message;
+            int size;
+
+            Entry() : message(), size(0) {}
+        };
 
         ConnectionStateTracker* parent;
+        std::vector<Entry> entries;
+        std::size_t head;
+        std::size_t count;
 
     public:
 
         int currentCacheSize;
 
+    private:
+
+        MessageCache(const MessageCache&);
+        MessageCache& operator= (const MessageCache&);
+
     public:
 
         MessageCache(ConnectionStateTracker* parent) :
-            LinkedHashMap<Pointer<MessageId>, Pointer<Command> >(), parent(parent), currentCacheSize(0) {
+            parent(parent), entries(), head(0), count(0), currentCacheSize(0) {
+        }
+
+        ~MessageCache() {}
+
+        void add(Pointer<Message> message) {
+
+            // A send that is retried after an IO error is tracked again, keep one copy.  The
+            // retry is tracked before any later send so only the newest entry is compared.
+            if (count > 0) {
+                Pointer<Message> newest = entries[index(count - 1)].message;
+                if (newest->getMessageId() != NULL && message->getMessageId() != NULL &&
+                    newest->getMessageId()->compareTo(*message->getMessageId()) == 0) {
+                    return;
+                }
+            }
+
+            if (count == entries.size()) {
+                grow();
+            }
+
+            Entry& entry = entries[index(count++)];
+            entry.message = message;
+            entry.size = (int) message->getSize();
+            currentCacheSize += entry.size;
+
+            // The newest message is always kept so that it is replayed however large it is.
+            while (count > 1 && currentCacheSize > parent->getMaxMessageCacheSize()) {
+                removeEldest();
+            }
+        }
+
+        std::size_t size() const {
+            return count;
+        }
+
+        Pointer<Message> get(std::size_t position) const {
+            return entries[index(position)].message;
+        }
+
+        void clear() {
+            while (count > 0) {
+                removeEldest();
+            }
+            head = 0;
+            currentCacheSize = 0;
+        }
+
+    private:
+
+        std::size_t index(std::size_t position) const {
+            return (head + position) % entries.size();
         }
 
-        virtual ~MessageCache() {}
+        void removeEldest() {
+            Entry& eldest = entries[head];
+            currentCacheSize -= eldest.size;
+            eldest.message.reset(NULL);
+            eldest.size = 0;
+            head = (head + 1) % entries.size();
+            count--;
+        }
 
-        virtual bool removeEldestEntry(const MapEntry<Pointer<MessageId>, Pointer<Command> >& eldest) {
-            bool result = currentCacheSize > parent->getMaxMessageCacheSize();
-            if (result) {
-                Pointer<Message> message = eldest.getValue().dynamicCast<Message>();
-                currentCacheSize -= message->getSize();
+        void grow() {
+            std::vector<Entry> larger(entries.empty() ? 16 : entries.size() * 2);
+            for (std::size_t i = 0; i < count; ++i) {
+                larger[i] = entries[index(i)];
             }
-            return result;
+            entries.swap(larger);
+            head = 0;
         }
     };
 
@@ -201,21 +284,8 @@ Pointer<Tracked> ConnectionStateTracker::track(Pointer<Command> command) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ConnectionStateTracker::trackBack(Pointer<Command> command) {
-
-    try {
-        if (command != NULL) {
-            if (trackMessages && command->isMessage()) {
-                Pointer<Message> message = command.dynamicCast<Message>();
-                if (message->getTransactionId() == NULL) {
-                    this->impl->messageCache.currentCacheSize += message->getSize();
-                }
-            }
-        }
-    }
-    AMQ_CATCH_RETHROW(ActiveMQException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
-    AMQ_CATCHALL_THROW(ActiveMQException)
+void ConnectionStateTracker::trackBack(Pointer<Command> command AMQCPP_UNUSED) {
+    // Message sizes are charged to the message cache when the Message is tracked.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -245,9 +315,8 @@ void ConnectionStateTracker::restore(Pointer<transport::Transport> transport) {
         }
 
         // Now we flush messages
-        Pointer<Iterator<Pointer<Command> > > messages(this->impl->messageCache.values().iterator());
-        while (messages->hasNext()) {
-            transport->oneway(messages->next());
+        for (std::size_t i = 0; i < this->impl->messageCache.size(); ++i) {
+            transport->oneway(this->impl->messageCache.get(i));
         }
 
         Pointer<Iterator<Pointer<Command> > > messagePullIter(this->impl->messagePullCache.values().iterator());
@@ -649,8 +718,7 @@ Pointer<Command> ConnectionStateTracker::processMessage(Message* message) {
                 }
                 return this->impl->TRACKED_RESPONSE_MARKER;
             } else if (trackMessages) {
-                this->impl->messageCache.put(
-                    message->getMessageId(), Pointer<Message>(message->cloneDataStructure()));
+                this->impl->messageCache.add(Pointer<Message>(message->cloneDataStructure()));
             }
         }
 
@@ -22,6 +22,7 @@
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/metrics/Tracer.h>
 #include <activemq/util/Config.h>
 #include <typeinfo>
 
@@ -269,6 +270,7 @@ void IOTransport::run() {
 
             // Read the next command from the input stream.
             Pointer<Command> command(impl->wireFormat->unmarshal(this, this->impl->inputStream));
+            metrics::Tracer::record(metrics::TraceEvent::UNMARSHAL_DONE, command.get());
 
             // Notify the listener.
             fire(command);
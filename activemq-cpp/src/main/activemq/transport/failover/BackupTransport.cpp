@@ -22,10 +22,11 @@
 using namespace activemq;
 using namespace activemq::transport;
 using namespace activemq::transport::failover;
+using namespace activemq::commands;
 
 ////////////////////////////////////////////////////////////////////////////////
 BackupTransport::BackupTransport(BackupTransportPool* parent) :
-    parent(parent), transport(), uri(), closed(true), priority(false) {
+    parent(parent), transport(), uri(), closed(true), priority(false), negotiated(false), wireFormatInfo() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -41,3 +42,12 @@ void BackupTransport::onException(const decaf::lang::Exception& ex AMQCPP_UNUSED
         this->parent->onBackupTransportFailure(this);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BackupTransport::onCommand(const Pointer<Command> command) {
+
+    if (command != NULL && command->isWireFormatInfo()) {
+        this->wireFormatInfo = command.dynamicCast<WireFormatInfo>();
+        this->negotiated = true;
+    }
+}
@@ -22,6 +22,7 @@
 
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/commands/WireFormatInfo.h>
 #include <decaf/net/URI.h>
 #include <decaf/lang/Pointer.h>
 #include <memory>
@@ -52,6 +53,12 @@ namespace failover {
         // Is this Transport one of the priority backups.
         bool priority;
 
+        // Indicates that the held transport has completed its wire format negotiation.
+        volatile bool negotiated;
+
+        // The WireFormatInfo the remote peer sent during negotiation.
+        Pointer<commands::WireFormatInfo> wireFormatInfo;
+
     private:
 
         BackupTransport(const BackupTransport&);
@@ -112,6 +119,46 @@ namespace failover {
          */
         virtual void onException(const decaf::lang::Exception& ex);
 
+        /**
+         * Event handler for commands received before this backup is put into use, the
+         * only command of interest is the remote peer's WireFormatInfo which marks the
+         * end of the wire format negotiation.
+         *
+         * @param command
+         *      The command that was received from the held transport.
+         */
+        virtual void onCommand(const Pointer<commands::Command> command);
+
+        /**
+         * Has the held transport finished its wire format negotiation, a backup that
+         * has can be switched to without waiting on the remote peer.
+         *
+         * @return true if the transport is ready for use.
+         */
+        bool isNegotiated() const {
+            return this->negotiated;
+        }
+
+        /**
+         * Sets the negotiated flag, used for transports that don't negotiate a wire format.
+         *
+         * @param value - true if no negotiation is outstanding.
+         */
+        void setNegotiated(bool value) {
+            this->negotiated = value;
+        }
+
+        /**
+         * Gets the WireFormatInfo the remote peer sent to this backup, since the listener
+         * of the backup isn't the one that will use the transport the new owner must be
+         * handed this command once it takes over.
+         *
+         * @return the remote WireFormatInfo or NULL if none was received.
+         */
+        Pointer<commands::WireFormatInfo> getWireFormatInfo() const {
+            return this->wireFormatInfo;
+        }
+
         /**
          * Has the Transport been shutdown and no longer usable.
          *
@@ -23,6 +23,7 @@
 #include <activemq/transport/TransportFactory.h>
 #include <activemq/transport/TransportRegistry.h>
 #include <activemq/transport/failover/FailoverTransport.h>
+#include <activemq/wireformat/WireFormatNegotiator.h>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
@@ -228,7 +229,26 @@ Pointer<BackupTransport> BackupTransportPool::getBackup() {
 
     synchronized(&this->impl->backups) {
         if (!this->impl->backups.isEmpty()) {
-            result = this->impl->backups.removeAt(0);
+
+            // Prefer a backup that has already finished its wire format negotiation so
+            // the switch doesn't wait on the broker, but never pass over a priority one.
+            int index = 0;
+            bool priority = this->impl->backups.getFirst()->isPriority();
+
+            std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
+            for (int i = 0; iter->hasNext(); ++i) {
+                Pointer<BackupTransport> backup = iter->next();
+                if (backup->isPriority() != priority) {
+                    break;
+                }
+
+                if (backup->isNegotiated()) {
+                    index = i;
+                    break;
+                }
+            }
+
+            result = this->impl->backups.removeAt(index);
         }
     }
 
@@ -289,6 +309,12 @@ bool BackupTransportPool::iterate() {
                 transport->start();
                 backup->setTransport(transport);
 
+                // Starting the transport kicks off the wire format negotiation, the backup
+                // completes it once the broker answers, with no negotiator there's no wait.
+                if (dynamic_cast<wireformat::WireFormatNegotiator*>(transport.get()) == NULL) {
+                    backup->setNegotiated(true);
+                }
+
                 if (priorityUriPool->contains(connectTo) || (priorityUriPool->isEmpty() && uriPool->isPriority(connectTo))) {
                     backup->setPriority(true);
 
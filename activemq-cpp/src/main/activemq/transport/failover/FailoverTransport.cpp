@@ -913,6 +913,7 @@ bool FailoverTransport::iterate() {
 
                 LinkedList<URI> failures;
                 Pointer<Transport> transport;
+                Pointer<WireFormatInfo> backupWireFormatInfo;
                 URI uri;
 
                 if (this->impl->backups->isEnabled()) {
@@ -920,6 +921,7 @@ bool FailoverTransport::iterate() {
                     if (backupTransport != NULL) {
                         transport = backupTransport->getTransport();
                         uri = backupTransport->getUri();
+                        backupWireFormatInfo = backupTransport->getWireFormatInfo();
                         if (this->impl->priorityBackup && this->impl->backups->isPriorityBackupAvailable()) {
                             // A priority connection is available and we aren't connected to
                             // any other priority transports so disconnect and use the backup.
@@ -957,6 +959,13 @@ bool FailoverTransport::iterate() {
                         transport->setTransportListener(this->impl->myTransportListener.get());
                         transport->start();
 
+                        // A backup has already negotiated its wire format, the broker's info
+                        // went to the backup so pass it along as if it had just arrived.
+                        if (backupWireFormatInfo != NULL) {
+                            this->impl->myTransportListener->onCommand(backupWireFormatInfo);
+                            backupWireFormatInfo.reset(NULL);
+                        }
+
                         if (this->impl->started && !this->impl->firstConnection) {
                             restoreTransport(transport);
                         }
@@ -1021,6 +1030,7 @@ bool FailoverTransport::iterate() {
                             transport.reset(NULL);
                         }
 
+                        backupWireFormatInfo.reset(NULL);
                         failures.add(uri);
                         failure.reset(e.clone());
                     }
@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DestinationCache.h"
+
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTempTopic.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int DestinationCache::DEFAULT_MAX_SIZE = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string makeKey(int type, const std::string& name) {
+        std::string key;
+        key.reserve(name.length() + 2);
+        key.push_back((char) ('0' + type));
+        key.push_back(':');
+        key.append(name);
+        return key;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DestinationCache::DestinationCache(int maxSize) : destinations(), maxSize(maxSize > 0 ? maxSize : 1), mutex() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DestinationCache::~DestinationCache() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQDestination> DestinationCache::lookup(int type, const std::string& name) {
+
+    std::string key = makeKey(type, name);
+
+    synchronized(&mutex) {
+        DestinationMap::const_iterator iter = this->destinations.find(key);
+        if (iter != this->destinations.end()) {
+            return iter->second;
+        }
+    }
+
+    ActiveMQDestination* destination = NULL;
+
+    switch (type) {
+        case cms::Destination::QUEUE:
+            destination = new ActiveMQQueue(name);
+            break;
+        case cms::Destination::TOPIC:
+            destination = new ActiveMQTopic(name);
+            break;
+        case cms::Destination::TEMPORARY_QUEUE:
+            destination = new ActiveMQTempQueue(name);
+            break;
+        case cms::Destination::TEMPORARY_TOPIC:
+            destination = new ActiveMQTempTopic(name);
+            break;
+        default:
+            throw IllegalArgumentException(
+                __FILE__, __LINE__, "Invalid destination type: %d", type);
+    }
+
+    return store(key, destination);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQDestination> DestinationCache::intern(const ActiveMQDestination* destination) {
+
+    if (destination == NULL) {
+        return Pointer<ActiveMQDestination>();
+    }
+
+    // The options aren't part of the name so two destinations that differ only in
+    // their options would share a key, those are just copied.  Temporary destinations
+    // are short lived and usually unique per requester so caching them only churns.
+    if (!destination->getOptions().isEmpty() || destination->isTemporary()) {
+        return Pointer<ActiveMQDestination>(destination->cloneDataStructure());
+    }
+
+    std::string key = makeKey(destination->getDestinationType(), destination->getPhysicalName());
+
+    synchronized(&mutex) {
+        DestinationMap::const_iterator iter = this->destinations.find(key);
+        if (iter != this->destinations.end()) {
+            return iter->second;
+        }
+    }
+
+    return store(key, destination->cloneDataStructure());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQDestination> DestinationCache::store(const std::string& key, ActiveMQDestination* destination) {
+
+    Pointer<ActiveMQDestination> created(destination);
+
+    // Composite destinations are split on first use, do it now while the instance
+    // is still private so that readers of the shared instance never write to it.
+    created->getCompositeDestinations();
+
+    synchronized(&mutex) {
+
+        // Another thread may have created it while the lock was released.
+        DestinationMap::const_iterator iter = this->destinations.find(key);
+        if (iter != this->destinations.end()) {
+            return iter->second;
+        }
+
+        if ((int) this->destinations.size() >= this->maxSize) {
+            this->destinations.clear();
+        }
+
+        this->destinations.insert(std::make_pair(key, created));
+    }
+
+    return created;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DestinationCache::size() const {
+
+    synchronized(&mutex) {
+        return (int) this->destinations.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCache::clear() {
+
+    synchronized(&mutex) {
+        this->destinations.clear();
+    }
+}
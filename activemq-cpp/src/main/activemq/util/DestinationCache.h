@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_DESTINATIONCACHE_H_
+#define _ACTIVEMQ_UTIL_DESTINATIONCACHE_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+
+namespace activemq {
+namespace util {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::ActiveMQDestination;
+
+    /**
+     * Interns ActiveMQDestination instances by type and name so that a name is parsed
+     * once and every later request for it shares the same instance.  The instances
+     * handed out are shared and must never be modified, callers that need to change
+     * a destination must clone it first.  Because each interned instance is unique
+     * two of them that came from the same cache can be compared by pointer.
+     *
+     * The cache holds at most a fixed number of destinations, once full it is emptied
+     * and starts over so that applications that use many one off names (reply to
+     * destinations for instance) don't grow it without limit.  Destinations already
+     * handed out remain valid.  This class is thread safe.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API DestinationCache {
+    public:
+
+        static const int DEFAULT_MAX_SIZE;
+
+    private:
+
+        typedef std::map<std::string, Pointer<ActiveMQDestination> > DestinationMap;
+
+        DestinationMap destinations;
+        int maxSize;
+        mutable decaf::util::concurrent::Mutex mutex;
+
+    private:
+
+        DestinationCache(const DestinationCache&);
+        DestinationCache& operator=(const DestinationCache&);
+
+    public:
+
+        /**
+         * Creates a new cache.
+         *
+         * @param maxSize
+         *      The number of destinations held before the cache starts over.
+         */
+        DestinationCache(int maxSize = DEFAULT_MAX_SIZE);
+
+        virtual ~DestinationCache();
+
+        /**
+         * Returns the shared destination of the given type with the given name, the
+         * name may carry an option query which is only parsed the first time.  The name
+         * is used as is, qualified prefixes like queue:// are not interpreted.
+         *
+         * @param type
+         *      The cms::Destination::DestinationType of the destination.
+         * @param name
+         *      The name, including any options, of the destination.
+         *
+         * @return the shared destination instance.
+         *
+         * @throws IllegalArgumentException if the type is not a valid destination type.
+         */
+        Pointer<ActiveMQDestination> lookup(int type, const std::string& name);
+
+        /**
+         * Returns the shared destination equal to the given one, adding a copy of it
+         * if there isn't one.  Destinations that carry options and temporary destinations
+         * are not interned, a copy is returned for those instead.
+         *
+         * @param destination
+         *      The destination to find the shared instance of.
+         *
+         * @return the shared destination instance, or NULL if destination is NULL.
+         */
+        Pointer<ActiveMQDestination> intern(const ActiveMQDestination* destination);
+
+        /**
+         * @return the number of destinations currently held.
+         */
+        int size() const;
+
+        /**
+         * @return the number of destinations held before the cache starts over.
+         */
+        int getMaxSize() const {
+            return this->maxSize;
+        }
+
+        /**
+         * Empties the cache, destinations already handed out remain valid.
+         */
+        void clear();
+
+    private:
+
+        Pointer<ActiveMQDestination> store(const std::string& key, ActiveMQDestination* destination);
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_UTIL_DESTINATIONCACHE_H_*/
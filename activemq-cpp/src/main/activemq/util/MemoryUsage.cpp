@@ -91,3 +91,37 @@ bool MemoryUsage::isFull() const {
 
     return result;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getUsage() const {
+    synchronized(&mutex) {
+        return this->usage;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setUsage(unsigned long long usage) {
+    synchronized(&mutex) {
+        this->usage = usage;
+        mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getLimit() const {
+    synchronized(&mutex) {
+        return this->limit;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setLimit(unsigned long long limit) {
+    synchronized(&mutex) {
+        this->limit = limit;
+        mutex.notifyAll();
+    }
+}
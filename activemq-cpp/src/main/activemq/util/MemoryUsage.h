@@ -95,33 +95,25 @@ namespace util {
          * Gets the current usage amount.
          * @return the amount of bytes currently used.
          */
-        unsigned long long getUsage() const {
-            return usage;
-        }
+        unsigned long long getUsage() const;
 
         /**
          * Sets the current usage amount
          * @param usage - The amount to tag as used.
          */
-        void setUsage(unsigned long long usage) {
-            this->usage = usage;
-        }
+        void setUsage(unsigned long long usage);
 
         /**
          * Gets the current limit amount.
          * @return the amount that can be used before full.
          */
-        unsigned long long getLimit() const {
-            return limit;
-        }
+        unsigned long long getLimit() const;
 
         /**
          * Sets the current limit amount
          * @param limit - The amount that can be used before full.
          */
-        void setLimit(unsigned long long limit) {
-            this->limit = limit;
-        }
+        void setLimit(unsigned long long limit);
 
     };
 
@@ -18,6 +18,7 @@
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
 
+#include <activemq/compression/CompressionCodecRegistry.h>
 #include <activemq/core/ActiveMQConnectionMetaData.h>
 
 #include <decaf/lang/Boolean.h>
@@ -30,6 +31,7 @@ using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::core;
 using namespace activemq::commands;
+using namespace activemq::compression;
 using namespace activemq::transport;
 using namespace activemq::exceptions;
 using namespace activemq::wireformat;
@@ -67,6 +69,14 @@ Pointer<WireFormat> OpenWireFormatFactory::createWireFormat(const decaf::util::P
         info->setMaxInactivityDurationInitalDelay(
             Long::parseLong(properties.getProperty("wireFormat.MaxInactivityDurationInitalDelay", "10000")));
 
+        // Advertise every registered body compression codec unless told otherwise.
+        std::vector<std::string> codecs = CompressionCodecRegistry::getInstance().getCodecNames();
+        std::string codecNames;
+        for (std::size_t i = 0; i < codecs.size(); ++i) {
+            codecNames += (i == 0 ? "" : ",") + codecs[i];
+        }
+        info->setCompressionCodecs(properties.getProperty("wireFormat.compressionCodecs", codecNames));
+
         info->getProperties().setString("ProviderName", meta.getCMSProviderName());
         info->getProperties().setString("ProviderVersion", meta.getProviderVersion());
         info->getProperties().setString("PlatformDetails", "C++");
@@ -74,7 +74,7 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setTimestamp(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setType(tightUnmarshalString(dataIn, bs));
-        info->setContent(tightUnmarshalByteArray(dataIn, bs));
+        std::vector<unsigned char>(tightUnmarshalByteArray(dataIn, bs)).swap(info->getContent());
         info->setMarshalledProperties(tightUnmarshalByteArray(dataIn, bs));
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
@@ -152,8 +152,8 @@ int MessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure*
         rc += tightMarshalNestedObject1(wireFormat, info->getReplyTo().get(), bs);
         rc += tightMarshalLong1(wireFormat, info->getTimestamp(), bs);
         rc += tightMarshalString1(info->getType(), bs);
-        bs->writeBoolean(info->getContent().size() != 0);
-        rc += info->getContent().size() == 0 ? 0 : (int)info->getContent().size() + 4;
+        bs->writeBoolean(info->getContentLength() != 0);
+        rc += info->getContentLength() == 0 ? 0 : info->getContentLength() + 4;
         bs->writeBoolean(info->getMarshalledProperties().size() != 0);
         rc += info->getMarshalledProperties().size() == 0 ? 0 : (int)info->getMarshalledProperties().size() + 4;
         rc += tightMarshalNestedObject1(wireFormat, info->getDataStructure().get(), bs);
@@ -214,8 +214,8 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
         tightMarshalLong2(wireFormat, info->getTimestamp(), dataOut, bs);
         tightMarshalString2(info->getType(), dataOut, bs);
         if (bs->readBoolean()) {
-            dataOut->writeInt((int)info->getContent().size() );
-            dataOut->write((const unsigned char*)(&info->getContent()[0]), (int)info->getContent().size(), 0, (int)info->getContent().size());
+            dataOut->writeInt(info->getContentLength() );
+            dataOut->write(info->getContentBytes(), info->getContentLength(), 0, info->getContentLength());
         }
         if (bs->readBoolean()) {
             dataOut->writeInt((int)info->getMarshalledProperties().size() );
@@ -283,7 +283,7 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setTimestamp(looseUnmarshalLong(wireFormat, dataIn));
         info->setType(looseUnmarshalString(dataIn));
-        info->setContent(looseUnmarshalByteArray(dataIn));
+        std::vector<unsigned char>(looseUnmarshalByteArray(dataIn)).swap(info->getContent());
         info->setMarshalledProperties(looseUnmarshalByteArray(dataIn));
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure*>(
             looseUnmarshalNestedObject(wireFormat, dataIn))));
@@ -362,10 +362,10 @@ void MessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure*
         looseMarshalNestedObject(wireFormat, info->getReplyTo().get(), dataOut);
         looseMarshalLong(wireFormat, info->getTimestamp(), dataOut);
         looseMarshalString(info->getType(), dataOut);
-        dataOut->write( info->getContent().size() != 0 );
-        if( info->getContent().size() != 0 ) {
-            dataOut->writeInt( (int)info->getContent().size() );
-            dataOut->write((const unsigned char*)(&info->getContent()[0]), (int)info->getContent().size(), 0, (int)info->getContent().size());
+        dataOut->write( info->getContentLength() != 0 );
+        if( info->getContentLength() != 0 ) {
+            dataOut->writeInt( info->getContentLength() );
+            dataOut->write(info->getContentBytes(), info->getContentLength(), 0, info->getContentLength());
         }
         dataOut->write( info->getMarshalledProperties().size() != 0 );
         if( info->getMarshalledProperties().size() != 0 ) {
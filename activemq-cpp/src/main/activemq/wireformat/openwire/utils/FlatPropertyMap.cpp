@@ -0,0 +1,806 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FlatPropertyMap.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/util/PrimitiveValueConverter.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Double.h>
+#include <decaf/lang/Float.h>
+#include <decaf/lang/Short.h>
+#include <decaf/util/NoSuchElementException.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int KEY_LENGTH_SIZE = 2;
+    const int COUNT_SIZE = 4;
+
+    // Compaction is skipped for small arenas where the copy costs more than
+    // the memory it would save.
+    const int MIN_COMPACT_SIZE = 1024;
+
+    bool isPlainAscii(const std::string& value) {
+        for (std::string::size_type i = 0; i < value.size(); ++i) {
+            unsigned char ch = (unsigned char) value[i];
+            if (ch == 0 || ch > 127) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Encodes the key exactly as DataOutputStream::writeUTF does, each byte of
+    // the string is taken to be a Latin-1 character.
+    std::string encodeKey(const std::string& key) {
+
+        std::string result;
+        result.reserve(key.size() * 2);
+
+        for (std::string::size_type i = 0; i < key.size(); ++i) {
+            unsigned int ch = (unsigned char) key[i];
+            if (ch > 0 && ch <= 127) {
+                result += (char) ch;
+            } else {
+                result += (char) (0xc0 | (0x1f & (ch >> 6)));
+                result += (char) (0x80 | (0x3f & ch));
+            }
+        }
+
+        if (result.size() > 65535) {
+            throw IOException(__FILE__, __LINE__, "Property name is too long to be marshaled.");
+        }
+
+        return result;
+    }
+
+    int compareKeys(const unsigned char* left, int leftLength, const unsigned char* right, int rightLength) {
+
+        int result = std::memcmp(left, right, (std::size_t) std::min(leftLength, rightLength));
+        if (result != 0) {
+            return result;
+        }
+
+        return leftLength - rightLength;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FlatPropertyMap::EntryOrder::operator()(const Entry& left, const Entry& right) const {
+    return compareKeys(arena + left.offset + KEY_LENGTH_SIZE, left.keyLength,
+                       arena + right.offset + KEY_LENGTH_SIZE, right.keyLength) < 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FlatPropertyMap::FlatPropertyMap() : arena(), entries(), garbage(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FlatPropertyMap::~FlatPropertyMap() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::clear() {
+    this->arena.clear();
+    this->entries.clear();
+    this->garbage = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::parse(const std::vector<unsigned char>& buffer) {
+
+    if (buffer.empty()) {
+        clear();
+        return;
+    }
+
+    parse(&buffer[0], (int) buffer.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::parse(const unsigned char* buffer, int size) {
+
+    try {
+
+        clear();
+
+        if (buffer == NULL || size <= 0) {
+            return;
+        }
+
+        if (size < COUNT_SIZE) {
+            throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+        }
+
+        this->arena.assign(buffer, buffer + size);
+
+        int count = readInt(0);
+        int position = COUNT_SIZE;
+
+        if (count > 0) {
+            this->entries.reserve((std::size_t) std::min(count, size));
+        }
+
+        for (int i = 0; i < count; ++i) {
+
+            if (position + KEY_LENGTH_SIZE > size) {
+                throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+            }
+
+            Entry entry;
+            entry.offset = position;
+            entry.keyLength = (this->arena[position] << 8) | this->arena[position + 1];
+
+            position += KEY_LENGTH_SIZE + entry.keyLength;
+            if (position >= size) {
+                throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+            }
+
+            entry.type = this->arena[position++];
+            entry.valueOffset = position;
+            position = skipValue(entry.type, position);
+            entry.end = position;
+
+            this->entries.push_back(entry);
+        }
+
+        // Later duplicates replace earlier ones, as they would in a PrimitiveMap.
+        std::stable_sort(this->entries.begin(), this->entries.end(), EntryOrder(&this->arena[0]));
+
+        std::vector<Entry>::iterator last = this->entries.begin();
+        for (std::vector<Entry>::iterator iter = this->entries.begin(); iter != this->entries.end(); ++iter) {
+            if (iter != last && !EntryOrder(&this->arena[0])(*last, *iter)) {
+                this->garbage += last->end - last->offset;
+                *last = *iter;
+            } else if (iter != last) {
+                *(++last) = *iter;
+            }
+        }
+
+        if (!this->entries.empty()) {
+            this->entries.erase(++last, this->entries.end());
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::marshal(std::vector<unsigned char>& buffer) const {
+
+    std::size_t total = COUNT_SIZE;
+    std::vector<Entry>::const_iterator iter = this->entries.begin();
+    for (; iter != this->entries.end(); ++iter) {
+        total += (std::size_t) (iter->end - iter->offset);
+    }
+
+    buffer.resize(total);
+
+    int count = (int) this->entries.size();
+    buffer[0] = (unsigned char) (count >> 24);
+    buffer[1] = (unsigned char) (count >> 16);
+    buffer[2] = (unsigned char) (count >> 8);
+    buffer[3] = (unsigned char) count;
+
+    std::size_t position = COUNT_SIZE;
+    for (iter = this->entries.begin(); iter != this->entries.end(); ++iter) {
+        std::size_t length = (std::size_t) (iter->end - iter->offset);
+        std::memcpy(&buffer[position], &this->arena[iter->offset], length);
+        position += length;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::toPrimitiveMap(PrimitiveMap& map) const {
+
+    try {
+        std::vector<unsigned char> buffer;
+        marshal(buffer);
+
+        map.clear();
+        PrimitiveTypesMarshaller::unmarshal(&map, buffer);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::fromPrimitiveMap(const PrimitiveMap& map) {
+
+    try {
+        std::vector<unsigned char> buffer;
+        PrimitiveTypesMarshaller::marshal(&map, buffer);
+        parse(buffer);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FlatPropertyMap::containsKey(const std::string& key) const {
+    return find(key) >= 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> FlatPropertyMap::keySet() const {
+
+    std::vector<std::string> keys;
+    keys.reserve(this->entries.size());
+
+    std::vector<Entry>::const_iterator iter = this->entries.begin();
+    for (; iter != this->entries.end(); ++iter) {
+
+        std::string key((const char*) &this->arena[iter->offset + KEY_LENGTH_SIZE], (std::size_t) iter->keyLength);
+
+        if (!isPlainAscii(key)) {
+            ByteArrayInputStream bytes(&this->arena[iter->offset], iter->keyLength + KEY_LENGTH_SIZE);
+            DataInputStream dataIn(&bytes);
+            key = dataIn.readUTF();
+        }
+
+        keys.push_back(key);
+    }
+
+    return keys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FlatPropertyMap::remove(const std::string& key) {
+
+    int index = find(key);
+    if (index < 0) {
+        return false;
+    }
+
+    this->garbage += this->entries[index].end - this->entries[index].offset;
+    this->entries.erase(this->entries.begin() + index);
+    compact();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PrimitiveValueNode::PrimitiveType FlatPropertyMap::getValueType(const std::string& key) const {
+    return (PrimitiveValueNode::PrimitiveType) lookup(key).type;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PrimitiveValueNode FlatPropertyMap::getValue(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+
+    try {
+
+        // Decode through the standard marshaller as a map of one entry so that
+        // nested values come back exactly as a PrimitiveMap would hold them.
+        std::vector<unsigned char> buffer(COUNT_SIZE + entry.end - entry.offset);
+        buffer[3] = 1;
+        std::memcpy(&buffer[COUNT_SIZE], &this->arena[entry.offset], (std::size_t) (entry.end - entry.offset));
+
+        PrimitiveMap map;
+        PrimitiveTypesMarshaller::unmarshal(&map, buffer);
+
+        return map.get(key);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setValue(const std::string& key, const PrimitiveValueNode& value) {
+
+    try {
+
+        PrimitiveMap map;
+        map.put(key, value);
+
+        std::vector<unsigned char> buffer;
+        PrimitiveTypesMarshaller::marshal(&map, buffer);
+
+        int offset = (int) this->arena.size();
+        this->arena.insert(this->arena.end(), buffer.begin() + COUNT_SIZE, buffer.end());
+
+        int keyLength = (this->arena[offset] << 8) | this->arena[offset + 1];
+        commitEntry(key, offset + KEY_LENGTH_SIZE + keyLength + 1);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FlatPropertyMap::getBool(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::BOOLEAN_TYPE) {
+        return this->arena[entry.valueOffset] != 0;
+    }
+
+    return PrimitiveValueConverter().convert<bool>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setBool(const std::string& key, bool value) {
+    int position = beginEntry(key, PrimitiveValueNode::BOOLEAN_TYPE, 1);
+    this->arena[position] = value ? 1 : 0;
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char FlatPropertyMap::getByte(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::BYTE_TYPE) {
+        return this->arena[entry.valueOffset];
+    }
+
+    return PrimitiveValueConverter().convert<unsigned char>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setByte(const std::string& key, unsigned char value) {
+    int position = beginEntry(key, PrimitiveValueNode::BYTE_TYPE, 1);
+    this->arena[position] = value;
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+char FlatPropertyMap::getChar(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::CHAR_TYPE) {
+        // Java chars are two bytes but only the low byte is carried.
+        return (char) this->arena[entry.valueOffset + 1];
+    }
+
+    return PrimitiveValueConverter().convert<char>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setChar(const std::string& key, char value) {
+    int position = beginEntry(key, PrimitiveValueNode::CHAR_TYPE, 2);
+    this->arena[position] = 0;
+    this->arena[position + 1] = (unsigned char) value;
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short FlatPropertyMap::getShort(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::SHORT_TYPE) {
+        return (short) ((this->arena[entry.valueOffset] << 8) | this->arena[entry.valueOffset + 1]);
+    }
+
+    return PrimitiveValueConverter().convert<short>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setShort(const std::string& key, short value) {
+    int position = beginEntry(key, PrimitiveValueNode::SHORT_TYPE, 2);
+    this->arena[position] = (unsigned char) (value >> 8);
+    this->arena[position + 1] = (unsigned char) value;
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::getInt(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::INTEGER_TYPE) {
+        return readInt(entry.valueOffset);
+    }
+
+    return PrimitiveValueConverter().convert<int>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setInt(const std::string& key, int value) {
+    int position = beginEntry(key, PrimitiveValueNode::INTEGER_TYPE, 4);
+    writeInt(position, value);
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FlatPropertyMap::getLong(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::LONG_TYPE) {
+        return readLong(entry.valueOffset);
+    } else if (entry.type == PrimitiveValueNode::INTEGER_TYPE) {
+        return readInt(entry.valueOffset);
+    }
+
+    return PrimitiveValueConverter().convert<long long>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setLong(const std::string& key, long long value) {
+    int position = beginEntry(key, PrimitiveValueNode::LONG_TYPE, 8);
+    writeLong(position, value);
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+float FlatPropertyMap::getFloat(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::FLOAT_TYPE) {
+        return Float::intBitsToFloat(readInt(entry.valueOffset));
+    }
+
+    return PrimitiveValueConverter().convert<float>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setFloat(const std::string& key, float value) {
+    int position = beginEntry(key, PrimitiveValueNode::FLOAT_TYPE, 4);
+    writeInt(position, Float::floatToRawIntBits(value));
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double FlatPropertyMap::getDouble(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::DOUBLE_TYPE) {
+        return Double::longBitsToDouble(readLong(entry.valueOffset));
+    }
+
+    return PrimitiveValueConverter().convert<double>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setDouble(const std::string& key, double value) {
+    int position = beginEntry(key, PrimitiveValueNode::DOUBLE_TYPE, 8);
+    writeLong(position, Double::doubleToRawLongBits(value));
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FlatPropertyMap::getString(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::STRING_TYPE) {
+        return std::string((const char*) &this->arena[0] + entry.valueOffset + 2,
+                           (std::size_t) (entry.end - entry.valueOffset - 2));
+    } else if (entry.type == PrimitiveValueNode::BIG_STRING_TYPE) {
+        return std::string((const char*) &this->arena[0] + entry.valueOffset + 4,
+                           (std::size_t) (entry.end - entry.valueOffset - 4));
+    }
+
+    return PrimitiveValueConverter().convert<std::string>(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setString(const std::string& key, const std::string& value) {
+
+    int size = (int) value.size();
+
+    // Matches the choice of string encoding made by PrimitiveTypesMarshaller.
+    if (size > Short::MAX_VALUE / 4) {
+        int position = beginEntry(key, PrimitiveValueNode::BIG_STRING_TYPE, 4 + size);
+        writeInt(position, size);
+        std::memcpy(&this->arena[position + 4], value.data(), (std::size_t) size);
+        commitEntry(key, position);
+    } else {
+        int position = beginEntry(key, PrimitiveValueNode::STRING_TYPE, 2 + size);
+        this->arena[position] = (unsigned char) (size >> 8);
+        this->arena[position + 1] = (unsigned char) size;
+        if (size > 0) {
+            std::memcpy(&this->arena[position + 2], value.data(), (std::size_t) size);
+        }
+        commitEntry(key, position);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char> FlatPropertyMap::getByteArray(const std::string& key) const {
+
+    const Entry& entry = lookup(key);
+    if (entry.type == PrimitiveValueNode::BYTE_ARRAY_TYPE) {
+        return std::vector<unsigned char>(this->arena.begin() + entry.valueOffset + 4,
+                                          this->arena.begin() + entry.end);
+    }
+
+    return PrimitiveValueConverter().convert<std::vector<unsigned char> >(getValue(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::setByteArray(const std::string& key, const std::vector<unsigned char>& value) {
+
+    int size = (int) value.size();
+    int position = beginEntry(key, PrimitiveValueNode::BYTE_ARRAY_TYPE, 4 + size);
+    writeInt(position, size);
+    if (size > 0) {
+        std::memcpy(&this->arena[position + 4], &value[0], (std::size_t) size);
+    }
+    commitEntry(key, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const FlatPropertyMap::Entry& FlatPropertyMap::lookup(const std::string& key) const {
+
+    int index = find(key);
+    if (index < 0) {
+        throw NoSuchElementException(__FILE__, __LINE__, "Key does not exist in map: %s", key.c_str());
+    }
+
+    return this->entries[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::find(const std::string& key) const {
+
+    if (isPlainAscii(key)) {
+        return find(key.data(), (int) key.size());
+    }
+
+    std::string encoded = encodeKey(key);
+    return find(encoded.data(), (int) encoded.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::find(const char* key, int length) const {
+
+    int low = 0;
+    int high = (int) this->entries.size() - 1;
+
+    while (low <= high) {
+
+        int middle = (low + high) >> 1;
+        const Entry& entry = this->entries[middle];
+
+        int result = compareKeys(&this->arena[entry.offset + KEY_LENGTH_SIZE], entry.keyLength,
+                                 (const unsigned char*) key, length);
+
+        if (result < 0) {
+            low = middle + 1;
+        } else if (result > 0) {
+            high = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+
+    return -(low + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::beginEntry(const std::string& key, unsigned char type, int valueSize) {
+
+    std::string encoded = isPlainAscii(key) ? key : encodeKey(key);
+    int keyLength = (int) encoded.size();
+
+    if (keyLength > 65535) {
+        throw IOException(__FILE__, __LINE__, "Property name is too long to be marshaled.");
+    }
+
+    std::size_t offset = this->arena.size();
+    this->arena.resize(offset + KEY_LENGTH_SIZE + keyLength + 1 + valueSize);
+
+    this->arena[offset] = (unsigned char) (keyLength >> 8);
+    this->arena[offset + 1] = (unsigned char) keyLength;
+    if (keyLength > 0) {
+        std::memcpy(&this->arena[offset + KEY_LENGTH_SIZE], encoded.data(), (std::size_t) keyLength);
+    }
+    this->arena[offset + KEY_LENGTH_SIZE + keyLength] = type;
+
+    return (int) offset + KEY_LENGTH_SIZE + keyLength + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::commitEntry(const std::string& key, int position) {
+
+    // The record for the key was just appended so it runs to the end of the arena.
+    int keyLength = isPlainAscii(key) ? (int) key.size() : (int) encodeKey(key).size();
+    int offset = position - 1 - keyLength - KEY_LENGTH_SIZE;
+
+    Entry entry;
+    entry.end = (int) this->arena.size();
+    entry.offset = offset;
+    entry.keyLength = (this->arena[offset] << 8) | this->arena[offset + 1];
+    entry.valueOffset = offset + KEY_LENGTH_SIZE + entry.keyLength + 1;
+    entry.type = this->arena[entry.valueOffset - 1];
+
+    int index = find((const char*) &this->arena[offset + KEY_LENGTH_SIZE], entry.keyLength);
+    if (index >= 0) {
+        this->garbage += this->entries[index].end - this->entries[index].offset;
+        this->entries[index] = entry;
+        compact();
+    } else {
+        this->entries.insert(this->entries.begin() + (-index - 1), entry);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::skipValue(unsigned char type, int position) const {
+
+    int size = (int) this->arena.size();
+    int length = 0;
+
+    switch (type) {
+        case PrimitiveValueNode::NULL_TYPE:
+            break;
+        case PrimitiveValueNode::BOOLEAN_TYPE:
+        case PrimitiveValueNode::BYTE_TYPE:
+            length = 1;
+            break;
+        case PrimitiveValueNode::CHAR_TYPE:
+        case PrimitiveValueNode::SHORT_TYPE:
+            length = 2;
+            break;
+        case PrimitiveValueNode::INTEGER_TYPE:
+        case PrimitiveValueNode::FLOAT_TYPE:
+            length = 4;
+            break;
+        case PrimitiveValueNode::LONG_TYPE:
+        case PrimitiveValueNode::DOUBLE_TYPE:
+            length = 8;
+            break;
+        case PrimitiveValueNode::STRING_TYPE: {
+            if (position + 2 > size) {
+                throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+            }
+            int utfLength = (this->arena[position] << 8) | this->arena[position + 1];
+            length = 2 + utfLength;
+            break;
+        }
+        case PrimitiveValueNode::BYTE_ARRAY_TYPE:
+        case PrimitiveValueNode::BIG_STRING_TYPE: {
+            if (position + 4 > size) {
+                length = 4;
+                break;
+            }
+            int dataLength = readInt(position);
+            if (dataLength < 0 || dataLength > size) {
+                throw IOException(__FILE__, __LINE__, "Marshaled property has an invalid length.");
+            }
+            length = 4 + dataLength;
+            break;
+        }
+        case PrimitiveValueNode::LIST_TYPE: {
+            if (position + 4 > size) {
+                length = 4;
+                break;
+            }
+            int count = readInt(position);
+            position += 4;
+            for (int i = 0; i < count; ++i) {
+                if (position >= size) {
+                    throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+                }
+                unsigned char elementType = this->arena[position];
+                position = skipValue(elementType, position + 1);
+            }
+            return position;
+        }
+        case PrimitiveValueNode::MAP_TYPE:
+            return skipMap(position);
+        default:
+            throw IOException(__FILE__, __LINE__, "Unsupported data type in marshaled property map: %d", (int) type);
+    }
+
+    if (position + length > size) {
+        throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+    }
+
+    return position + length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::skipMap(int position) const {
+
+    int size = (int) this->arena.size();
+
+    if (position + 4 > size) {
+        throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+    }
+
+    int count = readInt(position);
+    position += 4;
+
+    for (int i = 0; i < count; ++i) {
+        if (position + KEY_LENGTH_SIZE > size) {
+            throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+        }
+        position += KEY_LENGTH_SIZE + ((this->arena[position] << 8) | this->arena[position + 1]);
+        if (position >= size) {
+            throw IOException(__FILE__, __LINE__, "Marshaled property map is truncated.");
+        }
+        unsigned char type = this->arena[position];
+        position = skipValue(type, position + 1);
+    }
+
+    return position;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int FlatPropertyMap::readInt(int position) const {
+    const unsigned char* bytes = &this->arena[position];
+    return (int) (((unsigned int) bytes[0] << 24) | ((unsigned int) bytes[1] << 16) |
+                  ((unsigned int) bytes[2] << 8) | (unsigned int) bytes[3]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FlatPropertyMap::readLong(int position) const {
+    unsigned long long high = (unsigned int) readInt(position);
+    unsigned long long low = (unsigned int) readInt(position + 4);
+    return (long long) ((high << 32) | low);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::writeInt(int position, int value) {
+    unsigned char* bytes = &this->arena[position];
+    bytes[0] = (unsigned char) (value >> 24);
+    bytes[1] = (unsigned char) (value >> 16);
+    bytes[2] = (unsigned char) (value >> 8);
+    bytes[3] = (unsigned char) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::writeLong(int position, long long value) {
+    writeInt(position, (int) (value >> 32));
+    writeInt(position + 4, (int) value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMap::compact() {
+
+    int size = (int) this->arena.size();
+    if (size < MIN_COMPACT_SIZE || this->garbage * 2 < size) {
+        return;
+    }
+
+    std::vector<unsigned char> compacted;
+    compacted.reserve((std::size_t) (size - this->garbage));
+
+    std::vector<Entry>::iterator iter = this->entries.begin();
+    for (; iter != this->entries.end(); ++iter) {
+        int shift = (int) compacted.size() - iter->offset;
+        compacted.insert(compacted.end(), this->arena.begin() + iter->offset, this->arena.begin() + iter->end);
+        iter->offset += shift;
+        iter->valueOffset += shift;
+        iter->end += shift;
+    }
+
+    this->arena.swap(compacted);
+    this->garbage = 0;
+}
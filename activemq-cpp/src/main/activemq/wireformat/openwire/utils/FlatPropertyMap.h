@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAP_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAP_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/util/PrimitiveValueNode.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    /**
+     * A property map that keeps its entries in the OpenWire marshaled form.  All
+     * entries live in one byte arena exactly as they appear on the wire.  A
+     * small index sorted by name points into the arena, so a marshaled property
+     * block is parsed with a single copy and no per-property allocations.
+     * Writing it back out is one copy per entry.
+     *
+     * The typed getters read values straight out of the arena when the stored
+     * type matches.  Other types fall back to the same conversions PrimitiveMap
+     * applies, so both maps return the same results for the same data.  Nested
+     * maps and lists are kept in marshaled form and are only decoded when asked
+     * for through getValue.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API FlatPropertyMap {
+    private:
+
+        struct Entry {
+            int offset;
+            int keyLength;
+            int valueOffset;
+            int end;
+            unsigned char type;
+        };
+
+        struct EntryOrder {
+            const unsigned char* arena;
+
+            EntryOrder(const unsigned char* arena) : arena(arena) {}
+
+            bool operator()(const Entry& left, const Entry& right) const;
+        };
+
+        std::vector<unsigned char> arena;
+        std::vector<Entry> entries;
+        int garbage;
+
+    public:
+
+        FlatPropertyMap();
+
+        virtual ~FlatPropertyMap();
+
+        /**
+         * Replaces the contents of this map with the properties in the given
+         * marshaled map, as written by PrimitiveTypesMarshaller.
+         *
+         * @param buffer
+         *      The marshaled properties.
+         * @param size
+         *      The number of bytes in the buffer.
+         *
+         * @throws IOException if the buffer does not hold a valid marshaled map.
+         */
+        void parse(const unsigned char* buffer, int size);
+
+        /**
+         * Replaces the contents of this map with the properties in the given
+         * marshaled map, as written by PrimitiveTypesMarshaller.
+         *
+         * @throws IOException if the buffer does not hold a valid marshaled map.
+         */
+        void parse(const std::vector<unsigned char>& buffer);
+
+        /**
+         * Writes the properties in the OpenWire marshaled map format, replacing
+         * the contents of the given buffer.
+         *
+         * @param buffer
+         *      The buffer to write to.
+         */
+        void marshal(std::vector<unsigned char>& buffer) const;
+
+        /**
+         * Replaces the contents of the given PrimitiveMap with these properties.
+         */
+        void toPrimitiveMap(util::PrimitiveMap& map) const;
+
+        /**
+         * Replaces the contents of this map with those of the given PrimitiveMap.
+         */
+        void fromPrimitiveMap(const util::PrimitiveMap& map);
+
+        int size() const {
+            return (int) this->entries.size();
+        }
+
+        bool isEmpty() const {
+            return this->entries.empty();
+        }
+
+        void clear();
+
+        bool containsKey(const std::string& key) const;
+
+        /**
+         * @return the names of all the properties in name order.
+         */
+        std::vector<std::string> keySet() const;
+
+        /**
+         * Removes the named property.
+         *
+         * @return true if the property was present.
+         */
+        bool remove(const std::string& key);
+
+        /**
+         * @return the PrimitiveValueNode::PrimitiveType of the named property.
+         *
+         * @throws NoSuchElementException if the property is not present.
+         */
+        util::PrimitiveValueNode::PrimitiveType getValueType(const std::string& key) const;
+
+        /**
+         * Decodes the named property into a PrimitiveValueNode, this is the slow
+         * path and is needed only for nested maps and lists.
+         *
+         * @throws NoSuchElementException if the property is not present.
+         */
+        util::PrimitiveValueNode getValue(const std::string& key) const;
+
+        /**
+         * Sets the named property to a copy of the given value.
+         */
+        void setValue(const std::string& key, const util::PrimitiveValueNode& value);
+
+        // The typed getters throw NoSuchElementException when the property is not
+        // present and UnsupportedOperationException when its value cannot be
+        // converted, in the same way as PrimitiveMap.
+
+        bool getBool(const std::string& key) const;
+        void setBool(const std::string& key, bool value);
+
+        unsigned char getByte(const std::string& key) const;
+        void setByte(const std::string& key, unsigned char value);
+
+        char getChar(const std::string& key) const;
+        void setChar(const std::string& key, char value);
+
+        short getShort(const std::string& key) const;
+        void setShort(const std::string& key, short value);
+
+        int getInt(const std::string& key) const;
+        void setInt(const std::string& key, int value);
+
+        long long getLong(const std::string& key) const;
+        void setLong(const std::string& key, long long value);
+
+        float getFloat(const std::string& key) const;
+        void setFloat(const std::string& key, float value);
+
+        double getDouble(const std::string& key) const;
+        void setDouble(const std::string& key, double value);
+
+        std::string getString(const std::string& key) const;
+        void setString(const std::string& key, const std::string& value);
+
+        std::vector<unsigned char> getByteArray(const std::string& key) const;
+        void setByteArray(const std::string& key, const std::vector<unsigned char>& value);
+
+    private:
+
+        const Entry& lookup(const std::string& key) const;
+
+        int find(const std::string& key) const;
+
+        int find(const char* key, int length) const;
+
+        int beginEntry(const std::string& key, unsigned char type, int valueSize);
+
+        void commitEntry(const std::string& key, int position);
+
+        int skipValue(unsigned char type, int position) const;
+
+        int skipMap(int position) const;
+
+        int readInt(int position) const;
+
+        long long readLong(int position) const;
+
+        void writeInt(int position, int value);
+
+        void writeLong(int position, long long value);
+
+        void compact();
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAP_H_ */
@@ -43,6 +43,7 @@ namespace stomp{
         static const std::string COMMIT;
         static const std::string ABORT;
         static const std::string ACK;
+        static const std::string NACK;
         static const std::string ERROR_CMD;
         static const std::string RECEIPT;
 
@@ -84,12 +85,20 @@ namespace stomp{
         static const std::string HEADER_SUBSCRIPTION;
         static const std::string HEADER_TRANSFORMATION;
         static const std::string HEADER_TRANSFORMATION_ERROR;
+        static const std::string HEADER_ACCEPT_VERSION;
+        static const std::string HEADER_VERSION;
+        static const std::string HEADER_HEARTBEAT;
 
         // Stomp Ack Modes
         static const std::string ACK_CLIENT;
         static const std::string ACK_AUTO;
         static const std::string ACK_INDIVIDUAL;
 
+        // Stomp Protocol Versions
+        static const std::string VERSION_1_0;
+        static const std::string VERSION_1_1;
+        static const std::string VERSION_1_2;
+
         // Supported Stomp Message Types
         static const std::string TEXT;
         static const std::string BYTES;
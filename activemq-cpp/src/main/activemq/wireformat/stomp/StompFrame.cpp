@@ -20,10 +20,9 @@
 #include <string>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
-#include <decaf/lang/Character.h>
-#include <decaf/lang/Integer.h>
 
 #include <activemq/wireformat/stomp/StompCommandConstants.h>
+#include <activemq/wireformat/stomp/StompFrameParser.h>
 #include <activemq/exceptions/ActiveMQException.h>
 
 using namespace std;
@@ -36,6 +35,38 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void appendHeader(std::string& section, const std::string& text, bool escape) {
+
+        if (!escape || text.find_first_of("\\\n\r:") == std::string::npos) {
+            section.append(text);
+            return;
+        }
+
+        for (std::size_t ix = 0; ix < text.length(); ++ix) {
+            switch (text[ix]) {
+                case '\\':
+                    section.append("\\\\");
+                    break;
+                case '\n':
+                    section.append("\\n");
+                    break;
+                case '\r':
+                    section.append("\\r");
+                    break;
+                case ':':
+                    section.append("\\c");
+                    break;
+                default:
+                    section.append(1, text[ix]);
+                    break;
+            }
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 StompFrame::StompFrame() : command(), properties(), body() {
 }
@@ -71,31 +102,38 @@ void StompFrame::setBody(const unsigned char* bytes, std::size_t numBytes) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
+void StompFrame::toStream(decaf::io::DataOutputStream* stream, bool escapeHeaders) const {
 
     if (stream == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "Stream Passed is Null");
     }
 
-    // Write the command.
+    // Gather the command and the headers so they go to the stream in one write.
     const string& cmdString = this->getCommand();
-    stream->write((unsigned char*) cmdString.c_str(), (int) cmdString.length(), 0, (int) cmdString.length());
-    stream->write('\n');
-
-    // Write all the headers.
     vector<pair<string, string> > headers = this->getProperties().toArray();
+
+    std::size_t length = cmdString.length() + 2;
     for (std::size_t ix = 0; ix < headers.size(); ++ix) {
-        string& name = headers[ix].first;
-        string& value = headers[ix].second;
+        length += headers[ix].first.length() + headers[ix].second.length() + 2;
+    }
+
+    string section;
+    section.reserve(length);
 
-        stream->write((unsigned char*) name.c_str(), (int) name.length(), 0, (int) name.length());
-        stream->write(':');
-        stream->write((unsigned char*) value.c_str(), (int) value.length(), 0, (int) value.length());
-        stream->write('\n');
+    section.append(cmdString);
+    section.append(1, '\n');
+
+    for (std::size_t ix = 0; ix < headers.size(); ++ix) {
+        appendHeader(section, headers[ix].first, escapeHeaders);
+        section.append(1, ':');
+        appendHeader(section, headers[ix].second, escapeHeaders);
+        section.append(1, '\n');
     }
 
     // Finish the header section with a form feed.
-    stream->write('\n');
+    section.append(1, '\n');
+
+    stream->write((const unsigned char*) section.data(), (int) section.length(), 0, (int) section.length());
 
     // Write the body.
     const std::vector<unsigned char>& body = this->getBody();
@@ -103,12 +141,13 @@ void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
         stream->write(&body[0], (int) body.size(), 0, (int) body.size());
     }
 
+    unsigned char trailer[2] = { '\0', '\n' };
     if ((this->getBodyLength() == 0) || (this->getProperty(StompCommandConstants::HEADER_CONTENTLENGTH) != "")) {
-        stream->write('\0');
+        stream->write(trailer, 2, 0, 2);
+    } else {
+        stream->write(trailer, 2, 1, 1);
     }
 
-    stream->write('\n');
-
     // Flush the stream.
     stream->flush();
 }
@@ -116,211 +155,6 @@ void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
 ////////////////////////////////////////////////////////////////////////////////
 void StompFrame::fromStream(decaf::io::DataInputStream* in) {
 
-    if (in == NULL) {
-        throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
-    }
-
-    try {
-
-        // Read the command header.
-        readCommandHeader(in);
-
-        // Read the headers.
-        readHeaders(in);
-
-        // Read the body.
-        readBody(in);
-    }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void StompFrame::readCommandHeader(decaf::io::DataInputStream* in) {
-
-    try {
-
-        std::vector<unsigned char> buffer;
-
-        while (true) {
-
-            // The command header is formatted just like any other stomp header.
-            readHeaderLine(buffer, in);
-
-            // Ignore all white space before the command.
-            long long offset = -1;
-            for (size_t ix = 0; ix < buffer.size() - 1; ++ix) {
-
-                // Find the first non whitespace character
-                if (!Character::isWhitespace(buffer[ix])) {
-                    offset = (long long) ix;
-                    break;
-                }
-            }
-
-            if (offset >= 0) {
-                // Set the command in the frame - copy the memory.
-                this->setCommand(reinterpret_cast<char*>(&buffer[(size_t) offset]));
-                break;
-            }
-        }
-    }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void StompFrame::readHeaders(decaf::io::DataInputStream* in) {
-
-    try {
-
-        // Read the command;
-        bool endOfHeaders = false;
-        std::vector<unsigned char> buffer;
-
-        while (!endOfHeaders) {
-
-            // Read in the next header line.
-            std::size_t numChars = readHeaderLine(buffer, in);
-
-            if (numChars == 0) {
-
-                // should never get here
-                throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompHeaders: no characters read");
-            }
-
-            // Check for an empty line to demark the end of the header section.
-            // if its not the end then we have a header to process, so parse it.
-            if (numChars == 1 && buffer[0] == '\0') {
-                endOfHeaders = true;
-            } else {
-
-                // Search through this line to separate the key/value pair.
-                for (size_t ix = 0; ix < buffer.size(); ++ix) {
-
-                    // If found the key/value separator...
-                    if (buffer[ix] == ':') {
-
-                        // Null-terminate the key.
-                        buffer[ix] = '\0';
-
-                        const char* key = reinterpret_cast<char*>(&buffer[0]);
-                        const char* value = reinterpret_cast<char*>(&buffer[ix + 1]);
-
-                        // Assign the header key/value pair.
-                        if (!this->getProperties().hasProperty(key)) {
-                            this->getProperties().setProperty(key, value);
-                        }
-
-                        // Break out of the for loop.
-                        break;
-                    }
-                }
-            }
-        }
-    }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
-}
-
-////////////////////////////////////////////////////////////////////////////////
-std::size_t StompFrame::readHeaderLine(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in) {
-
-    try {
-
-        // Clear any data from the buffer.
-        buffer.clear();
-
-        std::size_t count = 0;
-
-        while (true) {
-
-            // Read the next char from the stream.
-            buffer.push_back(in->readByte());
-
-            // Increment the position pointer.
-            count++;
-
-            // If we reached the line terminator, return the total number
-            // of characters read.
-            if (buffer[count - 1] == '\n') {
-                // Overwrite the line feed with a null character.
-                buffer[count - 1] = '\0';
-                return count;
-            }
-        }
-
-        // If we get here something bad must have happened.
-        throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompHeaderLine: "
-                "Unrecoverable, error condition");
-    }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void StompFrame::readBody(decaf::io::DataInputStream* in) {
-
-    try {
-
-        // Clear any data from the body.
-        this->body.clear();
-
-        unsigned int content_length = 0;
-
-        if (this->hasProperty(StompCommandConstants::HEADER_CONTENTLENGTH)) {
-            string length = this->getProperty(StompCommandConstants::HEADER_CONTENTLENGTH);
-            content_length = (unsigned int) Integer::parseInt(length);
-        }
-
-        if (content_length != 0) {
-            // For this case its assumed that content length indicates how
-            // much to read.  We reserve space in the buffer for it to
-            // minimize the number of reallocs that might occur.  We are
-            // assuming that content length doesn't count the trailing null
-            // that indicates the end of frame.  The reserve won't do anything
-            // if the buffer already has that much capacity.  The resize call
-            // basically sets the end iterator to the correct location since
-            // this is a char vector and we already reserve enough space.
-            // Resize doesn't realloc the vector smaller if content_length
-            // is less than capacity of the buffer, it just move the end
-            // iterator.  Reserve adds the benefit that the mem is set to
-            // zero.
-
-            this->body.reserve((std::size_t) content_length);
-            this->body.resize((std::size_t) content_length);
-
-            // Read the Content Length now
-            in->readFully(&body[0], (int) body.size());
-
-            // Content Length read, now pop the end terminator off (\0\n).
-            if (in->readByte() != '\0') {
-                throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompBody: "
-                        "Read Content Length, and no trailing null");
-            }
-
-        } else {
-
-            // Content length was either zero, or not set, so we read until the
-            // first null is encountered.
-            while (true) {
-
-                char byte = in->readByte();
-                this->body.push_back(byte);
-
-                if (byte != '\0') {
-                    continue;
-                }
-
-                break; // Read null and newline we are done.
-            }
-        }
-    }
-    AMQ_CATCH_RETHROW(decaf::io::IOException)
-    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
-    AMQ_CATCHALL_THROW(decaf::io::IOException)
+    StompFrameParser parser;
+    parser.parse(in, *this);
 }
@@ -172,13 +172,17 @@ namespace stomp {
          * Writes this Frame to an OuputStream in the Stomp Wire Format.
          *
          * @param stream - The stream to write the Frame to.
+         * @param escapeHeaders - True to escape the backslashes, line ends and colons in
+         *                        header names and values as STOMP 1.1 and later require.
          *
          * @throw IOException if an error occurs while reading the Frame.
          */
-        void toStream(decaf::io::DataOutputStream* stream) const;
+        void toStream(decaf::io::DataOutputStream* stream, bool escapeHeaders = false) const;
 
         /**
-         * Reads a Stop Frame from a DataInputStream in the Stomp Wire format.
+         * Reads a Stop Frame from a DataInputStream in the Stomp Wire format.  Readers
+         * that take many Frames from one stream should keep a StompFrameParser instead
+         * so that its buffers are reused.
          *
          * @param stream - The stream to read the Frame from.
          *
@@ -186,38 +190,6 @@ namespace stomp {
          */
         void fromStream(decaf::io::DataInputStream* stream);
 
-    private:
-
-        /**
-         * Read the Stomp Command from the Frame
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readCommandHeader(decaf::io::DataInputStream* in);
-
-        /**
-         * Read all the Stomp Headers for the incoming Frame
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readHeaders(decaf::io::DataInputStream* in);
-
-        /**
-         * Reads a Stomp Header line and stores it in the buffer object
-         * @param buffer - reference to a memory buffer to store the read line in.
-         * @param in - The stream to read the Frame from.
-         * @return number of bytes read, zero if there was a problem.
-         * @throws IOException
-         */
-        std::size_t readHeaderLine(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in);
-
-        /**
-         * Reads the Stomp Body from the Wire and store it in the frame.
-         * @param in - The stream to read the Frame from.
-         * @throws IOException
-         */
-        void readBody(decaf::io::DataInputStream* in);
-
     };
 
 }}}
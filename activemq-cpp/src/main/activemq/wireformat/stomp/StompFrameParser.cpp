@@ -0,0 +1,312 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameParser.h"
+
+#include <string.h>
+
+#include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompCommandConstants.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Character.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/util/Properties.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::exceptions;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string decodeHeader(const char* data, std::size_t length) {
+
+        // Nearly all headers have nothing to unescape.
+        if (memchr(data, '\\', length) == NULL) {
+            return std::string(data, length);
+        }
+
+        std::string result;
+        result.reserve(length);
+
+        for (std::size_t ix = 0; ix < length; ++ix) {
+
+            if (data[ix] != '\\' || ix + 1 == length) {
+                result.append(1, data[ix]);
+                continue;
+            }
+
+            switch (data[++ix]) {
+                case 'n':
+                    result.append(1, '\n');
+                    break;
+                case 'r':
+                    result.append(1, '\r');
+                    break;
+                case 'c':
+                    result.append(1, ':');
+                    break;
+                case '\\':
+                    result.append(1, '\\');
+                    break;
+                default:
+                    // Not a defined escape, keep it as it was sent.
+                    result.append(1, '\\');
+                    result.append(1, data[ix]);
+                    break;
+            }
+        }
+
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameParser::StompFrameParser() : block(), headers(), decodeHeaders(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameParser::~StompFrameParser() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameParser::parse(DataInputStream* in, StompFrame& frame) {
+
+    if (in == NULL) {
+        throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
+    }
+
+    try {
+
+        DirectInputBuffer::Window window = in->getDirectInputWindow();
+
+        // Ignore all the blank lines before the command.
+        while (!readCommand(in, window, frame)) {
+        }
+
+        readHeaders(in, window, frame);
+        readBody(in, window, frame);
+    }
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool StompFrameParser::parseFrameOrHeartBeat(DataInputStream* in, StompFrame& frame) {
+
+    if (in == NULL) {
+        throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
+    }
+
+    try {
+
+        DirectInputBuffer::Window window = in->getDirectInputWindow();
+
+        if (!readCommand(in, window, frame)) {
+            return false;
+        }
+
+        readHeaders(in, window, frame);
+        readBody(in, window, frame);
+
+        // Take the line end that is sent after the null so it isn't seen as a
+        // heart-beat, only when it has arrived so that this never blocks.
+        if (window.array != NULL) {
+
+            const unsigned char* array = *window.array;
+            int position = *window.position;
+            int limit = *window.limit;
+
+            if (array != NULL && position < limit) {
+                if (array[position] == '\n') {
+                    *window.position = position + 1;
+                } else if (array[position] == '\r' && position + 1 < limit && array[position + 1] == '\n') {
+                    *window.position = position + 2;
+                }
+            }
+        }
+
+        return true;
+    }
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StompFrameParser::readUntil(DataInputStream* in, const DirectInputBuffer::Window& window,
+                                        unsigned char delimiter, std::vector<unsigned char>& target) {
+
+    std::size_t total = 0;
+
+    while (true) {
+
+        if (window.array != NULL) {
+
+            // Use a local reference in case of unsynchronized close.
+            const unsigned char* array = *window.array;
+            int position = *window.position;
+            int limit = *window.limit;
+
+            if (array != NULL && position < limit) {
+
+                const unsigned char* start = array + position;
+                const unsigned char* found = (const unsigned char*) memchr(start, delimiter, (std::size_t) (limit - position));
+                std::size_t length = found != NULL ? (std::size_t) (found - start) + 1 : (std::size_t) (limit - position);
+
+                target.insert(target.end(), start, start + length);
+                *window.position = position + (int) length;
+                total += length;
+
+                if (found != NULL) {
+                    return total;
+                }
+
+                continue;
+            }
+        }
+
+        // Nothing is buffered, reading the next byte waits for data and lets the
+        // stream refill its array so the scan above can take the rest of it.
+        unsigned char byte = in->readByte();
+        target.push_back(byte);
+        total++;
+
+        if (byte == delimiter) {
+            return total;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool StompFrameParser::readCommand(DataInputStream* in, const DirectInputBuffer::Window& window, StompFrame& frame) {
+
+    this->block.clear();
+    std::size_t length = readUntil(in, window, '\n', this->block);
+
+    // Ignore all white space before the command.
+    const char* line = reinterpret_cast<const char*>(&this->block[0]);
+    for (std::size_t ix = 0; ix < length - 1; ++ix) {
+
+        if (!Character::isWhitespace(line[ix])) {
+            const char* end = (const char*) memchr(line + ix, '\0', length - 1 - ix);
+            frame.setCommand(std::string(line + ix, end != NULL ? end : line + length - 1));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameParser::readHeaders(DataInputStream* in, const DirectInputBuffer::Window& window, StompFrame& frame) {
+
+    // The CONNECTED Frame is never escaped so that any version can read it.
+    bool decode = this->decodeHeaders && frame.getCommand() != StompCommandConstants::CONNECTED;
+
+    this->block.clear();
+    this->headers.clear();
+
+    while (true) {
+
+        std::size_t start = this->block.size();
+        std::size_t length = readUntil(in, window, '\n', this->block) - 1;
+
+        // The versions that escape headers may also end lines with a carriage return.
+        if (decode && length > 0 && this->block[start + length - 1] == '\r') {
+            length--;
+        }
+
+        // An empty line ends the header section.
+        if (length == 0) {
+            break;
+        }
+
+        // Lines without a key/value separator are ignored.
+        const unsigned char* line = &this->block[start];
+        const unsigned char* separator = (const unsigned char*) memchr(line, ':', length);
+        if (separator != NULL) {
+            HeaderView view;
+            view.name = start;
+            view.nameLength = (std::size_t) (separator - line);
+            view.value = start + view.nameLength + 1;
+            view.valueLength = length - view.nameLength - 1;
+            this->headers.push_back(view);
+        }
+    }
+
+    // Only the first occurrence of a repeated header is kept.
+    Properties& properties = frame.getProperties();
+    const char* data = reinterpret_cast<const char*>(&this->block[0]);
+    for (std::size_t ix = 0; ix < this->headers.size(); ++ix) {
+
+        const HeaderView& view = this->headers[ix];
+
+        if (decode) {
+            std::string name = decodeHeader(data + view.name, view.nameLength);
+            if (!properties.hasProperty(name)) {
+                properties.setProperty(name, decodeHeader(data + view.value, view.valueLength));
+            }
+        } else {
+            std::string name(data + view.name, view.nameLength);
+            if (!properties.hasProperty(name)) {
+                properties.setProperty(name, std::string(data + view.value, view.valueLength));
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameParser::readBody(DataInputStream* in, const DirectInputBuffer::Window& window, StompFrame& frame) {
+
+    std::vector<unsigned char>& body = frame.getBody();
+    body.clear();
+
+    unsigned int contentLength = 0;
+
+    if (frame.hasProperty(StompCommandConstants::HEADER_CONTENTLENGTH)) {
+        string length = frame.getProperty(StompCommandConstants::HEADER_CONTENTLENGTH);
+        contentLength = (unsigned int) Integer::parseInt(length);
+    }
+
+    if (contentLength != 0) {
+
+        // Content length doesn't count the trailing null that ends the frame.
+        body.resize((std::size_t) contentLength);
+        in->readFully(&body[0], (int) body.size());
+
+        if (in->readByte() != '\0') {
+            throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompBody: "
+                    "Read Content Length, and no trailing null");
+        }
+
+    } else {
+
+        // Content length was either zero, or not set, so read up to and
+        // including the first null.
+        readUntil(in, window, '\0', body);
+    }
+}
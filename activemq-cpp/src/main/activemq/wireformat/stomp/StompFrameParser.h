@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEPARSER_H_
+#define _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEPARSER_H_
+
+#include <vector>
+#include <activemq/util/Config.h>
+#include <decaf/io/DataInputStream.h>
+
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    class StompFrame;
+
+    /**
+     * Reads Stomp Frames from a DataInputStream by scanning whole runs of the
+     * stream's buffered bytes for the line and frame terminators rather than
+     * reading each byte through the stream.
+     *
+     * The command line and header section of a Frame are gathered into a single
+     * block that is reused from one Frame to the next, each header is located as
+     * a view into that block and is only copied once, into the Frame's properties.
+     * When the stream is not backed by an internal array the bytes are read one
+     * at a time so that nothing past the end of the Frame is consumed.
+     *
+     * A parser is not thread safe, it is meant to be used by the one thread that
+     * reads Frames from a given stream.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API StompFrameParser {
+    private:
+
+        // Location of a header's name and value in the header block.
+        struct HeaderView {
+            std::size_t name;
+            std::size_t nameLength;
+            std::size_t value;
+            std::size_t valueLength;
+        };
+
+        // The command line and header lines of the Frame being read, with their
+        // line terminators.
+        std::vector<unsigned char> block;
+
+        // The headers found in the block, in the order they were read.
+        std::vector<HeaderView> headers;
+
+        // Whether header names and values are unescaped, as STOMP 1.1 and later require.
+        bool decodeHeaders;
+
+    private:
+
+        StompFrameParser(const StompFrameParser&);
+        StompFrameParser& operator=(const StompFrameParser&);
+
+    public:
+
+        StompFrameParser();
+
+        virtual ~StompFrameParser();
+
+        /**
+         * Reads the next Frame from the stream into the given Frame, which is
+         * expected to be empty.
+         *
+         * @param in
+         *      The stream to read the Frame from.
+         * @param frame
+         *      The Frame that receives the command, headers and body read.
+         *
+         * @throw IOException if an error occurs while reading the Frame.
+         */
+        void parse(decaf::io::DataInputStream* in, StompFrame& frame);
+
+        /**
+         * Reads the next Frame from the stream into the given Frame, unless the
+         * stream holds a heart-beat first.  A line holding nothing but white space
+         * before a Frame is a heart-beat and is consumed on its own, while a line
+         * end that directly follows a Frame's null and is already buffered is read
+         * along with the Frame.
+         *
+         * @param in
+         *      The stream to read the Frame from.
+         * @param frame
+         *      The Frame that receives the command, headers and body read.
+         *
+         * @return true if a Frame was read, false if a heart-beat was read.
+         *
+         * @throw IOException if an error occurs while reading the Frame.
+         */
+        bool parseFrameOrHeartBeat(decaf::io::DataInputStream* in, StompFrame& frame);
+
+        /**
+         * Sets whether the backslash escapes in header names and values are decoded,
+         * STOMP 1.1 and later escape the headers of every Frame except CONNECTED.
+         *
+         * @param decodeHeaders
+         *      True if header escapes are decoded.
+         */
+        void setDecodeHeaders(bool decodeHeaders) {
+            this->decodeHeaders = decodeHeaders;
+        }
+
+        /**
+         * @return true if header escapes are decoded.
+         */
+        bool isDecodeHeaders() const {
+            return this->decodeHeaders;
+        }
+
+    private:
+
+        /**
+         * Appends bytes from the stream to the target up to and including the
+         * first occurrence of the delimiter.
+         *
+         * @return the number of bytes appended.
+         */
+        std::size_t readUntil(decaf::io::DataInputStream* in,
+                              const decaf::internal::io::DirectInputBuffer::Window& window,
+                              unsigned char delimiter, std::vector<unsigned char>& target);
+
+        /**
+         * Reads the next line as the Frame's command.
+         *
+         * @return false if the line held only white space and no command was read.
+         */
+        bool readCommand(decaf::io::DataInputStream* in,
+                         const decaf::internal::io::DirectInputBuffer::Window& window,
+                         StompFrame& frame);
+
+        void readHeaders(decaf::io::DataInputStream* in,
+                         const decaf::internal::io::DirectInputBuffer::Window& window,
+                         StompFrame& frame);
+
+        void readBody(decaf::io::DataInputStream* in,
+                      const decaf::internal::io::DirectInputBuffer::Window& window,
+                      StompFrame& frame);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEPARSER_H_ */
@@ -20,6 +20,7 @@
 #include <activemq/wireformat/stomp/StompWireFormat.h>
 #include <activemq/wireformat/stomp/StompCommandConstants.h>
 #include <activemq/commands/LocalTransactionId.h>
+#include <activemq/core/ActiveMQConstants.h>
 
 #include <decaf/util/StringTokenizer.h>
 #include <decaf/lang/Integer.h>
@@ -29,6 +30,7 @@
 using namespace std;
 using namespace activemq;
 using namespace activemq::commands;
+using namespace activemq::core;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::stomp;
 using namespace decaf;
@@ -66,7 +68,7 @@ namespace {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-StompHelper::StompHelper(StompWireFormat* wireformat) : messageIdGenerator(), wireFormat(wireformat) {
+StompHelper::StompHelper(StompWireFormat* wireformat) : messageIdGenerator(), destinations(), wireFormat(wireformat) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -186,6 +188,34 @@ void StompHelper::convertProperties(const Pointer<Message>& message, const Point
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void StompHelper::convertAck(const Pointer<MessageAck>& ack, const Pointer<StompFrame>& frame) {
+
+    const std::string version = this->wireFormat->getProtocolVersion();
+    const std::string messageId = convertMessageId(ack->getLastMessageId());
+
+    if (version == StompCommandConstants::VERSION_1_0) {
+        frame->setCommand(StompCommandConstants::ACK);
+        frame->setProperty(StompCommandConstants::HEADER_MESSAGEID, messageId);
+        return;
+    }
+
+    if (ack->getAckType() == ActiveMQConstants::ACK_TYPE_POISON) {
+        frame->setCommand(StompCommandConstants::NACK);
+    } else {
+        frame->setCommand(StompCommandConstants::ACK);
+    }
+
+    // STOMP 1.1 names the message and its subscription, 1.2 replaces both with the
+    // MESSAGE Frame's ack id, which the Broker sets to the message id.
+    frame->setProperty(StompCommandConstants::HEADER_MESSAGEID, messageId);
+    frame->setProperty(StompCommandConstants::HEADER_SUBSCRIPTION, convertConsumerId(ack->getConsumerId()));
+
+    if (version != StompCommandConstants::VERSION_1_1) {
+        frame->setProperty(StompCommandConstants::HEADER_ID, messageId);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string StompHelper::convertDestination(const Pointer<ActiveMQDestination>& destination) {
 
@@ -242,7 +272,8 @@ Pointer<ActiveMQDestination> StompHelper::convertDestination(const std::string&
         type = cms::Destination::TEMPORARY_QUEUE;
     }
 
-    return ActiveMQDestination::createDestination(type, dest);
+    // Every MESSAGE frame names its destination, only parse each one once.
+    return destinations.lookup(type, dest);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
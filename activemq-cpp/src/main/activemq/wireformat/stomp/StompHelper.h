@@ -20,8 +20,10 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/util/LongSequenceGenerator.h>
+#include <activemq/util/DestinationCache.h>
 #include <activemq/wireformat/stomp/StompFrame.h>
 #include <activemq/commands/Message.h>
+#include <activemq/commands/MessageAck.h>
 #include <activemq/commands/MessageId.h>
 #include <activemq/commands/ProducerId.h>
 #include <activemq/commands/ConsumerId.h>
@@ -37,6 +39,7 @@ namespace stomp {
 
     using decaf::lang::Pointer;
     using activemq::commands::Message;
+    using activemq::commands::MessageAck;
     using activemq::commands::MessageId;
     using activemq::commands::ProducerId;
     using activemq::commands::ConsumerId;
@@ -52,6 +55,7 @@ namespace stomp {
     private:
 
         activemq::util::LongSequenceGenerator messageIdGenerator;
+        activemq::util::DestinationCache destinations;
         StompWireFormat* wireFormat;
 
     private:
@@ -85,6 +89,16 @@ namespace stomp {
          */
         void convertProperties(const Pointer<Message>& message, const Pointer<StompFrame>& frame);
 
+        /**
+         * Sets the command and message headers of a Frame that acknowledges the given
+         * MessageAck.  A poison ack becomes a NACK once a version that has NACK is in
+         * use, every other ack or any ack under STOMP 1.0 is sent as an ACK.
+         *
+         * @param ack - The MessageAck to convert.
+         * @param frame - The frame that is sent for the ack.
+         */
+        void convertAck(const Pointer<MessageAck>& ack, const Pointer<StompFrame>& frame);
+
         /**
          * Converts from a Stomp Destination to an ActiveMQDestination
          *
@@ -18,6 +18,8 @@
 #include "StompWireFormat.h"
 
 #include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameParser.h>
+#include <activemq/wireformat/stomp/StompWireFormatNegotiator.h>
 #include <activemq/wireformat/stomp/StompHelper.h>
 #include <activemq/wireformat/stomp/StompCommandConstants.h>
 #include <activemq/core/ActiveMQConstants.h>
@@ -32,6 +34,7 @@
 #include <activemq/commands/ConnectionInfo.h>
 #include <activemq/commands/ConsumerId.h>
 #include <activemq/commands/ExceptionResponse.h>
+#include <activemq/commands/KeepAliveInfo.h>
 #include <activemq/commands/ShutdownInfo.h>
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/commands/TransactionInfo.h>
@@ -44,6 +47,7 @@
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Long.h>
+#include <decaf/lang/Math.h>
 #include <decaf/lang/exceptions/ClassCastException.h>
 #include <decaf/io/IOException.h>
 #include <decaf/io/ByteArrayOutputStream.h>
@@ -83,13 +87,40 @@ namespace stomp {
         // Prefix used to address Temporary Queues (default is /temp-queue/
         std::string tempQueuePrefix;
 
+        // Reads incoming Frames, kept so its buffers are reused from one Frame to the next.
+        StompFrameParser parser;
+
+        // Versions offered in the CONNECT Frame (default is 1.0)
+        std::string acceptVersion;
+
+        // Heart-beat intervals offered in the CONNECT Frame, zero for none.
+        long long heartBeatSendInterval;
+        long long heartBeatReceiveInterval;
+
+        // Version and heart-beat intervals agreed on in the CONNECTED Frame.
+        std::string version;
+        long long negotiatedSendInterval;
+        long long negotiatedReceiveInterval;
+
+    private:
+
+        StompWireformatProperties(const StompWireformatProperties&);
+        StompWireformatProperties& operator=(const StompWireformatProperties&);
+
     public:
 
         StompWireformatProperties() : connectResponseId(-1),
                                       topicPrefix("/topic/"),
                                       queuePrefix("/queue/"),
                                       tempTopicPrefix("/temp-topic/"),
-                                      tempQueuePrefix("/temp-queue/") {
+                                      tempQueuePrefix("/temp-queue/"),
+                                      parser(),
+                                      acceptVersion(StompCommandConstants::VERSION_1_0),
+                                      heartBeatSendInterval(0),
+                                      heartBeatReceiveInterval(0),
+                                      version(StompCommandConstants::VERSION_1_0),
+                                      negotiatedSendInterval(0),
+                                      negotiatedReceiveInterval(0) {
 
         }
 
@@ -125,6 +156,13 @@ void StompWireFormat::marshal(const Pointer<Command> command,
                     "output stream is NULL");
         }
 
+        // A heart-beat is a single line end between Frames.
+        if (command->isKeepAliveInfo()) {
+            out->write('\n');
+            out->flush();
+            return;
+        }
+
         Pointer<StompFrame> frame;
 
         if (command->isMessage()) {
@@ -162,8 +200,9 @@ void StompWireFormat::marshal(const Pointer<Command> command,
             return;
         }
 
-        // Let the Frame write itself to the output stream
-        frame->toStream(out);
+        // Let the Frame write itself to the output stream, every version after 1.0
+        // escapes the headers.
+        frame->toStream(out, this->properties->version != StompCommandConstants::VERSION_1_0);
     }
     AMQ_CATCH_RETHROW( decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT( decaf::lang::Exception, decaf::io::IOException)
@@ -188,8 +227,14 @@ Pointer<Command> StompWireFormat::unmarshal(const activemq::transport::Transport
         // Create a new Frame for reading to.
         frame.reset(new StompFrame());
 
-        // Read the command header.
-        frame->fromStream(in);
+        // Read the next Frame, heart-beats are only passed on once they were agreed on.
+        if (this->properties->negotiatedReceiveInterval > 0) {
+            if (!this->properties->parser.parseFrameOrHeartBeat(in, *frame)) {
+                return Pointer<Command>(new KeepAliveInfo());
+            }
+        } else {
+            this->properties->parser.parse(in, *frame);
+        }
 
         // Return the Command.
         const std::string commandId = frame->getCommand();
@@ -235,12 +280,22 @@ Pointer<Command> StompWireFormat::unmarshal(const activemq::transport::Transport
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<transport::Transport> StompWireFormat::createNegotiator(const Pointer<transport::Transport> transport AMQCPP_UNUSED) {
+bool StompWireFormat::hasNegotiator() const {
+    return this->properties->heartBeatSendInterval > 0 || this->properties->heartBeatReceiveInterval > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<transport::Transport> StompWireFormat::createNegotiator(const Pointer<transport::Transport> transport) {
 
-    throw UnsupportedOperationException(__FILE__, __LINE__, "No Negotiator is required to use this WireFormat.");
+    if (!hasNegotiator()) {
+        throw UnsupportedOperationException(__FILE__, __LINE__, "No Negotiator is required to use this WireFormat.");
+    }
 
-    // Apparently HP's aCC compiler is even dumber than Sun's
-    return Pointer<transport::Transport>();
+    try {
+        return Pointer<transport::Transport>(new StompWireFormatNegotiator(this, transport));
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCHALL_THROW(UnsupportedOperationException)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -296,7 +351,35 @@ Pointer<Command> StompWireFormat::unmarshalReceipt(const Pointer<StompFrame> fra
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<Command> StompWireFormat::unmarshalConnected(const Pointer<StompFrame> frame AMQCPP_UNUSED) {
+Pointer<Command> StompWireFormat::unmarshalConnected(const Pointer<StompFrame> frame) {
+
+    // A Broker that leaves out the version only speaks 1.0.
+    std::string version = frame->getProperty(StompCommandConstants::HEADER_VERSION, StompCommandConstants::VERSION_1_0);
+
+    if (version != StompCommandConstants::VERSION_1_0) {
+
+        this->properties->version = version;
+        this->properties->parser.setDecodeHeaders(true);
+
+        // Each side sends at the slower of what it can do and what the other side
+        // wants, and not at all if either of them is zero.
+        std::string heartBeat = frame->getProperty(StompCommandConstants::HEADER_HEARTBEAT, "0,0");
+        std::size_t separator = heartBeat.find(',');
+        if (separator == std::string::npos) {
+            throw IOException(__FILE__, __LINE__, "Error, Connected Command has an invalid heart-beat: %s", heartBeat.c_str());
+        }
+
+        long long brokerSend = Long::parseLong(heartBeat.substr(0, separator));
+        long long brokerReceive = Long::parseLong(heartBeat.substr(separator + 1));
+
+        if (this->properties->heartBeatSendInterval > 0 && brokerReceive > 0) {
+            this->properties->negotiatedSendInterval = Math::max(this->properties->heartBeatSendInterval, brokerReceive);
+        }
+
+        if (this->properties->heartBeatReceiveInterval > 0 && brokerSend > 0) {
+            this->properties->negotiatedReceiveInterval = Math::max(this->properties->heartBeatReceiveInterval, brokerSend);
+        }
+    }
 
     Pointer<Response> response(new Response());
 
@@ -366,12 +449,8 @@ Pointer<StompFrame> StompWireFormat::marshalMessage(const Pointer<Command> comma
 
     try {
         Pointer<ActiveMQBytesMessage> bytesMessage = message.dynamicCast<ActiveMQBytesMessage>();
-        unsigned char* bodyBytes = bytesMessage->getBodyBytes();
-        frame->setBody(bodyBytes, bytesMessage->getBodyLength());
+        frame->setBody(bytesMessage->getBodyBuffer(), bytesMessage->getBodyLength());
         frame->setProperty(StompCommandConstants::HEADER_CONTENTLENGTH, Long::toString(bytesMessage->getBodyLength()));
-        if (bodyBytes) {
-            delete [] bodyBytes;
-        }
         return frame;
     } catch (ClassCastException& ex) {
     }
@@ -385,16 +464,13 @@ Pointer<StompFrame> StompWireFormat::marshalAck(const Pointer<Command> command)
     Pointer<MessageAck> ack = command.dynamicCast<MessageAck>();
 
     Pointer<StompFrame> frame(new StompFrame());
-    frame->setCommand(StompCommandConstants::ACK);
+    helper->convertAck(ack, frame);
 
     if (command->isResponseRequired()) {
         frame->setProperty(StompCommandConstants::HEADER_RECEIPT_REQUIRED,
                            std::string("ignore:") + Integer::toString(command->getCommandId()));
     }
 
-    frame->setProperty(StompCommandConstants::HEADER_MESSAGEID,
-        helper->convertMessageId(ack->getLastMessageId()));
-
     if (ack->getTransactionId() != NULL) {
         frame->setProperty(StompCommandConstants::HEADER_TRANSACTIONID,
                            helper->convertTransactionId(ack->getTransactionId()));
@@ -414,6 +490,16 @@ Pointer<StompFrame> StompWireFormat::marshalConnectionInfo(const Pointer<Command
     frame->setProperty(StompCommandConstants::HEADER_LOGIN, info->getUserName());
     frame->setProperty(StompCommandConstants::HEADER_PASSWORD, info->getPassword());
 
+    if (this->properties->acceptVersion != StompCommandConstants::VERSION_1_0) {
+        frame->setProperty(StompCommandConstants::HEADER_ACCEPT_VERSION, this->properties->acceptVersion);
+    }
+
+    if (hasNegotiator()) {
+        frame->setProperty(StompCommandConstants::HEADER_HEARTBEAT,
+                           Long::toString(this->properties->heartBeatSendInterval) + "," +
+                           Long::toString(this->properties->heartBeatReceiveInterval));
+    }
+
     this->properties->connectResponseId = info->getCommandId();
 
     // Store this for later.
@@ -601,3 +687,48 @@ std::string StompWireFormat::getTempQueuePrefix() const {
 void StompWireFormat::setTempQueuePrefix(const std::string& prefix) {
     this->properties->tempQueuePrefix = prefix;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+std::string StompWireFormat::getAcceptVersion() const {
+    return this->properties->acceptVersion;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::setAcceptVersion(const std::string& acceptVersion) {
+    this->properties->acceptVersion = acceptVersion;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getHeartBeatSendInterval() const {
+    return this->properties->heartBeatSendInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::setHeartBeatSendInterval(long long interval) {
+    this->properties->heartBeatSendInterval = interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getHeartBeatReceiveInterval() const {
+    return this->properties->heartBeatReceiveInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::setHeartBeatReceiveInterval(long long interval) {
+    this->properties->heartBeatReceiveInterval = interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string StompWireFormat::getProtocolVersion() const {
+    return this->properties->version;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getNegotiatedSendInterval() const {
+    return this->properties->negotiatedSendInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getNegotiatedReceiveInterval() const {
+    return this->properties->negotiatedReceiveInterval;
+}
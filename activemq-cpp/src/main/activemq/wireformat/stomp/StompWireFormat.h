@@ -171,6 +171,80 @@ namespace stomp {
          */
         void setTempQueuePrefix(const std::string& prefix);
 
+        /**
+         * Gets the comma separated list of STOMP versions offered to the Broker in the
+         * accept-version header of the CONNECT Frame.
+         *
+         * @return the versions offered to the Broker, "1.0" by default.
+         */
+        std::string getAcceptVersion() const;
+
+        /**
+         * Sets the comma separated list of STOMP versions offered to the Broker, with
+         * only "1.0" no accept-version header is sent.
+         *
+         * @param acceptVersion
+         *      The versions to offer, for example "1.0,1.1,1.2".
+         */
+        void setAcceptVersion(const std::string& acceptVersion);
+
+        /**
+         * Gets the smallest number of milliseconds between the heart-beats this client
+         * can send, zero if it sends none.
+         *
+         * @return the heart-beat send interval offered in milliseconds.
+         */
+        long long getHeartBeatSendInterval() const;
+
+        /**
+         * Sets the smallest number of milliseconds between the heart-beats this client
+         * can send, the first value of the CONNECT Frame's heart-beat header.
+         *
+         * @param interval
+         *      The interval to offer in milliseconds, zero to send no heart-beats.
+         */
+        void setHeartBeatSendInterval(long long interval);
+
+        /**
+         * Gets the number of milliseconds between the heart-beats this client would
+         * like to receive, zero if it wants none.
+         *
+         * @return the heart-beat receive interval asked for in milliseconds.
+         */
+        long long getHeartBeatReceiveInterval() const;
+
+        /**
+         * Sets the number of milliseconds between the heart-beats this client would like
+         * to receive, the second value of the CONNECT Frame's heart-beat header.
+         *
+         * @param interval
+         *      The interval to ask for in milliseconds, zero to receive no heart-beats.
+         */
+        void setHeartBeatReceiveInterval(long long interval);
+
+        /**
+         * Gets the STOMP version that the Broker chose in its CONNECTED Frame.
+         *
+         * @return the version in use, "1.0" until a Broker picks a later one.
+         */
+        std::string getProtocolVersion() const;
+
+        /**
+         * Gets the number of milliseconds between heart-beats that was agreed on for
+         * this client to send, zero when it sends none.
+         *
+         * @return the negotiated send interval in milliseconds.
+         */
+        long long getNegotiatedSendInterval() const;
+
+        /**
+         * Gets the number of milliseconds between heart-beats that was agreed on for
+         * the Broker to send, zero when it sends none.
+         *
+         * @return the negotiated receive interval in milliseconds.
+         */
+        long long getNegotiatedReceiveInterval() const;
+
         /**
          * Is there a Message being unmarshaled?
          *
@@ -182,12 +256,10 @@ namespace stomp {
 
         /**
          * Returns true if this WireFormat has a Negotiator that needs to wrap the
-         * Transport that uses it.
+         * Transport that uses it, which is the case when heart-beats are asked for.
          * @return true if the WireFormat provides a Negotiator.
          */
-        virtual bool hasNegotiator() const {
-            return false;
-        }
+        virtual bool hasNegotiator() const;
 
         /**
          * If the Transport Provides a Negotiator this method will create and return
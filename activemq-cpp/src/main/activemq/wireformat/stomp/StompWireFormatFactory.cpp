@@ -18,12 +18,14 @@
 #include "StompWireFormatFactory.h"
 
 #include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/Long.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::stomp;
 using namespace activemq::exceptions;
+using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<WireFormat> StompWireFormatFactory::createWireFormat(const decaf::util::Properties& properties AMQCPP_UNUSED) {
@@ -40,9 +42,16 @@ Pointer<WireFormat> StompWireFormatFactory::createWireFormat(const decaf::util::
             properties.getProperty("wireFormat.tempTopicPrefix", "/temp-topic/"));
         wireFormat->setTempQueuePrefix(
             properties.getProperty("wireFormat.tempQueuePrefix", "/temp-queue/"));
+        wireFormat->setAcceptVersion(
+            properties.getProperty("wireFormat.acceptVersion", "1.0"));
+        wireFormat->setHeartBeatSendInterval(
+            Long::parseLong(properties.getProperty("wireFormat.heartBeatSendInterval", "0")));
+        wireFormat->setHeartBeatReceiveInterval(
+            Long::parseLong(properties.getProperty("wireFormat.heartBeatReceiveInterval", "0")));
 
         return wireFormat;
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, ActiveMQException)
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompWireFormatNegotiator.h"
+
+#include <activemq/wireformat/stomp/StompWireFormat.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Math.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/TimerTask.h>
+#include <decaf/util/concurrent/Concurrent.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    class StompHeartBeatWriteTask : public TimerTask {
+    private:
+
+        StompWireFormatNegotiator* parent;
+
+    private:
+
+        StompHeartBeatWriteTask(const StompHeartBeatWriteTask&);
+        StompHeartBeatWriteTask& operator=(const StompHeartBeatWriteTask&);
+
+    public:
+
+        StompHeartBeatWriteTask(StompWireFormatNegotiator* parent) : TimerTask(), parent(parent) {}
+
+        virtual void run() {
+            this->parent->writeCheck();
+        }
+    };
+
+    class StompHeartBeatReadTask : public TimerTask {
+    private:
+
+        StompWireFormatNegotiator* parent;
+        long long interval;
+
+    private:
+
+        StompHeartBeatReadTask(const StompHeartBeatReadTask&);
+        StompHeartBeatReadTask& operator=(const StompHeartBeatReadTask&);
+
+    public:
+
+        StompHeartBeatReadTask(StompWireFormatNegotiator* parent, long long interval) :
+            TimerTask(), parent(parent), interval(interval) {}
+
+        virtual void run() {
+            this->parent->readCheck(this->interval);
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+StompWireFormatNegotiator::StompWireFormatNegotiator(StompWireFormat* wireFormat, const Pointer<Transport> next) :
+    WireFormatNegotiator(next),
+    wireFormat(wireFormat),
+    timer(),
+    monitoring(),
+    stopped(),
+    commandSent(),
+    commandReceived(true),
+    mutex() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompWireFormatNegotiator::~StompWireFormatNegotiator() {
+    try {
+        stopHeartBeats();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::oneway(const Pointer<Command> command) {
+
+    try {
+        checkClosed();
+        this->next->oneway(command);
+        this->commandSent.set(true);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::onCommand(const Pointer<Command> command) {
+
+    this->commandReceived.set(true);
+
+    // Heart-beats only matter to the read check.
+    if (command->isKeepAliveInfo()) {
+        return;
+    }
+
+    // The CONNECTED Frame comes back as a Response, start before passing it on so
+    // the first heart-beat is not late.
+    if (command->isResponse() && !this->monitoring.get()) {
+        if (this->wireFormat->getNegotiatedSendInterval() > 0 || this->wireFormat->getNegotiatedReceiveInterval() > 0) {
+            startHeartBeats();
+        }
+    }
+
+    TransportFilter::onCommand(command);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::onException(const decaf::lang::Exception& ex) {
+
+    stopHeartBeats();
+    TransportFilter::onException(ex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::afterNextIsStopped() {
+    stopHeartBeats();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::doClose() {
+    stopHeartBeats();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::startHeartBeats() {
+
+    synchronized(&this->mutex) {
+
+        if (this->stopped.get() || !this->monitoring.compareAndSet(false, true)) {
+            return;
+        }
+
+        this->timer.reset(new Timer("StompWireFormatNegotiator Heart-Beat Timer"));
+
+        // Checking twice per interval keeps the gap between writes within it.
+        long long sendInterval = this->wireFormat->getNegotiatedSendInterval();
+        if (sendInterval > 0) {
+            long long period = Math::max(sendInterval / 2, 1LL);
+            this->timer->schedule(new StompHeartBeatWriteTask(this), period, period);
+        }
+
+        // Allow the Broker's heart-beats twice the interval to arrive.
+        long long receiveInterval = this->wireFormat->getNegotiatedReceiveInterval();
+        if (receiveInterval > 0) {
+            this->commandReceived.set(true);
+            this->timer->schedule(new StompHeartBeatReadTask(this, receiveInterval * 2), receiveInterval * 2, receiveInterval * 2);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::stopHeartBeats() {
+
+    synchronized(&this->mutex) {
+
+        this->stopped.set(true);
+
+        if (this->monitoring.compareAndSet(true, false)) {
+            this->timer->cancel();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::writeCheck() {
+
+    if (this->commandSent.compareAndSet(true, false)) {
+        return;
+    }
+
+    try {
+        oneway(Pointer<Command>(new KeepAliveInfo()));
+    } catch (IOException& ex) {
+        onException(ex);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::readCheck(long long interval) {
+
+    if (this->commandReceived.compareAndSet(true, false)) {
+        return;
+    }
+
+    IOException ex(__FILE__, __LINE__, "No heart-beat received for %lld milliseconds from: %s",
+                   interval, this->next->getRemoteAddress().c_str());
+    onException(ex);
+}
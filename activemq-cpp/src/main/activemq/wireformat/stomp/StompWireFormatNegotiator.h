@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_
+#define _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/wireformat/WireFormatNegotiator.h>
+#include <decaf/util/Timer.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    using decaf::lang::Pointer;
+
+    class StompWireFormat;
+    class StompHeartBeatWriteTask;
+    class StompHeartBeatReadTask;
+
+    /**
+     * Keeps a STOMP 1.1 or later connection alive with the heart-beats agreed on in
+     * the CONNECT and CONNECTED Frames.  Once the Broker's CONNECTED Frame arrives a
+     * single Timer thread sends a line end whenever nothing else was written during
+     * the send interval, and fails the Transport when nothing at all was read for
+     * twice the receive interval.  Heart-beats read from the Broker are dropped here
+     * and never reach the layers above.
+     *
+     * @since 3.9.5
+     */
+    class AMQCPP_API StompWireFormatNegotiator : public wireformat::WireFormatNegotiator {
+    private:
+
+        // The WireFormat that holds the negotiated heart-beat intervals.
+        StompWireFormat* wireFormat;
+
+        // Runs the heart-beat checks, only created once heart-beats are agreed on.
+        Pointer<decaf::util::Timer> timer;
+
+        decaf::util::concurrent::atomic::AtomicBoolean monitoring;
+        decaf::util::concurrent::atomic::AtomicBoolean stopped;
+
+        decaf::util::concurrent::atomic::AtomicBoolean commandSent;
+        decaf::util::concurrent::atomic::AtomicBoolean commandReceived;
+
+        decaf::util::concurrent::Mutex mutex;
+
+    private:
+
+        StompWireFormatNegotiator(const StompWireFormatNegotiator&);
+        StompWireFormatNegotiator& operator=(const StompWireFormatNegotiator&);
+
+    public:
+
+        /**
+         * Creates a new Negotiator that runs the heart-beats of the given WireFormat.
+         *
+         * @param wireFormat - The WireFormat whose CONNECTED Frame sets the intervals.
+         * @param next - The next transport in the chain
+         */
+        StompWireFormatNegotiator(StompWireFormat* wireFormat, const Pointer<transport::Transport> next);
+
+        virtual ~StompWireFormatNegotiator();
+
+        virtual void oneway(const Pointer<commands::Command> command);
+
+    public:
+
+        virtual void onCommand(const Pointer<commands::Command> command);
+
+        virtual void onException(const decaf::lang::Exception& ex);
+
+    protected:
+
+        virtual void afterNextIsStopped();
+
+        virtual void doClose();
+
+    private:
+
+        void startHeartBeats();
+
+        void stopHeartBeats();
+
+        void writeCheck();
+
+        void readCheck(long long interval);
+
+        friend class StompHeartBeatWriteTask;
+        friend class StompHeartBeatReadTask;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_ */
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CMS_BATCHMESSAGECONSUMER_H_
+#define _CMS_BATCHMESSAGECONSUMER_H_
+
+#include <cms/Config.h>
+#include <cms/MessageConsumer.h>
+#include <cms/Message.h>
+
+#include <vector>
+
+namespace cms {
+
+    /**
+     * An enhanced CMS MessageConsumer that can hand several messages to the client
+     * in a single call.  Clients that poll a consumer in a tight loop can use it to
+     * amortize the per call overhead of the provider, for instance the CMS Provider
+     * can remove all of the returned messages from its internal queue at once and
+     * acknowledge them together.
+     *
+     * A batch receive obeys the acknowledgement mode of the Session exactly as if
+     * each returned Message had been received with a separate call to receive.
+     *
+     * @since 3.9.5
+     */
+    class CMS_API BatchMessageConsumer : public virtual cms::MessageConsumer {
+    public:
+
+        virtual ~BatchMessageConsumer();
+
+        using MessageConsumer::receive;
+
+        /**
+         * Synchronously Receive up to maxMessages Messages.  The call waits up to the
+         * given number of milliseconds for the first Message, a value of zero waits
+         * until one arrives and a negative value does not wait at all.  Once a Message
+         * is available any others that are already waiting are returned along with it
+         * without further waiting.
+         *
+         * @param maxMessages
+         *      The maximum number of Messages to return, must be greater than zero.
+         * @param millisecs
+         *      The time to wait for the first Message.
+         *
+         * @return the received messages, which the caller owns and must delete, the
+         *         vector is empty if nothing was read.
+         *
+         * @throws CMSException - If an internal error occurs.
+         */
+        virtual std::vector<Message*> receive(int maxMessages, int millisecs) = 0;
+
+    };
+
+}
+
+#endif /* _CMS_BATCHMESSAGECONSUMER_H_ */
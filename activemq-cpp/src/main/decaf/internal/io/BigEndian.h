@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_BIGENDIAN_H_
+#define _DECAF_INTERNAL_IO_BIGENDIAN_H_
+
+#include <decaf/util/Config.h>
+
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#define DECAF_BSWAP16(x) _byteswap_ushort(x)
+#define DECAF_BSWAP32(x) _byteswap_ulong(x)
+#define DECAF_BSWAP64(x) _byteswap_uint64(x)
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)))
+#define DECAF_BSWAP16(x) __builtin_bswap16(x)
+#define DECAF_BSWAP32(x) __builtin_bswap32(x)
+#define DECAF_BSWAP64(x) __builtin_bswap64(x)
+#endif
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    /**
+     * Loads and stores the big endian primitives of the DataInput and DataOutput
+     * formats at unaligned addresses, using a single load or store and the
+     * compiler's byte swap intrinsic where one is available.
+     *
+     * @since 3.9.5
+     */
+    class BigEndian {
+    private:
+
+        BigEndian();
+        BigEndian(const BigEndian&);
+        BigEndian& operator= (const BigEndian&);
+
+    public:
+
+        static inline unsigned short load16(const unsigned char* bytes) {
+#if defined(DECAF_BSWAP16) && !defined(WORDS_BIGENDIAN)
+            unsigned short value;
+            memcpy(&value, bytes, sizeof(value));
+            return DECAF_BSWAP16(value);
+#else
+            return (unsigned short) (bytes[0] << 8 | bytes[1]);
+#endif
+        }
+
+        static inline unsigned int load32(const unsigned char* bytes) {
+#if defined(DECAF_BSWAP32) && !defined(WORDS_BIGENDIAN)
+            unsigned int value;
+            memcpy(&value, bytes, sizeof(value));
+            return DECAF_BSWAP32(value);
+#else
+            return (unsigned int) bytes[0] << 24 | (unsigned int) bytes[1] << 16 |
+                   (unsigned int) bytes[2] << 8 | (unsigned int) bytes[3];
+#endif
+        }
+
+        static inline unsigned long long load64(const unsigned char* bytes) {
+#if defined(DECAF_BSWAP64) && !defined(WORDS_BIGENDIAN)
+            unsigned long long value;
+            memcpy(&value, bytes, sizeof(value));
+            return DECAF_BSWAP64(value);
+#else
+            return (unsigned long long) load32(bytes) << 32 | load32(bytes + 4);
+#endif
+        }
+
+        static inline void store16(unsigned char* bytes, unsigned short value) {
+#if defined(DECAF_BSWAP16) && !defined(WORDS_BIGENDIAN)
+            value = DECAF_BSWAP16(value);
+            memcpy(bytes, &value, sizeof(value));
+#else
+            bytes[0] = (unsigned char) (value >> 8);
+            bytes[1] = (unsigned char) value;
+#endif
+        }
+
+        static inline void store32(unsigned char* bytes, unsigned int value) {
+#if defined(DECAF_BSWAP32) && !defined(WORDS_BIGENDIAN)
+            value = DECAF_BSWAP32(value);
+            memcpy(bytes, &value, sizeof(value));
+#else
+            bytes[0] = (unsigned char) (value >> 24);
+            bytes[1] = (unsigned char) (value >> 16);
+            bytes[2] = (unsigned char) (value >> 8);
+            bytes[3] = (unsigned char) value;
+#endif
+        }
+
+        static inline void store64(unsigned char* bytes, unsigned long long value) {
+#if defined(DECAF_BSWAP64) && !defined(WORDS_BIGENDIAN)
+            value = DECAF_BSWAP64(value);
+            memcpy(bytes, &value, sizeof(value));
+#else
+            store32(bytes, (unsigned int) (value >> 32));
+            store32(bytes + 4, (unsigned int) value);
+#endif
+        }
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_BIGENDIAN_H_ */
@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_DIRECTINPUTBUFFER_H_
+#define _DECAF_INTERNAL_IO_DIRECTINPUTBUFFER_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    /**
+     * Implemented by input streams that read from an internal array so that a
+     * DataInputStream wrapped around them can decode primitives straight out of
+     * that array instead of copying each one out through a read call.
+     *
+     * @since 3.9.5
+     */
+    class DECAF_API DirectInputBuffer {
+    public:
+
+        /**
+         * Addresses of the stream's own fields, the next unread byte is at
+         * (*array)[*position] and the readable bytes end at *limit.  The fields
+         * are read each time so the view follows the stream as it refills or
+         * moves its array, an array of NULL means the stream is closed.  A reader
+         * that takes bytes from the array advances *position past them.
+         */
+        struct Window {
+            const unsigned char* const* array;
+            int* position;
+            const int* limit;
+        };
+
+    public:
+
+        virtual ~DirectInputBuffer();
+
+        /**
+         * @return the view of this stream's internal array, valid for the life
+         *         of the stream.
+         */
+        virtual Window getDirectInputWindow() = 0;
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_DIRECTINPUTBUFFER_H_ */
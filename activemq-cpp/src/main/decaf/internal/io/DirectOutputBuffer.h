@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_DIRECTOUTPUTBUFFER_H_
+#define _DECAF_INTERNAL_IO_DIRECTOUTPUTBUFFER_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    /**
+     * Implemented by output streams that collect written bytes in an internal
+     * array so that a DataOutputStream wrapped around them can encode primitives
+     * straight into that array instead of passing each one through a write call.
+     *
+     * @since 3.9.5
+     */
+    class DECAF_API DirectOutputBuffer {
+    public:
+
+        /**
+         * Addresses of the stream's own fields, the next byte is written at
+         * (*array)[*position] and there is room up to *limit.  The fields are
+         * read each time so the view follows the stream as it drains or grows its
+         * array, an array of NULL means the stream is closed.  A writer that
+         * stores bytes into the array advances *position past them.
+         */
+        struct Window {
+            unsigned char* const* array;
+            int* position;
+            const int* limit;
+        };
+
+    public:
+
+        virtual ~DirectOutputBuffer();
+
+        /**
+         * @return the view of this stream's internal array, valid for the life
+         *         of the stream.
+         */
+        virtual Window getDirectOutputWindow() = 0;
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_DIRECTOUTPUTBUFFER_H_ */
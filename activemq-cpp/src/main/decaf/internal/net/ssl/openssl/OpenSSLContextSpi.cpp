@@ -29,6 +29,8 @@
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketException.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketFactory.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLServerSocketFactory.h>
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCache.h>
+#include <decaf/lang/Integer.h>
 
 #ifdef HAVE_STRINGS_H
 #include <strings.h>
@@ -76,6 +78,7 @@ namespace openssl {
         Pointer<ServerSocketFactory> serverSocketFactory;
         Pointer<SecureRandom> random;
         std::string password;
+        OpenSSLSessionCache sessionCache;
 
         static Mutex* locks;
         static std::string defaultCipherList;
@@ -98,6 +101,7 @@ namespace openssl {
                                   serverSocketFactory(),
                                   random(),
                                   password(),
+                                  sessionCache(),
                                   openSSLContext(NULL) {
 
             ContextData::locks = new Mutex[size];
@@ -107,6 +111,8 @@ namespace openssl {
 
 #ifdef HAVE_OPENSSL
             try{
+                // Cached sessions hold a reference to the context so release them first.
+                this->sessionCache.clear();
                 SSL_CTX_free( this->openSSLContext );
             } catch(...) {}
 #endif
@@ -203,6 +209,12 @@ void OpenSSLContextSpi::providerInit( SecureRandom* random ) {
         SSL_CTX_set_options( this->data->openSSLContext, SSL_OP_ALL | SSL_OP_NO_SSLv2 );
         SSL_CTX_set_mode( this->data->openSSLContext, SSL_MODE_AUTO_RETRY );
 
+        // Client Sockets keep the sessions they negotiate so that reconnects to the same
+        // peer can resume them, a size of zero disables session resumption.
+        this->data->sessionCache.setMaxSize( Integer::parseInt( System::getProperty(
+            "decaf.net.ssl.sessionCacheSize", Integer::toString( OpenSSLSessionCache::DEFAULT_MAX_SIZE ) ) ) );
+        this->data->sessionCache.install( this->data->openSSLContext );
+
         // The Password Callback for cases where we need to open a Cert.
         SSL_CTX_set_default_passwd_cb( this->data->openSSLContext, &ContextData::passwordCallback );
         SSL_CTX_set_default_passwd_cb_userdata( this->data->openSSLContext, (void*)this->data );
@@ -313,3 +325,9 @@ void* OpenSSLContextSpi::getOpenSSLCtx() {
 
     return (void*)this->data->openSSLContext;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache* OpenSSLContextSpi::getSessionCache() {
+
+    return &this->data->sessionCache;
+}
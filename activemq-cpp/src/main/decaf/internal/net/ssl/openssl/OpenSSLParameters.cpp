@@ -43,7 +43,8 @@ OpenSSLParameters::OpenSSLParameters(SSL_CTX* context) : needClientAuth(false),
                                                          ssl(NULL),
                                                          enabledCipherSuites(),
                                                          enabledProtocols(),
-                                                         serverNames() {
+                                                         serverNames(),
+                                                         sessionCache(NULL) {
 
     if (context == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "SSL Context was NULL");
@@ -123,6 +124,7 @@ OpenSSLParameters* OpenSSLParameters::clone() const {
     cloned->needClientAuth = this->needClientAuth;
     cloned->wantClientAuth = this->wantClientAuth;
     cloned->useClientMode = this->useClientMode;
+    cloned->sessionCache = this->sessionCache;
 
     return cloned.release();
 
@@ -38,6 +38,8 @@ namespace openssl {
      *
      * @since 1.0
      */
+    class OpenSSLSessionCache;
+
     class OpenSSLParameters {
     private:
 
@@ -54,6 +56,9 @@ namespace openssl {
         std::vector<std::string> enabledProtocols;
         std::vector<std::string> serverNames;
 
+        // Shared cache of client sessions, owned by the context, may be NULL.
+        OpenSSLSessionCache* sessionCache;
+
     private:
 
         OpenSSLParameters(const OpenSSLParameters&);
@@ -109,6 +114,14 @@ namespace openssl {
 
         void setServerNames(const std::vector<std::string>& serverNames);
 
+        OpenSSLSessionCache* getSessionCache() const {
+            return this->sessionCache;
+        }
+
+        void setSessionCache(OpenSSLSessionCache* sessionCache) {
+            this->sessionCache = sessionCache;
+        }
+
 #ifdef HAVE_OPENSSL
 
         SSL_CTX* getSSLContext() const {
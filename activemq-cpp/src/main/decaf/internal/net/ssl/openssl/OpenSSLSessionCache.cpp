@@ -0,0 +1,257 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenSSLSessionCache.h"
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::ssl;
+using namespace decaf::internal::net::ssl::openssl;
+
+////////////////////////////////////////////////////////////////////////////////
+const int OpenSSLSessionCache::DEFAULT_MAX_SIZE = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache::OpenSSLSessionCache() : lock(), maxSize(DEFAULT_MAX_SIZE)
+#ifdef HAVE_OPENSSL
+                                             , sessions(), usage(), keyIndex(-1)
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache::~OpenSSLSessionCache() {
+    try {
+        clear();
+    }
+    DECAF_CATCH_NOTHROW(Exception)
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::setMaxSize(int value) {
+
+    if (value < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Max cache size cannot be negative: %d", value);
+    }
+
+    synchronized(&lock) {
+        this->maxSize = value;
+
+#ifdef HAVE_OPENSSL
+        while ((int) this->sessions.size() > this->maxSize) {
+            evictEldest();
+        }
+#endif
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenSSLSessionCache::size() const {
+
+    int result = 0;
+
+#ifdef HAVE_OPENSSL
+    synchronized(&lock) {
+        result = (int) this->sessions.size();
+    }
+#endif
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::remove(const std::string& key DECAF_UNUSED) {
+
+#ifdef HAVE_OPENSSL
+    synchronized(&lock) {
+        std::map<std::string, Entry>::iterator iter = this->sessions.find(key);
+        if (iter != this->sessions.end()) {
+            SSL_SESSION_free(iter->second.session);
+            this->usage.erase(iter->second.position);
+            this->sessions.erase(iter);
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::clear() {
+
+#ifdef HAVE_OPENSSL
+    synchronized(&lock) {
+        std::map<std::string, Entry>::iterator iter = this->sessions.begin();
+        for (; iter != this->sessions.end(); ++iter) {
+            SSL_SESSION_free(iter->second.session);
+        }
+
+        this->sessions.clear();
+        this->usage.clear();
+    }
+#endif
+}
+
+#ifdef HAVE_OPENSSL
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::install(SSL_CTX* context) {
+
+    if (context == NULL) {
+        return;
+    }
+
+    synchronized(&lock) {
+        if (this->keyIndex < 0) {
+            this->keyIndex = SSL_get_ex_new_index(0, NULL, NULL, NULL, &OpenSSLSessionCache::freeKeyCallback);
+        }
+    }
+
+    SSL_CTX_set_app_data(context, this);
+    // The sessions are only kept here, OpenSSL's own cache would hold a second copy.
+    SSL_CTX_set_session_cache_mode(context, SSL_CTX_get_session_cache_mode(context) |
+                                   SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(context, &OpenSSLSessionCache::newSessionCallback);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::attach(const std::string& key, SSL* ssl) {
+
+    if (ssl == NULL || this->keyIndex < 0) {
+        return;
+    }
+
+    delete static_cast<std::string*>(SSL_get_ex_data(ssl, this->keyIndex));
+    SSL_set_ex_data(ssl, this->keyIndex, new std::string(key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenSSLSessionCache::resume(const std::string& key, SSL* ssl) {
+
+    if (ssl == NULL) {
+        return false;
+    }
+
+    synchronized(&lock) {
+        std::map<std::string, Entry>::iterator iter = this->sessions.find(key);
+        if (iter != this->sessions.end()) {
+            this->usage.splice(this->usage.end(), this->usage, iter->second.position);
+
+            // The SSL object takes its own reference to the session.
+            return SSL_set_session(ssl, iter->second.session) == 1;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenSSLSessionCache::store(const std::string& key, SSL_SESSION* session) {
+
+    if (session == NULL) {
+        return false;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (!SSL_SESSION_is_resumable(session)) {
+        return false;
+    }
+#endif
+
+    synchronized(&lock) {
+
+        if (this->maxSize == 0) {
+            return false;
+        }
+
+        std::map<std::string, Entry>::iterator iter = this->sessions.find(key);
+        if (iter != this->sessions.end()) {
+            SSL_SESSION_free(iter->second.session);
+            iter->second.session = session;
+            this->usage.splice(this->usage.end(), this->usage, iter->second.position);
+            return true;
+        }
+
+        while ((int) this->sessions.size() >= this->maxSize) {
+            evictEldest();
+        }
+
+        Entry entry;
+        entry.session = session;
+        entry.position = this->usage.insert(this->usage.end(), key);
+        this->sessions.insert(std::make_pair(key, entry));
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::evictEldest() {
+
+    if (this->usage.empty()) {
+        return;
+    }
+
+    std::map<std::string, Entry>::iterator iter = this->sessions.find(this->usage.front());
+    if (iter != this->sessions.end()) {
+        SSL_SESSION_free(iter->second.session);
+        this->sessions.erase(iter);
+    }
+
+    this->usage.pop_front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenSSLSessionCache::newSessionCallback(SSL* ssl, SSL_SESSION* session) {
+
+    OpenSSLSessionCache* cache = static_cast<OpenSSLSessionCache*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (cache == NULL || cache->keyIndex < 0) {
+        return 0;
+    }
+
+    // Only client connections that were attached to a peer have a key.
+    std::string* key = static_cast<std::string*>(SSL_get_ex_data(ssl, cache->keyIndex));
+    if (key == NULL) {
+        return 0;
+    }
+
+    // A session from a peer whose certificate did not verify must never be offered again.
+    if (SSL_get_verify_result(ssl) != X509_V_OK) {
+        return 0;
+    }
+
+    try {
+        // Returning one tells OpenSSL that we have kept its reference to the session.
+        return cache->store(*key, session) ? 1 : 0;
+    } catch (...) {
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::freeKeyCallback(void* parent DECAF_UNUSED, void* ptr, CRYPTO_EX_DATA* data DECAF_UNUSED,
+                                          int index DECAF_UNUSED, long argl DECAF_UNUSED, void* argp DECAF_UNUSED) {
+    delete static_cast<std::string*>(ptr);
+}
+
+#endif
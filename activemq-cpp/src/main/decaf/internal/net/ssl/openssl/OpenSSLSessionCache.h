@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_
+#define _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <list>
+#include <map>
+#include <string>
+
+#ifdef HAVE_OPENSSL
+#include <openssl/ssl.h>
+#endif
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace ssl {
+namespace openssl {
+
+    /**
+     * Client side cache of negotiated SSL sessions keyed by the remote "host:port", when a
+     * new client Socket connects to a peer that it has already completed a handshake with
+     * the cached session is offered to the peer which allows it to perform an abbreviated
+     * handshake instead of a full key exchange.
+     *
+     * Sessions are captured through the OpenSSL new session callback rather than read back
+     * once SSL_connect returns, under TLS 1.3 the peer sends its session tickets after the
+     * handshake has completed so a session taken at that point can not be resumed.
+     *
+     * The cache is owned by the OpenSSLContextSpi and shared by all the Sockets it creates.
+     *
+     * @since 3.9
+     */
+    class DECAF_API OpenSSLSessionCache {
+    public:
+
+        static const int DEFAULT_MAX_SIZE;
+
+    private:
+
+        mutable decaf::util::concurrent::Mutex lock;
+        int maxSize;
+
+#ifdef HAVE_OPENSSL
+
+        struct Entry {
+            SSL_SESSION* session;
+            std::list<std::string>::iterator position;
+        };
+
+        std::map<std::string, Entry> sessions;
+
+        // Peer keys from least to most recently used, the front is evicted first.
+        std::list<std::string> usage;
+
+        // Index of the SSL ex_data slot holding the key of the peer an SSL connects to.
+        int keyIndex;
+
+#endif
+
+    private:
+
+        OpenSSLSessionCache(const OpenSSLSessionCache&);
+        OpenSSLSessionCache& operator=(const OpenSSLSessionCache&);
+
+    public:
+
+        OpenSSLSessionCache();
+
+        virtual ~OpenSSLSessionCache();
+
+        /**
+         * @return the maximum number of peers whose sessions are held.
+         */
+        int getMaxSize() const {
+            return this->maxSize;
+        }
+
+        /**
+         * Sets the maximum number of peers whose sessions are held, once full the
+         * session of the least recently used peer is dropped to make room for a new peer.
+         *
+         * @param value
+         *      The max number of sessions to cache, zero disables caching.
+         */
+        void setMaxSize(int value);
+
+        /**
+         * @return the number of sessions currently cached.
+         */
+        int size() const;
+
+        /**
+         * Removes the session cached for the given peer if there is one.
+         *
+         * @param key
+         *      The "host:port" of the peer.
+         */
+        void remove(const std::string& key);
+
+        /**
+         * Removes and frees all cached sessions.
+         */
+        void clear();
+
+#ifdef HAVE_OPENSSL
+
+        /**
+         * Registers this cache with the given context so that client sessions the context
+         * negotiates are handed to it as they are issued, which for TLS 1.3 is after the
+         * handshake.  The context's application data is set to this cache.
+         *
+         * @param context
+         *      The SSL_CTX whose client SSL objects will use this cache.
+         */
+        void install(SSL_CTX* context);
+
+        /**
+         * Records the peer that the given SSL object connects to so that any session the
+         * peer issues for the connection is stored under the peer's key.  Sessions are only
+         * stored once the peer's certificate chain has verified.
+         *
+         * @param key
+         *      The "host:port" of the peer.
+         * @param ssl
+         *      The SSL object that is about to perform its handshake.
+         */
+        void attach(const std::string& key, SSL* ssl);
+
+        /**
+         * Sets the session cached for the given peer on the SSL object so that
+         * the next SSL_connect attempts to resume it.
+         *
+         * @param key
+         *      The "host:port" of the peer.
+         * @param ssl
+         *      The SSL object that is about to perform its handshake.
+         *
+         * @return true if a cached session was found and set.
+         */
+        bool resume(const std::string& key, SSL* ssl);
+
+        /**
+         * Stores a session negotiated with the given peer, replacing any session already
+         * held for it.  Sessions that can not be resumed are ignored.
+         *
+         * @param key
+         *      The "host:port" of the peer.
+         * @param session
+         *      The session, on success the cache takes over the caller's reference to it.
+         *
+         * @return true if the session was stored and the cache now owns the reference.
+         */
+        bool store(const std::string& key, SSL_SESSION* session);
+
+    private:
+
+        static int newSessionCallback(SSL* ssl, SSL_SESSION* session);
+
+        static void freeKeyCallback(void* parent, void* ptr, CRYPTO_EX_DATA* data,
+                                    int index, long argl, void* argp);
+
+        void evictEldest();
+
+#endif
+
+    };
+
+}}}}}
+
+#endif /* _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_ */
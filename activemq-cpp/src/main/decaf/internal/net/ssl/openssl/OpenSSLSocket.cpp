@@ -29,11 +29,13 @@
 #include <decaf/io/IOException.h>
 #include <decaf/net/SocketException.h>
 #include <decaf/lang/Boolean.h>
+#include <decaf/lang/Integer.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 #include <decaf/internal/util/StringUtils.h>
 #include <decaf/internal/net/SocketFileDescriptor.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLParameters.h>
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCache.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketException.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketInputStream.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketOutputStream.h>
@@ -65,6 +67,7 @@ namespace openssl {
         bool handshakeStarted;
         bool handshakeCompleted;
         std::string commonName;
+        std::string sessionKey;
 
         Mutex handshakeLock;
 
@@ -73,6 +76,7 @@ namespace openssl {
         SocketData() : handshakeStarted(false),
                        handshakeCompleted(false),
                        commonName(),
+                       sessionKey(),
                        handshakeLock() {
         }
 
@@ -190,6 +194,9 @@ void OpenSSLSocket::connect(const std::string& host, int port, int timeout) {
             // Later when startHandshake is called we will check for this common name
             // in the provided certificate
             this->data->commonName = host;
+
+            // Sessions are cached per peer so a reconnect can offer the last one back.
+            this->data->sessionKey = host + ":" + Integer::toString(port);
         }
 #else
         throw SocketException( __FILE__, __LINE__, "Not Supported" );
@@ -361,10 +368,26 @@ void OpenSSLSocket::startHandshake() {
                     SSL_set_verify(this->parameters->getSSL(), SSL_VERIFY_NONE, NULL);
                 }
 
+                std::string sessionKey = this->data->sessionKey;
                 std::vector<std::string> serverNames = this->parameters->getServerNames();
                 if (!serverNames.empty()) {
                     std::string serverName = serverNames.at(0);
                     SSL_set_tlsext_host_name(this->parameters->getSSL(), serverName.c_str());
+                    sessionKey += "/" + serverName;
+                }
+
+                // Offer the session from our last connection to this peer, if the peer
+                // still has it we skip the full key exchange.  A resumed session skips the
+                // chain validation so sessions are never used without peer verification.
+                OpenSSLSessionCache* sessionCache = NULL;
+                if (!this->data->sessionKey.empty() && !peerVerifyDisabled &&
+                    !Boolean::parseBoolean(System::getProperty("decaf.net.ssl.disableSessionResumption", "false"))) {
+
+                    sessionCache = this->parameters->getSessionCache();
+                    if (sessionCache != NULL) {
+                        sessionCache->attach(sessionKey, this->parameters->getSSL());
+                        sessionCache->resume(sessionKey, this->parameters->getSSL());
+                    }
                 }
 
                 int result = SSL_connect(this->parameters->getSSL());
@@ -376,12 +399,26 @@ void OpenSSLSocket::startHandshake() {
                 switch (SSL_get_error(this->parameters->getSSL(), result)) {
                 case SSL_ERROR_NONE:
                     if (!peerVerifyDisabled) {
-                        verifyServerCert(this->data->commonName);
+                        try {
+                            if (SSL_get_verify_result(this->parameters->getSSL()) != X509_V_OK) {
+                                throw OpenSSLSocketException(__FILE__, __LINE__,
+                                    "Server certificate failed verification for host: %s", this->data->commonName.c_str());
+                            }
+                            verifyServerCert(this->data->commonName);
+                        } catch (...) {
+                            if (sessionCache != NULL) {
+                                sessionCache->remove(sessionKey);
+                            }
+                            throw;
+                        }
                     }
                     break;
                 case SSL_ERROR_SSL:
                 case SSL_ERROR_ZERO_RETURN:
                 case SSL_ERROR_SYSCALL:
+                    if (sessionCache != NULL) {
+                        sessionCache->remove(sessionKey);
+                    }
                     SSLSocket::close();
                     throw OpenSSLSocketException(__FILE__, __LINE__);
                 }
@@ -75,6 +75,7 @@ Socket* OpenSSLSocketFactory::createSocket() {
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
         std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        parameters->setSessionCache( this->parent->getSessionCache() );
         return new OpenSSLSocket( parameters.release() );
 #else
         return NULL;
@@ -94,6 +95,7 @@ Socket* OpenSSLSocketFactory::createSocket( const decaf::net::InetAddress* host,
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
         std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        parameters->setSessionCache( this->parent->getSessionCache() );
         std::auto_ptr<SSLSocket> socket( new OpenSSLSocket( parameters.release(), host, port ) );
         return socket.release();
 #else
@@ -115,6 +117,7 @@ Socket* OpenSSLSocketFactory::createSocket( const decaf::net::InetAddress* host,
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
         std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        parameters->setSessionCache( this->parent->getSessionCache() );
         std::auto_ptr<SSLSocket> socket(
             new OpenSSLSocket( parameters.release(), host, port, ifAddress, localPort ) );
         return socket.release();
@@ -136,6 +139,7 @@ Socket* OpenSSLSocketFactory::createSocket( const std::string& hostname, int por
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
         std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        parameters->setSessionCache( this->parent->getSessionCache() );
         std::auto_ptr<SSLSocket> socket( new OpenSSLSocket( parameters.release(), hostname, port ) );
         return socket.release();
 #else
@@ -157,6 +161,7 @@ Socket* OpenSSLSocketFactory::createSocket( const std::string& hostname, int por
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
         std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        parameters->setSessionCache( this->parent->getSessionCache() );
         std::auto_ptr<SSLSocket> socket(
             new OpenSSLSocket( parameters.release(), hostname, port, ifAddress, localPort ) );
         return socket.release();
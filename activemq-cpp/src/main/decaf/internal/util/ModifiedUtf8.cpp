@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ModifiedUtf8.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DECAF_UTF8_SSE2
+#endif
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+#ifndef DECAF_UTF8_SSE2
+    const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+    const unsigned long long LOW_BITS = 0x0101010101010101ULL;
+#endif
+
+    /**
+     * Counts the leading bytes that are copied unchanged by the encoder, the range
+     * 1-127, zero is written as two bytes in modified UTF-8.
+     */
+    std::size_t plainLength(const unsigned char* buffer, std::size_t length) {
+
+        std::size_t index = 0;
+
+#ifdef DECAF_UTF8_SSE2
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; index + 32 <= length; index += 32) {
+            __m128i first = _mm_loadu_si128((const __m128i*) (buffer + index));
+            __m128i second = _mm_loadu_si128((const __m128i*) (buffer + index + 16));
+            __m128i zeros = _mm_or_si128(_mm_cmpeq_epi8(first, zero), _mm_cmpeq_epi8(second, zero));
+            if ((_mm_movemask_epi8(_mm_or_si128(first, second)) | _mm_movemask_epi8(zeros)) != 0) {
+                break;
+            }
+        }
+
+        for (; index + 16 <= length; index += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i*) (buffer + index));
+            if ((_mm_movemask_epi8(block) | _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero))) != 0) {
+                break;
+            }
+        }
+#else
+        for (; index + 8 <= length; index += 8) {
+            unsigned long long word;
+            memcpy(&word, buffer + index, 8);
+            if (((word | ((word - LOW_BITS) & ~word)) & HIGH_BITS) != 0) {
+                break;
+            }
+        }
+#endif
+
+        while (index < length && buffer[index] != 0 && buffer[index] < 0x80) {
+            index++;
+        }
+
+        return index;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ModifiedUtf8::asciiLength(const unsigned char* buffer, std::size_t length) {
+
+    std::size_t index = 0;
+
+#ifdef DECAF_UTF8_SSE2
+    for (; index + 32 <= length; index += 32) {
+        __m128i first = _mm_loadu_si128((const __m128i*) (buffer + index));
+        __m128i second = _mm_loadu_si128((const __m128i*) (buffer + index + 16));
+        if (_mm_movemask_epi8(_mm_or_si128(first, second)) != 0) {
+            break;
+        }
+    }
+
+    for (; index + 16 <= length; index += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*) (buffer + index))) != 0) {
+            break;
+        }
+    }
+#else
+    for (; index + 8 <= length; index += 8) {
+        unsigned long long word;
+        memcpy(&word, buffer + index, 8);
+        if ((word & HIGH_BITS) != 0) {
+            break;
+        }
+    }
+#endif
+
+    while (index < length && buffer[index] < 0x80) {
+        index++;
+    }
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ModifiedUtf8::encodedLength(const std::string& value) {
+
+    const unsigned char* buffer = (const unsigned char*) value.data();
+    std::size_t length = value.length();
+    std::size_t index = 0;
+    std::size_t utfLength = length;
+
+    // Every character outside of 1-127 takes two bytes.
+    while (index < length) {
+        index += plainLength(buffer + index, length - index);
+        if (index < length) {
+            utfLength++;
+            index++;
+        }
+    }
+
+    return utfLength;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ModifiedUtf8::encode(const std::string& value, unsigned char* buffer) {
+
+    const unsigned char* input = (const unsigned char*) value.data();
+    std::size_t length = value.length();
+    std::size_t index = 0;
+    std::size_t utfIndex = 0;
+
+    while (index < length) {
+
+        std::size_t run = plainLength(input + index, length - index);
+        if (run > 0) {
+            memcpy(buffer + utfIndex, input + index, run);
+            index += run;
+            utfIndex += run;
+        }
+
+        if (index < length) {
+            unsigned int charValue = input[index++];
+            buffer[utfIndex++] = (unsigned char) (0xc0 | (0x1f & (charValue >> 6)));
+            buffer[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
+        }
+    }
+
+    return utfIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ModifiedUtf8::decode(unsigned char* buffer, std::size_t length) {
+
+    std::size_t count = 0;
+    std::size_t index = 0;
+
+    while (count < length) {
+
+        std::size_t run = asciiLength(buffer + count, length - count);
+        if (run > 0) {
+            if (index != count) {
+                memmove(buffer + index, buffer + count, run);
+            }
+            index += run;
+            count += run;
+        }
+
+        if (count == length) {
+            break;
+        }
+
+        unsigned char a = buffer[count++];
+
+        if ((a & 0xE0) == 0xC0) {
+            if (count >= length) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of two byte char found at end.");
+            }
+
+            unsigned char b = buffer[count++];
+            if ((b & 0xC0) != 0x80) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, byte two does not start with 0x80.");
+            }
+
+            // 2-byte UTF8 encoding: 110X XXxx 10xx xxxx
+            // Bits set at 'X' means we have encountered a UTF8 encoded value
+            // greater than 255, which is not supported.
+            if (a & 0x1C) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 2 byte UTF-8 encoding found, "
+                        "This method only supports encoded ASCII values of (0-255).");
+            }
+
+            buffer[index++] = (unsigned char) (((a & 0x1F) << 6) | (b & 0x3F));
+
+        } else if ((a & 0xF0) == 0xE0) {
+
+            if (count + 1 >= length) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of three byte char found at end.");
+            } else {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 3 byte UTF-8 encoding found, "
+                        "This method only supports encoded ASCII values of (0-255).");
+            }
+
+        } else {
+            throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, aborting.");
+        }
+    }
+
+    return index;
+}
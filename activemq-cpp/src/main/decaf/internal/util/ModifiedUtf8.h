@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_MODIFIEDUTF8_H_
+#define _DECAF_INTERNAL_UTIL_MODIFIEDUTF8_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/io/UTFDataFormatException.h>
+
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace util {
+
+    /**
+     * Encodes and decodes the modified UTF-8 format used by DataInput and DataOutput
+     * and by the OpenWire string marshalers.  Strings are treated as single byte
+     * characters (0-255), so the encoded form of a character is never more than two
+     * bytes and the decoded form is never longer than the encoded one.
+     *
+     * Message strings are nearly always plain ASCII, so both directions scan for
+     * runs of bytes that encode as themselves sixteen or thirty two bytes at a time
+     * and copy them in bulk, only the bytes outside of those runs are converted one
+     * at a time.
+     *
+     * @since 3.9.5
+     */
+    class DECAF_API ModifiedUtf8 {
+    private:
+
+        ModifiedUtf8();
+        ModifiedUtf8(const ModifiedUtf8&);
+        ModifiedUtf8& operator= (const ModifiedUtf8&);
+
+    public:
+
+        /**
+         * Counts the bytes at the start of an encoded buffer that decode to themselves,
+         * which is every byte below 0x80.
+         *
+         * @param buffer
+         *      The encoded bytes to scan.
+         * @param length
+         *      The number of bytes in the buffer.
+         *
+         * @return the length of the leading run of ASCII bytes.
+         */
+        static std::size_t asciiLength(const unsigned char* buffer, std::size_t length);
+
+        /**
+         * Determines the number of bytes needed to encode the given string.
+         *
+         * @param value
+         *      The string to measure.
+         *
+         * @return the length of the modified UTF-8 encoding of value.
+         */
+        static std::size_t encodedLength(const std::string& value);
+
+        /**
+         * Encodes the given string into a buffer that holds at least encodedLength(value)
+         * bytes.
+         *
+         * @param value
+         *      The string to encode.
+         * @param buffer
+         *      The buffer that receives the encoded bytes.
+         *
+         * @return the number of bytes written.
+         */
+        static std::size_t encode(const std::string& value, unsigned char* buffer);
+
+        /**
+         * Decodes a modified UTF-8 buffer in place, the decoded characters are written
+         * over the front of the buffer.
+         *
+         * @param buffer
+         *      The encoded bytes, replaced with the decoded characters.
+         * @param length
+         *      The number of encoded bytes in the buffer.
+         *
+         * @return the number of decoded characters now at the front of the buffer.
+         *
+         * @throws UTFDataFormatException if the encoding is invalid or contains a
+         *         character greater than 255.
+         */
+        static std::size_t decode(unsigned char* buffer, std::size_t length);
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_MODIFIEDUTF8_H_ */
@@ -28,7 +28,7 @@ using namespace decaf::internal::util;
 using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) || !defined(HAVE_ATOMIC_BUILTINS_64)
 
 #include <decaf/internal/util/concurrent/PlatformThread.h>
 
@@ -40,14 +40,14 @@ namespace {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Atomics::initialize() {
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) || !defined(HAVE_ATOMIC_BUILTINS_64)
     PlatformThread::createMutex(&atomicMutex);
 #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Atomics::shutdown() {
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) || !defined(HAVE_ATOMIC_BUILTINS_64)
     PlatformThread::destroyMutex(atomicMutex);
 #endif
 }
@@ -251,3 +251,42 @@ int Atomics::decrementAndGet(volatile int* target) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update) {
+#ifdef HAVE_ATOMIC_BUILTINS_64
+    return __sync_val_compare_and_swap(target, expect, update) == expect;
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return atomic_cas_64((volatile uint64_t*)target, expect, update) == (uint64_t)expect;
+#else
+    bool result = false;
+    PlatformThread::lockMutex(atomicMutex);
+
+    if (*target == expect) {
+        *target = update;
+        result = true;
+    }
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return result;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getAndAdd64(volatile long long* target, long long delta) {
+#ifdef HAVE_ATOMIC_BUILTINS_64
+    return __sync_fetch_and_add(target, delta);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return (long long)atomic_add_64_nv((volatile uint64_t*)target, delta) - delta;
+#else
+    long long oldValue;
+    PlatformThread::lockMutex(atomicMutex);
+
+    oldValue = *target;
+    *target += delta;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return oldValue;
+#endif
+}
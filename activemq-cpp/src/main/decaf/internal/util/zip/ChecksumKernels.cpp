@@ -0,0 +1,366 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChecksumKernels.h"
+
+#include <decaf/internal/util/zip/simd_checksum.h>
+#include <decaf/internal/util/zip/zlib.h>
+
+#ifdef DECAF_ZIP_SIMD
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#    define DECAF_ZIP_TARGET(features)
+#  else
+#    include <cpuid.h>
+#    define DECAF_ZIP_TARGET(features) __attribute__((target(features)))
+#  endif
+#  include <emmintrin.h>
+#  include <tmmintrin.h>
+#  include <smmintrin.h>
+#  include <wmmintrin.h>
+#endif
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+const int ChecksumKernels::MINIMUM_LENGTH = DECAF_ZIP_SIMD_MINIMUM_LENGTH;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    enum Kernels {
+        CRC32_KERNEL = 1,
+        ADLER32_KERNEL = 2
+    };
+
+    // Written once on first use, racing threads all compute the same value.
+    volatile int supportedKernels = -1;
+    volatile bool kernelsEnabled = true;
+
+#ifdef DECAF_ZIP_SIMD
+
+    int detectKernels() {
+
+        unsigned int ecx = 0;
+
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        ecx = (unsigned int) info[2];
+#else
+        unsigned int eax, ebx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return 0;
+        }
+#endif
+
+        const unsigned int PCLMULQDQ = 1u << 1;
+        const unsigned int SSSE3 = 1u << 9;
+        const unsigned int SSE41 = 1u << 19;
+        const unsigned int SSE42 = 1u << 20;
+
+        int kernels = 0;
+        if ((ecx & (PCLMULQDQ | SSE41 | SSE42)) == (PCLMULQDQ | SSE41 | SSE42)) {
+            kernels |= CRC32_KERNEL;
+        }
+        if ((ecx & SSSE3) == SSSE3) {
+            kernels |= ADLER32_KERNEL;
+        }
+
+        return kernels;
+    }
+
+#else
+
+    int detectKernels() {
+        return 0;
+    }
+
+#endif
+
+    int getSupportedKernels() {
+        int kernels = supportedKernels;
+        if (kernels < 0) {
+            kernels = detectKernels();
+            supportedKernels = kernels;
+        }
+        return kernels;
+    }
+
+#ifdef DECAF_ZIP_SIMD
+
+    /*
+     * Folds the buffer 64 bytes at a time with carry-less multiplies, then down to
+     * 128 bits and finally Barrett reduces to the 32 bit remainder, following Intel's
+     * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+     * The crc is the raw register value, without zlib's pre and post inversion.
+     */
+    DECAF_ZIP_TARGET("sse4.2,pclmul")
+    unsigned int crc32Fold(unsigned int crc, const unsigned char* buffer, unsigned int length) {
+
+        // Bit reflected folding constants and the CRC-32 and Barrett polynomials.
+        static const unsigned long long k1k2[] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+        static const unsigned long long k3k4[] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+        static const unsigned long long k5k0[] = { 0x0163cd6124ULL, 0x0000000000ULL };
+        static const unsigned long long poly[] = { 0x01db710641ULL, 0x01f7011641ULL };
+
+        __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+        x1 = _mm_loadu_si128((const __m128i*) (buffer + 0x00));
+        x2 = _mm_loadu_si128((const __m128i*) (buffer + 0x10));
+        x3 = _mm_loadu_si128((const __m128i*) (buffer + 0x20));
+        x4 = _mm_loadu_si128((const __m128i*) (buffer + 0x30));
+
+        x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) crc));
+
+        x0 = _mm_loadu_si128((const __m128i*) k1k2);
+
+        buffer += 64;
+        length -= 64;
+
+        // Four independent folds per iteration keep the multipliers busy.
+        while (length >= 64) {
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+            x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+            x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+            x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+            x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+            y5 = _mm_loadu_si128((const __m128i*) (buffer + 0x00));
+            y6 = _mm_loadu_si128((const __m128i*) (buffer + 0x10));
+            y7 = _mm_loadu_si128((const __m128i*) (buffer + 0x20));
+            y8 = _mm_loadu_si128((const __m128i*) (buffer + 0x30));
+
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+            x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+            x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+            x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+            buffer += 64;
+            length -= 64;
+        }
+
+        // Fold the four lanes into one.
+        x0 = _mm_loadu_si128((const __m128i*) k3k4);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+        // Single folds for what is left in blocks of 16.
+        while (length >= 16) {
+            x2 = _mm_loadu_si128((const __m128i*) buffer);
+
+            x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+            x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+            x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+            buffer += 16;
+            length -= 16;
+        }
+
+        // Fold 128 bits down to 64.
+        x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+        x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x1 = _mm_srli_si128(x1, 8);
+        x1 = _mm_xor_si128(x1, x2);
+
+        x0 = _mm_loadl_epi64((const __m128i*) k5k0);
+
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_and_si128(x1, x3);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        // Barrett reduction to 32 bits.
+        x0 = _mm_loadu_si128((const __m128i*) poly);
+
+        x2 = _mm_and_si128(x1, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+        x2 = _mm_and_si128(x2, x3);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        return (unsigned int) _mm_extract_epi32(x1, 1);
+    }
+
+    /*
+     * Sums 32 byte blocks, s1 with a sum of absolute differences against zero and
+     * s2 with the bytes weighted by their distance from the end of the block.  At
+     * most NMAX bytes are summed between the modulo reductions, as zlib does.
+     */
+    DECAF_ZIP_TARGET("ssse3")
+    unsigned int adler32Blocks(unsigned int adler, const unsigned char* buffer, unsigned int length) {
+
+        const unsigned int BASE = 65521;
+        const unsigned int NMAX = 5552;
+        const unsigned int BLOCK_SIZE = 32;
+
+        unsigned int s1 = adler & 0xFFFF;
+        unsigned int s2 = adler >> 16;
+
+        unsigned int blocks = length / BLOCK_SIZE;
+        length -= blocks * BLOCK_SIZE;
+
+        const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+        const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+
+        while (blocks > 0) {
+
+            unsigned int n = NMAX / BLOCK_SIZE;
+            if (n > blocks) {
+                n = blocks;
+            }
+            blocks -= n;
+
+            // v_ps collects s1 as it stood before each block, each one adds 32 * s1 to s2.
+            __m128i v_ps = _mm_set_epi32(0, 0, 0, (int) (s1 * n));
+            __m128i v_s2 = _mm_set_epi32(0, 0, 0, (int) s2);
+            __m128i v_s1 = _mm_setzero_si128();
+
+            do {
+                const __m128i bytes1 = _mm_loadu_si128((const __m128i*) buffer);
+                const __m128i bytes2 = _mm_loadu_si128((const __m128i*) (buffer + 16));
+
+                v_ps = _mm_add_epi32(v_ps, v_s1);
+
+                v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+                v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+
+                v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+                v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+
+                buffer += BLOCK_SIZE;
+            } while (--n);
+
+            v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+            // Add up the four lanes of each sum.
+            v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+            v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+            s1 += (unsigned int) _mm_cvtsi128_si32(v_s1);
+
+            v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+            v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+            s2 = (unsigned int) _mm_cvtsi128_si32(v_s2);
+
+            s1 %= BASE;
+            s2 %= BASE;
+        }
+
+        // Fewer than 32 bytes remain, too few to overflow before reducing.
+        while (length > 0) {
+            s1 += *buffer++;
+            s2 += s1;
+            length--;
+        }
+
+        s1 %= BASE;
+        s2 %= BASE;
+
+        return s1 | (s2 << 16);
+    }
+
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChecksumKernels::isCrc32Supported() {
+    return (getSupportedKernels() & CRC32_KERNEL) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChecksumKernels::isAdler32Supported() {
+    return (getSupportedKernels() & ADLER32_KERNEL) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChecksumKernels::setEnabled(bool enabled) {
+    bool previous = kernelsEnabled;
+    kernelsEnabled = enabled;
+    return previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChecksumKernels::isEnabled() {
+    return kernelsEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int ChecksumKernels::crc32(unsigned int crc, const unsigned char* buffer, int length) {
+
+#ifdef DECAF_ZIP_SIMD
+    if (isCrc32Supported() && length >= MINIMUM_LENGTH && (length & 15) == 0) {
+        return ~crc32Fold(~crc, buffer, (unsigned int) length);
+    }
+#endif
+
+    return (unsigned int) ::crc32((uLong) crc, (const Bytef*) buffer, (uInt) length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int ChecksumKernels::adler32(unsigned int adler, const unsigned char* buffer, int length) {
+
+#ifdef DECAF_ZIP_SIMD
+    if (isAdler32Supported() && length >= MINIMUM_LENGTH) {
+        return adler32Blocks(adler, buffer, (unsigned int) length);
+    }
+#endif
+
+    return (unsigned int) ::adler32((uLong) adler, (const Bytef*) buffer, (uInt) length);
+}
+
+#ifdef DECAF_ZIP_SIMD
+
+////////////////////////////////////////////////////////////////////////////////
+int decaf_zip_simd_crc32_enabled(void) {
+    return kernelsEnabled && ChecksumKernels::isCrc32Supported();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int decaf_zip_simd_adler32_enabled(void) {
+    return kernelsEnabled && ChecksumKernels::isAdler32Supported();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long decaf_zip_simd_crc32(unsigned long crc, const unsigned char* buf, unsigned len) {
+    return ~crc32Fold(~(unsigned int) crc, buf, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned long decaf_zip_simd_adler32(unsigned long adler, const unsigned char* buf, unsigned len) {
+    return adler32Blocks((unsigned int) adler, buf, len);
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_ZIP_CHECKSUMKERNELS_H_
+#define _DECAF_INTERNAL_UTIL_ZIP_CHECKSUMKERNELS_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace util {
+namespace zip {
+
+    /**
+     * Vectorized implementations of the CRC-32 and Adler-32 checksums used by the
+     * bundled zlib.  The CRC-32 kernel folds the input with carry-less multiplies
+     * (PCLMULQDQ, with SSE4.1 for the final reduction) and the Adler-32 kernel sums
+     * 32 bytes at a time with SSSE3.
+     *
+     * The kernels are compiled for x86 processors only and are selected at runtime
+     * after checking the processor, zlib's crc32() and adler32() hand them any
+     * buffer of at least MINIMUM_LENGTH bytes when they are available.  Everything
+     * else, and every other platform, uses zlib's table driven code, so the results
+     * are always identical.
+     *
+     * @since 3.9.5
+     */
+    class DECAF_API ChecksumKernels {
+    private:
+
+        ChecksumKernels();
+        ChecksumKernels(const ChecksumKernels&);
+        ChecksumKernels& operator= (const ChecksumKernels&);
+
+    public:
+
+        /**
+         * Buffers shorter than this are left to the table driven code.
+         */
+        static const int MINIMUM_LENGTH;
+
+        /**
+         * @return true if this build has a CRC-32 kernel and the processor can run it.
+         */
+        static bool isCrc32Supported();
+
+        /**
+         * @return true if this build has an Adler-32 kernel and the processor can run it.
+         */
+        static bool isAdler32Supported();
+
+        /**
+         * Allows the kernels to be switched off so the table driven code can be
+         * measured or checked against them, they are enabled by default.
+         *
+         * @param enabled
+         *      false to make zlib use its own code for every buffer.
+         *
+         * @return the previous setting.
+         */
+        static bool setEnabled(bool enabled);
+
+        /**
+         * @return true if the kernels are used when they are supported.
+         */
+        static bool isEnabled();
+
+        /**
+         * Updates a CRC-32 with the contents of the buffer, the length must be a
+         * multiple of 16 and at least MINIMUM_LENGTH.
+         *
+         * @param crc
+         *      The CRC-32 of the data before this buffer.
+         * @param buffer
+         *      The data to add to the checksum.
+         * @param length
+         *      The number of bytes to add.
+         *
+         * @return the updated CRC-32.
+         */
+        static unsigned int crc32(unsigned int crc, const unsigned char* buffer, int length);
+
+        /**
+         * Updates an Adler-32 with the contents of the buffer, the length must be at
+         * least MINIMUM_LENGTH.
+         *
+         * @param adler
+         *      The Adler-32 of the data before this buffer.
+         * @param buffer
+         *      The data to add to the checksum.
+         * @param length
+         *      The number of bytes to add.
+         *
+         * @return the updated Adler-32.
+         */
+        static unsigned int adler32(unsigned int adler, const unsigned char* buffer, int length);
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_ZIP_CHECKSUMKERNELS_H_ */
@@ -0,0 +1,255 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LZ4Block.h"
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+#include <string.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::zip;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MIN_MATCH = 4;
+
+    // The format requires the last match to start at least this far from the
+    // end of the block and the final bytes to always be literals.
+    const int MF_LIMIT = 12;
+    const int LAST_LITERALS = 5;
+
+    const int MAX_OFFSET = 65535;
+
+    const int HASH_LOG = 12;
+    const int HASH_SIZE = 1 << HASH_LOG;
+
+    // Speeds up the scan through data that does not compress, every 64 bytes
+    // without a match the step between probes grows by one.
+    const int SKIP_TRIGGER = 6;
+
+    inline unsigned int read32(const unsigned char* position) {
+        unsigned int value;
+        memcpy(&value, position, sizeof(value));
+        return value;
+    }
+
+    inline unsigned int hash(unsigned int value) {
+        return (value * 2654435761U) >> (32 - HASH_LOG);
+    }
+
+    inline unsigned char* writeLength(unsigned char* output, int length) {
+        while (length >= 255) {
+            *output++ = 255;
+            length -= 255;
+        }
+        *output++ = (unsigned char) length;
+        return output;
+    }
+
+    unsigned char* writeSequence(unsigned char* output, const unsigned char* literals,
+                                 int literalLength, int offset, int matchLength) {
+
+        unsigned char* token = output++;
+
+        if (literalLength >= 15) {
+            *token = 15 << 4;
+            output = writeLength(output, literalLength - 15);
+        } else {
+            *token = (unsigned char) (literalLength << 4);
+        }
+
+        memcpy(output, literals, (size_t) literalLength);
+        output += literalLength;
+
+        // The final sequence of a block holds only literals.
+        if (matchLength == 0) {
+            return output;
+        }
+
+        *output++ = (unsigned char) offset;
+        *output++ = (unsigned char) (offset >> 8);
+
+        matchLength -= MIN_MATCH;
+        if (matchLength >= 15) {
+            *token |= 15;
+            output = writeLength(output, matchLength - 15);
+        } else {
+            *token |= (unsigned char) matchLength;
+        }
+
+        return output;
+    }
+
+    inline int readLength(const unsigned char* input, int size, int& position, int limit) {
+
+        int length = 0;
+        unsigned char value;
+
+        do {
+            if (position >= size) {
+                throw DataFormatException(__FILE__, __LINE__, "LZ4 block is truncated.");
+            }
+            value = input[position++];
+
+            // Checked before adding so a long run of 255 bytes can't overflow the length.
+            if (value > limit - length) {
+                throw DataFormatException(__FILE__, __LINE__, "LZ4 block length overruns the buffer.");
+            }
+            length += value;
+        } while (value == 255);
+
+        return length;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LZ4Block::compressBound(int size) {
+    return size + size / 255 + 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LZ4Block::compress(const unsigned char* input, int size, unsigned char* output, int capacity) {
+
+    if (size < 0 || capacity < compressBound(size)) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Output buffer is too small for the compressed block.");
+    }
+
+    unsigned char* out = output;
+    int anchor = 0;
+
+    if (size > MF_LIMIT) {
+
+        int table[HASH_SIZE];
+        memset(table, 0xFF, sizeof(table));
+
+        const int matchLimit = size - MF_LIMIT;
+        const int extendLimit = size - LAST_LITERALS;
+
+        int position = 0;
+
+        while (position < matchLimit) {
+
+            unsigned int sequence = read32(input + position);
+            unsigned int slot = hash(sequence);
+            int candidate = table[slot];
+            table[slot] = position;
+
+            if (candidate < 0 || position - candidate > MAX_OFFSET || read32(input + candidate) != sequence) {
+                position += 1 + ((position - anchor) >> SKIP_TRIGGER);
+                continue;
+            }
+
+            // Pull the match start back over any literals that also match.
+            while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1]) {
+                --position;
+                --candidate;
+            }
+
+            int length = MIN_MATCH;
+            while (position + length < extendLimit && input[candidate + length] == input[position + length]) {
+                ++length;
+            }
+
+            out = writeSequence(out, input + anchor, position - anchor, position - candidate, length);
+
+            position += length;
+            anchor = position;
+
+            // Index a position inside the match so that runs are picked up again.
+            if (position < matchLimit) {
+                table[hash(read32(input + position - 2))] = position - 2;
+            }
+        }
+    }
+
+    out = writeSequence(out, input + anchor, size - anchor, 0, 0);
+
+    return (int) (out - output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LZ4Block::decompress(const unsigned char* input, int size, unsigned char* output, int capacity) {
+
+    int position = 0;
+    int written = 0;
+
+    while (position < size) {
+
+        unsigned char token = input[position++];
+
+        int literalLength = token >> 4;
+        if (literalLength == 15) {
+            literalLength += readLength(input, size, position, size - position);
+        }
+
+        if (literalLength > size - position || literalLength > capacity - written) {
+            throw DataFormatException(__FILE__, __LINE__, "LZ4 block literals overrun the buffer.");
+        }
+
+        memcpy(output + written, input + position, (size_t) literalLength);
+        position += literalLength;
+        written += literalLength;
+
+        if (position == size) {
+            break;
+        }
+
+        if (size - position < 2) {
+            throw DataFormatException(__FILE__, __LINE__, "LZ4 block is truncated.");
+        }
+
+        int offset = input[position] | (input[position + 1] << 8);
+        position += 2;
+
+        if (offset == 0 || offset > written) {
+            throw DataFormatException(__FILE__, __LINE__, "LZ4 block has an invalid match offset.");
+        }
+
+        int matchLength = token & 15;
+        if (matchLength == 15) {
+            matchLength += readLength(input, size, position, capacity - written);
+        }
+        matchLength += MIN_MATCH;
+
+        if (matchLength > capacity - written) {
+            throw DataFormatException(__FILE__, __LINE__, "LZ4 block match overruns the buffer.");
+        }
+
+        unsigned char* target = output + written;
+        const unsigned char* source = target - offset;
+
+        if (offset >= matchLength) {
+            memcpy(target, source, (size_t) matchLength);
+        } else {
+            // Overlapping copy, repeats the last offset bytes.
+            for (int i = 0; i < matchLength; ++i) {
+                target[i] = source[i];
+            }
+        }
+
+        written += matchLength;
+    }
+
+    return written;
+}
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_ZIP_LZ4BLOCK_H_
+#define _DECAF_INTERNAL_UTIL_ZIP_LZ4BLOCK_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace util {
+namespace zip {
+
+    /**
+     * Compresses and decompresses single blocks of data in the LZ4 block format.
+     *
+     * The compressor is a greedy single pass matcher over a small hash table, it
+     * trades compression ratio for speed and makes no allocations.  The output is
+     * a standard LZ4 block so any LZ4 implementation can decode it.  The block
+     * format carries no length information, callers must record the size of the
+     * original data alongside the compressed block.
+     *
+     * @since 3.9.5
+     */
+    class DECAF_API LZ4Block {
+    private:
+
+        LZ4Block();
+        LZ4Block(const LZ4Block&);
+        LZ4Block& operator= (const LZ4Block&);
+
+    public:
+
+        /**
+         * Returns the largest size a block compressed from the given number of bytes
+         * can have, used to size the output buffer passed to compress.
+         *
+         * @param size
+         *      The number of bytes that will be compressed.
+         *
+         * @return the worst case size of the compressed block.
+         */
+        static int compressBound(int size);
+
+        /**
+         * Compresses the input into an LZ4 block.
+         *
+         * @param input
+         *      The data to compress.
+         * @param size
+         *      The number of bytes of input.
+         * @param output
+         *      The buffer that receives the block, at least compressBound(size) bytes.
+         * @param capacity
+         *      The size of the output buffer.
+         *
+         * @return the number of bytes written to the output buffer.
+         *
+         * @throws IllegalArgumentException if the output buffer is too small.
+         */
+        static int compress(const unsigned char* input, int size, unsigned char* output, int capacity);
+
+        /**
+         * Decompresses an LZ4 block.  The block is validated as it is decoded so a
+         * corrupt or truncated block never reads or writes outside the buffers.
+         *
+         * @param input
+         *      The compressed block.
+         * @param size
+         *      The number of bytes in the block.
+         * @param output
+         *      The buffer that receives the decompressed data.
+         * @param capacity
+         *      The size of the output buffer.
+         *
+         * @return the number of bytes written to the output buffer.
+         *
+         * @throws DataFormatException if the block is malformed or does not fit
+         *         in the output buffer.
+         */
+        static int decompress(const unsigned char* input, int size, unsigned char* output, int capacity);
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_ZIP_LZ4BLOCK_H_ */
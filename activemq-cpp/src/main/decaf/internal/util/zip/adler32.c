@@ -6,6 +6,7 @@
 /* @(#) $Id$ */
 
 #include "zutil.h"
+#include "simd_checksum.h"
 
 #define local static
 
@@ -84,6 +85,12 @@ uLong ZEXPORT adler32(adler, buf, len)
     if (buf == Z_NULL)
         return 1L;
 
+#ifdef DECAF_ZIP_SIMD
+    /* large buffers go to the vector kernel when the processor has one */
+    if (len >= DECAF_ZIP_SIMD_MINIMUM_LENGTH && decaf_zip_simd_adler32_enabled())
+        return decaf_zip_simd_adler32(adler | (sum2 << 16), buf, len);
+#endif
+
     /* in case short lengths are provided, keep it somewhat fast */
     if (len < 16) {
         while (len--) {
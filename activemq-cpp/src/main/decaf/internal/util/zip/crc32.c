@@ -27,6 +27,7 @@
 #endif /* MAKECRCH */
 
 #include "zutil.h"      /* for STDC and FAR definitions */
+#include "simd_checksum.h"
 
 #define local static
 
@@ -225,6 +226,17 @@ unsigned long ZEXPORT crc32(crc, buf, len)
 {
     if (buf == Z_NULL) return 0UL;
 
+#ifdef DECAF_ZIP_SIMD
+    /* whole 16 byte blocks of large buffers go to the vector kernel */
+    if (len >= DECAF_ZIP_SIMD_MINIMUM_LENGTH && decaf_zip_simd_crc32_enabled()) {
+        unsigned chunk = len & ~15U;
+        crc = decaf_zip_simd_crc32(crc, buf, chunk);
+        buf += chunk;
+        len -= chunk;
+        if (len == 0) return crc;
+    }
+#endif
+
 #ifdef DYNAMIC_CRC_TABLE
     if (crc_table_empty)
         make_crc_table();
@@ -0,0 +1,55 @@
+/* simd_checksum.h -- hooks from crc32.c and adler32.c into ChecksumKernels
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMD_CHECKSUM_H
+#define SIMD_CHECKSUM_H
+
+/* The kernels exist for x86 compilers that can emit SSE4.2, PCLMULQDQ and
+   SSSE3 code from a file built for the baseline instruction set. */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  if defined(_MSC_VER) || defined(__clang__) || \
+      (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#    define DECAF_ZIP_SIMD
+#  endif
+#endif
+
+/* Must match ChecksumKernels::MINIMUM_LENGTH. */
+#define DECAF_ZIP_SIMD_MINIMUM_LENGTH 64
+
+#ifdef DECAF_ZIP_SIMD
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int decaf_zip_simd_crc32_enabled(void);
+int decaf_zip_simd_adler32_enabled(void);
+
+/* len must be a multiple of 16 and at least DECAF_ZIP_SIMD_MINIMUM_LENGTH */
+unsigned long decaf_zip_simd_crc32(unsigned long crc, const unsigned char *buf, unsigned len);
+
+/* len must be at least DECAF_ZIP_SIMD_MINIMUM_LENGTH */
+unsigned long decaf_zip_simd_adler32(unsigned long adler, const unsigned char *buf, unsigned len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DECAF_ZIP_SIMD */
+
+#endif /* SIMD_CHECKSUM_H */
@@ -26,6 +26,7 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferedInputStream::BufferedInputStream(InputStream* stream, bool own) :
@@ -101,6 +102,17 @@ void BufferedInputStream::reset() {
     this->pos = this->markPos;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+DirectInputBuffer::Window BufferedInputStream::getDirectInputWindow() {
+
+    // The proxy is cleared on close, which sends readers back to the checked path.
+    DirectInputBuffer::Window window;
+    window.array = &this->proxyBuffer;
+    window.position = &this->pos;
+    window.limit = &this->count;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int BufferedInputStream::doReadByte() {
 
@@ -20,6 +20,7 @@
 
 #include <decaf/util/Config.h>
 #include <decaf/io/FilterInputStream.h>
+#include <decaf/internal/io/DirectInputBuffer.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 
 namespace decaf{
@@ -31,7 +32,7 @@ namespace io{
      * in order to reduce the number of io operations on the
      * input stream.
      */
-    class DECAF_API BufferedInputStream : public FilterInputStream {
+    class DECAF_API BufferedInputStream : public FilterInputStream, public decaf::internal::io::DirectInputBuffer {
     private:
 
         int pos;
@@ -110,6 +111,11 @@ namespace io{
             return true;
         }
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::internal::io::DirectInputBuffer::Window getDirectInputWindow();
+
     protected:
 
         virtual int doReadByte();
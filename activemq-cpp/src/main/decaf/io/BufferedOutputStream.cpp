@@ -25,10 +25,11 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferedOutputStream::BufferedOutputStream(OutputStream* stream, bool own) :
-    FilterOutputStream(stream, own), buffer(NULL), bufferSize(0), head(0), tail(0) {
+    FilterOutputStream(stream, own), buffer(NULL), bufferSize(0), head(0), tail(0), proxyBuffer(NULL) {
 
     // Default to 1k buffer.
     init(8192);
@@ -36,7 +37,7 @@ BufferedOutputStream::BufferedOutputStream(OutputStream* stream, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferedOutputStream::BufferedOutputStream(OutputStream* stream, int bufSize, bool own) :
-    FilterOutputStream(stream, own), buffer(NULL), bufferSize(0), head(0), tail(0) {
+    FilterOutputStream(stream, own), buffer(NULL), bufferSize(0), head(0), tail(0), proxyBuffer(NULL) {
 
     try {
         this->init(bufSize);
@@ -67,6 +68,10 @@ void BufferedOutputStream::init(int bufSize) {
 
     buffer = new unsigned char[bufSize];
     head = tail = 0;
+
+    if (!isClosed()) {
+        proxyBuffer = buffer;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -105,6 +110,28 @@ void BufferedOutputStream::flush() {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BufferedOutputStream::close() {
+
+    try {
+        this->proxyBuffer = NULL;
+        FilterOutputStream::close();
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DirectOutputBuffer::Window BufferedOutputStream::getDirectOutputWindow() {
+
+    // The proxy is cleared on close, which sends writers back to the checked path.
+    DirectOutputBuffer::Window window;
+    window.array = &this->proxyBuffer;
+    window.position = &this->tail;
+    window.limit = &this->bufferSize;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void BufferedOutputStream::doWriteByte(const unsigned char c) {
 
@@ -19,6 +19,7 @@
 #define _DECAF_IO_BUFFEREDOUTPUTSTREAM_H_
 
 #include <decaf/io/FilterOutputStream.h>
+#include <decaf/internal/io/DirectOutputBuffer.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 
 namespace decaf{
@@ -28,7 +29,7 @@ namespace io{
      * Wrapper around another output stream that buffers
      * output before writing to the target output stream.
      */
-    class DECAF_API BufferedOutputStream: public FilterOutputStream {
+    class DECAF_API BufferedOutputStream: public FilterOutputStream, public decaf::internal::io::DirectOutputBuffer {
     private:
 
         /**
@@ -51,6 +52,11 @@ namespace io{
          */
         int tail;
 
+        /**
+         * Proxy to the buffer for direct writers, cleared when this stream is closed.
+         */
+        unsigned char* proxyBuffer;
+
     private:
 
         BufferedOutputStream(const BufferedOutputStream&);
@@ -89,6 +95,16 @@ namespace io{
          */
         virtual void flush();
 
+        /**
+         * @{inheritDoc}
+         */
+        virtual void close();
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::internal::io::DirectOutputBuffer::Window getDirectOutputWindow();
+
     protected:
 
         virtual void doWriteByte(unsigned char c);
@@ -24,6 +24,7 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayInputStream::ByteArrayInputStream() :
@@ -128,6 +129,16 @@ void ByteArrayInputStream::reset() {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+DirectInputBuffer::Window ByteArrayInputStream::getDirectInputWindow() {
+
+    DirectInputBuffer::Window window;
+    window.array = &this->buffer;
+    window.position = &this->pos;
+    window.limit = &this->count;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ByteArrayInputStream::doReadByte() {
 
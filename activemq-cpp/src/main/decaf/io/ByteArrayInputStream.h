@@ -19,6 +19,7 @@
 #define _DECAF_IO_BYTEARRAYINPUTSTREAM_H_
 
 #include <decaf/io/InputStream.h>
+#include <decaf/internal/io/DirectInputBuffer.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <vector>
 
@@ -39,7 +40,7 @@ namespace io{
      *
      * @since 1.0
      */
-    class DECAF_API ByteArrayInputStream: public InputStream {
+    class DECAF_API ByteArrayInputStream: public InputStream, public decaf::internal::io::DirectInputBuffer {
     private:
 
         /**
@@ -217,6 +218,11 @@ namespace io{
             return true;
         }
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::internal::io::DirectInputBuffer::Window getDirectInputWindow();
+
     protected:
 
         virtual int doReadByte();
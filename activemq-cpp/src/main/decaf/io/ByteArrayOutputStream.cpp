@@ -26,6 +26,7 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayOutputStream::ByteArrayOutputStream() :
@@ -76,6 +77,17 @@ void ByteArrayOutputStream::reset() {
     this->count = 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+DirectOutputBuffer::Window ByteArrayOutputStream::getDirectOutputWindow() {
+
+    // Writers that find no room go through write(), which grows the buffer.
+    DirectOutputBuffer::Window window;
+    window.array = &this->buffer;
+    window.position = &this->count;
+    window.limit = &this->bufferSize;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ByteArrayOutputStream::doWriteByte(unsigned char c) {
 
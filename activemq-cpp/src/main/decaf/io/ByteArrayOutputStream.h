@@ -21,6 +21,7 @@
 #include <decaf/util/Config.h>
 
 #include <decaf/io/OutputStream.h>
+#include <decaf/internal/io/DirectOutputBuffer.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 
 #include <utility>
@@ -28,7 +29,7 @@
 namespace decaf{
 namespace io{
 
-    class DECAF_API ByteArrayOutputStream: public OutputStream {
+    class DECAF_API ByteArrayOutputStream: public OutputStream, public decaf::internal::io::DirectOutputBuffer {
     private:
 
         /**
@@ -108,6 +109,11 @@ namespace io{
          */
         void writeTo(OutputStream* out) const;
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::internal::io::DirectOutputBuffer::Window getDirectOutputWindow();
+
     protected:
 
         virtual void doWriteByte(unsigned char value);
@@ -18,6 +18,8 @@
 #include <decaf/io/DataInputStream.h>
 
 #include <decaf/io/PushbackInputStream.h>
+#include <decaf/internal/io/BigEndian.h>
+#include <decaf/internal/util/ModifiedUtf8.h>
 
 #ifdef HAVE_STRING_H
 #include <string.h>
@@ -32,22 +34,33 @@ using namespace decaf::io;
 using namespace decaf::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 DataInputStream::DataInputStream(InputStream* inputStream, bool own) :
-    FilterInputStream(inputStream, own), buffer() {
+    FilterInputStream(inputStream, own), buffer(), direct() {
+
+    DirectInputBuffer* source = dynamic_cast<DirectInputBuffer*>(inputStream);
+    if (source != NULL) {
+        this->direct = source->getDirectInputWindow();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 DataInputStream::~DataInputStream() {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+DirectInputBuffer::Window DataInputStream::getDirectInputWindow() {
+    return this->direct;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool DataInputStream::readBoolean() {
 
     try {
-        readAllData(buffer, sizeof(char));
-        return (bool) (buffer[0] != 0);
+        return (bool) (readPrimitive(sizeof(char))[0] != 0);
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -58,8 +71,7 @@ bool DataInputStream::readBoolean() {
 char DataInputStream::readByte() {
 
     try {
-        readAllData(buffer, sizeof(unsigned char));
-        return (char) (buffer[0]);
+        return (char) readPrimitive(sizeof(unsigned char))[0];
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -70,8 +82,7 @@ char DataInputStream::readByte() {
 unsigned char DataInputStream::readUnsignedByte() {
 
     try {
-        readAllData(buffer, sizeof(unsigned char));
-        return buffer[0];
+        return readPrimitive(sizeof(unsigned char))[0];
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -82,8 +93,7 @@ unsigned char DataInputStream::readUnsignedByte() {
 char DataInputStream::readChar() {
 
     try {
-        readAllData(buffer, sizeof(unsigned char));
-        return (char) (buffer[0]);
+        return (char) readPrimitive(sizeof(unsigned char))[0];
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -94,10 +104,7 @@ char DataInputStream::readChar() {
 short DataInputStream::readShort() {
 
     try {
-        short value = 0;
-        readAllData(buffer, sizeof(short));
-        value |= (short) (buffer[0] << 8 | buffer[1] << 0);
-        return value;
+        return (short) BigEndian::load16(readPrimitive(sizeof(short)));
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -108,10 +115,7 @@ short DataInputStream::readShort() {
 unsigned short DataInputStream::readUnsignedShort() {
 
     try {
-        unsigned short value = 0;
-        readAllData(buffer, sizeof(unsigned short));
-        value |= (unsigned short) (buffer[0] << 8 | buffer[1] << 0);
-        return value;
+        return BigEndian::load16(readPrimitive(sizeof(unsigned short)));
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -122,10 +126,7 @@ unsigned short DataInputStream::readUnsignedShort() {
 int DataInputStream::readInt() {
 
     try {
-        unsigned int value = 0;
-        readAllData(buffer, sizeof(int));
-        value |= (buffer[0] << 24 | buffer[1] << 16 | buffer[2] << 8 | buffer[3] << 0);
-        return value;
+        return (int) BigEndian::load32(readPrimitive(sizeof(int)));
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -164,23 +165,7 @@ float DataInputStream::readFloat() {
 long long DataInputStream::readLong() {
 
     try {
-        unsigned long long value = 0;
-        readAllData(buffer, sizeof(long long));
-
-        // Have to do it this way because on Solaris and Cygwin we get all
-        // kinds of warnings when shifting a byte up into a long long.
-        unsigned long long byte1 = buffer[0] & 0x00000000000000FFULL;
-        unsigned long long byte2 = buffer[1] & 0x00000000000000FFULL;
-        unsigned long long byte3 = buffer[2] & 0x00000000000000FFULL;
-        unsigned long long byte4 = buffer[3] & 0x00000000000000FFULL;
-        unsigned long long byte5 = buffer[4] & 0x00000000000000FFULL;
-        unsigned long long byte6 = buffer[5] & 0x00000000000000FFULL;
-        unsigned long long byte7 = buffer[6] & 0x00000000000000FFULL;
-        unsigned long long byte8 = buffer[7] & 0x00000000000000FFULL;
-
-        value = (byte1 << 56 | byte2 << 48 | byte3 << 40 | byte4 << 32 | byte5 << 24 | byte6 << 16 | byte7 << 8 | byte8 << 0);
-
-        return value;
+        return (long long) BigEndian::load64(readPrimitive(sizeof(long long)));
     }
     DECAF_CATCH_RETHROW(EOFException)
     DECAF_CATCH_RETHROW(IOException)
@@ -239,67 +224,17 @@ std::string DataInputStream::readUTF() {
             return "";
         }
 
-        std::vector<unsigned char> buffer(utfLength);
-        std::vector<unsigned char> result(utfLength);
-
-        this->readFully(&buffer[0], utfLength);
-
-        std::size_t count = 0;
-        std::size_t index = 0;
-        unsigned char a = 0;
-
-        while (count < utfLength) {
-            if ((result[index] = buffer[count++]) < 0x80) {
-                index++;
-            } else if (((a = result[index]) & 0xE0) == 0xC0) {
-                if (count >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of two byte char found at end.");
-                }
-
-                unsigned char b = buffer[count++];
-                if ((b & 0xC0) != 0x80) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, byte two does not start with 0x80.");
-                }
-
-                // 2-byte UTF8 encoding: 110X XXxx 10xx xxxx
-                // Bits set at 'X' means we have encountered a UTF8 encoded value
-                // greater than 255, which is not supported.
-                if (a & 0x1C) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 2 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
-
-                result[index++] = (unsigned char) (((a & 0x1F) << 6) | (b & 0x3F));
-
-            } else if ((a & 0xF0) == 0xE0) {
-
-                if (count + 1 >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of three byte char found at end.");
-                } else {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 3 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
+        // Decode in place in the returned string, the decoded form is never longer
+        // than the encoded one and for ASCII it is the same bytes.
+        std::string result(utfLength, '\0');
+        this->readFully((unsigned char*) &result[0], utfLength);
 
-                // If we were to support multibyte strings in the future this would be
-                // the remainder of this method decoding logic.
-                //
-                //int b = buffer[count++];
-                //int c = buffer[count++];
-                //if( ( ( b & 0xC0 ) != 0x80 ) || ( ( c & 0xC0 ) != 0x80 ) ) {
-                //    throw UTFDataFormatException(
-                //        __FILE__, __LINE__,
-                //        "Invalid UTF-8 encoding found, byte two does not start with 0x80." );
-                //}
-                //
-                //result[inde++] = ( ( a & 0x0F ) << 12 ) |
-                //                 ( ( b & 0x3F ) << 6 ) | ( c & 0x3F );
-
-            } else {
-                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, aborting.");
-            }
+        std::size_t length = ModifiedUtf8::decode((unsigned char*) &result[0], utfLength);
+        if (length < utfLength) {
+            result.resize(length);
         }
 
-        return std::string((char*) (&result[0]), index);
+        return result;
     }
     DECAF_CATCH_RETHROW(UTFDataFormatException)
     DECAF_CATCH_RETHROW(EOFException)
@@ -474,3 +409,22 @@ void DataInputStream::readAllData(unsigned char* buffer, int length) {
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* DataInputStream::readPrimitive(int length) {
+
+    if (this->direct.array != NULL) {
+
+        // Use a local reference in case of unsynchronized close.
+        const unsigned char* array = *this->direct.array;
+        int position = *this->direct.position;
+
+        if (array != NULL && *this->direct.limit - position >= length) {
+            *this->direct.position = position + length;
+            return array + position;
+        }
+    }
+
+    readAllData(this->buffer, length);
+    return this->buffer;
+}
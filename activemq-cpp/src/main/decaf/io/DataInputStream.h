@@ -19,6 +19,7 @@
 #define _DECAF_IO_DATAINPUTSTREAM_H_
 
 #include <decaf/io/FilterInputStream.h>
+#include <decaf/internal/io/DirectInputBuffer.h>
 #include <decaf/io/IOException.h>
 #include <decaf/io/EOFException.h>
 #include <decaf/io/UTFDataFormatException.h>
@@ -43,13 +44,17 @@ namespace io{
      *
      *  @since 1.0
      */
-    class DECAF_API DataInputStream: public FilterInputStream {
+    class DECAF_API DataInputStream: public FilterInputStream, public decaf::internal::io::DirectInputBuffer {
     private:
 
         // Buffer used to store bytes read from the stream while reconstructed into
         // higher order C++ primitives.
         unsigned char buffer[8];
 
+        // View of the wrapped stream's internal array when it provides one, primitives
+        // that are already buffered there are decoded in place.
+        decaf::internal::io::DirectInputBuffer::Window direct;
+
     private:
 
         DataInputStream(const DataInputStream&);
@@ -68,6 +73,13 @@ namespace io{
 
         virtual ~DataInputStream();
 
+        /**
+         * Returns the window of the wrapped stream since this stream holds no bytes
+         * of its own, when the wrapped stream has no internal array the returned
+         * window's array field is NULL.
+         */
+        virtual decaf::internal::io::DirectInputBuffer::Window getDirectInputWindow();
+
     public:
         // DataInput
 
@@ -341,6 +353,10 @@ namespace io{
         // Used internally to reliably get data from the underlying stream
         void readAllData(unsigned char* buffer, int length);
 
+        // Returns the next length bytes of a primitive, from the wrapped stream's
+        // array if it holds them all, otherwise read into buffer.
+        const unsigned char* readPrimitive(int length);
+
     };
 
 }}
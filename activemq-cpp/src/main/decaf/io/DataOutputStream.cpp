@@ -17,6 +17,8 @@
 
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/UTFDataFormatException.h>
+#include <decaf/internal/io/BigEndian.h>
+#include <decaf/internal/util/ModifiedUtf8.h>
 #include <decaf/util/Config.h>
 #include <string.h>
 #include <stdio.h>
@@ -25,10 +27,17 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::util;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 DataOutputStream::DataOutputStream(OutputStream* outputStream, bool own) :
-    FilterOutputStream(outputStream, own), written(0) {
+    FilterOutputStream(outputStream, own), written(0), buffer(), direct() {
+
+    DirectOutputBuffer* target = dynamic_cast<DirectOutputBuffer*>(outputStream);
+    if (target != NULL) {
+        this->direct = target->getDirectOutputWindow();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,15 +99,9 @@ void DataOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeBoolean(bool value) {
     try {
-
-        value == true ? buffer[0] = 1 : buffer[0] = 0;
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        outputStream->write(buffer[0]);
-        written++;
+        unsigned char* bytes = beginPrimitive(sizeof(unsigned char));
+        bytes[0] = value == true ? 1 : 0;
+        endPrimitive(bytes, sizeof(unsigned char));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -107,13 +110,9 @@ void DataOutputStream::writeBoolean(bool value) {
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeByte(unsigned char value) {
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        outputStream->write(value);
-        written++;
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        bytes[0] = value;
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -122,13 +121,9 @@ void DataOutputStream::writeByte(unsigned char value) {
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeChar(char value) {
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        outputStream->write(value);
-        written++;
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        bytes[0] = (unsigned char) value;
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -137,16 +132,9 @@ void DataOutputStream::writeChar(char value) {
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeShort(short value) {
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        buffer[0] = (unsigned char) ((value & 0xFF00) >> 8);
-        buffer[1] = (unsigned char) ((value & 0x00FF) >> 0);
-
-        outputStream->write(buffer, sizeof(value), 0, sizeof(value));
-        written += sizeof(value);
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        BigEndian::store16(bytes, (unsigned short) value);
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -155,16 +143,9 @@ void DataOutputStream::writeShort(short value) {
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeUnsignedShort(unsigned short value) {
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        buffer[0] = (unsigned char) ((value & 0xFF00) >> 8);
-        buffer[1] = (unsigned char) ((value & 0x00FF) >> 0);
-
-        outputStream->write(buffer, sizeof(value), 0, sizeof(value));
-        written += sizeof(value);
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        BigEndian::store16(bytes, value);
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -172,20 +153,10 @@ void DataOutputStream::writeUnsignedShort(unsigned short value) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeInt(int value) {
-
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        buffer[0] = (unsigned char) ((value & 0xFF000000) >> 24);
-        buffer[1] = (unsigned char) ((value & 0x00FF0000) >> 16);
-        buffer[2] = (unsigned char) ((value & 0x0000FF00) >> 8);
-        buffer[3] = (unsigned char) ((value & 0x000000FF) >> 0);
-
-        outputStream->write(buffer, sizeof(value), 0, sizeof(value));
-        written += sizeof(value);
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        BigEndian::store32(bytes, (unsigned int) value);
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -193,24 +164,10 @@ void DataOutputStream::writeInt(int value) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeLong(long long value) {
-
     try {
-
-        if (outputStream == NULL) {
-            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
-        }
-
-        buffer[0] = (unsigned char) ((value & 0xFF00000000000000ULL) >> 56);
-        buffer[1] = (unsigned char) ((value & 0x00FF000000000000ULL) >> 48);
-        buffer[2] = (unsigned char) ((value & 0x0000FF0000000000ULL) >> 40);
-        buffer[3] = (unsigned char) ((value & 0x000000FF00000000ULL) >> 32);
-        buffer[4] = (unsigned char) ((value & 0x00000000FF000000ULL) >> 24);
-        buffer[5] = (unsigned char) ((value & 0x0000000000FF0000ULL) >> 16);
-        buffer[6] = (unsigned char) ((value & 0x000000000000FF00ULL) >> 8);
-        buffer[7] = (unsigned char) ((value & 0x00000000000000FFULL) >> 0);
-
-        outputStream->write(buffer, sizeof(value), 0, sizeof(value));
-        written += sizeof(value);
+        unsigned char* bytes = beginPrimitive(sizeof(value));
+        BigEndian::store64(bytes, (unsigned long long) value);
+        endPrimitive(bytes, sizeof(value));
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
@@ -280,32 +237,17 @@ void DataOutputStream::writeUTF(const std::string& value) {
                     "than the supported 65535 bytes");
         }
 
-        std::size_t length = value.length();
-        std::vector<unsigned char> utfBytes((std::size_t) utfLength);
-        unsigned int utfIndex = 0;
-
-        for (std::size_t i = 0; i < length; i++) {
-
-            unsigned int charValue = (unsigned char) value.at(i);
-
-            // Written to allow for expansion to wide character strings at some
-            // point, as it stands now the value can never be > 255 since the
-            // string class returns a single byte char.
-            if (charValue > 0 && charValue <= 127) {
-                utfBytes[utfIndex++] = (unsigned char) charValue;
-            } else if (charValue <= 2047) {
-                utfBytes[utfIndex++] = (unsigned char) (0xc0 | (0x1f & (charValue >> 6)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
-            } else {
-                utfBytes[utfIndex++] = (unsigned char) (0xe0 | (0x0f & (charValue >> 12)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & (charValue >> 6)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
-            }
-        }
-
         this->writeUnsignedShort((unsigned short) utfLength);
-        if (utfLength > 0) {
-            this->write(&utfBytes[0], utfIndex, 0, utfIndex);
+
+        // A string with nothing to escape is its own encoding.
+        if (utfLength == value.length()) {
+            if (utfLength > 0) {
+                this->write((const unsigned char*) value.data(), (int) utfLength, 0, (int) utfLength);
+            }
+        } else {
+            std::vector<unsigned char> utfBytes((std::size_t) utfLength);
+            ModifiedUtf8::encode(value, &utfBytes[0]);
+            this->write(&utfBytes[0], (int) utfLength, 0, (int) utfLength);
         }
     }
     DECAF_CATCH_RETHROW(UTFDataFormatException)
@@ -316,24 +258,44 @@ void DataOutputStream::writeUTF(const std::string& value) {
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int DataOutputStream::countUTFLength(const std::string& value) {
 
-    unsigned int utfCount = 0;
-    std::size_t length = value.length();
+    std::size_t utfCount = ModifiedUtf8::encodedLength(value);
 
-    for (std::size_t i = 0; i < length; ++i) {
+    // Anything this long is rejected by the caller, avoid wrapping the count.
+    if (utfCount > 0xFFFFFFFFUL) {
+        return 0xFFFFFFFFU;
+    }
 
-        unsigned int charValue = (unsigned char) value.at(i);
+    return (unsigned int) utfCount;
+}
 
-        // Written to allow for expansion to wide character strings at some
-        // point, as it stands now the value can never be > 255 since the
-        // string class returns a single byte char.
-        if (charValue > 0 && charValue <= 127) {
-            utfCount++;
-        } else if (charValue <= 2047) {
-            utfCount += 2;
-        } else {
-            utfCount += 3;
+////////////////////////////////////////////////////////////////////////////////
+unsigned char* DataOutputStream::beginPrimitive(int length) {
+
+    if (this->direct.array != NULL) {
+
+        // Use a local reference in case of unsynchronized close.
+        unsigned char* array = *this->direct.array;
+        int position = *this->direct.position;
+
+        if (array != NULL && *this->direct.limit - position >= length) {
+            *this->direct.position = position + length;
+            return array + position;
         }
     }
 
-    return utfCount;
+    if (outputStream == NULL) {
+        throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
+    }
+
+    return this->buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStream::endPrimitive(const unsigned char* bytes, int length) {
+
+    if (bytes == this->buffer) {
+        outputStream->write(this->buffer, length, 0, length);
+    }
+
+    written += length;
 }
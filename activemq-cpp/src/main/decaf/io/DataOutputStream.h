@@ -19,6 +19,7 @@
 #define _DECAF_IO_DATAOUTPUTSTREAM_H_
 
 #include <decaf/io/FilterOutputStream.h>
+#include <decaf/internal/io/DirectOutputBuffer.h>
 #include <decaf/io/IOException.h>
 #include <decaf/io/UTFDataFormatException.h>
 #include <string>
@@ -40,6 +41,10 @@ namespace io{
         // Buffer used for storing byte values to write to the stream
         unsigned char buffer[8];
 
+        // View of the wrapped stream's internal array when it provides one, primitives
+        // are encoded straight into it while it has room.
+        decaf::internal::io::DirectOutputBuffer::Window direct;
+
     private:
 
         DataOutputStream(const DataOutputStream&);
@@ -139,6 +144,14 @@ namespace io{
         // Determine the encoded length of a string when written as modified UTF-8
         unsigned int countUTFLength(const std::string& value);
 
+        // Returns where to encode a primitive of the given length, space in the wrapped
+        // stream's array if it has room, otherwise buffer.
+        unsigned char* beginPrimitive(int length);
+
+        // Completes a primitive started with beginPrimitive, writing it to the wrapped
+        // stream if it was encoded into buffer.
+        void endPrimitive(const unsigned char* bytes, int length);
+
     };
 
 }}
@@ -381,6 +381,17 @@ long long System::nanoTime() {
 
 #else
 
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+
+    // Prefer the monotonic clock, it has nanosecond resolution and isn't
+    // affected by changes to the wall clock time.
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return ((long long)ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+    }
+
+#endif
+
     struct timeval tv;
     gettimeofday( &tv, NULL );
     return (((long long)tv.tv_sec * 1000000) + tv.tv_usec) * 1000;
@@ -0,0 +1,244 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CmsTemplateBenchmark.h"
+
+#include <activemq/cmsutil/CmsTemplate.h>
+#include <activemq/cmsutil/MessageCreator.h>
+#include <activemq/cmsutil/ProducerCallback.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <cms/Queue.h>
+#include <cms/Session.h>
+#include <cms/TextMessage.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/ArrayList.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::core;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int TOTAL_MESSAGES = 32000;
+    const std::string BROKER_URI = "mock://127.0.0.1:23232?wireFormat=openwire&connection.useAsyncSend=true";
+
+    const int THREAD_COUNTS[] = { 1, 4, 16 };
+    const int NUM_THREAD_COUNTS = sizeof( THREAD_COUNTS ) / sizeof( int );
+
+    const int ROUTING_DESTINATIONS = 16;
+
+    class TextCreator : public MessageCreator {
+    public:
+
+        virtual cms::Message* createMessage( cms::Session* session ) {
+            return session->createTextMessage( "benchmark" );
+        }
+    };
+
+    // Only takes a session and its cached producer from the template.
+    class NoOpCallback : public ProducerCallback {
+    public:
+
+        virtual void doInCms( cms::Session* session DECAF_UNUSED, cms::MessageProducer* producer DECAF_UNUSED ) {
+        }
+    };
+
+    class SenderTask : public Runnable {
+    private:
+
+        SenderTask( const SenderTask& );
+        SenderTask& operator= ( const SenderTask& );
+
+    public:
+
+        CmsTemplate& cmsTemplate;
+        const std::vector<cms::Destination*>& destinations;
+        int count;
+        int offset;
+        bool send;
+        LatencyHistogram sendLatency;
+        std::string error;
+
+        SenderTask( CmsTemplate& cmsTemplate, const std::vector<cms::Destination*>& destinations,
+                    int count, int offset, bool send ) :
+            Runnable(), cmsTemplate( cmsTemplate ), destinations( destinations ), count( count ),
+            offset( offset ), send( send ), sendLatency(), error() {
+        }
+
+        virtual ~SenderTask() {}
+
+        virtual void run() {
+
+            try{
+
+                TextCreator creator;
+                NoOpCallback callback;
+
+                for( int i = 0; i < count; ++i ) {
+                    cms::Destination* destination = destinations[( offset + i ) % destinations.size()];
+
+                    long long start = System::nanoTime();
+                    if( send ) {
+                        cmsTemplate.send( destination, &creator );
+                    } else {
+                        cmsTemplate.execute( destination, &callback );
+                    }
+                    sendLatency.record( System::nanoTime() - start );
+                }
+
+            } catch( cms::CMSException& ex ) {
+                error = ex.getMessage();
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CmsTemplateBenchmark::CmsTemplateBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CmsTemplateBenchmark::~CmsTemplateBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CmsTemplateBenchmark::runScenario( const std::string& name, int threads, int destinationCount, bool send ) {
+
+    ActiveMQConnectionFactory factory( BROKER_URI );
+    CmsTemplate cmsTemplate( &factory );
+    cmsTemplate.setDefaultDestinationName( "benchmark.template" );
+
+    // The destinations are resolved up front, the template's resolver is not meant
+    // to be shared between threads.
+    std::auto_ptr<cms::Connection> connection( factory.createConnection() );
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+    std::vector<cms::Destination*> destinations;
+    for( int i = 0; i < destinationCount; ++i ) {
+        destinations.push_back( session->createQueue( "benchmark.template." + Integer::toString( i ) ) );
+    }
+
+    int perThread = TOTAL_MESSAGES / threads;
+    int expected = perThread * threads;
+
+    ArrayList< Pointer<SenderTask> > tasks;
+    ArrayList< Pointer<Thread> > workers;
+    for( int i = 0; i < threads; ++i ) {
+        tasks.add( Pointer<SenderTask>( new SenderTask( cmsTemplate, destinations, perThread, i, send ) ) );
+        workers.add( Pointer<Thread>( new Thread( tasks.get( i ).get() ) ) );
+    }
+
+    // Let the template create its connection and first session outside the timing.
+    TextCreator creator;
+    cmsTemplate.send( destinations[0], &creator );
+
+    HardwareCounters counters;
+    long long allocationsBefore = AllocationCounter::getAllocations();
+    counters.start();
+    long long startTime = System::nanoTime();
+
+    for( int i = 0; i < threads; ++i ) {
+        workers.get( i )->start();
+    }
+
+    for( int i = 0; i < threads; ++i ) {
+        workers.get( i )->join();
+    }
+
+    long long elapsed = System::nanoTime() - startTime;
+    counters.stop();
+    long long allocations = AllocationCounter::getAllocations() - allocationsBefore;
+
+    LatencyHistogram latency;
+    for( int i = 0; i < threads; ++i ) {
+        CPPUNIT_ASSERT_MESSAGE( tasks.get( i )->error, tasks.get( i )->error.empty() );
+        latency.merge( tasks.get( i )->sendLatency );
+    }
+
+    for( std::size_t i = 0; i < destinations.size(); ++i ) {
+        delete destinations[i];
+    }
+
+    connection->close();
+
+    BenchmarkResult result;
+    result.name = "CmsTemplateBenchmark[" + name + " threads=" + Integer::toString( threads ) + "]";
+    result.iterations = expected;
+    result.meanNanos = latency.getMean();
+    result.p50Nanos = latency.getPercentile( 50.0 );
+    result.p99Nanos = latency.getPercentile( 99.0 );
+    result.p999Nanos = latency.getPercentile( 99.9 );
+    result.maxNanos = latency.getMax();
+    result.opsPerSecond = (double)expected / ( (double)elapsed / 1000000000.0 );
+
+    if( AllocationCounter::isSupported() ) {
+        result.allocationsPerOp = (double)allocations / (double)expected;
+    }
+
+    if( counters.isAvailable() ) {
+        result.cycles = counters.getCycles();
+        result.instructions = counters.getInstructions();
+        result.cacheMisses = counters.getCacheMisses();
+    }
+
+    std::string regression = BenchmarkReporter::getInstance().report( result );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CmsTemplateBenchmark::testSend() {
+
+    for( int i = 0; i < NUM_THREAD_COUNTS; ++i ) {
+        runScenario( "send", THREAD_COUNTS[i], 1, true );
+    }
+
+    for( int i = 0; i < NUM_THREAD_COUNTS; ++i ) {
+        runScenario( "send destinations=" + Integer::toString( ROUTING_DESTINATIONS ),
+                     THREAD_COUNTS[i], ROUTING_DESTINATIONS, true );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CmsTemplateBenchmark::testExecute() {
+
+    for( int i = 0; i < NUM_THREAD_COUNTS; ++i ) {
+        runScenario( "execute", THREAD_COUNTS[i], 1, false );
+    }
+
+    for( int i = 0; i < NUM_THREAD_COUNTS; ++i ) {
+        runScenario( "execute destinations=" + Integer::toString( ROUTING_DESTINATIONS ),
+                     THREAD_COUNTS[i], ROUTING_DESTINATIONS, false );
+    }
+}
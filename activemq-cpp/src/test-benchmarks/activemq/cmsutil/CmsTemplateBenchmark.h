@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CMSUTIL_CMSTEMPLATEBENCHMARK_H_
+#define _ACTIVEMQ_CMSUTIL_CMSTEMPLATEBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+
+#include <string>
+
+namespace activemq{
+namespace cmsutil{
+
+    /**
+     * Measures one CmsTemplate shared by a growing number of threads, over the mock
+     * transport so that little time is spent on the wire.  The execute scenarios run
+     * a callback that does nothing, leaving only the cost of taking a session from
+     * the pool and finding its cached producer.
+     */
+    class CmsTemplateBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( CmsTemplateBenchmark );
+        CPPUNIT_TEST( testSend );
+        CPPUNIT_TEST( testExecute );
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+
+        void runScenario( const std::string& name, int threads, int destinations, bool send );
+
+    public:
+
+        CmsTemplateBenchmark();
+        virtual ~CmsTemplateBenchmark();
+
+        void testSend();
+        void testExecute();
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_CMSUTIL_CMSTEMPLATEBENCHMARK_H_*/
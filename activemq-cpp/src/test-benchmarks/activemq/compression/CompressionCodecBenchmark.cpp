@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionCodecBenchmark.h"
+
+#include <activemq/compression/CompressionCodec.h>
+#include <activemq/compression/CompressionCodecRegistry.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/Random.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::compression;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 2000;
+    const int WARMUP_OPERATIONS = 200;
+    const int BATCH_SIZE = 10;
+
+    const char* CODECS[] = { "deflate", "lz4" };
+    const int CODEC_COUNT = 2;
+
+    struct Payload {
+        std::string name;
+        std::vector<unsigned char> data;
+
+        Payload( const std::string& name, const std::vector<unsigned char>& data ) : name( name ), data( data ) {}
+    };
+
+    // Order records in the shape of a typical JSON message body.
+    std::vector<unsigned char> createText( int size ) {
+
+        std::string text;
+        for( int i = 0; (int)text.size() < size; ++i ) {
+            text += "{\"order\":" + Integer::toString( i ) + ",\"account\":\"ACC-" +
+                    Integer::toString( 100000 + i * 37 % 5000 ) + "\",\"symbol\":\"AMQ\",\"side\":\"" +
+                    ( i % 3 == 0 ? "SELL" : "BUY" ) + "\",\"quantity\":" + Integer::toString( i * 7 % 1000 ) + "}\n";
+        }
+
+        return std::vector<unsigned char>( text.begin(), text.begin() + size );
+    }
+
+    std::vector<unsigned char> createRandom( int size ) {
+        Random random( 42 );
+        std::vector<unsigned char> data( size );
+        random.nextBytes( data );
+        return data;
+    }
+
+    std::vector<Payload> createPayloads() {
+        std::vector<Payload> payloads;
+        payloads.push_back( Payload( "text 1K", createText( 1024 ) ) );
+        payloads.push_back( Payload( "text 64K", createText( 64 * 1024 ) ) );
+        payloads.push_back( Payload( "random 16K", createRandom( 16 * 1024 ) ) );
+        return payloads;
+    }
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class Compress : public Operation {
+    public:
+
+        const CompressionCodec& codec;
+        const std::vector<unsigned char>& input;
+        std::vector<unsigned char> output;
+
+        Compress( const CompressionCodec& codec, const std::vector<unsigned char>& input ) :
+            codec( codec ), input( input ), output() {}
+
+        virtual void run() {
+            codec.compress( &input[0], (int)input.size(), -1, output );
+        }
+    };
+
+    class Decompress : public Operation {
+    public:
+
+        const CompressionCodec& codec;
+        const std::vector<unsigned char>& input;
+        std::vector<unsigned char> output;
+
+        Decompress( const CompressionCodec& codec, const std::vector<unsigned char>& input ) :
+            codec( codec ), input( input ), output() {}
+
+        virtual void run() {
+            codec.decompress( &input[0], (int)input.size(), output );
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation, double bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < BATCH_SIZE; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "CompressionCodecBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodecBenchmark::CompressionCodecBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodecBenchmark::~CompressionCodecBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecBenchmark::testCompress() {
+
+    std::vector<Payload> payloads = createPayloads();
+
+    for( std::size_t i = 0; i < payloads.size(); ++i ) {
+        for( int j = 0; j < CODEC_COUNT; ++j ) {
+
+            CompressionCodec* codec = CompressionCodecRegistry::getInstance().findCodec( CODECS[j] );
+
+            // Reported bytes are the compressed size, compare with the payload's size.
+            Compress compress( *codec, payloads[i].data );
+            compress.run();
+            measure( "compress " + std::string( CODECS[j] ) + " " + payloads[i].name,
+                     compress, (double)compress.output.size() );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecBenchmark::testDecompress() {
+
+    std::vector<Payload> payloads = createPayloads();
+
+    for( std::size_t i = 0; i < payloads.size(); ++i ) {
+        for( int j = 0; j < CODEC_COUNT; ++j ) {
+
+            CompressionCodec* codec = CompressionCodecRegistry::getInstance().findCodec( CODECS[j] );
+
+            std::vector<unsigned char> compressed;
+            codec->compress( &payloads[i].data[0], (int)payloads[i].data.size(), -1, compressed );
+
+            Decompress decompress( *codec, compressed );
+            measure( "decompress " + std::string( CODECS[j] ) + " " + payloads[i].name,
+                     decompress, (double)compressed.size() );
+
+            CPPUNIT_ASSERT( decompress.output == payloads[i].data );
+        }
+    }
+}
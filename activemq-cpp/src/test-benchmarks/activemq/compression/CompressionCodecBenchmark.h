@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECBENCHMARK_H_
+#define _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+
+namespace activemq{
+namespace compression{
+
+    /**
+     * Compares the registered CompressionCodecs on message sized payloads: a small
+     * and a large text document and a block of random bytes that does not compress.
+     * Each result reports the size of the codec's output as its bytes per operation
+     * so the compression ratio can be read next to the time it costs.
+     */
+    class CompressionCodecBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( CompressionCodecBenchmark );
+        CPPUNIT_TEST( testCompress );
+        CPPUNIT_TEST( testDecompress );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        CompressionCodecBenchmark();
+        virtual ~CompressionCodecBenchmark();
+
+        void testCompress();
+        void testDecompress();
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_COMPRESSION_COMPRESSIONCODECBENCHMARK_H_*/
@@ -0,0 +1,221 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageDispatchChannelBenchmark.h"
+
+#include <activemq/core/FifoMessageDispatchChannel.h>
+#include <activemq/core/PriorityMessageDispatchChannel.h>
+#include <activemq/core/SimplePriorityMessageDispatchChannel.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 200000;
+    const int WARMUP_OPERATIONS = 20000;
+    const int BATCH_SIZE = 100;
+    const int BACKLOG = 1000;
+    const int POOL_SIZE = 1024;
+
+    Pointer<MessageDispatch> createDispatch( int priority ) {
+        Pointer<Message> message( new Message() );
+        message->setPriority( (unsigned char) priority );
+        Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+        dispatch->setMessage( message );
+        return dispatch;
+    }
+
+    MessageDispatchChannel* createChannel( const std::string& type ) {
+        if( type == "fifo" ) {
+            return new FifoMessageDispatchChannel();
+        } else if( type == "simple priority" ) {
+            return new SimplePriorityMessageDispatchChannel();
+        } else if( type == "priority" ) {
+            return new PriorityMessageDispatchChannel( false );
+        }
+
+        return new PriorityMessageDispatchChannel( true );
+    }
+
+    const char* CHANNELS[] = { "fifo", "simple priority", "priority", "weighted fair" };
+    const int NUM_CHANNELS = sizeof(CHANNELS) / sizeof(CHANNELS[0]);
+
+    /**
+     * Keeps a backlog in the channel and on each run enqueues the next dispatch of the
+     * pool and takes one out again, counting how many of the lowest priority come out.
+     * An extra lowest priority dispatch can be added every few runs on top of that.
+     */
+    class EnqueueDequeue {
+    public:
+
+        std::auto_ptr<MessageDispatchChannel> channel;
+        std::vector< Pointer<MessageDispatch> > pool;
+        Pointer<MessageDispatch> lowest;
+        int lowestEvery;
+        int next;
+        long long lowestDispatched;
+
+        EnqueueDequeue( const std::string& type, const std::vector<int>& priorities, int lowestEvery = 0 ) :
+            channel( createChannel( type ) ), pool(), lowest( createDispatch( 0 ) ),
+            lowestEvery( lowestEvery ), next( 0 ), lowestDispatched( 0 ) {
+
+            for( int i = 0; i < POOL_SIZE; ++i ) {
+                pool.push_back( createDispatch( priorities[i % priorities.size()] ) );
+            }
+
+            channel->start();
+            for( int i = 0; i < BACKLOG; ++i ) {
+                channel->enqueue( pool[i % POOL_SIZE] );
+            }
+        }
+
+        void run() {
+            if( lowestEvery > 0 && next % lowestEvery == 0 ) {
+                channel->enqueue( lowest );
+            }
+            channel->enqueue( pool[next++ % POOL_SIZE] );
+            if( channel->dequeueNoWait()->getMessage()->getPriority() == 0 ) {
+                lowestDispatched++;
+            }
+        }
+    };
+
+    void measure( const std::string& name, EnqueueDequeue& operation ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        operation.lowestDispatched = 0;
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < BATCH_SIZE; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "MessageDispatchChannelBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageDispatchChannelBenchmark::MessageDispatchChannelBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageDispatchChannelBenchmark::~MessageDispatchChannelBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannelBenchmark::testMixedPriorities() {
+
+    std::vector<int> priorities;
+    for( int i = 0; i < 10; ++i ) {
+        priorities.push_back( ( i * 7 ) % 10 );
+    }
+
+    for( int i = 0; i < NUM_CHANNELS; ++i ) {
+        EnqueueDequeue operation( CHANNELS[i], priorities );
+        measure( std::string( CHANNELS[i] ) + " mixed", operation );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannelBenchmark::testLowPriorityOnly() {
+
+    std::vector<int> priorities( 1, 0 );
+
+    for( int i = 0; i < NUM_CHANNELS; ++i ) {
+        EnqueueDequeue operation( CHANNELS[i], priorities );
+        measure( std::string( CHANNELS[i] ) + " lowest only", operation );
+        CPPUNIT_ASSERT_EQUAL( (long long) OPERATIONS, operation.lowestDispatched );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDispatchChannelBenchmark::testWeightedFairShare() {
+
+    // The highest priority arrives as fast as it is dispatched, with one extra Message of
+    // the lowest priority every sixteen, strict priority order starves the lowest completely.
+    std::vector<int> priorities( 1, 9 );
+
+    EnqueueDequeue strict( "priority", priorities, 16 );
+    measure( "priority sustained load", strict );
+    CPPUNIT_ASSERT_EQUAL( 0LL, strict.lowestDispatched );
+
+    EnqueueDequeue fair( "weighted fair", priorities, 16 );
+    measure( "weighted fair sustained load", fair );
+
+    // The lowest may take one of every eleven dispatches, more than it needs to keep up.
+    CPPUNIT_ASSERT( fair.lowestDispatched > OPERATIONS / 20 );
+}
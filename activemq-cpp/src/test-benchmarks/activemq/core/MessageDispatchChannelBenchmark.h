@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_MESSAGEDISPATCHCHANNELBENCHMARK_H_
+#define _ACTIVEMQ_CORE_MESSAGEDISPATCHCHANNELBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+
+namespace activemq{
+namespace core{
+
+    /**
+     * Measures the cost of moving a Message through each MessageDispatchChannel while
+     * a backlog is held in it, with every priority level in use and with only the
+     * lowest level in use, which is the worst case for a channel that scans its levels.
+     *
+     * The weighted fair scenario also checks that the lowest priority keeps receiving
+     * its share of dispatches while the highest priority never runs dry.
+     */
+    class MessageDispatchChannelBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( MessageDispatchChannelBenchmark );
+        CPPUNIT_TEST( testMixedPriorities );
+        CPPUNIT_TEST( testLowPriorityOnly );
+        CPPUNIT_TEST( testWeightedFairShare );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        MessageDispatchChannelBenchmark();
+        virtual ~MessageDispatchChannelBenchmark();
+
+        void testMixedPriorities();
+        void testLowPriorityOnly();
+        void testWeightedFairShare();
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_CORE_MESSAGEDISPATCHCHANNELBENCHMARK_H_*/
@@ -0,0 +1,536 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessagingBenchmark.h"
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConsumer.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/mock/LoopbackBroker.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <cms/BatchMessageConsumer.h>
+#include <cms/BytesMessage.h>
+#include <cms/Connection.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageProducer.h>
+#include <cms/Queue.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/ArrayList.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace cms;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::mock;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int TOTAL_MESSAGES = 4000;
+    const std::string SEND_TIME_PROPERTY = "BenchmarkSendTime";
+
+    const int PAYLOAD_SIZES[] = { 64, 1024, 16384 };
+    const int NUM_PAYLOAD_SIZES = sizeof( PAYLOAD_SIZES ) / sizeof( int );
+
+    const int REGISTRATION_CONSUMERS = 500;
+    const long long REGISTRATION_RESPONSE_DELAY = 1;
+
+    const int RECEIVE_ROUNDS = 4;
+    const int RECEIVE_PREFETCH = 1000;
+
+    const int BATCH_SIZES[] = { 0, 16, 128 };
+    const int NUM_BATCH_SIZES = sizeof( BATCH_SIZES ) / sizeof( int );
+
+    const int PRODUCER_COUNTS[] = { 1, 4 };
+    const int NUM_PRODUCER_COUNTS = sizeof( PRODUCER_COUNTS ) / sizeof( int );
+
+    const cms::Session::AcknowledgeMode ACK_MODES[] = {
+        cms::Session::AUTO_ACKNOWLEDGE,
+        cms::Session::DUPS_OK_ACKNOWLEDGE,
+        cms::Session::CLIENT_ACKNOWLEDGE,
+        cms::Session::INDIVIDUAL_ACKNOWLEDGE
+    };
+    const int NUM_ACK_MODES = sizeof( ACK_MODES ) / sizeof( cms::Session::AcknowledgeMode );
+
+    int destinationCounter = 0;
+
+    std::string ackModeName( cms::Session::AcknowledgeMode mode ) {
+        switch( mode ) {
+            case cms::Session::AUTO_ACKNOWLEDGE:
+                return "AUTO";
+            case cms::Session::DUPS_OK_ACKNOWLEDGE:
+                return "DUPS_OK";
+            case cms::Session::CLIENT_ACKNOWLEDGE:
+                return "CLIENT";
+            case cms::Session::INDIVIDUAL_ACKNOWLEDGE:
+                return "INDIVIDUAL";
+            default:
+                return "TRANSACTED";
+        }
+    }
+
+    std::string withOptions( const std::string& uri ) {
+
+        std::string options;
+
+        try{
+            options = System::getenv( "AMQCPP_BENCHMARK_URI_OPTIONS" );
+        } catch( Exception& ex ) {
+            // Not set, run with the defaults.
+        }
+
+        if( options.empty() ) {
+            return uri;
+        }
+
+        return uri + ( uri.find( '?' ) == std::string::npos ? "?" : "&" ) + options;
+    }
+
+    class ProducerTask : public Runnable {
+    private:
+
+        ProducerTask( const ProducerTask& );
+        ProducerTask& operator= ( const ProducerTask& );
+
+    public:
+
+        cms::Connection* connection;
+        std::string destination;
+        int count;
+        int payloadSize;
+        LatencyHistogram sendLatency;
+        std::string error;
+
+        ProducerTask( cms::Connection* connection, const std::string& destination, int count, int payloadSize ) :
+            Runnable(), connection( connection ), destination( destination ), count( count ),
+            payloadSize( payloadSize ), sendLatency(), error() {
+        }
+
+        virtual ~ProducerTask() {}
+
+        virtual void run() {
+
+            try{
+
+                std::auto_ptr<cms::Session> session( connection->createSession( cms::Session::AUTO_ACKNOWLEDGE ) );
+                std::auto_ptr<cms::Queue> queue( session->createQueue( destination ) );
+                std::auto_ptr<cms::MessageProducer> producer( session->createProducer( queue.get() ) );
+
+                std::vector<unsigned char> payload( payloadSize, 'a' );
+
+                for( int i = 0; i < count; ++i ) {
+                    std::auto_ptr<cms::BytesMessage> message(
+                        session->createBytesMessage( &payload[0], (int)payload.size() ) );
+
+                    long long start = System::nanoTime();
+                    message->setLongProperty( SEND_TIME_PROPERTY, start );
+                    producer->send( message.get() );
+                    sendLatency.record( System::nanoTime() - start );
+                }
+
+                session->close();
+
+            } catch( cms::CMSException& ex ) {
+                error = ex.getMessage();
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagingBenchmark::MessagingBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagingBenchmark::~MessagingBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::runScenario( const std::string& transportName,
+                                      const std::string& brokerURI,
+                                      int payloadSize,
+                                      cms::Session::AcknowledgeMode ackMode,
+                                      int producers,
+                                      bool consume ) {
+
+    std::string destination = "benchmark." + Integer::toString( ++destinationCounter );
+    ActiveMQConnectionFactory factory( withOptions( brokerURI ) );
+
+    std::auto_ptr<cms::Connection> producerConnection( factory.createConnection() );
+    std::auto_ptr<cms::Connection> consumerConnection;
+    std::auto_ptr<cms::Session> consumerSession;
+    std::auto_ptr<cms::Queue> queue;
+    std::auto_ptr<cms::MessageConsumer> consumer;
+
+    if( consume ) {
+        consumerConnection.reset( factory.createConnection() );
+        consumerSession.reset( consumerConnection->createSession( ackMode ) );
+        queue.reset( consumerSession->createQueue( destination ) );
+        consumer.reset( consumerSession->createConsumer( queue.get() ) );
+        consumerConnection->start();
+    }
+
+    producerConnection->start();
+
+    int perProducer = TOTAL_MESSAGES / producers;
+    int expected = perProducer * producers;
+
+    ArrayList< Pointer<ProducerTask> > tasks;
+    ArrayList< Pointer<Thread> > threads;
+    for( int i = 0; i < producers; ++i ) {
+        tasks.add( Pointer<ProducerTask>(
+            new ProducerTask( producerConnection.get(), destination, perProducer, payloadSize ) ) );
+        threads.add( Pointer<Thread>( new Thread( tasks.get( i ).get() ) ) );
+    }
+
+    LatencyHistogram latency;
+    HardwareCounters counters;
+
+    long long allocationsBefore = AllocationCounter::getAllocations();
+    counters.start();
+    long long startTime = System::nanoTime();
+
+    for( int i = 0; i < producers; ++i ) {
+        threads.get( i )->start();
+    }
+
+    int received = 0;
+    if( consume ) {
+        while( received < expected ) {
+            std::auto_ptr<cms::Message> message( consumer->receive( 10000 ) );
+            if( message.get() == NULL ) {
+                break;
+            }
+
+            latency.record( System::nanoTime() - message->getLongProperty( SEND_TIME_PROPERTY ) );
+
+            if( ackMode == cms::Session::CLIENT_ACKNOWLEDGE ||
+                ackMode == cms::Session::INDIVIDUAL_ACKNOWLEDGE ) {
+                message->acknowledge();
+            }
+
+            received++;
+        }
+    }
+
+    for( int i = 0; i < producers; ++i ) {
+        threads.get( i )->join();
+    }
+
+    long long elapsed = System::nanoTime() - startTime;
+    counters.stop();
+    long long allocations = AllocationCounter::getAllocations() - allocationsBefore;
+
+    for( int i = 0; i < producers; ++i ) {
+        CPPUNIT_ASSERT_MESSAGE( tasks.get( i )->error, tasks.get( i )->error.empty() );
+        if( !consume ) {
+            latency.merge( tasks.get( i )->sendLatency );
+        }
+    }
+
+    if( consume ) {
+        CPPUNIT_ASSERT_EQUAL( expected, received );
+        consumerConnection->close();
+    }
+
+    producerConnection->close();
+
+    BenchmarkResult result;
+    result.name = "MessagingBenchmark[" + transportName +
+                  " payload=" + Integer::toString( payloadSize ) +
+                  " ack=" + ackModeName( ackMode ) +
+                  " producers=" + Integer::toString( producers ) + "]";
+    result.iterations = expected;
+    result.meanNanos = latency.getMean();
+    result.p50Nanos = latency.getPercentile( 50.0 );
+    result.p99Nanos = latency.getPercentile( 99.0 );
+    result.p999Nanos = latency.getPercentile( 99.9 );
+    result.maxNanos = latency.getMax();
+    result.opsPerSecond = (double)expected / ( (double)elapsed / 1000000000.0 );
+
+    if( AllocationCounter::isSupported() ) {
+        result.allocationsPerOp = (double)allocations / (double)expected;
+    }
+
+    if( counters.isAvailable() ) {
+        result.cycles = counters.getCycles();
+        result.instructions = counters.getInstructions();
+        result.cacheMisses = counters.getCacheMisses();
+    }
+
+    std::string regression = BenchmarkReporter::getInstance().report( result );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::runReceiveScenario( cms::Session::AcknowledgeMode ackMode, int batchSize ) {
+
+    std::string destination = "benchmark." + Integer::toString( ++destinationCounter );
+    ActiveMQConnectionFactory factory( withOptions( "mock://127.0.0.1:23232?wireFormat=openwire" ) );
+
+    std::auto_ptr<ActiveMQConnection> connection(
+        dynamic_cast<ActiveMQConnection*>( factory.createConnection() ) );
+    transport::mock::MockTransport* transport = dynamic_cast<transport::mock::MockTransport*>(
+        connection->getTransport().narrow( typeid( transport::mock::MockTransport ) ) );
+    CPPUNIT_ASSERT( transport != NULL );
+
+    std::auto_ptr<cms::Session> session( connection->createSession( ackMode ) );
+    std::auto_ptr<cms::Queue> queue( session->createQueue( destination ) );
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>( session->createConsumer( queue.get() ) ) );
+    connection->start();
+
+    Pointer<ProducerId> producerId( new ProducerId() );
+    producerId->setConnectionId( consumer->getConsumerId()->getConnectionId() );
+    producerId->setSessionId( consumer->getConsumerId()->getSessionId() );
+    producerId->setValue( 1 );
+
+    LatencyHistogram latency;
+    long long elapsed = 0;
+    long long allocations = 0;
+    int received = 0;
+    long long sequence = 0;
+
+    // The broker side is replaced by filling the prefetch window directly so only
+    // the consumer's receive path is timed, latency is per receive call.
+    for( int round = 0; round < RECEIVE_ROUNDS; ++round ) {
+
+        for( int i = 0; i < RECEIVE_PREFETCH; ++i ) {
+            Pointer<MessageId> messageId( new MessageId() );
+            messageId->setProducerId( producerId );
+            messageId->setProducerSequenceId( ++sequence );
+
+            Pointer<ActiveMQTextMessage> message( new ActiveMQTextMessage() );
+            message->setText( std::string( PAYLOAD_SIZES[0], 'a' ) );
+            message->setMessageId( messageId );
+            message->setCMSDestination( queue.get() );
+
+            Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+            dispatch->setMessage( message );
+            dispatch->setConsumerId( consumer->getConsumerId() );
+            transport->fireCommand( dispatch );
+        }
+
+        for( int i = 0; i < 500 && consumer->getMessageAvailableCount() < RECEIVE_PREFETCH; ++i ) {
+            Thread::sleep( 10 );
+        }
+        CPPUNIT_ASSERT_EQUAL( RECEIVE_PREFETCH, consumer->getMessageAvailableCount() );
+
+        long long allocationsBefore = AllocationCounter::getAllocations();
+        long long startTime = System::nanoTime();
+
+        int remaining = RECEIVE_PREFETCH;
+        while( remaining > 0 ) {
+            long long start = System::nanoTime();
+
+            if( batchSize > 0 ) {
+                std::vector<cms::Message*> messages = consumer->receive( batchSize, -1 );
+                CPPUNIT_ASSERT( !messages.empty() );
+
+                if( ackMode == cms::Session::CLIENT_ACKNOWLEDGE ) {
+                    messages.back()->acknowledge();
+                }
+
+                for( std::size_t j = 0; j < messages.size(); ++j ) {
+                    if( ackMode == cms::Session::INDIVIDUAL_ACKNOWLEDGE ) {
+                        messages[j]->acknowledge();
+                    }
+                    delete messages[j];
+                }
+
+                remaining -= (int)messages.size();
+            } else {
+                std::auto_ptr<cms::Message> message( consumer->receiveNoWait() );
+                CPPUNIT_ASSERT( message.get() != NULL );
+
+                if( ackMode == cms::Session::CLIENT_ACKNOWLEDGE ||
+                    ackMode == cms::Session::INDIVIDUAL_ACKNOWLEDGE ) {
+                    message->acknowledge();
+                }
+
+                remaining--;
+            }
+
+            latency.record( System::nanoTime() - start );
+        }
+
+        elapsed += System::nanoTime() - startTime;
+        allocations += AllocationCounter::getAllocations() - allocationsBefore;
+        received += RECEIVE_PREFETCH;
+    }
+
+    connection->close();
+
+    BenchmarkResult result;
+    result.name = "MessagingBenchmark[mock receive ack=" + ackModeName( ackMode ) +
+                  ( batchSize > 0 ? " batch=" + Integer::toString( batchSize ) : std::string( " single" ) ) + "]";
+    result.iterations = received;
+    result.meanNanos = latency.getMean();
+    result.p50Nanos = latency.getPercentile( 50.0 );
+    result.p99Nanos = latency.getPercentile( 99.0 );
+    result.p999Nanos = latency.getPercentile( 99.9 );
+    result.maxNanos = latency.getMax();
+    result.opsPerSecond = (double)received / ( (double)elapsed / 1000000000.0 );
+
+    if( AllocationCounter::isSupported() ) {
+        result.allocationsPerOp = (double)allocations / (double)received;
+    }
+
+    std::string regression = BenchmarkReporter::getInstance().report( result );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::runRegistrationScenario( const std::string& brokerURI, bool asyncRegistration ) {
+
+    ActiveMQConnectionFactory factory( withOptions( brokerURI ) );
+    factory.setAsyncRegistration( asyncRegistration );
+
+    std::auto_ptr<cms::Connection> connection( factory.createConnection() );
+    ActiveMQConnection* amqConnection = dynamic_cast<ActiveMQConnection*>( connection.get() );
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+
+    std::vector<cms::Queue*> queues;
+    for( int i = 0; i < REGISTRATION_CONSUMERS; ++i ) {
+        queues.push_back( session->createQueue( "registration." + Integer::toString( i ) ) );
+    }
+
+    std::vector<cms::MessageConsumer*> consumers;
+    LatencyHistogram latency;
+
+    long long allocationsBefore = AllocationCounter::getAllocations();
+    long long startTime = System::nanoTime();
+
+    // Latency is the time each create call blocks, the pipelined total includes
+    // waiting for the Broker to answer every registration.
+    for( int i = 0; i < REGISTRATION_CONSUMERS; ++i ) {
+        long long start = System::nanoTime();
+        consumers.push_back( session->createConsumer( queues[i] ) );
+        latency.record( System::nanoTime() - start );
+    }
+
+    CPPUNIT_ASSERT( amqConnection->awaitRegistrations( 10000 ) );
+
+    long long elapsed = System::nanoTime() - startTime;
+    long long allocations = AllocationCounter::getAllocations() - allocationsBefore;
+
+    for( int i = 0; i < REGISTRATION_CONSUMERS; ++i ) {
+        delete consumers[i];
+        delete queues[i];
+    }
+
+    connection->close();
+
+    BenchmarkResult result;
+    result.name = std::string( "MessagingBenchmark[loopback registration " ) +
+                  ( asyncRegistration ? "async" : "sync" ) +
+                  " consumers=" + Integer::toString( REGISTRATION_CONSUMERS ) +
+                  " delay=" + Integer::toString( (int)REGISTRATION_RESPONSE_DELAY ) + "ms]";
+    result.iterations = REGISTRATION_CONSUMERS;
+    result.meanNanos = latency.getMean();
+    result.p50Nanos = latency.getPercentile( 50.0 );
+    result.p99Nanos = latency.getPercentile( 99.0 );
+    result.p999Nanos = latency.getPercentile( 99.9 );
+    result.maxNanos = latency.getMax();
+    result.opsPerSecond = (double)REGISTRATION_CONSUMERS / ( (double)elapsed / 1000000000.0 );
+
+    if( AllocationCounter::isSupported() ) {
+        result.allocationsPerOp = (double)allocations / (double)REGISTRATION_CONSUMERS;
+    }
+
+    std::string regression = BenchmarkReporter::getInstance().report( result );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testMockTransportSend() {
+
+    // There's no consumer side over the mock so only the producer thread count
+    // and payload size are varied, latency is the time spent in send.
+    for( int i = 0; i < NUM_PAYLOAD_SIZES; ++i ) {
+        for( int j = 0; j < NUM_PRODUCER_COUNTS; ++j ) {
+            runScenario( "mock", "mock://127.0.0.1:23232?wireFormat=openwire",
+                         PAYLOAD_SIZES[i], cms::Session::AUTO_ACKNOWLEDGE, PRODUCER_COUNTS[j], false );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testMockTransportReceive() {
+
+    // A batch size of zero is the one message per receive call baseline.
+    for( int i = 0; i < NUM_ACK_MODES; ++i ) {
+        for( int j = 0; j < NUM_BATCH_SIZES; ++j ) {
+            runReceiveScenario( ACK_MODES[i], BATCH_SIZES[j] );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testLoopbackBrokerSendReceive() {
+
+    LoopbackBroker broker;
+    broker.start();
+
+    // Latency here is from the call to send until the consumer has the message.
+    for( int i = 0; i < NUM_PAYLOAD_SIZES; ++i ) {
+        for( int j = 0; j < NUM_ACK_MODES; ++j ) {
+            for( int k = 0; k < NUM_PRODUCER_COUNTS; ++k ) {
+                runScenario( "loopback", broker.getConnectString(),
+                             PAYLOAD_SIZES[i], ACK_MODES[j], PRODUCER_COUNTS[k], true );
+            }
+        }
+    }
+
+    broker.stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagingBenchmark::testLoopbackBrokerRegistration() {
+
+    LoopbackBroker broker;
+    broker.setResponseDelay( REGISTRATION_RESPONSE_DELAY );
+    broker.start();
+
+    // Each synchronous registration costs a round trip, pipelined ones share them.
+    runRegistrationScenario( broker.getConnectString(), false );
+    runRegistrationScenario( broker.getConnectString(), true );
+
+    broker.stop();
+}
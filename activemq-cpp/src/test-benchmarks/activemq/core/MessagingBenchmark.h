@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_
+#define _ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+#include <cms/Session.h>
+
+#include <string>
+
+namespace activemq{
+namespace core{
+
+    /**
+     * End to end benchmarks that drive real Connection, Session, Producer and Consumer
+     * objects.  Producer side throughput is measured over the MockTransport and the
+     * full send to receive path over TCP against an in-process LoopbackBroker.
+     *
+     * The consumer side receive path is also measured alone over the MockTransport by
+     * filling the prefetch window directly, both one message at a time and in batches.
+     *
+     * Each scenario is reported through the BenchmarkReporter with its throughput,
+     * the send to receive latency percentiles and the allocations per message.  Extra URI
+     * options can be applied to every scenario with the AMQCPP_BENCHMARK_URI_OPTIONS
+     * environment variable, e.g. "connection.useAsyncSend=true".
+     */
+    class MessagingBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( MessagingBenchmark );
+        CPPUNIT_TEST( testMockTransportSend );
+        CPPUNIT_TEST( testMockTransportReceive );
+        CPPUNIT_TEST( testLoopbackBrokerSendReceive );
+        CPPUNIT_TEST( testLoopbackBrokerRegistration );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        MessagingBenchmark();
+        virtual ~MessagingBenchmark();
+
+        void testMockTransportSend();
+        void testMockTransportReceive();
+        void testLoopbackBrokerSendReceive();
+        void testLoopbackBrokerRegistration();
+
+    private:
+
+        void runScenario( const std::string& transportName,
+                          const std::string& brokerURI,
+                          int payloadSize,
+                          cms::Session::AcknowledgeMode ackMode,
+                          int producers,
+                          bool consume );
+
+        void runReceiveScenario( cms::Session::AcknowledgeMode ackMode, int batchSize );
+
+        void runRegistrationScenario( const std::string& brokerURI, bool asyncRegistration );
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_CORE_MESSAGINGBENCHMARK_H_*/
@@ -0,0 +1,502 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackBroker.h"
+
+#include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireResponseBuilder.h>
+#include <activemq/commands/Command.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/Response.h>
+#include <activemq/commands/WireFormatInfo.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/net/ServerSocket.h>
+#include <decaf/net/Socket.h>
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/BufferedOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/ArrayList.h>
+#include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::mock;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::transport::mock;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::io;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace mock {
+
+    class BrokerConnection;
+
+    class Subscription {
+    public:
+
+        Pointer<ConsumerId> consumerId;
+        Pointer<ActiveMQDestination> destination;
+        BrokerConnection* connection;
+
+        Subscription() : consumerId(), destination(), connection(NULL) {}
+    };
+
+    class LoopbackRouter {
+    private:
+
+        LoopbackRouter(const LoopbackRouter&);
+        LoopbackRouter& operator= (const LoopbackRouter&);
+
+    public:
+
+        Mutex mutex;
+        std::vector<Subscription> subscriptions;
+        unsigned int nextQueueConsumer;
+
+        LoopbackRouter() : mutex(), subscriptions(), nextQueueConsumer(0) {}
+
+        void addConsumer(BrokerConnection* connection, const Pointer<ConsumerInfo> info);
+
+        void removeConsumer(const Pointer<ConsumerId> consumerId);
+
+        void removeConnection(BrokerConnection* connection);
+
+        void route(const Pointer<Message> message);
+    };
+
+    // Holds each Response back for the same time so they still leave in the order the
+    // requests came in, as they would over a slow link.
+    class ResponseDelayer : public Thread {
+    private:
+
+        ResponseDelayer(const ResponseDelayer&);
+        ResponseDelayer& operator= (const ResponseDelayer&);
+
+    private:
+
+        BrokerConnection* connection;
+        long long delay;
+        std::deque< std::pair<long long, Pointer<Command> > > pending;
+        Mutex lock;
+        bool done;
+
+    public:
+
+        ResponseDelayer(BrokerConnection* connection, long long delay) :
+            Thread(), connection(connection), delay(delay), pending(), lock(), done(false) {
+        }
+
+        virtual ~ResponseDelayer() {
+            shutdown();
+        }
+
+        void post(const Pointer<Command> response) {
+            synchronized(&lock) {
+                pending.push_back(std::make_pair(System::currentTimeMillis() + delay, response));
+                lock.notify();
+            }
+        }
+
+        void shutdown() {
+            synchronized(&lock) {
+                done = true;
+                lock.notify();
+            }
+
+            try {
+                this->join();
+            } catch (...) {}
+        }
+
+        virtual void run();
+    };
+
+    class BrokerConnection : public Thread {
+    private:
+
+        BrokerConnection(const BrokerConnection&);
+        BrokerConnection& operator= (const BrokerConnection&);
+
+    private:
+
+        LoopbackRouter* router;
+        std::auto_ptr<Socket> socket;
+        Pointer<OpenWireFormat> wireFormat;
+        Pointer<OpenWireResponseBuilder> responseBuilder;
+        Pointer<MockTransport> transport;
+        std::auto_ptr<DataInputStream> dataIn;
+        std::auto_ptr<DataOutputStream> dataOut;
+        std::auto_ptr<ResponseDelayer> delayer;
+        Mutex writeLock;
+        volatile bool done;
+
+    public:
+
+        BrokerConnection(LoopbackRouter* router, Socket* socket, long long responseDelay) :
+            Thread(), router(router), socket(socket), wireFormat(), responseBuilder(), transport(),
+            dataIn(), dataOut(), delayer(), writeLock(), done(false) {
+
+            Properties properties;
+            this->wireFormat = OpenWireFormatFactory().createWireFormat(properties).dynamicCast<OpenWireFormat>();
+            this->responseBuilder.reset(new OpenWireResponseBuilder());
+            this->transport.reset(new MockTransport(this->wireFormat, this->responseBuilder));
+
+            this->socket->setSoLinger(false, 0);
+            this->socket->setTcpNoDelay(true);
+
+            this->dataIn.reset(new DataInputStream(
+                new BufferedInputStream(this->socket->getInputStream(), 8192), true));
+            this->dataOut.reset(new DataOutputStream(
+                new BufferedOutputStream(this->socket->getOutputStream(), 8192), true));
+
+            if (responseDelay > 0) {
+                this->delayer.reset(new ResponseDelayer(this, responseDelay));
+                this->delayer->start();
+            }
+        }
+
+        virtual ~BrokerConnection() {
+            close();
+            try {
+                this->join();
+            } catch (...) {}
+
+            if (this->delayer.get() != NULL) {
+                this->delayer->shutdown();
+            }
+        }
+
+        void close() {
+            this->done = true;
+            try {
+                this->socket->close();
+            } catch (...) {}
+        }
+
+        void send(const Pointer<Command> command) {
+            synchronized(&writeLock) {
+                this->wireFormat->marshal(command, this->transport.get(), this->dataOut.get());
+                this->dataOut->flush();
+            }
+        }
+
+        virtual void run() {
+
+            try {
+
+                send(this->wireFormat->getPreferedWireFormatInfo());
+
+                while (!done) {
+
+                    Pointer<Command> command = this->wireFormat->unmarshal(this->transport.get(), this->dataIn.get());
+
+                    if (command->isWireFormatInfo()) {
+                        Pointer<WireFormatInfo> info = command.dynamicCast<WireFormatInfo>();
+                        this->wireFormat->renegotiateWireFormat(*info);
+                    } else if (command->isConsumerInfo()) {
+                        this->router->addConsumer(this, command.dynamicCast<ConsumerInfo>());
+                    } else if (command->isRemoveInfo()) {
+                        Pointer<RemoveInfo> info = command.dynamicCast<RemoveInfo>();
+                        if (info->getObjectId()->getDataStructureType() == ConsumerId::ID_CONSUMERID) {
+                            this->router->removeConsumer(info->getObjectId().dynamicCast<ConsumerId>());
+                        }
+                    } else if (command->isMessage()) {
+                        this->router->route(command.dynamicCast<Message>());
+                    } else if (command->isShutdownInfo()) {
+                        break;
+                    }
+
+                    Pointer<Response> response = this->responseBuilder->buildResponse(command);
+                    if (response != NULL) {
+                        if (this->delayer.get() != NULL) {
+                            this->delayer->post(response);
+                        } else {
+                            send(response);
+                        }
+                    }
+                }
+
+            } catch (...) {
+            }
+
+            this->router->removeConnection(this);
+            this->done = true;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    void LoopbackRouter::addConsumer(BrokerConnection* connection, const Pointer<ConsumerInfo> info) {
+
+        Subscription subscription;
+        subscription.consumerId = info->getConsumerId();
+        subscription.destination = info->getDestination();
+        subscription.connection = connection;
+
+        synchronized(&mutex) {
+            subscriptions.push_back(subscription);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    void LoopbackRouter::removeConsumer(const Pointer<ConsumerId> consumerId) {
+
+        synchronized(&mutex) {
+            std::vector<Subscription>::iterator iter = subscriptions.begin();
+            for (; iter != subscriptions.end(); ++iter) {
+                if (iter->consumerId->equals(consumerId.get())) {
+                    subscriptions.erase(iter);
+                    break;
+                }
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    void LoopbackRouter::removeConnection(BrokerConnection* connection) {
+
+        synchronized(&mutex) {
+            std::vector<Subscription>::iterator iter = subscriptions.begin();
+            while (iter != subscriptions.end()) {
+                if (iter->connection == connection) {
+                    iter = subscriptions.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    void LoopbackRouter::route(const Pointer<Message> message) {
+
+        std::vector<Subscription> targets;
+
+        synchronized(&mutex) {
+
+            std::vector<Subscription>::const_iterator iter = subscriptions.begin();
+            for (; iter != subscriptions.end(); ++iter) {
+                if (iter->destination->equals(message->getDestination().get())) {
+                    targets.push_back(*iter);
+                }
+            }
+
+            if (message->getDestination()->isQueue() && targets.size() > 1) {
+                Subscription selected = targets[nextQueueConsumer++ % targets.size()];
+                targets.clear();
+                targets.push_back(selected);
+            }
+        }
+
+        std::vector<Subscription>::const_iterator iter = targets.begin();
+        for (; iter != targets.end(); ++iter) {
+
+            const Subscription& subscription = *iter;
+
+            Pointer<MessageDispatch> dispatch(new MessageDispatch());
+            dispatch->setConsumerId(subscription.consumerId);
+            dispatch->setDestination(message->getDestination());
+            dispatch->setMessage(message->copy());
+            dispatch->setRedeliveryCounter(0);
+
+            try {
+                subscription.connection->send(dispatch);
+            } catch (...) {
+                // The consumer's connection is going away, it cleans up after itself.
+            }
+        }
+    }
+
+    void ResponseDelayer::run() {
+
+        while (true) {
+
+            std::pair<long long, Pointer<Command> > next;
+
+            synchronized(&lock) {
+                while (pending.empty() && !done) {
+                    lock.wait();
+                }
+
+                if (done) {
+                    return;
+                }
+
+                next = pending.front();
+                pending.pop_front();
+            }
+
+            long long wait = next.first - System::currentTimeMillis();
+            if (wait > 0) {
+                Thread::sleep(wait);
+            }
+
+            try {
+                connection->send(next.second);
+            } catch (...) {
+            }
+        }
+    }
+
+    class LoopbackBrokerImpl : public Thread {
+    private:
+
+        LoopbackBrokerImpl(const LoopbackBrokerImpl&);
+        LoopbackBrokerImpl& operator= (const LoopbackBrokerImpl&);
+
+    public:
+
+        Pointer<ServerSocket> server;
+        LoopbackRouter router;
+        ArrayList< Pointer<BrokerConnection> > connections;
+        Mutex connectionsLock;
+        long long responseDelay;
+        volatile bool done;
+
+        LoopbackBrokerImpl() : Thread(), server(), router(), connections(), connectionsLock(), responseDelay(0), done(false) {}
+
+        virtual ~LoopbackBrokerImpl() {}
+
+        void shutdown() {
+
+            this->done = true;
+
+            try {
+                if (this->server != NULL) {
+                    this->server->close();
+                }
+            } catch (...) {}
+
+            try {
+                this->join();
+            } catch (...) {}
+
+            synchronized(&connectionsLock) {
+                for (int i = 0; i < connections.size(); ++i) {
+                    connections.get(i)->close();
+                }
+
+                // Destroying the connections waits for their threads to finish.
+                connections.clear();
+            }
+        }
+
+        virtual void run() {
+
+            while (!done) {
+                try {
+                    Socket* socket = this->server->accept();
+                    Pointer<BrokerConnection> connection(new BrokerConnection(&router, socket, responseDelay));
+
+                    synchronized(&connectionsLock) {
+                        connections.add(connection);
+                    }
+
+                    connection->start();
+                } catch (...) {
+                }
+            }
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackBroker::LoopbackBroker() : impl(new LoopbackBrokerImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackBroker::~LoopbackBroker() {
+    try {
+        stop();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    try {
+        delete impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackBroker::start() {
+
+    if (this->impl->server != NULL) {
+        return;
+    }
+
+    this->impl->server.reset(new ServerSocket(0));
+    this->impl->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackBroker::stop() {
+
+    if (this->impl->server == NULL || this->impl->done) {
+        return;
+    }
+
+    this->impl->shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackBroker::setResponseDelay(long long millis) {
+    this->impl->responseDelay = millis;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LoopbackBroker::getResponseDelay() const {
+    return this->impl->responseDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LoopbackBroker::getPort() const {
+
+    if (this->impl->server != NULL) {
+        return this->impl->server->getLocalPort();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LoopbackBroker::getConnectString() const {
+    return std::string("tcp://localhost:") + Integer::toString(getPort());
+}
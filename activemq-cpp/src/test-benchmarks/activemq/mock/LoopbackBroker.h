@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_MOCK_LOOPBACKBROKER_H_
+#define _ACTIVEMQ_MOCK_LOOPBACKBROKER_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+
+namespace activemq {
+namespace mock {
+
+    class LoopbackBrokerImpl;
+
+    /**
+     * A minimal in-process stand in for a broker that speaks OpenWire over TCP on the
+     * loopback interface.  It answers every command that requires a response, tracks
+     * the consumers that clients create and routes each message a producer sends to
+     * the consumers on the same destination, round robin for Queues and to all of
+     * them for Topics.  Nothing is stored and acks are ignored, its only purpose is
+     * to exercise the full client stack in the benchmarks.
+     */
+    class LoopbackBroker {
+    private:
+
+        LoopbackBroker(const LoopbackBroker&);
+        LoopbackBroker& operator= (const LoopbackBroker&);
+
+    private:
+
+        LoopbackBrokerImpl* impl;
+
+    public:
+
+        LoopbackBroker();
+
+        virtual ~LoopbackBroker();
+
+    public:
+
+        /**
+         * Binds to an ephemeral port and starts accepting client connections.
+         */
+        void start();
+
+        /**
+         * Stops accepting connections and closes all the connected clients.
+         */
+        void stop();
+
+        /**
+         * Sets how long every Response is held before it is written, which stands in
+         * for the round trip time of a slow link.  Only connections accepted after the
+         * call are affected, messages routed to consumers are never delayed.
+         *
+         * @param millis
+         *      The delay in milliseconds, zero (the default) answers right away.
+         */
+        void setResponseDelay(long long millis);
+
+        /**
+         * @return the delay in milliseconds applied to each Response.
+         */
+        long long getResponseDelay() const;
+
+        /**
+         * @return the URI a client uses to connect to this broker.
+         */
+        std::string getConnectString() const;
+
+        /**
+         * @return the port the broker is bound to, or zero if not started.
+         */
+        int getPort() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_MOCK_LOOPBACKBROKER_H_ */
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageSelectorBenchmark.h"
+
+#include <activemq/selector/SelectorParser.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::selector;
+using namespace activemq::commands;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 200000;
+    const int WARMUP_OPERATIONS = 20000;
+    const int BATCH_SIZE = 100;
+
+    const char* SELECTORS[][2] = {
+        { "property", "region = 'EU'" },
+        { "header", "JMSPriority > 4" },
+        { "compound", "region = 'EU' AND amount BETWEEN 100 AND 5000 AND JMSType = 'order'" },
+        { "like and in", "path LIKE 'orders/%/new' AND status IN ('NEW', 'OPEN', 'PENDING')" },
+        { "arithmetic", "amount * 1.2 + fee > 1000 OR (retries IS NOT NULL AND retries < 3)" },
+        { "no match", "region = 'US' OR amount > 100000 OR status NOT IN ('NEW')" }
+    };
+
+    const int NUM_SELECTORS = sizeof(SELECTORS) / sizeof(SELECTORS[0]);
+
+    Pointer<ActiveMQTextMessage> createMessage() {
+        Pointer<ActiveMQTextMessage> message( new ActiveMQTextMessage() );
+        message->setCMSType( "order" );
+        message->setCMSPriority( 6 );
+        message->setStringProperty( "region", "EU" );
+        message->setStringProperty( "status", "NEW" );
+        message->setStringProperty( "path", "orders/eu/new" );
+        message->setLongProperty( "amount", 1250 );
+        message->setDoubleProperty( "fee", 2.5 );
+        message->setIntProperty( "retries", 1 );
+        message->setBooleanProperty( "priority", false );
+        message->setText( "payload" );
+        return message;
+    }
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class Evaluate : public Operation {
+    public:
+
+        std::auto_ptr<MessageSelector> selector;
+        Pointer<ActiveMQTextMessage> message;
+        long long matched;
+
+        Evaluate( const std::string& text ) :
+            selector( SelectorParser::compile( text ) ), message( createMessage() ), matched( 0 ) {}
+
+        virtual void run() {
+            const commands::Message* target = message.get();
+            if( selector->matches( target ) ) {
+                matched++;
+            }
+        }
+    };
+
+    class Compile : public Operation {
+    public:
+
+        std::string text;
+
+        Compile( const std::string& text ) : text( text ) {}
+
+        virtual void run() {
+            delete SelectorParser::compile( text );
+        }
+    };
+
+    class Parse : public Compile {
+    public:
+
+        Parse( const std::string& text ) : Compile( text ) {}
+
+        virtual void run() {
+            Pointer<MessageSelector> selector = SelectorParser::parse( text );
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < BATCH_SIZE; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "MessageSelectorBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelectorBenchmark::MessageSelectorBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelectorBenchmark::~MessageSelectorBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorBenchmark::testEvaluate() {
+
+    for( int i = 0; i < NUM_SELECTORS; ++i ) {
+        Evaluate evaluate( SELECTORS[i][1] );
+        measure( std::string( "evaluate " ) + SELECTORS[i][0], evaluate );
+
+        // Every selector but the last one is written to match the message.
+        CPPUNIT_ASSERT_EQUAL( i == NUM_SELECTORS - 1, evaluate.matched == 0 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorBenchmark::testParse() {
+
+    const std::string text = SELECTORS[2][1];
+
+    Compile compile( text );
+    measure( "compile", compile );
+
+    Parse parse( text );
+    measure( "cached", parse );
+}
@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DestinationCacheBenchmark.h"
+
+#include <activemq/util/DestinationCache.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::commands;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 100000;
+    const int WARMUP_OPERATIONS = 10000;
+    const int BATCH_SIZE = 100;
+    const int DESTINATION_COUNT = 64;
+
+    std::vector<std::string> createNames( bool withOptions ) {
+        std::vector<std::string> names;
+        for( int i = 0; i < DESTINATION_COUNT; ++i ) {
+            std::string name = "ORDERS.REGION" + Integer::toString( i % 8 ) + ".ACCOUNT" + Integer::toString( i );
+            if( withOptions ) {
+                name += "?consumer.prefetchSize=100&consumer.dispatchAsync=false";
+            }
+            names.push_back( name );
+        }
+        return names;
+    }
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class Parse : public Operation {
+    public:
+
+        const std::vector<std::string>& names;
+        int next;
+
+        Parse( const std::vector<std::string>& names ) : names( names ), next( 0 ) {}
+
+        virtual void run() {
+            Pointer<ActiveMQDestination> destination( new ActiveMQQueue( names[next++ % DESTINATION_COUNT] ) );
+        }
+    };
+
+    class Lookup : public Operation {
+    public:
+
+        DestinationCache cache;
+        const std::vector<std::string>& names;
+        int next;
+
+        Lookup( const std::vector<std::string>& names ) : cache(), names( names ), next( 0 ) {}
+
+        virtual void run() {
+            Pointer<ActiveMQDestination> destination =
+                cache.lookup( cms::Destination::QUEUE, names[next++ % DESTINATION_COUNT] );
+        }
+    };
+
+    // What an anonymous producer did for every send before the cache.
+    class Clone : public Operation {
+    public:
+
+        std::vector< Pointer<ActiveMQDestination> > destinations;
+        int next;
+
+        Clone( const std::vector<std::string>& names ) : destinations(), next( 0 ) {
+            for( std::size_t i = 0; i < names.size(); ++i ) {
+                destinations.push_back( Pointer<ActiveMQDestination>( new ActiveMQQueue( names[i] ) ) );
+            }
+        }
+
+        virtual void run() {
+            Pointer<ActiveMQDestination> destination(
+                destinations[next++ % DESTINATION_COUNT]->cloneDataStructure() );
+        }
+    };
+
+    class Intern : public Clone {
+    public:
+
+        DestinationCache cache;
+
+        Intern( const std::vector<std::string>& names ) : Clone( names ), cache() {}
+
+        virtual void run() {
+            Pointer<ActiveMQDestination> destination =
+                cache.intern( destinations[next++ % DESTINATION_COUNT].get() );
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < BATCH_SIZE; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "DestinationCacheBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DestinationCacheBenchmark::DestinationCacheBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DestinationCacheBenchmark::~DestinationCacheBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheBenchmark::testLookup() {
+
+    for( int i = 0; i < 2; ++i ) {
+
+        bool withOptions = i == 1;
+        std::vector<std::string> names = createNames( withOptions );
+        std::string suffix = withOptions ? " with options" : "";
+
+        Parse parse( names );
+        measure( "parse" + suffix, parse );
+
+        Lookup lookup( names );
+        measure( "lookup" + suffix, lookup );
+        CPPUNIT_ASSERT_EQUAL( DESTINATION_COUNT, lookup.cache.size() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheBenchmark::testIntern() {
+
+    std::vector<std::string> names = createNames( false );
+
+    Clone clone( names );
+    measure( "clone", clone );
+
+    Intern intern( names );
+    measure( "intern", intern );
+    CPPUNIT_ASSERT_EQUAL( DESTINATION_COUNT, intern.cache.size() );
+}
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_DESTINATIONCACHEBENCHMARK_H_
+#define _ACTIVEMQ_UTIL_DESTINATIONCACHEBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+
+namespace activemq{
+namespace util{
+
+    /**
+     * Compares creating destinations by parsing their names against taking them from
+     * a DestinationCache, over a rotating set of routing names the way a producer that
+     * sends to many destinations would.
+     */
+    class DestinationCacheBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( DestinationCacheBenchmark );
+        CPPUNIT_TEST( testLookup );
+        CPPUNIT_TEST( testIntern );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        DestinationCacheBenchmark();
+        virtual ~DestinationCacheBenchmark();
+
+        void testLookup();
+        void testIntern();
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_UTIL_DESTINATIONCACHEBENCHMARK_H_*/
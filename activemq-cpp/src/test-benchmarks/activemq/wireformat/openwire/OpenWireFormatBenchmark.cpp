@@ -0,0 +1,332 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenWireFormatBenchmark.h"
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQMapMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerAck.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
+#include <activemq/wireformat/openwire/OpenWireResponseBuilder.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/Properties.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::transport;
+using namespace activemq::transport::mock;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 20000;
+    const int WARMUP_OPERATIONS = 2000;
+
+    // Single marshal calls are too short to time individually, each sample
+    // in the histogram is the average over a batch of this many calls.
+    const int BATCH_SIZE = 50;
+
+    const int PAYLOAD_SIZE = 1024;
+
+    Pointer<ConsumerId> createConsumerId() {
+        Pointer<ConsumerId> consumerId( new ConsumerId() );
+        consumerId->setConnectionId( "ID:benchmark-host-61616-1234567890123-0:1" );
+        consumerId->setSessionId( 1 );
+        consumerId->setValue( 1 );
+        return consumerId;
+    }
+
+    Pointer<MessageId> createMessageId( long long sequence ) {
+        return Pointer<MessageId>(
+            new MessageId( "ID:benchmark-host-61616-1234567890123-0:1:1:1", sequence ) );
+    }
+
+    // Fills in the headers and properties a typical application message carries.
+    void populateMessage( Message* message ) {
+
+        message->setMessageId( createMessageId( 1 ) );
+        message->setProducerId( message->getMessageId()->getProducerId() );
+        message->setDestination( Pointer<ActiveMQDestination>( new ActiveMQQueue( "benchmark.queue" ) ) );
+        message->setCorrelationId( "benchmark-correlation-id" );
+        message->setPersistent( true );
+        message->setPriority( 4 );
+        message->setTimestamp( 1400000000000LL );
+
+        activemq::util::PrimitiveMap& properties = message->getMessageProperties();
+        properties.setString( "Application", "OpenWireFormatBenchmark" );
+        properties.setString( "Region", "eu-west" );
+        properties.setInt( "RetryCount", 3 );
+        properties.setLong( "SendTime", 1400000000000LL );
+        properties.setBool( "Urgent", false );
+        properties.setDouble( "Score", 0.75 );
+    }
+
+    Pointer<Command> createDispatch( const Pointer<Message>& message ) {
+
+        Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+        dispatch->setConsumerId( createConsumerId() );
+        dispatch->setDestination( message->getDestination() );
+        dispatch->setMessage( message );
+        dispatch->setRedeliveryCounter( 0 );
+
+        return dispatch;
+    }
+
+    void fillResult( BenchmarkResult& result, LatencyHistogram& batches, long long elapsed,
+                     long long allocations, const HardwareCounters& counters ) {
+
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFormatBenchmark::OpenWireFormatBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFormatBenchmark::~OpenWireFormatBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::runCommand( const std::string& name, const Pointer<Command>& command ) {
+    runCommand( name, command, true );
+    runCommand( name, command, false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::runCommand( const std::string& name,
+                                          const Pointer<Command>& command,
+                                          bool tightEncoding ) {
+
+    Properties properties;
+    Pointer<OpenWireFormat> wireFormat =
+        OpenWireFormatFactory().createWireFormat( properties ).dynamicCast<OpenWireFormat>();
+    wireFormat->setTightEncodingEnabled( tightEncoding );
+
+    Pointer<ResponseBuilder> responseBuilder( new OpenWireResponseBuilder() );
+    MockTransport transport( wireFormat, responseBuilder );
+
+    BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+    std::string encoding = tightEncoding ? "tight" : "loose";
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut( &bytesOut );
+
+    // Marshal
+    int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+    for( int i = 0; i < warmup; ++i ) {
+        bytesOut.reset();
+        wireFormat->marshal( command, &transport, &dataOut );
+    }
+
+    LatencyHistogram batches;
+    HardwareCounters counters;
+    long long allocations = AllocationCounter::getAllocations();
+    counters.start();
+    long long startTime = System::nanoTime();
+
+    for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+        long long batchStart = System::nanoTime();
+        for( int i = 0; i < BATCH_SIZE; ++i ) {
+            bytesOut.reset();
+            wireFormat->marshal( command, &transport, &dataOut );
+        }
+        batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+    }
+
+    long long elapsed = System::nanoTime() - startTime;
+    counters.stop();
+    allocations = AllocationCounter::getAllocations() - allocations;
+
+    std::pair<unsigned char*, int> encoded = bytesOut.toByteArray();
+    std::vector<unsigned char> buffer( encoded.first, encoded.first + encoded.second );
+    delete [] encoded.first;
+
+    BenchmarkResult marshalResult;
+    marshalResult.name = "OpenWireFormatBenchmark[marshal " + encoding + " " + name + "]";
+    marshalResult.bytesPerOp = (double)buffer.size();
+    fillResult( marshalResult, batches, elapsed, allocations, counters );
+
+    std::string regression = reporter.report( marshalResult );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+
+    // Unmarshal
+    ByteArrayInputStream bytesIn;
+    DataInputStream dataIn( &bytesIn );
+
+    Pointer<Command> result;
+    for( int i = 0; i < warmup; ++i ) {
+        bytesIn.setByteArray( &buffer[0], (int)buffer.size() );
+        result = wireFormat->unmarshal( &transport, &dataIn );
+    }
+
+    CPPUNIT_ASSERT( result != NULL );
+    CPPUNIT_ASSERT_EQUAL( command->getDataStructureType(), result->getDataStructureType() );
+
+    batches.reset();
+    allocations = AllocationCounter::getAllocations();
+    counters.start();
+    startTime = System::nanoTime();
+
+    for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+        long long batchStart = System::nanoTime();
+        for( int i = 0; i < BATCH_SIZE; ++i ) {
+            bytesIn.setByteArray( &buffer[0], (int)buffer.size() );
+            result = wireFormat->unmarshal( &transport, &dataIn );
+        }
+        batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+    }
+
+    elapsed = System::nanoTime() - startTime;
+    counters.stop();
+    allocations = AllocationCounter::getAllocations() - allocations;
+
+    BenchmarkResult unmarshalResult;
+    unmarshalResult.name = "OpenWireFormatBenchmark[unmarshal " + encoding + " " + name + "]";
+    unmarshalResult.bytesPerOp = (double)buffer.size();
+    fillResult( unmarshalResult, batches, elapsed, allocations, counters );
+
+    regression = reporter.report( unmarshalResult );
+    CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testTextMessageDispatch() {
+
+    Pointer<ActiveMQTextMessage> message( new ActiveMQTextMessage() );
+    populateMessage( message.get() );
+    message->setText( std::string( PAYLOAD_SIZE, 'a' ) );
+
+    runCommand( "MessageDispatch(TextMessage)", createDispatch( message ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testBytesMessageDispatch() {
+
+    Pointer<ActiveMQBytesMessage> message( new ActiveMQBytesMessage() );
+    populateMessage( message.get() );
+
+    std::vector<unsigned char> payload( PAYLOAD_SIZE, 'a' );
+    message->setBodyBytes( &payload[0], (int)payload.size() );
+    message->reset();
+
+    runCommand( "MessageDispatch(BytesMessage)", createDispatch( message ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testMapMessageDispatch() {
+
+    Pointer<ActiveMQMapMessage> message( new ActiveMQMapMessage() );
+    populateMessage( message.get() );
+
+    message->setString( "symbol", "ACME" );
+    message->setDouble( "price", 101.25 );
+    message->setInt( "quantity", 500 );
+    message->setLong( "orderId", 123456789LL );
+    message->setBoolean( "limit", true );
+    message->setString( "notes", std::string( 256, 'a' ) );
+
+    runCommand( "MessageDispatch(MapMessage)", createDispatch( message ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testMessageAck() {
+
+    Pointer<MessageAck> ack( new MessageAck() );
+    ack->setAckType( ActiveMQConstants::ACK_TYPE_CONSUMED );
+    ack->setConsumerId( createConsumerId() );
+    ack->setDestination( Pointer<ActiveMQDestination>( new ActiveMQQueue( "benchmark.queue" ) ) );
+    ack->setFirstMessageId( createMessageId( 1 ) );
+    ack->setLastMessageId( createMessageId( 100 ) );
+    ack->setMessageCount( 100 );
+
+    runCommand( "MessageAck", ack );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testProducerAck() {
+
+    Pointer<ProducerAck> ack( new ProducerAck() );
+    ack->setProducerId( Pointer<ProducerId>(
+        new ProducerId( "ID:benchmark-host-61616-1234567890123-0:1:1:1" ) ) );
+    ack->setSize( PAYLOAD_SIZE );
+
+    runCommand( "ProducerAck", ack );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::testConsumerInfo() {
+
+    Pointer<ConsumerInfo> info( new ConsumerInfo() );
+    info->setConsumerId( createConsumerId() );
+    info->setDestination( Pointer<ActiveMQDestination>( new ActiveMQQueue( "benchmark.queue" ) ) );
+    info->setPrefetchSize( 1000 );
+    info->setMaximumPendingMessageLimit( 0 );
+    info->setDispatchAsync( true );
+    info->setSelector( "Region = 'eu-west' AND RetryCount < 5" );
+    info->setPriority( 0 );
+
+    runCommand( "ConsumerInfo", info );
+}
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+
+namespace activemq{
+namespace wireformat{
+namespace openwire{
+
+    /**
+     * Marshals and unmarshals the commands that dominate a running client through
+     * OpenWireFormat and the generated marshallers, with both tight and loose
+     * encoding.  Each combination is reported through the BenchmarkReporter with
+     * the time and allocations per command and the encoded size in bytes.
+     */
+    class OpenWireFormatBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( OpenWireFormatBenchmark );
+        CPPUNIT_TEST( testTextMessageDispatch );
+        CPPUNIT_TEST( testBytesMessageDispatch );
+        CPPUNIT_TEST( testMapMessageDispatch );
+        CPPUNIT_TEST( testMessageAck );
+        CPPUNIT_TEST( testProducerAck );
+        CPPUNIT_TEST( testConsumerInfo );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        OpenWireFormatBenchmark();
+        virtual ~OpenWireFormatBenchmark();
+
+        void testTextMessageDispatch();
+        void testBytesMessageDispatch();
+        void testMapMessageDispatch();
+        void testMessageAck();
+        void testProducerAck();
+        void testConsumerInfo();
+
+    private:
+
+        void runCommand( const std::string& name,
+                         const decaf::lang::Pointer<commands::Command>& command );
+
+        void runCommand( const std::string& name,
+                         const decaf::lang::Pointer<commands::Command>& command,
+                         bool tightEncoding );
+
+    };
+
+}}}
+
+#endif /*_ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_*/
@@ -0,0 +1,285 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FlatPropertyMapBenchmark.h"
+
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
+#include <activemq/wireformat/openwire/utils/FlatPropertyMap.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace activemq::wireformat::openwire::utils;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 20000;
+    const int WARMUP_OPERATIONS = 2000;
+
+    // Single operations are too short to time individually, each sample in
+    // the histogram is the average over a batch of this many calls.
+    const int BATCH_SIZE = 50;
+
+    // Roughly what an application message with a rich set of headers carries.
+    const int PROPERTY_COUNT = 30;
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    void populate( PrimitiveMap& map ) {
+
+        for( int i = 0; i < PROPERTY_COUNT; ++i ) {
+            std::string key = "property" + Integer::toString( i );
+            switch( i % 5 ) {
+                case 0:
+                    map.setString( key, "value-" + Integer::toString( i ) );
+                    break;
+                case 1:
+                    map.setInt( key, i );
+                    break;
+                case 2:
+                    map.setLong( key, 1400000000000LL + i );
+                    break;
+                case 3:
+                    map.setBool( key, ( i & 1 ) == 0 );
+                    break;
+                default:
+                    map.setDouble( key, i * 0.5 );
+                    break;
+            }
+        }
+    }
+
+    void measure( const std::string& name, Operation& operation, double bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < OPERATIONS / BATCH_SIZE; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < BATCH_SIZE; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / BATCH_SIZE );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "FlatPropertyMapBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+
+    // The consumer side of a typical exchange, decode the properties and look
+    // at a handful of them.
+    class PrimitiveMapRead : public Operation {
+    public:
+
+        const std::vector<unsigned char>& buffer;
+        long long checksum;
+
+        PrimitiveMapRead( const std::vector<unsigned char>& buffer ) : buffer( buffer ), checksum( 0 ) {}
+
+        virtual void run() {
+            PrimitiveMap map;
+            PrimitiveTypesMarshaller::unmarshal( &map, buffer );
+            checksum += map.getInt( "property1" ) + map.getLong( "property27" ) +
+                        (long long)map.getString( "property15" ).size();
+        }
+    };
+
+    class FlatPropertyMapRead : public Operation {
+    public:
+
+        const std::vector<unsigned char>& buffer;
+        long long checksum;
+
+        FlatPropertyMapRead( const std::vector<unsigned char>& buffer ) : buffer( buffer ), checksum( 0 ) {}
+
+        virtual void run() {
+            FlatPropertyMap map;
+            map.parse( buffer );
+            checksum += map.getInt( "property1" ) + map.getLong( "property27" ) +
+                        (long long)map.getString( "property15" ).size();
+        }
+    };
+
+    template<typename MAP>
+    class Lookup : public Operation {
+    public:
+
+        const MAP& map;
+        long long checksum;
+
+        Lookup( const MAP& map ) : map( map ), checksum( 0 ) {}
+
+        virtual void run() {
+            checksum += map.getInt( "property11" ) + map.getLong( "property2" ) +
+                        ( map.getBool( "property3" ) ? 1 : 0 ) + (long long)map.getDouble( "property4" );
+        }
+    };
+
+    class PrimitiveMapWrite : public Operation {
+    public:
+
+        std::vector<unsigned char> buffer;
+
+        PrimitiveMapWrite() : buffer() {}
+
+        virtual void run() {
+            PrimitiveMap map;
+            map.setString( "Application", "FlatPropertyMapBenchmark" );
+            map.setInt( "RetryCount", 3 );
+            map.setLong( "SendTime", 1400000000000LL );
+            map.setBool( "Urgent", false );
+            map.setDouble( "Score", 0.75 );
+            PrimitiveTypesMarshaller::marshal( &map, buffer );
+        }
+    };
+
+    class FlatPropertyMapWrite : public Operation {
+    public:
+
+        std::vector<unsigned char> buffer;
+
+        FlatPropertyMapWrite() : buffer() {}
+
+        virtual void run() {
+            FlatPropertyMap map;
+            map.setString( "Application", "FlatPropertyMapBenchmark" );
+            map.setInt( "RetryCount", 3 );
+            map.setLong( "SendTime", 1400000000000LL );
+            map.setBool( "Urgent", false );
+            map.setDouble( "Score", 0.75 );
+            map.marshal( buffer );
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FlatPropertyMapBenchmark::FlatPropertyMapBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FlatPropertyMapBenchmark::~FlatPropertyMapBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapBenchmark::testUnmarshalAndRead() {
+
+    PrimitiveMap source;
+    populate( source );
+
+    std::vector<unsigned char> buffer;
+    PrimitiveTypesMarshaller::marshal( &source, buffer );
+
+    PrimitiveMapRead primitive( buffer );
+    measure( "unmarshal+read PrimitiveMap", primitive, (double)buffer.size() );
+
+    FlatPropertyMapRead flat( buffer );
+    measure( "unmarshal+read FlatPropertyMap", flat, (double)buffer.size() );
+
+    CPPUNIT_ASSERT_EQUAL( primitive.checksum, flat.checksum );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapBenchmark::testLookup() {
+
+    PrimitiveMap source;
+    populate( source );
+
+    FlatPropertyMap map;
+    map.fromPrimitiveMap( source );
+
+    Lookup<PrimitiveMap> primitive( source );
+    measure( "lookup PrimitiveMap", primitive, 0 );
+
+    Lookup<FlatPropertyMap> flat( map );
+    measure( "lookup FlatPropertyMap", flat, 0 );
+
+    CPPUNIT_ASSERT_EQUAL( primitive.checksum, flat.checksum );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapBenchmark::testMarshal() {
+
+    PrimitiveMapWrite primitive;
+    measure( "build+marshal PrimitiveMap", primitive, 0 );
+
+    FlatPropertyMapWrite flat;
+    measure( "build+marshal FlatPropertyMap", flat, 0 );
+
+    PrimitiveMap fromPrimitive;
+    PrimitiveMap fromFlat;
+    PrimitiveTypesMarshaller::unmarshal( &fromPrimitive, primitive.buffer );
+    PrimitiveTypesMarshaller::unmarshal( &fromFlat, flat.buffer );
+    CPPUNIT_ASSERT( fromPrimitive.equals( fromFlat ) );
+}
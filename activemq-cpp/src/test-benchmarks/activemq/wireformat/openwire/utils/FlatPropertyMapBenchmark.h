@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPBENCHMARK_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/util/Config.h>
+
+namespace activemq{
+namespace wireformat{
+namespace openwire{
+namespace utils{
+
+    /**
+     * Compares FlatPropertyMap against PrimitiveMap for the work a consumer does
+     * with message properties: decoding the marshaled map and reading a few
+     * values from it, repeated lookups on a decoded map, and marshaling a map
+     * built up by a producer.  Both variants are reported through the
+     * BenchmarkReporter so the results sit next to each other.
+     */
+    class FlatPropertyMapBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( FlatPropertyMapBenchmark );
+        CPPUNIT_TEST( testUnmarshalAndRead );
+        CPPUNIT_TEST( testLookup );
+        CPPUNIT_TEST( testMarshal );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        FlatPropertyMapBenchmark();
+        virtual ~FlatPropertyMapBenchmark();
+
+        void testUnmarshalAndRead();
+        void testLookup();
+        void testMarshal();
+
+    };
+
+}}}}
+
+#endif /*_ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPBENCHMARK_H_*/
@@ -0,0 +1,248 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <activemq/wireformat/stomp/StompCommandConstants.h>
+#include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameParser.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/FilterInputStream.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace benchmark;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int WARMUP_BYTES = 1024 * 1024;
+    const int MEASURED_BYTES = 16 * 1024 * 1024;
+    const int BATCH_COUNT = 100;
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class Parse : public Operation {
+    public:
+
+        ByteArrayInputStream& source;
+        DataInputStream& input;
+        StompFrameParser parser;
+
+        Parse( ByteArrayInputStream& source, DataInputStream& input ) :
+            source( source ), input( input ), parser() {}
+
+        virtual void run() {
+            source.reset();
+            StompFrame frame;
+            parser.parse( &input, frame );
+        }
+    };
+
+    class Serialize : public Operation {
+    public:
+
+        const StompFrame& frame;
+        ByteArrayOutputStream& target;
+        DataOutputStream& output;
+
+        Serialize( const StompFrame& frame, ByteArrayOutputStream& target, DataOutputStream& output ) :
+            frame( frame ), target( target ), output( output ) {}
+
+        virtual void run() {
+            target.reset();
+            frame.toStream( &output );
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation, int bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int operations = MEASURED_BYTES / bytesPerOp;
+        int batchSize = operations > BATCH_COUNT ? operations / BATCH_COUNT : 1;
+        operations = ( operations / batchSize ) * batchSize;
+
+        int warmup = reporter.getWarmupIterations( WARMUP_BYTES / bytesPerOp + 1 );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < operations / batchSize; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < batchSize; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / batchSize );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "StompFrameBenchmark[" + name + "]";
+        result.iterations = operations;
+        result.meanNanos = (double)elapsed / (double)operations;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)operations / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = (double)bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)operations;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+
+    // A MESSAGE frame carrying the headers the broker adds to a typical dispatch.
+    void createMessage( StompFrame& frame, int bodySize, bool contentLength ) {
+
+        frame.setCommand( "MESSAGE" );
+        frame.setProperty( StompCommandConstants::HEADER_DESTINATION, "/queue/benchmark.stomp.frames" );
+        frame.setProperty( StompCommandConstants::HEADER_MESSAGEID, "ID:benchmark-host-45123-1400000000000-1:1:1:1:42" );
+        frame.setProperty( StompCommandConstants::HEADER_SUBSCRIPTION, "ID:benchmark-host-45123-1400000000000-1:1:1:1" );
+        frame.setProperty( StompCommandConstants::HEADER_EXPIRES, "0" );
+        frame.setProperty( StompCommandConstants::HEADER_TIMESTAMP, "1400000000123" );
+        frame.setProperty( StompCommandConstants::HEADER_JMSPRIORITY, "4" );
+        frame.setProperty( StompCommandConstants::HEADER_PERSISTENT, "true" );
+        frame.setProperty( StompCommandConstants::HEADER_CORRELATIONID, "request-42" );
+        frame.setProperty( StompCommandConstants::HEADER_TYPE, "benchmark" );
+        frame.setProperty( "JMSXDeliveryCount", "1" );
+        frame.setProperty( "JMSXGroupSeq", "0" );
+
+        std::vector<unsigned char> body( bodySize, 'x' );
+        if( contentLength ) {
+            frame.setProperty( StompCommandConstants::HEADER_CONTENTLENGTH, Integer::toString( bodySize ) );
+        } else {
+            body.push_back( '\0' );
+        }
+        frame.setBody( &body[0], body.size() );
+    }
+
+    void encode( const StompFrame& frame, std::vector<unsigned char>& encoded ) {
+
+        ByteArrayOutputStream bytes;
+        DataOutputStream output( &bytes );
+        frame.toStream( &output );
+
+        std::pair<const unsigned char*, int> array = bytes.toByteArray();
+        encoded.assign( array.first, array.first + array.second );
+        delete [] array.first;
+    }
+
+    void measureParse( const std::string& name, const StompFrame& frame ) {
+
+        std::vector<unsigned char> encoded;
+        encode( frame, encoded );
+
+        ByteArrayInputStream source( encoded );
+
+        DataInputStream scanned( &source );
+        Parse scan( source, scanned );
+        measure( name + " scan", scan, (int)encoded.size() );
+
+        // A plain filter hides the array so the parser falls back to single bytes.
+        FilterInputStream filter( &source );
+        DataInputStream bytewise( &filter );
+        Parse single( source, bytewise );
+        measure( name + " bytewise", single, (int)encoded.size() );
+    }
+
+    void measureSerialize( const std::string& name, const StompFrame& frame ) {
+
+        std::vector<unsigned char> encoded;
+        encode( frame, encoded );
+
+        ByteArrayOutputStream target( (int)encoded.size() );
+        DataOutputStream output( &target );
+        Serialize serialize( frame, target, output );
+        measure( name, serialize, (int)encoded.size() );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameBenchmark::StompFrameBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameBenchmark::~StompFrameBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameBenchmark::testParse() {
+
+    StompFrame text;
+    createMessage( text, 256, false );
+    measureParse( "parse text 256", text );
+
+    StompFrame bytes;
+    createMessage( bytes, 16 * 1024, true );
+    measureParse( "parse bytes 16K", bytes );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameBenchmark::testSerialize() {
+
+    StompFrame text;
+    createMessage( text, 256, false );
+    measureSerialize( "serialize text 256", text );
+
+    StompFrame bytes;
+    createMessage( bytes, 16 * 1024, true );
+    measureSerialize( "serialize bytes 16K", bytes );
+}
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEBENCHMARK_H_
+#define _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    /**
+     * Measures reading and writing Stomp MESSAGE frames with a small text body
+     * that ends at its null and a larger bytes body sized by content-length.
+     * Frames are parsed once from a stream that exposes its array, which is
+     * scanned in bulk, and once from a stream that does not, which is read a
+     * byte at a time.  Each result reports the encoded frame size as its bytes
+     * per operation.
+     */
+    class StompFrameBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( StompFrameBenchmark );
+        CPPUNIT_TEST( testParse );
+        CPPUNIT_TEST( testSerialize );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        StompFrameBenchmark();
+        virtual ~StompFrameBenchmark();
+
+        void testParse();
+        void testSerialize();
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_STOMP_STOMPFRAMEBENCHMARK_H_ */
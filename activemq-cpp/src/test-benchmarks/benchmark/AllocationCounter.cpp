@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AllocationCounter.h"
+
+#include <new>
+#include <cstdlib>
+
+using namespace benchmark;
+
+#if defined(__GNUC__)
+
+namespace {
+    volatile long long allocations = 0;
+
+    void* countedAllocate( std::size_t size ) {
+
+        __sync_fetch_and_add( &allocations, 1LL );
+
+        void* result = std::malloc( size == 0 ? 1 : size );
+        if( result == NULL ) {
+            throw std::bad_alloc();
+        }
+
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size ) throw( std::bad_alloc ) {
+    return countedAllocate( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size ) throw( std::bad_alloc ) {
+    return countedAllocate( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete( void* ptr ) throw() {
+    std::free( ptr );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* ptr ) throw() {
+    std::free( ptr );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AllocationCounter::isSupported() {
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long AllocationCounter::getAllocations() {
+    return __sync_fetch_and_add( &allocations, 0LL );
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////
+bool AllocationCounter::isSupported() {
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long AllocationCounter::getAllocations() {
+    return 0;
+}
+
+#endif
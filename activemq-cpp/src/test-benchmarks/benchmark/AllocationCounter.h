@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_ALLOCATIONCOUNTER_H_
+#define _BENCHMARK_ALLOCATIONCOUNTER_H_
+
+#include <activemq/util/Config.h>
+
+namespace benchmark{
+
+    /**
+     * Counts calls to the global operator new made anywhere in the benchmark process,
+     * the benchmark executable replaces the global allocation functions to do so.
+     * Only supported on compilers with atomic builtins, elsewhere the count stays at
+     * zero and isSupported returns false.
+     */
+    class AllocationCounter {
+    private:
+
+        AllocationCounter();
+        AllocationCounter( const AllocationCounter& );
+        AllocationCounter& operator= ( const AllocationCounter& );
+
+    public:
+
+        /**
+         * @return true if allocations are being counted on this platform.
+         */
+        static bool isSupported();
+
+        /**
+         * @return the number of allocations made since the process started.
+         */
+        static long long getAllocations();
+
+    };
+
+}
+
+#endif /*_BENCHMARK_ALLOCATIONCOUNTER_H_*/
@@ -21,13 +21,22 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <decaf/lang/Runnable.h>
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
 #include <benchmark/PerformanceTimer.h>
 #include <string>
-#include <iostream>
+#include <typeinfo>
 
 namespace benchmark{
 
-    template < class NAME, class TARGET, int ITERATIONS = 100 >
+    /**
+     * Runs the target's run method WARMUP times to settle caches and allocators,
+     * then times ITERATIONS calls individually and reports the distribution through
+     * the BenchmarkReporter.  The benchmark fails if the reporter finds the median
+     * time has regressed past the baseline.
+     */
+    template < class NAME, class TARGET, int ITERATIONS = 100, int WARMUP = ITERATIONS / 10 >
     class BenchmarkBase : public decaf::lang::Runnable,
                           public CppUnit::TestFixture
     {
@@ -50,15 +59,54 @@ namespace benchmark{
 
         void runBenchmark(){
 
+            BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+            int warmup = reporter.getWarmupIterations( WARMUP );
+            for( int i = 0; i < warmup; ++i ){
+                this->run();
+            }
+
+            timer.reset();
+
+            HardwareCounters counters;
+            long long allocations = AllocationCounter::getAllocations();
+            counters.start();
+
             for( int i = 0; i < ITERATIONS; ++i ){
                 timer.start();
                 this->run();
                 timer.stop();
             }
 
-            std::cout << typeid( TARGET ).name() << " Benchmark Time = "
-                      << timer.getAverageTime() << " Millisecs"
-                      << std::endl;
+            counters.stop();
+            allocations = AllocationCounter::getAllocations() - allocations;
+
+            LatencyHistogram& times = timer.getHistogram();
+
+            BenchmarkResult result;
+            result.name = typeid( TARGET ).name();
+            result.iterations = ITERATIONS;
+            result.meanNanos = timer.getAverageTimeNanos();
+            result.p50Nanos = times.getPercentile( 50.0 );
+            result.p99Nanos = times.getPercentile( 99.0 );
+            result.p999Nanos = times.getPercentile( 99.9 );
+            result.maxNanos = times.getMax();
+            result.opsPerSecond = result.meanNanos > 0 ? 1000000000.0 / result.meanNanos : 0;
+
+            if( AllocationCounter::isSupported() ) {
+                result.allocationsPerOp = (double)allocations / (double)ITERATIONS;
+            }
+
+            if( counters.isAvailable() ) {
+                result.cycles = counters.getCycles();
+                result.instructions = counters.getInstructions();
+                result.cacheMisses = counters.getCacheMisses();
+            }
+
+            std::string regression = reporter.report( result );
+            if( !regression.empty() ) {
+                CPPUNIT_FAIL( regression );
+            }
         }
 
     };
@@ -0,0 +1,213 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkReporter.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace benchmark;
+
+namespace {
+
+    std::string escape( const std::string& value ) {
+
+        std::ostringstream result;
+        for( std::string::size_type i = 0; i < value.size(); ++i ) {
+            unsigned char ch = (unsigned char)value[i];
+            if( ch == '"' || ch == '\\' ) {
+                result << '\\' << value[i];
+            } else if( ch < 0x20 ) {
+                result << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << (int)ch
+                       << std::dec << std::setfill( ' ' );
+            } else {
+                result << value[i];
+            }
+        }
+
+        return result.str();
+    }
+
+    // Reads the string value for the given key out of a single line of JSON as
+    // written by BenchmarkReporter::report.
+    bool readString( const std::string& line, const std::string& key, std::string& value ) {
+
+        std::string::size_type pos = line.find( "\"" + key + "\":\"" );
+        if( pos == std::string::npos ) {
+            return false;
+        }
+
+        value.clear();
+        for( pos += key.size() + 4; pos < line.size(); ++pos ) {
+            if( line[pos] == '"' ) {
+                return true;
+            } else if( line[pos] == '\\' && pos + 1 < line.size() ) {
+                value += line[++pos];
+            } else {
+                value += line[pos];
+            }
+        }
+
+        return false;
+    }
+
+    bool readNumber( const std::string& line, const std::string& key, long long& value ) {
+
+        std::string::size_type pos = line.find( "\"" + key + "\":" );
+        if( pos == std::string::npos ) {
+            return false;
+        }
+
+        std::istringstream stream( line.substr( pos + key.size() + 3 ) );
+        double number = 0;
+        if( !( stream >> number ) ) {
+            return false;
+        }
+
+        value = (long long)number;
+        return true;
+    }
+
+    void writeOptional( std::ostream& out, const char* key, long long value ) {
+        out << ",\"" << key << "\":";
+        if( value < 0 ) {
+            out << "null";
+        } else {
+            out << value;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BenchmarkReporter::BenchmarkReporter() : jsonOutput(), baseline(), threshold(10.0), warmupIterations(-1) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BenchmarkReporter::~BenchmarkReporter() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BenchmarkReporter& BenchmarkReporter::getInstance() {
+    static BenchmarkReporter instance;
+    return instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool BenchmarkReporter::loadBaseline( const std::string& path ) {
+
+    std::ifstream input( path.c_str() );
+    if( !input ) {
+        return false;
+    }
+
+    std::string line;
+    while( std::getline( input, line ) ) {
+        std::string name;
+        long long median = 0;
+
+        if( readString( line, "name", name ) && readNumber( line, "p50_ns", median ) ) {
+            this->baseline[name] = median;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string BenchmarkReporter::report( const BenchmarkResult& result ) {
+
+    std::cout << result.name << " :"
+              << " iterations=" << result.iterations
+              << std::fixed << std::setprecision( 0 )
+              << " mean=" << result.meanNanos << "ns"
+              << " p50=" << result.p50Nanos << "ns"
+              << " p99=" << result.p99Nanos << "ns"
+              << " p99.9=" << result.p999Nanos << "ns"
+              << " max=" << result.maxNanos << "ns"
+              << " ops/s=" << result.opsPerSecond;
+
+    if( result.allocationsPerOp >= 0 ) {
+        std::cout << std::setprecision( 1 ) << " allocs/op=" << result.allocationsPerOp;
+    }
+
+    if( result.bytesPerOp >= 0 ) {
+        std::cout << std::setprecision( 1 ) << " bytes/op=" << result.bytesPerOp;
+    }
+
+    if( result.cycles >= 0 ) {
+        std::cout << " cycles=" << result.cycles
+                  << " instructions=" << result.instructions
+                  << " cache-misses=" << result.cacheMisses;
+    }
+
+    std::cout << std::endl;
+
+    if( !this->jsonOutput.empty() ) {
+        std::ofstream out( this->jsonOutput.c_str(), std::ios::out | std::ios::app );
+
+        out << std::fixed << std::setprecision( 2 )
+            << "{\"name\":\"" << escape( result.name ) << "\""
+            << ",\"iterations\":" << result.iterations
+            << ",\"mean_ns\":" << result.meanNanos
+            << ",\"p50_ns\":" << result.p50Nanos
+            << ",\"p99_ns\":" << result.p99Nanos
+            << ",\"p999_ns\":" << result.p999Nanos
+            << ",\"max_ns\":" << result.maxNanos
+            << ",\"ops_per_sec\":" << result.opsPerSecond
+            << ",\"allocs_per_op\":";
+
+        if( result.allocationsPerOp < 0 ) {
+            out << "null";
+        } else {
+            out << result.allocationsPerOp;
+        }
+
+        out << ",\"bytes_per_op\":";
+        if( result.bytesPerOp < 0 ) {
+            out << "null";
+        } else {
+            out << result.bytesPerOp;
+        }
+
+        writeOptional( out, "cycles", result.cycles );
+        writeOptional( out, "instructions", result.instructions );
+        writeOptional( out, "cache_misses", result.cacheMisses );
+        out << "}" << std::endl;
+    }
+
+    std::map<std::string, long long>::const_iterator expected = this->baseline.find( result.name );
+    if( expected == this->baseline.end() || expected->second <= 0 ) {
+        return "";
+    }
+
+    double limit = (double)expected->second * ( 1.0 + this->threshold / 100.0 );
+    if( (double)result.p50Nanos <= limit ) {
+        return "";
+    }
+
+    std::ostringstream message;
+    message << std::fixed << std::setprecision( 1 )
+            << result.name << " regressed: p50 " << result.p50Nanos << "ns against a baseline of "
+            << expected->second << "ns, "
+            << ( (double)result.p50Nanos / (double)expected->second - 1.0 ) * 100.0
+            << "% slower with a threshold of " << this->threshold << "%";
+
+    return message.str();
+}
@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_BENCHMARKREPORTER_H_
+#define _BENCHMARK_BENCHMARKREPORTER_H_
+
+#include <activemq/util/Config.h>
+#include <map>
+#include <string>
+
+namespace benchmark{
+
+    /**
+     * The measurements taken for a single benchmark, times are in nanoseconds.
+     * Values that could not be measured on this platform are left at -1.
+     */
+    struct BenchmarkResult {
+
+        std::string name;
+        long long iterations;
+        double meanNanos;
+        long long p50Nanos;
+        long long p99Nanos;
+        long long p999Nanos;
+        long long maxNanos;
+        double opsPerSecond;
+        double allocationsPerOp;
+        double bytesPerOp;
+        long long cycles;
+        long long instructions;
+        long long cacheMisses;
+
+        BenchmarkResult() : name(), iterations(0), meanNanos(0), p50Nanos(0), p99Nanos(0),
+                            p999Nanos(0), maxNanos(0), opsPerSecond(0), allocationsPerOp(-1),
+                            bytesPerOp(-1), cycles(-1), instructions(-1), cacheMisses(-1) {}
+
+    };
+
+    /**
+     * Prints the results of each benchmark in a common format, optionally appends
+     * them as JSON lines to a file and compares them against the median times from
+     * an earlier run.  The runner configures the single instance from its command
+     * line before any benchmarks run.
+     */
+    class BenchmarkReporter {
+    private:
+
+        std::string jsonOutput;
+        std::map<std::string, long long> baseline;
+        double threshold;
+        int warmupIterations;
+
+    private:
+
+        BenchmarkReporter();
+        BenchmarkReporter( const BenchmarkReporter& );
+        BenchmarkReporter& operator= ( const BenchmarkReporter& );
+
+    public:
+
+        virtual ~BenchmarkReporter();
+
+        static BenchmarkReporter& getInstance();
+
+        /**
+         * Sets the file that each result is appended to as a single line of JSON,
+         * an empty string disables the JSON output.
+         */
+        void setJsonOutput( const std::string& path ) {
+            this->jsonOutput = path;
+        }
+
+        /**
+         * Loads the results of an earlier run that was written with setJsonOutput.
+         *
+         * @return false if the file could not be read.
+         */
+        bool loadBaseline( const std::string& path );
+
+        /**
+         * Sets how many percent slower than the baseline median a benchmark may
+         * be before it is considered a regression.
+         */
+        void setThreshold( double percent ) {
+            this->threshold = percent;
+        }
+
+        double getThreshold() const {
+            return this->threshold;
+        }
+
+        /**
+         * Overrides the number of warm-up iterations each benchmark runs before it
+         * is measured, a negative value leaves the benchmark's own default.
+         */
+        void setWarmupIterations( int iterations ) {
+            this->warmupIterations = iterations;
+        }
+
+        int getWarmupIterations( int defaultValue ) const {
+            return this->warmupIterations < 0 ? defaultValue : this->warmupIterations;
+        }
+
+        /**
+         * Prints the result and writes it to the JSON output if one is set.
+         *
+         * @return a description of the regression when the median time is worse
+         *         than the baseline by more than the threshold, otherwise an empty string.
+         */
+        std::string report( const BenchmarkResult& result );
+
+    };
+
+}
+
+#endif /*_BENCHMARK_BENCHMARKREPORTER_H_*/
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HardwareCounters.h"
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+using namespace benchmark;
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+
+namespace {
+
+    int openCounter( unsigned long long config ) {
+
+        struct perf_event_attr attr;
+        memset( &attr, 0, sizeof( attr ) );
+
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof( attr );
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Counts this process on any CPU.
+        return (int)syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HardwareCounters::HardwareCounters() : descriptors(), values(), available( false ) {
+
+    const unsigned long long configs[NUM_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    this->available = true;
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        this->values[i] = 0;
+        this->descriptors[i] = openCounter( configs[i] );
+        if( this->descriptors[i] < 0 ) {
+            this->available = false;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HardwareCounters::~HardwareCounters() {
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        if( this->descriptors[i] >= 0 ) {
+            close( this->descriptors[i] );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HardwareCounters::start() {
+
+    if( !this->available ) {
+        return;
+    }
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        ioctl( this->descriptors[i], PERF_EVENT_IOC_RESET, 0 );
+        ioctl( this->descriptors[i], PERF_EVENT_IOC_ENABLE, 0 );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HardwareCounters::stop() {
+
+    if( !this->available ) {
+        return;
+    }
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        ioctl( this->descriptors[i], PERF_EVENT_IOC_DISABLE, 0 );
+
+        long long value = 0;
+        if( read( this->descriptors[i], &value, sizeof( value ) ) == (ssize_t)sizeof( value ) ) {
+            this->values[i] = value;
+        } else {
+            this->values[i] = 0;
+        }
+    }
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////
+HardwareCounters::HardwareCounters() : descriptors(), values(), available( false ) {
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        this->descriptors[i] = -1;
+        this->values[i] = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HardwareCounters::~HardwareCounters() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HardwareCounters::start() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HardwareCounters::stop() {
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_HARDWARECOUNTERS_H_
+#define _BENCHMARK_HARDWARECOUNTERS_H_
+
+#include <activemq/util/Config.h>
+
+namespace benchmark{
+
+    /**
+     * Reads the CPU cycle, retired instruction and cache miss counters for the
+     * benchmark process between calls to start and stop.  This uses the Linux
+     * perf_event_open interface, on other platforms or when the kernel doesn't
+     * allow access to the counters isAvailable returns false and all the values
+     * read as zero.  Threads created after start are counted as well.
+     */
+    class HardwareCounters {
+    private:
+
+        enum { CYCLES = 0, INSTRUCTIONS = 1, CACHE_MISSES = 2, NUM_COUNTERS = 3 };
+
+        int descriptors[NUM_COUNTERS];
+        long long values[NUM_COUNTERS];
+        bool available;
+
+    private:
+
+        HardwareCounters( const HardwareCounters& );
+        HardwareCounters& operator= ( const HardwareCounters& );
+
+    public:
+
+        HardwareCounters();
+        virtual ~HardwareCounters();
+
+        /**
+         * @return true if the hardware counters could be opened.
+         */
+        bool isAvailable() const {
+            return this->available;
+        }
+
+        /**
+         * Resets the counters and starts counting.
+         */
+        void start();
+
+        /**
+         * Stops counting and stores the values counted since start.
+         */
+        void stop();
+
+        long long getCycles() const {
+            return this->values[CYCLES];
+        }
+
+        long long getInstructions() const {
+            return this->values[INSTRUCTIONS];
+        }
+
+        long long getCacheMisses() const {
+            return this->values[CACHE_MISSES];
+        }
+
+    };
+
+}
+
+#endif /*_BENCHMARK_HARDWARECOUNTERS_H_*/
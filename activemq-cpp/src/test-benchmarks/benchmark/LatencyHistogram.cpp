@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace benchmark;
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram() : samples(), total(0), sorted(true) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::~LatencyHistogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::record( long long nanos ) {
+    this->samples.push_back( nanos );
+    this->total += nanos;
+    this->sorted = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::merge( const LatencyHistogram& other ) {
+    this->samples.insert( this->samples.end(), other.samples.begin(), other.samples.end() );
+    this->total += other.total;
+    this->sorted = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::reset() {
+    this->samples.clear();
+    this->total = 0;
+    this->sorted = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double LatencyHistogram::getMean() const {
+
+    if( this->samples.empty() ) {
+        return 0.0;
+    }
+
+    return (double)this->total / (double)this->samples.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getMin() {
+
+    if( this->samples.empty() ) {
+        return 0;
+    }
+
+    sort();
+    return this->samples.front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getMax() {
+
+    if( this->samples.empty() ) {
+        return 0;
+    }
+
+    sort();
+    return this->samples.back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getPercentile( double percentile ) {
+
+    if( this->samples.empty() ) {
+        return 0;
+    }
+
+    sort();
+
+    // Nearest rank, so p100 is the max and small sample counts round up.
+    double rank = ( percentile / 100.0 ) * (double)this->samples.size();
+    std::size_t index = (std::size_t)rank;
+    if( (double)index < rank ) {
+        index++;
+    }
+
+    if( index > 0 ) {
+        index--;
+    }
+
+    if( index >= this->samples.size() ) {
+        index = this->samples.size() - 1;
+    }
+
+    return this->samples[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::sort() {
+
+    if( !this->sorted ) {
+        std::sort( this->samples.begin(), this->samples.end() );
+        this->sorted = true;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_LATENCYHISTOGRAM_H_
+#define _BENCHMARK_LATENCYHISTOGRAM_H_
+
+#include <activemq/util/Config.h>
+#include <vector>
+
+namespace benchmark{
+
+    /**
+     * Collects individual latency samples in nanoseconds so that percentiles can
+     * be reported along with the average.  Each thread should record into its own
+     * instance, the results can be combined afterwards with merge.
+     */
+    class LatencyHistogram {
+    private:
+
+        std::vector<long long> samples;
+        long long total;
+        bool sorted;
+
+    public:
+
+        LatencyHistogram();
+        virtual ~LatencyHistogram();
+
+        /**
+         * Records a single sample.
+         *
+         * @param nanos
+         *      The measured time in nanoseconds.
+         */
+        void record( long long nanos );
+
+        /**
+         * Adds all the samples from another histogram to this one.
+         */
+        void merge( const LatencyHistogram& other );
+
+        /**
+         * Throws out all recorded samples.
+         */
+        void reset();
+
+        /**
+         * @return the number of samples recorded.
+         */
+        long long getCount() const {
+            return (long long)samples.size();
+        }
+
+        /**
+         * @return the average of all samples, or zero if there are none.
+         */
+        double getMean() const;
+
+        /**
+         * @return the smallest sample, or zero if there are none.
+         */
+        long long getMin();
+
+        /**
+         * @return the largest sample, or zero if there are none.
+         */
+        long long getMax();
+
+        /**
+         * Gets the sample value below which the given percentage of samples fall.
+         *
+         * @param percentile
+         *      A value between 0 and 100, e.g. 99.9
+         *
+         * @return the sample at the given percentile, or zero if there are none.
+         */
+        long long getPercentile( double percentile );
+
+    private:
+
+        void sort();
+
+    };
+
+}
+
+#endif /*_BENCHMARK_LATENCYHISTOGRAM_H_*/
@@ -33,37 +33,31 @@ PerformanceTimer::~PerformanceTimer(){
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::start(){
-    this->startTime = System::currentTimeMillis();
+    this->startTime = System::nanoTime();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::stop(){
 
-    this->endTime = System::currentTimeMillis();
-    times.push_back( endTime - startTime );
+    this->endTime = System::nanoTime();
+    times.record( endTime - startTime );
     numberOfRuns++;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::reset(){
+    this->numberOfRuns = 0;
     this->startTime = 0;
     this->endTime = 0;
-    this->times.clear();
+    this->times.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 long long PerformanceTimer::getAverageTime() const{
+    return (long long)( getAverageTimeNanos() / 1000000.0 );
+}
 
-    std::vector<long long>::const_iterator iter = times.begin();
-    long long totalTime = 0;
-
-    do{
-        totalTime += *iter;
-    } while( ++iter != times.end() );
-
-    if( totalTime == 0 || numberOfRuns == 0 ) {
-        return 0;
-    }
-
-    return totalTime / numberOfRuns;
+////////////////////////////////////////////////////////////////////////////////
+double PerformanceTimer::getAverageTimeNanos() const{
+    return times.getMean();
 }
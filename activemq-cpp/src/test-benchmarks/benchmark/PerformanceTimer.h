@@ -19,7 +19,7 @@
 #define _BENCHMARK_PERFORMANCETIMER_H_
 
 #include <activemq/util/Config.h>
-#include <vector>
+#include <benchmark/LatencyHistogram.h>
 
 namespace benchmark{
 
@@ -28,13 +28,14 @@ namespace benchmark{
      * maintains a running list of performance numbers for successive calls to
      * the method start and stop.  Once the desired number of tests has been run,
      * the user can call getAverageTime to find out the average time it took for
-     * all start / stop cycles.
+     * all start / stop cycles.  Times are taken from the monotonic nanosecond clock
+     * and every cycle is kept so that percentiles can be read from getHistogram.
      */
     class PerformanceTimer {
     private:
 
         long long numberOfRuns;
-        std::vector<long long> times;
+        LatencyHistogram times;
         long long startTime;
         long long endTime;
 
@@ -70,10 +71,22 @@ namespace benchmark{
         /**
          * Gets the overall average time that the count has recoreded
          * for all start / stop cycles.
-         * @return the average time for all the runs times / numberOfRuns
+         * @return the average time in milliseconds for all the runs times / numberOfRuns
          */
         long long getAverageTime() const;
 
+        /**
+         * @return the average time in nanoseconds for all the start / stop cycles.
+         */
+        double getAverageTimeNanos() const;
+
+        /**
+         * @return the times in nanoseconds of each start / stop cycle.
+         */
+        LatencyHistogram& getHistogram() {
+            return times;
+        }
+
     };
 
 }
@@ -17,9 +17,128 @@
 
 #include "DataInputStreamBenchmark.h"
 
+#include <benchmark/LatencyHistogram.h>
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/FilterInputStream.h>
+#include <decaf/lang/System.h>
+
+#include <memory>
+#include <vector>
+
 using namespace std;
+using namespace benchmark;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 200;
+    const int WARMUP_OPERATIONS = 20;
+
+    // Each record is an int, a long, a short and a byte, the mix the OpenWire
+    // marshalers read for a command header.
+    const int RECORD_COUNT = 4096;
+    const int RECORD_SIZE = 15;
+
+    enum StreamType {
+        BYTE_ARRAY,
+        BUFFERED,
+        FILTERED
+    };
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class ReadRecords : public Operation {
+    public:
+
+        const std::vector<unsigned char>& data;
+        StreamType type;
+        long long total;
+
+        ReadRecords( const std::vector<unsigned char>& data, StreamType type ) :
+            data( data ), type( type ), total( 0 ) {}
+
+        virtual void run() {
+
+            ByteArrayInputStream bytes( &data[0], (int)data.size() );
+            std::auto_ptr<InputStream> wrapper;
+            if( type == BUFFERED ) {
+                wrapper.reset( new BufferedInputStream( &bytes ) );
+            } else if( type == FILTERED ) {
+                wrapper.reset( new FilterInputStream( &bytes ) );
+            }
+
+            DataInputStream in( wrapper.get() != NULL ? wrapper.get() : &bytes );
+
+            for( int i = 0; i < RECORD_COUNT; ++i ) {
+                total += in.readInt();
+                total += in.readLong();
+                total += in.readShort();
+                total += in.readByte();
+            }
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation, double bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram times;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int i = 0; i < OPERATIONS; ++i ) {
+            long long operationStart = System::nanoTime();
+            operation.run();
+            times.record( System::nanoTime() - operationStart );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "DataInputStreamBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = times.getPercentile( 50.0 );
+        result.p99Nanos = times.getPercentile( 99.0 );
+        result.p999Nanos = times.getPercentile( 99.9 );
+        result.maxNanos = times.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 const int DataInputStreamBenchmark::bufferSize = 200000;
@@ -113,3 +232,39 @@ void DataInputStreamBenchmark::run() {
         bis.reset();
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamBenchmark::testPrimitives() {
+
+    ByteArrayOutputStream bytes;
+    DataOutputStream out( &bytes );
+    for( int i = 0; i < RECORD_COUNT; ++i ) {
+        out.writeInt( i * 31 );
+        out.writeLong( (long long)i << 33 );
+        out.writeShort( (short)i );
+        out.writeByte( (unsigned char)i );
+    }
+
+    std::pair<unsigned char*, int> array = bytes.toByteArray();
+    std::vector<unsigned char> data( array.first, array.first + array.second );
+    delete [] array.first;
+
+    const char* names[] = { "readPrimitives ByteArrayInputStream",
+                            "readPrimitives BufferedInputStream",
+                            "readPrimitives FilterInputStream" };
+    const StreamType types[] = { BYTE_ARRAY, BUFFERED, FILTERED };
+
+    long long expected = -1;
+    for( int i = 0; i < 3; ++i ) {
+        ReadRecords read( data, types[i] );
+        measure( names[i], read, (double)( RECORD_COUNT * RECORD_SIZE ) );
+
+        // All three must decode the same values.
+        ReadRecords check( data, types[i] );
+        check.run();
+        if( expected != -1 ) {
+            CPPUNIT_ASSERT_EQUAL( expected, check.total );
+        }
+        expected = check.total;
+    }
+}
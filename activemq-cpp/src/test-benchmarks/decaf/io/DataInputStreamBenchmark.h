@@ -29,6 +29,12 @@ namespace io{
         public benchmark::BenchmarkBase<
             decaf::io::DataInputStreamBenchmark, DataInputStream >
     {
+        typedef benchmark::BenchmarkBase< decaf::io::DataInputStreamBenchmark, DataInputStream > Base;
+
+        CPPUNIT_TEST_SUB_SUITE( DataInputStreamBenchmark, Base );
+        CPPUNIT_TEST( testPrimitives );
+        CPPUNIT_TEST_SUITE_END();
+
     private:
 
         unsigned char* buffer;
@@ -48,6 +54,13 @@ namespace io{
         virtual void setUp();
         virtual void tearDown();
         virtual void run();
+
+        /**
+         * Decodes records of mixed primitives from a ByteArrayInputStream and a
+         * BufferedInputStream, which hand DataInputStream their internal arrays, and
+         * through a FilterInputStream, which forces a read call per primitive.
+         */
+        void testPrimitives();
     };
 
 }}
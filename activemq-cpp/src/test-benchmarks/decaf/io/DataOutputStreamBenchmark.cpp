@@ -17,10 +17,127 @@
 
 #include "DataOutputStreamBenchmark.h"
 #include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/BufferedOutputStream.h>
+#include <decaf/io/FilterOutputStream.h>
+
+#include <benchmark/LatencyHistogram.h>
+#include <decaf/lang/System.h>
+
+#include <memory>
 
 using namespace std;
+using namespace benchmark;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int OPERATIONS = 200;
+    const int WARMUP_OPERATIONS = 20;
+
+    // Each record is an int, a long, a short and a byte, the mix the OpenWire
+    // marshalers write for a command header.
+    const int RECORD_COUNT = 4096;
+    const int RECORD_SIZE = 15;
+
+    enum StreamType {
+        BYTE_ARRAY,
+        BUFFERED,
+        FILTERED
+    };
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class WriteRecords : public Operation {
+    public:
+
+        StreamType type;
+        long long size;
+
+        WriteRecords( StreamType type ) : type( type ), size( 0 ) {}
+
+        virtual void run() {
+
+            ByteArrayOutputStream bytes( RECORD_COUNT * RECORD_SIZE );
+            std::auto_ptr<OutputStream> wrapper;
+            if( type == BUFFERED ) {
+                wrapper.reset( new BufferedOutputStream( &bytes ) );
+            } else if( type == FILTERED ) {
+                wrapper.reset( new FilterOutputStream( &bytes ) );
+            }
+
+            DataOutputStream out( wrapper.get() != NULL ? wrapper.get() : &bytes );
+
+            for( int i = 0; i < RECORD_COUNT; ++i ) {
+                out.writeInt( i * 31 );
+                out.writeLong( (long long)i << 33 );
+                out.writeShort( (short)i );
+                out.writeByte( (unsigned char)i );
+            }
+
+            out.flush();
+            size = bytes.size();
+        }
+    };
+
+    void measure( const std::string& name, Operation& operation, double bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int warmup = reporter.getWarmupIterations( WARMUP_OPERATIONS );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram times;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int i = 0; i < OPERATIONS; ++i ) {
+            long long operationStart = System::nanoTime();
+            operation.run();
+            times.record( System::nanoTime() - operationStart );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "DataOutputStreamBenchmark[" + name + "]";
+        result.iterations = OPERATIONS;
+        result.meanNanos = (double)elapsed / (double)OPERATIONS;
+        result.p50Nanos = times.getPercentile( 50.0 );
+        result.p99Nanos = times.getPercentile( 99.0 );
+        result.p999Nanos = times.getPercentile( 99.9 );
+        result.maxNanos = times.getMax();
+        result.opsPerSecond = (double)OPERATIONS / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)OPERATIONS;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 DataOutputStreamBenchmark::DataOutputStreamBenchmark() : testString() {
@@ -81,3 +198,18 @@ void DataOutputStreamBenchmark::run() {
 
     bos.reset();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStreamBenchmark::testPrimitives() {
+
+    const char* names[] = { "writePrimitives ByteArrayOutputStream",
+                            "writePrimitives BufferedOutputStream",
+                            "writePrimitives FilterOutputStream" };
+    const StreamType types[] = { BYTE_ARRAY, BUFFERED, FILTERED };
+
+    for( int i = 0; i < 3; ++i ) {
+        WriteRecords write( types[i] );
+        measure( names[i], write, (double)( RECORD_COUNT * RECORD_SIZE ) );
+        CPPUNIT_ASSERT_EQUAL( (long long)( RECORD_COUNT * RECORD_SIZE ), write.size );
+    }
+}
@@ -28,6 +28,12 @@ namespace io{
         public benchmark::BenchmarkBase<
         decaf::io::DataOutputStreamBenchmark, DataOutputStream >
     {
+        typedef benchmark::BenchmarkBase< decaf::io::DataOutputStreamBenchmark, DataOutputStream > Base;
+
+        CPPUNIT_TEST_SUB_SUITE( DataOutputStreamBenchmark, Base );
+        CPPUNIT_TEST( testPrimitives );
+        CPPUNIT_TEST_SUITE_END();
+
     private:
 
         std::string testString;
@@ -39,6 +45,13 @@ namespace io{
 
         virtual void setUp();
         virtual void run();
+
+        /**
+         * Encodes records of mixed primitives into a ByteArrayOutputStream and a
+         * BufferedOutputStream, which hand DataOutputStream their internal arrays, and
+         * through a FilterOutputStream, which forces a write call per primitive.
+         */
+        void testPrimitives();
     };
 
 }}
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChecksumBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <benchmark/HardwareCounters.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <decaf/internal/util/zip/ChecksumKernels.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/Random.h>
+#include <decaf/util/zip/Adler32.h>
+#include <decaf/util/zip/CRC32.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::zip;
+using namespace decaf::internal::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int WARMUP_BYTES = 4 * 1024 * 1024;
+    const int MEASURED_BYTES = 64 * 1024 * 1024;
+    const int BATCH_COUNT = 100;
+
+    const int SIZES[] = { 1024, 64 * 1024, 1024 * 1024 };
+    const char* SIZE_NAMES[] = { "1K", "64K", "1M" };
+    const int SIZE_COUNT = 3;
+
+    class Operation {
+    public:
+
+        virtual ~Operation() {}
+
+        virtual void run() = 0;
+    };
+
+    class Update : public Operation {
+    public:
+
+        Checksum& checksum;
+        const std::vector<unsigned char>& input;
+
+        Update( Checksum& checksum, const std::vector<unsigned char>& input ) :
+            checksum( checksum ), input( input ) {}
+
+        virtual void run() {
+            checksum.update( &input[0], (int)input.size(), 0, (int)input.size() );
+        }
+    };
+
+    // The same number of bytes is hashed for every buffer size so the small
+    // buffers run enough iterations to be measured.
+    void measure( const std::string& name, Operation& operation, int bytesPerOp ) {
+
+        BenchmarkReporter& reporter = BenchmarkReporter::getInstance();
+
+        int operations = MEASURED_BYTES / bytesPerOp;
+        int batchSize = operations > BATCH_COUNT ? operations / BATCH_COUNT : 1;
+        operations = ( operations / batchSize ) * batchSize;
+
+        int warmup = reporter.getWarmupIterations( WARMUP_BYTES / bytesPerOp + 1 );
+        for( int i = 0; i < warmup; ++i ) {
+            operation.run();
+        }
+
+        LatencyHistogram batches;
+        HardwareCounters counters;
+        long long allocations = AllocationCounter::getAllocations();
+        counters.start();
+        long long startTime = System::nanoTime();
+
+        for( int batch = 0; batch < operations / batchSize; ++batch ) {
+            long long batchStart = System::nanoTime();
+            for( int i = 0; i < batchSize; ++i ) {
+                operation.run();
+            }
+            batches.record( ( System::nanoTime() - batchStart ) / batchSize );
+        }
+
+        long long elapsed = System::nanoTime() - startTime;
+        counters.stop();
+        allocations = AllocationCounter::getAllocations() - allocations;
+
+        BenchmarkResult result;
+        result.name = "ChecksumBenchmark[" + name + "]";
+        result.iterations = operations;
+        result.meanNanos = (double)elapsed / (double)operations;
+        result.p50Nanos = batches.getPercentile( 50.0 );
+        result.p99Nanos = batches.getPercentile( 99.0 );
+        result.p999Nanos = batches.getPercentile( 99.9 );
+        result.maxNanos = batches.getMax();
+        result.opsPerSecond = (double)operations / ( (double)elapsed / 1000000000.0 );
+        result.bytesPerOp = (double)bytesPerOp;
+
+        if( AllocationCounter::isSupported() ) {
+            result.allocationsPerOp = (double)allocations / (double)operations;
+        }
+
+        if( counters.isAvailable() ) {
+            result.cycles = counters.getCycles();
+            result.instructions = counters.getInstructions();
+            result.cacheMisses = counters.getCacheMisses();
+        }
+
+        std::string regression = reporter.report( result );
+        CPPUNIT_ASSERT_MESSAGE( regression, regression.empty() );
+    }
+
+    void measureChecksum( const std::string& algorithm, Checksum& checksum, bool supported ) {
+
+        Random random( 42 );
+
+        for( int i = 0; i < SIZE_COUNT; ++i ) {
+
+            std::vector<unsigned char> data( SIZES[i] );
+            random.nextBytes( data );
+            Update update( checksum, data );
+
+            bool previous = ChecksumKernels::setEnabled( false );
+            measure( algorithm + " table " + SIZE_NAMES[i], update, SIZES[i] );
+
+            if( supported ) {
+                ChecksumKernels::setEnabled( true );
+                measure( algorithm + " simd " + SIZE_NAMES[i], update, SIZES[i] );
+            }
+
+            ChecksumKernels::setEnabled( previous );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChecksumBenchmark::ChecksumBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChecksumBenchmark::~ChecksumBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChecksumBenchmark::testCRC32() {
+
+    CRC32 crc;
+    measureChecksum( "crc32", crc, ChecksumKernels::isCrc32Supported() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChecksumBenchmark::testAdler32() {
+
+    Adler32 adler;
+    measureChecksum( "adler32", adler, ChecksumKernels::isAdler32Supported() );
+}
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_ZIP_CHECKSUMBENCHMARK_H_
+#define _DECAF_UTIL_ZIP_CHECKSUMBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <decaf/util/Config.h>
+
+namespace decaf{
+namespace util{
+namespace zip{
+
+    /**
+     * Measures the throughput of the CRC32 and Adler32 checksums over buffers from
+     * 1K to 1M, once with zlib's table driven code and once with the vectorized
+     * kernels when the processor supports them.  Each result reports the buffer
+     * size as its bytes per operation.
+     */
+    class ChecksumBenchmark : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( ChecksumBenchmark );
+        CPPUNIT_TEST( testCRC32 );
+        CPPUNIT_TEST( testAdler32 );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        ChecksumBenchmark();
+        virtual ~ChecksumBenchmark();
+
+        void testCRC32();
+        void testAdler32();
+
+    };
+
+}}}
+
+#endif /*_DECAF_UTIL_ZIP_CHECKSUMBENCHMARK_H_*/
@@ -20,9 +20,49 @@
 #include <cppunit/TestResult.h>
 #include <activemq/util/Config.h>
 #include <activemq/library/ActiveMQCPP.h>
+#include <benchmark/BenchmarkReporter.h>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
-int main( int argc AMQCPP_UNUSED, char **argv AMQCPP_UNUSED ) {
+namespace {
+
+    bool matchOption( const std::string& arg, const std::string& name, std::string& value ) {
+        if( arg.compare( 0, name.size(), name ) != 0 ) {
+            return false;
+        }
+
+        value = arg.substr( name.size() );
+        return true;
+    }
+}
+
+// Usage: activemq-test-benchmarks [--json=FILE] [--baseline=FILE]
+//                                 [--threshold=PERCENT] [--warmup=N] [TestName]
+int main( int argc, char **argv ) {
+
+    benchmark::BenchmarkReporter& reporter = benchmark::BenchmarkReporter::getInstance();
+    std::string testName;
+
+    for( int i = 1; i < argc; ++i ) {
+        std::string arg( argv[i] );
+        std::string value;
+
+        if( matchOption( arg, "--json=", value ) ) {
+            reporter.setJsonOutput( value );
+        } else if( matchOption( arg, "--baseline=", value ) ) {
+            if( !reporter.loadBaseline( value ) ) {
+                std::cout << "Could not read the baseline file: " << value << std::endl;
+                return 1;
+            }
+        } else if( matchOption( arg, "--threshold=", value ) ) {
+            reporter.setThreshold( std::atof( value.c_str() ) );
+        } else if( matchOption( arg, "--warmup=", value ) ) {
+            reporter.setWarmupIterations( std::atoi( value.c_str() ) );
+        } else {
+            testName = arg;
+        }
+    }
 
     activemq::library::ActiveMQCPP::initializeLibrary();
     bool wasSuccessful = false;
@@ -37,7 +77,7 @@ int main( int argc AMQCPP_UNUSED, char **argv AMQCPP_UNUSED ) {
         std::cout << "Starting the Benchmarks:" << std::endl;
         std::cout << "-----------------------------------------------------\n";
 
-        wasSuccessful = runner.run( "", false );
+        wasSuccessful = runner.run( testName, false );
 
         std::cout << "-----------------------------------------------------\n";
         std::cout << "Finished with the Benchmarks." << std::endl;
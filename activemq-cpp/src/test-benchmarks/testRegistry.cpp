@@ -17,6 +17,24 @@
 
 #include <activemq/util/PrimitiveMapBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::PrimitiveMapBenchmark );
+#include <activemq/util/DestinationCacheBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::DestinationCacheBenchmark );
+#include <activemq/cmsutil/CmsTemplateBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::CmsTemplateBenchmark );
+#include <activemq/core/MessageDispatchChannelBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::MessageDispatchChannelBenchmark );
+#include <activemq/core/MessagingBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::MessagingBenchmark );
+#include <activemq/selector/MessageSelectorBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::selector::MessageSelectorBenchmark );
+#include <activemq/wireformat/openwire/OpenWireFormatBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::OpenWireFormatBenchmark );
+#include <activemq/wireformat/openwire/utils/FlatPropertyMapBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::FlatPropertyMapBenchmark );
+#include <activemq/wireformat/stomp/StompFrameBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompFrameBenchmark );
+#include <activemq/compression/CompressionCodecBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::compression::CompressionCodecBenchmark );
 
 #include <decaf/lang/BooleanBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::lang::BooleanBenchmark );
@@ -37,6 +55,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::HashMapBenchmark );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::StlListBenchmark );
 #include <decaf/util/LinkedListBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::LinkedListBenchmark );
+#include <decaf/util/zip/ChecksumBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::zip::ChecksumBenchmark );
 
 #include <decaf/io/ByteArrayOutputStreamBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::io::ByteArrayOutputStreamBenchmark );
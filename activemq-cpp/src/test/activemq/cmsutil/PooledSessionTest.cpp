@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PooledSessionTest.h"
+#include "DummyConnection.h"
+#include <activemq/cmsutil/SessionPool.h>
+#include <activemq/cmsutil/ResourceLifecycleManager.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTempTopic.h>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::commands;
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledSessionTest::testCachedProducer() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    PooledSession* session = pool.takeSession();
+
+    ActiveMQQueue queue("test");
+    ActiveMQQueue sameQueue("test");
+    ActiveMQTopic topic("test");
+
+    cms::MessageProducer* producer = session->createCachedProducer(&queue);
+    CPPUNIT_ASSERT(producer != NULL);
+    CPPUNIT_ASSERT(producer == session->createCachedProducer(&queue));
+
+    // An equal destination from another object shares the producer.
+    CPPUNIT_ASSERT(producer == session->createCachedProducer(&sameQueue));
+
+    // A topic with the same name does not.
+    cms::MessageProducer* topicProducer = session->createCachedProducer(&topic);
+    CPPUNIT_ASSERT(topicProducer != NULL);
+    CPPUNIT_ASSERT(topicProducer != producer);
+    CPPUNIT_ASSERT(topicProducer == session->createCachedProducer(&topic));
+
+    CPPUNIT_ASSERT_THROW(session->createCachedProducer(NULL), cms::CMSException);
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledSessionTest::testCachedConsumer() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    PooledSession* session = pool.takeSession();
+
+    ActiveMQQueue queue("test");
+    ActiveMQQueue sameQueue("test");
+
+    cms::MessageConsumer* consumer = session->createCachedConsumer(&queue, "", false);
+    CPPUNIT_ASSERT(consumer != NULL);
+    CPPUNIT_ASSERT(consumer == session->createCachedConsumer(&queue, "", false));
+    CPPUNIT_ASSERT(consumer == session->createCachedConsumer(&sameQueue, "", false));
+
+    // The selector and noLocal flag are part of the key.
+    cms::MessageConsumer* selected = session->createCachedConsumer(&queue, "x = 1", false);
+    cms::MessageConsumer* noLocal = session->createCachedConsumer(&queue, "", true);
+    CPPUNIT_ASSERT(selected != consumer);
+    CPPUNIT_ASSERT(noLocal != consumer);
+    CPPUNIT_ASSERT(noLocal != selected);
+    CPPUNIT_ASSERT(selected == session->createCachedConsumer(&sameQueue, "x = 1", false));
+    CPPUNIT_ASSERT(noLocal == session->createCachedConsumer(&sameQueue, "", true));
+
+    CPPUNIT_ASSERT_THROW(session->createCachedConsumer(NULL, "", false), cms::CMSException);
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledSessionTest::testTemporaryDestinations() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    PooledSession* session = pool.takeSession();
+
+    ActiveMQTempQueue queue1("ID:temp:1");
+    ActiveMQTempQueue queue2("ID:temp:2");
+    ActiveMQTempTopic topic1("ID:temp:1");
+
+    cms::MessageProducer* producer1 = session->createCachedProducer(&queue1);
+    cms::MessageProducer* producer2 = session->createCachedProducer(&queue2);
+    cms::MessageProducer* producer3 = session->createCachedProducer(&topic1);
+
+    CPPUNIT_ASSERT(producer1 != producer2);
+    CPPUNIT_ASSERT(producer1 != producer3);
+    CPPUNIT_ASSERT(producer2 != producer3);
+    CPPUNIT_ASSERT(producer1 == session->createCachedProducer(&queue1));
+    CPPUNIT_ASSERT(producer2 == session->createCachedProducer(&queue2));
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PooledSessionTest::testChangedDestination() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    PooledSession* session = pool.takeSession();
+
+    // The same object naming a different destination, as happens when the address
+    // of a deleted destination is reused, must not find the old producer.
+    ActiveMQQueue queue("first");
+
+    cms::MessageProducer* first = session->createCachedProducer(&queue);
+    queue.setPhysicalName("second");
+    cms::MessageProducer* second = session->createCachedProducer(&queue);
+
+    CPPUNIT_ASSERT(first != second);
+
+    queue.setPhysicalName("first");
+    CPPUNIT_ASSERT(first == session->createCachedProducer(&queue));
+
+    session->close();
+}
@@ -19,8 +19,64 @@
 #include "DummyConnection.h"
 #include <activemq/cmsutil/SessionPool.h>
 #include <activemq/cmsutil/ResourceLifecycleManager.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <set>
+#include <vector>
 
 using namespace activemq::cmsutil;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class PoolUser : public Runnable {
+    private:
+
+        SessionPool& pool;
+        Mutex& mutex;
+        std::set<PooledSession*>& inUse;
+
+    private:
+
+        PoolUser(const PoolUser&);
+        PoolUser& operator= (const PoolUser&);
+
+    public:
+
+        bool failed;
+
+        PoolUser(SessionPool& pool, Mutex& mutex, std::set<PooledSession*>& inUse) :
+            Runnable(), pool(pool), mutex(mutex), inUse(inUse), failed(false) {}
+
+        virtual void run() {
+
+            for (int i = 0; i < 2000; ++i) {
+
+                PooledSession* session = pool.takeSession();
+
+                // No other thread may hold the session while we have it.
+                synchronized(&mutex) {
+                    if (!inUse.insert(session).second) {
+                        failed = true;
+                    }
+                }
+
+                if (i % 100 == 0) {
+                    Thread::yield();
+                }
+
+                synchronized(&mutex) {
+                    inUse.erase(session);
+                }
+
+                pool.returnSession(session);
+            }
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void SessionPoolTest::testTakeSession() {
@@ -87,3 +143,66 @@ void SessionPoolTest::testCloseSession() {
     // Make sure they're the same object.
     CPPUNIT_ASSERT(pooledSession1 == pooledSession2); 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SessionPoolTest::testReturnMoreThanSlots() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+
+    // More sessions than the pool can park without its lock.
+    const int count = SessionPool::SLOT_COUNT + 8;
+
+    std::set<PooledSession*> taken;
+    for (int i = 0; i < count; ++i) {
+        taken.insert(pool.takeSession());
+    }
+    CPPUNIT_ASSERT_EQUAL(count, (int) taken.size());
+
+    std::set<PooledSession*>::const_iterator iter = taken.begin();
+    for (; iter != taken.end(); ++iter) {
+        pool.returnSession(*iter);
+    }
+
+    // Every session comes back out again before a new one is created.
+    std::set<PooledSession*> retaken;
+    for (int i = 0; i < count; ++i) {
+        retaken.insert(pool.takeSession());
+    }
+    CPPUNIT_ASSERT(taken == retaken);
+
+    CPPUNIT_ASSERT(taken.find(pool.takeSession()) == taken.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SessionPoolTest::testConcurrentTakeAndReturn() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+
+    Mutex mutex;
+    std::set<PooledSession*> inUse;
+
+    const int numThreads = 8;
+    std::vector<PoolUser*> users;
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < numThreads; ++i) {
+        users.push_back(new PoolUser(pool, mutex, inUse));
+        threads.push_back(new Thread(users.back()));
+        threads.back()->start();
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        threads[i]->join();
+        CPPUNIT_ASSERT_MESSAGE("A session was handed to two threads at once", !users[i]->failed);
+        delete threads[i];
+        delete users[i];
+    }
+
+    CPPUNIT_ASSERT(inUse.empty());
+}
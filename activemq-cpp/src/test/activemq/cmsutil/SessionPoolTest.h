@@ -30,6 +30,8 @@ namespace cmsutil{
         CPPUNIT_TEST( testTakeSession );
         CPPUNIT_TEST( testReturnSession );
         CPPUNIT_TEST( testCloseSession );
+        CPPUNIT_TEST( testReturnMoreThanSlots );
+        CPPUNIT_TEST( testConcurrentTakeAndReturn );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +42,8 @@ namespace cmsutil{
         void testTakeSession();
         void testReturnSession();
         void testCloseSession();
+        void testReturnMoreThanSlots();
+        void testConcurrentTakeAndReturn();
     };
 
 }}
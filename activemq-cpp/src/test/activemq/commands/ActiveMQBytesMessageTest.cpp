@@ -20,15 +20,50 @@
 #include <decaf/util/UUID.h>
 #include <decaf/lang/Exception.h>
 #include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/MessageBodyReleaser.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/util/Properties.h>
 
 using namespace std;
 using namespace cms;
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::commands;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace activemq::wireformat::openwire::marshal::generated;
 using namespace decaf;
+using namespace decaf::io;
 using namespace decaf::lang;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class MyBodyReleaser : public MessageBodyReleaser {
+    public:
+
+        int released;
+        const unsigned char* buffer;
+        int length;
+
+        MyBodyReleaser() : MessageBodyReleaser(), released(0), buffer(NULL), length(0) {}
+
+        virtual ~MyBodyReleaser() {}
+
+        virtual void release(const unsigned char* buffer, int length) {
+            this->released++;
+            this->buffer = buffer;
+            this->length = length;
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQBytesMessageTest::testGetBodyLength() {
     ActiveMQBytesMessage msg;
@@ -459,3 +494,135 @@ void ActiveMQBytesMessageTest::testWriteOnlyBody() {
     } catch( MessageNotReadableException& e ) {
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testGetBodyBuffer() {
+
+    ActiveMQBytesMessage message;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotReadableException",
+        message.getBodyBuffer(),
+        MessageNotReadableException );
+
+    unsigned char data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    message.writeBytes( data, 0, 8 );
+    message.reset();
+
+    const unsigned char* body = message.getBodyBuffer();
+    CPPUNIT_ASSERT( body != NULL );
+    CPPUNIT_ASSERT_EQUAL( 8, message.getBodyLength() );
+    CPPUNIT_ASSERT( std::equal( data, data + 8, body ) );
+    CPPUNIT_ASSERT( body == message.getBodyBuffer() );
+
+    // The view doesn't consume the stream.
+    CPPUNIT_ASSERT_EQUAL( (unsigned char) 1, message.readByte() );
+
+    ActiveMQBytesMessage empty;
+    empty.reset();
+    CPPUNIT_ASSERT( empty.getBodyBuffer() == NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testSetBodyBuffer() {
+
+    MyBodyReleaser releaser;
+    unsigned char data[] = { 10, 20, 30, 40 };
+
+    {
+        ActiveMQBytesMessage message;
+        message.setBodyBuffer( data, 4, &releaser );
+        message.reset();
+
+        CPPUNIT_ASSERT_EQUAL( 4, message.getBodyLength() );
+        CPPUNIT_ASSERT( message.getBodyBuffer() == data );
+        CPPUNIT_ASSERT_EQUAL( 10, (int) message.readByte() );
+
+        // Copies share the same buffer and the last one out releases it.
+        std::auto_ptr<ActiveMQBytesMessage> copy( message.cloneDataStructure() );
+        CPPUNIT_ASSERT( copy->getBodyBuffer() == data );
+        CPPUNIT_ASSERT_EQUAL( 4, copy->getBodyLength() );
+        CPPUNIT_ASSERT_EQUAL( 0, releaser.released );
+
+        copy.reset( NULL );
+        CPPUNIT_ASSERT_EQUAL( 0, releaser.released );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 1, releaser.released );
+    CPPUNIT_ASSERT( releaser.buffer == data );
+    CPPUNIT_ASSERT_EQUAL( 4, releaser.length );
+
+    ActiveMQBytesMessage message;
+    message.setBodyBuffer( data, 4, &releaser );
+    message.clearBody();
+    CPPUNIT_ASSERT_EQUAL( 2, releaser.released );
+
+    message.reset();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotWriteableException",
+        message.setBodyBuffer( data, 4, &releaser ),
+        MessageNotWriteableException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testSetBodyBufferThenWrite() {
+
+    MyBodyReleaser releaser;
+    unsigned char data[] = { 1, 2, 3 };
+
+    ActiveMQBytesMessage message;
+    message.setBodyBuffer( data, 3, &releaser );
+    message.writeByte( 4 );
+
+    // Appending takes a private copy of the body.
+    CPPUNIT_ASSERT_EQUAL( 1, releaser.released );
+
+    message.reset();
+    CPPUNIT_ASSERT_EQUAL( 4, message.getBodyLength() );
+
+    const unsigned char* body = message.getBodyBuffer();
+    CPPUNIT_ASSERT( body != data );
+    CPPUNIT_ASSERT_EQUAL( 1, (int) body[0] );
+    CPPUNIT_ASSERT_EQUAL( 4, (int) body[3] );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testMarshalBodyBuffer() {
+
+    MyBodyReleaser releaser;
+    std::vector<unsigned char> data( 256 );
+    for( int i = 0; i < 256; ++i ) {
+        data[i] = (unsigned char) i;
+    }
+
+    ActiveMQBytesMessageMarshaller marshaller;
+    decaf::util::Properties props;
+    OpenWireFormat openWireFormat( props );
+    openWireFormat.setVersion( 11 );
+
+    ActiveMQBytesMessage outCommand;
+    ActiveMQBytesMessage inCommand;
+
+    outCommand.setBodyBuffer( &data[0], (int) data.size(), &releaser );
+    outCommand.onSend();
+
+    ByteArrayOutputStream baos;
+    DataOutputStream dataOut( &baos );
+    BooleanStream bs;
+    marshaller.tightMarshal1( &openWireFormat, &outCommand, &bs );
+    bs.marshal( &dataOut );
+    marshaller.tightMarshal2( &openWireFormat, &outCommand, &dataOut, &bs );
+
+    std::pair<const unsigned char*, int> array = baos.toByteArray();
+    ByteArrayInputStream bais( array.first, array.second, true );
+    DataInputStream dataIn( &bais );
+    bs.clear();
+    bs.unmarshal( &dataIn );
+    marshaller.tightUnmarshal( &openWireFormat, &inCommand, &dataIn, &bs );
+
+    inCommand.setReadOnlyBody( true );
+    CPPUNIT_ASSERT_EQUAL( 256, inCommand.getBodyLength() );
+    CPPUNIT_ASSERT( std::equal( data.begin(), data.end(), inCommand.getBodyBuffer() ) );
+    CPPUNIT_ASSERT( inCommand.getExternalContent() == NULL );
+    CPPUNIT_ASSERT_EQUAL( 0, releaser.released );
+}
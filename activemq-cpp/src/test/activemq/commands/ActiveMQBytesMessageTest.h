@@ -43,6 +43,10 @@ namespace commands{
         CPPUNIT_TEST( testReset );
         CPPUNIT_TEST( testReadOnlyBody );
         CPPUNIT_TEST( testWriteOnlyBody );
+        CPPUNIT_TEST( testGetBodyBuffer );
+        CPPUNIT_TEST( testSetBodyBuffer );
+        CPPUNIT_TEST( testSetBodyBufferThenWrite );
+        CPPUNIT_TEST( testMarshalBodyBuffer );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -67,6 +71,10 @@ namespace commands{
         void testReset();
         void testReadOnlyBody();
         void testWriteOnlyBody();
+        void testGetBodyBuffer();
+        void testSetBodyBuffer();
+        void testSetBodyBufferThenWrite();
+        void testMarshalBodyBuffer();
 
     };
 
@@ -0,0 +1,266 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionCodecTest.h"
+
+#include <activemq/compression/CompressionCodec.h>
+#include <activemq/compression/CompressionCodecRegistry.h>
+#include <activemq/compression/DeflateCompressionCodec.h>
+#include <activemq/compression/LZ4CompressionCodec.h>
+
+#include <decaf/internal/util/zip/LZ4Block.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/util/Random.h>
+#include <decaf/util/zip/DataFormatException.h>
+#include <decaf/util/zip/DeflaterOutputStream.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/NoSuchElementException.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::compression;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> createText(int size) {
+
+        std::string text;
+        for (int i = 0; (int) text.size() < size; ++i) {
+            text += "{\"order\":" + Integer::toString(i) + ",\"symbol\":\"AMQ\",\"side\":\"BUY\",\"quantity\":" +
+                    Integer::toString(i * 7 % 1000) + "}\n";
+        }
+
+        return std::vector<unsigned char>(text.begin(), text.begin() + size);
+    }
+
+    std::vector<unsigned char> createRandom(int size) {
+
+        Random random(42);
+        std::vector<unsigned char> data(size);
+        if (size > 0) {
+            random.nextBytes(data);
+        }
+
+        return data;
+    }
+
+    void assertRoundTrip(const CompressionCodec& codec, const std::vector<unsigned char>& data) {
+
+        std::vector<unsigned char> compressed;
+        std::vector<unsigned char> decompressed;
+
+        const unsigned char* input = data.empty() ? NULL : &data[0];
+        codec.compress(input, (int) data.size(), -1, compressed);
+        CPPUNIT_ASSERT(!compressed.empty());
+        CPPUNIT_ASSERT(codec.recognizes(&compressed[0], (int) compressed.size()));
+
+        codec.decompress(&compressed[0], (int) compressed.size(), decompressed);
+        CPPUNIT_ASSERT_EQUAL(data.size(), decompressed.size());
+        CPPUNIT_ASSERT(std::equal(data.begin(), data.end(), decompressed.begin()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testRegistry() {
+
+    CompressionCodecRegistry& registry = CompressionCodecRegistry::getInstance();
+
+    std::vector<std::string> names = registry.getCodecNames();
+    CPPUNIT_ASSERT(std::find(names.begin(), names.end(), DeflateCompressionCodec::NAME) != names.end());
+    CPPUNIT_ASSERT(std::find(names.begin(), names.end(), LZ4CompressionCodec::NAME) != names.end());
+
+    CPPUNIT_ASSERT_EQUAL(DeflateCompressionCodec::NAME, registry.findCodec("deflate")->getName());
+    CPPUNIT_ASSERT_EQUAL(LZ4CompressionCodec::NAME, registry.findCodec("lz4")->getName());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an NoSuchElementException",
+        registry.findCodec("snappy"),
+        NoSuchElementException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an NullPointerException",
+        registry.registerCodec(NULL),
+        NullPointerException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testDeflateRoundTrip() {
+
+    DeflateCompressionCodec codec;
+
+    assertRoundTrip(codec, std::vector<unsigned char>());
+    assertRoundTrip(codec, createText(1));
+    assertRoundTrip(codec, createText(1000));
+    assertRoundTrip(codec, createText(256 * 1024));
+    assertRoundTrip(codec, createRandom(100000));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testLZ4RoundTrip() {
+
+    LZ4CompressionCodec codec;
+
+    assertRoundTrip(codec, std::vector<unsigned char>());
+
+    // Sizes around the minimum match and end of block limits.
+    for (int size = 1; size < 40; ++size) {
+        assertRoundTrip(codec, createText(size));
+        assertRoundTrip(codec, std::vector<unsigned char>(size, 'A'));
+    }
+
+    assertRoundTrip(codec, createText(1000));
+    assertRoundTrip(codec, createText(256 * 1024));
+    assertRoundTrip(codec, createRandom(100000));
+
+    // Runs long enough to need extended literal and match lengths.
+    std::vector<unsigned char> mixed = createRandom(5000);
+    mixed.resize(mixed.size() + 70000, 0);
+    std::vector<unsigned char> tail = createRandom(300);
+    mixed.insert(mixed.end(), tail.begin(), tail.end());
+    assertRoundTrip(codec, mixed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testLZ4Compresses() {
+
+    LZ4CompressionCodec codec;
+
+    std::vector<unsigned char> text = createText(64 * 1024);
+    std::vector<unsigned char> compressed;
+    codec.compress(&text[0], (int) text.size(), -1, compressed);
+    CPPUNIT_ASSERT(compressed.size() < text.size() / 2);
+
+    // Incompressible data may only grow by the block's worst case overhead.
+    std::vector<unsigned char> random = createRandom(64 * 1024);
+    codec.compress(&random[0], (int) random.size(), -1, compressed);
+    CPPUNIT_ASSERT(compressed.size() <= random.size() + random.size() / 255 + 16 + LZ4CompressionCodec::HEADER_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testFindCodecFor() {
+
+    CompressionCodecRegistry& registry = CompressionCodecRegistry::getInstance();
+    std::vector<unsigned char> text = createText(4096);
+    std::vector<unsigned char> compressed;
+
+    registry.findCodec("lz4")->compress(&text[0], (int) text.size(), -1, compressed);
+    CPPUNIT_ASSERT_EQUAL(LZ4CompressionCodec::NAME,
+                         registry.findCodecFor(&compressed[0], (int) compressed.size())->getName());
+
+    for (int level = -1; level <= 9; ++level) {
+        registry.findCodec("deflate")->compress(&text[0], (int) text.size(), level, compressed);
+        CPPUNIT_ASSERT_EQUAL(DeflateCompressionCodec::NAME,
+                             registry.findCodecFor(&compressed[0], (int) compressed.size())->getName());
+    }
+
+    // Unknown data is assumed to be deflated, as it was before codecs existed.
+    CPPUNIT_ASSERT_EQUAL(DeflateCompressionCodec::NAME,
+                         registry.findCodecFor(&text[0], (int) text.size())->getName());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testReadsDeflaterOutputStream() {
+
+    std::vector<unsigned char> text = createText(10000);
+
+    ByteArrayOutputStream bytesOut;
+    DeflaterOutputStream deflater(&bytesOut);
+    deflater.write(&text[0], (int) text.size());
+    deflater.close();
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> compressed(array.first, array.first + array.second);
+    delete[] array.first;
+
+    CompressionCodec* codec = CompressionCodecRegistry::getInstance().findCodecFor(
+        &compressed[0], (int) compressed.size());
+    CPPUNIT_ASSERT_EQUAL(DeflateCompressionCodec::NAME, codec->getName());
+
+    std::vector<unsigned char> decompressed;
+    codec->decompress(&compressed[0], (int) compressed.size(), decompressed);
+    CPPUNIT_ASSERT(text == decompressed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testCorruptInput() {
+
+    std::vector<unsigned char> text = createText(10000);
+    std::vector<unsigned char> compressed;
+    std::vector<unsigned char> decompressed;
+
+    LZ4CompressionCodec lz4;
+    lz4.compress(&text[0], (int) text.size(), -1, compressed);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        lz4.decompress(&compressed[0], (int) compressed.size() / 2, decompressed),
+        IOException);
+
+    // Claim a longer body than the block holds.
+    compressed[2] = 0x7F;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        lz4.decompress(&compressed[0], (int) compressed.size(), decompressed),
+        IOException);
+
+    DeflateCompressionCodec deflate;
+    deflate.compress(&text[0], (int) text.size(), -1, compressed);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException",
+        deflate.decompress(&compressed[0], (int) compressed.size() / 2, decompressed),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testLZ4LengthOverflow() {
+
+    // A literal length extended by enough 255 bytes to overflow an int.
+    std::vector<unsigned char> block(9 * 1024 * 1024, 255);
+    block[0] = 0xF0;
+
+    std::vector<unsigned char> output(16);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a DataFormatException",
+        decaf::internal::util::zip::LZ4Block::decompress(&block[0], (int) block.size(), &output[0], (int) output.size()),
+        DataFormatException);
+
+    // The same for a match length, after a one byte literal.
+    block[0] = 0x1F;
+    block[1] = 'a';
+    block[2] = 1;
+    block[3] = 0;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a DataFormatException",
+        decaf::internal::util::zip::LZ4Block::decompress(&block[0], (int) block.size(), &output[0], (int) output.size()),
+        DataFormatException);
+}
@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECTEST_H_
+#define _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace compression {
+
+    class CompressionCodecTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( CompressionCodecTest );
+        CPPUNIT_TEST( testRegistry );
+        CPPUNIT_TEST( testDeflateRoundTrip );
+        CPPUNIT_TEST( testLZ4RoundTrip );
+        CPPUNIT_TEST( testLZ4Compresses );
+        CPPUNIT_TEST( testFindCodecFor );
+        CPPUNIT_TEST( testReadsDeflaterOutputStream );
+        CPPUNIT_TEST( testCorruptInput );
+        CPPUNIT_TEST( testLZ4LengthOverflow );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        CompressionCodecTest() {}
+        virtual ~CompressionCodecTest() {}
+
+        void testRegistry();
+        void testDeflateRoundTrip();
+        void testLZ4RoundTrip();
+        void testLZ4Compresses();
+        void testFindCodecFor();
+        void testReadsDeflaterOutputStream();
+        void testCorruptInput();
+        void testLZ4LengthOverflow();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMPRESSION_COMPRESSIONCODECTEST_H_ */
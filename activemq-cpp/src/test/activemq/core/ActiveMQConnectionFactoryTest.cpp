@@ -25,6 +25,7 @@
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQProducer.h>
+#include <activemq/core/policies/AdaptivePrefetchPolicy.h>
 #include <activemq/commands/ActiveMQTextMessage.h>
 #include <activemq/transport/TransportListener.h>
 #include <memory>
@@ -306,7 +307,7 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
             "mock://127.0.0.1:23232?connection.dispatchAsync=true&"
             "connection.alwaysSyncSend=true&connection.useAsyncSend=true&"
             "connection.useCompression=true&connection.compressionLevel=7&"
-            "connection.closeTimeout=10000";
+            "connection.closeTimeout=10000&connection.asyncRegistration=true";
 
         ActiveMQConnectionFactory connectionFactory( URI );
 
@@ -316,6 +317,7 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( connectionFactory.isUseCompression() == true );
         CPPUNIT_ASSERT( connectionFactory.getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( connectionFactory.getCompressionLevel() == 7 );
+        CPPUNIT_ASSERT( connectionFactory.isAsyncRegistration() == true );
 
         cms::Connection* connection =
             connectionFactory.createConnection();
@@ -330,6 +332,7 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( amqConnection->isUseCompression() == true );
         CPPUNIT_ASSERT( amqConnection->getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( amqConnection->getCompressionLevel() == 7 );
+        CPPUNIT_ASSERT( amqConnection->isAsyncRegistration() == true );
 
         delete connection;
 
@@ -340,3 +343,31 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
 
     CPPUNIT_ASSERT( false );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactoryTest::testAdaptivePrefetchURIOptions() {
+
+    std::string URI =
+        "mock://127.0.0.1:23232?cms.prefetchPolicy.adaptive=true&"
+        "cms.prefetchPolicy.queuePrefetch=200&cms.prefetchPolicy.minimumPrefetch=20&"
+        "cms.prefetchPolicy.adjustmentInterval=500";
+
+    ActiveMQConnectionFactory connectionFactory( URI );
+
+    PrefetchPolicy* policy = connectionFactory.getPrefetchPolicy();
+    CPPUNIT_ASSERT( policy->isAdaptive() );
+    CPPUNIT_ASSERT_EQUAL( 200, policy->getQueuePrefetch() );
+    CPPUNIT_ASSERT_EQUAL( 500LL, policy->getPrefetchAdjustmentInterval() );
+
+    policies::AdaptivePrefetchPolicy* adaptive =
+        dynamic_cast<policies::AdaptivePrefetchPolicy*>( policy );
+    CPPUNIT_ASSERT( adaptive != NULL );
+    CPPUNIT_ASSERT_EQUAL( 20, adaptive->getMinimumPrefetch() );
+
+    std::auto_ptr<cms::Connection> connection( connectionFactory.createConnection() );
+    ActiveMQConnection* amqConnection = dynamic_cast<ActiveMQConnection*>( connection.get() );
+    CPPUNIT_ASSERT( amqConnection->getPrefetchPolicy()->isAdaptive() );
+
+    ActiveMQConnectionFactory fixedFactory( "mock://127.0.0.1:23232" );
+    CPPUNIT_ASSERT( !fixedFactory.getPrefetchPolicy()->isAdaptive() );
+}
@@ -31,10 +31,19 @@
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/TransportRegistry.h>
 #include <activemq/util/Config.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/BrokerError.h>
+#include <activemq/commands/ExceptionResponse.h>
 #include <activemq/commands/Message.h>
+#include <activemq/commands/Response.h>
+#include <activemq/wireformat/openwire/OpenWireResponseBuilder.h>
 
 #include <cms/Connection.h>
 #include <cms/ExceptionListener.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
 
 using namespace activemq;
 using namespace activemq::core;
@@ -118,6 +127,43 @@ namespace core {
             return 1;
         }
     };
+
+    // Answers like the OpenWire builder but refuses consumers on the REFUSED Queue.
+    class RefusingResponseBuilder : public wireformat::openwire::OpenWireResponseBuilder {
+    public:
+
+        int registrations;
+
+    public:
+
+        RefusingResponseBuilder() : registrations(0) {}
+
+        virtual ~RefusingResponseBuilder() {}
+
+        virtual Pointer<commands::Response> buildResponse(const Pointer<commands::Command> command) {
+
+            if (command->isConsumerInfo() || command->isProducerInfo()) {
+                registrations++;
+            }
+
+            if (command->isConsumerInfo()) {
+                Pointer<commands::ConsumerInfo> info = command.dynamicCast<commands::ConsumerInfo>();
+                if (info->getDestination()->getPhysicalName() == "REFUSED") {
+
+                    Pointer<commands::BrokerError> error(new commands::BrokerError());
+                    error->setExceptionClass("javax.jms.JMSSecurityException");
+                    error->setMessage("User is not authorized to read from: queue://REFUSED");
+
+                    Pointer<commands::ExceptionResponse> response(new commands::ExceptionResponse());
+                    response->setCorrelationId(command->getCommandId());
+                    response->setException(error);
+                    return response;
+                }
+            }
+
+            return OpenWireResponseBuilder::buildResponse(command);
+        }
+    };
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -250,3 +296,48 @@ void ActiveMQConnectionTest::testExceptionInOnException() {
         throw ex;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionTest::testAsyncRegistration() {
+
+    MyExceptionListener exListener;
+    ActiveMQConnectionFactory factory("mock://mock");
+    factory.setAsyncRegistration(true);
+
+    std::auto_ptr<cms::Connection> connection(factory.createConnection());
+    ActiveMQConnection* amqConnection = dynamic_cast<ActiveMQConnection*>(connection.get());
+    CPPUNIT_ASSERT(amqConnection->isAsyncRegistration());
+    amqConnection->setExceptionListener(&exListener);
+
+    transport::mock::MockTransport* transport = transport::mock::MockTransport::getInstance();
+    Pointer<RefusingResponseBuilder> builder(new RefusingResponseBuilder());
+    transport->setResponseBuilder(builder);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    CPPUNIT_ASSERT(amqConnection->awaitRegistrations(2000));
+    int registrations = builder->registrations;
+
+    commands::ActiveMQQueue accepted("ACCEPTED");
+    commands::ActiveMQQueue refused("REFUSED");
+
+    std::auto_ptr<cms::MessageConsumer> consumer1(session->createConsumer(&accepted));
+    std::auto_ptr<cms::MessageConsumer> consumer2(session->createConsumer(&refused));
+    std::auto_ptr<cms::MessageConsumer> consumer3(session->createConsumer(&accepted));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(&accepted));
+
+    // The refusal reaches the listener and is thrown once from awaitRegistrations.
+    CPPUNIT_ASSERT(exListener.waitForException(2000));
+    CPPUNIT_ASSERT_THROW_MESSAGE("Should throw the refusal",
+        amqConnection->awaitRegistrations(2000), cms::CMSException);
+    CPPUNIT_ASSERT(amqConnection->awaitRegistrations(2000));
+    CPPUNIT_ASSERT_EQUAL(registrations + 4, builder->registrations);
+
+    // Without pipelining the refusal is thrown by the create call.
+    amqConnection->setAsyncRegistration(false);
+    CPPUNIT_ASSERT_THROW_MESSAGE("Should refuse the consumer",
+        session->createConsumer(&refused), cms::CMSException);
+    std::auto_ptr<cms::MessageConsumer> consumer4(session->createConsumer(&accepted));
+    CPPUNIT_ASSERT_EQUAL(registrations + 6, builder->registrations);
+
+    connection->close();
+}
@@ -30,6 +30,7 @@ namespace core {
         CPPUNIT_TEST( test2WithOpenwire );
         CPPUNIT_TEST( testCloseCancelsHungStart );
         CPPUNIT_TEST( testExceptionInOnException );
+        CPPUNIT_TEST( testAsyncRegistration );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +41,7 @@ namespace core {
         void test2WithOpenwire();
         void testCloseCancelsHungStart();
         void testExceptionInOnException();
+        void testAsyncRegistration();
 
     };
 
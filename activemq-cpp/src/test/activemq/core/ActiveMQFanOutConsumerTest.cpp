@@ -0,0 +1,575 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ActiveMQFanOutConsumerTest.h"
+
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConsumer.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/ExceptionListener.h>
+#include <cms/InvalidSelectorException.h>
+#include <cms/TextMessage.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingListener : public cms::MessageListener {
+    private:
+
+        RecordingListener(const RecordingListener&);
+        RecordingListener& operator=(const RecordingListener&);
+
+    public:
+
+        mutable Mutex mutex;
+        std::vector<std::string> bodies;
+        std::vector<const cms::Message*> instances;
+        std::set<const Thread*> threads;
+        CountDownLatch* gate;
+
+        RecordingListener() : mutex(), bodies(), instances(), threads(), gate(NULL) {}
+
+        virtual ~RecordingListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+
+            if (gate != NULL) {
+                gate->await();
+            }
+
+            std::string body;
+            const cms::TextMessage* textMessage = dynamic_cast<const cms::TextMessage*>(message);
+            if (textMessage != NULL) {
+                body = textMessage->getText();
+            } else {
+                const cms::BytesMessage* bytesMessage = dynamic_cast<const cms::BytesMessage*>(message);
+                std::vector<unsigned char> buffer(bytesMessage->getBodyLength());
+                if (!buffer.empty()) {
+                    bytesMessage->readBytes(buffer);
+                }
+                body = std::string(buffer.begin(), buffer.end());
+            }
+
+            synchronized(&mutex) {
+                bodies.push_back(body);
+                instances.push_back(message);
+                threads.insert(Thread::currentThread());
+                mutex.notifyAll();
+            }
+        }
+
+        int count() const {
+            synchronized(&mutex) {
+                return (int) bodies.size();
+            }
+            return 0;
+        }
+
+        bool waitFor(int expected) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 100 && (int) bodies.size() < expected; ++i) {
+                    mutex.wait(50);
+                }
+                return (int) bodies.size() == expected;
+            }
+            return false;
+        }
+    };
+
+    class ThrowingListener : public RecordingListener {
+    private:
+
+        ThrowingListener(const ThrowingListener&);
+        ThrowingListener& operator=(const ThrowingListener&);
+
+    public:
+
+        ThrowingListener() : RecordingListener() {}
+
+        virtual ~ThrowingListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+            RecordingListener::onMessage(message);
+            throw decaf::lang::exceptions::IllegalStateException(__FILE__, __LINE__, "Listener failed");
+        }
+    };
+
+    class SelfRemovingListener : public RecordingListener {
+    private:
+
+        SelfRemovingListener(const SelfRemovingListener&);
+        SelfRemovingListener& operator=(const SelfRemovingListener&);
+
+    public:
+
+        ActiveMQFanOutConsumer* consumer;
+        bool removed;
+
+        SelfRemovingListener() : RecordingListener(), consumer(NULL), removed(false) {}
+
+        virtual ~SelfRemovingListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+            removed = consumer->removeMessageListener(this);
+            RecordingListener::onMessage(message);
+        }
+    };
+
+    class ClosingListener : public RecordingListener {
+    private:
+
+        ClosingListener(const ClosingListener&);
+        ClosingListener& operator=(const ClosingListener&);
+
+    public:
+
+        ActiveMQFanOutConsumer* consumer;
+        CountDownLatch closed;
+
+        ClosingListener() : RecordingListener(), consumer(NULL), closed(1) {}
+
+        virtual ~ClosingListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+            RecordingListener::onMessage(message);
+            if (closed.getCount() > 0) {
+                consumer->close();
+                closed.countDown();
+            }
+        }
+    };
+
+    class RecordingExceptionListener : public cms::ExceptionListener {
+    private:
+
+        RecordingExceptionListener(const RecordingExceptionListener&);
+        RecordingExceptionListener& operator=(const RecordingExceptionListener&);
+
+    public:
+
+        Mutex mutex;
+        std::vector<std::string> messages;
+
+        RecordingExceptionListener() : mutex(), messages() {}
+
+        virtual ~RecordingExceptionListener() {}
+
+        virtual void onException(const cms::CMSException& ex) {
+            synchronized(&mutex) {
+                messages.push_back(ex.getMessage());
+                mutex.notifyAll();
+            }
+        }
+
+        bool waitFor(int expected) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 100 && (int) messages.size() < expected; ++i) {
+                    mutex.wait(50);
+                }
+                return (int) messages.size() == expected;
+            }
+            return false;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::setUp() {
+
+    ActiveMQConnectionFactory factory("mock://127.0.0.1:12345?wireFormat=openwire");
+
+    connection.reset(dynamic_cast<ActiveMQConnection*>(factory.createConnection()));
+
+    dTransport = dynamic_cast<transport::mock::MockTransport*>(
+        connection->getTransport().narrow(typeid(transport::mock::MockTransport)));
+    CPPUNIT_ASSERT(dTransport != NULL);
+
+    connection->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::tearDown() {
+    connection.reset(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQFanOutConsumer* ActiveMQFanOutConsumerTest::createFanOutConsumer(cms::Session* session, int maxPending) {
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestFanOutTopic"));
+    return new ActiveMQFanOutConsumer(session->createConsumer(topic.get()), maxPending);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::injectMessage(ActiveMQFanOutConsumer* consumer,
+                                               const Pointer<commands::Message>& message,
+                                               long long timeStamp) {
+
+    ActiveMQConsumer* amqConsumer = dynamic_cast<ActiveMQConsumer*>(consumer->getMessageConsumer());
+    CPPUNIT_ASSERT(amqConsumer != NULL);
+
+    const ConsumerId& id = *(amqConsumer->getConsumerId());
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId(id.getConnectionId());
+    producerId->setSessionId(id.getSessionId());
+    producerId->setValue(1);
+
+    Pointer<MessageId> messageId(new MessageId());
+    messageId->setProducerId(producerId);
+    messageId->setProducerSequenceId(timeStamp);
+
+    Pointer<ActiveMQTopic> topic(new ActiveMQTopic("TestFanOutTopic"));
+    message->setDestination(topic);
+    message->setMessageId(messageId);
+    message->setTimestamp(timeStamp);
+
+    Pointer<MessageDispatch> dispatch(new MessageDispatch());
+    dispatch->setMessage(message);
+    dispatch->setDestination(topic);
+    dispatch->setConsumerId(Pointer<ConsumerId>(id.cloneDataStructure()));
+
+    dTransport->fireCommand(dispatch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::injectTextMessage(ActiveMQFanOutConsumer* consumer,
+                                                   const std::string& text, long long timeStamp) {
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setText(text);
+    injectMessage(consumer, message, timeStamp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testFanOut() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingListener listeners[3];
+    for (int i = 0; i < 3; ++i) {
+        consumer->addMessageListener(&listeners[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(3, consumer->getMessageListenerCount());
+
+    for (int i = 0; i < 5; ++i) {
+        injectTextMessage(consumer.get(), "Message " + decaf::lang::Integer::toString(i), i + 1);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT(listeners[i].waitFor(5));
+        for (int j = 0; j < 5; ++j) {
+            CPPUNIT_ASSERT_EQUAL("Message " + decaf::lang::Integer::toString(j), listeners[i].bodies[j]);
+        }
+        CPPUNIT_ASSERT_EQUAL(1, (int) listeners[i].threads.size());
+    }
+
+    // One copy of each Message is shared between all of the listeners, each
+    // of which runs on its own thread.
+    for (int j = 0; j < 5; ++j) {
+        CPPUNIT_ASSERT(listeners[0].instances[j] == listeners[1].instances[j]);
+        CPPUNIT_ASSERT(listeners[0].instances[j] == listeners[2].instances[j]);
+    }
+
+    CPPUNIT_ASSERT(*listeners[0].threads.begin() != *listeners[1].threads.begin());
+    CPPUNIT_ASSERT(*listeners[1].threads.begin() != *listeners[2].threads.begin());
+    CPPUNIT_ASSERT(*listeners[0].threads.begin() != Thread::currentThread());
+
+    consumer->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testSelectors() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingListener all;
+    RecordingListener late;
+    RecordingListener none;
+    consumer->addMessageListener(&all);
+    consumer->addMessageListener(&late, "JMSTimestamp > 3");
+    consumer->addMessageListener(&none, "JMSTimestamp > 100");
+
+    for (int i = 1; i <= 5; ++i) {
+        injectTextMessage(consumer.get(), "Message " + decaf::lang::Integer::toString(i), i);
+    }
+
+    CPPUNIT_ASSERT(all.waitFor(5));
+    CPPUNIT_ASSERT(late.waitFor(2));
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 4"), late.bodies[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 5"), late.bodies[1]);
+    CPPUNIT_ASSERT_EQUAL(0, none.count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testBytesMessagesAreCopied() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingListener first;
+    RecordingListener second;
+    consumer->addMessageListener(&first);
+    consumer->addMessageListener(&second);
+
+    Pointer<ActiveMQBytesMessage> message(new ActiveMQBytesMessage());
+    std::string payload = "bytes payload";
+    message->writeBytes((const unsigned char*) payload.c_str(), 0, (int) payload.size());
+    message->reset();
+    injectMessage(consumer.get(), message, 1);
+
+    // Each listener reads the whole body through its own cursor.
+    CPPUNIT_ASSERT(first.waitFor(1));
+    CPPUNIT_ASSERT(second.waitFor(1));
+    CPPUNIT_ASSERT_EQUAL(payload, first.bodies[0]);
+    CPPUNIT_ASSERT_EQUAL(payload, second.bodies[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testRemoveListener() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingListener kept;
+    RecordingListener removed;
+    consumer->addMessageListener(&kept);
+    consumer->addMessageListener(&removed);
+
+    injectTextMessage(consumer.get(), "First", 1);
+    CPPUNIT_ASSERT(removed.waitFor(1));
+
+    CPPUNIT_ASSERT(consumer->removeMessageListener(&removed));
+    CPPUNIT_ASSERT(!consumer->removeMessageListener(&removed));
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getMessageListenerCount());
+
+    injectTextMessage(consumer.get(), "Second", 2);
+    CPPUNIT_ASSERT(kept.waitFor(2));
+    CPPUNIT_ASSERT_EQUAL(1, removed.count());
+
+    // A removed listener can be added again.
+    consumer->addMessageListener(&removed);
+    injectTextMessage(consumer.get(), "Third", 3);
+    CPPUNIT_ASSERT(removed.waitFor(2));
+    CPPUNIT_ASSERT_EQUAL(std::string("Third"), removed.bodies[1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testSlowListenerBoundsPending() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get(), 2));
+    CPPUNIT_ASSERT_EQUAL(2, consumer->getMaxPendingMessages());
+
+    CountDownLatch gate(1);
+    RecordingListener fast;
+    RecordingListener slow;
+    slow.gate = &gate;
+    consumer->addMessageListener(&fast);
+    consumer->addMessageListener(&slow);
+
+    for (int i = 1; i <= 5; ++i) {
+        injectTextMessage(consumer.get(), "Message " + decaf::lang::Integer::toString(i), i);
+    }
+
+    // The slow listener holds two Messages, delivery stops while handing it the third.
+    CPPUNIT_ASSERT(fast.waitFor(3));
+    Thread::sleep(100);
+    CPPUNIT_ASSERT_EQUAL(3, fast.count());
+
+    gate.countDown();
+
+    CPPUNIT_ASSERT(fast.waitFor(5));
+    CPPUNIT_ASSERT(slow.waitFor(5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testInvalidArguments() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestFanOutTopic"));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for a NULL consumer",
+        ActiveMQFanOutConsumer(NULL),
+        cms::CMSException);
+
+    std::auto_ptr<cms::MessageConsumer> plain(session->createConsumer(topic.get()));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for no pending messages",
+        ActiveMQFanOutConsumer(plain.get(), 0),
+        cms::CMSException);
+
+    RecordingListener listener;
+    plain->setMessageListener(&listener);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for a consumer with a listener",
+        ActiveMQFanOutConsumer(plain.get()),
+        cms::CMSException);
+
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for a NULL listener",
+        consumer->addMessageListener(NULL),
+        cms::CMSException);
+
+    consumer->addMessageListener(&listener);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for a listener added twice",
+        consumer->addMessageListener(&listener),
+        cms::CMSException);
+
+    RecordingListener other;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an InvalidSelectorException",
+        consumer->addMessageListener(&other, "JMSTimestamp >"),
+        cms::InvalidSelectorException);
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getMessageListenerCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testClose() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingListener listener;
+    consumer->addMessageListener(&listener);
+
+    injectTextMessage(consumer.get(), "Message", 1);
+    CPPUNIT_ASSERT(listener.waitFor(1));
+
+    consumer->close();
+    consumer->close();
+    CPPUNIT_ASSERT_EQUAL(0, consumer->getMessageListenerCount());
+
+    RecordingListener late;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException once closed",
+        consumer->addMessageListener(&late),
+        cms::CMSException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testListenerExceptionsAreReported() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    RecordingExceptionListener exceptions;
+    CPPUNIT_ASSERT(consumer->getExceptionListener() == NULL);
+    consumer->setExceptionListener(&exceptions);
+    CPPUNIT_ASSERT(consumer->getExceptionListener() == &exceptions);
+
+    ThrowingListener failing;
+    RecordingListener other;
+    consumer->addMessageListener(&failing);
+    consumer->addMessageListener(&other);
+
+    injectTextMessage(consumer.get(), "First", 1);
+    injectTextMessage(consumer.get(), "Second", 2);
+
+    // Each failure is reported and the failing listener still gets the later Messages.
+    CPPUNIT_ASSERT(failing.waitFor(2));
+    CPPUNIT_ASSERT(other.waitFor(2));
+    CPPUNIT_ASSERT(exceptions.waitFor(2));
+    CPPUNIT_ASSERT(exceptions.messages[0].find("Listener failed") != std::string::npos);
+
+    consumer->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testListenerRemovesItself() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get()));
+
+    SelfRemovingListener leaving;
+    RecordingListener staying;
+    leaving.consumer = consumer.get();
+    consumer->addMessageListener(&leaving);
+    consumer->addMessageListener(&staying);
+
+    // Removal from the listener's own thread returns without waiting on itself.
+    injectTextMessage(consumer.get(), "First", 1);
+    CPPUNIT_ASSERT(leaving.waitFor(1));
+    CPPUNIT_ASSERT(leaving.removed);
+    CPPUNIT_ASSERT_EQUAL(1, consumer->getMessageListenerCount());
+
+    injectTextMessage(consumer.get(), "Second", 2);
+    CPPUNIT_ASSERT(staying.waitFor(2));
+    CPPUNIT_ASSERT_EQUAL(1, leaving.count());
+
+    // The retired listener can be added again once it has finished.
+    consumer->addMessageListener(&leaving);
+    injectTextMessage(consumer.get(), "Third", 3);
+    CPPUNIT_ASSERT(leaving.waitFor(2));
+    CPPUNIT_ASSERT(staying.waitFor(3));
+
+    consumer->close();
+    CPPUNIT_ASSERT_EQUAL(0, consumer->getMessageListenerCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQFanOutConsumerTest::testListenerClosesWhilePendingIsFull() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<ActiveMQFanOutConsumer> consumer(createFanOutConsumer(session.get(), 1));
+
+    CountDownLatch gate(1);
+    ClosingListener closing;
+    closing.consumer = consumer.get();
+    closing.gate = &gate;
+    consumer->addMessageListener(&closing);
+
+    // The first Message holds the only permit, the session blocks handing over the second.
+    for (int i = 1; i <= 3; ++i) {
+        injectTextMessage(consumer.get(), "Message " + decaf::lang::Integer::toString(i), i);
+    }
+    Thread::sleep(100);
+
+    gate.countDown();
+
+    // Closing from the listener must not wait on the session that is waiting on it.
+    CPPUNIT_ASSERT(closing.closed.await(10000));
+    CPPUNIT_ASSERT_EQUAL(1, closing.count());
+    CPPUNIT_ASSERT_EQUAL(0, consumer->getMessageListenerCount());
+}
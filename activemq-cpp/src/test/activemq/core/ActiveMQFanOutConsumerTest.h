@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMERTEST_H_
+#define _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQFanOutConsumer.h>
+#include <activemq/commands/Message.h>
+#include <activemq/transport/mock/MockTransport.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <memory>
+
+namespace activemq {
+namespace core {
+
+    class ActiveMQFanOutConsumerTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( ActiveMQFanOutConsumerTest );
+        CPPUNIT_TEST( testFanOut );
+        CPPUNIT_TEST( testSelectors );
+        CPPUNIT_TEST( testBytesMessagesAreCopied );
+        CPPUNIT_TEST( testRemoveListener );
+        CPPUNIT_TEST( testSlowListenerBoundsPending );
+        CPPUNIT_TEST( testInvalidArguments );
+        CPPUNIT_TEST( testClose );
+        CPPUNIT_TEST( testListenerExceptionsAreReported );
+        CPPUNIT_TEST( testListenerRemovesItself );
+        CPPUNIT_TEST( testListenerClosesWhilePendingIsFull );
+        CPPUNIT_TEST_SUITE_END();
+
+    private:
+
+        std::auto_ptr<ActiveMQConnection> connection;
+        transport::mock::MockTransport* dTransport;
+
+    private:
+
+        ActiveMQFanOutConsumerTest(const ActiveMQFanOutConsumerTest&);
+        ActiveMQFanOutConsumerTest& operator= (const ActiveMQFanOutConsumerTest&);
+
+    public:
+
+        ActiveMQFanOutConsumerTest() : connection(), dTransport(NULL) {}
+        virtual ~ActiveMQFanOutConsumerTest() {}
+
+        virtual void setUp();
+        virtual void tearDown();
+
+        void testFanOut();
+        void testSelectors();
+        void testBytesMessagesAreCopied();
+        void testRemoveListener();
+        void testSlowListenerBoundsPending();
+        void testInvalidArguments();
+        void testClose();
+        void testListenerExceptionsAreReported();
+        void testListenerRemovesItself();
+        void testListenerClosesWhilePendingIsFull();
+
+    private:
+
+        ActiveMQFanOutConsumer* createFanOutConsumer(cms::Session* session, int maxPending = 100);
+
+        void injectMessage(ActiveMQFanOutConsumer* consumer,
+                           const decaf::lang::Pointer<commands::Message>& message,
+                           long long timeStamp);
+
+        void injectTextMessage(ActiveMQFanOutConsumer* consumer, const std::string& text, long long timeStamp);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ACTIVEMQFANOUTCONSUMERTEST_H_ */
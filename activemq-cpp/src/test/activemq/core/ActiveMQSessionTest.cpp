@@ -18,18 +18,27 @@
 #include "ActiveMQSessionTest.h"
 
 #include <cms/ExceptionListener.h>
+#include <cms/BatchMessageConsumer.h>
+#include <cms/InvalidSelectorException.h>
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/ConsumerId.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/ProducerAck.h>
 #include <activemq/core/ActiveMQConnectionFactory.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQConsumer.h>
 #include <activemq/core/ActiveMQProducer.h>
+#include <activemq/core/policies/AdaptivePrefetchPolicy.h>
+#include <activemq/util/MemoryUsage.h>
 #include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/Pointer.h>
+#include <decaf/lang/Integer.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/net/Socket.h>
 #include <decaf/net/ServerSocket.h>
@@ -101,6 +110,77 @@ namespace core {
             AMQ_CATCHALL_THROW( activemq::exceptions::ActiveMQException )
         }
     };
+
+    class MyProducerWindowListener : public ProducerWindowListener {
+    public:
+
+        int notifications;
+        cms::MessageProducer* producer;
+
+    public:
+
+        MyProducerWindowListener() : notifications(0), producer(NULL) {
+        }
+
+        virtual ~MyProducerWindowListener() {
+        }
+
+        virtual void onWindowAvailable(cms::MessageProducer* producer) {
+            this->producer = producer;
+            notifications++;
+        }
+    };
+
+    class MyConsumerControlListener : public transport::DefaultTransportListener {
+    public:
+
+        std::vector<int> prefetches;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyConsumerControlListener() : prefetches(), mutex() {
+        }
+
+        virtual ~MyConsumerControlListener() {
+        }
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            if (command->isConsumerControl()) {
+                synchronized(&mutex) {
+                    prefetches.push_back(command.dynamicCast<ConsumerControl>()->getPrefetch());
+                }
+            }
+        }
+
+        std::vector<int> getPrefetches() {
+            synchronized(&mutex) {
+                return prefetches;
+            }
+
+            return std::vector<int>();
+        }
+    };
+
+    class MyMessageAckListener : public transport::DefaultTransportListener {
+    public:
+
+        decaf::util::concurrent::atomic::AtomicInteger acks;
+
+    public:
+
+        MyMessageAckListener() : acks() {
+        }
+
+        virtual ~MyMessageAckListener() {
+        }
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            if (command->isMessageAck()) {
+                acks.incrementAndGet();
+            }
+        }
+    };
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -694,6 +774,377 @@ void ActiveMQSessionTest::testCreateTempTopicByName() {
     CPPUNIT_ASSERT(topic->getDestinationType() == cms::Destination::TEMPORARY_TOPIC);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testTrySendOnFullProducerWindow() {
+
+    MyProducerWindowListener windowListener;
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    connection->setProducerWindowSize(1024);
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<cms::MessageProducer> cmsProducer(session->createProducer(topic.get()));
+    cmsProducer->setDeliveryMode(cms::DeliveryMode::NON_PERSISTENT);
+
+    ActiveMQProducer* producer = dynamic_cast<ActiveMQProducer*>(cmsProducer.get());
+    CPPUNIT_ASSERT(producer != NULL);
+    producer->setProducerWindowListener(&windowListener);
+
+    CPPUNIT_ASSERT_EQUAL(1024ULL, producer->getProducerWindowSize());
+    CPPUNIT_ASSERT_EQUAL(0ULL, producer->getProducerWindowUsage());
+    CPPUNIT_ASSERT(!producer->isProducerWindowFull());
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage(std::string(2048, 'a')));
+
+    // The first send fits, the async send then fills the window.
+    CPPUNIT_ASSERT(producer->trySend(message.get()));
+    CPPUNIT_ASSERT(producer->isProducerWindowFull());
+    unsigned long long usage = producer->getProducerWindowUsage();
+    CPPUNIT_ASSERT(usage >= 2048ULL);
+
+    // The window is full so the send must be refused without blocking.
+    CPPUNIT_ASSERT(!producer->trySend(message.get()));
+    CPPUNIT_ASSERT(!producer->trySend(message.get()));
+    CPPUNIT_ASSERT_EQUAL(2LL, producer->getProducerWindowFullCount());
+    CPPUNIT_ASSERT_EQUAL(0, windowListener.notifications);
+
+    Pointer<ProducerAck> ack(new ProducerAck());
+    ack->setProducerId(producer->getProducerId());
+    ack->setSize((int) usage);
+    dTransport->fireCommand(ack);
+
+    CPPUNIT_ASSERT_EQUAL(1, windowListener.notifications);
+    CPPUNIT_ASSERT(windowListener.producer == cmsProducer.get());
+    CPPUNIT_ASSERT(!producer->isProducerWindowFull());
+    CPPUNIT_ASSERT(producer->trySend(message.get()));
+
+    producer->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testConnectionMetrics() {
+
+    MyCMSMessageListener msgListener(false);
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::CLIENT_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestTopic"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    producer->setDeliveryMode(cms::DeliveryMode::NON_PERSISTENT);
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("metrics"));
+    producer->send(message.get());
+    producer->send(message.get());
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    consumer->setMessageListener(&msgListener);
+
+    injectTextMessage("This is a Test 1", *topic, *(consumer->getConsumerId()));
+    msgListener.asyncWaitForMessages(1);
+    CPPUNIT_ASSERT_EQUAL(1, (int) msgListener.messages.size());
+
+    metrics::MetricsSnapshot snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(2LL, snapshot.getCounter("messages.sent"));
+    CPPUNIT_ASSERT(snapshot.getCounter("bytes.sent") > 0);
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getCounter("messages.received"));
+    CPPUNIT_ASSERT(snapshot.getCounter("bytes.received") > 0);
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getGauge("sessions"));
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getGauge("consumers"));
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getGauge("consumer.deliveredUnacked"));
+    CPPUNIT_ASSERT(snapshot.getGauge("consumer.prefetchLimit") > 0);
+
+    // Session and consumer creation are synchronous requests.
+    CPPUNIT_ASSERT(snapshot.getHistogram("request.time").getCount() >= 2);
+
+    // A delivered ack may already have gone out, the consumed ack adds one more.
+    long long acksSent = snapshot.getCounter("acks.sent");
+    msgListener.messages[0]->acknowledge();
+
+    snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(acksSent + 1, snapshot.getCounter("acks.sent"));
+    CPPUNIT_ASSERT_EQUAL(acksSent + 1, snapshot.getHistogram("ack.sendTime").getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getGauge("consumer.deliveredUnacked"));
+    CPPUNIT_ASSERT(!snapshot.toString().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testBatchReceive() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestBatchQueue"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(queue.get())));
+    cms::BatchMessageConsumer* batchConsumer = consumer.get();
+
+    CPPUNIT_ASSERT(batchConsumer->receive(10, -1).empty());
+    CPPUNIT_ASSERT(batchConsumer->receive(10, 5).empty());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw when asked for no messages",
+        batchConsumer->receive(0, -1),
+        cms::CMSException);
+
+    for (int i = 0; i < 5; ++i) {
+        injectTextMessage("Batch " + decaf::lang::Integer::toString(i), *queue, *(consumer->getConsumerId()));
+    }
+
+    waitForAvailable(consumer.get(), 5);
+
+    long long acksSent = connection->getMetricsSnapshot().getCounter("acks.sent");
+
+    std::vector<cms::Message*> messages = batchConsumer->receive(3, 1000);
+    CPPUNIT_ASSERT_EQUAL(3, (int) messages.size());
+    for (int i = 0; i < 3; ++i) {
+        std::auto_ptr<cms::TextMessage> message(dynamic_cast<cms::TextMessage*>(messages[i]));
+        CPPUNIT_ASSERT(message.get() != NULL);
+        CPPUNIT_ASSERT_EQUAL("Batch " + decaf::lang::Integer::toString(i), message->getText());
+    }
+
+    // The whole batch is consumed with a single ack.
+    metrics::MetricsSnapshot snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(acksSent + 1, snapshot.getCounter("acks.sent"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getGauge("consumer.deliveredUnacked"));
+
+    messages = batchConsumer->receive(10, -1);
+    CPPUNIT_ASSERT_EQUAL(2, (int) messages.size());
+    for (int i = 0; i < 2; ++i) {
+        std::auto_ptr<cms::TextMessage> message(dynamic_cast<cms::TextMessage*>(messages[i]));
+        CPPUNIT_ASSERT_EQUAL("Batch " + decaf::lang::Integer::toString(i + 3), message->getText());
+    }
+
+    CPPUNIT_ASSERT(batchConsumer->receive(10, -1).empty());
+    CPPUNIT_ASSERT(consumer->receiveNoWait() == NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testBatchReceiveClientAck() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::CLIENT_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestBatchQueue"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(queue.get())));
+
+    for (int i = 0; i < 4; ++i) {
+        injectTextMessage("Batch " + decaf::lang::Integer::toString(i), *queue, *(consumer->getConsumerId()));
+    }
+
+    waitForAvailable(consumer.get(), 4);
+
+    long long acksSent = connection->getMetricsSnapshot().getCounter("acks.sent");
+
+    std::vector<cms::Message*> messages = consumer->receive(10, 0);
+    CPPUNIT_ASSERT_EQUAL(4, (int) messages.size());
+
+    metrics::MetricsSnapshot snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(4LL, snapshot.getGauge("consumer.deliveredUnacked"));
+
+    // Acknowledging any message of the batch acknowledges all of it at once.
+    messages.back()->acknowledge();
+
+    snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(acksSent + 1, snapshot.getCounter("acks.sent"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getGauge("consumer.deliveredUnacked"));
+
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        delete messages[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testLocalSelector() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestLocalSelectorQueue"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(queue.get())));
+
+    CPPUNIT_ASSERT_EQUAL(std::string(""), consumer->getLocalSelector());
+    consumer->setLocalSelector("JMSTimestamp % 2 = 0");
+    CPPUNIT_ASSERT_EQUAL(std::string("JMSTimestamp % 2 = 0"), consumer->getLocalSelector());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an InvalidSelectorException",
+        consumer->setLocalSelector("JMSTimestamp %"),
+        cms::InvalidSelectorException);
+    CPPUNIT_ASSERT_EQUAL(std::string("JMSTimestamp % 2 = 0"), consumer->getLocalSelector());
+
+    for (int i = 1; i <= 6; ++i) {
+        injectTextMessage("Message " + decaf::lang::Integer::toString(i), *queue, *(consumer->getConsumerId()), i);
+    }
+
+    // Everything is queued, the receiving thread consumes the messages that don't match.
+    waitForAvailable(consumer.get(), 6);
+
+    for (int i = 2; i <= 6; i += 2) {
+        std::auto_ptr<cms::TextMessage> message(dynamic_cast<cms::TextMessage*>(consumer->receive(1000)));
+        CPPUNIT_ASSERT(message.get() != NULL);
+        CPPUNIT_ASSERT_EQUAL("Message " + decaf::lang::Integer::toString(i), message->getText());
+    }
+
+    CPPUNIT_ASSERT(consumer->receiveNoWait() == NULL);
+    CPPUNIT_ASSERT_EQUAL(0LL, connection->getMetricsSnapshot().getGauge("consumer.deliveredUnacked"));
+
+    consumer->setLocalSelector("");
+    CPPUNIT_ASSERT_EQUAL(std::string(""), consumer->getLocalSelector());
+
+    injectTextMessage("Message 7", *queue, *(consumer->getConsumerId()), 7);
+    waitForAvailable(consumer.get(), 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testLocalSelectorListener() {
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestLocalSelectorListenerQueue"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(queue.get())));
+    consumer->setLocalSelector("JMSTimestamp % 2 = 0");
+
+    MyCMSMessageListener listener;
+    consumer->setMessageListener(&listener);
+
+    for (int i = 1; i <= 6; ++i) {
+        injectTextMessage("Message " + decaf::lang::Integer::toString(i), *queue, *(consumer->getConsumerId()), i);
+    }
+
+    // The listener's messages are filtered on the dispatch thread before delivery.
+    listener.asyncWaitForMessages(3);
+    Thread::sleep(50);
+
+    synchronized(&listener.mutex) {
+        CPPUNIT_ASSERT_EQUAL(3, (int) listener.messages.size());
+        for (int i = 0; i < 3; ++i) {
+            CPPUNIT_ASSERT_EQUAL(2LL * (i + 1), listener.messages[i]->getCMSTimestamp());
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0LL, connection->getMetricsSnapshot().getGauge("consumer.deliveredUnacked"));
+    consumer->setMessageListener(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testConsumerMemoryLimit() {
+
+    MyConsumerControlListener controls;
+    dTransport->setOutgoingListener(&controls);
+
+    // Any buffered message fills the budget.
+    connection->setConsumerMemoryLimit(1);
+    CPPUNIT_ASSERT_EQUAL(1LL, connection->getConsumerMemoryLimit());
+
+    std::auto_ptr<cms::Session> session(connection->createSession());
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestConsumerMemoryLimitQueue"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(queue.get())));
+    int prefetch = consumer->getConsumerInfo()->getCurrentPrefetchSize();
+
+    CPPUNIT_ASSERT(!consumer->isPausedOnMemoryLimit());
+    CPPUNIT_ASSERT_EQUAL(0LL, consumer->getBufferedBytes());
+
+    injectTextMessage("Message 1", *queue, *(consumer->getConsumerId()));
+    injectTextMessage("Message 2", *queue, *(consumer->getConsumerId()));
+    waitForAvailable(consumer.get(), 2);
+
+    // The first message closes the window, the second arrived before the Broker saw it.
+    CPPUNIT_ASSERT(consumer->isPausedOnMemoryLimit());
+    CPPUNIT_ASSERT_EQUAL(1, (int) controls.getPrefetches().size());
+    CPPUNIT_ASSERT_EQUAL(0, controls.getPrefetches()[0]);
+
+    long long buffered = consumer->getBufferedBytes();
+    CPPUNIT_ASSERT(buffered > 0);
+    CPPUNIT_ASSERT_EQUAL(buffered, (long long) connection->getConsumerMemoryUsage()->getUsage());
+
+    metrics::MetricsSnapshot snapshot = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(buffered, snapshot.getGauge("consumer.bufferedBytes"));
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getGauge("consumer.pausedOnMemoryLimit"));
+
+    std::auto_ptr<cms::Message> message(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+    CPPUNIT_ASSERT(consumer->isPausedOnMemoryLimit());
+    CPPUNIT_ASSERT(consumer->getBufferedBytes() > 0);
+    CPPUNIT_ASSERT(consumer->getBufferedBytes() < buffered);
+
+    // Emptying its own queue reopens the consumer's window.
+    message.reset(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+    CPPUNIT_ASSERT(!consumer->isPausedOnMemoryLimit());
+    CPPUNIT_ASSERT_EQUAL(0LL, consumer->getBufferedBytes());
+    CPPUNIT_ASSERT_EQUAL(0ULL, connection->getConsumerMemoryUsage()->getUsage());
+    CPPUNIT_ASSERT_EQUAL(2, (int) controls.getPrefetches().size());
+    CPPUNIT_ASSERT_EQUAL(prefetch, controls.getPrefetches()[1]);
+
+    injectTextMessage("Message 3", *queue, *(consumer->getConsumerId()));
+    injectTextMessage("Message 4", *queue, *(consumer->getConsumerId()));
+    waitForAvailable(consumer.get(), 2);
+    CPPUNIT_ASSERT(consumer->isPausedOnMemoryLimit());
+
+    // Removing the limit resumes a paused consumer even with messages still queued.
+    connection->setConsumerMemoryLimit(0);
+    message.reset(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+    CPPUNIT_ASSERT(!consumer->isPausedOnMemoryLimit());
+    CPPUNIT_ASSERT_EQUAL(4, (int) controls.getPrefetches().size());
+    CPPUNIT_ASSERT_EQUAL(prefetch, controls.getPrefetches()[3]);
+
+    consumer->close();
+    dTransport->setOutgoingListener(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAdaptivePrefetchDestinationOption() {
+
+    MyMessageAckListener acks;
+    dTransport->setOutgoingListener(&acks);
+
+    // Keeps the policy from moving the window while the test runs.
+    policies::AdaptivePrefetchPolicy* policy = new policies::AdaptivePrefetchPolicy();
+    policy->setAdjustmentInterval(60000);
+    connection->setPrefetchPolicy(policy);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::DUPS_OK_ACKNOWLEDGE));
+    // DUPS_OK batches its acks on Topics, a batch is sent once half the prefetch is consumed.
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestAdaptivePrefetchTopic?consumer.prefetchSize=4"));
+
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    // The window the policy adapts starts from the destination's prefetch, not the policy's.
+    CPPUNIT_ASSERT_EQUAL(4, consumer->getConsumerInfo()->getPrefetchSize());
+    CPPUNIT_ASSERT_EQUAL(4, consumer->getConsumerInfo()->getCurrentPrefetchSize());
+
+    injectTextMessage("Message 1", *topic, *(consumer->getConsumerId()));
+    injectTextMessage("Message 2", *topic, *(consumer->getConsumerId()));
+    waitForAvailable(consumer.get(), 2);
+
+    CPPUNIT_ASSERT_EQUAL(0, acks.acks.get());
+
+    std::auto_ptr<cms::Message> message(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+    message.reset(consumer->receive(1000));
+    CPPUNIT_ASSERT(message.get() != NULL);
+
+    // Half of a prefetch of four has been consumed so the batch must be acked.
+    CPPUNIT_ASSERT_EQUAL(1, acks.acks.get());
+
+    consumer->close();
+    dTransport->setOutgoingListener(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::waitForAvailable(ActiveMQConsumer* consumer, int count) {
+    for (int i = 0; i < 100 && consumer->getMessageAvailableCount() < count; ++i) {
+        Thread::sleep(20);
+    }
+    CPPUNIT_ASSERT_EQUAL(count, consumer->getMessageAvailableCount());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::setUp() {
 
@@ -717,6 +1168,10 @@ void ActiveMQSessionTest::setUp() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::tearDown() {
+    // A test that failed part way may have left its stack listener installed.
+    if (dTransport != NULL) {
+        dTransport->setOutgoingListener(NULL);
+    }
     connection.reset(NULL);
 }
 
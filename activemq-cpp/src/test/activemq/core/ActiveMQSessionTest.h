@@ -36,6 +36,8 @@
 namespace activemq{
 namespace core{
 
+    class ActiveMQConsumer;
+
     class ActiveMQSessionTest : public CppUnit::TestFixture {
 
         CPPUNIT_TEST_SUITE( ActiveMQSessionTest );
@@ -51,6 +53,14 @@ namespace core{
         CPPUNIT_TEST( testCreateManyConsumersAndSetListeners );
         CPPUNIT_TEST( testCreateTempQueueByName );
         CPPUNIT_TEST( testCreateTempTopicByName );
+        CPPUNIT_TEST( testTrySendOnFullProducerWindow );
+        CPPUNIT_TEST( testConnectionMetrics );
+        CPPUNIT_TEST( testBatchReceive );
+        CPPUNIT_TEST( testBatchReceiveClientAck );
+        CPPUNIT_TEST( testLocalSelector );
+        CPPUNIT_TEST( testLocalSelectorListener );
+        CPPUNIT_TEST( testConsumerMemoryLimit );
+        CPPUNIT_TEST( testAdaptivePrefetchDestinationOption );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -90,6 +100,8 @@ namespace core{
                                const long long timeStamp = -1,
                                const long long timeToLive = -1);
 
+        void waitForAvailable(ActiveMQConsumer* consumer, int count);
+
     public:
 
         ActiveMQSessionTest();
@@ -107,6 +119,14 @@ namespace core{
         void testExpiration();
         void testCreateTempQueueByName();
         void testCreateTempTopicByName();
+        void testTrySendOnFullProducerWindow();
+        void testConnectionMetrics();
+        void testBatchReceive();
+        void testBatchReceiveClientAck();
+        void testLocalSelector();
+        void testLocalSelectorListener();
+        void testConsumerMemoryLimit();
+        void testAdaptivePrefetchDestinationOption();
 
     };
 
@@ -0,0 +1,473 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PriorityMessageDispatchChannelTest.h"
+
+#include <activemq/core/PriorityMessageDispatchChannel.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/util/MemoryUsage.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testCtor() {
+
+    PriorityMessageDispatchChannel channel;
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isClosed() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testStart() {
+
+    PriorityMessageDispatchChannel channel;
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testStop() {
+
+    PriorityMessageDispatchChannel channel;
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    channel.stop();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testClose() {
+
+    PriorityMessageDispatchChannel channel;
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    CPPUNIT_ASSERT( channel.isClosed() == false );
+    channel.close();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isClosed() == true );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isClosed() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testEnqueue() {
+
+    PriorityMessageDispatchChannel channel;
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueue( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueue( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testEnqueueFront() {
+
+    PriorityMessageDispatchChannel channel;
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueueFirst( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueueFirst( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testPeek() {
+
+    PriorityMessageDispatchChannel channel;
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueueFirst( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueueFirst( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+
+    CPPUNIT_ASSERT( channel.peek() == NULL );
+
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.peek() == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+    CPPUNIT_ASSERT( channel.peek() == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testDequeueNoWait() {
+
+    PriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testDequeue() {
+
+    PriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+
+    long long timeStarted = System::currentTimeMillis();
+
+    CPPUNIT_ASSERT( channel.dequeue( 1000 ) == NULL );
+
+    CPPUNIT_ASSERT( System::currentTimeMillis() - timeStarted >= 999 );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.dequeue( -1 ) == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeue( 1000 ) == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testRemoveAll() {
+
+    PriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.removeAll().size() == 3 );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testDrainTo() {
+
+    PriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    std::vector< Pointer<MessageDispatch> > drained;
+
+    CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 0 );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.drainTo( drained, 2 ) == 2 );
+    CPPUNIT_ASSERT( drained[0] == dispatch2 );
+    CPPUNIT_ASSERT( drained[1] == dispatch1 );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 1 );
+    CPPUNIT_ASSERT( drained.size() == 3 );
+    CPPUNIT_ASSERT( drained[2] == dispatch3 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testBufferedBytes() {
+
+    Pointer<MemoryUsage> usage( new MemoryUsage( 1024 * 1024 ) );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+
+    message1->setContent( std::vector<unsigned char>( 100 ) );
+    message2->setContent( std::vector<unsigned char>( 2000 ) );
+
+    message1->setPriority( 4 );
+    message2->setPriority( 4 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+
+    long long size1 = message1->getSize();
+    long long size2 = message2->getSize();
+
+    {
+        PriorityMessageDispatchChannel channel;
+        channel.start();
+
+        channel.enqueue( dispatch1 );
+        CPPUNIT_ASSERT_EQUAL( size1, channel.getBufferedBytes() );
+
+        // Bytes already buffered move over to the usage when it is attached.
+        channel.setMemoryUsage( usage );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size1, usage->getUsage() );
+
+        channel.enqueueFirst( dispatch2 );
+        channel.enqueue( dispatch3 );
+        CPPUNIT_ASSERT_EQUAL( size1 + size2, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) ( size1 + size2 ), usage->getUsage() );
+
+        CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+        CPPUNIT_ASSERT_EQUAL( size1, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size1, usage->getUsage() );
+
+        std::vector< Pointer<MessageDispatch> > drained;
+        CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 2 );
+        CPPUNIT_ASSERT_EQUAL( 0LL, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        channel.enqueue( dispatch1 );
+        channel.enqueue( dispatch2 );
+        CPPUNIT_ASSERT( channel.removeAll().size() == 2 );
+        CPPUNIT_ASSERT_EQUAL( 0LL, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        channel.enqueue( dispatch1 );
+        channel.clear();
+        CPPUNIT_ASSERT( channel.isEmpty() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        // Whatever is left when the channel goes away is returned to the usage.
+        channel.enqueue( dispatch2 );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size2, usage->getUsage() );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch( int priority ) {
+        Pointer<Message> message( new Message() );
+        message->setPriority( (unsigned char) priority );
+        Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+        dispatch->setMessage( message );
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testStrictPriority() {
+
+    PriorityMessageDispatchChannel channel;
+    CPPUNIT_ASSERT( channel.isWeightedFair() == false );
+    channel.start();
+
+    const int priorities[] = { 3, 9, 0, 7, 3, 5, 9, 1, 4, 8, 2, 6 };
+    const int count = sizeof( priorities ) / sizeof( priorities[0] );
+
+    for( int i = 0; i < count; ++i ) {
+        channel.enqueue( createDispatch( priorities[i] ) );
+    }
+
+    CPPUNIT_ASSERT( channel.size() == count );
+
+    int last = 9;
+    for( int i = 0; i < count; ++i ) {
+        Pointer<MessageDispatch> dispatch = channel.peek();
+        CPPUNIT_ASSERT( dispatch == channel.dequeueNoWait() );
+        int priority = dispatch->getMessage()->getPriority();
+        CPPUNIT_ASSERT( priority <= last );
+        last = priority;
+    }
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.peek() == NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityMessageDispatchChannelTest::testWeightedFair() {
+
+    PriorityMessageDispatchChannel channel( true );
+    CPPUNIT_ASSERT( channel.isWeightedFair() == true );
+    channel.start();
+
+    for( int i = 0; i < 25; ++i ) {
+        channel.enqueue( createDispatch( 9 ) );
+    }
+    for( int i = 0; i < 3; ++i ) {
+        channel.enqueue( createDispatch( 0 ) );
+    }
+
+    // Each round priority 9 may dispatch ten Messages and priority 0 one.
+    std::string order;
+    for( int i = 0; i < 28; ++i ) {
+        Pointer<MessageDispatch> dispatch = channel.peek();
+        CPPUNIT_ASSERT( dispatch == channel.dequeueNoWait() );
+        order += dispatch->getMessage()->getPriority() == 9 ? "H" : "L";
+    }
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "HHHHHHHHHHL" "HHHHHHHHHHL" "HHHHHL" ), order );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+
+    // A level that is alone gets every dispatch.
+    for( int i = 0; i < 5; ++i ) {
+        channel.enqueue( createDispatch( 0 ) );
+    }
+
+    std::vector< Pointer<MessageDispatch> > drained;
+    CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 5 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
@@ -19,12 +19,14 @@
 
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/util/MemoryUsage.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/System.h>
 
 using namespace activemq;
 using namespace activemq::core;
 using namespace activemq::commands;
+using namespace activemq::util;
 using namespace decaf;
 using namespace decaf::lang;
 
@@ -284,3 +286,112 @@ void SimplePriorityMessageDispatchChannelTest::testRemoveAll() {
     CPPUNIT_ASSERT( channel.size() == 0 );
     CPPUNIT_ASSERT( channel.isEmpty() == true );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testDrainTo() {
+
+    SimplePriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    std::vector< Pointer<MessageDispatch> > drained;
+
+    CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 0 );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.drainTo( drained, 2 ) == 2 );
+    CPPUNIT_ASSERT( drained[0] == dispatch2 );
+    CPPUNIT_ASSERT( drained[1] == dispatch1 );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 1 );
+    CPPUNIT_ASSERT( drained.size() == 3 );
+    CPPUNIT_ASSERT( drained[2] == dispatch3 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testBufferedBytes() {
+
+    Pointer<MemoryUsage> usage( new MemoryUsage( 1024 * 1024 ) );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+
+    message1->setContent( std::vector<unsigned char>( 100 ) );
+    message2->setContent( std::vector<unsigned char>( 2000 ) );
+
+    message1->setPriority( 4 );
+    message2->setPriority( 4 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+
+    long long size1 = message1->getSize();
+    long long size2 = message2->getSize();
+
+    {
+        SimplePriorityMessageDispatchChannel channel;
+        channel.start();
+
+        channel.enqueue( dispatch1 );
+        CPPUNIT_ASSERT_EQUAL( size1, channel.getBufferedBytes() );
+
+        // Bytes already buffered move over to the usage when it is attached.
+        channel.setMemoryUsage( usage );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size1, usage->getUsage() );
+
+        channel.enqueueFirst( dispatch2 );
+        channel.enqueue( dispatch3 );
+        CPPUNIT_ASSERT_EQUAL( size1 + size2, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) ( size1 + size2 ), usage->getUsage() );
+
+        CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+        CPPUNIT_ASSERT_EQUAL( size1, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size1, usage->getUsage() );
+
+        std::vector< Pointer<MessageDispatch> > drained;
+        CPPUNIT_ASSERT( channel.drainTo( drained, 10 ) == 2 );
+        CPPUNIT_ASSERT_EQUAL( 0LL, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        channel.enqueue( dispatch1 );
+        channel.enqueue( dispatch2 );
+        CPPUNIT_ASSERT( channel.removeAll().size() == 2 );
+        CPPUNIT_ASSERT_EQUAL( 0LL, channel.getBufferedBytes() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        channel.enqueue( dispatch1 );
+        channel.clear();
+        CPPUNIT_ASSERT( channel.isEmpty() );
+        CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+
+        // Whatever is left when the channel goes away is returned to the usage.
+        channel.enqueue( dispatch2 );
+        CPPUNIT_ASSERT_EQUAL( (unsigned long long) size2, usage->getUsage() );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 0ULL, usage->getUsage() );
+}
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AdaptivePrefetchPolicyTest.h"
+
+#include <activemq/core/policies/AdaptivePrefetchPolicy.h>
+#include <activemq/core/policies/DefaultPrefetchPolicy.h>
+
+#include <decaf/util/Properties.h>
+
+#include <memory>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::core::policies;
+using namespace decaf;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchPolicyTest::AdaptivePrefetchPolicyTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AdaptivePrefetchPolicyTest::~AdaptivePrefetchPolicyTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testDefaults() {
+
+    AdaptivePrefetchPolicy policy;
+
+    CPPUNIT_ASSERT(policy.isAdaptive());
+    CPPUNIT_ASSERT_EQUAL(AdaptivePrefetchPolicy::DEFAULT_MINIMUM_PREFETCH, policy.getMinimumPrefetch());
+    CPPUNIT_ASSERT_EQUAL(AdaptivePrefetchPolicy::DEFAULT_ADJUSTMENT_INTERVAL, policy.getAdjustmentInterval());
+    CPPUNIT_ASSERT_EQUAL(AdaptivePrefetchPolicy::DEFAULT_ADJUSTMENT_INTERVAL, policy.getPrefetchAdjustmentInterval());
+    CPPUNIT_ASSERT_EQUAL(AdaptivePrefetchPolicy::DEFAULT_TARGET_BACKLOG_TIME, policy.getTargetBacklogTime());
+    CPPUNIT_ASSERT_EQUAL(DefaultPrefetchPolicy::DEFAULT_QUEUE_PREFETCH, policy.getQueuePrefetch());
+
+    DefaultPrefetchPolicy fixed;
+    CPPUNIT_ASSERT(!fixed.isAdaptive());
+    CPPUNIT_ASSERT_EQUAL(100, fixed.adjustPrefetch(100, 1000, 0, 5000, 1000));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testClone() {
+
+    AdaptivePrefetchPolicy policy;
+
+    policy.setQueuePrefetch(250);
+    policy.setMinimumPrefetch(5);
+    policy.setAdjustmentInterval(250);
+    policy.setTargetBacklogTime(2000);
+
+    std::auto_ptr<PrefetchPolicy> copy(policy.clone());
+    AdaptivePrefetchPolicy* adaptive = dynamic_cast<AdaptivePrefetchPolicy*>(copy.get());
+
+    CPPUNIT_ASSERT(adaptive != NULL);
+    CPPUNIT_ASSERT_EQUAL(250, adaptive->getQueuePrefetch());
+    CPPUNIT_ASSERT_EQUAL(5, adaptive->getMinimumPrefetch());
+    CPPUNIT_ASSERT_EQUAL(250LL, adaptive->getAdjustmentInterval());
+    CPPUNIT_ASSERT_EQUAL(2000LL, adaptive->getTargetBacklogTime());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testConfigure() {
+
+    AdaptivePrefetchPolicy policy;
+    Properties properties;
+
+    properties.setProperty("cms.prefetchPolicy.queuePrefetch", "500");
+    properties.setProperty("cms.prefetchPolicy.minimumPrefetch", "10");
+    properties.setProperty("cms.prefetchPolicy.adjustmentInterval", "100");
+    properties.setProperty("cms.prefetchPolicy.targetBacklogTime", "3000");
+
+    policy.configure(properties);
+
+    CPPUNIT_ASSERT_EQUAL(500, policy.getQueuePrefetch());
+    CPPUNIT_ASSERT_EQUAL(10, policy.getMinimumPrefetch());
+    CPPUNIT_ASSERT_EQUAL(100LL, policy.getAdjustmentInterval());
+    CPPUNIT_ASSERT_EQUAL(3000LL, policy.getTargetBacklogTime());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testShrinkWhenBacklogged() {
+
+    AdaptivePrefetchPolicy policy;
+
+    // 50 messages a second with a one second target is a window of 50, but the
+    // window only halves per adjustment.
+    CPPUNIT_ASSERT_EQUAL(500, policy.adjustPrefetch(1000, 1000, 900, 50, 1000));
+    CPPUNIT_ASSERT_EQUAL(250, policy.adjustPrefetch(500, 1000, 400, 50, 1000));
+    CPPUNIT_ASSERT_EQUAL(60, policy.adjustPrefetch(100, 1000, 90, 60, 1000));
+
+    // Nothing consumed at all drops to the minimum over successive adjustments.
+    int prefetch = 1000;
+    for (int i = 0; i < 20; ++i) {
+        prefetch = policy.adjustPrefetch(prefetch, 1000, prefetch, 0, 1000);
+    }
+    CPPUNIT_ASSERT_EQUAL(1, prefetch);
+
+    // Keeping up with the target leaves the window alone.
+    CPPUNIT_ASSERT_EQUAL(100, policy.adjustPrefetch(100, 1000, 10, 200, 1000));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testGrowWhenDrained() {
+
+    AdaptivePrefetchPolicy policy;
+
+    CPPUNIT_ASSERT_EQUAL(20, policy.adjustPrefetch(10, 1000, 0, 10, 1000));
+    CPPUNIT_ASSERT_EQUAL(400, policy.adjustPrefetch(10, 1000, 0, 400, 1000));
+    CPPUNIT_ASSERT_EQUAL(1000, policy.adjustPrefetch(800, 1000, 0, 800, 1000));
+
+    // An idle consumer with nothing to do keeps its window.
+    CPPUNIT_ASSERT_EQUAL(10, policy.adjustPrefetch(10, 1000, 0, 0, 1000));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AdaptivePrefetchPolicyTest::testLimits() {
+
+    AdaptivePrefetchPolicy policy;
+    policy.setMinimumPrefetch(25);
+
+    CPPUNIT_ASSERT_EQUAL(25, policy.adjustPrefetch(30, 1000, 30, 0, 1000));
+    CPPUNIT_ASSERT_EQUAL(10, policy.adjustPrefetch(10, 10, 10, 0, 1000));
+    CPPUNIT_ASSERT_EQUAL(100, policy.adjustPrefetch(100, 1000, 100, 0, 0));
+
+    policy.setMinimumPrefetch(0);
+    CPPUNIT_ASSERT_EQUAL(1, policy.getMinimumPrefetch());
+}
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HistogramTest.h"
+
+#include <activemq/metrics/Histogram.h>
+#include <decaf/lang/Long.h>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testEmpty() {
+
+    Histogram histogram;
+
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMax());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.getMean());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getValueAtPercentile(50.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testBucketBoundaries() {
+
+    long long values[] = { 0, 1, 15, 16, 31, 32, 33, 100, 1000, 65535, 65536,
+                           1000000, 1000000000LL, Long::MAX_VALUE };
+
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(long long); ++i) {
+        int index = Histogram::getBucketIndex(values[i]);
+        CPPUNIT_ASSERT(index >= 0 && index < Histogram::BUCKETS);
+
+        long long highest = Histogram::getHighestValueInBucket(index);
+        CPPUNIT_ASSERT(highest >= values[i]);
+        CPPUNIT_ASSERT_EQUAL(index, Histogram::getBucketIndex(highest));
+
+        // Bucket width never exceeds one sixteenth of the value.
+        CPPUNIT_ASSERT(highest - values[i] <= values[i] / 16);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(Histogram::BUCKETS - 1, Histogram::getBucketIndex(Long::MAX_VALUE));
+    CPPUNIT_ASSERT_EQUAL(0, Histogram::getBucketIndex(-5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testSmallValuesAreExact() {
+
+    for (long long value = 0; value < 32; ++value) {
+        Histogram histogram;
+        histogram.record(value);
+        CPPUNIT_ASSERT_EQUAL(value, histogram.getValueAtPercentile(50.0));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testPercentiles() {
+
+    Histogram histogram;
+
+    for (long long value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(10000LL, histogram.getCount());
+
+    long long p50 = histogram.getValueAtPercentile(50.0);
+    long long p90 = histogram.getValueAtPercentile(90.0);
+    long long p99 = histogram.getValueAtPercentile(99.0);
+
+    CPPUNIT_ASSERT(p50 >= 5000 && p50 <= 5000 + 5000 / 16);
+    CPPUNIT_ASSERT(p90 >= 9000 && p90 <= 9000 + 9000 / 16);
+    CPPUNIT_ASSERT(p99 >= 9900 && p99 <= 10000);
+    CPPUNIT_ASSERT_EQUAL(10000LL, histogram.getValueAtPercentile(100.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testMinMaxMean() {
+
+    Histogram histogram;
+
+    histogram.record(10);
+    histogram.record(20);
+    histogram.record(30);
+    histogram.record(-1);
+
+    CPPUNIT_ASSERT_EQUAL(4LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(30LL, histogram.getMax());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(15.0, histogram.getMean(), 0.001);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testSnapshot() {
+
+    Histogram histogram;
+
+    for (long long value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+
+    HistogramSnapshot snapshot = histogram.getSnapshot();
+
+    CPPUNIT_ASSERT_EQUAL(1000LL, snapshot.getCount());
+    CPPUNIT_ASSERT_EQUAL(1LL, snapshot.getMin());
+    CPPUNIT_ASSERT_EQUAL(1000LL, snapshot.getMax());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(500.5, snapshot.getMean(), 0.001);
+    CPPUNIT_ASSERT_EQUAL(histogram.getValueAtPercentile(50.0), snapshot.get50thPercentile());
+    CPPUNIT_ASSERT_EQUAL(histogram.getValueAtPercentile(99.0), snapshot.get99thPercentile());
+    CPPUNIT_ASSERT(snapshot.get50thPercentile() <= snapshot.get90thPercentile());
+    CPPUNIT_ASSERT(snapshot.get90thPercentile() <= snapshot.get99thPercentile());
+    CPPUNIT_ASSERT(snapshot.get99thPercentile() <= snapshot.get999thPercentile());
+    CPPUNIT_ASSERT(snapshot.get999thPercentile() <= snapshot.getMax());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HistogramTest::testReset() {
+
+    Histogram histogram;
+
+    histogram.record(42);
+    histogram.record(4200);
+    histogram.reset();
+
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMax());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getValueAtPercentile(99.0));
+
+    histogram.record(7);
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getMax());
+}
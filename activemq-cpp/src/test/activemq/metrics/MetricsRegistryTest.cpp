@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetricsRegistryTest.h"
+
+#include <activemq/metrics/MetricsRegistry.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Runnable.h>
+
+#include <string>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CountingRunnable : public Runnable {
+    private:
+
+        Counter* counter;
+        Histogram* histogram;
+        int iterations;
+
+    private:
+
+        CountingRunnable(const CountingRunnable&);
+        CountingRunnable& operator=(const CountingRunnable&);
+
+    public:
+
+        CountingRunnable(Counter* counter, Histogram* histogram, int iterations) :
+            Runnable(), counter(counter), histogram(histogram), iterations(iterations) {
+        }
+
+        virtual ~CountingRunnable() {}
+
+        virtual void run() {
+            for (int i = 0; i < iterations; ++i) {
+                counter->increment();
+                histogram->record(i);
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testCounter() {
+
+    Counter counter;
+
+    CPPUNIT_ASSERT_EQUAL(0LL, counter.getCount());
+    counter.increment();
+    counter.add(41);
+    CPPUNIT_ASSERT_EQUAL(42LL, counter.getCount());
+    counter.add(-2);
+    CPPUNIT_ASSERT_EQUAL(40LL, counter.getCount());
+    counter.reset();
+    CPPUNIT_ASSERT_EQUAL(0LL, counter.getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testCounterConcurrentIncrements() {
+
+    static const int NUM_THREADS = 8;
+    static const int ITERATIONS = 10000;
+
+    Counter counter;
+    Histogram histogram;
+
+    CountingRunnable runnable(&counter, &histogram, ITERATIONS);
+    Thread* threads[NUM_THREADS];
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i] = new Thread(&runnable);
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL((long long) NUM_THREADS * ITERATIONS, counter.getCount());
+    CPPUNIT_ASSERT_EQUAL((long long) NUM_THREADS * ITERATIONS, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL((long long) ITERATIONS - 1, histogram.getMax());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testGauge() {
+
+    Gauge gauge;
+
+    CPPUNIT_ASSERT_EQUAL(0LL, gauge.get());
+    gauge.set(10);
+    CPPUNIT_ASSERT_EQUAL(10LL, gauge.get());
+    gauge.add(-3);
+    CPPUNIT_ASSERT_EQUAL(7LL, gauge.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testGetReturnsSameMetric() {
+
+    MetricsRegistry registry;
+
+    Counter* counter = registry.getCounter("test.counter");
+    CPPUNIT_ASSERT(counter != NULL);
+    CPPUNIT_ASSERT(counter == registry.getCounter("test.counter"));
+    CPPUNIT_ASSERT(counter != registry.getCounter("test.other"));
+
+    Gauge* gauge = registry.getGauge("test.gauge");
+    CPPUNIT_ASSERT(gauge != NULL);
+    CPPUNIT_ASSERT(gauge == registry.getGauge("test.gauge"));
+
+    Histogram* histogram = registry.getHistogram("test.histogram");
+    CPPUNIT_ASSERT(histogram != NULL);
+    CPPUNIT_ASSERT(histogram == registry.getHistogram("test.histogram"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testSnapshot() {
+
+    MetricsRegistry registry;
+
+    registry.getCounter("messages.sent")->add(5);
+    registry.getGauge("sessions")->set(2);
+    registry.getHistogram("request.time")->record(100);
+    registry.getHistogram("request.time")->record(300);
+
+    MetricsSnapshot snapshot = registry.getSnapshot();
+
+    CPPUNIT_ASSERT(snapshot.getTimestamp() > 0);
+    CPPUNIT_ASSERT(snapshot.hasCounter("messages.sent"));
+    CPPUNIT_ASSERT_EQUAL(5LL, snapshot.getCounter("messages.sent"));
+    CPPUNIT_ASSERT_EQUAL(2LL, snapshot.getGauge("sessions"));
+    CPPUNIT_ASSERT_EQUAL(2LL, snapshot.getHistogram("request.time").getCount());
+    CPPUNIT_ASSERT_EQUAL(300LL, snapshot.getHistogram("request.time").getMax());
+
+    CPPUNIT_ASSERT(!snapshot.hasCounter("missing"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getCounter("missing"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getGauge("missing"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getHistogram("missing").getCount());
+
+    CPPUNIT_ASSERT_EQUAL(1, (int) snapshot.getCounterNames().size());
+    CPPUNIT_ASSERT_EQUAL(1, (int) snapshot.getGaugeNames().size());
+    CPPUNIT_ASSERT_EQUAL(1, (int) snapshot.getHistogramNames().size());
+
+    // Later updates are not seen by an existing snapshot.
+    registry.getCounter("messages.sent")->increment();
+    CPPUNIT_ASSERT_EQUAL(5LL, snapshot.getCounter("messages.sent"));
+
+    std::string text = snapshot.toString();
+    CPPUNIT_ASSERT(text.find("messages.sent count=5") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("sessions value=2") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("request.time count=2") != std::string::npos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MetricsRegistryTest::testReset() {
+
+    MetricsRegistry registry;
+
+    Counter* counter = registry.getCounter("messages.sent");
+    counter->add(5);
+    registry.getGauge("sessions")->set(2);
+    registry.getHistogram("request.time")->record(100);
+
+    registry.reset();
+
+    CPPUNIT_ASSERT(counter == registry.getCounter("messages.sent"));
+
+    MetricsSnapshot snapshot = registry.getSnapshot();
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getCounter("messages.sent"));
+    CPPUNIT_ASSERT_EQUAL(0LL, snapshot.getHistogram("request.time").getCount());
+}
@@ -0,0 +1,289 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TracerTest.h"
+
+#include <activemq/metrics/TraceAnalyzer.h>
+#include <activemq/metrics/TraceBuffer.h>
+#include <activemq/metrics/Tracer.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+
+using namespace activemq;
+using namespace activemq::metrics;
+using namespace activemq::commands;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch(long long sequence) {
+
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId("ID:test-connection");
+        producerId->setSessionId(1);
+        producerId->setValue(1);
+
+        Pointer<MessageId> messageId(new MessageId());
+        messageId->setProducerId(producerId);
+        messageId->setProducerSequenceId(sequence);
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setMessageId(messageId);
+
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        dispatch->setCommandId((int) sequence);
+        dispatch->setMessage(message);
+
+        return dispatch;
+    }
+
+    class RecordingRunnable : public Runnable {
+    private:
+
+        int first;
+        int count;
+
+    public:
+
+        RecordingRunnable(int first, int count) : Runnable(), first(first), count(count) {
+        }
+
+        virtual ~RecordingRunnable() {}
+
+        virtual void run() {
+            for (int i = first; i < first + count; ++i) {
+                Pointer<MessageDispatch> dispatch = createDispatch(i);
+                Tracer::record(TraceEvent::UNMARSHAL_DONE, dispatch.get());
+                Tracer::record(TraceEvent::CONNECTION_DISPATCH, dispatch.get());
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::setUp() {
+    Tracer::clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::tearDown() {
+    Tracer::setEnabled(false);
+    Tracer::clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testDisabledRecordsNothing() {
+
+    Pointer<MessageDispatch> dispatch = createDispatch(1);
+
+    CPPUNIT_ASSERT(!Tracer::isEnabled());
+    Tracer::record(TraceEvent::UNMARSHAL_DONE, dispatch.get());
+
+    CPPUNIT_ASSERT(Tracer::getEvents().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testRecord() {
+
+    Pointer<MessageDispatch> dispatch = createDispatch(42);
+
+    Tracer::setEnabled(true);
+    Tracer::record(TraceEvent::UNMARSHAL_DONE, dispatch.get());
+    Tracer::record(TraceEvent::CONNECTION_DISPATCH, dispatch.get());
+    Tracer::setEnabled(false);
+    Tracer::record(TraceEvent::SESSION_DEQUEUE, dispatch.get());
+
+    std::vector<TraceEvent> events = Tracer::getEvents();
+    CPPUNIT_ASSERT_EQUAL(2, (int) events.size());
+
+    CPPUNIT_ASSERT_EQUAL((int) TraceEvent::UNMARSHAL_DONE, (int) events[0].stage);
+    CPPUNIT_ASSERT_EQUAL((int) TraceEvent::CONNECTION_DISPATCH, (int) events[1].stage);
+    CPPUNIT_ASSERT_EQUAL(42, events[0].commandId);
+    CPPUNIT_ASSERT_EQUAL((int) MessageDispatch::ID_MESSAGEDISPATCH, (int) events[0].type);
+    CPPUNIT_ASSERT_EQUAL(Tracer::getKey(dispatch.get()), events[0].key);
+    CPPUNIT_ASSERT_EQUAL(events[0].key, events[1].key);
+    CPPUNIT_ASSERT(events[0].timestamp <= events[1].timestamp);
+
+    Tracer::clear();
+    CPPUNIT_ASSERT(Tracer::getEvents().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testKeyMatchesAckAndDispatch() {
+
+    Pointer<MessageDispatch> dispatch = createDispatch(7);
+    Pointer<MessageAck> ack(new MessageAck(dispatch, 2, 1));
+    ack->setCommandId(99);
+
+    CPPUNIT_ASSERT_EQUAL(Tracer::getKey(dispatch.get()), Tracer::getKey(ack.get()));
+    CPPUNIT_ASSERT(Tracer::getKey(dispatch.get()) != Tracer::getKey(createDispatch(8).get()));
+    CPPUNIT_ASSERT_EQUAL(Tracer::getKey(dispatch->getMessage().get()), Tracer::getKey(dispatch.get()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testBufferOverwritesOldest() {
+
+    TraceBuffer buffer(6, 3);
+    CPPUNIT_ASSERT_EQUAL(8, buffer.getCapacity());
+
+    for (int i = 0; i < 20; ++i) {
+        buffer.record(i, i, i, 1, TraceEvent::UNMARSHAL_DONE);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(20LL, buffer.getRecordedCount());
+
+    std::vector<TraceEvent> events;
+    buffer.copyTo(events);
+
+    // The oldest slot may be in the middle of being rewritten so it is dropped.
+    CPPUNIT_ASSERT_EQUAL(7, (int) events.size());
+    for (int i = 0; i < 7; ++i) {
+        CPPUNIT_ASSERT_EQUAL(13 + i, events[i].commandId);
+        CPPUNIT_ASSERT_EQUAL(3, (int) events[i].thread);
+    }
+
+    buffer.clear();
+    events.clear();
+    buffer.copyTo(events);
+    CPPUNIT_ASSERT(events.empty());
+
+    buffer.record(20, 20, 20, 1, TraceEvent::ACK_SENT);
+    buffer.copyTo(events);
+    CPPUNIT_ASSERT_EQUAL(1, (int) events.size());
+    CPPUNIT_ASSERT_EQUAL(20, events[0].commandId);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testMultipleThreads() {
+
+    static const int NUM_THREADS = 4;
+    static const int COUNT = 500;
+
+    Tracer::setEnabled(true);
+
+    RecordingRunnable* runnables[NUM_THREADS];
+    Thread* threads[NUM_THREADS];
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        runnables[i] = new RecordingRunnable(i * COUNT, COUNT);
+        threads[i] = new Thread(runnables[i]);
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+        delete runnables[i];
+    }
+
+    std::vector<TraceEvent> events = Tracer::getEvents();
+    CPPUNIT_ASSERT_EQUAL(NUM_THREADS * COUNT * 2, (int) events.size());
+
+    for (std::size_t i = 1; i < events.size(); ++i) {
+        CPPUNIT_ASSERT(events[i - 1].timestamp <= events[i].timestamp);
+    }
+
+    TraceAnalyzer analyzer;
+    analyzer.analyze(events);
+    CPPUNIT_ASSERT_EQUAL(NUM_THREADS * COUNT, (int) analyzer.getMessages().size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testWriteAndReadEvents() {
+
+    std::vector<TraceEvent> events;
+    events.push_back(TraceEvent(100, 0x1234567890LL, 5, 21, TraceEvent::UNMARSHAL_DONE, 0));
+    events.push_back(TraceEvent(250, 0x1234567890LL, 5, 21, TraceEvent::LISTENER_END, 65535));
+
+    ByteArrayOutputStream output;
+    Tracer::writeEvents(events, &output);
+
+    std::pair<unsigned char*, int> bytes = output.toByteArray();
+    ByteArrayInputStream input(bytes.first, bytes.second, true);
+
+    std::vector<TraceEvent> result = Tracer::readEvents(&input);
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) result.size());
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(events[i].timestamp, result[i].timestamp);
+        CPPUNIT_ASSERT_EQUAL(events[i].key, result[i].key);
+        CPPUNIT_ASSERT_EQUAL(events[i].commandId, result[i].commandId);
+        CPPUNIT_ASSERT_EQUAL((int) events[i].type, (int) result[i].type);
+        CPPUNIT_ASSERT_EQUAL((int) events[i].stage, (int) result[i].stage);
+        CPPUNIT_ASSERT_EQUAL((int) events[i].thread, (int) result[i].thread);
+    }
+
+    ByteArrayInputStream garbage((const unsigned char*) "not a trace", 11);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        Tracer::readEvents(&garbage),
+        decaf::io::IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TracerTest::testAnalyzer() {
+
+    std::vector<TraceEvent> events;
+
+    // Two messages interleaved, the first seen again later as a redelivery.
+    events.push_back(TraceEvent(1000, 1, 1, 21, TraceEvent::UNMARSHAL_DONE, 0));
+    events.push_back(TraceEvent(1100, 2, 2, 21, TraceEvent::UNMARSHAL_DONE, 0));
+    events.push_back(TraceEvent(1200, 1, 1, 21, TraceEvent::CONNECTION_DISPATCH, 0));
+    events.push_back(TraceEvent(1500, 1, 1, 21, TraceEvent::SESSION_DEQUEUE, 1));
+    events.push_back(TraceEvent(1600, 1, 1, 21, TraceEvent::LISTENER_START, 1));
+    events.push_back(TraceEvent(2600, 1, 1, 21, TraceEvent::LISTENER_END, 1));
+    events.push_back(TraceEvent(2700, 1, 9, 22, TraceEvent::ACK_SENT, 1));
+    events.push_back(TraceEvent(1300, 2, 2, 21, TraceEvent::CONNECTION_DISPATCH, 0));
+    events.push_back(TraceEvent(5000, 1, 3, 21, TraceEvent::UNMARSHAL_DONE, 0));
+    events.push_back(TraceEvent(5100, 1, 3, 21, TraceEvent::CONNECTION_DISPATCH, 0));
+    events.push_back(TraceEvent(6000, 3, 4, 30, TraceEvent::UNMARSHAL_DONE, 0));
+
+    TraceAnalyzer analyzer;
+    analyzer.analyze(events);
+
+    const std::vector<TraceAnalyzer::MessageTrace>& messages = analyzer.getMessages();
+    CPPUNIT_ASSERT_EQUAL(3, (int) messages.size());
+
+    CPPUNIT_ASSERT_EQUAL(1LL, messages[0].key);
+    CPPUNIT_ASSERT_EQUAL(6, messages[0].getStageCount());
+    CPPUNIT_ASSERT_EQUAL(200LL, messages[0].getLatency(TraceEvent::UNMARSHAL_DONE, TraceEvent::CONNECTION_DISPATCH));
+    CPPUNIT_ASSERT_EQUAL(1000LL, messages[0].getLatency(TraceEvent::LISTENER_START, TraceEvent::LISTENER_END));
+    CPPUNIT_ASSERT_EQUAL(1700LL, messages[0].getTotalLatency());
+    CPPUNIT_ASSERT_EQUAL(-1LL, messages[1].getLatency(TraceEvent::SESSION_DEQUEUE, TraceEvent::LISTENER_START));
+
+    CPPUNIT_ASSERT_EQUAL(2LL, messages[1].key);
+    CPPUNIT_ASSERT_EQUAL(1LL, messages[2].key);
+    CPPUNIT_ASSERT_EQUAL(3, messages[2].commandId);
+
+    MetricsSnapshot summary = analyzer.getSummary();
+    CPPUNIT_ASSERT_EQUAL(3LL, summary.getHistogram("unmarshal->connection.dispatch").getCount());
+    CPPUNIT_ASSERT_EQUAL(1LL, summary.getHistogram("listener.start->listener.end").getCount());
+    CPPUNIT_ASSERT_EQUAL(1LL, summary.getHistogram("listener.end->ack.sent").getCount());
+    CPPUNIT_ASSERT_EQUAL(3LL, summary.getHistogram("total").getCount());
+    CPPUNIT_ASSERT(messages[0].toString().find("listener.end=1000") != std::string::npos);
+}
@@ -0,0 +1,368 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SelectorParserTest.h"
+
+#include <activemq/selector/SelectorParser.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <cms/InvalidSelectorException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+
+#include <memory>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::selector;
+using namespace activemq::commands;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<ActiveMQTextMessage> createMessage() {
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setIntProperty("count", 10);
+        message->setLongProperty("big", 3000000000LL);
+        message->setDoubleProperty("ratio", 2.5);
+        message->setFloatProperty("weight", 1.5f);
+        message->setStringProperty("color", "red");
+        message->setStringProperty("path", "orders/eu/new");
+        message->setBooleanProperty("urgent", true);
+        message->setBooleanProperty("archived", false);
+        message->setByteProperty("level", 3);
+
+        return message;
+    }
+
+    bool matches(const std::string& selector, const commands::Message* message) {
+        std::auto_ptr<MessageSelector> compiled(SelectorParser::compile(selector));
+        return compiled->matches(message);
+    }
+
+    bool matches(const std::string& selector) {
+        Pointer<ActiveMQTextMessage> message = createMessage();
+        return matches(selector, message.get());
+    }
+
+    bool isValid(const std::string& selector) {
+        try {
+            delete SelectorParser::compile(selector);
+        } catch (cms::InvalidSelectorException& ex) {
+            return false;
+        }
+        return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testEmptySelector() {
+
+    CPPUNIT_ASSERT(matches(""));
+    CPPUNIT_ASSERT(matches("   \t"));
+
+    std::auto_ptr<MessageSelector> selector(SelectorParser::compile("  "));
+    CPPUNIT_ASSERT_EQUAL(std::string("  "), selector->getText());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testComparisons() {
+
+    CPPUNIT_ASSERT(matches("count = 10"));
+    CPPUNIT_ASSERT(matches("count <> 11"));
+    CPPUNIT_ASSERT(matches("count > 9 AND count >= 10 AND count < 11 AND count <= 10"));
+    CPPUNIT_ASSERT(!matches("count > 10"));
+
+    // Integral and floating point values compare by value.
+    CPPUNIT_ASSERT(matches("count = 10.0"));
+    CPPUNIT_ASSERT(matches("ratio > count / 5"));
+    CPPUNIT_ASSERT(matches("weight = 1.5"));
+    CPPUNIT_ASSERT(matches("big > 2147483647"));
+    CPPUNIT_ASSERT(matches("level = 3"));
+
+    CPPUNIT_ASSERT(matches("color = 'red'"));
+    CPPUNIT_ASSERT(matches("color <> 'blue'"));
+    CPPUNIT_ASSERT(matches("color < 'violet'"));
+    CPPUNIT_ASSERT(!matches("color = 'RED'"));
+
+    CPPUNIT_ASSERT(matches("urgent = TRUE"));
+    CPPUNIT_ASSERT(matches("archived = false"));
+    CPPUNIT_ASSERT(matches("urgent"));
+    CPPUNIT_ASSERT(!matches("archived"));
+
+    // Values of different kinds are never equal.
+    CPPUNIT_ASSERT(!matches("color = 10"));
+    CPPUNIT_ASSERT(matches("color <> 10"));
+    CPPUNIT_ASSERT(!matches("count = '10'"));
+    CPPUNIT_ASSERT(!matches("urgent > FALSE"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testLogicalOperators() {
+
+    CPPUNIT_ASSERT(matches("count = 10 AND color = 'red'"));
+    CPPUNIT_ASSERT(!matches("count = 10 AND color = 'blue'"));
+    CPPUNIT_ASSERT(matches("count = 1 OR color = 'red'"));
+    CPPUNIT_ASSERT(!matches("count = 1 OR color = 'blue'"));
+    CPPUNIT_ASSERT(matches("NOT count = 1"));
+    CPPUNIT_ASSERT(matches("NOT (count = 1 OR color = 'blue')"));
+
+    // AND binds tighter than OR.
+    CPPUNIT_ASSERT(matches("count = 10 OR count = 1 AND color = 'blue'"));
+    CPPUNIT_ASSERT(!matches("(count = 10 OR count = 1) AND color = 'blue'"));
+
+    // A missing property is unknown, which NOT leaves unknown.
+    CPPUNIT_ASSERT(!matches("missing = 1"));
+    CPPUNIT_ASSERT(!matches("NOT missing = 1"));
+    CPPUNIT_ASSERT(!matches("missing <> 1"));
+    CPPUNIT_ASSERT(!matches("missing = 1 AND count = 10"));
+    CPPUNIT_ASSERT(matches("missing = 1 OR count = 10"));
+    CPPUNIT_ASSERT(!matches("NOT (missing = 1 AND count = 10)"));
+    CPPUNIT_ASSERT(matches("NOT (missing = 1 AND count = 1)"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testArithmetic() {
+
+    CPPUNIT_ASSERT(matches("count + 5 = 15"));
+    CPPUNIT_ASSERT(matches("count - 15 = -5"));
+    CPPUNIT_ASSERT(matches("count * 2 + 1 = 21"));
+    CPPUNIT_ASSERT(matches("count + 2 * 3 = 16"));
+    CPPUNIT_ASSERT(matches("(count + 2) * 3 = 36"));
+    CPPUNIT_ASSERT(matches("count / 4 = 2"));
+    CPPUNIT_ASSERT(matches("count / 4.0 = 2.5"));
+    CPPUNIT_ASSERT(matches("count % 3 = 1"));
+    CPPUNIT_ASSERT(matches("-count = -10"));
+    CPPUNIT_ASSERT(matches("ratio * 2 = 5"));
+
+    // Arithmetic on anything other than numbers, or dividing by zero, is unknown.
+    CPPUNIT_ASSERT(!matches("color + 1 = 1"));
+    CPPUNIT_ASSERT(!matches("NOT color + 1 = 1"));
+    CPPUNIT_ASSERT(!matches("count / 0 = 0"));
+    CPPUNIT_ASSERT(!matches("NOT count / 0 = 0"));
+    CPPUNIT_ASSERT(!matches("missing + 1 = 1"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testBetween() {
+
+    CPPUNIT_ASSERT(matches("count BETWEEN 5 AND 15"));
+    CPPUNIT_ASSERT(matches("count BETWEEN 10 AND 10"));
+    CPPUNIT_ASSERT(!matches("count BETWEEN 11 AND 15"));
+    CPPUNIT_ASSERT(matches("count NOT BETWEEN 11 AND 15"));
+    CPPUNIT_ASSERT(matches("ratio BETWEEN 2 AND 3"));
+    CPPUNIT_ASSERT(matches("count BETWEEN 5 AND 15 AND color = 'red'"));
+    CPPUNIT_ASSERT(matches("color BETWEEN 'p' AND 's'"));
+
+    CPPUNIT_ASSERT(!matches("missing BETWEEN 1 AND 2"));
+    CPPUNIT_ASSERT(!matches("missing NOT BETWEEN 1 AND 2"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testIn() {
+
+    CPPUNIT_ASSERT(matches("color IN ('red')"));
+    CPPUNIT_ASSERT(matches("color IN ('green', 'red', 'blue')"));
+    CPPUNIT_ASSERT(!matches("color IN ('green', 'blue')"));
+    CPPUNIT_ASSERT(matches("color NOT IN ('green', 'blue')"));
+
+    CPPUNIT_ASSERT(!matches("missing IN ('red')"));
+    CPPUNIT_ASSERT(!matches("missing NOT IN ('red')"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testLike() {
+
+    CPPUNIT_ASSERT(matches("color LIKE 'red'"));
+    CPPUNIT_ASSERT(matches("path LIKE 'orders/%'"));
+    CPPUNIT_ASSERT(matches("path LIKE '%/new'"));
+    CPPUNIT_ASSERT(matches("path LIKE '%/eu/%'"));
+    CPPUNIT_ASSERT(matches("path LIKE '%'"));
+    CPPUNIT_ASSERT(matches("path LIKE 'orders/__/new'"));
+    CPPUNIT_ASSERT(matches("path LIKE 'o%s/%/n_w'"));
+    CPPUNIT_ASSERT(matches("path LIKE '%%e%%e%'"));
+    CPPUNIT_ASSERT(!matches("path LIKE 'orders/_/new'"));
+    CPPUNIT_ASSERT(!matches("path LIKE 'orders'"));
+    CPPUNIT_ASSERT(!matches("path LIKE '%/us/%'"));
+    CPPUNIT_ASSERT(!matches("path LIKE 'o%s/%/x_w'"));
+    CPPUNIT_ASSERT(matches("path NOT LIKE '%/us/%'"));
+    CPPUNIT_ASSERT(matches("color LIKE 'r_d'"));
+    CPPUNIT_ASSERT(!matches("color LIKE 'r_'"));
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setStringProperty("name", "100%_done");
+    CPPUNIT_ASSERT(matches("name LIKE '100\\%\\_done' ESCAPE '\\'", message.get()));
+    CPPUNIT_ASSERT(matches("name LIKE '%!%%' ESCAPE '!'", message.get()));
+    CPPUNIT_ASSERT(!matches("name LIKE '100!%!_d' ESCAPE '!'", message.get()));
+    CPPUNIT_ASSERT(!matches("name LIKE '%!_x%' ESCAPE '!'", message.get()));
+
+    // Not a string is false, a missing value is unknown.
+    CPPUNIT_ASSERT(!matches("count LIKE '1%'"));
+    CPPUNIT_ASSERT(matches("count NOT LIKE '1%'"));
+    CPPUNIT_ASSERT(!matches("missing LIKE '%'"));
+    CPPUNIT_ASSERT(!matches("missing NOT LIKE '%'"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testIsNull() {
+
+    CPPUNIT_ASSERT(matches("missing IS NULL"));
+    CPPUNIT_ASSERT(!matches("missing IS NOT NULL"));
+    CPPUNIT_ASSERT(matches("color IS NOT NULL"));
+    CPPUNIT_ASSERT(!matches("color IS NULL"));
+    CPPUNIT_ASSERT(matches("NOT color IS NULL"));
+    CPPUNIT_ASSERT(matches("count / 0 IS NULL"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testHeaderFields() {
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setCMSType("order");
+    message->setCMSPriority(7);
+    message->setCMSCorrelationID("abc-1");
+    message->setPersistent(true);
+    message->setTimestamp(1000);
+    message->setGroupID("group");
+    message->setGroupSequence(4);
+    message->setRedeliveryCounter(2);
+
+    CPPUNIT_ASSERT(matches("JMSType = 'order'", message.get()));
+    CPPUNIT_ASSERT(matches("JMSPriority > 4", message.get()));
+    CPPUNIT_ASSERT(matches("JMSCorrelationID LIKE 'abc%'", message.get()));
+    CPPUNIT_ASSERT(matches("JMSDeliveryMode = 'PERSISTENT'", message.get()));
+    CPPUNIT_ASSERT(matches("JMSTimestamp = 1000", message.get()));
+    CPPUNIT_ASSERT(matches("JMSXGroupID = 'group' AND JMSXGroupSeq = 4", message.get()));
+    CPPUNIT_ASSERT(matches("JMSRedelivered", message.get()));
+    CPPUNIT_ASSERT(matches("JMSXDeliveryCount = 3", message.get()));
+    CPPUNIT_ASSERT(matches("JMSMessageID IS NULL", message.get()));
+
+    message->setPersistent(false);
+    message->setCMSType("");
+    CPPUNIT_ASSERT(matches("JMSDeliveryMode = 'NON_PERSISTENT'", message.get()));
+    CPPUNIT_ASSERT(matches("JMSType IS NULL", message.get()));
+
+    // The same header fields are read through the CMS interface.
+    const cms::Message* cmsMessage = message.get();
+    std::auto_ptr<MessageSelector> selector(SelectorParser::compile("JMSPriority = 7 AND JMSXGroupID = 'group'"));
+    CPPUNIT_ASSERT(selector->matches(cmsMessage));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testLiterals() {
+
+    CPPUNIT_ASSERT(matches("count = 0xA"));
+    CPPUNIT_ASSERT(matches("count = 012"));
+    CPPUNIT_ASSERT(matches("count = 10L"));
+    CPPUNIT_ASSERT(matches("count = 1e1"));
+    CPPUNIT_ASSERT(matches("ratio = 25E-1"));
+    CPPUNIT_ASSERT(matches("ratio = .25e1"));
+    CPPUNIT_ASSERT(matches("weight = 1.5f"));
+    CPPUNIT_ASSERT(matches("count > -9223372036854775808"));
+    CPPUNIT_ASSERT(matches("count < 9223372036854775807"));
+    CPPUNIT_ASSERT(matches("count = +10"));
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setStringProperty("quote", "it's");
+    message->setStringProperty("my-prop", "x");
+    CPPUNIT_ASSERT(matches("quote = 'it''s'", message.get()));
+    CPPUNIT_ASSERT(matches("\"my-prop\" = 'x'", message.get()));
+
+    // Keywords are not case sensitive, identifiers are.
+    CPPUNIT_ASSERT(matches("count between 5 and 15 or Count = 1"));
+    CPPUNIT_ASSERT(!matches("Count = 10"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testInvalidSelectors() {
+
+    CPPUNIT_ASSERT(isValid("a = 1"));
+
+    CPPUNIT_ASSERT(!isValid("a ="));
+    CPPUNIT_ASSERT(!isValid("= 1"));
+    CPPUNIT_ASSERT(!isValid("a = 1 b = 2"));
+    CPPUNIT_ASSERT(!isValid("(a = 1"));
+    CPPUNIT_ASSERT(!isValid("a = 1)"));
+    CPPUNIT_ASSERT(!isValid("a = 'unterminated"));
+    CPPUNIT_ASSERT(!isValid("a = 1 AND"));
+    CPPUNIT_ASSERT(!isValid("a # 1"));
+    CPPUNIT_ASSERT(!isValid("a IN ()"));
+    CPPUNIT_ASSERT(!isValid("a IN (1, 2)"));
+    CPPUNIT_ASSERT(!isValid("a LIKE b"));
+    CPPUNIT_ASSERT(!isValid("a LIKE 'x' ESCAPE 'ab'"));
+    CPPUNIT_ASSERT(!isValid("a LIKE 'x!' ESCAPE '!'"));
+    CPPUNIT_ASSERT(!isValid("a BETWEEN 1"));
+    CPPUNIT_ASSERT(!isValid("a IS 1"));
+    CPPUNIT_ASSERT(!isValid("a NOT 1"));
+    CPPUNIT_ASSERT(!isValid("a = 9223372036854775808"));
+    CPPUNIT_ASSERT(!isValid("a = 99999999999999999999999"));
+    CPPUNIT_ASSERT(!isValid("a = 09"));
+    CPPUNIT_ASSERT(!isValid("a = 1x"));
+    CPPUNIT_ASSERT(!isValid("a = 1e"));
+
+    // Only boolean valued expressions can be a selector or an operand of the logic operators.
+    CPPUNIT_ASSERT(!isValid("1"));
+    CPPUNIT_ASSERT(!isValid("'text'"));
+    CPPUNIT_ASSERT(!isValid("a + 1"));
+    CPPUNIT_ASSERT(!isValid("a = 1 AND 2"));
+    CPPUNIT_ASSERT(!isValid("NOT a * 2"));
+    CPPUNIT_ASSERT(isValid("TRUE"));
+    CPPUNIT_ASSERT(isValid("a AND NOT b"));
+
+    CPPUNIT_ASSERT(!isValid("XPATH '//order'"));
+    CPPUNIT_ASSERT(!isValid("XQUERY '//order'"));
+    CPPUNIT_ASSERT(isValid("XPATH = 'x'"));
+
+    try {
+        SelectorParser::compile("a = 1 b = 2");
+        CPPUNIT_FAIL("Should have thrown an InvalidSelectorException");
+    } catch (cms::InvalidSelectorException& ex) {
+        CPPUNIT_ASSERT(ex.getMessage().find("position 6") != std::string::npos);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SelectorParserTest::testParseIsCached() {
+
+    Pointer<MessageSelector> first = SelectorParser::parse("color = 'red' AND count > 5");
+    Pointer<MessageSelector> second = SelectorParser::parse("color = 'red' AND count > 5");
+    Pointer<MessageSelector> other = SelectorParser::parse("color = 'blue'");
+
+    CPPUNIT_ASSERT(first == second);
+    CPPUNIT_ASSERT(first != other);
+
+    Pointer<ActiveMQTextMessage> message = createMessage();
+    const commands::Message* amqMessage = message.get();
+    CPPUNIT_ASSERT(first->matches(amqMessage));
+    CPPUNIT_ASSERT(!other->matches(amqMessage));
+
+    // Fill the cache past its size, the evicted selector is compiled again.
+    for (int i = 0; i < SelectorParser::CACHE_SIZE; ++i) {
+        SelectorParser::parse("count = " + decaf::lang::Integer::toString(i));
+    }
+
+    Pointer<MessageSelector> third = SelectorParser::parse("color = 'red' AND count > 5");
+    CPPUNIT_ASSERT(first != third);
+    CPPUNIT_ASSERT_EQUAL(first->getText(), third->getText());
+
+    try {
+        SelectorParser::parse("color =");
+        CPPUNIT_FAIL("Should have thrown an InvalidSelectorException");
+    } catch (cms::InvalidSelectorException& ex) {
+    }
+}
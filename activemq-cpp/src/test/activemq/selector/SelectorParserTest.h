@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_SELECTOR_SELECTORPARSERTEST_H_
+#define _ACTIVEMQ_SELECTOR_SELECTORPARSERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace selector {
+
+    class SelectorParserTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( SelectorParserTest );
+        CPPUNIT_TEST( testEmptySelector );
+        CPPUNIT_TEST( testComparisons );
+        CPPUNIT_TEST( testLogicalOperators );
+        CPPUNIT_TEST( testArithmetic );
+        CPPUNIT_TEST( testBetween );
+        CPPUNIT_TEST( testIn );
+        CPPUNIT_TEST( testLike );
+        CPPUNIT_TEST( testIsNull );
+        CPPUNIT_TEST( testHeaderFields );
+        CPPUNIT_TEST( testLiterals );
+        CPPUNIT_TEST( testInvalidSelectors );
+        CPPUNIT_TEST( testParseIsCached );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        SelectorParserTest() {}
+        virtual ~SelectorParserTest() {}
+
+        void testEmptySelector();
+        void testComparisons();
+        void testLogicalOperators();
+        void testArithmetic();
+        void testBetween();
+        void testIn();
+        void testLike();
+        void testIsNull();
+        void testHeaderFields();
+        void testLiterals();
+        void testInvalidSelectors();
+        void testParseIsCached();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_SELECTOR_SELECTORPARSERTEST_H_ */
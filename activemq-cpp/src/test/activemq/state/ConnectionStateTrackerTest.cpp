@@ -241,7 +241,57 @@ void ConnectionStateTrackerTest::testMessageCache() {
 
     tracker.restore(transport);
 
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three messages", 4, transport->messages.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three messages", 3, transport->messages.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testMessageCacheReplayOrder() {
+
+    Pointer<TrackingTransport> transport(new TrackingTransport);
+    ConnectionStateTracker tracker;
+    tracker.setTrackMessages(true);
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    Pointer<Message> sizer(new Message);
+    tracker.setMaxMessageCacheSize(sizer->getSize() * 20);
+
+    for (int i = 1; i <= 50; ++i) {
+        decaf::lang::Pointer<commands::MessageId> id(new commands::MessageId());
+        id->setProducerId(conn.producer->getProducerId());
+        id->setProducerSequenceId(i);
+        Pointer<Message> message(new Message);
+        message->setMessageId(id);
+
+        tracker.processMessage(message.get());
+        tracker.trackBack(message);
+
+        // A send retried after an IO error is tracked a second time.
+        if (i % 10 == 0) {
+            tracker.processMessage(message.get());
+            tracker.trackBack(message);
+        }
+    }
+
+    tracker.restore(transport);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should keep the newest twenty messages", 20, transport->messages.size());
+
+    long long expected = 31;
+    Pointer<Iterator<Pointer<Command> > > iter(transport->messages.iterator());
+    while (iter->hasNext()) {
+        Pointer<Message> message = iter->next().dynamicCast<Message>();
+        CPPUNIT_ASSERT_EQUAL(expected++, message->getMessageId()->getProducerSequenceId());
+    }
+
+    // The newest message is kept even when it alone is over the limit.
+    tracker.setMaxMessageCacheSize(sizer->getSize() - 1);
+    tracker.processMessage(sizer.get());
+
+    Pointer<TrackingTransport> newest(new TrackingTransport);
+    tracker.restore(newest);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should keep only the newest message", 1, newest->messages.size());
+    CPPUNIT_ASSERT(newest->messages.getFirst().dynamicCast<Message>()->getMessageId() == NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
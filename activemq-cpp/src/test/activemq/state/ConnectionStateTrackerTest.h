@@ -29,6 +29,7 @@ namespace state {
         CPPUNIT_TEST_SUITE( ConnectionStateTrackerTest );
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( testMessageCache );
+        CPPUNIT_TEST( testMessageCacheReplayOrder );
         CPPUNIT_TEST( testMessagePullCache );
         CPPUNIT_TEST_SUITE_END();
 
@@ -39,6 +40,7 @@ namespace state {
 
         void test();
         void testMessageCache();
+        void testMessageCacheReplayOrder();
         void testMessagePullCache();
 
     };
@@ -27,6 +27,7 @@
 #include <activemq/mock/MockBrokerService.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/util/UUID.h>
@@ -42,6 +43,7 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 
 ////////////////////////////////////////////////////////////////////////////////
 FailoverTransportTest::FailoverTransportTest() {
@@ -1037,3 +1039,82 @@ void FailoverTransportTest::testConnectsToPriorityAfterInitialBackupFails() {
     broker3->stop();
     broker3->waitUntilStopped();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class WireFormatInfoCountingListener : public PriorityBackupListener {
+    public:
+
+        AtomicInteger numWireFormatInfos;
+
+        WireFormatInfoCountingListener() : PriorityBackupListener(), numWireFormatInfos() {}
+
+        virtual ~WireFormatInfoCountingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            if (command->isWireFormatInfo()) {
+                numWireFormatInfos.incrementAndGet();
+            }
+        }
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testFailoverToNegotiatedBackup() {
+
+    Pointer<MockBrokerService> broker1(new MockBrokerService(61626));
+    Pointer<MockBrokerService> broker2(new MockBrokerService(61628));
+
+    broker1->start();
+    broker1->waitUntilStarted();
+
+    broker2->start();
+    broker2->waitUntilStarted();
+
+    std::string uri = "failover://(tcp://localhost:61626,"
+                                  "tcp://localhost:61628)?randomize=false&backup=true";
+
+    WireFormatInfoCountingListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+
+    CPPUNIT_ASSERT(failover != NULL);
+    CPPUNIT_ASSERT(failover->isBackup() == true);
+
+    transport->start();
+
+    int count = 0;
+    while (listener.numWireFormatInfos.get() == 0 && count++ < 50) {
+        Thread::sleep(100);
+    }
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+    CPPUNIT_ASSERT_EQUAL(1, listener.numWireFormatInfos.get());
+
+    // Give the backup time to connect and negotiate with the second broker.
+    Thread::sleep(2000);
+    listener.reset();
+
+    broker1->stop();
+    broker1->waitUntilStopped();
+
+    CPPUNIT_ASSERT_MESSAGE("Failed to get interrupted in time", listener.awaitInterruption());
+    CPPUNIT_ASSERT_MESSAGE("Failed to get reconnected in time", listener.awaitResumed());
+
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    // The broker's info went to the backup, the switch must still hand it on.
+    CPPUNIT_ASSERT_EQUAL(2, listener.numWireFormatInfos.get());
+
+    transport->close();
+
+    broker2->stop();
+    broker2->waitUntilStopped();
+}
@@ -59,6 +59,7 @@ namespace failover {
         CPPUNIT_TEST( testStartupMaxReconnectsHonorsConfiguration );
         CPPUNIT_TEST( testConnectedToPriorityOnFirstTryThenFailover );
         CPPUNIT_TEST( testConnectsToPriorityOnceStarted );
+        CPPUNIT_TEST( testFailoverToNegotiatedBackup );
         //CPPUNIT_TEST( testConnectsToPriorityAfterInitialBackupFails );
         CPPUNIT_TEST_SUITE_END();
 
@@ -87,6 +88,7 @@ namespace failover {
         void testConnectedToPriorityOnFirstTryThenFailover();
         void testConnectsToPriorityOnceStarted();
         void testConnectsToPriorityAfterInitialBackupFails();
+        void testFailoverToNegotiatedBackup();
 
     private:
 
@@ -0,0 +1,198 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DestinationCacheTest.h"
+
+#include <activemq/util/DestinationCache.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testLookup() {
+
+    DestinationCache cache;
+
+    Pointer<ActiveMQDestination> queue = cache.lookup(cms::Destination::QUEUE, "TEST.FOO");
+    Pointer<ActiveMQDestination> topic = cache.lookup(cms::Destination::TOPIC, "TEST.FOO");
+
+    CPPUNIT_ASSERT(queue != NULL);
+    CPPUNIT_ASSERT(topic != NULL);
+    CPPUNIT_ASSERT(queue->isQueue());
+    CPPUNIT_ASSERT(topic->isTopic());
+    CPPUNIT_ASSERT_EQUAL(std::string("TEST.FOO"), queue->getPhysicalName());
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+    // Same type and name gives back the very same instance.
+    CPPUNIT_ASSERT(queue.get() == cache.lookup(cms::Destination::QUEUE, "TEST.FOO").get());
+    CPPUNIT_ASSERT(topic.get() == cache.lookup(cms::Destination::TOPIC, "TEST.FOO").get());
+    CPPUNIT_ASSERT(queue.get() != topic.get());
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+    cache.clear();
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    Pointer<ActiveMQDestination> fresh = cache.lookup(cms::Destination::QUEUE, "TEST.FOO");
+    CPPUNIT_ASSERT(queue.get() != fresh.get());
+    CPPUNIT_ASSERT(queue->equals(*fresh));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testLookupWithOptions() {
+
+    DestinationCache cache;
+
+    Pointer<ActiveMQDestination> queue =
+        cache.lookup(cms::Destination::QUEUE, "TEST.FOO?consumer.prefetchSize=10");
+
+    CPPUNIT_ASSERT_EQUAL(std::string("TEST.FOO"), queue->getPhysicalName());
+    CPPUNIT_ASSERT_EQUAL(std::string("10"), std::string(queue->getOptions().getProperty("consumer.prefetchSize")));
+    CPPUNIT_ASSERT(queue.get() == cache.lookup(cms::Destination::QUEUE, "TEST.FOO?consumer.prefetchSize=10").get());
+
+    // A different option string is a different destination even with the same name.
+    Pointer<ActiveMQDestination> other = cache.lookup(cms::Destination::QUEUE, "TEST.FOO");
+    CPPUNIT_ASSERT(queue.get() != other.get());
+    CPPUNIT_ASSERT(other->getOptions().isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testLookupInvalidType() {
+
+    DestinationCache cache;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        cache.lookup(42, "TEST.FOO"),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testIntern() {
+
+    DestinationCache cache;
+
+    CPPUNIT_ASSERT(cache.intern(NULL) == NULL);
+
+    ActiveMQQueue queue("TEST.FOO");
+    ActiveMQTopic topic("TEST.FOO");
+
+    Pointer<ActiveMQDestination> interned = cache.intern(&queue);
+    CPPUNIT_ASSERT(interned.get() != &queue);
+    CPPUNIT_ASSERT(interned->equals(queue));
+    CPPUNIT_ASSERT(interned.get() == cache.intern(&queue).get());
+
+    ActiveMQQueue copy("TEST.FOO");
+    CPPUNIT_ASSERT(interned.get() == cache.intern(&copy).get());
+    CPPUNIT_ASSERT(interned.get() == cache.lookup(cms::Destination::QUEUE, "TEST.FOO").get());
+
+    Pointer<ActiveMQDestination> internedTopic = cache.intern(&topic);
+    CPPUNIT_ASSERT(internedTopic.get() != interned.get());
+    CPPUNIT_ASSERT(internedTopic->isTopic());
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testInternWithOptions() {
+
+    DestinationCache cache;
+
+    ActiveMQQueue queue("TEST.FOO?consumer.prefetchSize=10");
+
+    Pointer<ActiveMQDestination> first = cache.intern(&queue);
+    Pointer<ActiveMQDestination> second = cache.intern(&queue);
+
+    CPPUNIT_ASSERT(first.get() != second.get());
+    CPPUNIT_ASSERT(first->equals(queue));
+    CPPUNIT_ASSERT_EQUAL(std::string("10"), std::string(first->getOptions().getProperty("consumer.prefetchSize")));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testInternTemporary() {
+
+    DestinationCache cache;
+
+    ActiveMQTempQueue queue("ID:test-connection:1:1");
+
+    Pointer<ActiveMQDestination> first = cache.intern(&queue);
+    Pointer<ActiveMQDestination> second = cache.intern(&queue);
+
+    CPPUNIT_ASSERT(first.get() != second.get());
+    CPPUNIT_ASSERT(first->isTemporary());
+    CPPUNIT_ASSERT(first->equals(*second));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testCompositeDestinations() {
+
+    DestinationCache cache;
+
+    Pointer<ActiveMQDestination> composite = cache.lookup(cms::Destination::QUEUE, "A,B,topic://C");
+
+    CPPUNIT_ASSERT(composite->isComposite());
+
+    // Splitting was done up front, repeated calls see the same parsed destinations.
+    decaf::util::ArrayList< Pointer<ActiveMQDestination> > first = composite->getCompositeDestinations();
+    decaf::util::ArrayList< Pointer<ActiveMQDestination> > second = composite->getCompositeDestinations();
+
+    CPPUNIT_ASSERT_EQUAL(3, first.size());
+    CPPUNIT_ASSERT_EQUAL(3, second.size());
+    for (int i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT(first.get(i).get() == second.get(i).get());
+    }
+
+    CPPUNIT_ASSERT(first.get(0)->isQueue());
+    CPPUNIT_ASSERT(first.get(2)->isTopic());
+    CPPUNIT_ASSERT_EQUAL(std::string("C"), first.get(2)->getPhysicalName());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationCacheTest::testMaxSize() {
+
+    DestinationCache cache(4);
+
+    CPPUNIT_ASSERT_EQUAL(4, cache.getMaxSize());
+    CPPUNIT_ASSERT_EQUAL(DestinationCache::DEFAULT_MAX_SIZE, DestinationCache().getMaxSize());
+
+    Pointer<ActiveMQDestination> first = cache.lookup(cms::Destination::QUEUE, "TEST.0");
+
+    for (int i = 1; i < 4; ++i) {
+        cache.lookup(cms::Destination::QUEUE, std::string("TEST.") + Integer::toString(i));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(4, cache.size());
+    CPPUNIT_ASSERT(first.get() == cache.lookup(cms::Destination::QUEUE, "TEST.0").get());
+
+    // Going over the limit starts the cache over, instances already handed out stay valid.
+    cache.lookup(cms::Destination::QUEUE, "TEST.4");
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("TEST.0"), first->getPhysicalName());
+    CPPUNIT_ASSERT(first.get() != cache.lookup(cms::Destination::QUEUE, "TEST.0").get());
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+}
@@ -182,6 +182,49 @@ void MarshallingSupportTest::testModifiedUtf8ToAscii() {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void MarshallingSupportTest::testModifiedUtf8LongStrings() {
+
+    // The encoder and decoder copy ASCII in blocks of up to 32 bytes, place a
+    // character that needs two bytes at every position around those blocks.
+    for( int length = 1; length < 100; ++length ) {
+        for( int position = 0; position < length; position += 3 ) {
+
+            std::string input;
+            for( int i = 0; i < length; ++i ) {
+                input += (char)( 'a' + i % 26 );
+            }
+            input[position] = (char)( position % 2 == 0 ? 0x00 : 0xE9 );
+
+            std::string expect;
+            for( int i = 0; i < length; ++i ) {
+                unsigned char value = (unsigned char)input[i];
+                if( value > 0 && value < 0x80 ) {
+                    expect += (char)value;
+                } else {
+                    expect += (char)( 0xC0 | ( value >> 6 ) );
+                    expect += (char)( 0x80 | ( value & 0x3F ) );
+                }
+            }
+
+            std::string encoded = MarshallingSupport::asciiToModifiedUtf8( input );
+            CPPUNIT_ASSERT( encoded == expect );
+            CPPUNIT_ASSERT( MarshallingSupport::modifiedUtf8ToAscii( encoded ) == input );
+        }
+    }
+
+    std::string ascii( 1000, 'x' );
+    CPPUNIT_ASSERT( MarshallingSupport::asciiToModifiedUtf8( ascii ) == ascii );
+    CPPUNIT_ASSERT( MarshallingSupport::modifiedUtf8ToAscii( ascii ) == ascii );
+
+    // An invalid sequence after a long run of ASCII must still be caught.
+    std::string invalid = ascii + (char)0xC8 + (char)0xA9;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a UTFDataFormatException",
+        MarshallingSupport::modifiedUtf8ToAscii( invalid ),
+        UTFDataFormatException );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void MarshallingSupportTest::testWriteString() {
 
@@ -34,6 +34,7 @@ namespace util {
         CPPUNIT_TEST( testReadString32 );
         CPPUNIT_TEST( testAsciiToModifiedUtf8 );
         CPPUNIT_TEST( testModifiedUtf8ToAscii );
+        CPPUNIT_TEST( testModifiedUtf8LongStrings );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -48,6 +49,7 @@ namespace util {
         void testReadString32();
         void testAsciiToModifiedUtf8();
         void testModifiedUtf8ToAscii();
+        void testModifiedUtf8LongStrings();
 
     private:
 
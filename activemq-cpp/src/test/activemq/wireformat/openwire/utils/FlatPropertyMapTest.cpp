@@ -0,0 +1,404 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FlatPropertyMapTest.h"
+
+#include <activemq/util/PrimitiveList.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
+#include <activemq/wireformat/openwire/utils/FlatPropertyMap.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/NoSuchElementException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace decaf::io;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void populate(PrimitiveMap& map) {
+
+        std::vector<unsigned char> bytes;
+        bytes.push_back(65);
+        bytes.push_back(66);
+        bytes.push_back(67);
+
+        map.setString("stringKey", "The test string");
+        map.setBool("boolKey", true);
+        map.setByte("byteKey", 'A');
+        map.setChar("charKey", 'B');
+        map.setShort("shortKey", 2048);
+        map.setInt("intKey", 655369);
+        map.setLong("longKey", 0xFFFFFFFF00000000ULL);
+        map.setFloat("floatKey", 45.6545f);
+        map.setDouble("doubleKey", 654564.654654);
+        map.setByteArray("bytesKey", bytes);
+    }
+
+    std::vector<unsigned char> marshalMap(const PrimitiveMap& map) {
+        std::vector<unsigned char> buffer;
+        PrimitiveTypesMarshaller::marshal(&map, buffer);
+        return buffer;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testEmpty() {
+
+    FlatPropertyMap map;
+
+    CPPUNIT_ASSERT(map.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, map.size());
+    CPPUNIT_ASSERT(!map.containsKey("key"));
+
+    std::vector<unsigned char> buffer;
+    map.marshal(buffer);
+    CPPUNIT_ASSERT_EQUAL(4, (int) buffer.size());
+
+    PrimitiveMap empty;
+    map.parse(marshalMap(empty));
+    CPPUNIT_ASSERT(map.isEmpty());
+
+    map.parse(std::vector<unsigned char>());
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testParseMarshaledMap() {
+
+    PrimitiveMap source;
+    populate(source);
+
+    FlatPropertyMap map;
+    map.parse(marshalMap(source));
+
+    CPPUNIT_ASSERT_EQUAL(10, map.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("The test string"), map.getString("stringKey"));
+    CPPUNIT_ASSERT_EQUAL(true, map.getBool("boolKey"));
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 'A', map.getByte("byteKey"));
+    CPPUNIT_ASSERT_EQUAL('B', map.getChar("charKey"));
+    CPPUNIT_ASSERT_EQUAL((short) 2048, map.getShort("shortKey"));
+    CPPUNIT_ASSERT_EQUAL(655369, map.getInt("intKey"));
+    CPPUNIT_ASSERT_EQUAL((long long) 0xFFFFFFFF00000000ULL, map.getLong("longKey"));
+    CPPUNIT_ASSERT_EQUAL(45.6545f, map.getFloat("floatKey"));
+    CPPUNIT_ASSERT_EQUAL(654564.654654, map.getDouble("doubleKey"));
+    CPPUNIT_ASSERT(source.getByteArray("bytesKey") == map.getByteArray("bytesKey"));
+
+    CPPUNIT_ASSERT_EQUAL(PrimitiveValueNode::INTEGER_TYPE, map.getValueType("intKey"));
+    CPPUNIT_ASSERT_EQUAL(PrimitiveValueNode::STRING_TYPE, map.getValueType("stringKey"));
+
+    std::vector<std::string> keys = map.keySet();
+    CPPUNIT_ASSERT_EQUAL(10, (int) keys.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("boolKey"), keys[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("stringKey"), keys[9]);
+
+    PrimitiveMap result;
+    map.toPrimitiveMap(result);
+    CPPUNIT_ASSERT(source.equals(result));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testMarshalMatchesPrimitiveMap() {
+
+    PrimitiveMap source;
+    populate(source);
+
+    FlatPropertyMap map;
+    map.setString("stringKey", "The test string");
+    map.setBool("boolKey", true);
+    map.setByte("byteKey", 'A');
+    map.setChar("charKey", 'B');
+    map.setShort("shortKey", 2048);
+    map.setInt("intKey", 655369);
+    map.setLong("longKey", 0xFFFFFFFF00000000ULL);
+    map.setFloat("floatKey", 45.6545f);
+    map.setDouble("doubleKey", 654564.654654);
+    map.setByteArray("bytesKey", source.getByteArray("bytesKey"));
+
+    std::vector<unsigned char> buffer;
+    map.marshal(buffer);
+
+    PrimitiveMap result;
+    PrimitiveTypesMarshaller::unmarshal(&result, buffer);
+    CPPUNIT_ASSERT(source.equals(result));
+
+    FlatPropertyMap copy;
+    copy.fromPrimitiveMap(source);
+
+    std::vector<unsigned char> copied;
+    copy.marshal(copied);
+    CPPUNIT_ASSERT(buffer == copied);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testConversions() {
+
+    FlatPropertyMap map;
+    map.setByte("byte", 12);
+    map.setShort("short", 1234);
+    map.setInt("int", 123456);
+    map.setFloat("float", 1.5f);
+    map.setString("number", "42");
+    map.setString("boolean", "true");
+
+    CPPUNIT_ASSERT_EQUAL((short) 12, map.getShort("byte"));
+    CPPUNIT_ASSERT_EQUAL(1234, map.getInt("short"));
+    CPPUNIT_ASSERT_EQUAL(123456LL, map.getLong("int"));
+    CPPUNIT_ASSERT_EQUAL(1.5, map.getDouble("float"));
+    CPPUNIT_ASSERT_EQUAL(42, map.getInt("number"));
+    CPPUNIT_ASSERT_EQUAL(42LL, map.getLong("number"));
+    CPPUNIT_ASSERT_EQUAL(true, map.getBool("boolean"));
+    CPPUNIT_ASSERT_EQUAL(std::string("123456"), map.getString("int"));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        map.getShort("int"),
+        UnsupportedOperationException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        map.getBool("int"),
+        UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testMissingKey() {
+
+    FlatPropertyMap map;
+    map.setInt("int", 1);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        map.getInt("missing"),
+        decaf::util::NoSuchElementException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        map.getValueType("missing"),
+        decaf::util::NoSuchElementException);
+
+    CPPUNIT_ASSERT(!map.remove("missing"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testNestedValues() {
+
+    PrimitiveMap inner;
+    inner.setInt("int", 1);
+    inner.setString("string", "value");
+
+    PrimitiveList list;
+    list.add(1);
+    list.add(std::string("two"));
+    list.add(inner);
+
+    PrimitiveMap source;
+    source.put("map", inner);
+    source.put("list", list);
+    source.setInt("after", 7);
+
+    FlatPropertyMap map;
+    map.parse(marshalMap(source));
+
+    CPPUNIT_ASSERT_EQUAL(3, map.size());
+    CPPUNIT_ASSERT_EQUAL(7, map.getInt("after"));
+    CPPUNIT_ASSERT_EQUAL(PrimitiveValueNode::MAP_TYPE, map.getValueType("map"));
+    CPPUNIT_ASSERT_EQUAL(PrimitiveValueNode::LIST_TYPE, map.getValueType("list"));
+
+    PrimitiveValueNode value = map.getValue("map");
+    CPPUNIT_ASSERT(value.getMap().equals(inner));
+    CPPUNIT_ASSERT(map.getValue("list").getList().equals(list));
+
+    FlatPropertyMap copy;
+    copy.setValue("map", PrimitiveValueNode(inner));
+    copy.setValue("list", PrimitiveValueNode(list));
+    copy.setInt("after", 7);
+
+    PrimitiveMap result;
+    copy.toPrimitiveMap(result);
+    CPPUNIT_ASSERT(source.equals(result));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testReplaceAndRemove() {
+
+    FlatPropertyMap map;
+    map.setInt("b", 1);
+    map.setInt("a", 2);
+    map.setInt("c", 3);
+
+    map.setString("b", "replaced");
+    CPPUNIT_ASSERT_EQUAL(3, map.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("replaced"), map.getString("b"));
+
+    CPPUNIT_ASSERT(map.remove("a"));
+    CPPUNIT_ASSERT_EQUAL(2, map.size());
+    CPPUNIT_ASSERT(!map.containsKey("a"));
+    CPPUNIT_ASSERT_EQUAL(3, map.getInt("c"));
+
+    // Enough churn to force the arena to be compacted at least once.
+    for (int i = 0; i < 1000; ++i) {
+        map.setInt("c", i);
+        map.setLong("d", i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(3, map.size());
+    CPPUNIT_ASSERT_EQUAL(999, map.getInt("c"));
+    CPPUNIT_ASSERT_EQUAL(999LL, map.getLong("d"));
+    CPPUNIT_ASSERT_EQUAL(std::string("replaced"), map.getString("b"));
+
+    std::vector<unsigned char> buffer;
+    map.marshal(buffer);
+    CPPUNIT_ASSERT(buffer.size() < 64);
+
+    map.clear();
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testStringEncodings() {
+
+    std::string big(10000, 'x');
+
+    PrimitiveMap source;
+    source.setString("empty", "");
+    source.setString("big", big);
+
+    FlatPropertyMap map;
+    map.parse(marshalMap(source));
+
+    CPPUNIT_ASSERT_EQUAL(std::string(), map.getString("empty"));
+    CPPUNIT_ASSERT_EQUAL(PrimitiveValueNode::BIG_STRING_TYPE, map.getValueType("big"));
+    CPPUNIT_ASSERT(big == map.getString("big"));
+
+    FlatPropertyMap copy;
+    copy.setString("empty", "");
+    copy.setString("big", big);
+
+    std::vector<unsigned char> buffer;
+    copy.marshal(buffer);
+    CPPUNIT_ASSERT(buffer == marshalMap(source));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testNonAsciiKeys() {
+
+    std::string key("caf\xE9");
+
+    PrimitiveMap source;
+    source.setInt(key, 5);
+    source.setInt("plain", 6);
+
+    FlatPropertyMap map;
+    map.parse(marshalMap(source));
+
+    CPPUNIT_ASSERT(map.containsKey(key));
+    CPPUNIT_ASSERT_EQUAL(5, map.getInt(key));
+
+    std::vector<std::string> keys = map.keySet();
+    CPPUNIT_ASSERT_EQUAL(2, (int) keys.size());
+    CPPUNIT_ASSERT(keys[0] == key || keys[1] == key);
+
+    map.setInt(key, 8);
+    PrimitiveMap result;
+    map.toPrimitiveMap(result);
+    CPPUNIT_ASSERT_EQUAL(8, result.getInt(key));
+    CPPUNIT_ASSERT_EQUAL(6, result.getInt("plain"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testTruncatedInput() {
+
+    PrimitiveMap source;
+    populate(source);
+
+    std::vector<unsigned char> buffer = marshalMap(source);
+
+    FlatPropertyMap map;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(&buffer[0], (int) buffer.size() - 1),
+        IOException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(&buffer[0], 2),
+        IOException);
+
+    // Unknown type tag on the first entry.
+    buffer[4 + 2 + 7] = 99;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(buffer),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FlatPropertyMapTest::testTruncatedString() {
+
+    // One entry keyed "a" holding a STRING_TYPE value.
+    std::vector<unsigned char> buffer;
+    buffer.push_back(0);
+    buffer.push_back(0);
+    buffer.push_back(0);
+    buffer.push_back(1);
+    buffer.push_back(0);
+    buffer.push_back(1);
+    buffer.push_back('a');
+    buffer.push_back(PrimitiveValueNode::STRING_TYPE);
+
+    FlatPropertyMap map;
+
+    // Only one of the two length bytes is present.
+    std::vector<unsigned char> truncated(buffer);
+    truncated.push_back(0);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(truncated),
+        IOException);
+
+    // The length claims more bytes than remain.
+    truncated.push_back(3);
+    truncated.push_back('x');
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(truncated),
+        IOException);
+
+    // The two byte length is unsigned, 40000 must not read as negative.
+    std::vector<unsigned char> large(buffer);
+    large.push_back((unsigned char) (40000 >> 8));
+    large.push_back((unsigned char) (40000 & 0xFF));
+    large.insert(large.end(), 40000, 'z');
+    map.parse(large);
+    CPPUNIT_ASSERT_EQUAL(std::string(40000, 'z'), map.getString("a"));
+
+    large.pop_back();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        map.parse(large),
+        IOException);
+}
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPTEST_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq{
+namespace wireformat{
+namespace openwire{
+namespace utils{
+
+    class FlatPropertyMapTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( FlatPropertyMapTest );
+        CPPUNIT_TEST( testEmpty );
+        CPPUNIT_TEST( testParseMarshaledMap );
+        CPPUNIT_TEST( testMarshalMatchesPrimitiveMap );
+        CPPUNIT_TEST( testConversions );
+        CPPUNIT_TEST( testMissingKey );
+        CPPUNIT_TEST( testNestedValues );
+        CPPUNIT_TEST( testReplaceAndRemove );
+        CPPUNIT_TEST( testStringEncodings );
+        CPPUNIT_TEST( testNonAsciiKeys );
+        CPPUNIT_TEST( testTruncatedInput );
+        CPPUNIT_TEST( testTruncatedString );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        FlatPropertyMapTest() {}
+        virtual ~FlatPropertyMapTest() {}
+
+        void testEmpty();
+        void testParseMarshaledMap();
+        void testMarshalMatchesPrimitiveMap();
+        void testConversions();
+        void testMissingKey();
+        void testNestedValues();
+        void testReplaceAndRemove();
+        void testStringEncodings();
+        void testNonAsciiKeys();
+        void testTruncatedInput();
+        void testTruncatedString();
+
+    };
+
+}}}}
+
+#endif /*_ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_FLATPROPERTYMAPTEST_H_*/
@@ -0,0 +1,301 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameTest.h"
+
+#include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameParser.h>
+
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/FilterInputStream.h>
+#include <decaf/io/IOException.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> toBytes(const std::string& text) {
+        return std::vector<unsigned char>(text.begin(), text.end());
+    }
+
+    std::string bodyText(const StompFrame& frame) {
+        const std::vector<unsigned char>& body = frame.getBody();
+        return std::string(body.begin(), body.end());
+    }
+
+    // Parses the first count frames of the input through a buffer of the given size.
+    void parseFrames(const std::vector<unsigned char>& input, int bufferSize, int count, std::vector<StompFrame*>& frames) {
+
+        ByteArrayInputStream bytes(input);
+        BufferedInputStream buffered(&bytes, bufferSize);
+        DataInputStream in(&buffered);
+
+        StompFrameParser parser;
+        for (int ix = 0; ix < count; ++ix) {
+            frames.push_back(new StompFrame());
+            parser.parse(&in, *frames.back());
+        }
+    }
+
+    void checkConsecutiveFrames(const std::vector<StompFrame*>& frames) {
+
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 2, frames.size());
+
+        CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), frames[0]->getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("/queue/a"), frames[0]->getProperty("destination"));
+        CPPUNIT_ASSERT_EQUAL(std::string("b:c"), frames[0]->getProperty("key"));
+        CPPUNIT_ASSERT_EQUAL(std::string(""), frames[0]->getProperty("empty", "missing"));
+        CPPUNIT_ASSERT(!frames[0]->hasProperty("nocolon"));
+        CPPUNIT_ASSERT_EQUAL(3, frames[0]->getProperties().size());
+        CPPUNIT_ASSERT_EQUAL(std::string("hello", 6), bodyText(*frames[0]));
+
+        CPPUNIT_ASSERT_EQUAL(std::string("RECEIPT"), frames[1]->getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("7"), frames[1]->getProperty("receipt-id"));
+        CPPUNIT_ASSERT_EQUAL(std::string("", 1), bodyText(*frames[1]));
+    }
+
+    void deleteAll(std::vector<StompFrame*>& frames) {
+        for (std::size_t ix = 0; ix < frames.size(); ++ix) {
+            delete frames[ix];
+        }
+        frames.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameTest::StompFrameTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameTest::~StompFrameTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testRoundTrip() {
+
+    StompFrame frame;
+    frame.setCommand("SEND");
+    frame.setProperty("destination", "/topic/test");
+    frame.setProperty("content-length", "5");
+    frame.setProperty("persistent", "true");
+
+    unsigned char body[] = { 'a', '\0', 'b', '\n', 'c' };
+    frame.setBody(body, sizeof(body));
+
+    ByteArrayOutputStream bytes;
+    DataOutputStream out(&bytes);
+    frame.toStream(&out);
+
+    std::pair<unsigned char*, int> array = bytes.toByteArray();
+    std::vector<unsigned char> encoded(array.first, array.first + array.second);
+    delete [] array.first;
+
+    CPPUNIT_ASSERT_EQUAL((unsigned char) '\n', encoded[encoded.size() - 1]);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) '\0', encoded[encoded.size() - 2]);
+
+    ByteArrayInputStream source(encoded);
+    FilterInputStream filter(&source);
+    DataInputStream scanned(&source);
+    DataInputStream bytewise(&filter);
+
+    StompFrame first;
+    first.fromStream(&scanned);
+    source.reset();
+    StompFrame second;
+    second.fromStream(&bytewise);
+
+    const StompFrame* parsed[] = { &first, &second };
+    for (int ix = 0; ix < 2; ++ix) {
+        CPPUNIT_ASSERT_EQUAL(std::string("SEND"), parsed[ix]->getCommand());
+        CPPUNIT_ASSERT_EQUAL(3, parsed[ix]->getProperties().size());
+        CPPUNIT_ASSERT_EQUAL(std::string("/topic/test"), parsed[ix]->getProperty("destination"));
+        CPPUNIT_ASSERT_EQUAL(std::string("true"), parsed[ix]->getProperty("persistent"));
+        CPPUNIT_ASSERT(frame.getBody() == parsed[ix]->getBody());
+    }
+
+    // Only the trailing line feed is left behind.
+    CPPUNIT_ASSERT_EQUAL(1, source.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testParseConsecutiveFrames() {
+
+    std::string text("\n \r\n  MESSAGE\n"
+                     "destination:/queue/a\n"
+                     "key:b:c\n"
+                     "nocolon\n"
+                     "destination:/queue/ignored\n"
+                     "empty:\n"
+                     "\n"
+                     "hello", 91);
+    text.append(std::string("\0\nRECEIPT\nreceipt-id:7\n\n\0\n", 26));
+
+    std::vector<unsigned char> input = toBytes(text);
+    std::vector<StompFrame*> frames;
+
+    // Buffers smaller than a line make the scan refill part way through.
+    int sizes[] = { 1, 3, 7, 64, 1024 };
+    for (int ix = 0; ix < 5; ++ix) {
+        parseFrames(input, sizes[ix], 2, frames);
+        checkConsecutiveFrames(frames);
+        deleteAll(frames);
+    }
+
+    ByteArrayInputStream bytes(input);
+    FilterInputStream filter(&bytes);
+    DataInputStream in(&filter);
+
+    StompFrameParser parser;
+    for (int ix = 0; ix < 2; ++ix) {
+        frames.push_back(new StompFrame());
+        parser.parse(&in, *frames.back());
+    }
+
+    checkConsecutiveFrames(frames);
+    deleteAll(frames);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testParseContentLength() {
+
+    std::string text("MESSAGE\ncontent-length:4\n\n\0\0\0\0\0\nMESSAGE\ncontent-length:2\n\nabc\0\n", 63);
+    std::vector<unsigned char> input = toBytes(text);
+
+    ByteArrayInputStream bytes(input);
+    DataInputStream in(&bytes);
+    StompFrameParser parser;
+
+    StompFrame frame;
+    parser.parse(&in, frame);
+    CPPUNIT_ASSERT_EQUAL(std::string("\0\0\0\0", 4), bodyText(frame));
+
+    // The null that ends the frame must follow the content.
+    in.readByte();
+    StompFrame missing;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        parser.parse(&in, missing),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testParseTruncatedFrame() {
+
+    const char* truncated[] = { "MESS", "MESSAGE\ndestination:/queue/a", "MESSAGE\n\nbody" };
+
+    for (int ix = 0; ix < 3; ++ix) {
+
+        std::vector<unsigned char> input = toBytes(truncated[ix]);
+        ByteArrayInputStream bytes(input);
+        BufferedInputStream buffered(&bytes, 2);
+        DataInputStream in(&buffered);
+
+        StompFrameParser parser;
+        StompFrame frame;
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw an IOException",
+            parser.parse(&in, frame),
+            IOException);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testEscapedHeaders() {
+
+    StompFrame frame;
+    frame.setCommand("SEND");
+    frame.setProperty("destination", "/queue/a");
+    frame.setProperty("odd:key", "line\none\r\\two:three");
+
+    ByteArrayOutputStream bytes;
+    DataOutputStream out(&bytes);
+    frame.toStream(&out, true);
+
+    std::pair<unsigned char*, int> array = bytes.toByteArray();
+    std::string encoded((const char*) array.first, array.second);
+    std::vector<unsigned char> input(array.first, array.first + array.second);
+    delete [] array.first;
+
+    CPPUNIT_ASSERT(encoded.find("odd\\ckey:line\\none\\r\\\\two\\cthree\n") != std::string::npos);
+    CPPUNIT_ASSERT(encoded.find("destination:/queue/a\n") != std::string::npos);
+
+    ByteArrayInputStream source(input);
+    DataInputStream in(&source);
+
+    StompFrameParser parser;
+    parser.setDecodeHeaders(true);
+    StompFrame parsed;
+    parser.parse(&in, parsed);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("/queue/a"), parsed.getProperty("destination"));
+    CPPUNIT_ASSERT_EQUAL(std::string("line\none\r\\two:three"), parsed.getProperty("odd:key"));
+
+    // A CONNECTED Frame is never decoded and undefined escapes are kept as sent.
+    std::string text("CONNECTED\nsession:a\\cb\r\n\nMESSAGE\nkey:a\\tb\r\n\n", 44);
+    text.insert(25, 1, '\0');
+    text.push_back('\0');
+    input = toBytes(text);
+
+    ByteArrayInputStream source2(input);
+    DataInputStream in2(&source2);
+
+    StompFrame connected;
+    parser.parse(&in2, connected);
+    CPPUNIT_ASSERT_EQUAL(std::string("a\\cb\r"), connected.getProperty("session"));
+
+    StompFrame message;
+    parser.parse(&in2, message);
+    CPPUNIT_ASSERT_EQUAL(std::string("a\\tb"), message.getProperty("key"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testParseHeartBeats() {
+
+    std::string text("\n\r\nRECEIPT\nreceipt-id:1\n\n");
+    text.push_back('\0');
+    text.append("\r\n\n");
+    std::vector<unsigned char> input = toBytes(text);
+
+    ByteArrayInputStream source(input);
+    DataInputStream in(&source);
+
+    StompFrameParser parser;
+    StompFrame frame;
+
+    CPPUNIT_ASSERT(!parser.parseFrameOrHeartBeat(&in, frame));
+    CPPUNIT_ASSERT(!parser.parseFrameOrHeartBeat(&in, frame));
+    CPPUNIT_ASSERT(parser.parseFrameOrHeartBeat(&in, frame));
+    CPPUNIT_ASSERT_EQUAL(std::string("RECEIPT"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), frame.getProperty("receipt-id"));
+
+    // The Frame's own line end was consumed with it, leaving one heart-beat.
+    CPPUNIT_ASSERT(!parser.parseFrameOrHeartBeat(&in, frame));
+    CPPUNIT_ASSERT_EQUAL(0, source.available());
+}
@@ -56,4 +56,20 @@ void StompWireFormatFactoryTest::testCreateWireFormat() {
     CPPUNIT_ASSERT_EQUAL(std::string("/test-queue/"), stomp->getQueuePrefix());
     CPPUNIT_ASSERT_EQUAL(std::string("/test-temp-topic/"), stomp->getTempTopicPrefix());
     CPPUNIT_ASSERT_EQUAL(std::string("/test-temp-queue/"), stomp->getTempQueuePrefix());
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0"), stomp->getAcceptVersion());
+    CPPUNIT_ASSERT_EQUAL(0LL, stomp->getHeartBeatSendInterval());
+    CPPUNIT_ASSERT_EQUAL(0LL, stomp->getHeartBeatReceiveInterval());
+
+    properties.setProperty("wireFormat.acceptVersion", "1.0,1.1,1.2");
+    properties.setProperty("wireFormat.heartBeatSendInterval", "10000");
+    properties.setProperty("wireFormat.heartBeatReceiveInterval", "20000");
+
+    format = factory.createWireFormat(properties);
+    stomp = format.dynamicCast<StompWireFormat>();
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0,1.1,1.2"), stomp->getAcceptVersion());
+    CPPUNIT_ASSERT_EQUAL(10000LL, stomp->getHeartBeatSendInterval());
+    CPPUNIT_ASSERT_EQUAL(20000LL, stomp->getHeartBeatReceiveInterval());
+    CPPUNIT_ASSERT(stomp->hasNegotiator());
 }
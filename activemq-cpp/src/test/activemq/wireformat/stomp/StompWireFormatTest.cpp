@@ -17,13 +17,236 @@
 
 #include "StompWireFormatTest.h"
 
+#include <activemq/wireformat/stomp/StompCommandConstants.h>
 #include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/wireformat/stomp/StompFrameParser.h>
 #include <activemq/wireformat/stomp/StompHelper.h>
 #include <activemq/wireformat/stomp/StompWireFormat.h>
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/transport/tcp/TcpTransportFactory.h>
 
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/net/ServerSocket.h>
+#include <decaf/net/Socket.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <memory>
+
+using namespace std;
 using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string marshal(StompWireFormat& wireFormat, const Pointer<Command>& command) {
+
+        ByteArrayOutputStream bytes;
+        DataOutputStream out(&bytes);
+        wireFormat.marshal(command, NULL, &out);
+
+        std::pair<unsigned char*, int> array = bytes.toByteArray();
+        std::string result((const char*) array.first, array.second);
+        delete [] array.first;
+        return result;
+    }
+
+    Pointer<StompFrame> toFrame(const std::string& text) {
+
+        std::vector<unsigned char> bytes(text.begin(), text.end());
+        ByteArrayInputStream source(bytes);
+        DataInputStream in(&source);
+
+        Pointer<StompFrame> frame(new StompFrame());
+        StompFrameParser parser;
+        parser.parse(&in, *frame);
+        return frame;
+    }
+
+    Pointer<Command> unmarshal(StompWireFormat& wireFormat, const std::string& text) {
+
+        std::vector<unsigned char> bytes(text.begin(), text.end());
+        ByteArrayInputStream source(bytes);
+        DataInputStream in(&source);
+
+        IOTransport transport;
+        return wireFormat.unmarshal(&transport, &in);
+    }
+
+    // Sends a CONNECT and reads back the CONNECTED headers given, the terminating
+    // null is added here.
+    std::string connect(StompWireFormat& wireFormat, const std::string& connected) {
+
+        Pointer<ConnectionInfo> info(new ConnectionInfo());
+        info->setCommandId(1);
+        info->setClientId("client");
+        std::string frame = marshal(wireFormat, info);
+
+        Pointer<Command> response = unmarshal(wireFormat, connected + '\0');
+        CPPUNIT_ASSERT(response->isResponse());
+        CPPUNIT_ASSERT_EQUAL(1, response.dynamicCast<Response>()->getCorrelationId());
+
+        return frame;
+    }
+
+    Pointer<MessageAck> createAck(StompHelper& helper, unsigned char ackType) {
+
+        Pointer<ConsumerId> consumerId(new ConsumerId());
+        consumerId->setConnectionId("ID:test-host-1");
+        consumerId->setSessionId(2);
+        consumerId->setValue(3);
+
+        Pointer<MessageAck> ack(new MessageAck());
+        ack->setAckType(ackType);
+        ack->setConsumerId(consumerId);
+        ack->setLastMessageId(helper.convertMessageId("ID:test-host-1:2:3:4"));
+        return ack;
+    }
+
+    // Stands in for a STOMP 1.1 Broker, answering the CONNECT and then sending and
+    // counting heart-beats until it is told to go quiet.
+    class StompStandInServer : public Thread {
+    private:
+
+        StompStandInServer(const StompStandInServer&);
+        StompStandInServer& operator=(const StompStandInServer&);
+
+    public:
+
+        ServerSocket server;
+        std::string heartBeat;
+        long long sendInterval;
+
+        StompFrame connectFrame;
+        CountDownLatch connected;
+
+        AtomicBoolean sending;
+        AtomicInteger heartBeatsReceived;
+
+        StompStandInServer(const std::string& heartBeat, long long sendInterval) :
+            Thread(), server(0), heartBeat(heartBeat), sendInterval(sendInterval),
+            connectFrame(), connected(1), sending(true), heartBeatsReceived() {
+        }
+
+        virtual ~StompStandInServer() {
+            stop();
+        }
+
+        void stop() {
+            try {
+                server.close();
+            } catch (...) {}
+        }
+
+        virtual void run() {
+
+            try {
+
+                std::auto_ptr<Socket> socket(server.accept());
+                BufferedInputStream buffered(socket->getInputStream());
+                DataInputStream in(&buffered);
+                DataOutputStream out(socket->getOutputStream());
+
+                StompFrameParser parser;
+                parser.parse(&in, connectFrame);
+
+                StompFrame reply;
+                reply.setCommand(StompCommandConstants::CONNECTED);
+                reply.setProperty(StompCommandConstants::HEADER_VERSION, StompCommandConstants::VERSION_1_1);
+                reply.setProperty(StompCommandConstants::HEADER_HEARTBEAT, heartBeat);
+                reply.toStream(&out);
+                connected.countDown();
+
+                // The client only sends heart-beats after connecting, read those on
+                // another thread while this one writes.
+                class Reader : public Thread {
+                public:
+
+                    DataInputStream& in;
+                    AtomicInteger& count;
+
+                    Reader(DataInputStream& in, AtomicInteger& count) : Thread(), in(in), count(count) {}
+
+                    virtual void run() {
+                        try {
+                            StompFrameParser parser;
+                            while (true) {
+                                StompFrame frame;
+                                if (!parser.parseFrameOrHeartBeat(&in, frame)) {
+                                    count.incrementAndGet();
+                                }
+                            }
+                        } catch (...) {}
+                    }
+                } reader(in, heartBeatsReceived);
+
+                reader.start();
+
+                while (sending.get()) {
+                    out.write('\n');
+                    out.flush();
+                    Thread::sleep(sendInterval);
+                }
+
+                // Quiet until the client gives up and hangs up.
+                reader.join();
+                socket->close();
+
+            } catch (...) {
+                connected.countDown();
+            }
+        }
+    };
+
+    class RecordingListener : public DefaultTransportListener {
+    public:
+
+        CountDownLatch failed;
+        AtomicInteger keepAlives;
+        std::string message;
+
+        RecordingListener() : DefaultTransportListener(), failed(1), keepAlives(), message() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            if (command->isKeepAliveInfo()) {
+                keepAlives.incrementAndGet();
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex) {
+            message = ex.getMessage();
+            failed.countDown();
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 StompWireFormatTest::StompWireFormatTest() {
@@ -46,3 +269,175 @@ void StompWireFormatTest::testChangeDestinationPrefix() {
     frame.setProperty("subscription", "connection:1:1:0:1");
     frame.setProperty("message-id", "connection:1:1:0:1");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testConnectNegotiation() {
+
+    StompWireFormat stomp10;
+    Pointer<StompFrame> frame = toFrame(connect(stomp10, "CONNECTED\n\n"));
+    CPPUNIT_ASSERT(!frame->hasProperty(StompCommandConstants::HEADER_ACCEPT_VERSION));
+    CPPUNIT_ASSERT(!frame->hasProperty(StompCommandConstants::HEADER_HEARTBEAT));
+    CPPUNIT_ASSERT(!stomp10.hasNegotiator());
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::VERSION_1_0, stomp10.getProtocolVersion());
+
+    StompWireFormat wireFormat;
+    wireFormat.setAcceptVersion("1.0,1.1,1.2");
+    wireFormat.setHeartBeatSendInterval(1000);
+    wireFormat.setHeartBeatReceiveInterval(2000);
+    CPPUNIT_ASSERT(wireFormat.hasNegotiator());
+
+    frame = toFrame(connect(wireFormat, "CONNECTED\nversion:1.2\nheart-beat:3000,500\n\n"));
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::CONNECT, frame->getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0,1.1,1.2"), frame->getProperty(StompCommandConstants::HEADER_ACCEPT_VERSION));
+    CPPUNIT_ASSERT_EQUAL(std::string("1000,2000"), frame->getProperty(StompCommandConstants::HEADER_HEARTBEAT));
+
+    // Each side sends at the slower of the two rates.
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::VERSION_1_2, wireFormat.getProtocolVersion());
+    CPPUNIT_ASSERT_EQUAL(1000LL, wireFormat.getNegotiatedSendInterval());
+    CPPUNIT_ASSERT_EQUAL(3000LL, wireFormat.getNegotiatedReceiveInterval());
+
+    // A Broker that sends no heart-beats turns off the read side only.
+    StompWireFormat noBrokerBeats;
+    noBrokerBeats.setAcceptVersion("1.1");
+    noBrokerBeats.setHeartBeatSendInterval(1000);
+    noBrokerBeats.setHeartBeatReceiveInterval(2000);
+    connect(noBrokerBeats, "CONNECTED\nversion:1.1\nheart-beat:0,1500\n\n");
+    CPPUNIT_ASSERT_EQUAL(1500LL, noBrokerBeats.getNegotiatedSendInterval());
+    CPPUNIT_ASSERT_EQUAL(0LL, noBrokerBeats.getNegotiatedReceiveInterval());
+
+    // Heart-beats need a version after 1.0.
+    StompWireFormat oldBroker;
+    oldBroker.setAcceptVersion("1.0,1.1");
+    oldBroker.setHeartBeatSendInterval(1000);
+    oldBroker.setHeartBeatReceiveInterval(2000);
+    connect(oldBroker, "CONNECTED\nheart-beat:1000,1000\n\n");
+    CPPUNIT_ASSERT_EQUAL(0LL, oldBroker.getNegotiatedSendInterval());
+    CPPUNIT_ASSERT_EQUAL(0LL, oldBroker.getNegotiatedReceiveInterval());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testAckMapping() {
+
+    StompWireFormat stomp10;
+    StompHelper helper10(&stomp10);
+    connect(stomp10, "CONNECTED\n\n");
+
+    // STOMP 1.0 has no NACK.
+    Pointer<StompFrame> frame = toFrame(marshal(stomp10, createAck(helper10, ActiveMQConstants::ACK_TYPE_POISON)));
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::ACK, frame->getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:test-host-1:2:3:4"), frame->getProperty(StompCommandConstants::HEADER_MESSAGEID));
+    CPPUNIT_ASSERT(!frame->hasProperty(StompCommandConstants::HEADER_SUBSCRIPTION));
+
+    StompWireFormat stomp11;
+    StompHelper helper11(&stomp11);
+    stomp11.setAcceptVersion("1.0,1.1");
+    connect(stomp11, "CONNECTED\nversion:1.1\n\n");
+
+    std::string text = marshal(stomp11, createAck(helper11, ActiveMQConstants::ACK_TYPE_POISON));
+
+    // Colons in 1.1 header values are escaped.
+    CPPUNIT_ASSERT(text.find("message-id:ID\\ctest-host-1\\c2\\c3\\c4\n") != std::string::npos);
+
+    StompFrameParser parser;
+    parser.setDecodeHeaders(true);
+    std::vector<unsigned char> bytes(text.begin(), text.end());
+    ByteArrayInputStream source(bytes);
+    DataInputStream in(&source);
+    StompFrame nack;
+    parser.parse(&in, nack);
+
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::NACK, nack.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:test-host-1:2:3:4"), nack.getProperty(StompCommandConstants::HEADER_MESSAGEID));
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:test-host-1:2:3"), nack.getProperty(StompCommandConstants::HEADER_SUBSCRIPTION));
+    CPPUNIT_ASSERT(!nack.hasProperty(StompCommandConstants::HEADER_ID));
+
+    frame = toFrame(marshal(stomp11, createAck(helper11, ActiveMQConstants::ACK_TYPE_CONSUMED)));
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::ACK, frame->getCommand());
+
+    StompWireFormat stomp12;
+    StompHelper helper12(&stomp12);
+    stomp12.setAcceptVersion("1.2");
+    connect(stomp12, "CONNECTED\nversion:1.2\n\n");
+
+    frame = toFrame(marshal(stomp12, createAck(helper12, ActiveMQConstants::ACK_TYPE_POISON)));
+    CPPUNIT_ASSERT_EQUAL(StompCommandConstants::NACK, frame->getCommand());
+    CPPUNIT_ASSERT(frame->hasProperty(StompCommandConstants::HEADER_ID));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testHeartBeatFrames() {
+
+    StompWireFormat wireFormat;
+    wireFormat.setAcceptVersion("1.1");
+    wireFormat.setHeartBeatReceiveInterval(1000);
+
+    // Until heart-beats are agreed on blank lines are skipped.
+    CPPUNIT_ASSERT(unmarshal(wireFormat, std::string("\nRECEIPT\nreceipt-id:5\n\n") + '\0').dynamicCast<Response>() != NULL);
+
+    connect(wireFormat, "CONNECTED\nversion:1.1\nheart-beat:500,0\n\n");
+    CPPUNIT_ASSERT_EQUAL(1000LL, wireFormat.getNegotiatedReceiveInterval());
+
+    CPPUNIT_ASSERT(unmarshal(wireFormat, "\n").dynamicCast<KeepAliveInfo>() != NULL);
+    CPPUNIT_ASSERT(unmarshal(wireFormat, "\r\nRECEIPT\n\n").dynamicCast<KeepAliveInfo>() != NULL);
+
+    // The line end after a Frame's null is part of the Frame.
+    std::string text("RECEIPT\nreceipt-id:6\n\n\0\n\n", 25);
+    std::vector<unsigned char> bytes(text.begin(), text.end());
+    ByteArrayInputStream source(bytes);
+    DataInputStream in(&source);
+    IOTransport transport;
+
+    Pointer<Response> receipt = wireFormat.unmarshal(&transport, &in).dynamicCast<Response>();
+    CPPUNIT_ASSERT(receipt != NULL);
+    CPPUNIT_ASSERT_EQUAL(6, receipt->getCorrelationId());
+    CPPUNIT_ASSERT(wireFormat.unmarshal(&transport, &in).dynamicCast<KeepAliveInfo>() != NULL);
+    CPPUNIT_ASSERT_EQUAL(0, source.available());
+
+    CPPUNIT_ASSERT_EQUAL(std::string("\n"), marshal(wireFormat, Pointer<Command>(new KeepAliveInfo())));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testHeartBeatsWithStandInServer() {
+
+    StompStandInServer server("40,60", 40);
+    server.start();
+
+    TcpTransportFactory factory;
+    URI uri("tcp://localhost:" + Integer::toString(server.server.getLocalPort()) +
+            "?wireFormat=stomp&wireFormat.acceptVersion=1.0,1.1"
+            "&wireFormat.heartBeatSendInterval=50&wireFormat.heartBeatReceiveInterval=100");
+
+    RecordingListener listener;
+    Pointer<Transport> transport = factory.create(uri);
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    Pointer<ConnectionInfo> info(new ConnectionInfo());
+    info->setClientId("client");
+    Pointer<Response> response = transport->request(info, 5000);
+    CPPUNIT_ASSERT(response != NULL);
+    CPPUNIT_ASSERT(server.connected.await(5000));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0,1.1"), server.connectFrame.getProperty(StompCommandConstants::HEADER_ACCEPT_VERSION));
+    CPPUNIT_ASSERT_EQUAL(std::string("50,100"), server.connectFrame.getProperty(StompCommandConstants::HEADER_HEARTBEAT));
+
+    Pointer<StompWireFormat> wireFormat = transport->getWireFormat().dynamicCast<StompWireFormat>();
+    CPPUNIT_ASSERT_EQUAL(60LL, wireFormat->getNegotiatedSendInterval());
+    CPPUNIT_ASSERT_EQUAL(100LL, wireFormat->getNegotiatedReceiveInterval());
+
+    // While both sides beat the connection stays up and the Broker's heart-beats
+    // never reach the listener.
+    Thread::sleep(600);
+    CPPUNIT_ASSERT_EQUAL(1L, (long) listener.failed.getCount());
+    CPPUNIT_ASSERT_EQUAL(0, listener.keepAlives.get());
+    CPPUNIT_ASSERT(server.heartBeatsReceived.get() >= 3);
+
+    // Once the Broker goes quiet the read check fails the Transport.
+    server.sending.set(false);
+    CPPUNIT_ASSERT(listener.failed.await(5000));
+    CPPUNIT_ASSERT(listener.message.find("No heart-beat received") != std::string::npos);
+
+    transport->close();
+    server.stop();
+    server.join();
+}
@@ -29,6 +29,10 @@ namespace stomp {
 
         CPPUNIT_TEST_SUITE( StompWireFormatTest );
         CPPUNIT_TEST( testChangeDestinationPrefix );
+        CPPUNIT_TEST( testConnectNegotiation );
+        CPPUNIT_TEST( testAckMapping );
+        CPPUNIT_TEST( testHeartBeatFrames );
+        CPPUNIT_TEST( testHeartBeatsWithStandInServer );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +41,10 @@ namespace stomp {
         virtual ~StompWireFormatTest();
 
         virtual void testChangeDestinationPrefix();
+        virtual void testConnectNegotiation();
+        virtual void testAckMapping();
+        virtual void testHeartBeatFrames();
+        virtual void testHeartBeatsWithStandInServer();
 
     };
 
@@ -0,0 +1,222 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenSSLSessionCacheTest.h"
+
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCache.h>
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::ssl;
+using namespace decaf::internal::net::ssl::openssl;
+
+#ifdef HAVE_OPENSSL
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    SSL_SESSION* createSession(const std::string& id) {
+
+        SSL_SESSION* session = SSL_SESSION_new();
+
+        // A session needs an id or a ticket before OpenSSL considers it resumable.
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+        SSL_SESSION_set1_id(session, (const unsigned char*) id.c_str(), (unsigned int) id.length());
+#endif
+
+        return session;
+    }
+
+    bool isCached(OpenSSLSessionCache& cache, const std::string& key) {
+
+        SSL_CTX* context = SSL_CTX_new(SSLv23_client_method());
+        SSL* ssl = SSL_new(context);
+
+        bool result = cache.resume(key, ssl);
+
+        SSL_free(ssl);
+        SSL_CTX_free(context);
+
+        return result;
+    }
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCacheTest::OpenSSLSessionCacheTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCacheTest::~OpenSSLSessionCacheTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testMaxSize() {
+
+    OpenSSLSessionCache cache;
+
+    CPPUNIT_ASSERT_EQUAL(OpenSSLSessionCache::DEFAULT_MAX_SIZE, cache.getMaxSize());
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    cache.setMaxSize(0);
+    CPPUNIT_ASSERT_EQUAL(0, cache.getMaxSize());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        cache.setMaxSize(-1),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_EQUAL(0, cache.getMaxSize());
+}
+
+#ifdef HAVE_OPENSSL
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testStore() {
+
+    OpenSSLSessionCache cache;
+
+    CPPUNIT_ASSERT(cache.store("host1:61617", createSession("one")));
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+    CPPUNIT_ASSERT(isCached(cache, "host1:61617"));
+    CPPUNIT_ASSERT(!isCached(cache, "host2:61617"));
+
+    // A newer session for the same peer replaces the old one.
+    CPPUNIT_ASSERT(cache.store("host1:61617", createSession("two")));
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+
+    cache.remove("host1:61617");
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+    CPPUNIT_ASSERT(!isCached(cache, "host1:61617"));
+
+    cache.setMaxSize(0);
+    SSL_SESSION* session = createSession("three");
+    CPPUNIT_ASSERT(!cache.store("host1:61617", session));
+    SSL_SESSION_free(session);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testEvictsLeastRecentlyUsed() {
+
+    OpenSSLSessionCache cache;
+    cache.setMaxSize(2);
+
+    // Keys chosen so that the alphabetically smallest peer is the most recent.
+    CPPUNIT_ASSERT(cache.store("c:61617", createSession("c")));
+    CPPUNIT_ASSERT(cache.store("b:61617", createSession("b")));
+    CPPUNIT_ASSERT(cache.store("a:61617", createSession("a")));
+
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+    CPPUNIT_ASSERT(!isCached(cache, "c:61617"));
+    CPPUNIT_ASSERT(isCached(cache, "b:61617"));
+    CPPUNIT_ASSERT(isCached(cache, "a:61617"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testResumeRefreshesPeer() {
+
+    OpenSSLSessionCache cache;
+    cache.setMaxSize(2);
+
+    CPPUNIT_ASSERT(cache.store("a:61617", createSession("a")));
+    CPPUNIT_ASSERT(cache.store("b:61617", createSession("b")));
+
+    // Reconnecting to the first peer makes the second the least recently used.
+    CPPUNIT_ASSERT(isCached(cache, "a:61617"));
+    CPPUNIT_ASSERT(cache.store("c:61617", createSession("c")));
+
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+    CPPUNIT_ASSERT(!isCached(cache, "b:61617"));
+    CPPUNIT_ASSERT(isCached(cache, "a:61617"));
+    CPPUNIT_ASSERT(isCached(cache, "c:61617"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testStoreIgnoresNonResumableSession() {
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    OpenSSLSessionCache cache;
+
+    // Without an id or ticket, as when read back before a TLS 1.3 ticket arrives.
+    SSL_SESSION* session = SSL_SESSION_new();
+    CPPUNIT_ASSERT(!cache.store("host1:61617", session));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+    SSL_SESSION_free(session);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testShrinkMaxSize() {
+
+    OpenSSLSessionCache cache;
+
+    CPPUNIT_ASSERT(cache.store("a:61617", createSession("a")));
+    CPPUNIT_ASSERT(cache.store("b:61617", createSession("b")));
+    CPPUNIT_ASSERT(cache.store("c:61617", createSession("c")));
+
+    cache.setMaxSize(1);
+
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+    CPPUNIT_ASSERT(isCached(cache, "c:61617"));
+
+    cache.clear();
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCacheTest::testInstall() {
+
+    OpenSSLSessionCache cache;
+
+    SSL_CTX* context = SSL_CTX_new(SSLv23_client_method());
+    cache.install(context);
+
+    // Client sessions are kept only by the cache, not again by OpenSSL.
+    long mode = SSL_CTX_get_session_cache_mode(context);
+    CPPUNIT_ASSERT((mode & SSL_SESS_CACHE_CLIENT) != 0);
+    CPPUNIT_ASSERT((mode & SSL_SESS_CACHE_NO_INTERNAL_STORE) == SSL_SESS_CACHE_NO_INTERNAL_STORE);
+
+    int (*callback)(SSL*, SSL_SESSION*) = SSL_CTX_sess_get_new_cb(context);
+    CPPUNIT_ASSERT(callback != NULL);
+
+    // Sessions issued to an SSL that was never attached to a peer are not kept.
+    SSL* ssl = SSL_new(context);
+    SSL_SESSION* session = createSession("one");
+    CPPUNIT_ASSERT_EQUAL(0, callback(ssl, session));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    // Nor are sessions from a peer whose certificate did not verify.
+    cache.attach("host1:61617", ssl);
+    SSL_set_verify_result(ssl, X509_V_ERR_CERT_UNTRUSTED);
+    CPPUNIT_ASSERT_EQUAL(0, callback(ssl, session));
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    SSL_set_verify_result(ssl, X509_V_OK);
+    CPPUNIT_ASSERT_EQUAL(1, callback(ssl, session));
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+    CPPUNIT_ASSERT(isCached(cache, "host1:61617"));
+
+    SSL_free(ssl);
+    SSL_CTX_free(context);
+}
+
+#endif
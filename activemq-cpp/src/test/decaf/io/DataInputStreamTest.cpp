@@ -676,3 +676,33 @@ void DataInputStreamTest::testUTFDecoding() {
     }
 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamTest::testUTFLongStrings() {
+
+    std::vector<std::string> values;
+    values.push_back( std::string( 1000, 'x' ) );
+    for( int length = 1; length < 80; length += 7 ) {
+        for( int position = 0; position < length; position += 5 ) {
+            std::string value( length, 'a' );
+            value[position] = (char)( position % 2 == 0 ? 0x00 : 0xFF );
+            values.push_back( value );
+        }
+    }
+
+    ByteArrayOutputStream baos;
+    DataOutputStream writer( &baos );
+    for( std::size_t i = 0; i < values.size(); ++i ) {
+        writer.writeUTF( values[i] );
+    }
+
+    std::pair<unsigned char*, int> array = baos.toByteArray();
+    ByteArrayInputStream bais( array.first, array.second, true );
+    DataInputStream reader( &bais );
+
+    for( std::size_t i = 0; i < values.size(); ++i ) {
+        CPPUNIT_ASSERT( reader.readUTF() == values[i] );
+    }
+
+    CPPUNIT_ASSERT( reader.available() == 0 );
+}
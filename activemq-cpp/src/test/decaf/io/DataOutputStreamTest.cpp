@@ -413,3 +413,55 @@ void DataOutputStreamTest::test(){
 
     delete [] buffer.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStreamTest::testBufferedPrimitives() {
+
+    // Buffers smaller than a long leave values split across their ends, those are
+    // written and read through the stream while the rest go straight to the array.
+    ByteArrayOutputStream bytes;
+    BufferedOutputStream buffered( &bytes, 7 );
+    DataOutputStream writer( &buffered );
+
+    for( int i = 0; i < 100; ++i ) {
+        writer.writeInt( i * 100003 );
+        writer.writeLong( (long long)i * 0x0102030405060708LL );
+        writer.writeShort( (short)( i * -331 ) );
+        writer.writeBoolean( i % 2 == 0 );
+        writer.writeDouble( i * 1.5 );
+    }
+    writer.flush();
+
+    CPPUNIT_ASSERT_EQUAL( 100LL * 23, writer.size() );
+    CPPUNIT_ASSERT_EQUAL( 100LL * 23, bytes.size() );
+
+    std::pair<unsigned char*, int> array = bytes.toByteArray();
+    ByteArrayInputStream input( array.first, array.second, true );
+    BufferedInputStream bufferedInput( &input, 5 );
+    DataInputStream reader( &bufferedInput );
+
+    for( int i = 0; i < 100; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( i * 100003, reader.readInt() );
+        CPPUNIT_ASSERT_EQUAL( (long long)i * 0x0102030405060708LL, reader.readLong() );
+        CPPUNIT_ASSERT_EQUAL( (short)( i * -331 ), reader.readShort() );
+        CPPUNIT_ASSERT_EQUAL( i % 2 == 0, reader.readBoolean() );
+        CPPUNIT_ASSERT_EQUAL( i * 1.5, reader.readDouble() );
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an EOFException",
+        reader.readInt(),
+        EOFException );
+
+    bufferedInput.close();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException reading from a closed stream",
+        reader.readByte(),
+        IOException );
+
+    buffered.close();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IOException writing to a closed stream",
+        writer.writeInt( 1 ),
+        IOException );
+}
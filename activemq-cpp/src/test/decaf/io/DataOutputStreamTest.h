@@ -26,6 +26,8 @@
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/BufferedOutputStream.h>
 #include <memory>
 
 namespace decaf{
@@ -52,6 +54,7 @@ namespace io{
         CPPUNIT_TEST( testWriteUTF );
         CPPUNIT_TEST( testWriteUTFStringLength );
         CPPUNIT_TEST( testWriteUTFEncoding );
+        CPPUNIT_TEST( testBufferedPrimitives );
         CPPUNIT_TEST_SUITE_END();
 
         std::auto_ptr<ByteArrayOutputStream> baos;
@@ -98,6 +101,7 @@ namespace io{
         void testWriteUTF();
         void testWriteUTFStringLength();
         void testWriteUTFEncoding();
+        void testBufferedPrimitives();
 
     private:
 
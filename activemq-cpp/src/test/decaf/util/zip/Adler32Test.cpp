@@ -18,6 +18,7 @@
 #include "Adler32Test.h"
 
 #include <decaf/util/zip/Adler32.h>
+#include <decaf/internal/util/zip/ChecksumKernels.h>
 
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
@@ -156,3 +157,45 @@ void Adler32Test::testUpdateArrayIndexed() {
         adl.update( byteArray, SIZE, offError, len ),
         IndexOutOfBoundsException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    long long computeAdler32( const std::vector<unsigned char>& buffer, int offset, int length, bool useKernels ) {
+
+        bool previous = decaf::internal::util::zip::ChecksumKernels::setEnabled( useKernels );
+        Adler32 checksum;
+        checksum.update( &buffer[0], (int)buffer.size(), offset, length );
+        decaf::internal::util::zip::ChecksumKernels::setEnabled( previous );
+        return checksum.getValue();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Adler32Test::testUpdateLargeArray() {
+
+    std::vector<unsigned char> buffer( 70000 );
+    for( std::size_t i = 0; i < buffer.size(); ++i ) {
+        buffer[i] = (unsigned char)( ( i * 31 ) ^ ( i >> 7 ) );
+    }
+
+    // The vectorized kernels take over from the table driven code once the
+    // buffer is long enough, every length and alignment must give the same value.
+    for( int length = 0; length < 300; ++length ) {
+        for( int offset = 0; offset < 16; offset += 5 ) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( "checksum differs from the table driven value",
+                                          computeAdler32( buffer, offset, length, false ),
+                                          computeAdler32( buffer, offset, length, true ) );
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "checksum differs from the table driven value",
+                                  computeAdler32( buffer, 3, 65537, false ),
+                                  computeAdler32( buffer, 3, 65537, true ) );
+
+    std::vector<unsigned char> ones( 10000, 0xFF );
+    Adler32 adl;
+    adl.update( ones );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "update(unsigned char[]) failed to update the checksum to the correct value ",
+                                  computeAdler32( ones, 0, 10000, false ), adl.getValue() );
+}
@@ -18,6 +18,7 @@
 #include "CRC32Test.h"
 
 #include <decaf/util/zip/CRC32.h>
+#include <decaf/internal/util/zip/ChecksumKernels.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
 
@@ -175,3 +176,45 @@ void CRC32Test::testUpdateArrayIndexed() {
         crc.update( byteArray, SIZE, offError, len ),
         IndexOutOfBoundsException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    long long computeCRC32( const std::vector<unsigned char>& buffer, int offset, int length, bool useKernels ) {
+
+        bool previous = decaf::internal::util::zip::ChecksumKernels::setEnabled( useKernels );
+        CRC32 checksum;
+        checksum.update( &buffer[0], (int)buffer.size(), offset, length );
+        decaf::internal::util::zip::ChecksumKernels::setEnabled( previous );
+        return checksum.getValue();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CRC32Test::testUpdateLargeArray() {
+
+    std::vector<unsigned char> buffer( 70000 );
+    for( std::size_t i = 0; i < buffer.size(); ++i ) {
+        buffer[i] = (unsigned char)( ( i * 31 ) ^ ( i >> 7 ) );
+    }
+
+    // The vectorized kernels take over from the table driven code once the
+    // buffer is long enough, every length and alignment must give the same value.
+    for( int length = 0; length < 300; ++length ) {
+        for( int offset = 0; offset < 16; offset += 5 ) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( "checksum differs from the table driven value",
+                                          computeCRC32( buffer, offset, length, false ),
+                                          computeCRC32( buffer, offset, length, true ) );
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "checksum differs from the table driven value",
+                                  computeCRC32( buffer, 3, 65537, false ),
+                                  computeCRC32( buffer, 3, 65537, true ) );
+
+    std::vector<unsigned char> ones( 10000, 0xFF );
+    CRC32 crc;
+    crc.update( ones );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "update(unsigned char[]) failed to update the checksum to the correct value ",
+                                  computeCRC32( ones, 0, 10000, false ), crc.getValue() );
+}
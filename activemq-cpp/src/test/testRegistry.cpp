@@ -42,10 +42,31 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::IOTransportTest );
 #include <activemq/exceptions/ActiveMQExceptionTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::exceptions::ActiveMQExceptionTest );
 
+#include <activemq/compression/CompressionCodecTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::compression::CompressionCodecTest );
+
+#include <activemq/cmsutil/SessionPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::SessionPoolTest );
+#include <activemq/cmsutil/PooledSessionTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::PooledSessionTest );
+
+#include <activemq/core/ActiveMQConnectionTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQConnectionTest );
+#include <activemq/core/ActiveMQConnectionFactoryTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQConnectionFactoryTest );
+#include <activemq/core/ActiveMQFanOutConsumerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQFanOutConsumerTest );
+#include <activemq/core/PriorityMessageDispatchChannelTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::PriorityMessageDispatchChannelTest );
+#include <activemq/core/policies/AdaptivePrefetchPolicyTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::policies::AdaptivePrefetchPolicyTest );
+
 #include <activemq/util/AdvisorySupportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::AdvisorySupportTest );
 #include <activemq/util/ActiveMQMessageTransformationTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::ActiveMQMessageTransformationTest );
+#include <activemq/util/DestinationCacheTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::DestinationCacheTest );
 #include <activemq/util/IdGeneratorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::IdGeneratorTest );
 #include <activemq/util/LongSequenceGeneratorTest.h>
@@ -65,6 +86,15 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MemoryUsageTest );
 #include <activemq/util/MarshallingSupportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MarshallingSupportTest );
 
+#include <activemq/metrics/HistogramTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::metrics::HistogramTest );
+#include <activemq/metrics/MetricsRegistryTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::metrics::MetricsRegistryTest );
+#include <activemq/metrics/TracerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::metrics::TracerTest );
+#include <activemq/selector/SelectorParserTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::selector::SelectorParserTest );
+
 #include <activemq/threads/SchedulerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::SchedulerTest );
 #include <activemq/threads/DedicatedTaskRunnerTest.h>
@@ -74,6 +104,14 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::CompositeTaskRunnerTest );
 
 #include <activemq/wireformat/WireFormatRegistryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::WireFormatRegistryTest );
+#include <activemq/wireformat/openwire/utils/FlatPropertyMapTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::FlatPropertyMapTest );
+#include <activemq/wireformat/stomp/StompFrameTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompFrameTest );
+#include <activemq/wireformat/stomp/StompWireFormatTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompWireFormatTest );
+#include <activemq/wireformat/stomp/StompWireFormatFactoryTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::stomp::StompWireFormatFactoryTest );
 
 #include <decaf/internal/util/ByteArrayAdapterTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::ByteArrayAdapterTest );
@@ -82,6 +120,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::TimerTaskHeapTest );
 
 #include <decaf/internal/net/ssl/DefaultSSLSocketFactoryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::ssl::DefaultSSLSocketFactoryTest );
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCacheTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::ssl::openssl::OpenSSLSessionCacheTest );
 
 #include <decaf/internal/nio/ByteArrayBufferTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::nio::ByteArrayBufferTest );